@@ -2,6 +2,7 @@
 
 #include "hero/config_derivation.h"
 #include "hero/config_hero/hero_config.h"
+#include "hero/json_field_index.h"
 #include "hero/mcp_schema_compat.h"
 #include "hero/mcp_stdio_transport.h"
 #include "kikijyeba/protocol/config_provenance.h"
@@ -366,77 +367,11 @@ void skip_ws(const std::string &s, std::size_t *idx) {
   return *idx > begin;
 }
 
-[[nodiscard]] bool extract_json_raw_field(const std::string &json,
-                                          std::string_view key,
-                                          std::string *out) {
-  std::size_t idx = 0;
-  skip_ws(json, &idx);
-  if (idx >= json.size() || json[idx] != '{') {
-    return false;
-  }
-  ++idx;
-  while (idx < json.size()) {
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-    std::string current_key;
-    if (!parse_json_string_token(json, &idx, &current_key)) {
-      return false;
-    }
-    skip_ws(json, &idx);
-    if (idx >= json.size() || json[idx] != ':') {
-      return false;
-    }
-    ++idx;
-    skip_ws(json, &idx);
-    const std::size_t value_begin = idx;
-    if (!skip_json_value(json, &idx)) {
-      return false;
-    }
-    if (current_key == key) {
-      if (out) {
-        *out = trim_ascii(
-            std::string_view(json).substr(value_begin, idx - value_begin));
-      }
-      return true;
-    }
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == ',') {
-      ++idx;
-      continue;
-    }
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-  }
-  return false;
-}
-
-[[nodiscard]] bool extract_json_string_field(const std::string &json,
-                                             std::string_view key,
-                                             std::string *out) {
-  std::string raw;
-  if (!extract_json_raw_field(json, key, &raw)) {
-    return false;
-  }
-  std::size_t idx = 0;
-  skip_ws(raw, &idx);
-  std::string value;
-  if (!parse_json_string_token(raw, &idx, &value)) {
-    return false;
-  }
-  skip_ws(raw, &idx);
-  if (idx != raw.size()) {
-    return false;
-  }
-  if (out) {
-    *out = std::move(value);
-  }
-  return true;
-}
+using cuwacunu::hero::json_field_index::extract_json_raw_field;
+using cuwacunu::hero::json_field_index::extract_json_string_field;
+using cuwacunu::hero::json_field_index::json_payload_t;
 
-[[nodiscard]] bool extract_json_bool_field(const std::string &json,
+[[nodiscard]] bool extract_json_bool_field(const json_payload_t &json,
                                            std::string_view key, bool *out) {
   std::string raw;
   if (!extract_json_raw_field(json, key, &raw)) {
@@ -458,7 +393,7 @@ void skip_ws(const std::string &s, std::size_t *idx) {
   return false;
 }
 
-[[nodiscard]] bool extract_json_int_field(const std::string &json,
+[[nodiscard]] bool extract_json_int_field(const json_payload_t &json,
                                           std::string_view key, int *out) {
   std::string raw;
   if (!extract_json_raw_field(json, key, &raw)) {
@@ -612,10 +547,10 @@ validate_allowed_fields(const std::vector<json_field_t> &fields,
 }
 
 [[nodiscard]] bool parse_allowed_direct_fields(
-    const std::string &args, std::initializer_list<std::string_view> allowed,
+    const json_payload_t &args, std::initializer_list<std::string_view> allowed,
     std::vector<json_field_t> *fields, std::string *err) {
   std::vector<json_field_t> parsed;
-  if (!parse_json_object_fields(args, &parsed, err)) {
+  if (!parse_json_object_fields(args.text(), &parsed, err)) {
     return false;
   }
   if (!validate_allowed_fields(parsed, allowed, err)) {
@@ -627,7 +562,7 @@ validate_allowed_fields(const std::vector<json_field_t> &fields,
   return true;
 }
 
-[[nodiscard]] bool validate_optional_bool_field(const std::string &args,
+[[nodiscard]] bool validate_optional_bool_field(const json_payload_t &args,
                                                 std::string_view key,
                                                 std::string *err) {
   if (!extract_json_raw_field(args, key, nullptr)) {
@@ -643,7 +578,7 @@ validate_allowed_fields(const std::vector<json_field_t> &fields,
   return true;
 }
 
-[[nodiscard]] bool validate_optional_string_field(const std::string &args,
+[[nodiscard]] bool validate_optional_string_field(const json_payload_t &args,
                                                   std::string_view key,
                                                   std::string *err) {
   if (!extract_json_raw_field(args, key, nullptr)) {
@@ -660,7 +595,7 @@ validate_allowed_fields(const std::vector<json_field_t> &fields,
 }
 
 [[nodiscard]] bool
-validate_optional_string_fields(const std::string &args,
+validate_optional_string_fields(const json_payload_t &args,
                                 std::initializer_list<std::string_view> keys,
                                 std::string *err) {
   for (const auto key : keys) {
@@ -1535,14 +1470,14 @@ build_global_config_map_json(const hero_config_store_t &store,
   return out.str();
 }
 
-[[nodiscard]] bool handle_status(const std::string &,
+[[nodiscard]] bool handle_status(const json_payload_t &,
                                  hero_config_store_t *store, std::string *out,
                                  std::string *) {
   *out = build_status_json(*store);
   return true;
 }
 
-[[nodiscard]] bool handle_schema(const std::string &, hero_config_store_t *,
+[[nodiscard]] bool handle_schema(const json_payload_t &, hero_config_store_t *,
                                  std::string *out, std::string *) {
   std::ostringstream json;
   json << "{\"keys\":[";
@@ -1564,7 +1499,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_show(const std::string &, hero_config_store_t *store,
+[[nodiscard]] bool handle_show(const json_payload_t &, hero_config_store_t *store,
                                std::string *out, std::string *) {
   const auto entries = store->entries_snapshot();
   std::ostringstream json;
@@ -1583,7 +1518,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_get(const std::string &args,
+[[nodiscard]] bool handle_get(const json_payload_t &args,
                               hero_config_store_t *store, std::string *out,
                               std::string *err) {
   std::string key;
@@ -1601,7 +1536,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_set(const std::string &args,
+[[nodiscard]] bool handle_set(const json_payload_t &args,
                               hero_config_store_t *store, std::string *out,
                               std::string *err) {
   std::string key;
@@ -1643,7 +1578,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_map(const std::string &args,
+[[nodiscard]] bool handle_map(const json_payload_t &args,
                               hero_config_store_t *store, std::string *out,
                               std::string *err) {
   bool include_sha256 = false;
@@ -1657,7 +1592,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_capture_bundle(const std::string &args,
+[[nodiscard]] bool handle_capture_bundle(const json_payload_t &args,
                                          hero_config_store_t *store,
                                          std::string *out, std::string *err) {
   bool include_text = false;
@@ -1691,7 +1626,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_resolve(const std::string &args,
+[[nodiscard]] bool handle_resolve(const json_payload_t &args,
                                   hero_config_store_t *store, std::string *out,
                                   std::string *err) {
   std::string path_arg;
@@ -1716,7 +1651,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_diff(const std::string &args,
+[[nodiscard]] bool handle_diff(const json_payload_t &args,
                                hero_config_store_t *store, std::string *out,
                                std::string *err) {
   bool include_text = false;
@@ -1739,7 +1674,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return resolve_managed_path(store, config_path.string(), true, nullptr, err);
 }
 
-[[nodiscard]] bool handle_save(const std::string &, hero_config_store_t *store,
+[[nodiscard]] bool handle_save(const json_payload_t &, hero_config_store_t *store,
                                std::string *out, std::string *err) {
   if (!enforce_policy_write(*store, err)) {
     return false;
@@ -1784,7 +1719,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_rollback(const std::string &args,
+[[nodiscard]] bool handle_rollback(const json_payload_t &args,
                                    hero_config_store_t *store, std::string *out,
                                    std::string *err) {
   if (!enforce_policy_write(*store, err)) {
@@ -1801,7 +1736,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_list(const std::string &args,
+[[nodiscard]] bool handle_list(const json_payload_t &args,
                                hero_config_store_t *store, std::string *out,
                                std::string *err) {
   std::string root_arg;
@@ -1897,7 +1832,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_read(const std::string &args,
+[[nodiscard]] bool handle_read(const json_payload_t &args,
                                hero_config_store_t *store, std::string *out,
                                std::string *err) {
   std::string path_arg;
@@ -1925,7 +1860,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_write(const std::string &args,
+[[nodiscard]] bool handle_write(const json_payload_t &args,
                                 hero_config_store_t *store, std::string *out,
                                 std::string *err) {
   std::string path_arg;
@@ -2028,7 +1963,7 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_delete(const std::string &args,
+[[nodiscard]] bool handle_delete(const json_payload_t &args,
                                  hero_config_store_t *store, std::string *out,
                                  std::string *err) {
   std::string path_arg;
@@ -2102,25 +2037,25 @@ build_global_config_map_json(const hero_config_store_t &store,
   return true;
 }
 
-[[nodiscard]] bool handle_inspect_schema(const std::string &args,
+[[nodiscard]] bool handle_inspect_schema(const json_payload_t &args,
                                          hero_config_store_t *store,
                                          std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {}, nullptr, err)) {
     return false;
   }
-  return handle_schema("{}", store, out, err);
+  return handle_schema(json_payload_t("{}"), store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_show(const std::string &args,
+[[nodiscard]] bool handle_inspect_show(const json_payload_t &args,
                                        hero_config_store_t *store,
                                        std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {}, nullptr, err)) {
     return false;
   }
-  return handle_show("{}", store, out, err);
+  return handle_show(json_payload_t("{}"), store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_value(const std::string &args,
+[[nodiscard]] bool handle_inspect_value(const json_payload_t &args,
                                         hero_config_store_t *store,
                                         std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"key"}, nullptr, err)) {
@@ -2130,7 +2065,7 @@ build_global_config_map_json(const hero_config_store_t &store,
 }
 
 [[nodiscard]] bool
-handle_inspect_validate_global_config(const std::string &args,
+handle_inspect_validate_global_config(const json_payload_t &args,
                                       hero_config_store_t *store,
                                       std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {}, nullptr, err)) {
@@ -2139,7 +2074,7 @@ handle_inspect_validate_global_config(const std::string &args,
   return handle_validate("{}", store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_map(const std::string &args,
+[[nodiscard]] bool handle_inspect_map(const json_payload_t &args,
                                       hero_config_store_t *store,
                                       std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"include_sha256"}, nullptr, err)) {
@@ -2148,7 +2083,7 @@ handle_inspect_validate_global_config(const std::string &args,
   return handle_map(args, store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_bundle(const std::string &args,
+[[nodiscard]] bool handle_inspect_bundle(const json_payload_t &args,
                                          hero_config_store_t *store,
                                          std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -2166,11 +2101,12 @@ handle_inspect_validate_global_config(const std::string &args,
   append_raw_member(&subargs, &has_any, fields, "include_content",
                     "include_text");
   subargs << "}";
-  return handle_capture_bundle(subargs.str(), store, out, err);
+  return handle_capture_bundle(json_payload_t(subargs.str()), store, out,
+                               err);
 }
 
 [[nodiscard]] bool handle_inspect_resolve_path_with_mode(
-    const std::string &args, hero_config_store_t *store, bool for_write,
+    const json_payload_t &args, hero_config_store_t *store, bool for_write,
     std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
   if (!parse_allowed_direct_fields(args, {"path", "include_sha256"}, &fields,
@@ -2186,24 +2122,24 @@ handle_inspect_validate_global_config(const std::string &args,
   append_literal_member(&subargs, &has_any, "for_write",
                         for_write ? "true" : "false");
   subargs << "}";
-  return handle_resolve(subargs.str(), store, out, err);
+  return handle_resolve(json_payload_t(subargs.str()), store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_resolve_path_read(const std::string &args,
+[[nodiscard]] bool handle_inspect_resolve_path_read(const json_payload_t &args,
                                                     hero_config_store_t *store,
                                                     std::string *out,
                                                     std::string *err) {
   return handle_inspect_resolve_path_with_mode(args, store, false, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_resolve_path_write(const std::string &args,
+[[nodiscard]] bool handle_inspect_resolve_path_write(const json_payload_t &args,
                                                      hero_config_store_t *store,
                                                      std::string *out,
                                                      std::string *err) {
   return handle_inspect_resolve_path_with_mode(args, store, true, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_diff(const std::string &args,
+[[nodiscard]] bool handle_inspect_diff(const json_payload_t &args,
                                        hero_config_store_t *store,
                                        std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -2219,10 +2155,10 @@ handle_inspect_validate_global_config(const std::string &args,
   append_raw_member(&subargs, &has_any, fields, "include_content",
                     "include_text");
   subargs << "}";
-  return handle_diff(subargs.str(), store, out, err);
+  return handle_diff(json_payload_t(subargs.str()), store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_backups(const std::string &args,
+[[nodiscard]] bool handle_inspect_backups(const json_payload_t &args,
                                           hero_config_store_t *store,
                                           std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {}, nullptr, err)) {
@@ -2231,7 +2167,7 @@ handle_inspect_validate_global_config(const std::string &args,
   return handle_backups("{}", store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_file_list(const std::string &args,
+[[nodiscard]] bool handle_inspect_file_list(const json_payload_t &args,
                                             hero_config_store_t *store,
                                             std::string *out,
                                             std::string *err) {
@@ -2250,10 +2186,10 @@ handle_inspect_validate_global_config(const std::string &args,
                     "include_sha256");
   append_raw_member(&subargs, &has_any, fields, "limit", "limit");
   subargs << "}";
-  return handle_list(subargs.str(), store, out, err);
+  return handle_list(json_payload_t(subargs.str()), store, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_file_read(const std::string &args,
+[[nodiscard]] bool handle_inspect_file_read(const json_payload_t &args,
                                             hero_config_store_t *store,
                                             std::string *out,
                                             std::string *err) {
@@ -2310,9 +2246,10 @@ build_expected_sha256_args(const std::vector<json_field_t> &fields,
                            std::ostringstream *subargs, bool *has_any,
                            std::string *err) {
   std::string expected_sha;
+  const json_payload_t expected_fields(
+      object_with_fields(fields, {{"expected_sha256", "expected_sha256"}}));
   const bool has_expected = extract_json_string_field(
-      object_with_fields(fields, {{"expected_sha256", "expected_sha256"}}),
-      "expected_sha256", &expected_sha);
+      expected_fields, "expected_sha256", &expected_sha);
   if (has_expected) {
     append_literal_member(subargs, has_any, "expected_sha256",
                           json_quote(expected_sha));
@@ -2322,7 +2259,7 @@ build_expected_sha256_args(const std::vector<json_field_t> &fields,
 }
 
 [[nodiscard]] std::string build_apply_result_json(std::string_view operation,
-                                                  const std::string &args,
+                                                  const json_payload_t &args,
                                                   std::string_view preflight,
                                                   std::string_view result) {
   std::ostringstream json;
@@ -2338,7 +2275,7 @@ build_expected_sha256_args(const std::vector<json_field_t> &fields,
 }
 
 [[nodiscard]] bool build_apply_preflight(const std::string &operation,
-                                         const std::string &args,
+                                         const json_payload_t &args,
                                          hero_config_store_t *store,
                                          std::string *out, std::string *err) {
   if (operation == "set") {
@@ -2422,7 +2359,7 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   return true;
 }
 
-[[nodiscard]] bool handle_apply_set(const std::string &args,
+[[nodiscard]] bool handle_apply_set(const json_payload_t &args,
                                     hero_config_store_t *store,
                                     std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"key", "value", "reason"}, nullptr,
@@ -2442,7 +2379,7 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   return true;
 }
 
-[[nodiscard]] bool handle_apply_save(const std::string &args,
+[[nodiscard]] bool handle_apply_save(const json_payload_t &args,
                                      hero_config_store_t *store,
                                      std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"reason", "include_content"}, nullptr,
@@ -2456,14 +2393,14 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
     return false;
   }
   std::string result;
-  if (!handle_save("{}", store, &result, err)) {
+  if (!handle_save(json_payload_t("{}"), store, &result, err)) {
     return false;
   }
   *out = build_apply_result_json("save", args, preflight, result);
   return true;
 }
 
-[[nodiscard]] bool handle_apply_reload(const std::string &args,
+[[nodiscard]] bool handle_apply_reload(const json_payload_t &args,
                                        hero_config_store_t *store,
                                        std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"reason"}, nullptr, err) ||
@@ -2482,7 +2419,7 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   return true;
 }
 
-[[nodiscard]] bool handle_apply_rollback(const std::string &args,
+[[nodiscard]] bool handle_apply_rollback(const json_payload_t &args,
                                          hero_config_store_t *store,
                                          std::string *out, std::string *err) {
   if (!parse_allowed_direct_fields(args, {"backup_id", "reason"}, nullptr,
@@ -2495,9 +2432,10 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
     return false;
   }
   std::string selected;
-  (void)extract_json_string_field(preflight, "selected_backup", &selected);
-  const std::string rollback_args =
-      selected.empty() ? "{}" : "{\"backup\":" + json_quote(selected) + "}";
+  (void)extract_json_string_field(json_payload_t(preflight), "selected_backup",
+                                  &selected);
+  const json_payload_t rollback_args(
+      selected.empty() ? "{}" : "{\"backup\":" + json_quote(selected) + "}");
   std::string result;
   if (!handle_rollback(rollback_args, store, &result, err)) {
     return false;
@@ -2506,7 +2444,7 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   return true;
 }
 
-[[nodiscard]] bool handle_apply_write(const std::string &args,
+[[nodiscard]] bool handle_apply_write(const json_payload_t &args,
                                       hero_config_store_t *store,
                                       std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -2521,23 +2459,25 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   if (!build_file_apply_args(fields, true, &preflight_args, err)) {
     return false;
   }
+  const json_payload_t preflight_payload(std::move(preflight_args));
   std::string preflight;
-  if (!handle_write(preflight_args, store, &preflight, err)) {
+  if (!handle_write(preflight_payload, store, &preflight, err)) {
     return false;
   }
   std::string execute_args;
   if (!build_file_apply_args(fields, false, &execute_args, err)) {
     return false;
   }
+  const json_payload_t execute_payload(std::move(execute_args));
   std::string result;
-  if (!handle_write(execute_args, store, &result, err)) {
+  if (!handle_write(execute_payload, store, &result, err)) {
     return false;
   }
   *out = build_apply_result_json("write", args, preflight, result);
   return true;
 }
 
-[[nodiscard]] bool handle_apply_delete(const std::string &args,
+[[nodiscard]] bool handle_apply_delete(const json_payload_t &args,
                                        hero_config_store_t *store,
                                        std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -2551,23 +2491,25 @@ build_file_apply_args(const std::vector<json_field_t> &fields, bool dry_run,
   if (!build_file_apply_args(fields, true, &preflight_args, err)) {
     return false;
   }
+  const json_payload_t preflight_payload(std::move(preflight_args));
   std::string preflight;
-  if (!handle_delete(preflight_args, store, &preflight, err)) {
+  if (!handle_delete(preflight_payload, store, &preflight, err)) {
     return false;
   }
   std::string execute_args;
   if (!build_file_apply_args(fields, false, &execute_args, err)) {
     return false;
   }
+  const json_payload_t execute_payload(std::move(execute_args));
   std::string result;
-  if (!handle_delete(execute_args, store, &result, err)) {
+  if (!handle_delete(execute_payload, store, &result, err)) {
     return false;
   }
   *out = build_apply_result_json("delete", args, preflight, result);
   return true;
 }
 
-using handler_fn = bool (*)(const std::string &, hero_config_store_t *,
+using handler_fn = bool (*)(const json_payload_t &, hero_config_store_t *,
                             std::string *, std::string *);
 
 [[nodiscard]] std::optional<handler_fn> find_handler(std::string_view name) {
@@ -2682,7 +2624,8 @@ bool execute_tool_json(const std::string &tool_name, std::string arguments_json,
 
   std::string structured;
   std::string err;
-  const bool ok = (*handler)(arguments_json, store, &structured, &err);
+  const json_payload_t arguments(arguments_json);
+  const bool ok = (*handler)(arguments, store, &structured, &err);
   if (!ok) {
     if (out_error_message) {
       *out_error_message = err;
@@ -2733,8 +2676,8 @@ void run_jsonrpc_stdio_loop(hero_config_store_t *store) {
   mcp_stdio::message_t message;
   bool shutdown_seen = false;
   while (mcp_stdio::read_message(std::cin, &message)) {
-    std::string line = trim_ascii(message.json);
-    if (line.empty()) {
+    const json_payload_t request(trim_ascii(message.json));
+    if (request.text().empty()) {
       continue;
     }
     const auto send = [&](std::string response) {
@@ -2742,9 +2685,9 @@ void run_jsonrpc_stdio_loop(hero_config_store_t *store) {
                                 message.content_length_framed);
     };
     std::string id_raw = "null";
-    (void)extract_json_raw_field(line, "id", &id_raw);
+    (void)extract_json_raw_field(request, "id", &id_raw);
     std::string method;
-    if (!extract_json_string_field(line, "method", &method)) {
+    if (!extract_json_string_field(request, "method", &method)) {
       continue;
     }
     if (method == "notifications/initialized") {
@@ -2757,10 +2700,11 @@ void run_jsonrpc_stdio_loop(hero_config_store_t *store) {
     if (method == "initialize") {
       std::string protocol = "2024-11-05";
       std::string params;
-      if (extract_json_raw_field(line, "params", &params)) {
-        (void)extract_json_string_field(params, "protocolVersion", &protocol);
+      if (extract_json_raw_field(request, "params", &params)) {
+        (void)extract_json_string_field(json_payload_t(std::move(params)),
+                                        "protocolVersion", &protocol);
       } else {
-        (void)extract_json_string_field(line, "protocolVersion", &protocol);
+        (void)extract_json_string_field(request, "protocolVersion", &protocol);
       }
       send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
            ",\"result\":{\"protocolVersion\":" + json_quote(protocol) +
@@ -2796,21 +2740,22 @@ void run_jsonrpc_stdio_loop(hero_config_store_t *store) {
     }
     if (method == "tools/call") {
       std::string params;
-      if (!extract_json_raw_field(line, "params", &params)) {
+      if (!extract_json_raw_field(request, "params", &params)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing "
              "params\"}}");
         continue;
       }
+      const json_payload_t call(std::move(params));
       std::string name;
-      if (!extract_json_string_field(params, "name", &name)) {
+      if (!extract_json_string_field(call, "name", &name)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing tool "
              "name\"}}");
         continue;
       }
       std::string arguments = "{}";
-      (void)extract_json_raw_field(params, "arguments", &arguments);
+      (void)extract_json_raw_field(call, "arguments", &arguments);
       std::string result;
       std::string error;
       (void)execute_tool_json(name, arguments, store, &result, &error);
@@ -1,6 +1,7 @@
 #include "hero/lattice_hero/hero_lattice_tools.h"
 
 #include "hero/config_path_defaults.h"
+#include "hero/json_field_index.h"
 #include "hero/lattice_hero/hero_lattice.h"
 #include "hero/lattice_hero/lattice/exposure/exposure_ledger.h"
 #include "hero/lattice_hero/lattice/target/lattice_target_evaluator.h"
@@ -592,77 +593,11 @@ void skip_ws(const std::string &s, std::size_t *idx) {
   return *idx > begin;
 }
 
-[[nodiscard]] bool extract_json_raw_field(const std::string &json,
-                                          std::string_view key,
-                                          std::string *out) {
-  std::size_t idx = 0;
-  skip_ws(json, &idx);
-  if (idx >= json.size() || json[idx] != '{') {
-    return false;
-  }
-  ++idx;
-  while (idx < json.size()) {
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-    std::string current_key;
-    if (!parse_json_string_token(json, &idx, &current_key)) {
-      return false;
-    }
-    skip_ws(json, &idx);
-    if (idx >= json.size() || json[idx] != ':') {
-      return false;
-    }
-    ++idx;
-    skip_ws(json, &idx);
-    const std::size_t value_begin = idx;
-    if (!skip_json_value(json, &idx)) {
-      return false;
-    }
-    if (current_key == key) {
-      if (out) {
-        *out = trim_ascii(
-            std::string_view(json).substr(value_begin, idx - value_begin));
-      }
-      return true;
-    }
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == ',') {
-      ++idx;
-      continue;
-    }
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-  }
-  return false;
-}
-
-[[nodiscard]] bool extract_json_string_field(const std::string &json,
-                                             std::string_view key,
-                                             std::string *out) {
-  std::string raw;
-  if (!extract_json_raw_field(json, key, &raw)) {
-    return false;
-  }
-  std::size_t idx = 0;
-  skip_ws(raw, &idx);
-  std::string value;
-  if (!parse_json_string_token(raw, &idx, &value)) {
-    return false;
-  }
-  skip_ws(raw, &idx);
-  if (idx != raw.size()) {
-    return false;
-  }
-  if (out) {
-    *out = std::move(value);
-  }
-  return true;
-}
+using cuwacunu::hero::json_field_index::extract_json_raw_field;
+using cuwacunu::hero::json_field_index::extract_json_string_field;
+using cuwacunu::hero::json_field_index::json_payload_t;
 
-[[nodiscard]] bool extract_json_int_field(const std::string &json,
+[[nodiscard]] bool extract_json_int_field(const json_payload_t &json,
                                           std::string_view key, int *out) {
   std::string raw;
   if (!extract_json_raw_field(json, key, &raw)) {
@@ -758,11 +693,11 @@ field_allowed(std::string_view key,
 }
 
 [[nodiscard]] bool
-validate_json_fields(const std::string &args,
+validate_json_fields(const json_payload_t &args,
                      std::initializer_list<std::string_view> allowed,
                      std::string *err) {
   std::vector<json_field_t> fields;
-  if (!parse_json_object_fields(args, &fields, err)) {
+  if (!parse_json_object_fields(args.text(), &fields, err)) {
     return false;
   }
   for (const auto &field : fields) {
@@ -776,13 +711,13 @@ validate_json_fields(const std::string &args,
   return true;
 }
 
-[[nodiscard]] bool with_fixed_json_string_field(const std::string &args,
+[[nodiscard]] bool with_fixed_json_string_field(const json_payload_t &args,
                                                 std::string_view key,
                                                 std::string_view value,
                                                 std::string *out,
                                                 std::string *err) {
   std::vector<json_field_t> fields;
-  if (!parse_json_object_fields(args, &fields, err)) {
+  if (!parse_json_object_fields(args.text(), &fields, err)) {
     return false;
   }
   std::ostringstream json;
@@ -805,13 +740,13 @@ validate_json_fields(const std::string &args,
   return true;
 }
 
-[[nodiscard]] bool with_fixed_json_raw_field(const std::string &args,
+[[nodiscard]] bool with_fixed_json_raw_field(const json_payload_t &args,
                                              std::string_view key,
                                              std::string_view raw_value,
                                              std::string *out,
                                              std::string *err) {
   std::vector<json_field_t> fields;
-  if (!parse_json_object_fields(args, &fields, err)) {
+  if (!parse_json_object_fields(args.text(), &fields, err)) {
     return false;
   }
   std::ostringstream json;
@@ -1093,7 +1028,7 @@ map_get_or(const std::unordered_map<std::string, std::string> &map,
                         policy.policy_path);
 }
 
-[[nodiscard]] bool parse_optional_int_arg(const std::string &json,
+[[nodiscard]] bool parse_optional_int_arg(const json_payload_t &json,
                                           std::string_view key, int fallback,
                                           int *out, std::string *err) {
   int value = fallback;
@@ -1110,7 +1045,7 @@ map_get_or(const std::unordered_map<std::string, std::string> &map,
   return true;
 }
 
-[[nodiscard]] bool parse_optional_bool_arg(const std::string &json,
+[[nodiscard]] bool parse_optional_bool_arg(const json_payload_t &json,
                                            std::string_view key, bool fallback,
                                            bool *out, std::string *err) {
   bool value = fallback;
@@ -1127,7 +1062,7 @@ map_get_or(const std::unordered_map<std::string, std::string> &map,
   return true;
 }
 
-[[nodiscard]] bool parse_optional_string_arg(const std::string &json,
+[[nodiscard]] bool parse_optional_string_arg(const json_payload_t &json,
                                              std::string_view key,
                                              std::string fallback,
                                              std::string *out,
@@ -1188,7 +1123,8 @@ parse_json_string_array_token(const std::string &raw,
 }
 
 [[nodiscard]] bool
-parse_optional_string_array_arg(const std::string &json, std::string_view key,
+parse_optional_string_array_arg(const json_payload_t &json,
+                                std::string_view key,
                                 std::vector<std::string> fallback,
                                 std::vector<std::string> *out,
                                 std::string *err) {
@@ -1208,7 +1144,7 @@ parse_optional_string_array_arg(const std::string &json, std::string_view key,
 }
 
 [[nodiscard]] bool parse_runtime_index_validation_strength_arg(
-    const std::string &json,
+    const json_payload_t &json,
     exposure::lattice_runtime_index_validation_strength_t fallback,
     exposure::lattice_runtime_index_validation_strength_t *out,
     std::string *err) {
@@ -11944,7 +11880,7 @@ scan_fact_family_json(const exposure::lattice_exposure_ledger_t &ledger,
 }
 
 [[nodiscard]] std::vector<exposure::lattice_fact_family_t>
-selected_fact_families_from_arg(const std::string &args) {
+selected_fact_families_from_arg(const json_payload_t &args) {
   std::string family_arg;
   (void)extract_json_string_field(args, "family", &family_arg);
   auto parsed = exposure::parse_lattice_fact_family(family_arg);
@@ -12985,7 +12921,7 @@ void overlay_active_identity_from_config(
 }
 
 void overlay_active_identity_from_args(
-    const std::string &args, target::lattice_target_active_identity_t *id) {
+    const json_payload_t &args, target::lattice_target_active_identity_t *id) {
   if (!id) {
     return;
   }
@@ -13033,7 +12969,7 @@ active_identity_json(const target::lattice_target_active_identity_t &id) {
   return out.str();
 }
 
-[[nodiscard]] bool resolve_runtime_root_arg(const std::string &args,
+[[nodiscard]] bool resolve_runtime_root_arg(const json_payload_t &args,
                                             lattice_context_t *ctx,
                                             fs::path *out, std::string *err) {
   std::string root_arg;
@@ -13084,7 +13020,8 @@ session_scan_for_runtime_root(
 }
 
 [[nodiscard]] exposure::exposure_build_context_t
-scan_context_from_config_args(const std::string &args, lattice_context_t *ctx) {
+scan_context_from_config_args(const json_payload_t &args,
+                              lattice_context_t *ctx) {
   exposure::exposure_build_context_t out{};
   if (ctx == nullptr) {
     return out;
@@ -13116,7 +13053,7 @@ default_runtime_index_path(const fs::path &runtime_root) {
   return runtime_root / "indexes" / "lattice_runtime_index.v1.lls";
 }
 
-[[nodiscard]] bool resolve_runtime_index_path_arg(const std::string &args,
+[[nodiscard]] bool resolve_runtime_index_path_arg(const json_payload_t &args,
                                                   lattice_context_t *ctx,
                                                   const fs::path &runtime_root,
                                                   fs::path *out,
@@ -13145,7 +13082,7 @@ default_runtime_index_path(const fs::path &runtime_root) {
 }
 
 [[nodiscard]] bool
-build_target_evaluator(const std::string &args, lattice_context_t *ctx,
+build_target_evaluator(const json_payload_t &args, lattice_context_t *ctx,
                        std::vector<target::lattice_target_spec_t> *targets_out,
                        exposure::exposure_ledger_scan_result_t *scan_out,
                        target::lattice_target_active_identity_t *identity_out,
@@ -13203,7 +13140,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_status(const std::string &args,
+[[nodiscard]] bool handle_status(const json_payload_t &args,
                                  lattice_context_t *ctx, std::string *out,
                                  std::string *err) {
   if (!validate_json_fields(args, {}, err)) {
@@ -13311,7 +13248,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_schema(const std::string &, lattice_context_t *,
+[[nodiscard]] bool handle_schema(const json_payload_t &, lattice_context_t *,
                                  std::string *out, std::string *) {
   std::ostringstream json;
   json << "{\"schema\":\"kikijyeba.lattice.hero_policy_schema.v1\""
@@ -13341,7 +13278,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_list_targets(const std::string &args,
+[[nodiscard]] bool handle_list_targets(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   std::string config_arg;
@@ -13397,7 +13334,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_explain_target(const std::string &args,
+[[nodiscard]] bool handle_explain_target(const json_payload_t &args,
                                          lattice_context_t *ctx,
                                          std::string *out, std::string *err) {
   std::string target_id;
@@ -13774,7 +13711,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool evaluate_target_common(const std::string &args,
+[[nodiscard]] bool evaluate_target_common(const json_payload_t &args,
                                           lattice_context_t *ctx,
                                           bool plan_only, std::string *out,
                                           std::string *err) {
@@ -14091,13 +14028,13 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_evaluate_target(const std::string &args,
+[[nodiscard]] bool handle_evaluate_target(const json_payload_t &args,
                                           lattice_context_t *ctx,
                                           std::string *out, std::string *err) {
   return evaluate_target_common(args, ctx, false, out, err);
 }
 
-[[nodiscard]] bool handle_evaluate_targets(const std::string &args,
+[[nodiscard]] bool handle_evaluate_targets(const json_payload_t &args,
                                            lattice_context_t *ctx,
                                            std::string *out, std::string *err) {
   int limit = policy_int_or(ctx->policy, "max_fact_preview", 64);
@@ -14262,14 +14199,14 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_target_deficit(const std::string &args,
+[[nodiscard]] bool handle_target_deficit(const json_payload_t &args,
                                          lattice_context_t *ctx,
                                          std::string *out, std::string *err) {
   return evaluate_target_common(args, ctx, true, out, err);
 }
 
 [[nodiscard]] bool evaluate_target_for_derived_query(
-    const std::string &args, lattice_context_t *ctx,
+    const json_payload_t &args, lattice_context_t *ctx,
     const std::string &target_id, target::lattice_target_evaluation_t *eval_out,
     fs::path *config_path_out, fs::path *runtime_root_out,
     target::lattice_target_active_identity_t *identity_out,
@@ -14278,10 +14215,10 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
 [[nodiscard]] bool target_satisfied_relation_value(
     const target::lattice_target_evaluation_t &eval);
 
-[[nodiscard]] bool handle_latest_satisfying_checkpoint(const std::string &args,
-                                                       lattice_context_t *ctx,
-                                                       std::string *out,
-                                                       std::string *err) {
+[[nodiscard]] bool
+handle_latest_satisfying_checkpoint(const json_payload_t &args,
+                                    lattice_context_t *ctx, std::string *out,
+                                    std::string *err) {
   std::string symbolic_hint;
   if (!parse_optional_string_arg(args, "symbolic_hint", {}, &symbolic_hint,
                                  err)) {
@@ -14483,7 +14420,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_scan_exposure(const std::string &args,
+[[nodiscard]] bool handle_scan_exposure(const json_payload_t &args,
                                         lattice_context_t *ctx,
                                         std::string *out, std::string *err) {
   fs::path runtime_root;
@@ -14709,7 +14646,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_list_fact_families(const std::string &args,
+[[nodiscard]] bool handle_list_fact_families(const json_payload_t &args,
                                              lattice_context_t *ctx,
                                              std::string *out,
                                              std::string *err) {
@@ -14746,7 +14683,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_scan_facts(const std::string &args,
+[[nodiscard]] bool handle_scan_facts(const json_payload_t &args,
                                      lattice_context_t *ctx, std::string *out,
                                      std::string *err) {
   fs::path runtime_root;
@@ -14815,7 +14752,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_fact_summary(const std::string &args,
+[[nodiscard]] bool handle_fact_summary(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   fs::path runtime_root;
@@ -14871,7 +14808,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_fact_lineage(const std::string &args,
+[[nodiscard]] bool handle_fact_lineage(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   fs::path runtime_root;
@@ -14956,7 +14893,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_fact_preview(const std::string &args,
+[[nodiscard]] bool handle_fact_preview(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   fs::path runtime_root;
@@ -15153,7 +15090,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_index_status(const std::string &args,
+[[nodiscard]] bool handle_index_status(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   fs::path runtime_root;
@@ -15233,7 +15170,7 @@ build_target_evaluator(const std::string &args, lattice_context_t *ctx,
   return true;
 }
 
-[[nodiscard]] bool handle_index_query(const std::string &args,
+[[nodiscard]] bool handle_index_query(const json_payload_t &args,
                                       lattice_context_t *ctx, std::string *out,
                                       std::string *err) {
   fs::path runtime_root;
@@ -15396,7 +15333,7 @@ canonical_derived_query_relation(std::string relation) {
 }
 
 [[nodiscard]] bool evaluate_target_for_derived_query(
-    const std::string &args, lattice_context_t *ctx,
+    const json_payload_t &args, lattice_context_t *ctx,
     const std::string &target_id, target::lattice_target_evaluation_t *eval_out,
     fs::path *config_path_out, fs::path *runtime_root_out,
     target::lattice_target_active_identity_t *identity_out,
@@ -15846,7 +15783,7 @@ evidence_dimension_comparison_rows(
   return out.str();
 }
 
-[[nodiscard]] bool handle_compare_evidence(const std::string &args,
+[[nodiscard]] bool handle_compare_evidence(const json_payload_t &args,
                                            lattice_context_t *ctx,
                                            std::string *out, std::string *err) {
   std::string left_target_id;
@@ -16182,7 +16119,7 @@ find_checkpoint_fact_for_path(
   return out.str();
 }
 
-[[nodiscard]] bool handle_derived_query(const std::string &args,
+[[nodiscard]] bool handle_derived_query(const json_payload_t &args,
                                         lattice_context_t *ctx,
                                         std::string *out, std::string *err) {
   std::string requested_relation;
@@ -16529,7 +16466,7 @@ find_checkpoint_fact_for_path(
   return false;
 }
 
-[[nodiscard]] bool handle_checkpoint_closure(const std::string &args,
+[[nodiscard]] bool handle_checkpoint_closure(const json_payload_t &args,
                                              lattice_context_t *ctx,
                                              std::string *out,
                                              std::string *err) {
@@ -16631,10 +16568,10 @@ find_checkpoint_fact_for_path(
   return true;
 }
 
-using handler_fn = bool (*)(const std::string &, lattice_context_t *,
+using handler_fn = bool (*)(const json_payload_t &, lattice_context_t *,
                             std::string *, std::string *);
 
-[[nodiscard]] bool handle_inspect_schema(const std::string &args,
+[[nodiscard]] bool handle_inspect_schema(const json_payload_t &args,
                                          lattice_context_t *ctx,
                                          std::string *out, std::string *err) {
   if (!validate_json_fields(args, {}, err)) {
@@ -16643,7 +16580,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_schema(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_targets(const std::string &args,
+[[nodiscard]] bool handle_inspect_targets(const json_payload_t &args,
                                           lattice_context_t *ctx,
                                           std::string *out, std::string *err) {
   if (!validate_json_fields(args, {"config_path"}, err)) {
@@ -16652,7 +16589,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_list_targets(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_target(const std::string &args,
+[[nodiscard]] bool handle_inspect_target(const json_payload_t &args,
                                          lattice_context_t *ctx,
                                          std::string *out, std::string *err) {
   if (!validate_json_fields(args, {"target_id", "config_path"}, err)) {
@@ -16661,7 +16598,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_explain_target(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_exposure(const std::string &args,
+[[nodiscard]] bool handle_inspect_exposure(const json_payload_t &args,
                                            lattice_context_t *ctx,
                                            std::string *out, std::string *err) {
   if (!validate_json_fields(args, {"runtime_root", "limit"}, err)) {
@@ -16670,7 +16607,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_scan_exposure(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_fact_families(const std::string &args,
+[[nodiscard]] bool handle_inspect_fact_families(const json_payload_t &args,
                                                 lattice_context_t *ctx,
                                                 std::string *out,
                                                 std::string *err) {
@@ -16680,7 +16617,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_list_fact_families(args, ctx, out, err);
 }
 
-[[nodiscard]] bool require_inspect_mode(const std::string &args,
+[[nodiscard]] bool require_inspect_mode(const json_payload_t &args,
                                         std::string_view tool,
                                         std::string *mode, std::string *err) {
   std::string raw;
@@ -16697,7 +16634,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return true;
 }
 
-[[nodiscard]] bool handle_inspect_facts_summary_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_facts_summary_tool(const json_payload_t &args,
                                                      lattice_context_t *ctx,
                                                      std::string *out,
                                                      std::string *err) {
@@ -16707,7 +16644,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_fact_summary(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_facts_scan_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_facts_scan_tool(const json_payload_t &args,
                                                   lattice_context_t *ctx,
                                                   std::string *out,
                                                   std::string *err) {
@@ -16718,7 +16655,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_scan_facts(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_facts_lineage_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_facts_lineage_tool(const json_payload_t &args,
                                                      lattice_context_t *ctx,
                                                      std::string *out,
                                                      std::string *err) {
@@ -16728,7 +16665,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
   return handle_fact_lineage(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_facts_preview_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_facts_preview_tool(const json_payload_t &args,
                                                      lattice_context_t *ctx,
                                                      std::string *out,
                                                      std::string *err) {
@@ -16739,7 +16676,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
 }
 
 [[nodiscard]] bool handle_inspect_facts_preview_by_digest_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_json_fields(
           args, {"runtime_root", "family", "limit", "fact_digest"}, err)) {
@@ -16757,7 +16694,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
 }
 
 [[nodiscard]] bool handle_inspect_facts_preview_by_digest_prefix_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_json_fields(
           args, {"runtime_root", "family", "limit", "fact_digest_prefix"},
@@ -16777,7 +16714,7 @@ using handler_fn = bool (*)(const std::string &, lattice_context_t *,
 }
 
 [[nodiscard]] bool
-handle_inspect_facts_preview_by_index_tool(const std::string &args,
+handle_inspect_facts_preview_by_index_tool(const json_payload_t &args,
                                            lattice_context_t *ctx,
                                            std::string *out, std::string *err) {
   if (!validate_json_fields(
@@ -16793,7 +16730,7 @@ handle_inspect_facts_preview_by_index_tool(const std::string &args,
   return handle_fact_preview(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_index_status_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_index_status_tool(const json_payload_t &args,
                                                     lattice_context_t *ctx,
                                                     std::string *out,
                                                     std::string *err) {
@@ -16805,7 +16742,7 @@ handle_inspect_facts_preview_by_index_tool(const std::string &args,
   return handle_index_status(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_index_query_tool(const std::string &args,
+[[nodiscard]] bool handle_inspect_index_query_tool(const json_payload_t &args,
                                                    lattice_context_t *ctx,
                                                    std::string *out,
                                                    std::string *err) {
@@ -16818,14 +16755,14 @@ handle_inspect_facts_preview_by_index_tool(const std::string &args,
 }
 
 [[nodiscard]] bool validate_index_query_selector_fields(
-    const std::string &args, std::string_view selector, std::string *err) {
+    const json_payload_t &args, std::string_view selector, std::string *err) {
   std::vector<std::string_view> allowed{"runtime_root", "index_path", "limit",
                                         "validation_strength"};
   if (!selector.empty()) {
     allowed.push_back(selector);
   }
   std::vector<json_field_t> fields;
-  if (!parse_json_object_fields(args, &fields, err)) {
+  if (!parse_json_object_fields(args.text(), &fields, err)) {
     return false;
   }
   for (const auto &field : fields) {
@@ -16853,29 +16790,31 @@ handle_inspect_facts_preview_by_index_tool(const std::string &args,
 }
 
 [[nodiscard]] bool handle_index_query_unproven_cache_forwarded(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   std::string forwarded;
   if (!with_fixed_json_raw_field(args, "compare_live_scan", "false", &forwarded,
                                  err)) {
     return false;
   }
-  if (!with_fixed_json_raw_field(forwarded, "allow_unproven_cache", "true",
-                                 &forwarded, err)) {
+  if (!with_fixed_json_raw_field(json_payload_t(std::move(forwarded)),
+                                 "allow_unproven_cache", "true", &forwarded,
+                                 err)) {
     return false;
   }
-  return handle_index_query(forwarded, ctx, out, err);
+  return handle_index_query(json_payload_t(std::move(forwarded)), ctx, out,
+                            err);
 }
 
 [[nodiscard]] bool handle_inspect_index_query_by_relation_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "relation", err) &&
          handle_index_query(args, ctx, out, err);
 }
 
 [[nodiscard]] bool
-handle_inspect_index_query_by_key_tool(const std::string &args,
+handle_inspect_index_query_by_key_tool(const json_payload_t &args,
                                        lattice_context_t *ctx, std::string *out,
                                        std::string *err) {
   return validate_index_query_selector_fields(args, "key", err) &&
@@ -16883,14 +16822,14 @@ handle_inspect_index_query_by_key_tool(const std::string &args,
 }
 
 [[nodiscard]] bool handle_inspect_index_query_by_key_contains_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "key_contains", err) &&
          handle_index_query(args, ctx, out, err);
 }
 
 [[nodiscard]] bool
-handle_inspect_index_query_by_digest_tool(const std::string &args,
+handle_inspect_index_query_by_digest_tool(const json_payload_t &args,
                                           lattice_context_t *ctx,
                                           std::string *out, std::string *err) {
   return validate_index_query_selector_fields(args, "digest", err) &&
@@ -16898,14 +16837,14 @@ handle_inspect_index_query_by_digest_tool(const std::string &args,
 }
 
 [[nodiscard]] bool handle_inspect_index_query_by_digest_prefix_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "digest_prefix", err) &&
          handle_index_query(args, ctx, out, err);
 }
 
 [[nodiscard]] bool handle_inspect_index_query_unproven_cache_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_index_query_selector_fields(args, "", err)) {
     return false;
@@ -16914,14 +16853,14 @@ handle_inspect_index_query_by_digest_tool(const std::string &args,
 }
 
 [[nodiscard]] bool handle_inspect_index_query_unproven_cache_by_relation_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "relation", err) &&
          handle_index_query_unproven_cache_forwarded(args, ctx, out, err);
 }
 
 [[nodiscard]] bool handle_inspect_index_query_unproven_cache_by_key_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "key", err) &&
          handle_index_query_unproven_cache_forwarded(args, ctx, out, err);
@@ -16929,14 +16868,14 @@ handle_inspect_index_query_by_digest_tool(const std::string &args,
 
 [[nodiscard]] bool
 handle_inspect_index_query_unproven_cache_by_key_contains_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "key_contains", err) &&
          handle_index_query_unproven_cache_forwarded(args, ctx, out, err);
 }
 
 [[nodiscard]] bool handle_inspect_index_query_unproven_cache_by_digest_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "digest", err) &&
          handle_index_query_unproven_cache_forwarded(args, ctx, out, err);
@@ -16944,13 +16883,13 @@ handle_inspect_index_query_unproven_cache_by_key_contains_tool(
 
 [[nodiscard]] bool
 handle_inspect_index_query_unproven_cache_by_digest_prefix_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return validate_index_query_selector_fields(args, "digest_prefix", err) &&
          handle_index_query_unproven_cache_forwarded(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_derived_relation_tool(const std::string &args,
+[[nodiscard]] bool handle_derived_relation_tool(const json_payload_t &args,
                                                 lattice_context_t *ctx,
                                                 std::string_view relation,
                                                 std::string *out,
@@ -16960,17 +16899,18 @@ handle_inspect_index_query_unproven_cache_by_digest_prefix_tool(
                                     err)) {
     return false;
   }
-  return handle_derived_query(forwarded, ctx, out, err);
+  return handle_derived_query(json_payload_t(std::move(forwarded)), ctx, out,
+                              err);
 }
 
-[[nodiscard]] bool validate_target_derived_fields(const std::string &args,
+[[nodiscard]] bool validate_target_derived_fields(const json_payload_t &args,
                                                   std::string *err) {
   return validate_json_fields(
       args, {"target_id", "config_path", "runtime_root", "limit"}, err);
 }
 
 [[nodiscard]] bool handle_inspect_derived_target_satisfied_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_target_derived_fields(args, err)) {
     return false;
@@ -16979,7 +16919,7 @@ handle_inspect_index_query_unproven_cache_by_digest_prefix_tool(
 }
 
 [[nodiscard]] bool handle_inspect_derived_forbidden_overlap_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_target_derived_fields(args, err)) {
     return false;
@@ -16988,7 +16928,7 @@ handle_inspect_index_query_unproven_cache_by_digest_prefix_tool(
 }
 
 [[nodiscard]] bool handle_inspect_derived_unresolved_lineage_target_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_target_derived_fields(args, err)) {
     return false;
@@ -16998,7 +16938,7 @@ handle_inspect_index_query_unproven_cache_by_digest_prefix_tool(
 }
 
 [[nodiscard]] bool
-handle_inspect_derived_stale_cache_tool(const std::string &args,
+handle_inspect_derived_stale_cache_tool(const json_payload_t &args,
                                         lattice_context_t *ctx,
                                         std::string *out, std::string *err) {
   if (!validate_json_fields(
@@ -17018,7 +16958,7 @@ enum class checkpoint_ancestor_selector_t {
   by_checkpoint_identity_with_ancestor_id,
 };
 
-[[nodiscard]] bool require_non_empty_string_field(const std::string &args,
+[[nodiscard]] bool require_non_empty_string_field(const json_payload_t &args,
                                                   std::string_view field,
                                                   std::string *err) {
   std::string value;
@@ -17033,7 +16973,7 @@ enum class checkpoint_ancestor_selector_t {
 }
 
 [[nodiscard]] bool
-validate_checkpoint_ancestor_fields(const std::string &args,
+validate_checkpoint_ancestor_fields(const json_payload_t &args,
                                     checkpoint_ancestor_selector_t selector,
                                     std::string *err) {
   std::vector<std::string_view> allowed{"runtime_root", "limit"};
@@ -17066,7 +17006,7 @@ validate_checkpoint_ancestor_fields(const std::string &args,
     allowed.push_back("ancestor_checkpoint_id");
   }
   std::vector<json_field_t> fields;
-  if (!parse_json_object_fields(args, &fields, err)) {
+  if (!parse_json_object_fields(args.text(), &fields, err)) {
     return false;
   }
   for (const auto &field : fields) {
@@ -17101,7 +17041,7 @@ validate_checkpoint_ancestor_fields(const std::string &args,
 }
 
 [[nodiscard]] bool
-handle_checkpoint_ancestor_split_tool(const std::string &args,
+handle_checkpoint_ancestor_split_tool(const json_payload_t &args,
                                       lattice_context_t *ctx,
                                       checkpoint_ancestor_selector_t selector,
                                       std::string *out, std::string *err) {
@@ -17113,7 +17053,7 @@ handle_checkpoint_ancestor_split_tool(const std::string &args,
 }
 
 [[nodiscard]] bool handle_inspect_derived_checkpoint_ancestor_by_path_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx, checkpoint_ancestor_selector_t::by_checkpoint_path, out, err);
@@ -17121,7 +17061,7 @@ handle_checkpoint_ancestor_split_tool(const std::string &args,
 
 [[nodiscard]] bool
 handle_inspect_derived_checkpoint_ancestor_by_path_with_ancestor_path_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx,
@@ -17131,7 +17071,7 @@ handle_inspect_derived_checkpoint_ancestor_by_path_with_ancestor_path_tool(
 
 [[nodiscard]] bool
 handle_inspect_derived_checkpoint_ancestor_by_path_with_ancestor_id_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx,
@@ -17140,7 +17080,7 @@ handle_inspect_derived_checkpoint_ancestor_by_path_with_ancestor_id_tool(
 }
 
 [[nodiscard]] bool handle_inspect_derived_checkpoint_ancestor_by_identity_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx, checkpoint_ancestor_selector_t::by_checkpoint_identity, out,
@@ -17149,7 +17089,7 @@ handle_inspect_derived_checkpoint_ancestor_by_path_with_ancestor_id_tool(
 
 [[nodiscard]] bool
 handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_path_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx,
@@ -17159,7 +17099,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_path_tool(
 
 [[nodiscard]] bool
 handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   return handle_checkpoint_ancestor_split_tool(
       args, ctx,
@@ -17168,7 +17108,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
 }
 
 [[nodiscard]] bool handle_inspect_derived_unresolved_lineage_checkpoint_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_json_fields(args,
                             {"runtime_root", "limit", "checkpoint_path",
@@ -17180,7 +17120,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
                                       err);
 }
 
-[[nodiscard]] bool handle_inspect_checkpoint(const std::string &args,
+[[nodiscard]] bool handle_inspect_checkpoint(const json_payload_t &args,
                                              lattice_context_t *ctx,
                                              std::string *out,
                                              std::string *err) {
@@ -17193,13 +17133,13 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
   return handle_checkpoint_closure(args, ctx, out, err);
 }
 
-[[nodiscard]] bool validate_evaluate_target_fields(const std::string &args,
+[[nodiscard]] bool validate_evaluate_target_fields(const json_payload_t &args,
                                                    std::string *err) {
   return validate_json_fields(
       args, {"target_id", "config_path", "runtime_root"}, err);
 }
 
-[[nodiscard]] bool handle_evaluate_target_tool(const std::string &args,
+[[nodiscard]] bool handle_evaluate_target_tool(const json_payload_t &args,
                                                lattice_context_t *ctx,
                                                std::string *out,
                                                std::string *err) {
@@ -17209,7 +17149,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
   return handle_evaluate_target(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_evaluate_targets_tool(const std::string &args,
+[[nodiscard]] bool handle_evaluate_targets_tool(const json_payload_t &args,
                                                 lattice_context_t *ctx,
                                                 std::string *out,
                                                 std::string *err) {
@@ -17220,7 +17160,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
   return handle_evaluate_targets(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_evaluate_deficit_tool(const std::string &args,
+[[nodiscard]] bool handle_evaluate_deficit_tool(const json_payload_t &args,
                                                 lattice_context_t *ctx,
                                                 std::string *out,
                                                 std::string *err) {
@@ -17231,7 +17171,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
 }
 
 [[nodiscard]] bool handle_evaluate_latest_satisfying_checkpoint_target_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_json_fields(args, {"target_id", "config_path", "runtime_root"},
                             err)) {
@@ -17241,7 +17181,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
 }
 
 [[nodiscard]] bool handle_evaluate_latest_satisfying_checkpoint_hint_tool(
-    const std::string &args, lattice_context_t *ctx, std::string *out,
+    const json_payload_t &args, lattice_context_t *ctx, std::string *out,
     std::string *err) {
   if (!validate_json_fields(
           args, {"symbolic_hint", "config_path", "runtime_root"}, err)) {
@@ -17250,7 +17190,7 @@ handle_inspect_derived_checkpoint_ancestor_by_identity_with_ancestor_id_tool(
   return handle_latest_satisfying_checkpoint(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_compare(const std::string &args,
+[[nodiscard]] bool handle_compare(const json_payload_t &args,
                                   lattice_context_t *ctx, std::string *out,
                                   std::string *err) {
   if (!validate_json_fields(
@@ -17499,7 +17439,8 @@ bool execute_tool_json(const std::string &tool_name, std::string arguments_json,
   }
   std::string structured;
   std::string err;
-  const bool ok = (*handler)(arguments_json, ctx, &structured, &err);
+  const json_payload_t arguments(arguments_json);
+  const bool ok = (*handler)(arguments, ctx, &structured, &err);
   if (!ok) {
     if (out_error_message) {
       *out_error_message = err;
@@ -17548,8 +17489,8 @@ std::string build_tools_list_human_text() {
 void run_jsonrpc_stdio_loop(lattice_context_t *ctx) {
   mcp_stdio::message_t message;
   while (mcp_stdio::read_message(std::cin, &message)) {
-    std::string line = trim_ascii(message.json);
-    if (line.empty()) {
+    const json_payload_t request(trim_ascii(message.json));
+    if (request.text().empty()) {
       continue;
     }
     const auto send = [&](std::string response) {
@@ -17557,9 +17498,9 @@ void run_jsonrpc_stdio_loop(lattice_context_t *ctx) {
                                 message.content_length_framed);
     };
     std::string id_raw = "null";
-    (void)extract_json_raw_field(line, "id", &id_raw);
+    (void)extract_json_raw_field(request, "id", &id_raw);
     std::string method;
-    if (!extract_json_string_field(line, "method", &method)) {
+    if (!extract_json_string_field(request, "method", &method)) {
       continue;
     }
     if (method == "notifications/initialized") {
@@ -17571,10 +17512,11 @@ void run_jsonrpc_stdio_loop(lattice_context_t *ctx) {
     if (method == "initialize") {
       std::string protocol = "2024-11-05";
       std::string params;
-      if (extract_json_raw_field(line, "params", &params)) {
-        (void)extract_json_string_field(params, "protocolVersion", &protocol);
+      if (extract_json_raw_field(request, "params", &params)) {
+        (void)extract_json_string_field(json_payload_t(std::move(params)),
+                                        "protocolVersion", &protocol);
       } else {
-        (void)extract_json_string_field(line, "protocolVersion", &protocol);
+        (void)extract_json_string_field(request, "protocolVersion", &protocol);
       }
       send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
            ",\"result\":{\"protocolVersion\":" + json_quote(protocol) +
@@ -17609,21 +17551,22 @@ void run_jsonrpc_stdio_loop(lattice_context_t *ctx) {
     }
     if (method == "tools/call") {
       std::string params;
-      if (!extract_json_raw_field(line, "params", &params)) {
+      if (!extract_json_raw_field(request, "params", &params)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing "
              "params\"}}");
         continue;
       }
+      const json_payload_t call(std::move(params));
       std::string name;
-      if (!extract_json_string_field(params, "name", &name)) {
+      if (!extract_json_string_field(call, "name", &name)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing tool "
              "name\"}}");
         continue;
       }
       std::string arguments = "{}";
-      (void)extract_json_raw_field(params, "arguments", &arguments);
+      (void)extract_json_raw_field(call, "arguments", &arguments);
       std::string result;
       std::string error;
       (void)execute_tool_json(name, arguments, ctx, &result, &error);
@@ -236,10 +236,20 @@ std::map<std::string, std::string> latent_lineage_state_instruction_t::to_map()
 
 latentLineageStatePipeline::latentLineageStatePipeline(std::string grammar_text)
     : grammar_text_(std::move(grammar_text)),
-      grammar_lexer_(require_non_ws_grammar_text_(grammar_text_)),
-      grammar_parser_(grammar_lexer_),
       grammar_(parseGrammarDefinition()),
-      instruction_parser_(instruction_lexer_, grammar_) {}
+      instruction_parser_(instruction_lexer_,
+                          compileGrammarText(grammar_text_)) {}
+
+latentLineageStatePipeline::latentLineageStatePipeline(
+    const std::filesystem::path& grammar_path)
+    : latentLineageStatePipeline(readGrammarFileCached(grammar_path)) {}
+
+latentLineageStatePipeline::latentLineageStatePipeline(
+    CachedGrammarFile grammar_file)
+    : grammar_text_(std::move(grammar_file.text)),
+      grammar_(grammar_file.compiled->grammar),
+      instruction_parser_(instruction_lexer_,
+                          std::move(grammar_file.compiled)) {}
 
 latent_lineage_state_instruction_t latentLineageStatePipeline::decode(std::string instruction) {
   std::lock_guard<std::mutex> lk(current_mutex_);
@@ -279,8 +289,9 @@ latent_lineage_state_instruction_t latentLineageStatePipeline::decode(std::strin
 }
 
 ProductionGrammar latentLineageStatePipeline::parseGrammarDefinition() {
-  grammar_parser_.parseGrammar();
-  return grammar_parser_.getGrammar();
+  /* compiled once per process per grammar text; see compileGrammarText */
+  return compileGrammarText(require_non_ws_grammar_text_(grammar_text_))
+      ->grammar;
 }
 
 latent_lineage_state_instruction_t decode_latent_lineage_state_from_dsl(
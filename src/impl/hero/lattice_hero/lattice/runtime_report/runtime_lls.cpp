@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <charconv>
 #include <cmath>
+#include <filesystem>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
@@ -13,6 +14,7 @@
 #include "hero/lattice_hero/lattice/lattice.h"
 #include "hero/lattice_hero/lattice/lhs.h"
 #include "hero/lattice_hero/lattice/runtime_report/report_taxonomy.h"
+#include "hero/lattice_hero/lattice/runtime_report/runtime_lls_view.h"
 #include "piaabo/db/idydb/idydb.h"
 #include "piaabo/io/files.h"
 
@@ -582,8 +584,9 @@ contains_forbidden_legacy_comment_markers(std::string_view text,
   }
 
   try {
+    namespace report = cuwacunu::hero::lattice::runtime_report;
     static cuwacunu::hero::lattice::latentLineageStatePipeline pipeline(
-        cuwacunu::hero::lattice::runtime_report::runtime_lls_grammar_text());
+        std::filesystem::path(report::runtime_lls_grammar_path()));
     const auto decoded = pipeline.decode(stripped);
     std::vector<entry_t> parsed = to_runtime_entries(decoded);
     if (!validate_entries(parsed, true, error))
@@ -704,46 +707,12 @@ bool parse_runtime_lls_text_fast_to_kv_map(
   }
   out->clear();
 
-  bool saw_schema = false;
-  std::size_t cursor = 0;
-  while (cursor < text.size()) {
-    std::size_t line_end = text.find('\n', cursor);
-    if (line_end == std::string_view::npos)
-      line_end = text.size();
-    std::string_view line = text.substr(cursor, line_end - cursor);
-    if (!line.empty() && line.back() == '\r')
-      line.remove_suffix(1);
-    const std::string trimmed = trim_ascii_copy(line);
-    if (!trimmed.empty() && trimmed.front() != '#') {
-      const std::size_t eq = trimmed.find('=');
-      if (eq == std::string_view::npos || eq == 0) {
-        set_error(error, "runtime .lls parse failure: invalid key/value line");
-        out->clear();
-        return false;
-      }
-      const std::string key =
-          cuwacunu::hero::lattice::extract_latent_lineage_state_lhs_key(
-              trim_ascii_copy(trimmed.substr(0, eq)));
-      if (key.empty()) {
-        set_error(error, "runtime .lls parse failure: invalid lhs key");
-        out->clear();
-        return false;
-      }
-      std::string value = trim_ascii_copy(trimmed.substr(eq + 1));
-      (*out)[key] = value;
-      if (key == "schema" && !value.empty())
-        saw_schema = true;
-    }
-    if (line_end == text.size())
-      break;
-    cursor = line_end + 1;
-  }
-
-  if (!saw_schema) {
-    set_error(error, "persisted runtime .lls requires top-level schema key");
-    out->clear();
+  std::vector<runtime_lls_kv_view_t> views;
+  if (!parse_runtime_lls_text_fast_views(text, &views, error))
     return false;
-  }
+  out->reserve(views.size());
+  for (const auto &view : views)
+    (*out)[std::string(view.key)] = std::string(view.value);
   return true;
 }
 
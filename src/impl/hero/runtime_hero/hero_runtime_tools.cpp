@@ -2,7 +2,9 @@
 
 #include "hero/config_derivation.h"
 #include "hero/config_path_defaults.h"
+#include "hero/json_field_index.h"
 #include "hero/lattice_hero/lattice/exposure/exposure_ledger.h"
+#include "hero/lattice_hero/lattice/runtime_report/runtime_lls_view.h"
 #include "hero/lattice_hero/lattice/split/split_policy.h"
 #include "hero/marshal_hero/marshal/digest.h"
 #include "hero/marshal_hero/marshal/rollout_marshal.h"
@@ -424,78 +426,12 @@ void skip_ws(const std::string &s, std::size_t *idx) {
   return *idx > begin;
 }
 
-[[nodiscard]] bool extract_json_raw_field(const std::string &json,
-                                          std::string_view key,
-                                          std::string *out) {
-  std::size_t idx = 0;
-  skip_ws(json, &idx);
-  if (idx >= json.size() || json[idx] != '{') {
-    return false;
-  }
-  ++idx;
-  while (idx < json.size()) {
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-    std::string current_key;
-    if (!parse_json_string_token(json, &idx, &current_key)) {
-      return false;
-    }
-    skip_ws(json, &idx);
-    if (idx >= json.size() || json[idx] != ':') {
-      return false;
-    }
-    ++idx;
-    skip_ws(json, &idx);
-    const std::size_t value_begin = idx;
-    if (!skip_json_value(json, &idx)) {
-      return false;
-    }
-    if (current_key == key) {
-      if (out) {
-        *out = trim_ascii(
-            std::string_view(json).substr(value_begin, idx - value_begin));
-      }
-      return true;
-    }
-    skip_ws(json, &idx);
-    if (idx < json.size() && json[idx] == ',') {
-      ++idx;
-      continue;
-    }
-    if (idx < json.size() && json[idx] == '}') {
-      return false;
-    }
-  }
-  return false;
-}
-
-[[nodiscard]] bool extract_json_string_field(const std::string &json,
-                                             std::string_view key,
-                                             std::string *out) {
-  std::string raw;
-  if (!extract_json_raw_field(json, key, &raw)) {
-    return false;
-  }
-  std::size_t idx = 0;
-  skip_ws(raw, &idx);
-  std::string value;
-  if (!parse_json_string_token(raw, &idx, &value)) {
-    return false;
-  }
-  skip_ws(raw, &idx);
-  if (idx != raw.size()) {
-    return false;
-  }
-  if (out) {
-    *out = std::move(value);
-  }
-  return true;
-}
+using cuwacunu::hero::json_field_index::extract_json_raw_field;
+using cuwacunu::hero::json_field_index::extract_json_string_field;
+using cuwacunu::hero::json_field_index::json_payload_t;
 
 [[nodiscard]] bool
-extract_json_first_string_field(const std::string &json,
+extract_json_first_string_field(const json_payload_t &json,
                                 std::initializer_list<std::string_view> keys,
                                 std::string *out) {
   for (const auto key : keys) {
@@ -557,7 +493,7 @@ extract_json_string_object(const std::string &json,
   return false;
 }
 
-[[nodiscard]] bool extract_json_bool_field(const std::string &json,
+[[nodiscard]] bool extract_json_bool_field(const json_payload_t &json,
                                            std::string_view key, bool *out) {
   std::string raw;
   if (!extract_json_raw_field(json, key, &raw)) {
@@ -579,7 +515,7 @@ extract_json_string_object(const std::string &json,
   return false;
 }
 
-[[nodiscard]] bool extract_json_int_field(const std::string &json,
+[[nodiscard]] bool extract_json_int_field(const json_payload_t &json,
                                           std::string_view key, int *out) {
   std::string raw;
   if (!extract_json_raw_field(json, key, &raw)) {
@@ -708,16 +644,16 @@ validate_allowed_fields(const std::vector<json_field_t> &fields,
 }
 
 [[nodiscard]] bool
-validate_tool_fields(const std::string &args,
+validate_tool_fields(const json_payload_t &args,
                      std::initializer_list<std::string_view> allowed,
                      std::vector<json_field_t> *fields, std::string *err) {
-  if (!parse_json_object_fields(args, fields, err)) {
+  if (!parse_json_object_fields(args.text(), fields, err)) {
     return false;
   }
   return validate_allowed_fields(*fields, allowed, err);
 }
 
-[[nodiscard]] bool parse_required_string_arg(const std::string &args,
+[[nodiscard]] bool parse_required_string_arg(const json_payload_t &args,
                                              std::string_view key,
                                              std::string *out,
                                              std::string *err) {
@@ -767,7 +703,7 @@ void append_string_json_field(std::ostringstream &out, std::string_view key,
   append_raw_json_field(out, key, json_quote(value), first);
 }
 
-void append_optional_raw_json_field(const std::string &args,
+void append_optional_raw_json_field(const json_payload_t &args,
                                     std::ostringstream &out,
                                     std::string_view key, bool *first) {
   std::string raw;
@@ -777,7 +713,7 @@ void append_optional_raw_json_field(const std::string &args,
 }
 
 [[nodiscard]] std::string
-object_with_selected_fields(const std::string &args,
+object_with_selected_fields(const json_payload_t &args,
                             std::initializer_list<std::string_view> keys) {
   std::ostringstream out;
   out << "{";
@@ -1226,6 +1162,33 @@ split_environment_profile_blocks(std::string_view text,
 
 [[nodiscard]] std::unordered_map<std::string, std::string>
 parse_kv_file(const fs::path &path) {
+  if (path.extension() == ".lls") {
+    // Runtime .lls facts use the mapped view (and any sidecar their producer
+    // left); files the fast parse rejects fall through to the permissive
+    // assignment parser below. Inline `#`/`;` comments are cut the way that
+    // parser cuts them, so both routes return the same map.
+    namespace runtime_report = cuwacunu::hero::lattice::runtime_report;
+    runtime_report::runtime_lls_view_options_t options{};
+    options.use_sidecar = true;
+    runtime_report::runtime_lls_file_view_t view{};
+    std::string ignored;
+    if (runtime_report::read_runtime_lls_file_views(path, options, &view,
+                                                    &ignored)) {
+      std::unordered_map<std::string, std::string> out;
+      out.reserve(view.entries().size());
+      for (const auto &entry : view.entries()) {
+        if (entry.key.find_first_of("#;") != std::string_view::npos) {
+          continue; // the comment starts before '=': not an assignment
+        }
+        std::string value(entry.value);
+        if (value.find_first_of("#;") != std::string::npos) {
+          value = trim_ascii(strip_ini_comment(value));
+        }
+        out[std::string(entry.key)] = std::move(value);
+      }
+      return out;
+    }
+  }
   std::string text;
   std::string ignored;
   if (!read_text_file(path, &text, &ignored)) {
@@ -1429,7 +1392,7 @@ append_kv_json_fields(const std::unordered_map<std::string, std::string> &map,
   return true;
 }
 
-[[nodiscard]] bool read_required_text_file_arg(const std::string &args,
+[[nodiscard]] bool read_required_text_file_arg(const json_payload_t &args,
                                                std::string_view path_key,
                                                fs::path *path,
                                                std::string *text,
@@ -1452,7 +1415,7 @@ append_kv_json_fields(const std::unordered_map<std::string, std::string> &map,
   return true;
 }
 
-[[nodiscard]] bool check_optional_string_digest_arg(const std::string &args,
+[[nodiscard]] bool check_optional_string_digest_arg(const json_payload_t &args,
                                                     std::string_view digest_key,
                                                     std::string_view actual,
                                                     std::string_view error_code,
@@ -1485,7 +1448,7 @@ runtime_handoff_file_digest(const std::string &handoff_text) {
 }
 
 [[nodiscard]] bool read_optional_runtime_handoff_artifact(
-    const std::string &args, std::string_view requested_mode,
+    const json_payload_t &args, std::string_view requested_mode,
     std::string *handoff_json, std::string *err) {
   if (handoff_json != nullptr) {
     handoff_json->clear();
@@ -1545,16 +1508,17 @@ runtime_handoff_file_digest(const std::string &handoff_text) {
   return true;
 }
 
-[[nodiscard]] bool append_handoff_wave_overlay(const std::string &handoff_json,
+[[nodiscard]] bool append_handoff_wave_overlay(const json_payload_t &handoff,
                                                std::ostringstream &out,
                                                bool *first, std::string *err) {
   std::string wave_raw;
-  if (!extract_json_raw_field(handoff_json, "wave", &wave_raw)) {
+  if (!extract_json_raw_field(handoff, "wave", &wave_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: wave is required";
     }
     return false;
   }
+  const json_payload_t wave(std::move(wave_raw));
 
   std::ostringstream overlay;
   overlay << "{";
@@ -1563,7 +1527,7 @@ runtime_handoff_file_digest(const std::string &handoff_text) {
        {"source_range", "anchor_index_begin", "anchor_index_end",
         "source_key_begin", "source_key_end"}) {
     std::string value;
-    if (extract_json_string_field(wave_raw, key, &value) &&
+    if (extract_json_string_field(wave, key, &value) &&
         !trim_ascii(value).empty()) {
       append_string_json_field(overlay, key, value, &overlay_first);
     }
@@ -1576,25 +1540,26 @@ runtime_handoff_file_digest(const std::string &handoff_text) {
 }
 
 [[nodiscard]] bool
-append_handoff_derived_run_fields(const std::string &handoff_json,
+append_handoff_derived_run_fields(const json_payload_t &handoff,
                                   std::ostringstream &out, bool *first,
                                   std::string *err) {
   std::string base_config_raw;
-  if (!extract_json_raw_field(handoff_json, "base_config", &base_config_raw)) {
+  if (!extract_json_raw_field(handoff, "base_config", &base_config_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: base_config is required";
     }
     return false;
   }
+  const json_payload_t base_config(std::move(base_config_raw));
   std::string base_config_path;
-  if (!extract_json_string_field(base_config_raw, "path", &base_config_path) ||
+  if (!extract_json_string_field(base_config, "path", &base_config_path) ||
       trim_ascii(base_config_path).empty()) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: base_config.path is required";
     }
     return false;
   }
-  if (extract_json_raw_field(base_config_raw, "hash", nullptr)) {
+  if (extract_json_raw_field(base_config, "hash", nullptr)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: base_config.hash is retired";
     }
@@ -1602,9 +1567,10 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
   }
 
   std::string runtime_policy_raw;
-  if (extract_json_raw_field(handoff_json, "runtime_policy",
+  if (extract_json_raw_field(handoff, "runtime_policy",
                              &runtime_policy_raw) &&
-      extract_json_raw_field(runtime_policy_raw, "hash", nullptr)) {
+      extract_json_raw_field(json_payload_t(std::move(runtime_policy_raw)),
+                             "hash", nullptr)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: runtime_policy.hash is retired";
     }
@@ -1612,15 +1578,15 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
   }
 
   std::string intent_raw;
-  if (!extract_json_raw_field(handoff_json, "intent", &intent_raw)) {
+  if (!extract_json_raw_field(handoff, "intent", &intent_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: intent is required";
     }
     return false;
   }
   bool force_rebuild_cache = false;
-  if (!extract_json_bool_field(intent_raw, "force_rebuild_cache",
-                               &force_rebuild_cache)) {
+  if (!extract_json_bool_field(json_payload_t(std::move(intent_raw)),
+                               "force_rebuild_cache", &force_rebuild_cache)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: intent.force_rebuild_cache is "
              "required";
@@ -1631,11 +1597,11 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
   append_string_json_field(out, "config_path", base_config_path, first);
   append_bool_json_field(out, "force_rebuild_cache", force_rebuild_cache,
                          first);
-  if (!append_handoff_wave_overlay(handoff_json, out, first, err)) {
+  if (!append_handoff_wave_overlay(handoff, out, first, err)) {
     return false;
   }
   std::string policy_execution_lock_fields_raw;
-  if (extract_json_raw_field(handoff_json, "policy_execution_input_lock_fields",
+  if (extract_json_raw_field(handoff, "policy_execution_input_lock_fields",
                              &policy_execution_lock_fields_raw)) {
     std::unordered_map<std::string, std::string> policy_execution_lock_fields;
     if (!extract_json_string_object(policy_execution_lock_fields_raw,
@@ -1658,9 +1624,11 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
     }
   }
   std::string policy_training_lock_raw;
-  if (extract_json_raw_field(handoff_json, "policy_training_execution_lock",
+  if (extract_json_raw_field(handoff, "policy_training_execution_lock",
                              &policy_training_lock_raw)) {
-    if (extract_json_raw_field(policy_training_lock_raw, "hash", nullptr)) {
+    const json_payload_t policy_training_lock(
+        std::move(policy_training_lock_raw));
+    if (extract_json_raw_field(policy_training_lock, "hash", nullptr)) {
       if (err) {
         *err = "E_RUNTIME_HANDOFF_INVALID: "
                "policy_training_execution_lock.hash is retired";
@@ -1668,7 +1636,7 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
       return false;
     }
     std::string lock_path;
-    if (!extract_json_string_field(policy_training_lock_raw, "path",
+    if (!extract_json_string_field(policy_training_lock, "path",
                                    &lock_path) ||
         trim_ascii(lock_path).empty()) {
       if (err) {
@@ -1678,7 +1646,7 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
       return false;
     }
     std::string lock_digest;
-    if (!extract_json_string_field(policy_training_lock_raw, "digest",
+    if (!extract_json_string_field(policy_training_lock, "digest",
                                    &lock_digest) ||
         trim_ascii(lock_digest).empty()) {
       if (err) {
@@ -1692,14 +1660,14 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
     append_string_json_field(out, "contract_digest", trim_ascii(lock_digest),
                              first);
   }
-  append_raw_json_field(out, "runtime_handoff", handoff_json, first);
+  append_raw_json_field(out, "runtime_handoff", handoff.text(), first);
   return true;
 }
 
-[[nodiscard]] bool materialize_runtime_run_args(const std::string &public_args,
-                                                std::string_view requested_mode,
-                                                std::string *out,
-                                                std::string *err) {
+[[nodiscard]] bool
+materialize_runtime_run_args(const json_payload_t &public_args,
+                             std::string_view requested_mode, std::string *out,
+                             std::string *err) {
   std::string handoff_json;
   if (!read_optional_runtime_handoff_artifact(public_args, requested_mode,
                                               &handoff_json, err)) {
@@ -1713,9 +1681,11 @@ append_handoff_derived_run_fields(const std::string &handoff_json,
                                  &first);
   append_optional_raw_json_field(public_args, resolved, "contract_digest",
                                  &first);
-  if (!handoff_json.empty() &&
-      !append_handoff_derived_run_fields(handoff_json, resolved, &first, err)) {
-    return false;
+  if (!handoff_json.empty()) {
+    const json_payload_t handoff(std::move(handoff_json));
+    if (!append_handoff_derived_run_fields(handoff, resolved, &first, err)) {
+      return false;
+    }
   }
   resolved << "}";
   if (out != nullptr) {
@@ -1741,7 +1711,7 @@ validate_kv_fields(const std::unordered_map<std::string, std::string> &map,
 }
 
 [[nodiscard]] bool append_top_or_kv_string_field(
-    const std::string &args,
+    const json_payload_t &args,
     const std::unordered_map<std::string, std::string> &map,
     std::string_view key, std::ostringstream &out, bool *first) {
   std::string raw;
@@ -1835,14 +1805,12 @@ validate_kv_fields(const std::unordered_map<std::string, std::string> &map,
     return false;
   }
 
-  std::string graph_grammar_text;
-  std::string grammar_read_error;
-  if (!read_text_file(graph_bnf_path, &graph_grammar_text,
-                      &grammar_read_error)) {
+  std::error_code grammar_ec;
+  if (!fs::is_regular_file(graph_bnf_path, grammar_ec)) {
     if (err != nullptr) {
       *err = "E_RUNTIME_POLICY_TRAINING_TARGET_NODE_IDS_GRAPH_GRAMMAR_READ_"
-             "FAILED: " +
-             grammar_read_error;
+             "FAILED: cannot open file: " +
+             graph_bnf_path.string();
     }
     return false;
   }
@@ -1860,7 +1828,8 @@ validate_kv_fields(const std::unordered_map<std::string, std::string> &map,
   std::vector<std::string> nodes;
   try {
     namespace graph = cuwacunu::kikijyeba::topology::graph;
-    graph::graph_topology_decoder_t decoder(graph_grammar_text);
+    /* the grammar compiles once per file; later runs load the .compiled cache */
+    graph::graph_topology_decoder_t decoder(graph_bnf_path);
     const auto topology = decoder.decode(graph_text);
     nodes.reserve(topology.graph_node_forms.size());
     for (const auto &node : topology.graph_node_forms) {
@@ -4131,12 +4100,12 @@ void append_unique_policy_execution_consumed_generation_vectors(
   try {
     namespace protocol = cuwacunu::kikijyeba::protocol;
     const auto bundle =
-        protocol::load_channel_graph_first_protocol_contract_from_config(
+        protocol::load_channel_graph_first_protocol_contract_cached(
             config_path);
     const std::string protocol_contract_fingerprint =
-        protocol::channel_graph_first_protocol_contract_fingerprint(bundle);
+        protocol::channel_graph_first_protocol_contract_fingerprint(*bundle);
     const std::string graph_order_fingerprint =
-        bundle.source_plan.market_graph.computed_graph_order_fingerprint();
+        bundle->source_plan.market_graph.computed_graph_order_fingerprint();
     return assign_or_confirm_policy_training_protocol_default(
                &contract->protocol_contract_fingerprint,
                "protocol_contract_fingerprint", protocol_contract_fingerprint,
@@ -6422,7 +6391,7 @@ struct wave_overlay_t {
   std::string source_key_end{};
 };
 
-[[nodiscard]] bool parse_wave_overlay_from_args(const std::string &args,
+[[nodiscard]] bool parse_wave_overlay_from_args(const json_payload_t &args,
                                                 wave_overlay_t *overlay,
                                                 std::string *err) {
   if (overlay == nullptr) {
@@ -6434,14 +6403,16 @@ struct wave_overlay_t {
     return true;
   }
   overlay->present = true;
-  (void)extract_json_string_field(raw, "source_range", &overlay->source_range);
-  (void)extract_json_string_field(raw, "anchor_index_begin",
+  const json_payload_t fields(std::move(raw));
+  (void)extract_json_string_field(fields, "source_range",
+                                  &overlay->source_range);
+  (void)extract_json_string_field(fields, "anchor_index_begin",
                                   &overlay->anchor_index_begin);
-  (void)extract_json_string_field(raw, "anchor_index_end",
+  (void)extract_json_string_field(fields, "anchor_index_end",
                                   &overlay->anchor_index_end);
-  (void)extract_json_string_field(raw, "source_key_begin",
+  (void)extract_json_string_field(fields, "source_key_begin",
                                   &overlay->source_key_begin);
-  (void)extract_json_string_field(raw, "source_key_end",
+  (void)extract_json_string_field(fields, "source_key_end",
                                   &overlay->source_key_end);
   if (trim_ascii(overlay->source_range).empty()) {
     if (!trim_ascii(overlay->anchor_index_begin).empty() ||
@@ -7541,7 +7512,7 @@ move_dev_nuke_target(const fs::path &root, const fs::path &target,
   return true;
 }
 
-[[nodiscard]] bool resolve_job_dir_from_args(const std::string &args,
+[[nodiscard]] bool resolve_job_dir_from_args(const json_payload_t &args,
                                              const runtime_policy_t &policy,
                                              fs::path *out, std::string *err) {
   std::string job_dir_arg;
@@ -8019,7 +7990,7 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
   return true;
 }
 
-[[nodiscard]] bool parse_optional_bool_arg(const std::string &args,
+[[nodiscard]] bool parse_optional_bool_arg(const json_payload_t &args,
                                            std::string_view key,
                                            bool default_value, bool *out,
                                            std::string *err) {
@@ -8033,7 +8004,7 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
   return true;
 }
 
-[[nodiscard]] bool parse_optional_int_arg(const std::string &args,
+[[nodiscard]] bool parse_optional_int_arg(const json_payload_t &args,
                                           std::string_view key,
                                           int default_value, int *out,
                                           std::string *err) {
@@ -8047,7 +8018,7 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
   return true;
 }
 
-[[nodiscard]] bool parse_optional_double_arg(const std::string &args,
+[[nodiscard]] bool parse_optional_double_arg(const json_payload_t &args,
                                              std::string_view key,
                                              double default_value, double *out,
                                              std::string *err) {
@@ -8061,10 +8032,10 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
   return true;
 }
 
-[[nodiscard]] bool parse_policy_training_required_int(const std::string &args,
-                                                      std::string_view key,
-                                                      int *out,
-                                                      std::string *err) {
+[[nodiscard]] bool
+parse_policy_training_required_int(const json_payload_t &args,
+                                   std::string_view key, int *out,
+                                   std::string *err) {
   if (!extract_json_raw_field(args, key, nullptr)) {
     *err = "missing required field: " + std::string(key);
     return false;
@@ -8079,7 +8050,7 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
 }
 
 [[nodiscard]] bool parse_required_string_arg_or_wave(
-    const std::string &args, std::string_view json_key,
+    const json_payload_t &args, std::string_view json_key,
     const wave_info_t *selected_wave, std::string_view wave_key,
     std::string *out, std::string *err) {
   if (extract_json_raw_field(args, json_key, nullptr)) {
@@ -8099,7 +8070,7 @@ validate_replay_report_for_validation_rollout(const fs::path &report_path,
 }
 
 [[nodiscard]] bool parse_optional_bool_arg_or_wave(
-    const std::string &args, std::string_view json_key,
+    const json_payload_t &args, std::string_view json_key,
     const wave_info_t *selected_wave, std::string_view wave_key,
     bool default_value, bool *out, std::string *err) {
   if (extract_json_raw_field(args, json_key, nullptr)) {
@@ -13439,17 +13410,17 @@ unique_policy_training_attempt_leaf(std::string_view contract_digest) {
 }
 
 [[nodiscard]] bool append_optional_double_cli_arg(
-    const std::string &args, std::string_view key, std::string_view flag,
+    const json_payload_t &args, std::string_view key, std::string_view flag,
     std::vector<std::string> *argv, std::string *err);
 
-[[nodiscard]] bool append_optional_int_cli_arg(const std::string &args,
+[[nodiscard]] bool append_optional_int_cli_arg(const json_payload_t &args,
                                                std::string_view key,
                                                std::string_view flag,
                                                std::vector<std::string> *argv,
                                                std::string *err);
 
 [[nodiscard]] bool execute_policy_training_ppo_v0(
-    const std::string &args,
+    const json_payload_t &args,
     const cuwacunu::hero::runtime::policy_training_job_contract_t &contract,
     const std::string &contract_text, std::string_view contract_digest,
     runtime_context_t *ctx, std::string *out, std::string *err) {
@@ -14741,7 +14712,7 @@ unique_policy_training_attempt_leaf(std::string_view contract_digest) {
 
 [[nodiscard]] bool handle_policy_training_contract_object(
     cuwacunu::hero::runtime::policy_training_job_contract_t contract,
-    const std::string &execution_args, std::string_view requested_mode,
+    const json_payload_t &execution_args, std::string_view requested_mode,
     runtime_context_t *ctx, std::string *out, std::string *err) {
   namespace runtime_contract = cuwacunu::hero::runtime;
   apply_policy_training_request_fixed_contract_values(&contract);
@@ -14976,7 +14947,7 @@ void apply_policy_training_request_fixed_contract_values(
 }
 
 [[nodiscard]] bool handle_policy_training_contract(
-    const std::string &args, std::string_view requested_mode,
+    const json_payload_t &args, std::string_view requested_mode,
     runtime_context_t *ctx, std::string *out, std::string *err) {
   namespace runtime_contract = cuwacunu::hero::runtime;
   std::optional<wave_info_t> selected_wave;
@@ -15838,12 +15809,12 @@ struct runtime_handoff_binding_t {
 };
 
 [[nodiscard]] bool validate_runtime_handoff_object(
-    const std::string &handoff_raw, const fs::path &config_path,
+    const json_payload_t &handoff, const fs::path &config_path,
     const fs::path &policy_path, bool dry_run, bool force_rebuild_cache,
     std::string *wave_raw, runtime_handoff_binding_t *binding,
     std::string *err) {
   std::string schema_version;
-  if (!extract_json_string_field(handoff_raw, "handoff_schema_version",
+  if (!extract_json_string_field(handoff, "handoff_schema_version",
                                  &schema_version) ||
       schema_version != "1") {
     if (err) {
@@ -15853,7 +15824,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string handoff_id;
-  if (!extract_json_string_field(handoff_raw, "handoff_id", &handoff_id) ||
+  if (!extract_json_string_field(handoff, "handoff_id", &handoff_id) ||
       trim_ascii(handoff_id).empty()) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: handoff_id is required";
@@ -15862,7 +15833,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string handoff_digest;
-  if (!extract_json_string_field(handoff_raw, "handoff_digest",
+  if (!extract_json_string_field(handoff, "handoff_digest",
                                  &handoff_digest) ||
       trim_ascii(handoff_digest).empty() ||
       handoff_id != "runtime_handoff_" + handoff_digest) {
@@ -15874,11 +15845,11 @@ struct runtime_handoff_binding_t {
   }
 
   std::string target_driver_run_id;
-  (void)extract_json_string_field(handoff_raw, "target_driver_run_id",
+  (void)extract_json_string_field(handoff, "target_driver_run_id",
                                   &target_driver_run_id);
 
   std::string created_by;
-  if (!extract_json_string_field(handoff_raw, "created_by", &created_by) ||
+  if (!extract_json_string_field(handoff, "created_by", &created_by) ||
       created_by != "marshal") {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: created_by must be marshal";
@@ -15887,7 +15858,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string created_at;
-  if (!extract_json_string_field(handoff_raw, "created_at", &created_at) ||
+  if (!extract_json_string_field(handoff, "created_at", &created_at) ||
       trim_ascii(created_at).empty()) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: created_at is required";
@@ -15896,7 +15867,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string target_id;
-  if (!extract_json_string_field(handoff_raw, "target_id", &target_id) ||
+  if (!extract_json_string_field(handoff, "target_id", &target_id) ||
       trim_ascii(target_id).empty()) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: target_id is required";
@@ -15905,7 +15876,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string unresolved_raw;
-  if (!extract_json_raw_field(handoff_raw, "unresolved_symbols",
+  if (!extract_json_raw_field(handoff, "unresolved_symbols",
                               &unresolved_raw) ||
       !json_raw_is_empty_array(unresolved_raw)) {
     if (err) {
@@ -15916,24 +15887,25 @@ struct runtime_handoff_binding_t {
   }
 
   std::string base_config_raw;
-  if (!extract_json_raw_field(handoff_raw, "base_config", &base_config_raw)) {
+  if (!extract_json_raw_field(handoff, "base_config", &base_config_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: base_config is required";
     }
     return false;
   }
+  const json_payload_t base_config(std::move(base_config_raw));
   std::string base_config_path;
   std::string base_config_digest;
   const std::string actual_base_config_digest = file_digest_or_empty(
       config_path, "kikijyeba.runtime.handoff.base_config_file.v1");
-  if (extract_json_raw_field(base_config_raw, "hash", nullptr)) {
+  if (extract_json_raw_field(base_config, "hash", nullptr)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: base_config.hash is retired";
     }
     return false;
   }
-  if (!extract_json_string_field(base_config_raw, "path", &base_config_path) ||
-      !extract_json_string_field(base_config_raw, "digest",
+  if (!extract_json_string_field(base_config, "path", &base_config_path) ||
+      !extract_json_string_field(base_config, "digest",
                                  &base_config_digest) ||
       trim_ascii(base_config_digest).empty() ||
       base_config_digest != actual_base_config_digest ||
@@ -15946,26 +15918,27 @@ struct runtime_handoff_binding_t {
   }
 
   std::string runtime_policy_raw;
-  if (!extract_json_raw_field(handoff_raw, "runtime_policy",
+  if (!extract_json_raw_field(handoff, "runtime_policy",
                               &runtime_policy_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: runtime_policy is required";
     }
     return false;
   }
+  const json_payload_t runtime_policy(std::move(runtime_policy_raw));
   std::string runtime_policy_path;
   std::string runtime_policy_digest;
   const std::string actual_runtime_policy_digest = file_digest_or_empty(
       policy_path, "kikijyeba.runtime.handoff.runtime_policy_file.v1");
-  if (extract_json_raw_field(runtime_policy_raw, "hash", nullptr)) {
+  if (extract_json_raw_field(runtime_policy, "hash", nullptr)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: runtime_policy.hash is retired";
     }
     return false;
   }
-  if (!extract_json_string_field(runtime_policy_raw, "path",
+  if (!extract_json_string_field(runtime_policy, "path",
                                  &runtime_policy_path) ||
-      !extract_json_string_field(runtime_policy_raw, "digest",
+      !extract_json_string_field(runtime_policy, "digest",
                                  &runtime_policy_digest) ||
       trim_ascii(runtime_policy_path).empty() ||
       trim_ascii(runtime_policy_digest).empty() ||
@@ -15979,22 +15952,23 @@ struct runtime_handoff_binding_t {
   }
 
   std::string intent_raw;
-  if (!extract_json_raw_field(handoff_raw, "intent", &intent_raw)) {
+  if (!extract_json_raw_field(handoff, "intent", &intent_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: intent is required";
     }
     return false;
   }
+  const json_payload_t intent(std::move(intent_raw));
   bool intent_dry_run = false;
   bool intent_force_rebuild_cache = false;
-  if (extract_json_raw_field(intent_raw, "confirm_execute", nullptr)) {
+  if (extract_json_raw_field(intent, "confirm_execute", nullptr)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: intent.confirm_execute is retired";
     }
     return false;
   }
-  if (!extract_json_bool_field(intent_raw, "dry_run", &intent_dry_run) ||
-      !extract_json_bool_field(intent_raw, "force_rebuild_cache",
+  if (!extract_json_bool_field(intent, "dry_run", &intent_dry_run) ||
+      !extract_json_bool_field(intent, "force_rebuild_cache",
                                &intent_force_rebuild_cache) ||
       intent_dry_run != dry_run ||
       intent_force_rebuild_cache != force_rebuild_cache) {
@@ -16005,7 +15979,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string local_wave_raw;
-  if (!extract_json_raw_field(handoff_raw, "wave", &local_wave_raw)) {
+  if (!extract_json_raw_field(handoff, "wave", &local_wave_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: wave is required";
     }
@@ -16013,7 +15987,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string checkpoint_inputs_raw;
-  if (!extract_json_raw_field(handoff_raw, "checkpoint_inputs",
+  if (!extract_json_raw_field(handoff, "checkpoint_inputs",
                               &checkpoint_inputs_raw)) {
     if (err) {
       *err = "E_RUNTIME_HANDOFF_INVALID: checkpoint_inputs is required";
@@ -16039,7 +16013,8 @@ struct runtime_handoff_binding_t {
 
   std::string wave_inputs_raw;
   std::unordered_map<std::string, std::string> wave_inputs;
-  if (extract_json_raw_field(local_wave_raw, "model_state_inputs",
+  const json_payload_t local_wave(std::move(local_wave_raw));
+  if (extract_json_raw_field(local_wave, "model_state_inputs",
                              &wave_inputs_raw)) {
     if (!extract_json_string_object(wave_inputs_raw, &wave_inputs)) {
       if (err) {
@@ -16065,7 +16040,7 @@ struct runtime_handoff_binding_t {
 
   std::string lattice_refs_raw;
   std::unordered_map<std::string, std::string> lattice_refs;
-  if (!extract_json_raw_field(handoff_raw, "lattice_certificate_refs",
+  if (!extract_json_raw_field(handoff, "lattice_certificate_refs",
                               &lattice_refs_raw) ||
       !extract_json_string_object(lattice_refs_raw, &lattice_refs)) {
     if (err) {
@@ -16076,7 +16051,7 @@ struct runtime_handoff_binding_t {
   }
 
   if (wave_raw) {
-    *wave_raw = std::move(local_wave_raw);
+    *wave_raw = local_wave.text();
   }
   if (binding) {
     binding->handoff_id = std::move(handoff_id);
@@ -16088,21 +16063,22 @@ struct runtime_handoff_binding_t {
 }
 
 [[nodiscard]] bool expected_wave_matches_runtime_wave(
-    const std::string &args, const fs::path &config_path,
+    const json_payload_t &args, const fs::path &config_path,
     const fs::path &policy_path, bool dry_run, bool force_rebuild_cache,
     const wave_info_t &wave, runtime_handoff_binding_t *binding,
     std::unordered_map<std::string, std::string> *effective_model_state_inputs,
     std::string *err) {
   std::string expected_raw;
   std::string handoff_raw;
-  if (args.find("\"runtime_handoff\"") != std::string::npos) {
+  if (args.text().find("\"runtime_handoff\"") != std::string::npos) {
     if (!extract_json_raw_field(args, "runtime_handoff", &handoff_raw)) {
       if (err) {
         *err = "E_RUNTIME_HANDOFF_INVALID: runtime_handoff is malformed";
       }
       return false;
     }
-    if (!validate_runtime_handoff_object(handoff_raw, config_path, policy_path,
+    const json_payload_t handoff(std::move(handoff_raw));
+    if (!validate_runtime_handoff_object(handoff, config_path, policy_path,
                                          dry_run, force_rebuild_cache,
                                          &expected_raw, binding, err)) {
       return false;
@@ -16110,10 +16086,11 @@ struct runtime_handoff_binding_t {
   } else {
     return true;
   }
+  const json_payload_t expected(std::move(expected_raw));
 
   std::string expected_target;
   if (extract_json_first_string_field(
-          expected_raw, {"target_component_family_id"}, &expected_target)) {
+          expected, {"target_component_family_id"}, &expected_target)) {
     const std::string actual_target = wave.values.count("TARGET") != 0
                                           ? wave.values.at("TARGET")
                                           : std::string{};
@@ -16127,7 +16104,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_mode;
-  if (extract_json_first_string_field(expected_raw, {"mode"}, &expected_mode)) {
+  if (extract_json_first_string_field(expected, {"mode"}, &expected_mode)) {
     const std::string actual_mode = wave.values.count("MODE") != 0
                                         ? wave.values.at("MODE")
                                         : std::string{"run"};
@@ -16151,7 +16128,7 @@ struct runtime_handoff_binding_t {
       wave.values.count("SOURCE_KEY_END") == 0;
 
   std::string expected_source_range;
-  if (extract_json_string_field(expected_raw, "source_range",
+  if (extract_json_string_field(expected, "source_range",
                                 &expected_source_range)) {
     expected_source_range = canonical_source_range(expected_source_range);
     const bool concrete_overlay_request =
@@ -16167,7 +16144,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_source_order;
-  if (extract_json_string_field(expected_raw, "source_order",
+  if (extract_json_string_field(expected, "source_order",
                                 &expected_source_order)) {
     expected_source_order = lowercase_ascii(trim_ascii(expected_source_order));
     const std::string actual_mode = wave.values.count("MODE") != 0
@@ -16184,7 +16161,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_begin;
-  if (extract_json_string_field(expected_raw, "anchor_index_begin",
+  if (extract_json_string_field(expected, "anchor_index_begin",
                                 &expected_begin)) {
     const std::string actual_begin =
         wave.values.count("ANCHOR_INDEX_BEGIN") != 0
@@ -16200,7 +16177,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_end;
-  if (extract_json_string_field(expected_raw, "anchor_index_end",
+  if (extract_json_string_field(expected, "anchor_index_end",
                                 &expected_end)) {
     const std::string actual_end = wave.values.count("ANCHOR_INDEX_END") != 0
                                        ? wave.values.at("ANCHOR_INDEX_END")
@@ -16215,7 +16192,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_source_key_begin;
-  if (extract_json_string_field(expected_raw, "source_key_begin",
+  if (extract_json_string_field(expected, "source_key_begin",
                                 &expected_source_key_begin)) {
     const std::string actual_begin = wave.values.count("SOURCE_KEY_BEGIN") != 0
                                          ? wave.values.at("SOURCE_KEY_BEGIN")
@@ -16230,7 +16207,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_source_key_end;
-  if (extract_json_string_field(expected_raw, "source_key_end",
+  if (extract_json_string_field(expected, "source_key_end",
                                 &expected_source_key_end)) {
     const std::string actual_end = wave.values.count("SOURCE_KEY_END") != 0
                                        ? wave.values.at("SOURCE_KEY_END")
@@ -16245,7 +16222,7 @@ struct runtime_handoff_binding_t {
   }
 
   std::string expected_inputs_raw;
-  if (extract_json_raw_field(expected_raw, "model_state_inputs",
+  if (extract_json_raw_field(expected, "model_state_inputs",
                              &expected_inputs_raw)) {
     std::unordered_map<std::string, std::string> expected_inputs;
     if (!extract_json_string_object(expected_inputs_raw, &expected_inputs)) {
@@ -16305,7 +16282,7 @@ void append_model_state_checkpoint_arg(
   argv->push_back(fs::path(found->second).lexically_normal().string());
 }
 
-[[nodiscard]] bool handle_status(const std::string &args,
+[[nodiscard]] bool handle_status(const json_payload_t &args,
                                  runtime_context_t *ctx, std::string *out,
                                  std::string *err) {
   std::vector<json_field_t> fields;
@@ -16352,7 +16329,7 @@ void append_model_state_checkpoint_arg(
   return true;
 }
 
-[[nodiscard]] bool handle_schema(const std::string &, runtime_context_t *,
+[[nodiscard]] bool handle_schema(const json_payload_t &, runtime_context_t *,
                                  std::string *out, std::string *) {
   std::ostringstream json;
   json << "{\"keys\":[";
@@ -16374,8 +16351,9 @@ void append_model_state_checkpoint_arg(
   return true;
 }
 
-[[nodiscard]] bool handle_wave(const std::string &args, runtime_context_t *ctx,
-                               std::string *out, std::string *) {
+[[nodiscard]] bool handle_wave(const json_payload_t &args,
+                               runtime_context_t *ctx, std::string *out,
+                               std::string *) {
   std::string config_arg;
   (void)extract_json_string_field(args, "config_path", &config_arg);
   *out = wave_info_json(
@@ -16383,7 +16361,7 @@ void append_model_state_checkpoint_arg(
   return true;
 }
 
-[[nodiscard]] bool execute_runtime(const std::string &args,
+[[nodiscard]] bool execute_runtime(const json_payload_t &args,
                                    runtime_context_t *ctx, bool force_dry_run,
                                    std::string *out, std::string *err) {
   std::string config_arg;
@@ -16527,20 +16505,20 @@ void append_model_state_checkpoint_arg(
   return true;
 }
 
-[[nodiscard]] bool handle_dry_run(const std::string &args,
+[[nodiscard]] bool handle_dry_run(const json_payload_t &args,
                                   runtime_context_t *ctx, std::string *out,
                                   std::string *err) {
   return execute_runtime(args, ctx, true, out, err);
 }
 
-[[nodiscard]] bool handle_execute(const std::string &args,
+[[nodiscard]] bool handle_execute(const json_payload_t &args,
                                   runtime_context_t *ctx, std::string *out,
                                   std::string *err) {
   return execute_runtime(args, ctx, false, out, err);
 }
 
 [[nodiscard]] bool append_optional_double_cli_arg(
-    const std::string &args, std::string_view key, std::string_view flag,
+    const json_payload_t &args, std::string_view key, std::string_view flag,
     std::vector<std::string> *argv, std::string *err) {
   std::string raw;
   if (!extract_json_raw_field(args, key, &raw)) {
@@ -16556,7 +16534,7 @@ void append_model_state_checkpoint_arg(
   return true;
 }
 
-[[nodiscard]] bool append_optional_int_cli_arg(const std::string &args,
+[[nodiscard]] bool append_optional_int_cli_arg(const json_payload_t &args,
                                                std::string_view key,
                                                std::string_view flag,
                                                std::vector<std::string> *argv,
@@ -16575,7 +16553,7 @@ void append_model_state_checkpoint_arg(
 }
 
 [[nodiscard]] bool
-append_optional_string_cli_arg(const std::string &args, std::string_view key,
+append_optional_string_cli_arg(const json_payload_t &args, std::string_view key,
                                std::string_view flag,
                                std::vector<std::string> *argv) {
   std::string value;
@@ -16612,7 +16590,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return json.str();
 }
 
-[[nodiscard]] bool handle_replay(const std::string &args,
+[[nodiscard]] bool handle_replay(const json_payload_t &args,
                                  runtime_context_t *ctx, std::string *out,
                                  std::string *err) {
   fs::path job_dir;
@@ -16908,7 +16886,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return true;
 }
 
-[[nodiscard]] bool handle_dev_nuke(const std::string &args,
+[[nodiscard]] bool handle_dev_nuke(const json_payload_t &args,
                                    runtime_context_t *ctx, std::string *out,
                                    std::string *err) {
   std::string root_arg;
@@ -17055,7 +17033,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return true;
 }
 
-[[nodiscard]] bool handle_list_jobs(const std::string &args,
+[[nodiscard]] bool handle_list_jobs(const json_payload_t &args,
                                     runtime_context_t *ctx, std::string *out,
                                     std::string *err) {
   std::string root_arg;
@@ -17131,6 +17109,14 @@ replay_dry_run_json(const std::vector<std::string> &argv,
          << ",\"accepted_anchor_count\":"
          << json_quote(manifest.count("accepted_anchor_count") != 0
                            ? manifest.at("accepted_anchor_count")
+                           : "")
+         << ",\"compute_role\":"
+         << json_quote(manifest.count("compute_role") != 0
+                           ? manifest.at("compute_role")
+                           : "")
+         << ",\"compute_cores_per_job\":"
+         << json_quote(manifest.count("compute_cores_per_job") != 0
+                           ? manifest.at("compute_cores_per_job")
                            : "");
     if (include_artifacts) {
       json << ",\"artifacts\":"
@@ -17145,7 +17131,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return true;
 }
 
-[[nodiscard]] bool handle_get_job(const std::string &args,
+[[nodiscard]] bool handle_get_job(const json_payload_t &args,
                                   runtime_context_t *ctx, std::string *out,
                                   std::string *err) {
   fs::path job_dir;
@@ -17170,7 +17156,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return true;
 }
 
-[[nodiscard]] bool handle_read_artifact(const std::string &args,
+[[nodiscard]] bool handle_read_artifact(const json_payload_t &args,
                                         runtime_context_t *ctx,
                                         std::string *out, std::string *err) {
   std::string explicit_path_arg;
@@ -17250,7 +17236,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return true;
 }
 
-[[nodiscard]] bool handle_inspect_schema(const std::string &args,
+[[nodiscard]] bool handle_inspect_schema(const json_payload_t &args,
                                          runtime_context_t *ctx,
                                          std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -17260,7 +17246,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_schema(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_wave(const std::string &args,
+[[nodiscard]] bool handle_inspect_wave(const json_payload_t &args,
                                        runtime_context_t *ctx, std::string *out,
                                        std::string *err) {
   std::vector<json_field_t> fields;
@@ -17270,7 +17256,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_wave(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_jobs(const std::string &args,
+[[nodiscard]] bool handle_inspect_jobs(const json_payload_t &args,
                                        runtime_context_t *ctx, std::string *out,
                                        std::string *err) {
   std::vector<json_field_t> fields;
@@ -17281,7 +17267,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_list_jobs(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_job(const std::string &args,
+[[nodiscard]] bool handle_inspect_job(const json_payload_t &args,
                                       runtime_context_t *ctx, std::string *out,
                                       std::string *err) {
   std::vector<json_field_t> fields;
@@ -17293,7 +17279,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_get_job(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_artifact_job(const std::string &args,
+[[nodiscard]] bool handle_inspect_artifact_job(const json_payload_t &args,
                                                runtime_context_t *ctx,
                                                std::string *out,
                                                std::string *err) {
@@ -17305,7 +17291,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_read_artifact(args, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_inspect_artifact_path(const std::string &args,
+[[nodiscard]] bool handle_inspect_artifact_path(const json_payload_t &args,
                                                 runtime_context_t *ctx,
                                                 std::string *out,
                                                 std::string *err) {
@@ -17324,7 +17310,7 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return handle_read_artifact(args, ctx, out, err);
 }
 
-[[nodiscard]] bool policy_training_wave_requested(const std::string &args) {
+[[nodiscard]] bool policy_training_wave_requested(const json_payload_t &args) {
   return extract_json_raw_field(args, "policy_kind", nullptr) ||
          extract_json_raw_field(args, "policy_id", nullptr) ||
          extract_json_raw_field(args, "training_schedule_mode", nullptr) ||
@@ -17927,12 +17913,12 @@ replay_dry_run_json(const std::vector<std::string> &argv,
   return out.str();
 }
 
-[[nodiscard]] bool handle_run_policy_training(const std::string &args,
+[[nodiscard]] bool handle_run_policy_training(const json_payload_t &args,
                                               runtime_context_t *ctx,
                                               std::string *out,
                                               std::string *err);
 
-[[nodiscard]] bool handle_run_policy_training(const std::string &args,
+[[nodiscard]] bool handle_run_policy_training(const json_payload_t &args,
                                               runtime_context_t *ctx,
                                               std::string *out,
                                               std::string *err) {
@@ -17984,9 +17970,10 @@ replay_dry_run_json(const std::vector<std::string> &argv,
     return false;
   }
 
+  const json_payload_t execution_args(
+      policy_training_contract_execution_args_json(contract));
   return handle_policy_training_contract_object(
-      contract, policy_training_contract_execution_args_json(contract),
-      requested_mode, ctx, out, err);
+      contract, execution_args, requested_mode, ctx, out, err);
 }
 
 struct policy_training_replay_source_candidate_t {
@@ -18151,7 +18138,7 @@ struct policy_training_replay_source_candidate_t {
 }
 
 [[nodiscard]] bool synthesize_policy_training_wave_contract(
-    const std::string &run_args, runtime_context_t *ctx,
+    const json_payload_t &run_args, runtime_context_t *ctx,
     cuwacunu::hero::runtime::policy_training_job_contract_t *out,
     std::string *err) {
   if (ctx == nullptr || out == nullptr) {
@@ -18240,13 +18227,12 @@ struct policy_training_replay_source_candidate_t {
 }
 
 [[nodiscard]] bool handle_runtime_wave_run_materialized(
-    const std::string &run_args, std::string_view requested_mode,
+    const json_payload_t &run_args, std::string_view requested_mode,
     runtime_context_t *ctx, std::string *out, std::string *err) {
   if (extract_json_raw_field(run_args, "contract_path", nullptr)) {
-    return handle_run_policy_training(
-        object_with_selected_fields(
-            run_args, {"requested_mode", "contract_path", "contract_digest"}),
-        ctx, out, err);
+    const json_payload_t training_args(object_with_selected_fields(
+        run_args, {"requested_mode", "contract_path", "contract_digest"}));
+    return handle_run_policy_training(training_args, ctx, out, err);
   }
 
   std::optional<wave_info_t> selected_wave;
@@ -18266,9 +18252,10 @@ struct policy_training_replay_source_candidate_t {
                                                     err)) {
         return false;
       }
+      const json_payload_t execution_args(
+          policy_training_contract_execution_args_json(contract));
       return handle_policy_training_contract_object(
-          contract, policy_training_contract_execution_args_json(contract),
-          requested_mode, ctx, out, err);
+          contract, execution_args, requested_mode, ctx, out, err);
     }
     *err =
         "E_RUNTIME_POLICY_COMPONENT_DRIVER_MATERIALIZED_CONTRACT_REQUIRED: "
@@ -18290,11 +18277,13 @@ struct policy_training_replay_source_candidate_t {
   append_bool_json_field(forwarded, "dry_run", requested_mode == "dry_run",
                          &first);
   forwarded << "}";
-  return execute_runtime(forwarded.str(), ctx, false, out, err);
+  return execute_runtime(json_payload_t(forwarded.str()), ctx, false, out,
+                         err);
 }
 
-[[nodiscard]] bool handle_run(const std::string &args, runtime_context_t *ctx,
-                              std::string *out, std::string *err) {
+[[nodiscard]] bool handle_run(const json_payload_t &args,
+                              runtime_context_t *ctx, std::string *out,
+                              std::string *err) {
   std::vector<json_field_t> fields;
   if (!validate_tool_fields(args,
                             {"mode", "runtime_handoff_path",
@@ -18329,11 +18318,11 @@ struct policy_training_replay_source_candidate_t {
   if (!materialize_runtime_run_args(args, requested_mode, &run_args, err)) {
     return false;
   }
-  return handle_runtime_wave_run_materialized(run_args, requested_mode, ctx,
-                                              out, err);
+  return handle_runtime_wave_run_materialized(
+      json_payload_t(std::move(run_args)), requested_mode, ctx, out, err);
 }
 
-[[nodiscard]] bool handle_replay_internal(const std::string &args,
+[[nodiscard]] bool handle_replay_internal(const json_payload_t &args,
                                           runtime_context_t *ctx,
                                           std::string *out, std::string *err) {
   std::vector<json_field_t> fields;
@@ -18414,11 +18403,12 @@ struct policy_training_replay_source_candidate_t {
   append_bool_json_field(forwarded, "dry_run", requested_mode != "execute",
                          &first);
   forwarded << "}";
-  return handle_replay(forwarded.str(), ctx, out, err);
+  return handle_replay(json_payload_t(forwarded.str()), ctx, out, err);
 }
 
-[[nodiscard]] bool handle_reset(const std::string &args, runtime_context_t *ctx,
-                                std::string *out, std::string *err) {
+[[nodiscard]] bool handle_reset(const json_payload_t &args,
+                                runtime_context_t *ctx, std::string *out,
+                                std::string *err) {
   std::vector<json_field_t> fields;
   if (!validate_tool_fields(args, {"mode", "runtime_root", "backup"}, &fields,
                             err)) {
@@ -18441,10 +18431,10 @@ struct policy_training_replay_source_candidate_t {
   append_bool_json_field(forwarded, "dry_run", requested_mode == "plan",
                          &first);
   forwarded << "}";
-  return handle_dev_nuke(forwarded.str(), ctx, out, err);
+  return handle_dev_nuke(json_payload_t(forwarded.str()), ctx, out, err);
 }
 
-using handler_fn = bool (*)(const std::string &, runtime_context_t *,
+using handler_fn = bool (*)(const json_payload_t &, runtime_context_t *,
                             std::string *, std::string *);
 
 [[nodiscard]] std::optional<handler_fn> find_handler(std::string_view name) {
@@ -18633,7 +18623,8 @@ bool execute_tool_json(const std::string &tool_name, std::string arguments_json,
 
   std::string structured;
   std::string err;
-  const bool ok = (*handler)(arguments_json, ctx, &structured, &err);
+  const json_payload_t arguments(arguments_json);
+  const bool ok = (*handler)(arguments, ctx, &structured, &err);
   if (!ok) {
     if (err.empty()) {
       err = "E_RUNTIME_HANDLER_FAILED_WITHOUT_DIAGNOSTIC";
@@ -18690,8 +18681,8 @@ bool execute_replay_delegate_json(std::string arguments_json,
 
   std::string structured;
   std::string err;
-  const bool ok =
-      handle_replay_internal(arguments_json, ctx, &structured, &err);
+  const json_payload_t arguments(arguments_json);
+  const bool ok = handle_replay_internal(arguments, ctx, &structured, &err);
   if (!ok) {
     if (err.empty()) {
       err = "E_RUNTIME_REPLAY_DELEGATE_FAILED_WITHOUT_DIAGNOSTIC";
@@ -18746,8 +18737,8 @@ void run_jsonrpc_stdio_loop(runtime_context_t *ctx) {
   mcp_stdio::message_t message;
   bool shutdown_seen = false;
   while (mcp_stdio::read_message(std::cin, &message)) {
-    std::string line = trim_ascii(message.json);
-    if (line.empty()) {
+    const json_payload_t request(trim_ascii(message.json));
+    if (request.text().empty()) {
       continue;
     }
     const auto send = [&](std::string response) {
@@ -18755,9 +18746,9 @@ void run_jsonrpc_stdio_loop(runtime_context_t *ctx) {
                                 message.content_length_framed);
     };
     std::string id_raw = "null";
-    (void)extract_json_raw_field(line, "id", &id_raw);
+    (void)extract_json_raw_field(request, "id", &id_raw);
     std::string method;
-    if (!extract_json_string_field(line, "method", &method)) {
+    if (!extract_json_string_field(request, "method", &method)) {
       continue;
     }
     if (method == "notifications/initialized") {
@@ -18769,10 +18760,11 @@ void run_jsonrpc_stdio_loop(runtime_context_t *ctx) {
     if (method == "initialize") {
       std::string protocol = "2024-11-05";
       std::string params;
-      if (extract_json_raw_field(line, "params", &params)) {
-        (void)extract_json_string_field(params, "protocolVersion", &protocol);
+      if (extract_json_raw_field(request, "params", &params)) {
+        (void)extract_json_string_field(json_payload_t(std::move(params)),
+                                        "protocolVersion", &protocol);
       } else {
-        (void)extract_json_string_field(line, "protocolVersion", &protocol);
+        (void)extract_json_string_field(request, "protocolVersion", &protocol);
       }
       send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
            ",\"result\":{\"protocolVersion\":" + json_quote(protocol) +
@@ -18808,21 +18800,22 @@ void run_jsonrpc_stdio_loop(runtime_context_t *ctx) {
     }
     if (method == "tools/call") {
       std::string params;
-      if (!extract_json_raw_field(line, "params", &params)) {
+      if (!extract_json_raw_field(request, "params", &params)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing "
              "params\"}}");
         continue;
       }
+      const json_payload_t call(std::move(params));
       std::string name;
-      if (!extract_json_string_field(params, "name", &name)) {
+      if (!extract_json_string_field(call, "name", &name)) {
         send(std::string("{\"jsonrpc\":\"2.0\",\"id\":") + id_raw +
              ",\"error\":{\"code\":-32602,\"message\":\"missing tool "
              "name\"}}");
         continue;
       }
       std::string arguments = "{}";
-      (void)extract_json_raw_field(params, "arguments", &arguments);
+      (void)extract_json_raw_field(call, "arguments", &arguments);
       std::string result;
       std::string error;
       (void)execute_tool_json(name, arguments, ctx, &result, &error);
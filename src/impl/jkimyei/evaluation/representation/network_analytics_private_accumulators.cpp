@@ -4,7 +4,7 @@
 #include "hero/lattice_hero/lattice/lhs.h"
 #include "hero/lattice_hero/lattice/runtime_report/runtime_lls.h"
 #include "piaabo/tensor/network_design/network_design.h"
-#include <ATen/ops/linalg_svd.h>
+#include "piaabo/tensor/torch/tensor_summary.h"
 #include <torch/torch.h>
 
 #include <algorithm>
@@ -88,6 +88,8 @@ struct spectral_aggregate_t {
   std::uint64_t spectral_tensor_count{0};
   std::uint64_t spectral_skipped_tensor_count{0};
   std::uint64_t spectral_failed_tensor_count{0};
+  std::uint64_t spectral_exact_tensor_count{0};
+  double max_spectral_norm_rel_error_bound{0.0};
 
   double sum_spectral_norm{0.0};
   double max_spectral_norm{0.0};
@@ -286,6 +288,14 @@ normalize_options_(const network_analytics_options_t &options) {
     out.spectral_max_elements = 1;
   if (out.anomaly_top_k < 0)
     out.anomaly_top_k = 0;
+  out.spectral_method = lower_ascii_copy_(
+      std::string(trim_ascii_ws_view_(out.spectral_method)));
+  if (out.spectral_method != "exact")
+    out.spectral_method = "randomized";
+  if (out.spectral_rank < 1)
+    out.spectral_rank = 1;
+  if (out.spectral_power_iterations < 0)
+    out.spectral_power_iterations = 0;
   return out;
 }
 
@@ -548,43 +558,92 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
   if (!tensor.defined())
     return;
 
-  auto flattened = tensor.detach()
-                       .to(torch::kCPU)
-                       .to(torch::kFloat64)
-                       .contiguous()
-                       .flatten();
-  const std::int64_t n64 = flattened.numel();
-  if (n64 <= 0)
+  const auto moments =
+      cuwacunu::piaabo::tensor::torch::summarize_tensor_moments(tensor);
+  if (moments.count == 0)
     return;
 
   ++out->buffer_tensor_count;
-  out->total_buffer_count += static_cast<std::uint64_t>(n64);
-
-  auto nan_mask = torch::isnan(flattened);
-  auto inf_mask = torch::isinf(flattened);
-  auto finite_mask = torch::isfinite(flattened);
-
-  const std::uint64_t nan_count =
-      static_cast<std::uint64_t>(nan_mask.sum().item<std::int64_t>());
-  const std::uint64_t inf_count =
-      static_cast<std::uint64_t>(inf_mask.sum().item<std::int64_t>());
-  const std::uint64_t finite_count =
-      static_cast<std::uint64_t>(finite_mask.sum().item<std::int64_t>());
+  out->total_buffer_count += moments.count;
+  out->nan_buffer_count += moments.nan_count;
+  out->inf_buffer_count += moments.inf_count;
+  out->finite_buffer_count += moments.finite_count;
 
-  out->nan_buffer_count += nan_count;
-  out->inf_buffer_count += inf_count;
-  out->finite_buffer_count += finite_count;
-
-  if (finite_count == 0)
+  if (moments.finite_count == 0)
     return;
-  auto finite_values = flattened.masked_select(finite_mask);
-  const double tensor_max_abs = finite_values.abs().max().item<double>();
-  if (tensor_max_abs > out->max_abs_buffer_value) {
-    out->max_abs_buffer_value = tensor_max_abs;
+  if (moments.max_abs > out->max_abs_buffer_value) {
+    out->max_abs_buffer_value = moments.max_abs;
     out->max_abs_buffer_name = tensor_name;
   }
 }
 
+void accumulate_matrix_spectrum_(const torch::Tensor &param,
+                                 std::int64_t rows, std::int64_t cols,
+                                 const network_analytics_options_t &options,
+                                 tensor_snapshot_t *snapshot,
+                                 spectral_aggregate_t *spectral_acc) {
+  auto matrix = param.detach()
+                    .to(torch::kCPU)
+                    .to(torch::kFloat64)
+                    .contiguous()
+                    .view({rows, cols});
+
+  cuwacunu::piaabo::tensor::torch::matrix_spectrum_options_t spectrum_options{};
+  spectrum_options.exact = (options.spectral_method == "exact");
+  spectrum_options.rank = options.spectral_rank;
+  spectrum_options.power_iterations = options.spectral_power_iterations;
+  const auto spectrum = cuwacunu::piaabo::tensor::torch::
+      summarize_matrix_spectrum(matrix, spectrum_options);
+  if (spectrum.singular_values.empty()) {
+    ++spectral_acc->spectral_skipped_tensor_count;
+    return;
+  }
+
+  const double spectral_norm = spectrum.spectral_norm();
+  const double stable_rank = safe_ratio(
+      spectrum.frobenius_sq, spectral_norm * spectral_norm + kNumericEpsilon);
+  const double effective_rank = spectrum.effective_rank();
+
+  // Row and column norm moments come back in one host read.
+  const auto row_norms = matrix.square().sum(1).sqrt();
+  const auto col_norms = matrix.square().sum(0).sqrt();
+  const auto norm_moments =
+      torch::stack({row_norms.mean(), row_norms.var(/*unbiased=*/false),
+                    col_norms.mean(), col_norms.var(/*unbiased=*/false)})
+          .contiguous();
+  const double *m = norm_moments.data_ptr<double>();
+  const double row_norm_cv =
+      std::sqrt(std::max(0.0, m[1])) / (std::abs(m[0]) + kNumericEpsilon);
+  const double col_norm_cv =
+      std::sqrt(std::max(0.0, m[3])) / (std::abs(m[2]) + kNumericEpsilon);
+
+  snapshot->spectral_computed = true;
+  snapshot->spectral_norm = spectral_norm;
+  snapshot->stable_rank = stable_rank;
+  snapshot->effective_rank = effective_rank;
+
+  ++spectral_acc->spectral_tensor_count;
+  if (spectrum.exact)
+    ++spectral_acc->spectral_exact_tensor_count;
+  spectral_acc->max_spectral_norm_rel_error_bound =
+      std::max(spectral_acc->max_spectral_norm_rel_error_bound,
+               spectrum.spectral_norm_relative_error_bound());
+  spectral_acc->sum_spectral_norm += spectral_norm;
+  spectral_acc->max_spectral_norm =
+      std::max(spectral_acc->max_spectral_norm, spectral_norm);
+
+  spectral_acc->sum_stable_rank += stable_rank;
+  spectral_acc->min_stable_rank =
+      std::min(spectral_acc->min_stable_rank, stable_rank);
+
+  spectral_acc->sum_effective_rank += effective_rank;
+  spectral_acc->min_effective_rank =
+      std::min(spectral_acc->min_effective_rank, effective_rank);
+
+  spectral_acc->sum_row_norm_cv += row_norm_cv;
+  spectral_acc->sum_col_norm_cv += col_norm_cv;
+}
+
 [[nodiscard]] tensor_snapshot_t analyze_parameter_tensor_(
     const std::string &tensor_name, const torch::Tensor &param,
     const network_analytics_options_t &options,
@@ -603,26 +662,32 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
   if (param.requires_grad())
     ++acc->trainable_tensor_count;
 
-  auto flattened =
-      param.detach().to(torch::kCPU).to(torch::kFloat64).contiguous().flatten();
-  const std::int64_t n64 = flattened.numel();
+  // One fused pass yields counts, moments, zero ratios and the histogram.
+  cuwacunu::piaabo::tensor::torch::tensor_moments_options_t moment_options{};
+  moment_options.near_zero_epsilon = std::max(options.near_zero_epsilon, 0.0);
+  if (hist_counts != nullptr && !hist_counts->empty()) {
+    moment_options.log10_abs_bins =
+        static_cast<std::int64_t>(hist_counts->size());
+    moment_options.log10_abs_min = options.log10_abs_histogram_min;
+    moment_options.log10_abs_max = options.log10_abs_histogram_max;
+    moment_options.log10_abs_offset =
+        std::max(options.near_zero_epsilon, 1e-16);
+    moment_options.keep_log10_abs_values =
+        (hist_counts->size() == 1 && exact_logabs_samples != nullptr);
+  }
+  auto moments = cuwacunu::piaabo::tensor::torch::summarize_tensor_moments(
+      param, moment_options);
+  const std::int64_t n64 = static_cast<std::int64_t>(moments.count);
   if (n64 <= 0)
     return snapshot;
 
-  const std::uint64_t total_count = static_cast<std::uint64_t>(n64);
+  const std::uint64_t total_count = moments.count;
   snapshot.total_count = total_count;
   acc->total_parameter_count += total_count;
 
-  auto nan_mask = torch::isnan(flattened);
-  auto inf_mask = torch::isinf(flattened);
-  auto finite_mask = torch::isfinite(flattened);
-
-  const std::uint64_t nan_count =
-      static_cast<std::uint64_t>(nan_mask.sum().item<std::int64_t>());
-  const std::uint64_t inf_count =
-      static_cast<std::uint64_t>(inf_mask.sum().item<std::int64_t>());
-  const std::uint64_t finite_count =
-      static_cast<std::uint64_t>(finite_mask.sum().item<std::int64_t>());
+  const std::uint64_t nan_count = moments.nan_count;
+  const std::uint64_t inf_count = moments.inf_count;
+  const std::uint64_t finite_count = moments.finite_count;
 
   snapshot.nan_count = nan_count;
   snapshot.inf_count = inf_count;
@@ -636,24 +701,16 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
       safe_ratio(static_cast<double>(nan_count + inf_count),
                  static_cast<double>(total_count));
 
-  double tensor_rms = 0.0;
-  double tensor_max_abs = 0.0;
-
   if (finite_count > 0) {
-    auto finite_values = flattened.masked_select(finite_mask);
-    auto abs_values = finite_values.abs();
+    acc->sum += moments.sum;
+    acc->sum_sq += moments.sum_sq;
 
-    acc->sum += finite_values.sum().item<double>();
-    acc->sum_sq += finite_values.pow(2).sum().item<double>();
+    if (moments.min < acc->min)
+      acc->min = moments.min;
+    if (moments.max > acc->max)
+      acc->max = moments.max;
 
-    const double tensor_min = finite_values.min().item<double>();
-    const double tensor_max = finite_values.max().item<double>();
-    if (tensor_min < acc->min)
-      acc->min = tensor_min;
-    if (tensor_max > acc->max)
-      acc->max = tensor_max;
-
-    tensor_max_abs = abs_values.max().item<double>();
+    const double tensor_max_abs = moments.max_abs;
     if (tensor_max_abs > acc->max_abs)
       acc->max_abs = tensor_max_abs;
     if (tensor_max_abs > acc->max_abs_tensor_value) {
@@ -661,64 +718,30 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
       acc->max_abs_tensor_name = tensor_name;
     }
 
-    const double abs_sum = abs_values.sum().item<double>();
-    acc->sum_abs += abs_sum;
-
-    auto positive_abs = abs_values.masked_select(abs_values.gt(0.0));
-    const std::uint64_t non_zero_abs_count =
-        static_cast<std::uint64_t>(positive_abs.numel());
-    acc->non_zero_abs_count += non_zero_abs_count;
-    if (non_zero_abs_count > 0) {
-      acc->sum_abs_log_abs +=
-          (positive_abs * positive_abs.log()).sum().item<double>();
-    }
-
-    const double near_zero_epsilon = std::max(options.near_zero_epsilon, 0.0);
-    const std::uint64_t near_zero_count = static_cast<std::uint64_t>(
-        abs_values.le(near_zero_epsilon).sum().item<std::int64_t>());
-    const std::uint64_t exact_zero_count = static_cast<std::uint64_t>(
-        finite_values.eq(0.0).sum().item<std::int64_t>());
-
-    acc->near_zero_count += near_zero_count;
-    acc->exact_zero_count += exact_zero_count;
+    acc->sum_abs += moments.sum_abs;
+    acc->non_zero_abs_count += moments.non_zero_abs_count;
+    acc->sum_abs_log_abs += moments.sum_abs_log_abs;
+    acc->near_zero_count += moments.near_zero_count;
+    acc->exact_zero_count += moments.exact_zero_count;
 
-    snapshot.near_zero_ratio = safe_ratio(static_cast<double>(near_zero_count),
-                                          static_cast<double>(finite_count));
+    snapshot.near_zero_ratio =
+        safe_ratio(static_cast<double>(moments.near_zero_count),
+                   static_cast<double>(finite_count));
 
-    tensor_rms =
-        std::sqrt(std::max(0.0, finite_values.pow(2).mean().item<double>()));
+    const double tensor_rms = std::sqrt(
+        std::max(0.0, moments.sum_sq / static_cast<double>(finite_count)));
     snapshot.max_abs_over_rms =
         safe_ratio(tensor_max_abs, tensor_rms + kNumericEpsilon);
 
     acc->tensor_rms.push_back(tensor_rms);
 
-    if (hist_counts != nullptr && !hist_counts->empty()) {
-      const std::int64_t bins = static_cast<std::int64_t>(hist_counts->size());
-      const double hmin = options.log10_abs_histogram_min;
-      const double hmax = options.log10_abs_histogram_max;
-      if (bins > 0 && hmax > hmin) {
-        const double eps = std::max(options.near_zero_epsilon, 1e-16);
-        auto logabs = (abs_values + eps).log10().clamp(hmin, hmax);
-        auto scaled =
-            ((logabs - hmin) / (hmax - hmin)) * static_cast<double>(bins);
-        auto idx = torch::clamp(scaled.to(torch::kLong), 0, bins - 1);
-        auto bincount =
-            torch::bincount(idx, c10::nullopt, bins).to(torch::kCPU);
-        for (std::int64_t i = 0; i < bins; ++i) {
-          (*hist_counts)[static_cast<std::size_t>(i)] +=
-              static_cast<std::uint64_t>(bincount[i].item<std::int64_t>());
-        }
-
-        if (bins == 1 && exact_logabs_samples != nullptr) {
-          const auto sample_count = static_cast<std::size_t>(logabs.numel());
-          exact_logabs_samples->reserve(exact_logabs_samples->size() +
-                                        sample_count);
-          auto flattened_logabs = logabs.contiguous().flatten();
-          const double *begin = flattened_logabs.data_ptr<double>();
-          exact_logabs_samples->insert(exact_logabs_samples->end(), begin,
-                                       begin + sample_count);
-        }
-      }
+    for (std::size_t i = 0; i < moments.log10_abs_histogram.size(); ++i) {
+      (*hist_counts)[i] += moments.log10_abs_histogram[i];
+    }
+    if (!moments.log10_abs_values.empty()) {
+      exact_logabs_samples->insert(exact_logabs_samples->end(),
+                                   moments.log10_abs_values.begin(),
+                                   moments.log10_abs_values.end());
     }
   }
 
@@ -744,72 +767,8 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
           ++spectral_acc->spectral_skipped_tensor_count;
         } else {
           try {
-            auto matrix = param.detach()
-                              .to(torch::kCPU)
-                              .to(torch::kFloat64)
-                              .contiguous()
-                              .view({rows, cols});
-            auto svd_result =
-                at::linalg_svd(matrix,
-                               /*full_matrices=*/false, c10::nullopt);
-            auto singular_values =
-                std::get<1>(svd_result).to(torch::kFloat64).contiguous();
-
-            if (singular_values.numel() > 0) {
-              const double spectral_norm = singular_values.max().item<double>();
-              const double fro_norm_sq = matrix.pow(2).sum().item<double>();
-              const double stable_rank = safe_ratio(
-                  fro_norm_sq, spectral_norm * spectral_norm + kNumericEpsilon);
-
-              double effective_rank = 0.0;
-              const double sigma_sum = singular_values.sum().item<double>();
-              if (sigma_sum > 0.0) {
-                auto probs = singular_values / sigma_sum;
-                auto positive = probs.masked_select(probs.gt(0.0));
-                if (positive.numel() > 0) {
-                  const double entropy =
-                      -(positive * positive.log()).sum().item<double>();
-                  effective_rank = std::exp(entropy);
-                }
-              }
-
-              const auto row_norms = matrix.pow(2).sum(1).sqrt();
-              const auto col_norms = matrix.pow(2).sum(0).sqrt();
-
-              const double row_mean = row_norms.mean().item<double>();
-              const double col_mean = col_norms.mean().item<double>();
-              const double row_var =
-                  (row_norms - row_mean).pow(2).mean().item<double>();
-              const double col_var =
-                  (col_norms - col_mean).pow(2).mean().item<double>();
-              const double row_norm_cv = std::sqrt(std::max(0.0, row_var)) /
-                                         (std::abs(row_mean) + kNumericEpsilon);
-              const double col_norm_cv = std::sqrt(std::max(0.0, col_var)) /
-                                         (std::abs(col_mean) + kNumericEpsilon);
-
-              snapshot.spectral_computed = true;
-              snapshot.spectral_norm = spectral_norm;
-              snapshot.stable_rank = stable_rank;
-              snapshot.effective_rank = effective_rank;
-
-              ++spectral_acc->spectral_tensor_count;
-              spectral_acc->sum_spectral_norm += spectral_norm;
-              spectral_acc->max_spectral_norm =
-                  std::max(spectral_acc->max_spectral_norm, spectral_norm);
-
-              spectral_acc->sum_stable_rank += stable_rank;
-              spectral_acc->min_stable_rank =
-                  std::min(spectral_acc->min_stable_rank, stable_rank);
-
-              spectral_acc->sum_effective_rank += effective_rank;
-              spectral_acc->min_effective_rank =
-                  std::min(spectral_acc->min_effective_rank, effective_rank);
-
-              spectral_acc->sum_row_norm_cv += row_norm_cv;
-              spectral_acc->sum_col_norm_cv += col_norm_cv;
-            } else {
-              ++spectral_acc->spectral_skipped_tensor_count;
-            }
+            accumulate_matrix_spectrum_(param, rows, cols, options, &snapshot,
+                                        spectral_acc);
           } catch (...) {
             ++spectral_acc->spectral_failed_tensor_count;
           }
@@ -886,6 +845,13 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
   append_int_entry_(&document, "anomaly_top_k",
                     report.normalized_options.anomaly_top_k,
                     kRefRangeNonNegative);
+  append_string_entry_if_nonempty_(&document, "spectral_method",
+                                   report.normalized_options.spectral_method);
+  append_int_entry_(&document, "spectral_rank",
+                    report.normalized_options.spectral_rank, kRefRangePositive);
+  append_int_entry_(&document, "spectral_power_iterations",
+                    report.normalized_options.spectral_power_iterations,
+                    kRefRangeNonNegative);
 
   append_nonneg_double_entry_(&document, "tensor_rms_mean",
                               report.tensor_rms_mean);
@@ -931,6 +897,10 @@ void accumulate_buffer_tensor_(const std::string &tensor_name,
                     report.spectral_skipped_tensor_count, kRefRangeNonNegative);
   append_u64_entry_(&document, "spectral_failed_tensor_count",
                     report.spectral_failed_tensor_count, kRefRangeNonNegative);
+  append_u64_entry_(&document, "spectral_exact_tensor_count",
+                    report.spectral_exact_tensor_count, kRefRangeNonNegative);
+  append_nonneg_double_entry_(&document, "spectral_norm_rel_error_bound_max",
+                              report.spectral_norm_rel_error_bound_max);
   append_nonneg_double_entry_(&document, "spectral_norm_mean",
                               report.spectral_norm_mean);
   append_nonneg_double_entry_(&document, "spectral_norm_max",
@@ -598,7 +598,8 @@ bool resolve_network_analytics_options_from_network_design(
            key == "log10_abs_histogram_min" ||
            key == "log10_abs_histogram_max" || key == "include_buffers" ||
            key == "enable_spectral_metrics" || key == "spectral_max_elements" ||
-           key == "anomaly_top_k";
+           key == "anomaly_top_k" || key == "spectral_method" ||
+           key == "spectral_rank" || key == "spectral_power_iterations";
   };
 
   for (const auto &param : node.params) {
@@ -741,6 +742,38 @@ bool resolve_network_analytics_options_from_network_design(
     return false;
   }
 
+  // Spectral solver keys are optional; older designs keep the defaults.
+  if (const auto it = kv.find("spectral_method"); it != kv.end()) {
+    parsed.spectral_method = lower_ascii_copy_(it->second);
+    if (parsed.spectral_method != "exact" &&
+        parsed.spectral_method != "randomized") {
+      if (error) {
+        *error = "NETWORK_ANALYTICS_POLICY.spectral_method must be exact or "
+                 "randomized";
+      }
+      return false;
+    }
+  }
+  if (const auto it = kv.find("spectral_rank"); it != kv.end()) {
+    if (!parse_i64_strict_(it->second, &parsed.spectral_rank) ||
+        parsed.spectral_rank < 1) {
+      if (error) {
+        *error = "NETWORK_ANALYTICS_POLICY.spectral_rank must be int >= 1";
+      }
+      return false;
+    }
+  }
+  if (const auto it = kv.find("spectral_power_iterations"); it != kv.end()) {
+    if (!parse_i64_strict_(it->second, &parsed.spectral_power_iterations) ||
+        parsed.spectral_power_iterations < 0) {
+      if (error) {
+        *error = "NETWORK_ANALYTICS_POLICY.spectral_power_iterations must be "
+                 "int >= 0";
+      }
+      return false;
+    }
+  }
+
   *out_options = parsed;
   return true;
 }
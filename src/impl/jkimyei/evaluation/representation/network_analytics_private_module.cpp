@@ -103,6 +103,9 @@ as_pretty_text_(const network_analytics_report_t &report,
              report.spectral_failed_tensor_count,
              (report.spectral_failed_tensor_count == 0) ? c_good : c_bad,
              "SVD failures");
+  line("spectral_norm_rel_error_bound_max",
+       report.spectral_norm_rel_error_bound_max,
+       "randomized spectral-norm bound / estimate");
   oss << "\n";
 
   section("Top Alerts");
@@ -560,6 +563,9 @@ summarize_module_network_analytics(const torch::nn::Module &model,
   out.spectral_skipped_tensor_count =
       spectral_acc.spectral_skipped_tensor_count;
   out.spectral_failed_tensor_count = spectral_acc.spectral_failed_tensor_count;
+  out.spectral_exact_tensor_count = spectral_acc.spectral_exact_tensor_count;
+  out.spectral_norm_rel_error_bound_max =
+      spectral_acc.max_spectral_norm_rel_error_bound;
   out.spectral_norm_mean =
       safe_ratio(spectral_acc.sum_spectral_norm,
                  static_cast<double>(out.spectral_tensor_count));
@@ -14,8 +14,22 @@ using namespace ::cuwacunu::ujcamei::source::contract::syntax;
 
 graph_topology_decoder_t::graph_topology_decoder_t(std::string grammar_text)
     : SOURCE_GRAPH_GRAMMAR_TEXT(std::move(grammar_text)),
-      grammarLexer(SOURCE_GRAPH_GRAMMAR_TEXT), grammarParser(grammarLexer),
-      grammar(parseGrammarDefinition()), iParser(iLexer, grammar) {
+      grammar(parseGrammarDefinition()),
+      iParser(iLexer, compileGrammarText(SOURCE_GRAPH_GRAMMAR_TEXT)) {
+#ifdef SOURCE_PIPELINE_DEBUG
+  log_dbg("%s\n", SOURCE_GRAPH_GRAMMAR_TEXT.c_str());
+#endif
+}
+
+graph_topology_decoder_t::graph_topology_decoder_t(
+    const std::filesystem::path &grammar_path)
+    : graph_topology_decoder_t(readGrammarFileCached(grammar_path)) {}
+
+graph_topology_decoder_t::graph_topology_decoder_t(
+    CachedGrammarFile grammar_file)
+    : SOURCE_GRAPH_GRAMMAR_TEXT(std::move(grammar_file.text)),
+      grammar(grammar_file.compiled->grammar),
+      iParser(iLexer, std::move(grammar_file.compiled)) {
 #ifdef SOURCE_PIPELINE_DEBUG
   log_dbg("%s\n", SOURCE_GRAPH_GRAMMAR_TEXT.c_str());
 #endif
@@ -43,8 +57,8 @@ graph_topology_decoder_t::decode(std::string instruction) {
 }
 
 ProductionGrammar graph_topology_decoder_t::parseGrammarDefinition() {
-  grammarParser.parseGrammar();
-  return grammarParser.getGrammar();
+  /* compiled once per process per grammar text; see compileGrammarText */
+  return compileGrammarText(SOURCE_GRAPH_GRAMMAR_TEXT)->grammar;
 }
 
 void graph_topology_decoder_t::visit(const RootNode *node,
@@ -1,10 +1,16 @@
 /* curl_websocket_api.cpp */
 #include "piaabo/network/curl/websocket_api/curl_websocket_api.h"
 
+#include <atomic>
+#include <cstring>
+
 // Runtime contract:
 // - response matching assumes JSON payloads with an "id" field;
 // - RX chunks are buffered until they form a complete JSON payload;
 // - TX is FIFO, so callers needing deadlines should encode them in messages.
+// - every session lives on one curl_multi handle driven by a single event
+//   loop thread; writers never touch curl, they push onto a lock-free stack
+//   and wake the loop.
 
 namespace cuwacunu {
 namespace piaabo {
@@ -13,24 +19,184 @@ namespace curl {
 
 namespace {
 constexpr std::size_t kWsMaxRxBufferBytes = 1u << 20; /* 1 MiB safety cap */
-}
+constexpr std::size_t kWsCallbackLanes = 2;           /* message callback threads */
+constexpr std::size_t kWsCallbackLaneCapacity = 1024; /* queued callbacks per lane */
+constexpr int kWsPollTimeoutMs = 1000;
+constexpr int kWsRetryPollTimeoutMs = 1;
+
+/* TX stack node; writers push, the event loop takes the whole stack */
+struct ws_tx_node_t {
+  ws_outgoing_data_t frame;
+  ws_tx_node_t* next = nullptr;
+};
+
+/*
+  Bounded callback executor
+    - a fixed set of lanes, one thread each; a key always maps to the same
+      lane, so tasks submitted under one key run in order
+    - submit never blocks: when the lane is full the task is dropped and
+      submit returns false, so a slow callback cannot stall the event loop
+*/
+class ws_callback_executor_t {
+public:
+  ws_callback_executor_t(std::size_t lanes, std::size_t capacity)
+      : capacity_(capacity) {
+    for (std::size_t i = 0; i < lanes; ++i) {
+      lanes_.push_back(std::make_unique<lane_t>());
+    }
+    for (auto& lane : lanes_) {
+      lane->worker = std::thread([this, raw = lane.get()] { run(raw); });
+    }
+  }
+  ~ws_callback_executor_t() { stop(); }
+
+  [[nodiscard]] bool submit(std::size_t key, std::function<void()> task) {
+    lane_t& lane = *lanes_[key % lanes_.size()];
+    {
+      LOCK_GUARD(lane.mtx);
+      if (lane.stopping || lane.tasks.size() >= capacity_) return false;
+      lane.tasks.push_back(std::move(task));
+    }
+    lane.not_empty.notify_one();
+    return true;
+  }
+
+  /* runs what is already queued, then joins the lanes */
+  void stop() {
+    for (auto& lane : lanes_) {
+      {
+        LOCK_GUARD(lane->mtx);
+        lane->stopping = true;
+      }
+      lane->not_empty.notify_all();
+    }
+    for (auto& lane : lanes_) {
+      if (lane->worker.joinable()) lane->worker.join();
+    }
+  }
+
+private:
+  struct lane_t {
+    std::mutex mtx;
+    std::condition_variable not_empty;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+    std::thread worker;
+  };
+
+  static void run(lane_t* lane) {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(lane->mtx);
+        lane->not_empty.wait(lock, [lane] {
+          return lane->stopping || !lane->tasks.empty();
+        });
+        if (lane->tasks.empty()) return; /* stopping and drained */
+        task = std::move(lane->tasks.front());
+        lane->tasks.pop_front();
+      }
+      try {
+        task();
+      } catch (const std::exception& e) {
+        log_err("Websocket message callback threw: %s\n", e.what());
+      } catch (...) {
+        log_err("%s\n", "Websocket message callback threw a non-standard exception");
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<lane_t>> lanes_;
+  std::size_t capacity_;
+};
+
+std::unique_ptr<ws_callback_executor_t> callback_executor;
+std::atomic<std::uint64_t> dropped_callback_frames{0};
+} /* namespace */
+
+/*
+  Per-session state
+    - atomics are shared between writers and the event loop
+    - fields under "guarded by mtx" are read by waiting callers
+    - fields under "event loop only" are never touched by other threads
+*/
+struct WebsocketAPI::ws_session_t {
+  ws_session_id_t id = NULL_CURL_SESSION;
+  CURL* curl = nullptr;
+
+  std::atomic<ws_tx_node_t*> tx_stack{nullptr};
+  std::atomic<std::size_t> tx_pending{0};    /* queued and not yet sent */
+  std::atomic<bool> finalizing{false};       /* no more writes accepted */
+  std::atomic<bool> shutdown_requested{false}; /* retire once TX drains */
+  std::atomic<bool> running{true};           /* attached to the multi handle */
+
+  /* guarded by mtx */
+  std::mutex mtx;
+  std::condition_variable trigger;
+  std::deque<ws_incoming_data_t> rx_deque;
+  bool handshake_ready = false;
+  std::shared_ptr<const ws_message_callback_fn> callback;
+
+  /* event loop only */
+  std::deque<ws_outgoing_data_t> tx_queue;
+  std::string rx_buffer;
+  bool attached = false;
+  bool handshake_seen = false;
+
+  ~ws_session_t() {
+    ws_tx_node_t* node = tx_stack.exchange(nullptr);
+    while (node) {
+      ws_tx_node_t* next = node->next;
+      delete node;
+      node = next;
+    }
+    if (curl) curl_easy_cleanup(curl);
+  }
+
+  void push_tx(ws_outgoing_data_t frame) {
+    auto* node = new ws_tx_node_t{std::move(frame), nullptr};
+    tx_pending.fetch_add(1, std::memory_order_relaxed);
+    node->next = tx_stack.load(std::memory_order_relaxed);
+    while (!tx_stack.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  /* moves the TX stack into tx_queue in push order */
+  void take_tx() {
+    ws_tx_node_t* node = tx_stack.exchange(nullptr, std::memory_order_acquire);
+    ws_tx_node_t* reversed = nullptr;
+    while (node) {
+      ws_tx_node_t* next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+    while (reversed) {
+      ws_tx_node_t* next = reversed->next;
+      tx_queue.push_back(std::move(reversed->frame));
+      delete reversed;
+      reversed = next;
+    }
+  }
+
+  /* wakes waiters; the lock orders the notify after the state they check */
+  void notify() {
+    { LOCK_GUARD(mtx); }
+    trigger.notify_all();
+  }
+};
 
 /* Static member variable definitions */
 int WebsocketAPI::sessions_counter = 0;
-std::mutex WebsocketAPI::global_ws_mutex;
-std::unordered_map<ws_session_id_t, CURL*> WebsocketAPI::curl_ws_sessions;
-std::unordered_map<ws_session_id_t, CURLM *> WebsocketAPI::curl_multi_handles;
-std::unordered_map<ws_session_id_t, std::shared_ptr<int>> WebsocketAPI::curl_ws_session_still_running;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::mutex>> WebsocketAPI::session_mutex;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::thread>> WebsocketAPI::session_RX_thread;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::thread>> WebsocketAPI::session_TX_thread;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::deque<ws_incoming_data_t>>> WebsocketAPI::session_RX_frames_deque;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::deque<ws_outgoing_data_t>>> WebsocketAPI::session_TX_frames_deque;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::string>> WebsocketAPI::session_RX_buffer;
-std::unordered_map<ws_session_id_t, std::shared_ptr<bool>> WebsocketAPI::session_shutdown_requested;
-std::unordered_map<ws_session_id_t, std::shared_ptr<bool>> WebsocketAPI::session_handshake_ready;
-std::unordered_map<ws_session_id_t, std::shared_ptr<ws_session_id_t>> WebsocketAPI::id_sessions;
-std::unordered_map<ws_session_id_t, std::shared_ptr<std::condition_variable>> WebsocketAPI::session_triggers;
+std::shared_mutex WebsocketAPI::sessions_mutex;
+std::unordered_map<ws_session_id_t, std::shared_ptr<WebsocketAPI::ws_session_t>> WebsocketAPI::sessions;
+CURLM* WebsocketAPI::multi_handle = nullptr;
+std::thread WebsocketAPI::event_loop_thread;
+std::mutex WebsocketAPI::event_loop_mutex;
+std::vector<std::shared_ptr<WebsocketAPI::ws_session_t>> WebsocketAPI::pending_sessions;
+bool WebsocketAPI::event_loop_stop = false;
 
 WebsocketAPI::_init WebsocketAPI::_initializer;
 
@@ -46,30 +212,26 @@ void WebsocketAPI::init() {
   /* Trigger a cleanup process at the end */
   std::atexit(WebsocketAPI::finit);
 
-  {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    /* Make sure curl is globally initialized */
-    dcurl_global_init();
-  }
+  /* Make sure curl is globally initialized */
+  dcurl_global_init();
 }
 void WebsocketAPI::finit() {
   log_dbg("Finalizing WebsocketAPI \n");
 
-  /* Gracefully finalize active sessions before global cleanup. */
+  /* Gracefully finalize active sessions before stopping the event loop. */
   std::vector<ws_session_id_t> active_sessions;
   {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    active_sessions.reserve(WebsocketAPI::session_mutex.size());
-    for (const auto& it : WebsocketAPI::session_mutex) {
+    std::shared_lock<std::shared_mutex> lock(WebsocketAPI::sessions_mutex);
+    active_sessions.reserve(WebsocketAPI::sessions.size());
+    for (const auto& it : WebsocketAPI::sessions) {
       if (it.first != NULL_CURL_SESSION) active_sessions.push_back(it.first);
     }
   }
   for (const ws_session_id_t session_id : active_sessions) {
     bool exists = false;
     {
-      LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-      exists = WebsocketAPI::session_mutex.find(session_id) !=
-               WebsocketAPI::session_mutex.end();
+      std::shared_lock<std::shared_mutex> lock(WebsocketAPI::sessions_mutex);
+      exists = WebsocketAPI::sessions.count(session_id) != 0;
     }
     if (!exists) continue;
     try {
@@ -80,231 +242,120 @@ void WebsocketAPI::finit() {
     }
   }
 
+  /* Stop the event loop, then the callback executor */
   {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    dcurl_global_cleanup();
+    LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+    WebsocketAPI::event_loop_stop = true;
   }
-}
-
-/* Session utilities (private) */
-CURL* WebsocketAPI::get_session(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = curl_ws_sessions.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == curl_ws_sessions.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify curl websocket session", session_id);
-    return nullptr;
+  WebsocketAPI::wake_event_loop();
+  if (WebsocketAPI::event_loop_thread.joinable()) {
+    WebsocketAPI::event_loop_thread.join();
   }
-  return it->second;
-}
-CURLM* WebsocketAPI::get_session_multi_handle(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::curl_multi_handles.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::curl_multi_handles.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify curl websocket multi handle", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<std::mutex> WebsocketAPI::get_session_mutex(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_mutex.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_mutex.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session mutex", session_id);
-    return nullptr;
+  if (callback_executor) {
+    callback_executor->stop();
+    callback_executor.reset();
   }
-  return it->second;
-}
-std::shared_ptr<std::condition_variable> WebsocketAPI::get_session_trigger(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_triggers.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_triggers.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session trigger", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<int> WebsocketAPI::get_session_still_running(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::curl_ws_session_still_running.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::curl_ws_session_still_running.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session running state", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<ws_session_id_t> WebsocketAPI::get_session_id_ref(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::id_sessions.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::id_sessions.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session id reference", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<bool> WebsocketAPI::get_session_shutdown_flag(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_shutdown_requested.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_shutdown_requested.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session shutdown flag", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<bool> WebsocketAPI::get_session_handshake_flag(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_handshake_ready.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_handshake_ready.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session handshake flag", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<std::thread> WebsocketAPI::get_session_RX_thread(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_RX_thread.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_RX_thread.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket RX thread", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<std::thread> WebsocketAPI::get_session_TX_thread(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_TX_thread.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_TX_thread.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket TX thread", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<std::string> WebsocketAPI::get_session_RX_buffer(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_RX_buffer.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_RX_buffer.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session RX buffer", session_id);
-    return nullptr;
-  }
-  return it->second;
-}
-std::shared_ptr<std::deque<ws_incoming_data_t>> WebsocketAPI::get_session_RX_deque(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_RX_frames_deque.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_RX_frames_deque.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session RX deque", session_id);
-    return nullptr;
+  {
+    LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+    if (WebsocketAPI::multi_handle) {
+      curl_multi_cleanup(WebsocketAPI::multi_handle);
+      WebsocketAPI::multi_handle = nullptr;
+    }
   }
-  return it->second;
+
+  dcurl_global_cleanup();
 }
-std::shared_ptr<std::deque<ws_outgoing_data_t>> WebsocketAPI::get_session_TX_deque(const ws_session_id_t session_id) {
-  LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-  const auto it = WebsocketAPI::session_TX_frames_deque.find(session_id);
-  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::session_TX_frames_deque.end()) {
-    log_fatal("%s with session_id[ %d ]\n", "Failed to identify websocket session TX deque", session_id);
+
+/* Session utilities (private) */
+std::shared_ptr<WebsocketAPI::ws_session_t> WebsocketAPI::get_session(const ws_session_id_t session_id) {
+  std::shared_lock<std::shared_mutex> lock(WebsocketAPI::sessions_mutex);
+  const auto it = WebsocketAPI::sessions.find(session_id);
+  if (session_id == NULL_CURL_SESSION || it == WebsocketAPI::sessions.end()) {
+    log_fatal("%s with session_id[ %d ]\n", "Failed to identify curl websocket session", session_id);
     return nullptr;
   }
   return it->second;
 }
 void WebsocketAPI::remove_session(const ws_session_id_t session_id) {
-  std::unique_lock<std::mutex> global_lock(WebsocketAPI::global_ws_mutex);
   if (session_id == NULL_CURL_SESSION) {
     log_warn("remove_session ignored NULL session_id[ %d ]\n", session_id);
     return;
   }
-  auto mutex_it = WebsocketAPI::session_mutex.find(session_id);
-  if (mutex_it == WebsocketAPI::session_mutex.end()) {
-    return;
-  }
-
-  std::unique_lock<std::mutex> session_lock(*mutex_it->second);
-  WebsocketAPI::curl_ws_sessions.erase(session_id);
-  WebsocketAPI::curl_multi_handles.erase(session_id);
-  WebsocketAPI::session_RX_frames_deque.erase(session_id);
-  WebsocketAPI::session_RX_thread.erase(session_id);
-  WebsocketAPI::session_TX_thread.erase(session_id);
-  WebsocketAPI::curl_ws_session_still_running.erase(session_id);
-  WebsocketAPI::session_triggers.erase(session_id);
-  WebsocketAPI::session_RX_buffer.erase(session_id);
-  WebsocketAPI::session_shutdown_requested.erase(session_id);
-  WebsocketAPI::session_handshake_ready.erase(session_id);
-  WebsocketAPI::id_sessions.erase(session_id);
-  session_lock.unlock();
-  WebsocketAPI::session_mutex.erase(mutex_it);
+  std::unique_lock<std::shared_mutex> lock(WebsocketAPI::sessions_mutex);
+  WebsocketAPI::sessions.erase(session_id);
 }
 
 /* Session utils (private)
    - initialize session
-   - disconnect session
 */
 ws_session_id_t WebsocketAPI::initialize_curl_ws_session() {
   /* Initialize the session */
   CURL* new_curl_session = create_curl_session();
-  
-  /* Initialize the multi init object */
-  CURLM * new_curl_multi_handle = curl_multi_init();
-  if (new_curl_multi_handle == nullptr) {
-    curl_easy_cleanup(new_curl_session);
-    log_fatal("%s\n", "Failed to initialize curl websocket multi handle");
-    return NULL_CURL_SESSION;
-  }
+  if (new_curl_session == nullptr) return NULL_CURL_SESSION;
 
-  ws_session_id_t new_session_id = NULL_CURL_SESSION;
+  auto session = std::make_shared<ws_session_t>();
+  session->curl = new_curl_session;
   {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    new_session_id = WebsocketAPI::sessions_counter++;
-    WebsocketAPI::curl_ws_sessions.emplace(new_session_id, new_curl_session);
-    WebsocketAPI::curl_multi_handles.emplace(new_session_id, new_curl_multi_handle);
-    WebsocketAPI::id_sessions.emplace(
-        new_session_id, std::make_shared<ws_session_id_t>(new_session_id));
-    /* Mark as running until curl_loop explicitly transitions to stopped. */
-    WebsocketAPI::curl_ws_session_still_running.emplace(
-        new_session_id, std::make_shared<int>(1));
-    WebsocketAPI::session_RX_frames_deque.emplace(
-        new_session_id,
-        std::make_shared<std::deque<ws_incoming_data_t>>());
-    WebsocketAPI::session_TX_frames_deque.emplace(
-        new_session_id,
-        std::make_shared<std::deque<ws_outgoing_data_t>>());
-    WebsocketAPI::session_RX_buffer.emplace(new_session_id,
-                                            std::make_shared<std::string>(""));
-    WebsocketAPI::session_shutdown_requested.emplace(
-        new_session_id, std::make_shared<bool>(false));
-    WebsocketAPI::session_handshake_ready.emplace(
-        new_session_id, std::make_shared<bool>(false));
-    WebsocketAPI::session_mutex.emplace(new_session_id,
-                                        std::make_shared<std::mutex>());
-    WebsocketAPI::session_triggers.emplace(
-        new_session_id, std::make_shared<std::condition_variable>());
-    WebsocketAPI::session_RX_thread.emplace(new_session_id,
-                                            std::make_shared<std::thread>());
-    WebsocketAPI::session_TX_thread.emplace(new_session_id,
-                                            std::make_shared<std::thread>());
-  }
-
-  /* Launch the flush TX messages (outgoing messages) thread (joined on finalize). */
-  {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    WebsocketAPI::session_TX_thread.at(new_session_id) =
-        std::make_shared<std::thread>(WebsocketAPI::flush_messages_loop,
-                                      new_session_id);
+    std::unique_lock<std::shared_mutex> lock(WebsocketAPI::sessions_mutex);
+    session->id = WebsocketAPI::sessions_counter++;
+    WebsocketAPI::sessions.emplace(session->id, session);
   }
 
   /* Log */
-  log_dbg("[success] New Websocket session created with session_id[ %d ].\n", new_session_id);
+  log_dbg("[success] New Websocket session created with session_id[ %d ].\n", session->id);
+
+  return session->id;
+}
+
+/* Starts the event loop (and the callback executor) on first use */
+void WebsocketAPI::ensure_event_loop() {
+  LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+  if (WebsocketAPI::event_loop_thread.joinable() || WebsocketAPI::event_loop_stop) {
+    return;
+  }
+  WebsocketAPI::multi_handle = curl_multi_init();
+  if (WebsocketAPI::multi_handle == nullptr) {
+    log_fatal("%s\n", "Failed to initialize curl websocket multi handle");
+    return;
+  }
+  callback_executor = std::make_unique<ws_callback_executor_t>(
+      kWsCallbackLanes, kWsCallbackLaneCapacity);
+  WebsocketAPI::event_loop_thread = std::thread(WebsocketAPI::event_loop);
+}
+
+/* multi_handle is created and cleaned up under event_loop_mutex */
+void WebsocketAPI::wake_event_loop() {
+  LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+  if (WebsocketAPI::multi_handle) curl_multi_wakeup(WebsocketAPI::multi_handle);
+}
 
-  return new_session_id;
+std::uint64_t WebsocketAPI::ws_dropped_callback_frames() {
+  return dropped_callback_frames.load(std::memory_order_relaxed);
+}
+
+/* Queues a frame on the session's TX stack unless it is finalizing */
+std::string WebsocketAPI::enqueue_frame(const ws_session_id_t session_id, ws_outgoing_data_t frame, const char* what) {
+  auto session = WebsocketAPI::get_session(session_id);
+  if (session->finalizing.load(std::memory_order_acquire) ||
+      !session->running.load(std::memory_order_acquire)) {
+    log_warn("Ignoring %s on finalizing session_id[ %d ]\n", what, session_id);
+    return "";
+  }
+  std::string return_frame_id = frame.frame_id;
+  session->push_tx(std::move(frame));
+  WebsocketAPI::wake_event_loop();
+  return return_frame_id;
 }
 
 /*
   Wait to flush
-    - waits until session_id TX deque has been flushed
+    - waits until every frame queued on session_id has been sent
 */
 void WebsocketAPI::ws_wait_to_flush(const ws_session_id_t session_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  std::unique_lock<std::mutex> lock(*session_mtx);
-  const bool flushed = trigger->wait_for(lock, WS_MAX_WAIT, [tx_deque] {
-    return tx_deque->empty();
+  auto session = WebsocketAPI::get_session(session_id);
+  std::unique_lock<std::mutex> lock(session->mtx);
+  const bool flushed = session->trigger.wait_for(lock, WS_MAX_WAIT, [&session] {
+    return session->tx_pending.load() == 0 || !session->running.load();
   });
   if (!flushed) {
     log_warn("Timeout while waiting TX flush on session_id[ %d ]\n", session_id);
@@ -313,15 +364,13 @@ void WebsocketAPI::ws_wait_to_flush(const ws_session_id_t session_id) {
 
 /*
   Wait for curl loop to finish
-    - waits until the curl loop has finished
+    - waits until the session has left the curl loop
 */
 void WebsocketAPI::ws_wait_loop_to_finish(const ws_session_id_t session_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto still_running = WebsocketAPI::get_session_still_running(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  std::unique_lock<std::mutex> lock(*session_mtx);
-  const bool stopped = trigger->wait_for(lock, WS_MAX_WAIT, [still_running] {
-    return *still_running == 0;
+  auto session = WebsocketAPI::get_session(session_id);
+  std::unique_lock<std::mutex> lock(session->mtx);
+  const bool stopped = session->trigger.wait_for(lock, WS_MAX_WAIT, [&session] {
+    return !session->running.load();
   });
   if (!stopped) {
     log_warn("Timeout while waiting curl loop stop on session_id[ %d ]\n", session_id);
@@ -330,15 +379,13 @@ void WebsocketAPI::ws_wait_loop_to_finish(const ws_session_id_t session_id) {
 
 /*
   Wait for a response frame to match a frame_id
-    - waits until the curl loop has finished
+    - waits until the frame is in the RX deque
 */
 bool WebsocketAPI::ws_wait_server_response(const ws_session_id_t session_id, const std::string target_frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto rx_deque = WebsocketAPI::get_session_RX_deque(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  std::unique_lock<std::mutex> lock(*session_mtx);
-  bool condition_met = trigger->wait_for(lock, WS_MAX_WAIT, [rx_deque, &target_frame_id] {
-    const auto& deque = *rx_deque;
+  auto session = WebsocketAPI::get_session(session_id);
+  std::unique_lock<std::mutex> lock(session->mtx);
+  bool condition_met = session->trigger.wait_for(lock, WS_MAX_WAIT, [&session, &target_frame_id] {
+    const auto& deque = session->rx_deque;
     for (auto it = deque.rbegin(); it != deque.rend(); ++it) {
       if (it->frame_id == target_frame_id) { return true; }
     }
@@ -354,7 +401,7 @@ bool WebsocketAPI::ws_wait_server_response(const ws_session_id_t session_id, con
   return condition_met;
 }
 
-/* 
+/*
   Connection method (public)
     - finalize connection
 */
@@ -366,20 +413,13 @@ void WebsocketAPI::ws_finalize(const ws_session_id_t session_id) {
     return;
   }
 
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto tx_thread = WebsocketAPI::get_session_TX_thread(session_id);
-  auto rx_thread = WebsocketAPI::get_session_RX_thread(session_id);
-  CURL* curl_session = WebsocketAPI::get_session(session_id);
-  CURLM* multi_handle = WebsocketAPI::get_session_multi_handle(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
+  auto session = WebsocketAPI::get_session(session_id);
 
-  /* Atomically enqueue close frame and block further writes. */
+  /* Enqueue the close frame once and block further writes; the event loop
+     retires the session after the close frame has gone out. */
   std::string close_frame_id = "close-skipped";
-  {
-    LOCK_GUARD(*session_mtx);
-    if (!*shutdown_requested) {
+  if (!session->finalizing.exchange(true)) {
+    if (session->running.load()) {
       ws_outgoing_data_t close_frame{};
       const unsigned short close_code = ws_htons(WS_NORMAL_TERMINATION);
       close_frame.frame_data.resize(sizeof(close_code));
@@ -390,43 +430,27 @@ void WebsocketAPI::ws_finalize(const ws_session_id_t session_id) {
           cuwacunu::piaabo::core::generate_random_string(CLOSE_FRAME_ID_FORMAT);
       close_frame.local_timestamp = std::chrono::system_clock::now();
       close_frame_id = close_frame.frame_id;
-      tx_deque->push_back(std::move(close_frame));
+      session->push_tx(std::move(close_frame));
     }
-    *shutdown_requested = true;
   }
-  trigger->notify_all();
+  session->shutdown_requested.store(true, std::memory_order_release);
+  WebsocketAPI::wake_event_loop();
 
-  /* Wait until the TX deque is flushed */
+  /* Wait until the TX queue is flushed */
   WebsocketAPI::ws_wait_to_flush(session_id);
 
-  /* Wait until the curl_loop is done */
+  /* Wait until the event loop has released the handle */
   WebsocketAPI::ws_wait_loop_to_finish(session_id);
 
-  if (tx_thread->joinable() &&
-      tx_thread->get_id() != std::this_thread::get_id()) {
-    tx_thread->join();
-  }
-  if (rx_thread->joinable() &&
-      rx_thread->get_id() != std::this_thread::get_id()) {
-    rx_thread->join();
-  }
-
-  /* Terminate curl handles */
-  {
-    LOCK_GUARD(*session_mtx);
-    curl_multi_remove_handle(multi_handle, curl_session);
-    curl_multi_cleanup(multi_handle);
-    curl_easy_cleanup(curl_session);
-  } /* Unlock */
-
-  /* Finalize session maps */
+  /* Finalize the registry entry; the event loop may still hold a reference
+     until its next turn, the session is freed with the last one. */
   WebsocketAPI::remove_session(session_id);
 
-  log_dbg("Finalized WebSocket connection with session_id[ %d ] frame_id[ %s ].\n", 
+  log_dbg("Finalized WebSocket connection with session_id[ %d ] frame_id[ %s ].\n",
     session_id, close_frame_id.c_str());
 }
 
-/* 
+/*
   Connection method (public)
     - initialize connection
 */
@@ -435,20 +459,15 @@ ws_session_id_t WebsocketAPI::ws_init(const std::string& url) {
   ws_session_id_t session_id = WebsocketAPI::initialize_curl_ws_session();
   if (session_id == NULL_CURL_SESSION) { return NULL_CURL_SESSION; }
 
-  /* Get curl session from the session_id */
-  CURL* curl_session = WebsocketAPI::get_session(session_id);
-  CURLM* multi_handle = WebsocketAPI::get_session_multi_handle(session_id);
-  auto session_id_ref = WebsocketAPI::get_session_id_ref(session_id);
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  auto handshake_ready = WebsocketAPI::get_session_handshake_flag(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto still_running = WebsocketAPI::get_session_still_running(session_id);
-  
+  /* Get the session from the session_id */
+  auto session = WebsocketAPI::get_session(session_id);
+  CURL* curl_session = session->curl;
+
   /* Configure curl session for websockets */
   curl_easy_setopt(curl_session, CURLOPT_URL, url.c_str());
   curl_easy_setopt(curl_session, CURLOPT_WRITEFUNCTION, WebsocketAPI::websocket_RX_callback);
-  curl_easy_setopt(curl_session, CURLOPT_WRITEDATA, session_id_ref.get());
+  curl_easy_setopt(curl_session, CURLOPT_WRITEDATA, session.get());
+  curl_easy_setopt(curl_session, CURLOPT_PRIVATE, session.get());
   curl_easy_setopt(curl_session, CURLOPT_SSL_VERIFYPEER, 1L);
   curl_easy_setopt(curl_session, CURLOPT_SSL_VERIFYHOST, 2L);
   curl_easy_setopt(curl_session, CURLOPT_CONNECTTIMEOUT, 5L);
@@ -456,15 +475,12 @@ ws_session_id_t WebsocketAPI::ws_init(const std::string& url) {
   curl_easy_setopt(curl_session, CURLOPT_BUFFERSIZE, CURL_MAX_WRITE_SIZE);
 
   curl_easy_setopt(curl_session, CURLOPT_VERBOSE, 0L);
-  
+
 
   /* // Optional setup options, to be reviewed
     curl_easy_setopt(curl_session, CURLOPT_TIMEOUT, 10L);
     curl_easy_setopt(curl_session, CURLOPT_MAXREDIRS, 5L);
     curl_easy_setopt(curl_session, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_session, CURLOPT_SOCKOPTFUNCTION , WebsocketAPI::websocket_RX_callback);
-    curl_easy_setopt(curl_session, CURLOPT_SOCKOPTDATA, &(WebsocketAPI::id_sessions.at(session_id)));
-    curl_easy_setopt(curl_session, CURLOPT_CONNECT_ONLY, 2L);
     char errbuf[CURL_ERROR_SIZE];
     curl_easy_setopt(curl_session, CURLOPT_ERRORBUFFER, errbuf);
 
@@ -473,73 +489,41 @@ ws_session_id_t WebsocketAPI::ws_init(const std::string& url) {
     curl_easy_setopt(curl_session, CURLOPT_HTTPHEADER, headers);
   */
 
-  /* Add the session to the curl-multi-object */
-  const CURLMcode add_rc = curl_multi_add_handle(
-      multi_handle, curl_session); /* Only add one session per multi_handle */
-  if (add_rc != CURLM_OK) {
-    {
-      LOCK_GUARD(*session_mtx);
-      *shutdown_requested = true;
-      *still_running = 0;
-    }
-    trigger->notify_all();
-    auto tx_thread = WebsocketAPI::get_session_TX_thread(session_id);
-    if (tx_thread->joinable() &&
-        tx_thread->get_id() != std::this_thread::get_id()) {
-      tx_thread->join();
-    }
-    curl_multi_cleanup(multi_handle);
-    curl_easy_cleanup(curl_session);
-    WebsocketAPI::remove_session(session_id);
-    log_err("Failed to add websocket handle to multi stack for session_id[ %d ]: %s\n",
-            session_id, curl_multi_strerror(add_rc));
-    return NULL_CURL_SESSION;
-  }
-
-  /* Launch a thread for the curl loop to run on this session */
+  /* Hand the session to the event loop; it adds the handle to the shared
+     curl-multi-object on its next turn. */
+  WebsocketAPI::ensure_event_loop();
   {
-    LOCK_GUARD(WebsocketAPI::global_ws_mutex);
-    WebsocketAPI::session_RX_thread.at(session_id) =
-        std::make_shared<std::thread>(WebsocketAPI::curl_loop, session_id);
+    LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+    WebsocketAPI::pending_sessions.push_back(session);
   }
+  WebsocketAPI::wake_event_loop();
 
   /* Wait for a successful scheme change or early failure. */
-  std::unique_lock<std::mutex> lock(*session_mtx);
-  const bool signaled = trigger->wait_for(lock, WS_MAX_WAIT, [handshake_ready, still_running]() {
-    return *handshake_ready || *still_running == 0;
+  std::unique_lock<std::mutex> lock(session->mtx);
+  const bool signaled = session->trigger.wait_for(lock, WS_MAX_WAIT, [&session]() {
+    return session->handshake_ready || !session->running.load();
   });
-  const bool handshake_ok = signaled && *handshake_ready;
+  const bool handshake_ok = signaled && session->handshake_ready;
   lock.unlock();
 
   if (!handshake_ok) {
-    {
-      LOCK_GUARD(*session_mtx);
-      *shutdown_requested = true;
-    }
-    trigger->notify_all();
     log_err("WebSocket handshake failed or timed out for session_id[ %d ]\n", session_id);
     WebsocketAPI::ws_finalize(session_id);
     return NULL_CURL_SESSION;
   }
 
   log_dbg("[success] WebSocket connection established, session_id[ %d ]\n", session_id);
-  
+
   return session_id;
 }
 
-/* 
+/*
   Send a ping frame:
-    - push a message to the TX deque
+    - push a message to the TX queue
 */
 std::string WebsocketAPI::ws_write_ping(const ws_session_id_t session_id, const std::string frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-
   /* Create the Ping frame object */
   ws_outgoing_data_t frame_to_deque;
-  std::string return_frame_id;
   {
     /* Fill the frame data with the Ping payload */
     frame_to_deque.frame_data = {};
@@ -548,34 +532,16 @@ std::string WebsocketAPI::ws_write_ping(const ws_session_id_t session_id, const
     frame_to_deque.frame_id = frame_id != "" ? frame_id : cuwacunu::piaabo::core::generate_random_string(FRAME_ID_FORMAT);
     frame_to_deque.local_timestamp = std::chrono::system_clock::now();
   }
-  /* Push to deque */
-  {
-    LOCK_GUARD(*session_mtx);
-    if (*shutdown_requested) {
-      log_warn("Ignoring ws_write_ping on finalizing session_id[ %d ]\n",
-               session_id);
-      return "";
-    }
-    return_frame_id = frame_to_deque.frame_id;
-    tx_deque->push_back(std::move(frame_to_deque));
-  }
-  trigger->notify_all();
-  return return_frame_id;
+  return WebsocketAPI::enqueue_frame(session_id, std::move(frame_to_deque), "ws_write_ping");
 }
 
-/* 
+/*
   Send a pong frame:
-    - push a message to the TX deque
+    - push a message to the TX queue
 */
 std::string WebsocketAPI::ws_write_pong(const ws_session_id_t session_id, const std::string frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-
   /* Create the Pong frame object */
   ws_outgoing_data_t frame_to_deque;
-  std::string return_frame_id;
   {
     /* Fill the frame data with the Pong payload */
     frame_to_deque.frame_data = {};
@@ -584,34 +550,16 @@ std::string WebsocketAPI::ws_write_pong(const ws_session_id_t session_id, const
     frame_to_deque.frame_id = frame_id != "" ? frame_id : cuwacunu::piaabo::core::generate_random_string(FRAME_ID_FORMAT);
     frame_to_deque.local_timestamp = std::chrono::system_clock::now();
   }
-  /* Push to deque */
-  {
-    LOCK_GUARD(*session_mtx);
-    if (*shutdown_requested) {
-      log_warn("Ignoring ws_write_pong on finalizing session_id[ %d ]\n",
-               session_id);
-      return "";
-    }
-    return_frame_id = frame_to_deque.frame_id;
-    tx_deque->push_back(std::move(frame_to_deque));
-  }
-  trigger->notify_all();
-  return return_frame_id;
+  return WebsocketAPI::enqueue_frame(session_id, std::move(frame_to_deque), "ws_write_pong");
 }
 
-/* 
+/*
   Send a close frame:
-    - push a message to the TX deque
+    - push a message to the TX queue
 */
 std::string WebsocketAPI::ws_write_close(const ws_session_id_t session_id, unsigned short closing_code, const std::string frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-
   /* Create the object */
   ws_outgoing_data_t frame_to_deque;
-  std::string return_frame_id;
   {
     unsigned short close_code = ws_htons(closing_code); /* Network byte order */
     /* Fill the frame object */
@@ -622,34 +570,16 @@ std::string WebsocketAPI::ws_write_close(const ws_session_id_t session_id, unsig
     frame_to_deque.frame_id = frame_id != "" ? frame_id : cuwacunu::piaabo::core::generate_random_string(CLOSE_FRAME_ID_FORMAT);
     frame_to_deque.local_timestamp = std::chrono::system_clock::now();
   }
-  /* Push to deque */
-  {
-    LOCK_GUARD(*session_mtx);
-    if (*shutdown_requested) {
-      log_warn("Ignoring ws_write_close on finalizing session_id[ %d ]\n",
-               session_id);
-      return "";
-    }
-    return_frame_id = frame_to_deque.frame_id;
-    tx_deque->push_back(std::move(frame_to_deque));
-  }
-  trigger->notify_all();
-  return return_frame_id;
+  return WebsocketAPI::enqueue_frame(session_id, std::move(frame_to_deque), "ws_write_close");
 }
 
-/* 
+/*
   Send a binary frame:
-    - push a message to the TX deque
+    - push a message to the TX queue
 */
 std::string WebsocketAPI::ws_write_binary(const ws_session_id_t session_id, const std::vector<unsigned char>& data, const std::string frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-
   /* Create the object */
   ws_outgoing_data_t frame_to_deque;
-  std::string return_frame_id;
   {
     /* Fill the frame object */
     frame_to_deque.frame_size = data.size();
@@ -658,34 +588,16 @@ std::string WebsocketAPI::ws_write_binary(const ws_session_id_t session_id, cons
     frame_to_deque.frame_id = frame_id != "" ? frame_id : cuwacunu::piaabo::core::generate_random_string(FRAME_ID_FORMAT);
     frame_to_deque.local_timestamp = std::chrono::system_clock::now();
   }
-  /* Push to deque */
-  {
-    LOCK_GUARD(*session_mtx);
-    if (*shutdown_requested) {
-      log_warn("Ignoring ws_write_binary on finalizing session_id[ %d ]\n",
-               session_id);
-      return "";
-    }
-    return_frame_id = frame_to_deque.frame_id;
-    tx_deque->push_back(std::move(frame_to_deque));
-  }
-  trigger->notify_all();
-  return return_frame_id;
+  return WebsocketAPI::enqueue_frame(session_id, std::move(frame_to_deque), "ws_write_binary");
 }
 
-/* 
+/*
   Send a string frame:
-    - push a message to the TX deque
+    - push a message to the TX queue
 */
 std::string WebsocketAPI::ws_write_text(const ws_session_id_t session_id, std::string data, const std::string frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-
   /* Create the object */
   ws_outgoing_data_t frame_to_deque;
-  std::string return_frame_id;
   {
     std::vector<unsigned char> data_vect(data.begin(), data.end()); /* ASCII encoding assumption */
     /* Fill the frame object */
@@ -695,48 +607,35 @@ std::string WebsocketAPI::ws_write_text(const ws_session_id_t session_id, std::s
     frame_to_deque.frame_size = data.size();
     frame_to_deque.local_timestamp = std::chrono::system_clock::now();
   }
-  /* Push to deque */
-  {
-    LOCK_GUARD(*session_mtx);
-    if (*shutdown_requested) {
-      log_warn("Ignoring ws_write_text on finalizing session_id[ %d ]\n",
-               session_id);
-      return "";
-    }
-    return_frame_id = frame_to_deque.frame_id;
-    tx_deque->push_back(std::move(frame_to_deque));
-  }
-  trigger->notify_all();
-  return return_frame_id;
+  return WebsocketAPI::enqueue_frame(session_id, std::move(frame_to_deque), "ws_write_text");
 }
 
 /*
   Await and retrieve server response
 */
 std::optional<ws_incoming_data_t> WebsocketAPI::ws_await_and_retrieve_server_response(const ws_session_id_t session_id, const std::string target_frame_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto rx_deque = WebsocketAPI::get_session_RX_deque(session_id);
-  
+  auto session = WebsocketAPI::get_session(session_id);
+
   /* Wait for the server to respond */
   bool condition_met = cuwacunu::piaabo::network::curl::WebsocketAPI::ws_wait_server_response(session_id, target_frame_id);
-  
+
   /* Failure: if no response was received (await timeout) */
   if (!condition_met) {
     return std::nullopt;
   }
 
   /* Success: response from the server was retrieved */
-  { 
+  {
     /* Lock */
-    LOCK_GUARD(*session_mtx);
-    
+    LOCK_GUARD(session->mtx);
+
     /* Retrieve the response (and remove it from the queue) */
-    auto &deque = *rx_deque;
+    auto &deque = session->rx_deque;
     for (std::size_t idx = deque.size(); idx > 0; --idx) {
       std::size_t i = idx - 1; /* Adjust index for counting down */
       if (deque[i].frame_id == target_frame_id) {
         /* Store the element before erasing */
-        auto result = deque[i];
+        auto result = std::move(deque[i]);
         /* Erase the element from the deque */
         deque.erase(deque.begin() + i);
         /* Return the saved element */
@@ -746,175 +645,204 @@ std::optional<ws_incoming_data_t> WebsocketAPI::ws_await_and_retrieve_server_res
   } /* Unlock */
 
   /* Failure: unexpected disappearance */
-  log_err("Unexpected disappearance while retrieving deque element frame_id[ %s ] at session_id[ %d ]\n", 
+  log_err("Unexpected disappearance while retrieving deque element frame_id[ %s ] at session_id[ %d ]\n",
     target_frame_id.c_str(), session_id);
   return std::nullopt;
 }
 
-/* 
-  Main curl_multi loop 
+/*
+  Message callback
+*/
+void WebsocketAPI::ws_set_message_callback(const ws_session_id_t session_id, ws_message_callback_fn callback) {
+  auto session = WebsocketAPI::get_session(session_id);
+  LOCK_GUARD(session->mtx);
+  if (callback) {
+    session->callback = std::make_shared<const ws_message_callback_fn>(std::move(callback));
+  } else {
+    session->callback.reset();
+  }
+}
+
+/*
+  Main curl_multi loop
     used to process the activity of the curl handles (sessions)
 */
-void WebsocketAPI::curl_loop(const ws_session_id_t session_id) {
-  log_dbg("Dispatching a new curl-thread on session_id[ %d ].\n", session_id);
-  CURL* curl_session = WebsocketAPI::get_session(session_id);
-  CURLM* multi_handle = WebsocketAPI::get_session_multi_handle(session_id);
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  auto still_running_state = WebsocketAPI::get_session_still_running(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto handshake_ready = WebsocketAPI::get_session_handshake_flag(session_id);
-
-  bool notified_scheme_change = false;
+void WebsocketAPI::event_loop() {
+  log_dbg("%s\n", "Dispatching the websocket event loop.");
+  std::vector<std::shared_ptr<ws_session_t>> active;
+  std::vector<std::shared_ptr<ws_session_t>> adopted;
+
+  /* Releases a session's handle and wakes whoever waits on it */
+  const auto retire = [](ws_session_t& session) {
+    if (session.attached) {
+      curl_multi_remove_handle(WebsocketAPI::multi_handle, session.curl);
+      session.attached = false;
+    }
+    if (session.curl) {
+      curl_easy_cleanup(session.curl);
+      session.curl = nullptr;
+    }
+    session.tx_queue.clear();
+    {
+      LOCK_GUARD(session.mtx);
+      session.running.store(false, std::memory_order_release);
+    }
+    session.trigger.notify_all();
+  };
+
+  /* Sends what is queued once the handshake is done; a full socket leaves
+     the rest for the next turn. */
+  const auto flush_tx = [](ws_session_t& session) {
+    session.take_tx();
+    if (!session.handshake_seen || session.tx_queue.empty()) return;
+    bool sent_any = false;
+    while (!session.tx_queue.empty()) {
+      auto& frame = session.tx_queue.front();
+      size_t sent = 0;
+      const CURLcode res = curl_ws_send(session.curl, frame.frame_data.data(),
+                                        frame.frame_size, &sent, 0,
+                                        static_cast<unsigned int>(frame.frame_type));
+      if (res == CURLE_AGAIN) break;
+      if (res == CURLE_OK && sent < frame.frame_size) {
+        /* Partial send: keep the remainder at the front */
+        frame.frame_data.erase(frame.frame_data.begin(),
+                               frame.frame_data.begin() + static_cast<std::ptrdiff_t>(sent));
+        frame.frame_size -= sent;
+        break;
+      }
+      if (res != CURLE_OK) {
+        log_err("Unable to send frame_id[%s] from session_id[ %d ], with error: %s\n",
+                frame.frame_id.c_str(), session.id, curl_easy_strerror(res));
+      } else {
+        log_secure_dbg("[success] Sent session_id[ %d ]'s message with frame_id[ %s ]\n",
+                       session.id, frame.frame_id.c_str());
+      }
+      session.tx_queue.pop_front();
+      session.tx_pending.fetch_sub(1, std::memory_order_acq_rel);
+      sent_any = true;
+    }
+    if (sent_any) session.notify();
+  };
+
   int numfds = 0;
-  int still_running_local = 0;
+  int still_running = 0;
   CURLMcode res_code = CURLM_OK;
 
   while (true) {
+    /* Adopt new sessions */
+    bool stop = false;
     {
-      LOCK_GUARD(*session_mtx);
-      if (*shutdown_requested) break;
-    }
-
-    res_code = curl_multi_perform(multi_handle, &still_running_local);
-    {
-      LOCK_GUARD(*session_mtx);
-      *still_running_state = still_running_local;
+      LOCK_GUARD(WebsocketAPI::event_loop_mutex);
+      adopted.swap(WebsocketAPI::pending_sessions);
+      stop = WebsocketAPI::event_loop_stop;
     }
-    trigger->notify_all();
-    if (res_code != CURLM_OK) {
-      log_err("Failed to perform curl_multi operation with error: %s\n",
-              curl_multi_strerror(res_code));
-      break;
+    for (auto& session : adopted) {
+      const CURLMcode add_rc = curl_multi_add_handle(WebsocketAPI::multi_handle, session->curl);
+      if (add_rc != CURLM_OK) {
+        log_err("Failed to add websocket handle to multi stack for session_id[ %d ]: %s\n",
+                session->id, curl_multi_strerror(add_rc));
+        retire(*session);
+        continue;
+      }
+      session->attached = true;
+      active.push_back(std::move(session));
     }
+    adopted.clear();
+    if (stop) break;
 
-    {
-      LOCK_GUARD(*session_mtx);
-      if (*shutdown_requested) break;
-    }
+    /* Outgoing frames */
+    for (auto& session : active) flush_tx(*session);
 
-    res_code = curl_multi_wait(multi_handle, NULL, 0, 1000, &numfds);
+    res_code = curl_multi_perform(WebsocketAPI::multi_handle, &still_running);
     if (res_code != CURLM_OK) {
-      log_err("curl_multi_wait() failed: %s\n", curl_multi_strerror(res_code));
-      break;
-    }
-
-    {
-      LOCK_GUARD(*session_mtx);
-      if (*shutdown_requested) break;
+      log_err("Failed to perform curl_multi operation with error: %s\n",
+              curl_multi_strerror(res_code));
+      for (auto& session : active) retire(*session);
+      active.clear();
     }
 
     /* Verify connection failure, overall verify errors */
     CURLMsg* curl_dbg_msg = nullptr;
     int dbg_msgs_left = 0;
-    while ((curl_dbg_msg = curl_multi_info_read(multi_handle, &dbg_msgs_left))) {
-      if (curl_dbg_msg->msg == CURLMSG_DONE) {
-        if (curl_dbg_msg->data.result == CURLE_COULDNT_RESOLVE_HOST) {
-          log_err("Curl failed to resolve host (no internet). %s\n",
-                  curl_easy_strerror(curl_dbg_msg->data.result));
-        } else if (curl_dbg_msg->data.result == CURLE_COULDNT_CONNECT) {
-          log_err("Curl failed to connect or shutting down connection. %s\n",
-                  curl_easy_strerror(curl_dbg_msg->data.result));
-        } else if (curl_dbg_msg->data.result != CURLE_OK) {
-          log_err("Curl general error: %s\n",
-                  curl_easy_strerror(curl_dbg_msg->data.result));
-        }
+    while ((curl_dbg_msg = curl_multi_info_read(WebsocketAPI::multi_handle, &dbg_msgs_left))) {
+      if (curl_dbg_msg->msg != CURLMSG_DONE) continue;
+      if (curl_dbg_msg->data.result == CURLE_COULDNT_RESOLVE_HOST) {
+        log_err("Curl failed to resolve host (no internet). %s\n",
+                curl_easy_strerror(curl_dbg_msg->data.result));
+      } else if (curl_dbg_msg->data.result == CURLE_COULDNT_CONNECT) {
+        log_err("Curl failed to connect or shutting down connection. %s\n",
+                curl_easy_strerror(curl_dbg_msg->data.result));
+      } else if (curl_dbg_msg->data.result != CURLE_OK) {
+        log_err("Curl general error: %s\n",
+                curl_easy_strerror(curl_dbg_msg->data.result));
       }
+      /* The transfer is over: the session has nothing left to do */
+      ws_session_t* done = nullptr;
+      curl_easy_getinfo(curl_dbg_msg->easy_handle, CURLINFO_PRIVATE, &done);
+      if (done) retire(*done);
     }
 
-    /* Verify scheme change */
-    if (!notified_scheme_change) {
-      char* scheme = NULL;
-      if (curl_easy_getinfo(curl_session, CURLINFO_SCHEME, &scheme) == CURLE_OK) {
-        if (scheme && (strcmp(scheme, "WS") == 0 || strcmp(scheme, "WSS") == 0)) {
+    for (auto& session : active) {
+      if (!session->running.load(std::memory_order_acquire)) continue;
+
+      /* Verify scheme change */
+      if (!session->handshake_seen) {
+        char* scheme = NULL;
+        if (curl_easy_getinfo(session->curl, CURLINFO_SCHEME, &scheme) == CURLE_OK &&
+            scheme && (strcmp(scheme, "WS") == 0 || strcmp(scheme, "WSS") == 0)) {
           long response_code = 0;
           const CURLcode res =
-              curl_easy_getinfo(curl_session, CURLINFO_RESPONSE_CODE, &response_code);
+              curl_easy_getinfo(session->curl, CURLINFO_RESPONSE_CODE, &response_code);
           if (res == CURLE_OK && response_code == 101) {
-            notified_scheme_change = true;
+            session->handshake_seen = true;
             {
-              LOCK_GUARD(*session_mtx);
-              *handshake_ready = true;
+              LOCK_GUARD(session->mtx);
+              session->handshake_ready = true;
             }
-            trigger->notify_all();
+            session->trigger.notify_all();
           }
         }
       }
-    }
-
-    if (still_running_local <= 0) break;
-  }
 
-  /* Curl ran out of jobs */
-  CLEAR_SYS_ERR(); /* Curl triggers some errors that are not critical */
-  log_dbg("[success] curl-thread session_id[ %d ] finished operating.\n", session_id);
-
-  {
-    LOCK_GUARD(*session_mtx);
-    *still_running_state = 0;
-  }
-  trigger->notify_all();
-  
-  return;
-}
-
-/*
-  Flush (TX) messages
-    - runs an independent thread for every session_id
-    - trigger (notify) when on WebsocketAPI::ws_write_* methods
-*/
-void WebsocketAPI::flush_messages_loop(const ws_session_id_t session_id) {
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto tx_deque = WebsocketAPI::get_session_TX_deque(session_id);
-  auto shutdown_requested = WebsocketAPI::get_session_shutdown_flag(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
-  CURL* curl_session = WebsocketAPI::get_session(session_id);
-
-  while (true) {
-    ws_outgoing_data_t frame_from_deque;
-    bool should_send = false;
-    {
-      std::unique_lock<std::mutex> lock(*session_mtx);
-      trigger->wait_for(lock, WS_MAX_WAIT, [shutdown_requested, tx_deque]() {
-        return *shutdown_requested || !tx_deque->empty();
-      });
-      if (*shutdown_requested && tx_deque->empty()) {
-        log_dbg("Stop flushing messages for session_id[ %d ]\n", session_id);
-        break;
-      }
-      if (!tx_deque->empty()) {
-        frame_from_deque = std::move(tx_deque->front());
-        tx_deque->pop_front();
-        should_send = true;
+      /* Retire sessions whose close frame (and everything before it) is out,
+         or that never completed the handshake. */
+      if (session->shutdown_requested.load(std::memory_order_acquire)) {
+        session->take_tx();
+        if (session->tx_queue.empty() || !session->handshake_seen) {
+          retire(*session);
+        }
       }
     }
-
-    if (!should_send) continue;
-
-    /* Send the message outside lock. */
-    const CURLcode res = send_ws_frame(
-        curl_session, frame_from_deque.frame_data.data(),
-        frame_from_deque.frame_size, frame_from_deque.frame_type);
-
-    /* Validate the response */
-    if (res != CURLE_OK) {
-      log_err("Unable to send frame_id[%s] from session_id[ %d ], with error: %s\n",
-              frame_from_deque.frame_id.c_str(), session_id, curl_easy_strerror(res));
-    } else {
-      log_secure_dbg("[success] Sent session_id[ %d ]'s message with frame_id[ %s ]\n",
-                     session_id, frame_from_deque.frame_id.c_str());
+    std::erase_if(active, [](const std::shared_ptr<ws_session_t>& session) {
+      return !session->running.load(std::memory_order_acquire);
+    });
+
+    /* Frames held back by a full socket are retried after a short poll */
+    bool has_ready_tx = false;
+    for (auto& session : active) {
+      if (session->handshake_seen && !session->tx_queue.empty()) has_ready_tx = true;
     }
 
-    trigger->notify_all();
+    res_code = curl_multi_poll(WebsocketAPI::multi_handle, NULL, 0,
+                               has_ready_tx ? kWsRetryPollTimeoutMs : kWsPollTimeoutMs,
+                               &numfds);
+    if (res_code != CURLM_OK) {
+      log_err("curl_multi_poll() failed: %s\n", curl_multi_strerror(res_code));
+      break;
+    }
   }
 
-  trigger->notify_all();
+  /* Release whatever is still attached */
+  for (auto& session : active) retire(*session);
+
+  CLEAR_SYS_ERR(); /* Curl triggers some errors that are not critical */
+  log_dbg("%s\n", "[success] websocket event loop finished operating.");
 }
 
-/* 
-  Write_callback method, 
-    - on receiving a message it will add the data to the session deque. 
-    - there is a separate thread that processes those deques; the writeback is left simple without the logic of interpreting the data.
+/*
+  Write_callback method,
+    - on receiving a message it will add the data to the session deque.
+    - runs on the event loop thread; the writeback is left simple without the logic of interpreting the data.
 */
 size_t WebsocketAPI::websocket_RX_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
   /* Get the message arrival time */
@@ -922,61 +850,71 @@ size_t WebsocketAPI::websocket_RX_callback(char* ptr, size_t size, size_t nmemb,
 
   if (userdata == nullptr || ptr == nullptr) return size * nmemb;
 
-  /* Interpret the session_id */
-  ws_session_id_t session_id = *(ws_session_id_t*)userdata;
-  auto session_mtx = WebsocketAPI::get_session_mutex(session_id);
-  auto rx_buffer = WebsocketAPI::get_session_RX_buffer(session_id);
-  auto rx_deque = WebsocketAPI::get_session_RX_deque(session_id);
-  auto trigger = WebsocketAPI::get_session_trigger(session_id);
+  /* Interpret the session */
+  ws_session_t& session = *static_cast<ws_session_t*>(userdata);
+  const ws_session_id_t session_id = session.id;
+  std::string& rx_buffer = session.rx_buffer; /* event loop only */
+
+  /* Append the incoming buffer */
+  rx_buffer.append(ptr, size * nmemb);
+  if (rx_buffer.size() > kWsMaxRxBufferBytes) {
+    log_warn("Websocket session_id[ %d ] RX buffer exceeded %ld bytes; dropping partial frame.\n",
+             session_id, static_cast<long>(kWsMaxRxBufferBytes));
+    rx_buffer.clear();
+  }
+
+  /* Validate if the callback was invoked on a chunk or the total */
+  if (rx_buffer.empty() ||
+      !cuwacunu::piaabo::parse::json::json_fast_validity_check(rx_buffer)) {
+    log_secure_dbg("[chunk] Websocket session_id[ %d ] callback received data chunk of size: %ld\n",
+      session_id,
+      size * nmemb);
+    return size * nmemb;
+  }
+
+  /* Total data was reached in the chunk */
   ws_incoming_data_t frame_to_deque;
-  bool produced_complete_frame = false;
-    
-  /* Lock the current session mutex */
+  frame_to_deque.data = std::move(rx_buffer);
+  rx_buffer.clear(); /* Reset buffer */
+  frame_to_deque.local_timestamp = local_timestamp;
+  frame_to_deque.frame_id = cuwacunu::piaabo::parse::json::extract_json_string_value(frame_to_deque.data, "id", "NULL");
+
+  /* Log info */
+  log_secure_info("[total] Websocket session_id[ %d ] callback received frame_id[ %s ]\n",
+    session_id,
+    frame_to_deque.frame_id.c_str());
+  log_secure_dbg("[total] Websocket session_id[ %d ] callback received frame_id[ %s ] bytes=%ld\n",
+    session_id,
+    frame_to_deque.frame_id.c_str(),
+    static_cast<long>(frame_to_deque.data.size()));
+
+  /* Hand the frame to the callback, or push it to the session FIFO deque */
+  std::shared_ptr<const ws_message_callback_fn> callback;
   {
-    LOCK_GUARD(*session_mtx);
-
-    /* Push the received RX frame to the session_id FIFO deque */
-    {
-      /* Append the incoming buffer */
-      *rx_buffer += std::string(ptr, size * nmemb);
-      if (rx_buffer->size() > kWsMaxRxBufferBytes) {
-        log_warn("Websocket session_id[ %d ] RX buffer exceeded %ld bytes; dropping partial frame.\n",
-                 session_id, static_cast<long>(kWsMaxRxBufferBytes));
-        rx_buffer->clear();
-      }
+    LOCK_GUARD(session.mtx);
+    callback = session.callback;
+    if (!callback) session.rx_deque.push_back(std::move(frame_to_deque));
+  } /* Unlock */
 
-      /* Validate if the callback was invoked on a chunk or the total */
-      if (!rx_buffer->empty() &&
-          cuwacunu::piaabo::parse::json::json_fast_validity_check(*rx_buffer)) {
-        /* Total data was reached in the chunk */
-        frame_to_deque.data = *rx_buffer;
-        frame_to_deque.local_timestamp = local_timestamp;
-        frame_to_deque.frame_id = cuwacunu::piaabo::parse::json::extract_json_string_value(frame_to_deque.data, "id", "NULL");
-        
-        /* Reset buffer */
-        rx_buffer->clear();
-        produced_complete_frame = true;
-
-        /* Log info */
-        log_secure_info("[total] Websocket session_id[ %d ] callback received frame_id[ %s ]\n", 
-          session_id, 
-          frame_to_deque.frame_id.c_str());
-        log_secure_dbg("[total] Websocket session_id[ %d ] callback received frame_id[ %s ] bytes=%ld\n", 
-          session_id, 
-          frame_to_deque.frame_id.c_str(), 
-          static_cast<long>(frame_to_deque.data.size()));
-      } else {
-        log_secure_dbg("[chunk] Websocket session_id[ %d ] callback received data chunk of size: %ld\n", 
-          session_id, 
-          size * nmemb);
+  if (callback) {
+    const std::string frame_id = frame_to_deque.frame_id;
+    const bool queued = callback_executor->submit(
+        static_cast<std::size_t>(session_id),
+        [callback, session_id, frame = std::move(frame_to_deque)]() {
+          (*callback)(session_id, frame);
+        });
+    if (!queued) {
+      const std::uint64_t dropped =
+          dropped_callback_frames.fetch_add(1, std::memory_order_relaxed) + 1;
+      if ((dropped & (dropped - 1)) == 0) { /* 1, 2, 4, ... */
+        log_warn("Websocket session_id[ %d ] callback queue full, dropped frame_id[ %s ] (%llu dropped so far)\n",
+                 session_id, frame_id.c_str(),
+                 static_cast<unsigned long long>(dropped));
       }
     }
-    if (produced_complete_frame) {
-      rx_deque->push_back(std::move(frame_to_deque));
-    }
-  } /* Unlock */
-
-  if (produced_complete_frame) trigger->notify_all();
+  } else {
+    session.trigger.notify_all();
+  }
 
   /* Return the number of processed bytes; in this case, we return the total count */
   return size * nmemb;
@@ -81,6 +81,37 @@ bool compareAST(const ASTNode* actual, const ASTNode* expected) {
   return false;
 }
 
+ASTNodePtr cloneAST(const ASTNode* node) {
+  if (!node) return nullptr;
+
+  ASTNodePtr copy;
+  if (auto root = dynamic_cast<const RootNode*>(node)) {
+    std::vector<ASTNodePtr> children;
+    children.reserve(root->children.size());
+    for (const auto& child : root->children) children.push_back(cloneAST(child.get()));
+    copy = std::make_unique<RootNode>(root->lhs_instruction, std::move(children));
+  }
+  else if (auto intermediary = dynamic_cast<const IntermediaryNode*>(node)) {
+    std::vector<ASTNodePtr> children;
+    children.reserve(intermediary->children.size());
+    for (const auto& child : intermediary->children) children.push_back(cloneAST(child.get()));
+    copy = std::make_unique<IntermediaryNode>(intermediary->alt, std::move(children));
+  }
+  else if (auto terminal = dynamic_cast<const TerminalNode*>(node)) {
+    if (terminal->unit.type == ProductionUnit::Type::Terminal) {
+      copy = std::make_unique<TerminalNode>(terminal->name, terminal->unit);
+    } else {
+      copy = std::make_unique<TerminalNode>(terminal->name);
+    }
+  }
+  else {
+    throw std::runtime_error("cloneAST: unknown AST node type");
+  }
+  copy->name = node->name;
+  copy->hash = node->hash;
+  return copy;
+}
+
 // Functions to modify context
 void push_context(VisitorContext& context, const ASTNode* node) {
   // We no longer inspect node->hash or the existing stack entries.
@@ -0,0 +1,543 @@
+/* bnf_compiled_grammar.cpp */
+#include "piaabo/parse/bnf/compiled_grammar.h"
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include "piaabo/digest/sha256.h"
+#include "piaabo/parse/bnf/grammar_lexer.h"
+#include "piaabo/parse/bnf/grammar_parser.h"
+
+namespace cuwacunu {
+namespace piaabo {
+namespace parse {
+namespace bnf {
+
+/* - - - - - - - - - - - - */
+/*      Terminal bytes     */
+/* - - - - - - - - - - - - */
+
+std::string decodeTerminalLexeme(const std::string& raw) {
+  std::string str = raw;
+  /* remove quotes */
+  if (!str.empty() &&
+      ((str.front() == '"' && str.back() == '"') ||
+       (str.front() == '\'' && str.back() == '\''))) {
+    str = str.substr(1, str.size() - 2);
+  }
+  /* handle escape sequences */
+  std::string result;
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == '\\' && i + 1 < str.size()) {
+      switch (str[i + 1]) {
+      case 'n':  result += '\n'; break;
+      case 'r':  result += '\r'; break;
+      case 't':  result += '\t'; break;
+      case '\\': result += '\\'; break;
+      case '"':  result += '"';  break;
+      case '\'': result += '\''; break;
+      default:
+        /* unknown escape sequence, keep both characters as-is */
+        result += '\\';
+        result += str[i + 1];
+        break;
+      }
+      ++i;
+    } else {
+      result += str[i];
+    }
+  }
+  return result;
+}
+
+/* - - - - - - - - - - - - */
+/*     CompiledGrammar     */
+/* - - - - - - - - - - - - */
+
+size_t CompiledGrammar::ruleId(const std::string& lhs) const {
+  const auto it = rule_ids.find(lhs);
+  if (it == rule_ids.end()) {
+    throw std::invalid_argument("No production rule found with lhs: " + lhs);
+  }
+  return it->second;
+}
+
+const std::string& CompiledGrammar::terminalLiteral(const ProductionUnit& unit) const {
+  const auto it = terminal_literals.find(unit.lexeme);
+  if (it == terminal_literals.end()) {
+    throw std::invalid_argument("Terminal not present in compiled grammar: " + unit.str(true));
+  }
+  return it->second;
+}
+
+bool CompiledGrammar::rejects(size_t rule_id, unsigned char ch, bool at_end) const {
+  if (nullable[rule_id]) {
+    return false;
+  }
+  return at_end || !first_sets[rule_id].test(ch);
+}
+
+namespace {
+
+/* first-set facts of a unit or alternative */
+struct unit_facts_t {
+  bool nullable = false;
+  std::bitset<256> first;
+};
+
+unit_facts_t unbounded_facts() {
+  unit_facts_t facts;
+  facts.nullable = true; /* never prune what the parser would reject on its own */
+  facts.first.set();
+  return facts;
+}
+
+unit_facts_t rule_facts(const CompiledGrammar& out, const std::string& lhs) {
+  const auto it = out.rule_ids.find(lhs);
+  if (it == out.rule_ids.end()) {
+    return unbounded_facts();
+  }
+  unit_facts_t facts;
+  facts.nullable = out.nullable[it->second];
+  facts.first = out.first_sets[it->second];
+  return facts;
+}
+
+unit_facts_t unit_facts(const CompiledGrammar& out, const ProductionUnit& unit) {
+  switch (unit.type) {
+  case ProductionUnit::Type::Terminal: {
+    unit_facts_t facts;
+    const std::string& literal = out.terminal_literals.at(unit.lexeme);
+    facts.nullable = literal.empty();
+    if (!literal.empty()) {
+      facts.first.set(static_cast<unsigned char>(literal.front()));
+    }
+    return facts;
+  }
+  case ProductionUnit::Type::NonTerminal:
+    return rule_facts(out, unit.lexeme);
+  case ProductionUnit::Type::Optional:
+  case ProductionUnit::Type::Repetition: {
+    if (unit.lexeme.size() < 2) {
+      return unbounded_facts();
+    }
+    unit_facts_t facts = rule_facts(out, unit.lexeme.substr(1, unit.lexeme.size() - 2));
+    facts.nullable = true;
+    return facts;
+  }
+  default:
+    return unbounded_facts();
+  }
+}
+
+unit_facts_t alternative_facts(const CompiledGrammar& out, const ProductionAlternative& alt) {
+  const ProductionUnit* units = nullptr;
+  size_t count = 0;
+  if (alt.type == ProductionAlternative::Type::Single) {
+    units = &std::get<ProductionUnit>(alt.content);
+    count = 1;
+  } else if (alt.type == ProductionAlternative::Type::Sequence) {
+    const auto& seq = std::get<std::vector<ProductionUnit>>(alt.content);
+    units = seq.data();
+    count = seq.size();
+  } else {
+    return unbounded_facts();
+  }
+  /* an empty alternative never matches */
+  unit_facts_t facts;
+  if (count == 0) {
+    return facts;
+  }
+  facts.nullable = true;
+  for (size_t i = 0; i < count && facts.nullable; ++i) {
+    const unit_facts_t unit = unit_facts(out, units[i]);
+    facts.first |= unit.first;
+    facts.nullable = unit.nullable;
+  }
+  return facts;
+}
+
+template <typename Fn>
+void for_each_unit(const ProductionGrammar& grammar, Fn&& fn) {
+  for (const auto& rule : grammar.rules) {
+    for (const auto& alt : rule.rhs) {
+      if (alt.type == ProductionAlternative::Type::Single) {
+        fn(std::get<ProductionUnit>(alt.content));
+      } else if (alt.type == ProductionAlternative::Type::Sequence) {
+        for (const auto& unit : std::get<std::vector<ProductionUnit>>(alt.content)) {
+          fn(unit);
+        }
+      }
+    }
+  }
+}
+
+} /* namespace */
+
+CompiledGrammar compileGrammar(const ProductionGrammar& grammar) {
+  CompiledGrammar out;
+  out.grammar = grammar;
+  const size_t n = out.grammar.rules.size();
+  out.rule_ids.reserve(n);
+  out.rule_strings.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    /* first rule wins, like ProductionGrammar::getRule */
+    out.rule_ids.emplace(out.grammar.rules[i].lhs, i);
+    out.rule_strings.push_back(out.grammar.rules[i].str(false));
+  }
+  for_each_unit(out.grammar, [&](const ProductionUnit& unit) {
+    if (unit.type == ProductionUnit::Type::Terminal && !out.terminal_literals.count(unit.lexeme)) {
+      out.terminal_literals.emplace(unit.lexeme, decodeTerminalLexeme(unit.lexeme));
+    }
+  });
+
+  /* least fixed point of nullable and first sets */
+  out.nullable.assign(n, false);
+  out.first_sets.assign(n, std::bitset<256>());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < n; ++i) {
+      unit_facts_t facts;
+      for (const auto& alt : out.grammar.rules[i].rhs) {
+        const unit_facts_t alt_facts = alternative_facts(out, alt);
+        facts.nullable = facts.nullable || alt_facts.nullable;
+        facts.first |= alt_facts.first;
+      }
+      const bool nullable = out.nullable[i] || facts.nullable;
+      const std::bitset<256> first = out.first_sets[i] | facts.first;
+      if (nullable != out.nullable[i] || first != out.first_sets[i]) {
+        out.nullable[i] = nullable;
+        out.first_sets[i] = first;
+        changed = true;
+      }
+    }
+  }
+  return out;
+}
+
+/* - - - - - - - - - - - - */
+/*     Process memo        */
+/* - - - - - - - - - - - - */
+
+namespace {
+
+std::mutex& compiled_memo_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<std::string, std::shared_ptr<const CompiledGrammar>>& compiled_memo() {
+  static std::unordered_map<std::string, std::shared_ptr<const CompiledGrammar>> memo;
+  return memo;
+}
+
+std::shared_ptr<const CompiledGrammar> memo_find(const std::string& grammar_text) {
+  std::lock_guard<std::mutex> lock(compiled_memo_mutex());
+  const auto it = compiled_memo().find(grammar_text);
+  return it == compiled_memo().end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const CompiledGrammar> memo_insert(const std::string& grammar_text, std::shared_ptr<const CompiledGrammar> compiled) {
+  std::lock_guard<std::mutex> lock(compiled_memo_mutex());
+  return compiled_memo().emplace(grammar_text, std::move(compiled)).first->second;
+}
+
+} /* namespace */
+
+std::shared_ptr<const CompiledGrammar> compileGrammarText(const std::string& grammar_text) {
+  if (auto hit = memo_find(grammar_text)) {
+    return hit;
+  }
+  GrammarLexer lexer(grammar_text);
+  GrammarParser parser(lexer);
+  parser.parseGrammar();
+  return memo_insert(grammar_text, std::make_shared<const CompiledGrammar>(compileGrammar(parser.getGrammar())));
+}
+
+/* - - - - - - - - - - - - */
+/*      Binary cache       */
+/* - - - - - - - - - - - - */
+
+namespace {
+
+constexpr std::array<char, 8> kCompiledGrammarMagic{'C', 'W', 'B', 'N', 'F', 'C', '0', '1'};
+constexpr uint32_t kCompiledGrammarVersion = 1;
+
+struct compiled_grammar_header_t {
+  std::array<char, 8> magic{kCompiledGrammarMagic};
+  uint32_t version{kCompiledGrammarVersion};
+  uint32_t rule_count{0};
+  uint64_t text_bytes{0};
+  std::array<uint8_t, 32> text_digest{};
+  uint64_t reserved{0};
+};
+static_assert(sizeof(compiled_grammar_header_t) == 64);
+
+std::array<uint8_t, 32> text_digest(const std::string& text) {
+  cuwacunu::piaabo::digest::sha256_ctx_t ctx;
+  ctx.update(text);
+  return ctx.final_bytes();
+}
+
+class blob_writer_t {
+public:
+  template <typename T>
+  void pod(const T& value) {
+    const auto* bytes = reinterpret_cast<const char*>(&value);
+    data.append(bytes, sizeof(T));
+  }
+  void str(const std::string& value) {
+    pod(static_cast<uint32_t>(value.size()));
+    data.append(value);
+  }
+  void unit(const ProductionUnit& value) {
+    pod(static_cast<uint8_t>(value.type));
+    str(value.lexeme);
+    pod(static_cast<int32_t>(value.line));
+    pod(static_cast<int32_t>(value.column));
+  }
+  std::string data;
+};
+
+class blob_reader_t {
+public:
+  blob_reader_t(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool pod(T* value) {
+    if (size_ - pos_ < sizeof(T)) return false;
+    std::memcpy(value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+  bool str(std::string* value) {
+    uint32_t size = 0;
+    if (!pod(&size) || size_ - pos_ < size) return false;
+    value->assign(data_ + pos_, size);
+    pos_ += size;
+    return true;
+  }
+  bool unit(ProductionUnit* value) {
+    uint8_t type = 0;
+    int32_t line = 0;
+    int32_t column = 0;
+    if (!pod(&type) || type > static_cast<uint8_t>(ProductionUnit::Type::Undetermined)) return false;
+    if (!str(&value->lexeme) || !pod(&line) || !pod(&column)) return false;
+    value->type = static_cast<ProductionUnit::Type>(type);
+    value->line = line;
+    value->column = column;
+    return true;
+  }
+  bool at_end() const { return pos_ == size_; }
+
+private:
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+} /* namespace */
+
+void saveCompiledGrammar(const CompiledGrammar& compiled, const std::string& grammar_text, const std::filesystem::path& cache_path) {
+  compiled_grammar_header_t header{};
+  header.rule_count = static_cast<uint32_t>(compiled.grammar.rules.size());
+  header.text_bytes = grammar_text.size();
+  header.text_digest = text_digest(grammar_text);
+
+  blob_writer_t w;
+  w.pod(header);
+  for (size_t i = 0; i < compiled.grammar.rules.size(); ++i) {
+    const ProductionRule& rule = compiled.grammar.rules[i];
+    w.str(rule.lhs);
+    w.str(compiled.rule_strings[i]);
+    w.pod(static_cast<uint8_t>(compiled.nullable[i]));
+    for (size_t word = 0; word < 4; ++word) {
+      uint64_t bits = 0;
+      for (size_t b = 0; b < 64; ++b) {
+        if (compiled.first_sets[i].test(word * 64 + b)) bits |= (uint64_t{1} << b);
+      }
+      w.pod(bits);
+    }
+    w.pod(static_cast<uint32_t>(rule.rhs.size()));
+    for (const ProductionAlternative& alt : rule.rhs) {
+      w.str(alt.lhs);
+      w.pod(static_cast<uint8_t>(alt.type));
+      w.pod(static_cast<uint32_t>(alt.flags));
+      if (alt.type == ProductionAlternative::Type::Single) {
+        w.pod(uint32_t{1});
+        w.unit(std::get<ProductionUnit>(alt.content));
+      } else if (alt.type == ProductionAlternative::Type::Sequence) {
+        const auto& units = std::get<std::vector<ProductionUnit>>(alt.content);
+        w.pod(static_cast<uint32_t>(units.size()));
+        for (const auto& unit : units) w.unit(unit);
+      } else {
+        throw std::runtime_error("Compiled grammar: cannot serialize alternative of unknown type: " + alt.str());
+      }
+    }
+  }
+  w.pod(static_cast<uint32_t>(compiled.terminal_literals.size()));
+  for (const auto& [raw, decoded] : compiled.terminal_literals) {
+    w.str(raw);
+    w.str(decoded);
+  }
+
+  /* unique per process and call: concurrent cuwacunu_exec runs refresh the same cache */
+  static std::atomic<uint64_t> tmp_sequence{0};
+  std::filesystem::path tmp = cache_path;
+  tmp += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(tmp_sequence.fetch_add(1));
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("Compiled grammar: could not open " + tmp.string());
+    }
+    out.write(w.data.data(), static_cast<std::streamsize>(w.data.size()));
+    out.flush();
+    if (!out) {
+      std::error_code ignored;
+      std::filesystem::remove(tmp, ignored);
+      throw std::runtime_error("Compiled grammar: failed writing " + tmp.string());
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, cache_path, ec);
+  if (ec) {
+    std::error_code ignored;
+    std::filesystem::remove(tmp, ignored);
+    throw std::runtime_error("Compiled grammar: failed renaming " + tmp.string() + ": " + ec.message());
+  }
+}
+
+bool loadCompiledGrammar(const std::filesystem::path& cache_path, const std::string& grammar_text, CompiledGrammar* out) {
+  if (!out) return false;
+  std::ifstream in(cache_path, std::ios::binary);
+  if (!in) return false;
+  const std::string blob((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  blob_reader_t r(blob.data(), blob.size());
+
+  compiled_grammar_header_t header{};
+  if (!r.pod(&header) || header.magic != kCompiledGrammarMagic ||
+      header.version != kCompiledGrammarVersion ||
+      header.text_bytes != grammar_text.size() ||
+      header.text_digest != text_digest(grammar_text)) {
+    return false;
+  }
+
+  CompiledGrammar loaded;
+  loaded.grammar.rules.reserve(header.rule_count);
+  for (uint32_t i = 0; i < header.rule_count; ++i) {
+    ProductionRule rule;
+    std::string rule_string;
+    uint8_t nullable = 0;
+    std::bitset<256> first;
+    uint32_t alt_count = 0;
+    if (!r.str(&rule.lhs) || !r.str(&rule_string) || !r.pod(&nullable)) return false;
+    for (size_t word = 0; word < 4; ++word) {
+      uint64_t bits = 0;
+      if (!r.pod(&bits)) return false;
+      for (size_t b = 0; b < 64; ++b) {
+        if ((bits >> b) & 1u) first.set(word * 64 + b);
+      }
+    }
+    if (!r.pod(&alt_count)) return false;
+    for (uint32_t a = 0; a < alt_count; ++a) {
+      std::string alt_lhs;
+      uint8_t type = 0;
+      uint32_t flags = 0;
+      uint32_t unit_count = 0;
+      if (!r.str(&alt_lhs) || !r.pod(&type) || !r.pod(&flags) || !r.pod(&unit_count)) return false;
+      const auto alt_flags = static_cast<ProductionAlternative::Flags>(flags);
+      if (type == static_cast<uint8_t>(ProductionAlternative::Type::Single)) {
+        ProductionUnit unit;
+        if (unit_count != 1 || !r.unit(&unit)) return false;
+        rule.rhs.emplace_back(alt_lhs, unit, alt_flags);
+      } else if (type == static_cast<uint8_t>(ProductionAlternative::Type::Sequence)) {
+        std::vector<ProductionUnit> units(unit_count);
+        for (auto& unit : units) {
+          if (!r.unit(&unit)) return false;
+        }
+        rule.rhs.emplace_back(alt_lhs, units, alt_flags);
+      } else {
+        return false;
+      }
+    }
+    loaded.rule_ids.emplace(rule.lhs, i);
+    loaded.rule_strings.push_back(std::move(rule_string));
+    loaded.nullable.push_back(nullable != 0);
+    loaded.first_sets.push_back(first);
+    loaded.grammar.rules.push_back(std::move(rule));
+  }
+  uint32_t literal_count = 0;
+  if (!r.pod(&literal_count)) return false;
+  for (uint32_t i = 0; i < literal_count; ++i) {
+    std::string raw;
+    std::string decoded;
+    if (!r.str(&raw) || !r.str(&decoded)) return false;
+    loaded.terminal_literals.emplace(std::move(raw), std::move(decoded));
+  }
+  if (!r.at_end()) return false;
+
+  *out = std::move(loaded);
+  return true;
+}
+
+std::filesystem::path compiledGrammarCachePath(const std::filesystem::path& grammar_path) {
+  std::filesystem::path out = grammar_path;
+  out += ".compiled";
+  return out;
+}
+
+namespace {
+
+std::atomic<size_t> file_cache_memo_hits{0};
+std::atomic<size_t> file_cache_file_hits{0};
+std::atomic<size_t> file_cache_compiles{0};
+
+} /* namespace */
+
+CachedGrammarFile readGrammarFileCached(const std::filesystem::path& grammar_path) {
+  std::ifstream in(grammar_path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Compiled grammar: could not read grammar file " + grammar_path.string());
+  }
+  CachedGrammarFile out;
+  out.text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  if ((out.compiled = memo_find(out.text))) {
+    ++file_cache_memo_hits;
+    return out;
+  }
+
+  const auto cache_path = compiledGrammarCachePath(grammar_path);
+  CompiledGrammar loaded;
+  if (loadCompiledGrammar(cache_path, out.text, &loaded)) {
+    ++file_cache_file_hits;
+    out.compiled = memo_insert(out.text, std::make_shared<const CompiledGrammar>(std::move(loaded)));
+    return out;
+  }
+
+  ++file_cache_compiles;
+  out.compiled = compileGrammarText(out.text);
+  try {
+    saveCompiledGrammar(*out.compiled, out.text, cache_path);
+  } catch (const std::exception&) {
+    /* read-only config trees still parse; they just pay the compile each time */
+  }
+  return out;
+}
+
+std::shared_ptr<const CompiledGrammar> loadGrammarFileCached(const std::filesystem::path& grammar_path) {
+  return readGrammarFileCached(grammar_path).compiled;
+}
+
+GrammarFileCacheStats grammarFileCacheStats() {
+  return GrammarFileCacheStats{file_cache_memo_hits.load(), file_cache_file_hits.load(), file_cache_compiles.load()};
+}
+
+} /* namespace bnf */
+} /* namespace parse */
+} /* namespace piaabo */
+} /* namespace cuwacunu */
@@ -280,7 +280,7 @@ ProductionUnit GrammarLexer::parseTerminal() {
     }
 
     // Escape sequence: keep backslash + next char verbatim.
-    // They will be interpreted later by InstructionParser::unescape().
+    // They will be interpreted later by decodeTerminalLexeme() when the grammar is compiled.
     if (ch == '\\') {
       lexeme += advance();             // '\'
       if (!isAtEnd()) {
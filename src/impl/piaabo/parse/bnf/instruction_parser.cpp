@@ -1,8 +1,16 @@
 /* bnf_instruction_parser.cpp */
 #include "piaabo/parse/bnf/instruction_parser.h"
 
-// Backlog: parser speed and ProductionAlternative::Flags semantics are cleanup
-// items; they are not runtime warning conditions.
+// Backlog: ProductionAlternative::Flags semantics are a cleanup item; it is not
+// a runtime warning condition.
+//
+// Rule attempts are packrat-memoized per (rule id, input position) for the
+// duration of one parse_Instruction call, so backtracking never re-parses a
+// rule at a position it has already tried, and non-nullable rules are skipped
+// outright when the next input byte is outside their first set. Memo hits
+// replay the failure position and the rule-level diagnostics; terminal-level
+// messages are only reported for the first attempt. Diagnostics are recorded
+// as small events and only formatted when an instruction fails to parse.
 
 namespace cuwacunu {
 namespace piaabo {
@@ -22,6 +30,10 @@ InstructionParser::parse_Instruction(const std::string &instruction_input) {
   iLexer.setInput(instruction_input);
   iLexer.reset();
   failure_position = 0; /* safe init */
+  terminal_failure_count = 0;
+  error_clear_count = 0;
+  memo.clear();
+  memo_stride = instruction_input.size() + 1;
 
   /* reset the stacks */
   while (!parsing_error_stack.empty()) {
@@ -32,7 +44,8 @@ InstructionParser::parse_Instruction(const std::string &instruction_input) {
   };
 
   /* parse Instruction Rule */
-  ASTNodePtr root_node = parse_ProductionRule(grammar.getRule(lhs_instruction));
+  ASTNodePtr root_node = parse_ProductionRule(compiled->ruleId(lhs_instruction));
+  memo.clear();
 
   /* validate */
   if (root_node == nullptr || !iLexer.isAtEnd()) {
@@ -41,14 +54,14 @@ InstructionParser::parse_Instruction(const std::string &instruction_input) {
     /* print the report in case of failure */
     std::ostringstream err_oss, scss_oss;
     while (!parsing_error_stack.empty()) {
-      err_oss << parsing_error_stack.top() << "\n";
+      err_oss << format_Diagnostic(parsing_error_stack.top()) << "\n";
       parsing_error_stack.pop();
     }
     if (parsing_success_stack.size() > max_success_stack) {
       scss_oss << "\t\t ...truncated to size " << max_success_stack << "...\n";
     }
     while (!parsing_success_stack.empty() && ++count < max_success_stack) {
-      scss_oss << parsing_success_stack.top() << "\n";
+      scss_oss << format_Diagnostic(parsing_success_stack.top()) << "\n";
       parsing_success_stack.pop();
     }
     throw std::runtime_error(
@@ -73,9 +86,70 @@ InstructionParser::parse_Instruction(const std::string &instruction_input) {
 
 /* --- --- --- --- --- parse types --- --- --- --- --- ---  */
 
-ASTNodePtr InstructionParser::parse_ProductionRule(const ProductionRule &rule) {
+void InstructionParser::clear_ErrorStack() {
+  while (!parsing_error_stack.empty()) {
+    parsing_error_stack.pop();
+  };
+  ++error_clear_count;
+}
+
+ASTNodePtr InstructionParser::replay_Memo(MemoEntry &entry) {
+  if (entry.had_failure) {
+    failure_position = entry.failure_position;
+    ++terminal_failure_count;
+  }
+  if (entry.cleared_errors) {
+    clear_ErrorStack();
+  }
+  if (!entry.matched) {
+    return nullptr;
+  }
+  iLexer.setPosition(entry.end_position);
+  parsing_success_stack.push(entry.success);
+  return cloneAST(entry.node.get());
+}
+
+ASTNodePtr InstructionParser::parse_ProductionRule(size_t rule_id) {
   size_t initial_pos = iLexer.getPosition();
-  std::vector<std::pair<ASTNodePtr, size_t>> matches;
+  const size_t memo_key = rule_id * memo_stride + initial_pos;
+  Diagnostic rule_failure;
+  rule_failure.kind = Diagnostic::Kind::RuleFailure;
+  rule_failure.rule_id = rule_id;
+
+  /* packrat: a failed attempt, or a success seen twice, is replayed */
+  auto memo_it = memo.find(memo_key);
+  if (memo_it != memo.end()) {
+    MemoEntry &entry = memo_it->second;
+    if (!entry.matched) {
+      parsing_error_stack.push(rule_failure);
+      return replay_Memo(entry);
+    }
+    if (entry.node != nullptr) {
+      return replay_Memo(entry);
+    }
+  }
+
+  /* first-set rejection: every alternative would fail on the next byte */
+  if (compiled->rejects(rule_id, static_cast<unsigned char>(iLexer.peek()),
+                        iLexer.isAtEnd())) {
+    failure_position = initial_pos;
+    ++terminal_failure_count;
+    parsing_error_stack.push(rule_failure);
+    MemoEntry &entry = memo[memo_key];
+    entry.had_failure = true;
+    entry.failure_position = initial_pos;
+    return nullptr;
+  }
+
+  const size_t failures_before = terminal_failure_count;
+  const size_t clears_before = error_clear_count;
+  const ProductionRule &rule = compiled->grammar.rules[rule_id];
+  struct match_t {
+    ASTNodePtr node;
+    size_t end_position;
+    const ProductionAlternative *alt;
+  };
+  std::vector<match_t> matches;
 
   /* try to match all alternatives */
   for (const ProductionAlternative &alternative : rule.rhs) {
@@ -88,46 +162,59 @@ ASTNodePtr InstructionParser::parse_ProductionRule(const ProductionRule &rule) {
      * choose later */
     if (node != nullptr) {
       /* Append to success: store the node and the new lexer position */
-      matches.emplace_back(std::move(node), iLexer.getPosition());
+      matches.push_back(
+          match_t{std::move(node), iLexer.getPosition(), &alternative});
     }
   }
 
+  /* what this attempt did, for replay on later visits */
+  MemoEntry &entry = memo[memo_key];
+  entry.had_failure = terminal_failure_count != failures_before;
+  entry.failure_position = failure_position;
+  entry.cleared_errors = error_clear_count != clears_before;
+
   /* Determine if there was a success */
   if (!matches.empty()) {
     if (matches.size() > 1) {
       /* push the problem to the stack */
-      parsing_error_stack.push(cuwacunu::piaabo::core::string_format(
-          "        : --- --- : >> %sMultiple Alternatives%s [%ld]: found for "
-          "rule %s",
-          ANSI_COLOR_Yellow, ANSI_COLOR_RESET, matches.size(),
-          rule.str(false).c_str()));
+      Diagnostic multiple;
+      multiple.kind = Diagnostic::Kind::MultipleAlternatives;
+      multiple.rule_id = rule_id;
+      multiple.count = matches.size();
+      parsing_error_stack.push(multiple);
     }
     /* Find the match with the longest consumed input */
-    auto best_match_iter =
-        std::max_element(matches.begin(), matches.end(),
-                         [&](const std::pair<ASTNodePtr, size_t> &a,
-                             const std::pair<ASTNodePtr, size_t> &b) -> bool {
-                           return a.second < b.second;
-                         });
+    auto best_match_iter = std::max_element(
+        matches.begin(), matches.end(),
+        [&](const match_t &a, const match_t &b) -> bool {
+          return a.end_position < b.end_position;
+        });
 
     /* Advance the to the position after the best match */
-    iLexer.setPosition(best_match_iter->second);
+    iLexer.setPosition(best_match_iter->end_position);
 
     /* push the success to the stack */
-    parsing_success_stack.push(cuwacunu::piaabo::core::string_format(
-        "        :        : --- --- >> parsed %sparse_ProductionRule%s : %s",
-        ANSI_COLOR_Bright_Green, ANSI_COLOR_RESET,
-        best_match_iter->first->str(true).c_str()));
+    Diagnostic success;
+    success.kind = Diagnostic::Kind::RuleSuccess;
+    success.rule_id = rule_id;
+    success.alt = best_match_iter->alt;
+    parsing_success_stack.push(success);
+
+    /* keep a copy only once the position is revisited, so single-visit
+     * rules cost no extra allocation */
+    if (entry.matched) {
+      entry.node = cloneAST(best_match_iter->node.get());
+    }
+    entry.matched = true;
+    entry.end_position = best_match_iter->end_position;
+    entry.success = success;
 
     /* Return the AST node corresponding to the best match */
-    return std::move(best_match_iter->first);
+    return std::move(best_match_iter->node);
   }
 
   /* push the problem to the stack */
-  parsing_error_stack.push(cuwacunu::piaabo::core::string_format(
-      "        : --- --- : >> %sUnable%s to parse %sRule%s: %s",
-      ANSI_COLOR_Bright_Red, ANSI_COLOR_RESET, ANSI_COLOR_Cyan,
-      ANSI_COLOR_RESET, rule.str(false).c_str()));
+  parsing_error_stack.push(rule_failure);
   /* none of the alternatives matched */
   iLexer.setPosition(initial_pos);
 
@@ -136,18 +223,19 @@ ASTNodePtr InstructionParser::parse_ProductionRule(const ProductionRule &rule) {
 
 ASTNodePtr InstructionParser::parse_ProductionAlternative(
     const ProductionAlternative &alt) {
-  std::vector<ProductionUnit> units;
+  const ProductionUnit *units = nullptr;
+  size_t unit_count = 0;
   std::vector<ASTNodePtr> children;
 
-  /* emplace the units */
+  /* reference the units in place */
   switch (alt.type) {
   case ProductionAlternative::Type::Single:
-    units.push_back(std::get<ProductionUnit>(alt.content));
+    units = &std::get<ProductionUnit>(alt.content);
+    unit_count = 1;
     break;
   case ProductionAlternative::Type::Sequence:
-    units.insert(units.end(),
-                 std::get<std::vector<ProductionUnit>>(alt.content).begin(),
-                 std::get<std::vector<ProductionUnit>>(alt.content).end());
+    units = std::get<std::vector<ProductionUnit>>(alt.content).data();
+    unit_count = std::get<std::vector<ProductionUnit>>(alt.content).size();
     break;
   case ProductionAlternative::Type::Unknown:
   default:
@@ -157,12 +245,14 @@ ASTNodePtr InstructionParser::parse_ProductionAlternative(
   }
 
   /* validate */
-  if (units.empty()) {
+  if (unit_count == 0) {
     return nullptr;
   }
+  children.reserve(unit_count);
 
   /* parse the individual units */
-  for (const ProductionUnit &unit : units) {
+  for (size_t i = 0; i < unit_count; ++i) {
+    const ProductionUnit &unit = units[i];
     size_t initial_pos = iLexer.getPosition();
 
     /* parse unit */
@@ -206,7 +296,7 @@ InstructionParser::parse_ProductionUnit(const ProductionAlternative &alt,
     return parse_TerminalNode(alt.lhs, unit);
 
   case ProductionUnit::Type::NonTerminal:
-    return parse_ProductionRule(grammar.getRule(unit.lexeme));
+    return parse_ProductionRule(compiled->ruleId(unit.lexeme));
 
   case ProductionUnit::Type::Optional: {
     std::string inner_lexeme = unit.lexeme.substr(
@@ -232,7 +322,7 @@ InstructionParser::parse_ProductionUnit(const ProductionAlternative &alt,
 
     do {
       const size_t before_child = iLexer.getPosition();
-      child = parse_ProductionRule(grammar.getRule(inner_lexeme));
+      child = parse_ProductionRule(compiled->ruleId(inner_lexeme));
 
       if (child == nullptr) {
         break;
@@ -258,49 +348,6 @@ InstructionParser::parse_ProductionUnit(const ProductionAlternative &alt,
   }
 }
 
-std::string unescape(const std::string &str) {
-  std::string result;
-  for (size_t i = 0; i < str.size(); ++i) {
-    if (str[i] == '\\' && i + 1 < str.size()) {
-      switch (str[i + 1]) {
-      case 'n':
-        result += '\n';
-        ++i;
-        break;
-      case 'r':
-        result += '\r';
-        ++i;
-        break;
-      case 't':
-        result += '\t';
-        ++i;
-        break;
-      case '\\':
-        result += '\\';
-        ++i;
-        break;
-      case '"':
-        result += '"';
-        ++i;
-        break;
-      case '\'':
-        result += '\'';
-        ++i;
-        break;
-      default:
-        // If unknown escape sequence, include both characters as-is
-        result += '\\';
-        result += str[i + 1];
-        ++i;
-        break;
-      }
-    } else {
-      result += str[i];
-    }
-  }
-  return result;
-}
-
 std::string scape(const char ch) {
   std::string result;
   switch (ch) {
@@ -337,29 +384,22 @@ std::string scape(const std::string &str) {
 ASTNodePtr InstructionParser::parse_TerminalNode(const std::string &lhs,
                                                  const ProductionUnit &unit) {
   size_t initial_pos = iLexer.getPosition();
-  std::string lexeme = unit.lexeme;
-
-  /* remove quotes */
-  if ((lexeme.front() == '"' && lexeme.back() == '"') ||
-      (lexeme.front() == '\'' && lexeme.back() == '\'')) {
-    lexeme = lexeme.substr(1, lexeme.size() - 2);
-  }
-
-  /* handle escape sequences */
-  lexeme = unescape(lexeme);
+  /* quotes and escapes were resolved when the grammar was compiled */
+  const std::string &lexeme = compiled->terminalLiteral(unit);
 
   /* parse terminal */
   for (char ch : lexeme) {
     if (iLexer.isAtEnd() || iLexer.peek() != ch) {
       /* push the error to the stack */
-      parsing_error_stack.push(cuwacunu::piaabo::core::string_format(
-          "        :        : --- --- >> Unable to parse %sTerminal Node%s : "
-          "%s :  trying to match terminal: \"%s\" for character \'%s\' having "
-          "lexer at character: \'%s\'",
-          ANSI_COLOR_Bright_Red, ANSI_COLOR_RESET, unit.str(true).c_str(),
-          lexeme.c_str(), scape(ch).c_str(), scape(iLexer.peek()).c_str()));
+      Diagnostic mismatch;
+      mismatch.kind = Diagnostic::Kind::TerminalMismatch;
+      mismatch.unit = &unit;
+      mismatch.expected = ch;
+      mismatch.found = iLexer.peek();
+      parsing_error_stack.push(mismatch);
       /* save the failure position */
       failure_position = iLexer.getPosition();
+      ++terminal_failure_count;
       /* Match failed */
       iLexer.setPosition(initial_pos);
       return nullptr;
@@ -368,13 +408,54 @@ ASTNodePtr InstructionParser::parse_TerminalNode(const std::string &lhs,
   }
 
   /* reset the error stack (to avoid it growing to large) */
-  while (!parsing_error_stack.empty()) {
-    parsing_error_stack.pop();
-  };
+  clear_ErrorStack();
 
   return std::make_unique<TerminalNode>(lhs, unit);
 }
 
+std::string
+InstructionParser::format_Diagnostic(const Diagnostic &diagnostic) const {
+  switch (diagnostic.kind) {
+  case Diagnostic::Kind::TerminalMismatch:
+    return cuwacunu::piaabo::core::string_format(
+        "        :        : --- --- >> Unable to parse %sTerminal Node%s : "
+        "%s :  trying to match terminal: \"%s\" for character \'%s\' having "
+        "lexer at character: \'%s\'",
+        ANSI_COLOR_Bright_Red, ANSI_COLOR_RESET,
+        diagnostic.unit->str(true).c_str(),
+        compiled->terminalLiteral(*diagnostic.unit).c_str(),
+        scape(diagnostic.expected).c_str(), scape(diagnostic.found).c_str());
+  case Diagnostic::Kind::MultipleAlternatives:
+    return cuwacunu::piaabo::core::string_format(
+        "        : --- --- : >> %sMultiple Alternatives%s [%ld]: found for "
+        "rule %s",
+        ANSI_COLOR_Yellow, ANSI_COLOR_RESET, diagnostic.count,
+        compiled->rule_strings[diagnostic.rule_id].c_str());
+  case Diagnostic::Kind::RuleSuccess: {
+    /* the node parse_ProductionAlternative builds for this alternative */
+    const ProductionAlternative &alt = *diagnostic.alt;
+    std::string node_str;
+    if (alt.type == ProductionAlternative::Type::Single &&
+        std::get<ProductionUnit>(alt.content).type ==
+            ProductionUnit::Type::Terminal) {
+      node_str =
+          TerminalNode(alt.lhs, std::get<ProductionUnit>(alt.content)).str(true);
+    } else {
+      node_str = IntermediaryNode(alt, std::vector<ASTNodePtr>{}).str(true);
+    }
+    return cuwacunu::piaabo::core::string_format(
+        "        :        : --- --- >> parsed %sparse_ProductionRule%s : %s",
+        ANSI_COLOR_Bright_Green, ANSI_COLOR_RESET, node_str.c_str());
+  }
+  case Diagnostic::Kind::RuleFailure:
+  default:
+    return cuwacunu::piaabo::core::string_format(
+        "        : --- --- : >> %sUnable%s to parse %sRule%s: %s",
+        ANSI_COLOR_Bright_Red, ANSI_COLOR_RESET, ANSI_COLOR_Cyan,
+        ANSI_COLOR_RESET, compiled->rule_strings[diagnostic.rule_id].c_str());
+  }
+}
+
 } /* namespace bnf */
 } /* namespace parse */
 } /* namespace piaabo */
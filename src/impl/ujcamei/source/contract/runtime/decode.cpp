@@ -9,6 +9,7 @@
 #include "hero/config_derivation.h"
 #include "hero/config_path_defaults.h"
 #include "piaabo/core/utils.h"
+#include "piaabo/parse/bnf/compiled_grammar.h"
 
 #include <cctype>
 #include <cerrno>
@@ -209,6 +210,12 @@ parse_nonnegative_i64_field(const std::string &text, const std::string &field,
   return oss.str();
 }
 
+/* loads through the on-disk compiled grammar cache, so the decoders built
+ * from the returned text find their compiled form in the process memo */
+[[nodiscard]] std::string read_grammar_file_or_throw(const std::string &path) {
+  return cuwacunu::piaabo::parse::bnf::readGrammarFileCached(path).text;
+}
+
 [[nodiscard]] std::unordered_map<std::string, std::string>
 parse_simple_config_file(const std::string &config_path) {
   const std::string text = read_text_file_or_throw(config_path);
@@ -686,11 +693,11 @@ source_spec_t decode_source_spec_from_config(std::string config_path) {
   const auto graph_first_graph_dsl_path = required_config_value(
       cfg, "kikijyeba_topology_graph_dsl_path", config_path);
   auto spec = decode_source_spec_from_split_dsl(
-      read_text_file_or_throw(paths.source_registry_dsl_bnf_path),
+      read_grammar_file_or_throw(paths.source_registry_dsl_bnf_path),
       read_text_file_or_throw(paths.source_registry_dsl_path),
-      read_text_file_or_throw(graph_first_retrieval_channels_dsl_bnf_path),
+      read_grammar_file_or_throw(graph_first_retrieval_channels_dsl_bnf_path),
       read_text_file_or_throw(graph_first_retrieval_channels_dsl_path),
-      read_text_file_or_throw(graph_first_graph_dsl_bnf_path),
+      read_grammar_file_or_throw(graph_first_graph_dsl_bnf_path),
       read_text_file_or_throw(graph_first_graph_dsl_path));
   resolve_source_paths_relative_to_registry(spec,
                                             paths.source_registry_dsl_path);
@@ -701,7 +708,7 @@ source_universe_t decode_source_universe_from_config(std::string config_path) {
   const auto paths =
       load_source_registry_config_paths_from_config(std::move(config_path));
   auto universe = decode_source_universe_from_split_dsl(
-      read_text_file_or_throw(paths.source_registry_dsl_bnf_path),
+      read_grammar_file_or_throw(paths.source_registry_dsl_bnf_path),
       read_text_file_or_throw(paths.source_registry_dsl_path));
   resolve_source_paths_relative_to_registry(universe,
                                             paths.source_registry_dsl_path);
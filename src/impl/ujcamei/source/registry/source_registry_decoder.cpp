@@ -290,8 +290,22 @@ void append_kline_source_set(
 
 source_registry_decoder_t::source_registry_decoder_t(std::string grammar_text)
     : SOURCE_FORMS_GRAMMAR_TEXT(std::move(grammar_text)),
-      grammarLexer(SOURCE_FORMS_GRAMMAR_TEXT), grammarParser(grammarLexer),
-      grammar(parseGrammarDefinition()), iParser(iLexer, grammar) {
+      grammar(parseGrammarDefinition()),
+      iParser(iLexer, compileGrammarText(SOURCE_FORMS_GRAMMAR_TEXT)) {
+#ifdef SOURCE_PIPELINE_DEBUG
+  log_dbg("%s\n", SOURCE_FORMS_GRAMMAR_TEXT.c_str());
+#endif
+}
+
+source_registry_decoder_t::source_registry_decoder_t(
+    const std::filesystem::path &grammar_path)
+    : source_registry_decoder_t(readGrammarFileCached(grammar_path)) {}
+
+source_registry_decoder_t::source_registry_decoder_t(
+    CachedGrammarFile grammar_file)
+    : SOURCE_FORMS_GRAMMAR_TEXT(std::move(grammar_file.text)),
+      grammar(grammar_file.compiled->grammar),
+      iParser(iLexer, std::move(grammar_file.compiled)) {
 #ifdef SOURCE_PIPELINE_DEBUG
   log_dbg("%s\n", SOURCE_FORMS_GRAMMAR_TEXT.c_str());
 #endif
@@ -323,8 +337,8 @@ source_spec_t source_registry_decoder_t::decode(std::string instruction) {
 }
 
 ProductionGrammar source_registry_decoder_t::parseGrammarDefinition() {
-  grammarParser.parseGrammar();
-  return grammarParser.getGrammar();
+  /* compiled once per process per grammar text; see compileGrammarText */
+  return compileGrammarText(SOURCE_FORMS_GRAMMAR_TEXT)->grammar;
 }
 
 void source_registry_decoder_t::visit(const RootNode *node,
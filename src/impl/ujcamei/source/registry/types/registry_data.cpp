@@ -2,6 +2,8 @@
 #include "ujcamei/source/registry/types/data.h"
 #include "ujcamei/source/registry/types/kline_feature_registry.h"
 #include <array>
+#include <cctype>
+#include <charconv>
 #include <cmath>
 #include <cstring>
 #include <iomanip>
@@ -57,8 +59,76 @@ void reset_normalization_warning_scope_state() {
   return static_cast<ms_t>(raw_time);
 }
 
-[[nodiscard]] ms_t parse_exchange_time_ms(const std::string &raw) {
-  return canonical_exchange_time_ms(std::stoll(raw));
+/*
+ * CSV field parsing. Fields are parsed in place with std::from_chars; any
+ * field it does not take whole (leading blanks, '+', hex, subnormals, range
+ * errors, junk) falls back to the std::sto* call used before, so accepted
+ * values, results and exception messages are unchanged.
+ */
+[[nodiscard]] bool csv_field_tail_is_blank(const char *p, const char *end) {
+  for (; p != end; ++p) {
+    if (std::isspace(static_cast<unsigned char>(*p)) == 0)
+      return false;
+  }
+  return true;
+}
+
+[[nodiscard]] double csv_field_to_double(std::string_view field) {
+  double value = 0.0;
+  const char *end = field.data() + field.size();
+  const auto [p, ec] = std::from_chars(field.data(), end, value);
+  if (ec == std::errc{} && csv_field_tail_is_blank(p, end) &&
+      (value == 0.0 || !std::isfinite(value) ||
+       std::fabs(value) >= std::numeric_limits<double>::min())) {
+    return value;
+  }
+  return std::stod(std::string(field));
+}
+
+[[nodiscard]] i64 csv_field_to_i64(std::string_view field) {
+  long long value = 0;
+  const char *end = field.data() + field.size();
+  const auto [p, ec] = std::from_chars(field.data(), end, value);
+  if (ec == std::errc{} && csv_field_tail_is_blank(p, end)) {
+    return static_cast<i64>(value);
+  }
+  return static_cast<i64>(std::stoll(std::string(field)));
+}
+
+[[nodiscard]] int csv_field_to_int(std::string_view field) {
+  int value = 0;
+  const char *end = field.data() + field.size();
+  const auto [p, ec] = std::from_chars(field.data(), end, value);
+  if (ec == std::errc{} && csv_field_tail_is_blank(p, end)) {
+    return value;
+  }
+  return std::stoi(std::string(field));
+}
+
+/*
+ * Splits a line the way std::getline over a stringstream does: a trailing
+ * delimiter does not open an empty last field, and an empty line has no
+ * fields. Returns the field count; only the first N fields are stored.
+ */
+template <std::size_t N>
+[[nodiscard]] std::size_t
+split_csv_fields(std::string_view line, char delimiter,
+                 std::array<std::string_view, N> &out) {
+  std::size_t count = 0;
+  while (!line.empty()) {
+    const std::size_t pos = line.find(delimiter);
+    if (count < N)
+      out[count] = line.substr(0, pos);
+    ++count;
+    if (pos == std::string_view::npos)
+      break;
+    line.remove_prefix(pos + 1);
+  }
+  return count;
+}
+
+[[nodiscard]] ms_t parse_exchange_time_ms(std::string_view raw) {
+  return canonical_exchange_time_ms(csv_field_to_i64(raw));
 }
 
 std::size_t &warning_summary_slot(normalization_warning_summary_t &summary,
@@ -336,35 +406,36 @@ tickerBook_ret_t::tickerBook_ret_t(const std::string &json) {
 
 trade_t trade_t::from_csv(const std::string &line, char delimiter,
                           size_t line_number) {
-  const size_t expected_fields = 7;
-  std::vector<std::string> tokens;
-  std::stringstream ss(line);
-  std::string token;
-  while (std::getline(ss, token, delimiter)) {
-    tokens.push_back(token);
-  }
+  return from_csv_view(line, delimiter, line_number);
+}
+
+trade_t trade_t::from_csv_view(std::string_view line, char delimiter,
+                               size_t line_number) {
+  constexpr size_t expected_fields = 7;
+  std::array<std::string_view, expected_fields> tokens;
+  const size_t field_count = split_csv_fields(line, delimiter, tokens);
 
-  if (tokens.size() != expected_fields) {
+  if (field_count != expected_fields) {
     throw std::runtime_error(
         "[from_csv](trade_t) Incorrect number of fields in line " +
         std::to_string(line_number) + ": expected " +
         std::to_string(expected_fields) + ", got " +
-        std::to_string(tokens.size()) + ". Line content: " + line);
+        std::to_string(field_count) + ". Line content: " + std::string(line));
   }
 
   trade_t trade;
   size_t idx = 0;
 
   try {
-    trade.id = std::stoll(tokens[idx++]);
-    trade.price = std::stod(tokens[idx++]);
-    trade.qty = std::stod(tokens[idx++]);
-    trade.quoteQty = std::stod(tokens[idx++]);
+    trade.id = csv_field_to_i64(tokens[idx++]);
+    trade.price = csv_field_to_double(tokens[idx++]);
+    trade.qty = csv_field_to_double(tokens[idx++]);
+    trade.quoteQty = csv_field_to_double(tokens[idx++]);
     trade.time = parse_exchange_time_ms(tokens[idx++]);
 
     // isBuyerMaker
     {
-      std::string &bool_str = tokens[idx++];
+      const std::string_view bool_str = tokens[idx++];
       if (bool_str == "true" || bool_str == "1") {
         trade.isBuyerMaker = true;
       } else if (bool_str == "false" || bool_str == "0") {
@@ -372,13 +443,13 @@ trade_t trade_t::from_csv(const std::string &line, char delimiter,
       } else {
         throw std::runtime_error(
             "[from_csv](trade_t) Invalid boolean value for isBuyerMaker: " +
-            bool_str);
+            std::string(bool_str));
       }
     }
 
     // isBestMatch
     {
-      std::string &bool_str = tokens[idx++];
+      const std::string_view bool_str = tokens[idx++];
       if (bool_str == "true" || bool_str == "1") {
         trade.isBestMatch = true;
       } else if (bool_str == "false" || bool_str == "0") {
@@ -386,7 +457,7 @@ trade_t trade_t::from_csv(const std::string &line, char delimiter,
       } else {
         throw std::runtime_error(
             "[from_csv](trade_t) Invalid boolean value for isBestMatch: " +
-            bool_str);
+            std::string(bool_str));
       }
     }
   } catch (const std::exception &e) {
@@ -400,21 +471,22 @@ trade_t trade_t::from_csv(const std::string &line, char delimiter,
 
 kline_t kline_t::from_csv(const std::string &line, char delimiter,
                           size_t line_number) {
-  const size_t expected_fields =
+  return from_csv_view(line, delimiter, line_number);
+}
+
+kline_t kline_t::from_csv_view(std::string_view line, char delimiter,
+                               size_t line_number) {
+  constexpr size_t expected_fields =
       11 + 1; /* unused additional field (per Binance doc) */
-  std::vector<std::string> tokens;
-  std::stringstream ss(line);
-  std::string token;
-  while (std::getline(ss, token, delimiter)) {
-    tokens.push_back(token);
-  }
+  std::array<std::string_view, expected_fields> tokens;
+  const size_t field_count = split_csv_fields(line, delimiter, tokens);
 
-  if (tokens.size() != expected_fields) {
+  if (field_count != expected_fields) {
     throw std::runtime_error(
         "[from_csv](kline_t) Incorrect number of fields in line " +
         std::to_string(line_number) + ": expected " +
         std::to_string(expected_fields) + ", got " +
-        std::to_string(tokens.size()) + ". Line content: " + line);
+        std::to_string(field_count) + ". Line content: " + std::string(line));
   }
 
   kline_t kline;
@@ -422,16 +494,17 @@ kline_t kline_t::from_csv(const std::string &line, char delimiter,
 
   try {
     kline.open_time = parse_exchange_time_ms(tokens[idx++]);
-    kline.open_price = std::stod(tokens[idx++]);
-    kline.high_price = std::stod(tokens[idx++]);
-    kline.low_price = std::stod(tokens[idx++]);
-    kline.close_price = std::stod(tokens[idx++]);
-    kline.volume = std::stod(tokens[idx++]);
+    kline.open_price = csv_field_to_double(tokens[idx++]);
+    kline.high_price = csv_field_to_double(tokens[idx++]);
+    kline.low_price = csv_field_to_double(tokens[idx++]);
+    kline.close_price = csv_field_to_double(tokens[idx++]);
+    kline.volume = csv_field_to_double(tokens[idx++]);
     kline.close_time = parse_exchange_time_ms(tokens[idx++]);
-    kline.quote_asset_volume = std::stod(tokens[idx++]);
-    kline.number_of_trades = static_cast<int32_t>(std::stoi(tokens[idx++]));
-    kline.taker_buy_base_volume = std::stod(tokens[idx++]);
-    kline.taker_buy_quote_volume = std::stod(tokens[idx++]);
+    kline.quote_asset_volume = csv_field_to_double(tokens[idx++]);
+    kline.number_of_trades =
+        static_cast<int32_t>(csv_field_to_int(tokens[idx++]));
+    kline.taker_buy_base_volume = csv_field_to_double(tokens[idx++]);
+    kline.taker_buy_quote_volume = csv_field_to_double(tokens[idx++]);
   } catch (const std::exception &e) {
     throw std::runtime_error(
         std::string("[from_csv](kline_t) Error parsing tokens in line ") +
@@ -443,28 +516,29 @@ kline_t kline_t::from_csv(const std::string &line, char delimiter,
 
 basic_t basic_t::from_csv(const std::string &line, char delimiter,
                           size_t line_number) {
-  const size_t expected_fields = 2;
-  std::vector<std::string> tokens;
-  std::stringstream ss(line);
-  std::string token;
-  while (std::getline(ss, token, delimiter)) {
-    tokens.push_back(token);
-  }
+  return from_csv_view(line, delimiter, line_number);
+}
+
+basic_t basic_t::from_csv_view(std::string_view line, char delimiter,
+                               size_t line_number) {
+  constexpr size_t expected_fields = 2;
+  std::array<std::string_view, expected_fields> tokens;
+  const size_t field_count = split_csv_fields(line, delimiter, tokens);
 
-  if (tokens.size() != expected_fields) {
+  if (field_count != expected_fields) {
     throw std::runtime_error(
         "[from_csv](basic_t) Incorrect number of fields in line " +
         std::to_string(line_number) + ": expected " +
         std::to_string(expected_fields) + ", got " +
-        std::to_string(tokens.size()) + ". Line content: " + line);
+        std::to_string(field_count) + ". Line content: " + std::string(line));
   }
 
   basic_t out;
   size_t idx = 0;
 
   try {
-    out.time = std::stod(tokens[idx++]);
-    out.value = std::stod(tokens[idx++]);
+    out.time = csv_field_to_double(tokens[idx++]);
+    out.value = csv_field_to_double(tokens[idx++]);
   } catch (const std::exception &e) {
     throw std::runtime_error(
         std::string("[from_csv](basic_t) Error parsing tokens in line ") +
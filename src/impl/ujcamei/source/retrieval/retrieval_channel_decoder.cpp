@@ -116,8 +116,22 @@ void append_channel_set(const IntermediaryNode *node, source_spec_t &out) {
 retrieval_channel_decoder_t::retrieval_channel_decoder_t(
     std::string grammar_text)
     : SOURCE_CHANNELS_GRAMMAR_TEXT(std::move(grammar_text)),
-      grammarLexer(SOURCE_CHANNELS_GRAMMAR_TEXT), grammarParser(grammarLexer),
-      grammar(parseGrammarDefinition()), iParser(iLexer, grammar) {
+      grammar(parseGrammarDefinition()),
+      iParser(iLexer, compileGrammarText(SOURCE_CHANNELS_GRAMMAR_TEXT)) {
+#ifdef SOURCE_PIPELINE_DEBUG
+  log_dbg("%s\n", SOURCE_CHANNELS_GRAMMAR_TEXT.c_str());
+#endif
+}
+
+retrieval_channel_decoder_t::retrieval_channel_decoder_t(
+    const std::filesystem::path &grammar_path)
+    : retrieval_channel_decoder_t(readGrammarFileCached(grammar_path)) {}
+
+retrieval_channel_decoder_t::retrieval_channel_decoder_t(
+    CachedGrammarFile grammar_file)
+    : SOURCE_CHANNELS_GRAMMAR_TEXT(std::move(grammar_file.text)),
+      grammar(grammar_file.compiled->grammar),
+      iParser(iLexer, std::move(grammar_file.compiled)) {
 #ifdef SOURCE_PIPELINE_DEBUG
   log_dbg("%s\n", SOURCE_CHANNELS_GRAMMAR_TEXT.c_str());
 #endif
@@ -144,8 +158,8 @@ source_spec_t retrieval_channel_decoder_t::decode(std::string instruction) {
 }
 
 ProductionGrammar retrieval_channel_decoder_t::parseGrammarDefinition() {
-  grammarParser.parseGrammar();
-  return grammarParser.getGrammar();
+  /* compiled once per process per grammar text; see compileGrammarText */
+  return compileGrammarText(SOURCE_CHANNELS_GRAMMAR_TEXT)->grammar;
 }
 
 void retrieval_channel_decoder_t::visit(const RootNode *node,
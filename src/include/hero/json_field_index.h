@@ -0,0 +1,366 @@
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace cuwacunu::hero::json_field_index {
+
+// Flat index over the members of one JSON object text. A single scan records
+// key -> (offset, length, kind) for every member; nested objects are indexed
+// on first request. Lookup semantics match the Hero tool handlers' historical
+// linear scan: the first occurrence of a key wins, and members after a
+// malformed value are not visible.
+
+enum class json_value_kind_t { string, object, array, scalar };
+
+struct json_field_t {
+  std::size_t offset{0};
+  std::size_t length{0};
+  json_value_kind_t kind{json_value_kind_t::scalar};
+};
+
+namespace detail {
+
+inline void skip_ws(std::string_view s, std::size_t *idx) {
+  while (*idx < s.size() &&
+         std::isspace(static_cast<unsigned char>(s[*idx])) != 0) {
+    ++(*idx);
+  }
+}
+
+[[nodiscard]] inline std::string_view trim_ascii(std::string_view in) {
+  std::size_t begin = 0;
+  while (begin < in.size() &&
+         std::isspace(static_cast<unsigned char>(in[begin])) != 0) {
+    ++begin;
+  }
+  std::size_t end = in.size();
+  while (end > begin &&
+         std::isspace(static_cast<unsigned char>(in[end - 1])) != 0) {
+    --end;
+  }
+  return in.substr(begin, end - begin);
+}
+
+// Decodes a JSON string token. `\u` escapes are kept verbatim, as the tool
+// handlers have always done.
+[[nodiscard]] inline bool
+parse_json_string_token(std::string_view s, std::size_t *idx,
+                        std::string *out) {
+  if (*idx >= s.size() || s[*idx] != '"') {
+    return false;
+  }
+  ++(*idx);
+  std::string value;
+  while (*idx < s.size()) {
+    const char c = s[(*idx)++];
+    if (c == '"') {
+      if (out) {
+        *out = std::move(value);
+      }
+      return true;
+    }
+    if (c != '\\') {
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return false;
+      }
+      if (out) {
+        value.push_back(c);
+      }
+      continue;
+    }
+    if (*idx >= s.size()) {
+      return false;
+    }
+    const char escaped = s[(*idx)++];
+    char decoded = 0;
+    switch (escaped) {
+    case '"':
+    case '\\':
+    case '/':
+      decoded = escaped;
+      break;
+    case 'b':
+      decoded = '\b';
+      break;
+    case 'f':
+      decoded = '\f';
+      break;
+    case 'n':
+      decoded = '\n';
+      break;
+    case 'r':
+      decoded = '\r';
+      break;
+    case 't':
+      decoded = '\t';
+      break;
+    case 'u':
+      if (*idx + 4 > s.size()) {
+        return false;
+      }
+      if (out) {
+        value.append("\\u");
+        value.append(s.substr(*idx, 4));
+      }
+      *idx += 4;
+      continue;
+    default:
+      return false;
+    }
+    if (out) {
+      value.push_back(decoded);
+    }
+  }
+  return false;
+}
+
+[[nodiscard]] inline bool skip_json_value(std::string_view s,
+                                          std::size_t *idx) {
+  skip_ws(s, idx);
+  if (*idx >= s.size()) {
+    return false;
+  }
+  if (s[*idx] == '"') {
+    return parse_json_string_token(s, idx, nullptr);
+  }
+  if (s[*idx] == '{' || s[*idx] == '[') {
+    std::string stack;
+    stack.push_back(s[*idx]);
+    ++(*idx);
+    bool in_string = false;
+    bool escape = false;
+    while (*idx < s.size()) {
+      const char c = s[(*idx)++];
+      if (in_string) {
+        if (escape) {
+          escape = false;
+        } else if (c == '\\') {
+          escape = true;
+        } else if (c == '"') {
+          in_string = false;
+        }
+        continue;
+      }
+      if (c == '"') {
+        in_string = true;
+      } else if (c == '{' || c == '[') {
+        stack.push_back(c);
+      } else if (c == '}') {
+        if (stack.empty() || stack.back() != '{') {
+          return false;
+        }
+        stack.pop_back();
+      } else if (c == ']') {
+        if (stack.empty() || stack.back() != '[') {
+          return false;
+        }
+        stack.pop_back();
+      }
+      if (stack.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+  const std::size_t begin = *idx;
+  while (*idx < s.size()) {
+    const char c = s[*idx];
+    if (c == ',' || c == '}' || c == ']' ||
+        std::isspace(static_cast<unsigned char>(c)) != 0) {
+      break;
+    }
+    ++(*idx);
+  }
+  return *idx > begin;
+}
+
+[[nodiscard]] inline json_value_kind_t value_kind(std::string_view raw) {
+  if (raw.empty()) {
+    return json_value_kind_t::scalar;
+  }
+  switch (raw.front()) {
+  case '"':
+    return json_value_kind_t::string;
+  case '{':
+    return json_value_kind_t::object;
+  case '[':
+    return json_value_kind_t::array;
+  default:
+    return json_value_kind_t::scalar;
+  }
+}
+
+} // namespace detail
+
+class json_object_index_t {
+public:
+  json_object_index_t() = default;
+
+  // Indexes the members of `json`. Offsets are relative to `json`; a text
+  // that is not an object yields an empty index.
+  explicit json_object_index_t(std::string_view json) { build_(json); }
+
+  [[nodiscard]] const json_field_t *find(std::string_view key) const {
+    const auto it = fields_.find(std::string(key));
+    return it == fields_.end() ? nullptr : &it->second;
+  }
+
+  [[nodiscard]] std::size_t size() const { return fields_.size(); }
+
+  // Index of the nested object stored under `key`, built on first use. Its
+  // offsets stay relative to the root text, so `json` is always the text the
+  // root index was built from.
+  [[nodiscard]] const json_object_index_t *object(std::string_view json,
+                                                  std::string_view key) const {
+    const auto *field = find(key);
+    if (field == nullptr || field->kind != json_value_kind_t::object) {
+      return nullptr;
+    }
+    auto &child = children_[field->offset];
+    if (!child) {
+      child = std::make_unique<json_object_index_t>(
+          json.substr(field->offset, field->length));
+      child->shift_(field->offset);
+    }
+    return child.get();
+  }
+
+  // Raw member text, trimmed, or false when the key is absent.
+  [[nodiscard]] bool raw_field(std::string_view json, std::string_view key,
+                               std::string_view *out) const {
+    const auto *field = find(key);
+    if (field == nullptr) {
+      return false;
+    }
+    if (out) {
+      *out = json.substr(field->offset, field->length);
+    }
+    return true;
+  }
+
+private:
+  void build_(std::string_view json) {
+    std::size_t idx = 0;
+    detail::skip_ws(json, &idx);
+    if (idx >= json.size() || json[idx] != '{') {
+      return;
+    }
+    ++idx;
+    while (idx < json.size()) {
+      detail::skip_ws(json, &idx);
+      if (idx < json.size() && json[idx] == '}') {
+        return;
+      }
+      std::string key;
+      if (!detail::parse_json_string_token(json, &idx, &key)) {
+        return;
+      }
+      detail::skip_ws(json, &idx);
+      if (idx >= json.size() || json[idx] != ':') {
+        return;
+      }
+      ++idx;
+      detail::skip_ws(json, &idx);
+      const std::size_t value_begin = idx;
+      if (!detail::skip_json_value(json, &idx)) {
+        return;
+      }
+      const auto raw = detail::trim_ascii(
+          json.substr(value_begin, idx - value_begin));
+      fields_.emplace(std::move(key),
+                      json_field_t{
+                          .offset = static_cast<std::size_t>(
+                              raw.data() - json.data()),
+                          .length = raw.size(),
+                          .kind = detail::value_kind(raw),
+                      });
+      detail::skip_ws(json, &idx);
+      if (idx < json.size() && json[idx] == ',') {
+        ++idx;
+        continue;
+      }
+      if (idx < json.size() && json[idx] == '}') {
+        return;
+      }
+    }
+  }
+
+  void shift_(std::size_t base) {
+    for (auto &[key, field] : fields_) {
+      field.offset += base;
+    }
+  }
+
+  std::unordered_map<std::string, json_field_t> fields_{};
+  mutable std::unordered_map<std::size_t,
+                             std::unique_ptr<json_object_index_t>>
+      children_{};
+};
+
+// One JSON object text together with the index of its members. Build it once
+// where a payload enters a handler and pass it to every extractor that reads
+// that payload. The text is owned, so temporaries can be indexed safely.
+// Construction is explicit so that every index build is visible at the call
+// site.
+class json_payload_t {
+public:
+  explicit json_payload_t(const std::string &text)
+      : text_(text), index_(text_) {}
+  explicit json_payload_t(std::string &&text)
+      : text_(std::move(text)), index_(text_) {}
+  explicit json_payload_t(const char *text)
+      : json_payload_t(std::string(text)) {}
+
+  json_payload_t(const json_payload_t &) = delete;
+  json_payload_t &operator=(const json_payload_t &) = delete;
+
+  [[nodiscard]] const std::string &text() const { return text_; }
+  [[nodiscard]] const json_object_index_t &index() const { return index_; }
+
+private:
+  std::string text_{};
+  json_object_index_t index_{};
+};
+
+// Field extractors of the Hero tool handlers.
+[[nodiscard]] inline bool extract_json_raw_field(const json_payload_t &json,
+                                                 std::string_view key,
+                                                 std::string *out) {
+  std::string_view raw;
+  if (!json.index().raw_field(json.text(), key, &raw)) {
+    return false;
+  }
+  if (out) {
+    *out = std::string(raw);
+  }
+  return true;
+}
+
+[[nodiscard]] inline bool extract_json_string_field(const json_payload_t &json,
+                                                    std::string_view key,
+                                                    std::string *out) {
+  const auto *field = json.index().find(key);
+  if (field == nullptr || field->kind != json_value_kind_t::string) {
+    return false;
+  }
+  const auto raw =
+      std::string_view(json.text()).substr(field->offset, field->length);
+  std::size_t idx = 0;
+  std::string value;
+  if (!detail::parse_json_string_token(raw, &idx, &value) ||
+      idx != raw.size()) {
+    return false;
+  }
+  if (out) {
+    *out = std::move(value);
+  }
+  return true;
+}
+
+} // namespace cuwacunu::hero::json_field_index
@@ -28,6 +28,7 @@
 
 #include "hero/config_path_defaults.h"
 #include "hero/lattice_hero/lattice/runtime_report/runtime_lls.h"
+#include "hero/lattice_hero/lattice/runtime_report/runtime_lls_view.h"
 #include "hero/runtime_hero/runtime/job_layout.h"
 #include "kikijyeba/protocol/protocol_variant.h"
 #include "piaabo/parse/simple_kv_block.h"
@@ -4446,20 +4447,38 @@ parse_first_assignment_file(const std::vector<fs::path> &paths) {
   return {};
 }
 
+// Strict read through the mapped view. A validated `.kvidx` sidecar whose
+// digest still matches the file stands in for the strict parse. Lattice scans
+// are read-only over job directories, so this path never writes sidecars;
+// they come from the producer of the file.
 [[nodiscard]] inline std::optional<std::unordered_map<std::string, std::string>>
 parse_runtime_lls_file_if_exists(const fs::path &path) {
-  const auto text = read_text_file_if_exists(path);
-  if (!text.has_value()) {
+  namespace runtime_report = cuwacunu::hero::lattice::runtime_report;
+  std::error_code ec;
+  if (!fs::exists(path, ec)) {
     return std::nullopt;
   }
 
-  cuwacunu::hero::lattice::runtime_report::runtime_lls_document_t document{};
-  std::unordered_map<std::string, std::string> parsed{};
+  runtime_report::runtime_lls_view_options_t options{};
+  options.use_sidecar = true;
+  options.require_validated_sidecar = true;
+  options.verify_sidecar_digest = true;
+  runtime_report::runtime_lls_file_view_t view{};
   std::string parse_error{};
-  if (!cuwacunu::hero::lattice::runtime_report::parse_runtime_lls_text(
-          *text, &document, &parse_error) ||
-      !cuwacunu::hero::lattice::runtime_report::runtime_lls_document_to_kv_map(
-          document, &parsed, &parse_error)) {
+  if (!runtime_report::read_runtime_lls_file_views(path, options, &view,
+                                                   &parse_error)) {
+    return std::unordered_map<std::string, std::string>{};
+  }
+  if (view.loaded_from_sidecar()) {
+    return view.to_kv_map();
+  }
+
+  runtime_report::runtime_lls_document_t document{};
+  std::unordered_map<std::string, std::string> parsed{};
+  if (!runtime_report::parse_runtime_lls_text(view.text(), &document,
+                                              &parse_error) ||
+      !runtime_report::runtime_lls_document_to_kv_map(document, &parsed,
+                                                      &parse_error)) {
     return std::unordered_map<std::string, std::string>{};
   }
   return parsed;
@@ -23340,6 +23359,11 @@ runtime_index_cache_path_is_metadata(const std::filesystem::path &path) {
     }
   }
   const auto filename = path.filename().string();
+  // `.kvidx` sidecars and their temp files are read caches, not facts.
+  if (filename.ends_with(".kvidx") ||
+      filename.find(".kvidx.tmp.") != std::string::npos) {
+    return true;
+  }
   return filename == "lattice_runtime_index.v1.lls";
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <filesystem>
 #include <map>
 #include <mutex>
 #include <string>
@@ -29,15 +30,16 @@ std::map<std::string, std::string> to_map() const;
 class latentLineageStatePipeline {
  public:
   explicit latentLineageStatePipeline(std::string grammar_text);
+  /* reads the grammar file through the on-disk compiled grammar cache */
+  explicit latentLineageStatePipeline(const std::filesystem::path& grammar_path);
   latent_lineage_state_instruction_t decode(std::string instruction);
 
  private:
+  explicit latentLineageStatePipeline(CachedGrammarFile grammar_file);
   ProductionGrammar parseGrammarDefinition();
 
   std::mutex current_mutex_{};
   std::string grammar_text_{};
-  GrammarLexer grammar_lexer_;
-  GrammarParser grammar_parser_;
   ProductionGrammar grammar_;
   InstructionLexer instruction_lexer_;
   InstructionParser instruction_parser_;
@@ -0,0 +1,433 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hero/lattice_hero/lattice/lhs.h"
+#include "piaabo/digest/sha256.h"
+#include "piaabo/io/mapped_file.h"
+
+// Zero-copy reader for persisted runtime `.lls` facts.
+//
+// The fast path accepts exactly what parse_runtime_lls_text_fast_to_kv_map
+// accepts: one `lhs = value` per line, blank and `#` lines skipped, the lhs
+// reduced to its bare key, last occurrence winning. Lines and separators are
+// located with memchr (vectorized in libc) and every key and value is returned
+// as a string_view into the mapped file. Strict canonical validation stays a
+// separate pass: hand text() to validate_runtime_lls_text.
+//
+// An optional `<file>.kvidx` sidecar stores the parsed spans keyed by file
+// size, mtime, inode and SHA-256, so repeat reads of an unchanged file skip
+// the line scan. The key is taken from the descriptor that was mapped, so a
+// file replaced between open and read cannot borrow another file's key. The
+// sidecar is a cache: a stale, torn or unreadable sidecar is ignored, never
+// trusted. Sidecars are only written on request (write_sidecar, or
+// write_validated_sidecar after a strict check); readers never create them.
+
+namespace cuwacunu {
+namespace hero {
+namespace lattice {
+namespace runtime_report {
+
+struct runtime_lls_kv_view_t {
+  std::string_view key{};
+  std::string_view value{};
+};
+
+struct runtime_lls_view_options_t {
+  // Read spans from `<file>.kvidx` when it matches the file.
+  bool use_sidecar{false};
+  // Write or refresh the sidecar after a scan.
+  bool write_sidecar{false};
+  // Also compare the file digest, not only size and mtime, before trusting a
+  // sidecar. Costs one SHA-256 pass over the file.
+  bool verify_sidecar_digest{false};
+  // Trust only sidecars written by write_validated_sidecar(), i.e. for files
+  // the caller already checked with validate_runtime_lls_text.
+  bool require_validated_sidecar{false};
+};
+
+namespace runtime_lls_view_detail {
+
+inline constexpr std::array<char, 8> kSidecarMagic{'C', 'W', 'L', 'L',
+                                                   'S', 'K', 'V', '1'};
+inline constexpr std::uint32_t kSidecarVersion = 3;
+inline constexpr std::uint32_t kSidecarValidated = 1u << 0;
+
+struct sidecar_header_t {
+  std::array<char, 8> magic{kSidecarMagic};
+  std::uint32_t version{kSidecarVersion};
+  std::uint32_t entry_count{0};
+  std::uint64_t file_size{0};
+  std::int64_t mtime_ns{0};
+  std::uint64_t inode{0};
+  std::uint32_t flags{0};
+  std::uint32_t reserved{0};
+  std::array<std::uint8_t, 32> digest{};
+};
+static_assert(sizeof(sidecar_header_t) == 80);
+
+// Offsets are relative to the start of the `.lls` file.
+struct sidecar_span_t {
+  std::uint32_t key_offset{0};
+  std::uint32_t key_length{0};
+  std::uint32_t value_offset{0};
+  std::uint32_t value_length{0};
+};
+
+[[nodiscard]] inline bool is_ascii_space(char c) {
+  return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+[[nodiscard]] inline std::string_view trim_view(std::string_view in) {
+  while (!in.empty() && is_ascii_space(in.front())) {
+    in.remove_prefix(1);
+  }
+  while (!in.empty() && is_ascii_space(in.back())) {
+    in.remove_suffix(1);
+  }
+  return in;
+}
+
+// View counterpart of extract_latent_lineage_state_lhs_key: the key is always
+// a subrange of the lhs, so no copy is needed.
+[[nodiscard]] inline std::string_view lhs_key_view(std::string_view raw_lhs) {
+  const std::string_view lhs = trim_view(raw_lhs);
+  if (lhs.empty()) {
+    return {};
+  }
+  const std::size_t colon = find_top_level_colon(lhs);
+  const std::string_view left =
+      colon == std::string_view::npos ? lhs : trim_view(lhs.substr(0, colon));
+  const std::size_t domain_begin = trailing_domain_begin_index(left);
+  if (domain_begin == std::string_view::npos) {
+    return left;
+  }
+  const std::string_view key = trim_view(left.substr(0, domain_begin));
+  return key.empty() ? left : key;
+}
+
+[[nodiscard]] inline std::filesystem::path
+sidecar_path(const std::filesystem::path &path) {
+  return std::filesystem::path(path.string() + ".kvidx");
+}
+
+// Unique per process and per call, so concurrent writers of the same sidecar
+// never share a temp file; the rename decides which complete copy wins.
+[[nodiscard]] inline std::filesystem::path
+sidecar_tmp_path(const std::filesystem::path &target) {
+  static std::atomic<std::uint64_t> sequence{0};
+  return std::filesystem::path(target.string() + ".tmp." +
+                               std::to_string(::getpid()) + "." +
+                               std::to_string(sequence.fetch_add(1)));
+}
+
+[[nodiscard]] inline std::int64_t mtime_ns(const struct stat &st) {
+  return static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000LL +
+         static_cast<std::int64_t>(st.st_mtim.tv_nsec);
+}
+
+[[nodiscard]] inline std::array<std::uint8_t, 32>
+text_digest(std::string_view text) {
+  cuwacunu::piaabo::digest::sha256_ctx_t ctx;
+  ctx.update(text.data(), text.size());
+  return ctx.final_bytes();
+}
+
+} // namespace runtime_lls_view_detail
+
+// Splits `text` into key/value views. On failure `out` is cleared and `error`
+// carries the same message the map-building fast path reports.
+[[nodiscard]] inline bool
+parse_runtime_lls_text_fast_views(std::string_view text,
+                                  std::vector<runtime_lls_kv_view_t> *out,
+                                  std::string *error) {
+  namespace d = runtime_lls_view_detail;
+  if (error) {
+    error->clear();
+  }
+  const auto fail = [&](const char *message) {
+    if (error) {
+      *error = message;
+    }
+    if (out) {
+      out->clear();
+    }
+    return false;
+  };
+  if (!out) {
+    return fail("runtime .lls kv output pointer is null");
+  }
+  out->clear();
+
+  bool saw_schema = false;
+  const char *cursor = text.data();
+  const char *const end = text.data() + text.size();
+  while (cursor < end) {
+    const auto *newline = static_cast<const char *>(
+        std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+    const char *line_end = newline == nullptr ? end : newline;
+    std::string_view line(cursor,
+                          static_cast<std::size_t>(line_end - cursor));
+    line = d::trim_view(line);
+    if (!line.empty() && line.front() != '#') {
+      const auto *eq = static_cast<const char *>(
+          std::memchr(line.data(), '=', line.size()));
+      if (eq == nullptr || eq == line.data()) {
+        return fail("runtime .lls parse failure: invalid key/value line");
+      }
+      const auto eq_index = static_cast<std::size_t>(eq - line.data());
+      const std::string_view key = d::lhs_key_view(line.substr(0, eq_index));
+      if (key.empty()) {
+        return fail("runtime .lls parse failure: invalid lhs key");
+      }
+      const std::string_view value = d::trim_view(line.substr(eq_index + 1));
+      out->push_back(runtime_lls_kv_view_t{.key = key, .value = value});
+      if (key == "schema" && !value.empty()) {
+        saw_schema = true;
+      }
+    }
+    if (newline == nullptr) {
+      break;
+    }
+    cursor = newline + 1;
+  }
+
+  if (!saw_schema) {
+    return fail("persisted runtime .lls requires top-level schema key");
+  }
+  return true;
+}
+
+class runtime_lls_file_view_t;
+
+[[nodiscard]] inline bool
+read_runtime_lls_file_views(const std::filesystem::path &path,
+                            const runtime_lls_view_options_t &options,
+                            runtime_lls_file_view_t *out, std::string *error);
+
+// A mapped `.lls` file and its key/value views. Views stay valid for the
+// lifetime of the object (and of copies, which share the mapping).
+class runtime_lls_file_view_t {
+public:
+  [[nodiscard]] const std::filesystem::path &path() const { return path_; }
+  [[nodiscard]] std::string_view text() const { return text_; }
+  [[nodiscard]] const std::vector<runtime_lls_kv_view_t> &entries() const {
+    return entries_;
+  }
+  // True when the entries came from a matching sidecar.
+  [[nodiscard]] bool loaded_from_sidecar() const {
+    return loaded_from_sidecar_;
+  }
+
+  // Value of the last entry with `key`, or nullptr.
+  [[nodiscard]] const std::string_view *find(std::string_view key) const {
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+      if (it->key == key) {
+        return &it->value;
+      }
+    }
+    return nullptr;
+  }
+
+  // Owning copy, identical to parse_runtime_lls_text_fast_to_kv_map.
+  [[nodiscard]] std::unordered_map<std::string, std::string> to_kv_map() const {
+    std::unordered_map<std::string, std::string> out;
+    out.reserve(entries_.size());
+    for (const auto &entry : entries_) {
+      out[std::string(entry.key)] = std::string(entry.value);
+    }
+    return out;
+  }
+
+  // Writes a sidecar marked validated. Call only after the text passed
+  // validate_runtime_lls_text; best effort like the unvalidated write.
+  void write_validated_sidecar() const {
+    write_sidecar_(runtime_lls_view_detail::kSidecarValidated);
+  }
+
+  friend bool read_runtime_lls_file_views(const std::filesystem::path &,
+                                          const runtime_lls_view_options_t &,
+                                          runtime_lls_file_view_t *,
+                                          std::string *);
+
+private:
+  bool load_sidecar_(const runtime_lls_view_options_t &options) {
+    namespace d = runtime_lls_view_detail;
+    std::ifstream in(d::sidecar_path(path_), std::ios::binary);
+    if (!in) {
+      return false;
+    }
+    d::sidecar_header_t header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != d::kSidecarMagic ||
+        header.version != d::kSidecarVersion ||
+        header.file_size != file_size_ || header.mtime_ns != mtime_ns_ ||
+        header.inode != inode_ || header.file_size != text_.size()) {
+      return false;
+    }
+    if (options.require_validated_sidecar &&
+        (header.flags & d::kSidecarValidated) == 0) {
+      return false;
+    }
+    if (options.verify_sidecar_digest &&
+        header.digest != d::text_digest(text_)) {
+      return false;
+    }
+    std::vector<d::sidecar_span_t> spans(header.entry_count);
+    if (!in.read(reinterpret_cast<char *>(spans.data()),
+                 static_cast<std::streamsize>(spans.size() *
+                                              sizeof(d::sidecar_span_t)))) {
+      return false;
+    }
+    std::vector<runtime_lls_kv_view_t> entries;
+    entries.reserve(spans.size());
+    for (const auto &span : spans) {
+      const std::uint64_t size = text_.size();
+      if (span.key_length == 0 || span.key_offset > size ||
+          span.key_length > size - span.key_offset ||
+          span.value_offset > size ||
+          span.value_length > size - span.value_offset) {
+        return false;
+      }
+      entries.push_back(runtime_lls_kv_view_t{
+          .key = text_.substr(span.key_offset, span.key_length),
+          .value = text_.substr(span.value_offset, span.value_length),
+      });
+    }
+    entries_ = std::move(entries);
+    return true;
+  }
+
+  // Best effort: a failed write only costs the next reader a scan.
+  void write_sidecar_(std::uint32_t flags) const {
+    namespace d = runtime_lls_view_detail;
+    if (text_.size() > UINT32_MAX) {
+      return;
+    }
+    d::sidecar_header_t header{};
+    header.entry_count = static_cast<std::uint32_t>(entries_.size());
+    header.file_size = file_size_;
+    header.mtime_ns = mtime_ns_;
+    header.inode = inode_;
+    header.flags = flags;
+    header.digest = d::text_digest(text_);
+    std::vector<d::sidecar_span_t> spans;
+    spans.reserve(entries_.size());
+    for (const auto &entry : entries_) {
+      spans.push_back(d::sidecar_span_t{
+          .key_offset = static_cast<std::uint32_t>(entry.key.data() -
+                                                   text_.data()),
+          .key_length = static_cast<std::uint32_t>(entry.key.size()),
+          .value_offset = static_cast<std::uint32_t>(entry.value.data() -
+                                                     text_.data()),
+          .value_length = static_cast<std::uint32_t>(entry.value.size()),
+      });
+    }
+    const auto target = d::sidecar_path(path_);
+    const auto tmp = d::sidecar_tmp_path(target);
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      if (!out) {
+        return;
+      }
+      out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char *>(spans.data()),
+                static_cast<std::streamsize>(spans.size() *
+                                             sizeof(d::sidecar_span_t)));
+      out.flush();
+      if (!out) {
+        std::error_code ignored;
+        std::filesystem::remove(tmp, ignored);
+        return;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, target, ec);
+    if (ec) {
+      std::filesystem::remove(tmp, ec);
+    }
+  }
+
+  std::filesystem::path path_{};
+  std::shared_ptr<cuwacunu::piaabo::io::mapped_file_t> file_{};
+  std::string_view text_{};
+  std::uint64_t file_size_{0};
+  std::int64_t mtime_ns_{0};
+  std::uint64_t inode_{0};
+  std::vector<runtime_lls_kv_view_t> entries_{};
+  bool loaded_from_sidecar_{false};
+};
+
+// Maps `path` and fills `out` with its key/value views. Returns false with
+// `error` set when the file cannot be read or fails the fast parse.
+inline bool
+read_runtime_lls_file_views(const std::filesystem::path &path,
+                            const runtime_lls_view_options_t &options,
+                            runtime_lls_file_view_t *out, std::string *error) {
+  namespace d = runtime_lls_view_detail;
+  if (error) {
+    error->clear();
+  }
+  if (!out) {
+    if (error) {
+      *error = "runtime .lls view output pointer is null";
+    }
+    return false;
+  }
+  *out = runtime_lls_file_view_t{};
+  out->path_ = path;
+
+  try {
+    out->file_ = std::make_shared<cuwacunu::piaabo::io::mapped_file_t>(
+        path, /*allow_empty=*/true);
+  } catch (const std::exception &e) {
+    if (error) {
+      *error = "runtime .lls file is not readable: " + path.string() + ": " +
+               e.what();
+    }
+    return false;
+  }
+  const auto &st = out->file_->file_stat();
+  out->file_size_ = static_cast<std::uint64_t>(st.st_size);
+  out->mtime_ns_ = d::mtime_ns(st);
+  out->inode_ = static_cast<std::uint64_t>(st.st_ino);
+  if (out->file_->size() != 0) {
+    out->text_ = std::string_view(
+        reinterpret_cast<const char *>(out->file_->data()),
+        out->file_->size());
+  }
+
+  if (options.use_sidecar && out->load_sidecar_(options)) {
+    out->loaded_from_sidecar_ = true;
+    return true;
+  }
+  if (!parse_runtime_lls_text_fast_views(out->text_, &out->entries_, error)) {
+    return false;
+  }
+  if (options.write_sidecar) {
+    out->write_sidecar_(0);
+  }
+  return true;
+}
+
+} // namespace runtime_report
+} // namespace lattice
+} // namespace hero
+} // namespace cuwacunu
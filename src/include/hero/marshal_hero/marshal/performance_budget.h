@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "hero/marshal_hero/marshal/dispatch_receipt.h"
+#include "piaabo/bench/microbenchmark.h"
 
 namespace cuwacunu::hero::marshal {
 
@@ -22,9 +23,19 @@ struct marshal_performance_stage_t {
   double max_ms{0.0};
   double p50_ms{0.0};
   double p95_ms{0.0};
+  double p99_ms{0.0};
+  std::size_t warmup_count{0};
+  double cpu_p50_ms{0.0};
   bool passed{false};
 };
 
+// Repeated sampling for measure_stage: `warmup` untimed runs, then `samples`
+// timed runs. The stage passes when its p95 wall time fits the budget.
+struct marshal_stage_sampling_t {
+  std::size_t warmup{0};
+  std::size_t samples{1};
+};
+
 struct marshal_performance_report_t {
   std::vector<marshal_performance_stage_t> stages{};
   std::string non_authority_statement{
@@ -40,61 +51,49 @@ struct marshal_performance_report_t {
   }
 };
 
+template <typename Fn>
+[[nodiscard]] inline marshal_performance_stage_t
+measure_stage(const std::string &name, const std::string &layer,
+              double budget_ms, const marshal_stage_sampling_t &sampling,
+              Fn &&fn) {
+  const auto result = cuwacunu::piaabo::bench::run_microbench(
+      name,
+      cuwacunu::piaabo::bench::microbench_options_t{
+          .warmup = sampling.warmup, .repetitions = sampling.samples},
+      fn);
+  constexpr double ns_per_ms = 1e6;
+  const auto &wall = result.wall_ns;
+  return marshal_performance_stage_t{
+      .name = name,
+      .layer = layer,
+      .elapsed_ms = wall.mean / ns_per_ms,
+      .budget_ms = budget_ms,
+      .sample_count = result.repetitions,
+      .min_ms = wall.min / ns_per_ms,
+      .max_ms = wall.max / ns_per_ms,
+      .p50_ms = wall.p50 / ns_per_ms,
+      .p95_ms = wall.p95 / ns_per_ms,
+      .p99_ms = wall.p99 / ns_per_ms,
+      .warmup_count = result.warmup,
+      .cpu_p50_ms = result.cpu_ns.p50 / ns_per_ms,
+      .passed = wall.p95 / ns_per_ms <= budget_ms};
+}
+
 template <typename Fn>
 [[nodiscard]] inline marshal_performance_stage_t
 measure_stage(const std::string &name, const std::string &layer,
               double budget_ms, Fn &&fn) {
-  const auto begin = std::chrono::steady_clock::now();
-  std::forward<Fn>(fn)();
-  const auto end = std::chrono::steady_clock::now();
-  const double elapsed_ms =
-      std::chrono::duration<double, std::milli>(end - begin).count();
-  return marshal_performance_stage_t{.name = name,
-                                     .layer = layer,
-                                     .elapsed_ms = elapsed_ms,
-                                     .budget_ms = budget_ms,
-                                     .sample_count = 1,
-                                     .min_ms = elapsed_ms,
-                                     .max_ms = elapsed_ms,
-                                     .p50_ms = elapsed_ms,
-                                     .p95_ms = elapsed_ms,
-                                     .passed = elapsed_ms <= budget_ms};
+  return measure_stage(name, layer, budget_ms, marshal_stage_sampling_t{},
+                       std::forward<Fn>(fn));
 }
 
 template <typename Fn>
 [[nodiscard]] inline marshal_performance_stage_t
 measure_stage_repeated(const std::string &name, const std::string &layer,
                        double budget_ms, std::size_t sample_count, Fn &&fn) {
-  if (sample_count == 0U) {
-    sample_count = 1U;
-  }
-  std::vector<double> samples;
-  samples.reserve(sample_count);
-  for (std::size_t i = 0; i < sample_count; ++i) {
-    const auto stage = measure_stage(name, layer, budget_ms, fn);
-    samples.push_back(stage.elapsed_ms);
-  }
-  std::sort(samples.begin(), samples.end());
-  double sum = 0.0;
-  for (const auto sample : samples) {
-    sum += sample;
-  }
-  const auto percentile_at = [&](double percentile) {
-    const double scaled = percentile * static_cast<double>(samples.size() - 1U);
-    return samples[static_cast<std::size_t>(scaled + 0.5)];
-  };
-  const double mean = sum / static_cast<double>(samples.size());
-  const double p95 = percentile_at(0.95);
-  return marshal_performance_stage_t{.name = name,
-                                     .layer = layer,
-                                     .elapsed_ms = mean,
-                                     .budget_ms = budget_ms,
-                                     .sample_count = samples.size(),
-                                     .min_ms = samples.front(),
-                                     .max_ms = samples.back(),
-                                     .p50_ms = percentile_at(0.50),
-                                     .p95_ms = p95,
-                                     .passed = p95 <= budget_ms};
+  return measure_stage(name, layer, budget_ms,
+                       marshal_stage_sampling_t{.samples = sample_count},
+                       std::forward<Fn>(fn));
 }
 
 inline void add_stage(marshal_performance_report_t *report,
@@ -125,6 +124,11 @@ canonical_performance_report_text(const marshal_performance_report_t &report) {
     detail::append_kv(out, prefix + ".max_ms", std::to_string(stage.max_ms));
     detail::append_kv(out, prefix + ".p50_ms", std::to_string(stage.p50_ms));
     detail::append_kv(out, prefix + ".p95_ms", std::to_string(stage.p95_ms));
+    detail::append_kv(out, prefix + ".p99_ms", std::to_string(stage.p99_ms));
+    detail::append_kv(out, prefix + ".warmup_count",
+                      std::to_string(stage.warmup_count));
+    detail::append_kv(out, prefix + ".cpu_p50_ms",
+                      std::to_string(stage.cpu_p50_ms));
     detail::append_kv(out, prefix + ".passed", detail::bool_text(stage.passed));
   }
   return out.str();
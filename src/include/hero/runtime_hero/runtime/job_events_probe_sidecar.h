@@ -9,6 +9,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -17,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "hero/runtime_hero/runtime/job_events_probe_writer.h"
 #include "hero/runtime_hero/runtime/job_layout.h"
 #include "hero/runtime_hero/runtime/job_manifest.h"
 #include "hero/runtime_hero/runtime/job_state.h"
@@ -70,6 +72,8 @@ struct job_events_probe_write_summary_t {
   std::int64_t record_count{0};
   std::string error{};
   job_events_probe_stream_config_t config{};
+  // Open stream shared by copies of the summary; created on the first record.
+  std::shared_ptr<probe_stream_writer_t> writer{};
 };
 
 [[nodiscard]] inline std::filesystem::path
@@ -182,23 +186,6 @@ serialize_record(const job_manifest_t &manifest,
   return out.str();
 }
 
-inline void append_record_file(const std::filesystem::path &path,
-                               const std::string &text) {
-  if (!path.parent_path().empty()) {
-    std::filesystem::create_directories(path.parent_path());
-  }
-  std::ofstream out(path, std::ios::app | std::ios::binary);
-  if (!out) {
-    throw std::runtime_error(
-        "[runtime_job_events_probe] failed to open stream: " + path.string());
-  }
-  out << text;
-  if (!out) {
-    throw std::runtime_error(
-        "[runtime_job_events_probe] failed to write stream: " + path.string());
-  }
-}
-
 [[nodiscard]] inline job_events_probe_write_summary_t
 make_write_summary(bool enabled, const std::filesystem::path &job_dir,
                    job_events_probe_stream_config_t config =
@@ -222,11 +209,14 @@ inline void append_record(const job_manifest_t &manifest,
     if (summary->stream_path.empty()) {
       throw std::runtime_error("probe stream path is empty");
     }
+    if (!summary->writer) {
+      summary->writer =
+          std::make_shared<probe_stream_writer_t>(summary->stream_path);
+    }
     const auto sequence = summary->record_count + 1;
-    append_record_file(summary->stream_path,
-                       serialize_record(manifest, event, sequence,
-                                        current_unix_ms_text(),
-                                        summary->config));
+    summary->writer->append(serialize_record(manifest, event, sequence,
+                                             current_unix_ms_text(),
+                                             summary->config));
     summary->written = true;
     summary->record_count = sequence;
   } catch (const std::exception &ex) {
@@ -234,6 +224,19 @@ inline void append_record(const job_manifest_t &manifest,
   }
 }
 
+// Writes the buffered records out; job state transitions call this so the
+// stream is current whenever the job state changes.
+inline void flush_records(job_events_probe_write_summary_t *summary) {
+  if (summary == nullptr || !summary->writer || !summary->error.empty()) {
+    return;
+  }
+  try {
+    summary->writer->flush();
+  } catch (const std::exception &ex) {
+    summary->error = ex.what();
+  }
+}
+
 inline void
 apply_summary_to_state(const job_events_probe_write_summary_t &summary,
                        job_state_t *state) {
@@ -259,6 +262,7 @@ inline void write_job_started_event(const job_manifest_t &manifest,
   event.phase = "started";
   event.status = "started";
   append_record(manifest, summary, std::move(event));
+  flush_records(summary);
 }
 
 inline void write_job_progress_event(const job_manifest_t &manifest,
@@ -274,6 +278,7 @@ inline void write_job_progress_event(const job_manifest_t &manifest,
   event.status = std::move(status);
   event.message = std::move(message);
   append_record(manifest, summary, std::move(event));
+  flush_records(summary);
 }
 
 inline void append_scalar_metric(
@@ -1042,6 +1047,7 @@ inline void write_job_final_events(const std::filesystem::path &job_dir,
                             state.lattice_fact_error);
   append_warning_if_present(manifest, summary, "replay_artifact",
                             state.replay_artifact_error);
+  flush_records(summary);
 }
 
 } // namespace cuwacunu::hero::runtime::job_events_probe
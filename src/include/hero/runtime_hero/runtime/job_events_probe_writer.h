@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace cuwacunu::hero::runtime::job_events_probe {
+
+inline constexpr std::size_t k_job_events_probe_flush_bytes =
+    std::size_t{64} << 10U;
+inline constexpr std::chrono::milliseconds k_job_events_probe_flush_interval{
+    1000};
+
+// Append-only writer for one job's probe stream. The file is opened once and
+// kept open; records collect in a userspace buffer that is written when it
+// passes `flush_bytes`, once it has waited `flush_interval` since the last
+// write, on flush(), and on destruction. The interval is enforced by a timer
+// thread started with the first buffered record, so a quiet job still
+// publishes its tail. The buffer only ever holds whole records and each flush
+// is one append, so a crash loses the buffered tail but never leaves half a
+// record; a failed or short append is truncated back to the last record
+// boundary. A timer flush failure is rethrown by the next append().
+class probe_stream_writer_t {
+public:
+  explicit probe_stream_writer_t(
+      std::filesystem::path path,
+      std::size_t flush_bytes = k_job_events_probe_flush_bytes,
+      std::chrono::milliseconds flush_interval =
+          k_job_events_probe_flush_interval)
+      : path_(std::move(path)), flush_bytes_(flush_bytes),
+        flush_interval_(flush_interval),
+        last_flush_(std::chrono::steady_clock::now()) {}
+
+  probe_stream_writer_t(const probe_stream_writer_t &) = delete;
+  probe_stream_writer_t &operator=(const probe_stream_writer_t &) = delete;
+
+  ~probe_stream_writer_t() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    if (timer_.joinable()) {
+      timer_.join();
+    }
+    try {
+      flush();
+    } catch (...) {
+      // The owner reads errors from flush(); destruction stays quiet.
+    }
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+  }
+
+  [[nodiscard]] const std::filesystem::path &path() const { return path_; }
+  [[nodiscard]] std::size_t buffered_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffer_.size();
+  }
+
+  // Buffers one serialized record (a whole record, blank-line terminated).
+  void append(std::string_view record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!timer_error_.empty()) {
+      std::string error;
+      error.swap(timer_error_);
+      throw std::runtime_error(error);
+    }
+    const bool was_empty = buffer_.empty();
+    buffer_.append(record);
+    if (buffer_.size() >= flush_bytes_ ||
+        std::chrono::steady_clock::now() - last_flush_ >= flush_interval_) {
+      flush_locked_();
+      return;
+    }
+    if (!timer_.joinable()) {
+      timer_ = std::thread([this] { run_timer_(); });
+    } else if (was_empty) {
+      wake_.notify_one();
+    }
+  }
+
+  // Writes every buffered record; throws with the stream path on failure and
+  // keeps the records buffered so a later flush can retry.
+  void flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timer_error_.clear();
+    flush_locked_();
+  }
+
+private:
+  void flush_locked_() {
+    last_flush_ = std::chrono::steady_clock::now();
+    if (buffer_.empty()) {
+      return;
+    }
+    open_();
+    struct stat st {};
+    if (::fstat(fd_, &st) == -1) {
+      fail_("failed to stat stream");
+    }
+    const auto boundary = st.st_size;
+    std::size_t written = 0;
+    while (written < buffer_.size()) {
+      const ssize_t n =
+          ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        const int saved_errno = errno;
+        if (written > 0) {
+          (void)::ftruncate(fd_, boundary);
+        }
+        errno = saved_errno;
+        fail_("failed to write stream");
+      }
+      written += static_cast<std::size_t>(n);
+    }
+    buffer_.clear();
+  }
+
+  // Flushes a non-empty buffer `flush_interval_` after the last write. Sleeps
+  // until a record arrives when the buffer is empty.
+  void run_timer_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      if (buffer_.empty()) {
+        wake_.wait(lock, [this] { return stopping_ || !buffer_.empty(); });
+        continue;
+      }
+      if (wake_.wait_until(lock, last_flush_ + flush_interval_,
+                           [this] { return stopping_; })) {
+        break;
+      }
+      if (!buffer_.empty() &&
+          std::chrono::steady_clock::now() - last_flush_ >= flush_interval_) {
+        try {
+          flush_locked_();
+        } catch (const std::exception &ex) {
+          timer_error_ = ex.what();
+        }
+      }
+    }
+  }
+
+  void open_() {
+    if (fd_ != -1) {
+      return;
+    }
+    if (!path_.parent_path().empty()) {
+      std::filesystem::create_directories(path_.parent_path());
+    }
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                 0644);
+    if (fd_ == -1) {
+      fail_("failed to open stream");
+    }
+  }
+
+  [[noreturn]] void fail_(const char *what) const {
+    throw std::runtime_error(std::string("[runtime_job_events_probe] ") +
+                             what + ": " + path_.string() + " (" +
+                             std::strerror(errno) + ")");
+  }
+
+  std::filesystem::path path_{};
+  std::size_t flush_bytes_{k_job_events_probe_flush_bytes};
+  std::chrono::milliseconds flush_interval_{k_job_events_probe_flush_interval};
+  std::chrono::steady_clock::time_point last_flush_{};
+  std::string buffer_{};
+  int fd_{-1};
+  mutable std::mutex mutex_{};
+  std::condition_variable wake_{};
+  std::thread timer_{};
+  bool stopping_{false};
+  std::string timer_error_{};
+};
+
+} // namespace cuwacunu::hero::runtime::job_events_probe
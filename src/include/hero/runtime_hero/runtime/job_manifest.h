@@ -139,6 +139,11 @@ struct job_manifest_t {
   std::string probe_record_schema{
       "kikijyeba.runtime.job_events.probe_record.v1"};
   std::string probe_stream_leaf{"runtime.job_events.probe"};
+  std::string compute_role{};
+  std::int64_t compute_intra_op_threads{0};
+  std::int64_t compute_inter_op_threads{0};
+  std::uint64_t compute_cores_per_job{0};
+  bool compute_inference_mode{false};
   std::string policy_training_contract_schema{};
   std::string policy_training_contract_digest{};
   std::string policy_training_artifact_schema{};
@@ -288,6 +293,12 @@ struct job_manifest_t {
         << (probe_sidecar_enabled ? "true" : "false") << "\n";
     out << "probe_record_schema=" << probe_record_schema << "\n";
     out << "probe_stream_leaf=" << probe_stream_leaf << "\n";
+    out << "compute_role=" << compute_role << "\n";
+    out << "compute_intra_op_threads=" << compute_intra_op_threads << "\n";
+    out << "compute_inter_op_threads=" << compute_inter_op_threads << "\n";
+    out << "compute_cores_per_job=" << compute_cores_per_job << "\n";
+    out << "compute_inference_mode="
+        << (compute_inference_mode ? "true" : "false") << "\n";
     out << "policy_training_contract_schema=" << policy_training_contract_schema
         << "\n";
     out << "policy_training_contract_digest=" << policy_training_contract_digest
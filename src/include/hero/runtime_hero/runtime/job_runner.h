@@ -32,6 +32,7 @@
 #include "kikijyeba/protocol/config_bundle.h"
 #include "kikijyeba/protocol/config_provenance.h"
 #include "kikijyeba/protocol/pipeline_builder.h"
+#include "piaabo/bench/trace_span.h"
 
 namespace cuwacunu::hero::runtime {
 
@@ -46,6 +47,8 @@ struct job_runner_options_t {
   bool write_report{true};
   bool write_probe_records{false};
   bool write_replay_artifacts{true};
+  // Records piaabo trace spans for the whole job into job.trace.json.
+  bool write_trace_spans{false};
   bool replay_require_direct_accounting_numeraire_valuation_edges{true};
   std::size_t batch_size{0};
   std::string job_id{};
@@ -56,6 +59,7 @@ struct job_runner_options_t {
   std::string marshal_target_driver_run_id{};
   std::string input_representation_checkpoint_path{};
   std::string input_mdn_checkpoint_path{};
+  std::string vicreg_loss_impl_override{};
   bool source_range_override_enabled{false};
   std::string source_range_override{};
   std::optional<std::size_t> anchor_index_begin_override{std::nullopt};
@@ -128,6 +132,11 @@ state_path_for_job_dir(const std::filesystem::path &job_dir) {
   return job_dir / "job.state";
 }
 
+[[nodiscard]] inline std::filesystem::path
+trace_path_for_job_dir(const std::filesystem::path &job_dir) {
+  return job_dir / "job.trace.json";
+}
+
 [[nodiscard]] inline std::filesystem::path
 delegated_report_path_for_job(const std::filesystem::path &job_dir,
                               runtime_job_kind_t kind) {
@@ -176,6 +185,7 @@ job_dir_has_runtime_artifacts(const std::filesystem::path &job_dir) {
       job_dir / "runtime.result.fact",
       job_dir / "runtime.checkpoint_io.fact",
       job_dir / "runtime.health_measurement.fact",
+      trace_path_for_job_dir(job_dir),
   };
   for (const auto &artifact : artifacts) {
     if (std::filesystem::exists(artifact, ec) && !ec) {
@@ -562,6 +572,11 @@ inline void apply_model_state_input_overrides(
             .lexically_normal()
             .string();
   }
+  if (!options.vicreg_loss_impl_override.empty()) {
+    bundle->vicreg.vicreg_loss_impl =
+        cuwacunu::wikimyei::representation::encoding::vicreg::
+            parse_vicreg_loss_impl(options.vicreg_loss_impl_override);
+  }
 }
 
 inline void write_lattice_fact_sidecars(const std::filesystem::path &job_dir,
@@ -755,10 +770,9 @@ public:
           options_.job_dir.string());
     }
 
-    const auto wave_settings =
-        cuwacunu::kikijyeba::protocol::load_wave_settings_from_config(
+    auto effective_wave_settings =
+        *cuwacunu::kikijyeba::protocol::load_wave_settings_cached(
             config_path_);
-    auto effective_wave_settings = wave_settings;
     job_runner_detail::apply_source_range_override(&effective_wave_settings,
                                                    options_);
     const auto resolved_job_kind =
@@ -784,8 +798,8 @@ public:
 private:
   [[nodiscard]] job_run_result_t
   run_channel_graph_first(runtime_job_kind_t resolved_job_kind) const {
-    auto bundle = cuwacunu::kikijyeba::protocol::
-        load_channel_graph_first_protocol_contract_from_config(config_path_);
+    auto bundle = *cuwacunu::kikijyeba::protocol::
+        load_channel_graph_first_protocol_contract_cached(config_path_);
     job_runner_detail::apply_source_range_override(&bundle.wave_settings,
                                                    options_);
     job_runner_detail::apply_model_state_input_overrides(&bundle, options_);
@@ -830,6 +844,21 @@ private:
     manifest.probe_sidecar_enabled = probe_records_requested;
     manifest.probe_record_schema = probe_stream_config.record_schema;
     manifest.probe_stream_leaf = probe_stream_config.stream_leaf;
+    namespace compute = cuwacunu::piaabo::tensor::torch;
+    const auto compute_profile =
+        cuwacunu::kikijyeba::protocol::load_compute_profile_from_config(
+            config_path_);
+    const auto compute_role = train_target
+                                  ? compute::compute_role_t::train
+                                  : compute::compute_role_t::evaluation;
+    const auto &compute_budget = compute_profile.budget(compute_role);
+    manifest.compute_role = compute::compute_role_name(compute_role);
+    manifest.compute_intra_op_threads = compute_budget.intra_op_threads;
+    manifest.compute_inter_op_threads = compute_budget.inter_op_threads;
+    manifest.compute_cores_per_job =
+        compute::compute_cores_per_job(compute_budget);
+    manifest.compute_inference_mode =
+        compute_profile.uses_inference_mode(compute_role);
     const auto runtime_root =
         options_.job_dir.empty()
             ? job_runner_detail::default_job_root_for_config(config_path_)
@@ -854,6 +883,10 @@ private:
       job_runner_detail::prepare_explicit_job_dir(job_dir, &manifest);
     }
     job_runner_detail::ensure_job_dir(job_dir);
+    cuwacunu::piaabo::bench::trace::trace_session_t trace_session(
+        job_runner_detail::trace_path_for_job_dir(job_dir),
+        options_.write_trace_spans);
+    PIAABO_TRACE_SPAN("hero", "runtime_job.run");
     job_runner_detail::populate_manifest_config_provenance(runtime_root,
                                                            job_dir, &manifest);
     job_layout::write_component_spawn_ref(
@@ -887,12 +920,20 @@ private:
       job_events_probe::write_job_progress_event(
           manifest, &probe_summary, "delegate_start", "running",
           runtime_job_kind_name(resolved_job_kind));
-      result.state = run_channel_delegate(
-          std::move(builder), manifest, wave_plan, result.delegated_report_path,
-          job_dir, resolved_job_kind, train_target, &probe_summary);
+      {
+        PIAABO_TRACE_SPAN("hero", "runtime_job.delegate");
+        // Non-train jobs (evaluation and forecast-artifact export) run the
+        // whole delegate under InferenceMode.
+        compute::compute_scope_t compute_scope(compute_profile, compute_role);
+        result.state = run_channel_delegate(
+            std::move(builder), manifest, wave_plan,
+            result.delegated_report_path, job_dir, resolved_job_kind,
+            train_target, &probe_summary);
+      }
       job_events_probe::write_job_progress_event(
           manifest, &probe_summary, "delegate_complete", "completed",
           runtime_job_kind_name(resolved_job_kind));
+      PIAABO_TRACE_SPAN("hero", "runtime_job.finalize");
       write_job_state_file(result.state_path, result.state);
       terminal_facts::write_terminal_fact_sidecars(job_dir, manifest,
                                                    &result.state);
@@ -986,6 +1027,10 @@ private:
       launcher_options.write_report = options_.write_report;
       launcher_options.report_path = delegated_report_path;
       launcher_options.runtime_report_mode = options_.runtime_report_mode;
+      launcher_options.representation_embedding_cache_root =
+          job_layout::cache_dir(
+              job_runner_detail::runtime_root_for_job_dir(job_dir)) /
+          "representation_embeddings";
       if (probe_summary != nullptr && probe_summary->enabled &&
           probe_summary->config.emit_report_metrics) {
         launcher_options.learning_probe_report_sink =
@@ -7,26 +7,58 @@
 #include <array>
 #include <cctype>
 #include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
-#include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(__has_include)
+#if __has_include(<zlib.h>)
+#define IINUJI_HAS_SYSTEM_ZLIB 1
+#endif
+#endif
+#ifndef IINUJI_HAS_SYSTEM_ZLIB
+#define IINUJI_HAS_SYSTEM_ZLIB 0
+#endif
+
+#if IINUJI_HAS_SYSTEM_ZLIB
+#include <zlib.h>
+#endif
+
 namespace cuwacunu::iinuji::html {
 
 inline constexpr std::size_t kMaximumHttpRequestHeaderBytes = 8U * 1024U;
+// Unparsed bytes a connection may buffer (pipelined requests) before the
+// server stops reading from it.
+inline constexpr std::size_t kMaximumPendingHttpInputBytes =
+    4U * kMaximumHttpRequestHeaderBytes;
+// Smaller bodies are sent uncompressed.
+inline constexpr std::size_t kMinimumCompressedBodyBytes = 1024U;
 
 enum class http_method_e { get, head };
 
@@ -44,8 +76,12 @@ struct http_response_t {
   std::string content_type{"text/plain; charset=utf-8"};
   std::string body;
   std::vector<std::pair<std::string, std::string>> extra_headers;
+  // Quoted strong validator for cached documents; empty otherwise.
+  std::string etag{};
 };
 
+enum class http_content_coding_e { identity, gzip, deflate };
+
 class http_request_error : public std::runtime_error {
 public:
   http_request_error(int status, std::string reason, std::string message,
@@ -170,55 +206,207 @@ private:
   int descriptor_;
 };
 
-[[nodiscard]] inline std::string receive_request_header(int client) {
-  std::string request;
-  request.reserve(2048U);
-  std::array<char, 2048> buffer{};
-  while (request.find("\r\n\r\n") == std::string::npos) {
-    const auto received = ::recv(client, buffer.data(), buffer.size(), 0);
-    if (received == 0) {
+[[nodiscard]] inline bool set_nonblocking(int descriptor) {
+  const int flags = ::fcntl(descriptor, F_GETFL, 0);
+  return flags >= 0 && ::fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Calls `visit(element)` for each trimmed, non-empty element of a
+// comma-separated header value.
+template <typename Visit>
+inline void for_each_header_element(std::string_view value, Visit &&visit) {
+  while (!value.empty()) {
+    const auto comma = value.find(',');
+    const auto element = trim_http_value(value.substr(0U, comma));
+    if (!element.empty()) {
+      visit(std::string_view(element));
+    }
+    if (comma == std::string_view::npos) {
       break;
     }
-    if (received < 0) {
-      if (errno == EINTR) {
-        continue;
-      }
-      if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        throw http_request_error(408, "Request Timeout",
-                                 "request header timed out");
+    value.remove_prefix(comma + 1U);
+  }
+}
+
+[[nodiscard]] inline bool header_has_token(const http_request_t &request,
+                                           std::string_view name,
+                                           std::string_view token) {
+  const auto found = request.headers.find(std::string(name));
+  if (found == request.headers.end()) {
+    return false;
+  }
+  bool present = false;
+  for_each_header_element(found->second, [&](std::string_view element) {
+    present = present || lowercase_ascii(element) == token;
+  });
+  return present;
+}
+
+// HTTP/1.1 connections persist unless the client says close; HTTP/1.0 ones
+// only when the client asks for keep-alive.
+[[nodiscard]] inline bool wants_keep_alive(const http_request_t &request) {
+  if (header_has_token(request, "connection", "close")) {
+    return false;
+  }
+  return request.version == "HTTP/1.1" ||
+         header_has_token(request, "connection", "keep-alive");
+}
+
+[[nodiscard]] inline bool compressible_content_type(std::string_view type) {
+  return type.starts_with("application/json") ||
+         type.starts_with("image/svg+xml");
+}
+
+// Picks the coding for a response from Accept-Encoding. Only gzip and
+// deflate are offered; "*" covers whichever is not listed and q=0 refuses.
+[[nodiscard]] inline http_content_coding_e
+negotiate_content_coding(const http_request_t &request) {
+  if (!IINUJI_HAS_SYSTEM_ZLIB) {
+    return http_content_coding_e::identity;
+  }
+  const auto found = request.headers.find("accept-encoding");
+  if (found == request.headers.end()) {
+    return http_content_coding_e::identity;
+  }
+  double gzip_q = -1.0;
+  double deflate_q = -1.0;
+  double star_q = -1.0;
+  for_each_header_element(found->second, [&](std::string_view element) {
+    const auto semicolon = element.find(';');
+    const auto coding =
+        lowercase_ascii(trim_http_value(element.substr(0U, semicolon)));
+    double q = 1.0;
+    if (semicolon != std::string_view::npos) {
+      const auto parameter =
+          lowercase_ascii(trim_http_value(element.substr(semicolon + 1U)));
+      if (parameter.starts_with("q=")) {
+        const char *begin = parameter.data() + 2U;
+        const char *end = parameter.data() + parameter.size();
+        if (std::from_chars(begin, end, q).ec != std::errc{}) {
+          q = 0.0;
+        }
       }
-      throw http_request_error(400, "Bad Request", "request receive failed");
     }
-    const auto count = static_cast<std::size_t>(received);
-    if (request.size() + count > kMaximumHttpRequestHeaderBytes) {
-      throw http_request_error(431, "Request Header Fields Too Large",
-                               "request header exceeds 8 KiB");
+    if (coding == "gzip" || coding == "x-gzip") {
+      gzip_q = q;
+    } else if (coding == "deflate") {
+      deflate_q = q;
+    } else if (coding == "*") {
+      star_q = q;
     }
-    request.append(buffer.data(), count);
+  });
+  if (gzip_q < 0.0) {
+    gzip_q = star_q;
   }
-  if (request.find("\r\n\r\n") == std::string::npos) {
-    throw http_request_error(400, "Bad Request", "incomplete request header");
+  if (deflate_q < 0.0) {
+    deflate_q = star_q;
   }
-  return request;
+  if (gzip_q > 0.0 && gzip_q >= deflate_q) {
+    return http_content_coding_e::gzip;
+  }
+  if (deflate_q > 0.0) {
+    return http_content_coding_e::deflate;
+  }
+  return http_content_coding_e::identity;
 }
 
-inline void send_all(int client, std::string_view response) {
-  std::size_t offset = 0U;
-  while (offset < response.size()) {
-    const auto sent = ::send(client, response.data() + offset,
-                             response.size() - offset, MSG_NOSIGNAL);
-    if (sent < 0) {
-      if (errno == EINTR) {
-        continue;
-      }
-      return;
+[[nodiscard]] inline std::string_view
+content_coding_name(http_content_coding_e coding) {
+  switch (coding) {
+  case http_content_coding_e::gzip:
+    return "gzip";
+  case http_content_coding_e::deflate:
+    return "deflate";
+  case http_content_coding_e::identity:
+    break;
+  }
+  return "identity";
+}
+
+// gzip (RFC 1952) or zlib-wrapped deflate (RFC 1950), which is what HTTP
+// calls "deflate".
+[[nodiscard]] inline std::string compress_body(std::string_view body,
+                                               http_content_coding_e coding) {
+#if IINUJI_HAS_SYSTEM_ZLIB
+  z_stream stream{};
+  const int window_bits = coding == http_content_coding_e::gzip ? 15 + 16 : 15;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::runtime_error("[iinuji_http] deflateInit2 failed");
+  }
+  std::string out(
+      static_cast<std::size_t>(deflateBound(&stream, body.size())) + 32U, '\0');
+  stream.next_in =
+      reinterpret_cast<Bytef *>(const_cast<char *>(body.data()));
+  stream.avail_in = static_cast<uInt>(body.size());
+  stream.next_out = reinterpret_cast<Bytef *>(out.data());
+  stream.avail_out = static_cast<uInt>(out.size());
+  const int rc = deflate(&stream, Z_FINISH);
+  const auto produced = static_cast<std::size_t>(stream.total_out);
+  deflateEnd(&stream);
+  if (rc != Z_STREAM_END) {
+    throw std::runtime_error("[iinuji_http] deflate failed");
+  }
+  out.resize(produced);
+  return out;
+#else
+  (void)coding;
+  return std::string(body);
+#endif
+}
+
+// Validators and encoded forms of one immutable document. The entity tag is
+// taken from the document bytes once; compressed bodies are built on first
+// request and kept.
+struct http_representation_t {
+  std::string etag_hex;
+  std::once_flag gzip_once;
+  std::string gzip_body;
+  std::once_flag deflate_once;
+  std::string deflate_body;
+
+  [[nodiscard]] std::string etag(http_content_coding_e coding) const {
+    if (coding == http_content_coding_e::identity) {
+      return "\"" + etag_hex + "\"";
     }
-    if (sent == 0) {
-      return;
+    return "\"" + etag_hex + "-" + std::string(content_coding_name(coding)) +
+           "\"";
+  }
+
+  [[nodiscard]] const std::string &encoded(const std::string &document,
+                                           http_content_coding_e coding) {
+    if (coding == http_content_coding_e::gzip) {
+      std::call_once(gzip_once,
+                     [&] { gzip_body = compress_body(document, coding); });
+      return gzip_body;
+    }
+    if (coding == http_content_coding_e::deflate) {
+      std::call_once(deflate_once,
+                     [&] { deflate_body = compress_body(document, coding); });
+      return deflate_body;
     }
-    offset += static_cast<std::size_t>(sent);
+    return document;
   }
-}
+
+  // If-None-Match uses weak comparison, and every coding of the document
+  // carries the same content.
+  [[nodiscard]] bool matches(std::string_view if_none_match) const {
+    bool matched = false;
+    for_each_header_element(if_none_match, [&](std::string_view tag) {
+      if (tag == "*") {
+        matched = true;
+        return;
+      }
+      if (tag.starts_with("W/")) {
+        tag.remove_prefix(2U);
+      }
+      matched = matched || tag == etag(http_content_coding_e::identity) ||
+                tag == etag(http_content_coding_e::gzip) ||
+                tag == etag(http_content_coding_e::deflate);
+    });
+    return matched;
+  }
+};
 
 } // namespace iinuji_http_detail
 
@@ -375,19 +563,31 @@ inline void send_all(int client, std::string_view response) {
   return request;
 }
 
+// A 304 carries no body and no Content-Type/Content-Length. Documents with
+// an entity tag are sent as revalidate-on-use (no-cache) so clients can poll
+// with If-None-Match; everything else stays no-store.
 [[nodiscard]] inline std::string
-serialize_http_response(const http_response_t &response, bool head_only) {
+serialize_http_response(const http_response_t &response, bool head_only,
+                        bool keep_alive = false) {
   if (response.status < 100 || response.status > 599 ||
       response.reason.empty()) {
     throw std::invalid_argument("invalid HTTP response status");
   }
+  const bool not_modified = response.status == 304;
   std::ostringstream output;
-  output << "HTTP/1.1 " << response.status << ' ' << response.reason << "\r\n"
-         << "Content-Type: " << response.content_type << "\r\n"
-         << "Content-Length: " << response.body.size() << "\r\n"
-         << "Connection: close\r\n"
-         << "Cache-Control: no-store\r\n"
-         << "Content-Security-Policy: default-src 'none'; script-src 'self'; "
+  output << "HTTP/1.1 " << response.status << ' ' << response.reason << "\r\n";
+  if (!not_modified) {
+    output << "Content-Type: " << response.content_type << "\r\n"
+           << "Content-Length: " << response.body.size() << "\r\n";
+  }
+  output << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
+  if (!response.etag.empty()) {
+    output << "ETag: " << response.etag << "\r\n"
+           << "Cache-Control: no-cache\r\n";
+  } else {
+    output << "Cache-Control: no-store\r\n";
+  }
+  output << "Content-Security-Policy: default-src 'none'; script-src 'self'; "
             "style-src 'self'; img-src 'self'; connect-src 'self'; "
             "base-uri 'none'; frame-ancestors 'none'; form-action 'none'; "
             "object-src 'none'\r\n"
@@ -400,7 +600,7 @@ serialize_http_response(const http_response_t &response, bool head_only) {
     output << name << ": " << value << "\r\n";
   }
   output << "\r\n";
-  if (!head_only) {
+  if (!head_only && !not_modified) {
     output << response.body;
   }
   return output.str();
@@ -445,6 +645,58 @@ public:
   }
 
   [[nodiscard]] http_response_t route(const http_request_t &request) const {
+    const std::string *document = nullptr;
+    auto response = route_document(request, &document);
+    if (document != nullptr) {
+      response.body = *document;
+      response.etag = representation(*document).etag(
+          http_content_coding_e::identity);
+    }
+    return response;
+  }
+
+  // What the server sends: route() plus If-None-Match revalidation and
+  // gzip/deflate bodies for JSON and SVG documents.
+  [[nodiscard]] http_response_t respond(const http_request_t &request) const {
+    const std::string *document = nullptr;
+    auto response = route_document(request, &document);
+    if (document == nullptr) {
+      return response;
+    }
+    auto &cached = representation(*document);
+    const bool compressible =
+        iinuji_http_detail::compressible_content_type(response.content_type);
+    const auto coding =
+        compressible && document->size() >= kMinimumCompressedBodyBytes
+            ? iinuji_http_detail::negotiate_content_coding(request)
+            : http_content_coding_e::identity;
+    response.etag = cached.etag(coding);
+    if (compressible) {
+      response.extra_headers.emplace_back("Vary", "Accept-Encoding");
+    }
+    if (const auto condition = request.headers.find("if-none-match");
+        condition != request.headers.end() &&
+        cached.matches(condition->second)) {
+      response.status = 304;
+      response.reason = "Not Modified";
+      return response;
+    }
+    response.body = cached.encoded(*document, coding);
+    if (coding != http_content_coding_e::identity) {
+      response.extra_headers.emplace_back(
+          "Content-Encoding",
+          std::string(iinuji_http_detail::content_coding_name(coding)));
+    }
+    return response;
+  }
+
+private:
+  // Routes a request. Fixed documents are returned through `document` (the
+  // response then has no body yet); errors and health checks come back
+  // complete.
+  [[nodiscard]] http_response_t
+  route_document(const http_request_t &request,
+                 const std::string **document) const {
     if (request.method != http_method_e::get &&
         request.method != http_method_e::head) {
       return iinuji_http_detail::make_error_response(405, "Method Not Allowed",
@@ -458,29 +710,20 @@ public:
               {}};
     }
     if (request.path == "/api/v1/benchmarks" && request.query.empty()) {
-      return {200,
-              "OK",
-              "application/json; charset=utf-8",
-              benchmark_catalog_json_,
-              {}};
+      return document_response(benchmark_catalog_json_,
+                               "application/json; charset=utf-8", document);
     }
     if (request.path == "/api/v1/catalog") {
       const auto benchmark = selected_benchmark(request);
       if (benchmark == kSyntheticBenchmarkV2Id) {
-        return {200,
-                "OK",
-                "application/json; charset=utf-8",
-                v2_repository_.catalog_json(),
-                {}};
+        return document_response(v2_repository_.catalog_json(),
+                                 "application/json; charset=utf-8", document);
       }
       if (benchmark != kSyntheticBenchmarkV1Id) {
         return iinuji_http_detail::make_error_response(404, "Not Found");
       }
-      return {200,
-              "OK",
-              "application/json; charset=utf-8",
-              repository_.catalog_json(),
-              {}};
+      return document_response(repository_.catalog_json(),
+                               "application/json; charset=utf-8", document);
     }
     constexpr std::string_view chart_prefix = "/api/v1/chart/";
     if (request.path.starts_with(chart_prefix)) {
@@ -500,32 +743,48 @@ public:
             !synthetic_chart_v2_repository_t::interval_allowed(interval)) {
           return iinuji_http_detail::make_error_response(404, "Not Found");
         }
-        return {200,
-                "OK",
-                "application/json; charset=utf-8",
-                v2_repository_.chart_json(instrument, interval),
-                {}};
+        return document_response(
+            v2_repository_.chart_json(instrument, interval),
+            "application/json; charset=utf-8", document);
       }
       if (benchmark != kSyntheticBenchmarkV1Id ||
           !synthetic_chart_repository_t::instrument_allowed(instrument) ||
           !synthetic_chart_repository_t::interval_allowed(interval)) {
         return iinuji_http_detail::make_error_response(404, "Not Found");
       }
-      return {200,
-              "OK",
-              "application/json; charset=utf-8",
-              repository_.chart_json(instrument, interval),
-              {}};
+      return document_response(repository_.chart_json(instrument, interval),
+                               "application/json; charset=utf-8", document);
     }
     const std::string asset_path =
         request.path == "/" ? "/index.html" : request.path;
     if (const auto asset = assets_.find(asset_path); asset != assets_.end()) {
-      return {200, "OK", asset->second.content_type, asset->second.body, {}};
+      return document_response(asset->second.body,
+                               asset->second.content_type, document);
     }
     return iinuji_http_detail::make_error_response(404, "Not Found");
   }
 
-private:
+  [[nodiscard]] static http_response_t
+  document_response(const std::string &body, std::string content_type,
+                    const std::string **document) {
+    *document = &body;
+    return {200, "OK", std::move(content_type), {}, {}};
+  }
+
+  // Repository documents are built once and never change, so their address
+  // identifies them for the lifetime of the application.
+  [[nodiscard]] iinuji_http_detail::http_representation_t &
+  representation(const std::string &document) const {
+    const std::lock_guard<std::mutex> lock(representations_mutex_);
+    auto &slot = representations_[&document];
+    if (!slot) {
+      slot = std::make_unique<iinuji_http_detail::http_representation_t>();
+      slot->etag_hex =
+          cuwacunu::piaabo::digest::sha256_hex(document).substr(0U, 32U);
+    }
+    return *slot;
+  }
+
   struct static_asset_t {
     std::string content_type;
     std::string body;
@@ -554,14 +813,139 @@ private:
       "\"served_anchor_end_exclusive\":3264,"
       "\"test_holdout_served\":false,\"raw_source_served\":false}]}"};
   std::map<std::string, static_asset_t> assets_;
+  mutable std::mutex representations_mutex_;
+  mutable std::map<const std::string *,
+                   std::unique_ptr<iinuji_http_detail::http_representation_t>>
+      representations_;
 };
 
 struct iinuji_http_server_config_t {
   std::string bind_address{"127.0.0.1"};
   std::uint16_t port{8765U};
   std::size_t max_requests{0U};
+  std::size_t worker_threads{4U};
+  std::size_t max_connections{256U};
+  // A started request header must complete, and queued output must drain,
+  // within this many seconds of the last progress.
+  int io_timeout_seconds{5};
+  // Idle keep-alive connections are closed after this many seconds.
+  int keep_alive_timeout_seconds{30};
+};
+
+namespace iinuji_http_detail {
+
+struct http_job_t {
+  std::uint64_t connection_id{0U};
+  http_request_t request;
+  bool keep_alive{false};
+};
+
+struct http_result_t {
+  std::uint64_t connection_id{0U};
+  std::string wire;
+};
+
+// Fixed pool of handler threads. Each finished job is queued for the event
+// loop and announced on `wake_descriptor` (an eventfd).
+class http_worker_pool_t {
+public:
+  http_worker_pool_t(std::size_t threads,
+                     std::function<std::string(const http_job_t &)> handler,
+                     int wake_descriptor)
+      : handler_(std::move(handler)), wake_descriptor_(wake_descriptor) {
+    threads = std::max<std::size_t>(1U, threads);
+    workers_.reserve(threads);
+    for (std::size_t i = 0U; i < threads; ++i) {
+      workers_.emplace_back([this] { work(); });
+    }
+  }
+
+  http_worker_pool_t(const http_worker_pool_t &) = delete;
+  http_worker_pool_t &operator=(const http_worker_pool_t &) = delete;
+
+  ~http_worker_pool_t() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    jobs_ready_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void submit(http_job_t job) {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(std::move(job));
+    }
+    jobs_ready_.notify_one();
+  }
+
+  [[nodiscard]] std::vector<http_result_t> take_results() {
+    std::uint64_t signalled = 0U;
+    (void)!::read(wake_descriptor_, &signalled, sizeof(signalled));
+    const std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<http_result_t> results(
+        std::make_move_iterator(results_.begin()),
+        std::make_move_iterator(results_.end()));
+    results_.clear();
+    return results;
+  }
+
+private:
+  void work() {
+    for (;;) {
+      http_job_t job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        jobs_ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (stopping_) {
+          return;
+        }
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+      http_result_t result{job.connection_id, handler_(job)};
+      {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+      }
+      const std::uint64_t one = 1U;
+      (void)!::write(wake_descriptor_, &one, sizeof(one));
+    }
+  }
+
+  std::function<std::string(const http_job_t &)> handler_;
+  int wake_descriptor_;
+  std::mutex mutex_;
+  std::condition_variable jobs_ready_;
+  std::deque<http_job_t> jobs_;
+  std::deque<http_result_t> results_;
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+struct http_connection_t {
+  socket_t socket;
+  std::string input;
+  std::string output;
+  std::size_t output_offset{0U};
+  std::uint32_t events{0U};           // interest currently registered
+  bool watched{false};                // the socket is in the epoll set
+  bool busy{false};                   // a request is with the worker pool
+  bool closing{false};                // close once output drains
+  bool peer_closed{false};            // the client shut down its side
+  std::chrono::steady_clock::time_point last_progress{};
 };
 
+} // namespace iinuji_http_detail
+
+// Single-threaded epoll loop over non-blocking sockets with a small pool of
+// handler threads. Connections persist (HTTP/1.1 keep-alive) and may
+// pipeline: buffered requests are parsed one at a time and each is
+// dispatched only after the previous response was queued, so responses keep
+// request order.
 class iinuji_http_server_t {
 public:
   iinuji_http_server_t(
@@ -574,9 +958,329 @@ public:
     if (config_.bind_address.empty() || config_.port == 0U) {
       throw std::invalid_argument("iinuji bind address/port is invalid");
     }
+    if (config_.max_connections == 0U || config_.io_timeout_seconds <= 0 ||
+        config_.keep_alive_timeout_seconds <= 0) {
+      throw std::invalid_argument("iinuji connection limits are invalid");
+    }
   }
 
+  // Serves until `max_requests` responses have been sent (forever when 0)
+  // and returns how many requests were answered.
   [[nodiscard]] std::size_t run() const {
+    using iinuji_http_detail::http_connection_t;
+    using iinuji_http_detail::socket_t;
+
+    const socket_t listener = listen_socket();
+    const socket_t poller(::epoll_create1(EPOLL_CLOEXEC));
+    const socket_t wake(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    if (!poller || !wake) {
+      throw std::runtime_error("iinuji HTTP event loop setup failed: " +
+                               std::string(std::strerror(errno)));
+    }
+    constexpr std::uint64_t kListenerKey = 0U;
+    constexpr std::uint64_t kWakeKey = 1U;
+    const auto watch = [&](int descriptor, std::uint32_t events,
+                           std::uint64_t key, int operation) {
+      epoll_event event{};
+      event.events = events;
+      event.data.u64 = key;
+      return ::epoll_ctl(poller.get(), operation, descriptor, &event) == 0;
+    };
+    if (!watch(listener.get(), EPOLLIN, kListenerKey, EPOLL_CTL_ADD) ||
+        !watch(wake.get(), EPOLLIN, kWakeKey, EPOLL_CTL_ADD)) {
+      throw std::runtime_error("iinuji HTTP epoll registration failed");
+    }
+
+    iinuji_http_detail::http_worker_pool_t pool(
+        config_.worker_threads,
+        [this](const iinuji_http_detail::http_job_t &job) {
+          return handle(job.request, job.keep_alive);
+        },
+        wake.get());
+
+    std::unordered_map<std::uint64_t, http_connection_t> connections;
+    std::uint64_t next_key = 2U;
+    std::size_t handled = 0U;
+    bool accepting = true;
+    const auto limit_reached = [&] {
+      return config_.max_requests != 0U && handled >= config_.max_requests;
+    };
+    const auto io_timeout = std::chrono::seconds(config_.io_timeout_seconds);
+    const auto idle_timeout =
+        std::chrono::seconds(config_.keep_alive_timeout_seconds);
+
+    const auto close_connection = [&](std::uint64_t key) {
+      const auto found = connections.find(key);
+      if (found != connections.end()) {
+        if (found->second.watched) {
+          (void)::epoll_ctl(poller.get(), EPOLL_CTL_DEL,
+                            found->second.socket.get(), nullptr);
+        }
+        connections.erase(found);
+      }
+    };
+
+    const auto queue_error = [&](http_connection_t &connection, int status,
+                                 std::string reason, bool include_allow) {
+      connection.output += serialize_http_response(
+          iinuji_http_detail::make_error_response(status, std::move(reason),
+                                                  include_allow),
+          false, false);
+      connection.closing = true;
+      connection.input.clear();
+      ++handled;
+    };
+
+    // Hands the next complete request on a connection to the pool.
+    const auto dispatch = [&](std::uint64_t key,
+                              http_connection_t &connection) {
+      if (connection.busy || connection.closing || limit_reached()) {
+        return;
+      }
+      const auto header_end = connection.input.find("\r\n\r\n");
+      if (header_end == std::string::npos) {
+        if (connection.input.size() > kMaximumHttpRequestHeaderBytes) {
+          queue_error(connection, 431, "Request Header Fields Too Large",
+                      false);
+        } else if (connection.peer_closed && !connection.input.empty()) {
+          queue_error(connection, 400, "Bad Request", false);
+        }
+        return;
+      }
+      http_request_t request;
+      try {
+        request = parse_http_request(
+            std::string_view(connection.input).substr(0U, header_end + 4U));
+      } catch (const http_request_error &error) {
+        queue_error(connection, error.status(), error.reason(),
+                    error.include_allow());
+        return;
+      } catch (const std::exception &) {
+        queue_error(connection, 500, "Internal Server Error", false);
+        return;
+      }
+      connection.input.erase(0U, header_end + 4U);
+      ++handled;
+      const bool keep_alive =
+          iinuji_http_detail::wants_keep_alive(request) && !limit_reached();
+      connection.closing = !keep_alive;
+      connection.busy = true;
+      pool.submit({key, std::move(request), keep_alive});
+    };
+
+    // Writes what the socket takes, dispatches the next request, updates the
+    // epoll interest and closes the connection once it has nothing left.
+    const auto settle = [&](std::uint64_t key) {
+      auto found = connections.find(key);
+      if (found == connections.end()) {
+        return;
+      }
+      auto &connection = found->second;
+      dispatch(key, connection);
+      while (connection.output_offset < connection.output.size()) {
+        const auto sent =
+            ::send(connection.socket.get(),
+                   connection.output.data() + connection.output_offset,
+                   connection.output.size() - connection.output_offset,
+                   MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+          continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          break;
+        }
+        if (sent <= 0) {
+          close_connection(key);
+          return;
+        }
+        connection.output_offset += static_cast<std::size_t>(sent);
+        connection.last_progress = std::chrono::steady_clock::now();
+      }
+      const bool drained = connection.output_offset == connection.output.size();
+      if (drained) {
+        connection.output.clear();
+        connection.output_offset = 0U;
+      }
+      if (drained && !connection.busy &&
+          (connection.closing || limit_reached() ||
+           (connection.peer_closed && connection.input.empty()))) {
+        close_connection(key);
+        return;
+      }
+      std::uint32_t events = 0U;
+      if (!connection.peer_closed && !connection.closing &&
+          connection.input.size() < kMaximumPendingHttpInputBytes) {
+        events |= EPOLLIN;
+      }
+      if (!drained) {
+        events |= EPOLLOUT;
+      }
+      // With nothing to wait for (typically a hung-up peer whose request is
+      // still with the pool) the socket leaves the epoll set: EPOLLHUP and
+      // EPOLLERR are reported even with an empty interest mask and would
+      // wake the loop on every wait until the worker answers.
+      if (events == 0U) {
+        if (connection.watched) {
+          (void)::epoll_ctl(poller.get(), EPOLL_CTL_DEL,
+                            connection.socket.get(), nullptr);
+          connection.watched = false;
+        }
+      } else if (!connection.watched) {
+        if (!watch(connection.socket.get(), events, key, EPOLL_CTL_ADD)) {
+          close_connection(key);
+          return;
+        }
+        connection.watched = true;
+      } else if (events != connection.events) {
+        (void)watch(connection.socket.get(), events, key, EPOLL_CTL_MOD);
+      }
+      connection.events = events;
+    };
+
+    const auto accept_connections = [&] {
+      for (;;) {
+        const int descriptor = ::accept4(listener.get(), nullptr, nullptr,
+                                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor < 0) {
+          if (errno == EINTR || errno == ECONNABORTED) {
+            continue;
+          }
+          if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EMFILE ||
+              errno == ENFILE) {
+            return;
+          }
+          throw std::runtime_error("iinuji HTTP accept failed: " +
+                                   std::string(std::strerror(errno)));
+        }
+        socket_t client(descriptor);
+        if (connections.size() >= config_.max_connections) {
+          continue;
+        }
+        int enabled = 1;
+        (void)::setsockopt(client.get(), IPPROTO_TCP, TCP_NODELAY, &enabled,
+                           sizeof(enabled));
+        const std::uint64_t key = next_key++;
+        if (!watch(client.get(), EPOLLIN, key, EPOLL_CTL_ADD)) {
+          continue;
+        }
+        auto &connection = connections[key];
+        connection.socket = std::move(client);
+        connection.events = EPOLLIN;
+        connection.watched = true;
+        connection.last_progress = std::chrono::steady_clock::now();
+      }
+    };
+
+    const auto read_connection = [&](std::uint64_t key) {
+      const auto found = connections.find(key);
+      if (found == connections.end()) {
+        return;
+      }
+      auto &connection = found->second;
+      std::array<char, 16U * 1024U> buffer{};
+      while (connection.input.size() < kMaximumPendingHttpInputBytes) {
+        const auto received =
+            ::recv(connection.socket.get(), buffer.data(), buffer.size(), 0);
+        if (received < 0 && errno == EINTR) {
+          continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          break;
+        }
+        if (received < 0) {
+          close_connection(key);
+          return;
+        }
+        if (received == 0) {
+          connection.peer_closed = true;
+          break;
+        }
+        connection.input.append(buffer.data(),
+                                static_cast<std::size_t>(received));
+        connection.last_progress = std::chrono::steady_clock::now();
+      }
+      settle(key);
+    };
+
+    // Closes connections that stopped making progress; a partially received
+    // request header is answered with 408 first.
+    const auto expire_connections = [&] {
+      const auto now = std::chrono::steady_clock::now();
+      std::vector<std::uint64_t> expired;
+      for (auto &[key, connection] : connections) {
+        const bool idle =
+            connection.input.empty() && connection.output.empty();
+        if (connection.busy ||
+            now - connection.last_progress <
+                (idle ? idle_timeout : io_timeout)) {
+          continue;
+        }
+        if (connection.output.empty() && !connection.input.empty() &&
+            !connection.closing) {
+          queue_error(connection, 408, "Request Timeout", false);
+          connection.last_progress = now;
+          expired.push_back(key);
+          continue;
+        }
+        expired.push_back(key);
+        connection.closing = true;
+        connection.output.clear();
+        connection.output_offset = 0U;
+      }
+      for (const auto key : expired) {
+        settle(key);
+      }
+    };
+
+    std::array<epoll_event, 64> events{};
+    while (accepting || !connections.empty()) {
+      if (accepting && limit_reached()) {
+        (void)::epoll_ctl(poller.get(), EPOLL_CTL_DEL, listener.get(),
+                          nullptr);
+        accepting = false;
+        continue;
+      }
+      const int ready = ::epoll_wait(poller.get(), events.data(),
+                                     static_cast<int>(events.size()), 1000);
+      if (ready < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error("iinuji HTTP epoll_wait failed: " +
+                                 std::string(std::strerror(errno)));
+      }
+      for (int index = 0; index < ready; ++index) {
+        const auto key = events[static_cast<std::size_t>(index)].data.u64;
+        const auto flags = events[static_cast<std::size_t>(index)].events;
+        if (key == kListenerKey) {
+          if (accepting) {
+            accept_connections();
+          }
+        } else if (key == kWakeKey) {
+          for (auto &result : pool.take_results()) {
+            const auto found = connections.find(result.connection_id);
+            if (found == connections.end()) {
+              continue;
+            }
+            found->second.busy = false;
+            found->second.output += result.wire;
+            settle(result.connection_id);
+          }
+        } else if ((flags & EPOLLERR) != 0U) {
+          close_connection(key);
+        } else if ((flags & (EPOLLIN | EPOLLHUP)) != 0U) {
+          read_connection(key);
+        } else if ((flags & EPOLLOUT) != 0U) {
+          settle(key);
+        }
+      }
+      expire_connections();
+    }
+    return handled;
+  }
+
+private:
+  [[nodiscard]] iinuji_http_detail::socket_t listen_socket() const {
     addrinfo hints{};
     hints.ai_family = AF_UNSPEC;
     hints.ai_socktype = SOCK_STREAM;
@@ -597,7 +1301,8 @@ public:
     for (auto *address = addresses.get(); address != nullptr;
          address = address->ai_next) {
       iinuji_http_detail::socket_t candidate(::socket(
-          address->ai_family, address->ai_socktype, address->ai_protocol));
+          address->ai_family, address->ai_socktype | SOCK_CLOEXEC,
+          address->ai_protocol));
       if (!candidate) {
         continue;
       }
@@ -605,7 +1310,8 @@ public:
       (void)::setsockopt(candidate.get(), SOL_SOCKET, SO_REUSEADDR, &enabled,
                          sizeof(enabled));
       if (::bind(candidate.get(), address->ai_addr, address->ai_addrlen) == 0 &&
-          ::listen(candidate.get(), 16) == 0) {
+          ::listen(candidate.get(), SOMAXCONN) == 0 &&
+          iinuji_http_detail::set_nonblocking(candidate.get())) {
         listener = std::move(candidate);
         break;
       }
@@ -614,51 +1320,27 @@ public:
       throw std::runtime_error("cannot bind iinuji HTTP server to " +
                                config_.bind_address + ":" + port_text);
     }
+    return listener;
+  }
 
-    std::size_t handled = 0U;
-    while (config_.max_requests == 0U || handled < config_.max_requests) {
-      iinuji_http_detail::socket_t client;
-      while (!client) {
-        const int descriptor = ::accept(listener.get(), nullptr, nullptr);
-        if (descriptor >= 0) {
-          client = iinuji_http_detail::socket_t(descriptor);
-          break;
-        }
-        if (errno != EINTR) {
-          throw std::runtime_error("iinuji HTTP accept failed: " +
-                                   std::string(std::strerror(errno)));
-        }
-      }
-      timeval timeout{};
-      timeout.tv_sec = 5;
-      (void)::setsockopt(client.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout,
-                         sizeof(timeout));
-      (void)::setsockopt(client.get(), SOL_SOCKET, SO_SNDTIMEO, &timeout,
-                         sizeof(timeout));
-
-      bool head_only = false;
-      http_response_t response;
-      try {
-        const auto raw =
-            iinuji_http_detail::receive_request_header(client.get());
-        const auto request = parse_http_request(raw);
-        head_only = request.method == http_method_e::head;
-        response = application_->route(request);
-      } catch (const http_request_error &error) {
-        response = iinuji_http_detail::make_error_response(
-            error.status(), error.reason(), error.include_allow());
-      } catch (const std::exception &) {
-        response = iinuji_http_detail::make_error_response(
-            500, "Internal Server Error");
-      }
-      iinuji_http_detail::send_all(
-          client.get(), serialize_http_response(response, head_only));
-      ++handled;
+  // Runs on a pool thread: route, negotiate and serialize one request.
+  [[nodiscard]] std::string handle(const http_request_t &request,
+                                   bool keep_alive) const {
+    const bool head_only = request.method == http_method_e::head;
+    http_response_t response;
+    try {
+      response = application_->respond(request);
+      return serialize_http_response(response, head_only, keep_alive);
+    } catch (const http_request_error &error) {
+      response = iinuji_http_detail::make_error_response(
+          error.status(), error.reason(), error.include_allow());
+    } catch (const std::exception &) {
+      response =
+          iinuji_http_detail::make_error_response(500, "Internal Server Error");
     }
-    return handled;
+    return serialize_http_response(response, head_only, keep_alive);
   }
 
-private:
   iinuji_http_server_config_t config_;
   std::shared_ptr<const iinuji_http_application_t> application_;
 };
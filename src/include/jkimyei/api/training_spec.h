@@ -151,6 +151,10 @@ struct training_run_spec_t {
   int64_t mdn_direct_edge_return_readout_identity_embedding_dim{0};
   int64_t mdn_direct_edge_return_readout_adapter_hidden_dim{0};
   bool freeze_representation{true};
+  std::string representation_embedding_cache{"off"};
+  // float32 | bf16_autocast. bf16 applies to the trainable forward pass only;
+  // weights, optimizer state and losses stay float32.
+  std::string precision_policy{"float32"};
   std::string input_representation_checkpoint_path{};
   std::string input_mdn_checkpoint_path{};
   bool allow_untrained_representation{false};
@@ -535,6 +539,31 @@ validate_training_run_spec(const training_run_spec_t &spec,
         "[training_spec] v1 MDN ExpectedValue training requires frozen "
         "representation");
   }
+  if (spec.representation_embedding_cache != "off" &&
+      spec.representation_embedding_cache != "float32" &&
+      spec.representation_embedding_cache != "float16") {
+    throw std::runtime_error(
+        "[training_spec] invalid REPRESENTATION_EMBEDDING_CACHE: " +
+        spec.representation_embedding_cache +
+        " (expected off|float32|float16)");
+  }
+  if (!is_mdn_training && spec.representation_embedding_cache != "off") {
+    throw std::runtime_error(
+        "[training_spec] REPRESENTATION_EMBEDDING_CACHE is only supported "
+        "for MDN training over a frozen representation");
+  }
+  if (spec.precision_policy != "float32" &&
+      spec.precision_policy != "bf16_autocast") {
+    throw std::runtime_error("[training_spec] invalid PRECISION_POLICY: " +
+                             spec.precision_policy +
+                             " (expected float32|bf16_autocast)");
+  }
+  if (!is_mdn_training && !is_representation_training &&
+      spec.precision_policy != "float32") {
+    throw std::runtime_error(
+        "[training_spec] PRECISION_POLICY = bf16_autocast is only supported "
+        "for representation and MDN training");
+  }
   if (is_mdn_training) {
     training_spec_detail::validate_non_negative_finite(
         spec.mdn_edge_return_auxiliary_loss_weight,
@@ -917,6 +946,10 @@ inline void validate_training_run_spec(const training_run_spec_t &spec) {
       training_spec_detail::expected_freeze_representation(spec.task)
           ? "true"
           : "false"));
+  spec.representation_embedding_cache = kv::lowercase(
+      kv::trim(kv::optional(block, "REPRESENTATION_EMBEDDING_CACHE", "off")));
+  spec.precision_policy = kv::lowercase(
+      kv::trim(kv::optional(block, "PRECISION_POLICY", "float32")));
   spec.input_representation_checkpoint_path =
       kv::optional(block, "INPUT_REPRESENTATION_CHECKPOINT", "");
   spec.input_mdn_checkpoint_path =
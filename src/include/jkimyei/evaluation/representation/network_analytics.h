@@ -51,6 +51,12 @@ struct network_analytics_options_t {
   bool enable_spectral_metrics{true};
   std::int64_t spectral_max_elements{1048576};
   std::int64_t anomaly_top_k{5};
+  // "randomized" resolves the leading spectral_rank singular values with
+  // spectral_power_iterations rounds of subspace iteration. It records a
+  // spectral-norm error bound per tensor. "exact" runs a full SVD.
+  std::string spectral_method{"randomized"};
+  std::int64_t spectral_rank{32};
+  std::int64_t spectral_power_iterations{2};
 };
 
 struct analytics_topk_entry_t {
@@ -116,6 +122,8 @@ struct network_analytics_report_t {
   std::uint64_t spectral_tensor_count{0};
   std::uint64_t spectral_skipped_tensor_count{0};
   std::uint64_t spectral_failed_tensor_count{0};
+  std::uint64_t spectral_exact_tensor_count{0};
+  double spectral_norm_rel_error_bound_max{0.0};
   double spectral_norm_mean{0.0};
   double spectral_norm_max{0.0};
   double stable_rank_mean{0.0};
@@ -26,6 +26,10 @@
 #include "kikijyeba/protocol/component_stream.h"
 #include "kikijyeba/protocol/pipeline_builder.h"
 #include "kikijyeba/topology/dock_binding.h"
+#include "piaabo/bench/trace_span.h"
+#include "piaabo/tensor/torch/checkpoint_writer.h"
+#include "piaabo/tensor/torch/device_metric_accumulator.h"
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/assembly.h"
 #include "wikimyei/inference/expected_value/mdn/channel_context_mdn_train_model.h"
 #include "wikimyei/inference/expected_value/mdn/mdn_spec.h"
@@ -50,6 +54,9 @@ struct channel_graph_first_inference_launcher_options_t {
   cuwacunu::hero::lattice::runtime_report::runtime_report_mode_t
       runtime_report_mode{cuwacunu::hero::lattice::runtime_report::
                               runtime_report_mode_t::normal};
+  // Root of the content-addressed frozen-representation embedding cache; the
+  // cache is used only when this is set and the training spec enables it.
+  std::filesystem::path representation_embedding_cache_root{};
 };
 
 struct channel_graph_first_inference_training_report_t {
@@ -122,12 +129,20 @@ struct channel_graph_first_inference_training_report_t {
   std::size_t effective_batch_size{0};
   std::string batch_size_source{};
   std::string dtype{};
+  std::string precision_policy{"float32"};
+  std::string precision_policy_requested{"float32"};
+  std::string precision_policy_fallback{};
   std::string device{};
   int64_t seed{0};
   std::string seed_scope{};
   bool allow_untrained_representation{false};
   std::string representation_checkpoint_path{};
   bool representation_checkpoint_loaded{false};
+  std::string representation_embedding_cache{"off"};
+  std::string representation_embedding_cache_dir{};
+  int64_t representation_embedding_cache_hits{0};
+  int64_t representation_embedding_cache_misses{0};
+  int64_t representation_embedding_cache_writes{0};
   std::string mdn_checkpoint_path{};
   bool mdn_checkpoint_loaded{false};
   int64_t checkpoint_every{0};
@@ -159,6 +174,11 @@ struct channel_graph_first_inference_training_report_t {
   int64_t wave_pulses_skipped{0};
   bool all_target_masks_forced_empty{false};
 
+  // Loss, gradient-norm and direct-readout head norm fields (last_*, mean_*,
+  // max_*) and finite_parameter_check are accumulated on device and refreshed
+  // only when a report or checkpoint is written and at the end of the run,
+  // so between those points they describe the last refresh, not the last
+  // step. The refreshed values equal the per-step host reads they replace.
   double last_loss{std::numeric_limits<double>::quiet_NaN()};
   double mean_loss{std::numeric_limits<double>::quiet_NaN()};
   double last_nll_loss{std::numeric_limits<double>::quiet_NaN()};
@@ -397,6 +417,7 @@ struct channel_graph_first_inference_training_report_t {
   bool runtime_lls_emitted{false};
   std::string nodelift_runtime_lls{};
   std::string representation_runtime_lls{};
+  // Latest step's MDN runtime LLS, rendered at the same refresh points.
   std::string mdn_runtime_lls{};
 
   static void append_double_list(std::ostringstream &oss, const char *key,
@@ -510,6 +531,11 @@ struct channel_graph_first_inference_training_report_t {
     oss << "effective_batch_size=" << effective_batch_size << "\n";
     oss << "batch_size_source=" << batch_size_source << "\n";
     oss << "dtype=" << dtype << "\n";
+    oss << "precision_policy=" << precision_policy << "\n";
+    oss << "precision_policy_requested=" << precision_policy_requested
+        << "\n";
+    oss << "precision_policy_fallback=" << precision_policy_fallback
+        << "\n";
     oss << "device=" << device << "\n";
     oss << "seed=" << seed << "\n";
     oss << "seed_scope=" << seed_scope << "\n";
@@ -519,6 +545,16 @@ struct channel_graph_first_inference_training_report_t {
         << "\n";
     oss << "representation_checkpoint_loaded="
         << (representation_checkpoint_loaded ? "true" : "false") << "\n";
+    oss << "representation_embedding_cache=" << representation_embedding_cache
+        << "\n";
+    oss << "representation_embedding_cache_dir="
+        << representation_embedding_cache_dir << "\n";
+    oss << "representation_embedding_cache_hits="
+        << representation_embedding_cache_hits << "\n";
+    oss << "representation_embedding_cache_misses="
+        << representation_embedding_cache_misses << "\n";
+    oss << "representation_embedding_cache_writes="
+        << representation_embedding_cache_writes << "\n";
     oss << "mdn_checkpoint_path=" << mdn_checkpoint_path << "\n";
     oss << "mdn_checkpoint_loaded="
         << (mdn_checkpoint_loaded ? "true" : "false") << "\n";
@@ -892,6 +928,9 @@ struct channel_graph_first_inference_training_report_t {
 
 namespace channel_graph_first_inference_launcher_detail {
 
+using cuwacunu::piaabo::tensor::torch::checkpoint_writer_t;
+using cuwacunu::piaabo::tensor::torch::string_metadata_tensor;
+
 template <typename KeyT>
 inline std::string optional_key_to_string(const std::optional<KeyT> &value) {
   if (!value.has_value()) {
@@ -1194,6 +1233,59 @@ finite_spread_value(const std::vector<double> &values) {
   return std::abs(numerator) / abs_denominator;
 }
 
+// Device twin of safe_abs_ratio for scalar tensors; keeps the per-step ratio
+// off the host until the report interval materializes it.
+[[nodiscard]] inline torch::Tensor
+safe_abs_ratio_tensor(const torch::Tensor &numerator,
+                      const torch::Tensor &denominator) {
+  if (!numerator.defined() || numerator.numel() == 0 ||
+      !denominator.defined() || denominator.numel() == 0) {
+    return torch::Tensor{};
+  }
+  constexpr double kMinDenominator = 1.0e-12;
+  const auto num = numerator.detach().reshape({}).to(torch::kFloat64);
+  const auto den =
+      denominator.detach().reshape({}).to(num.device()).to(torch::kFloat64);
+  const auto abs_denominator = den.abs();
+  const auto valid = torch::isfinite(num) & torch::isfinite(den) &
+                     abs_denominator.ge(kMinDenominator);
+  const auto nan =
+      torch::full_like(num, std::numeric_limits<double>::quiet_NaN());
+  return torch::where(valid, num.abs() / abs_denominator, nan);
+}
+
+// Slots of the per-step loss components accumulated on device.
+enum loss_metric_slot_t : std::size_t {
+  kLossSlotTotal = 0,
+  kLossSlotNll,
+  kLossSlotEdgeAuxiliary,
+  kLossSlotEdgeAuxiliaryRegression,
+  kLossSlotEdgeAuxiliaryDirection,
+  kLossSlotEdgeAuxiliaryRank,
+  kLossSlotDirectReadout,
+  kLossSlotDirectReadoutRegression,
+  kLossSlotDirectReadoutDirection,
+  kLossSlotDirectReadoutRank,
+  kLossSlotDirectReadoutToNllRatio,
+  kLossSlotDirectReadoutToTotalRatio,
+  kLossSlotDirectReadoutHeadGradNorm,
+  kLossSlotDirectReadoutHeadParameterNorm,
+  kLossSlotDirectReadoutHeadParameterUpdateNorm,
+  kLossSlotCount,
+};
+
+// Slots committed on every attempted step, skipped ones included.
+enum attempt_metric_slot_t : std::size_t {
+  kAttemptSlotGradNorm = 0,
+  kAttemptSlotNonfiniteLoss,
+  kAttemptSlotCount,
+};
+
+[[nodiscard]] inline double finite_or_nan(const double value) {
+  return std::isfinite(value) ? value
+                              : std::numeric_limits<double>::quiet_NaN();
+}
+
 [[nodiscard]] inline double correlation_from_sums(
     const int64_t count, const double predicted_sum, const double realized_sum,
     const double predicted_squared_sum, const double realized_squared_sum,
@@ -1597,8 +1689,62 @@ inline void append_finite_double(
   }
 }
 
+// MDN runtime LLS for one step whose device-scalar entries (losses and
+// gradient norm) are still pending. emit() reads them in one transfer and
+// splices the finite ones back at their document positions, so the launcher
+// can keep the latest step's document and only pay the sync when it writes.
+struct channel_mdn_runtime_lls_pending_t {
+  struct deferred_entry_t {
+    std::size_t position{0};
+    std::string key{};
+    std::string domain{};
+    torch::Tensor value{};
+  };
+
+  cuwacunu::hero::lattice::runtime_report::runtime_lls_document_t document{};
+  std::vector<deferred_entry_t> deferred{};
+
+  void defer(std::string key, const torch::Tensor &value,
+             std::string domain = "(-inf,+inf)") {
+    if (!value.defined() || value.numel() == 0) {
+      return;
+    }
+    deferred.push_back(deferred_entry_t{
+        .position = document.entries.size(),
+        .key = std::move(key),
+        .domain = std::move(domain),
+        .value = value.detach(),
+    });
+  }
+
+  [[nodiscard]] std::string emit() const {
+    namespace lls = cuwacunu::hero::lattice::runtime_report;
+    std::vector<torch::Tensor> values;
+    values.reserve(deferred.size());
+    for (const auto &entry : deferred) {
+      values.push_back(entry.value);
+    }
+    const auto host =
+        cuwacunu::piaabo::tensor::torch::materialize_scalars(values);
+    auto out = document;
+    std::size_t inserted = 0;
+    for (std::size_t i = 0; i < deferred.size(); ++i) {
+      if (!std::isfinite(host[i])) {
+        continue;
+      }
+      const auto at = static_cast<std::ptrdiff_t>(deferred[i].position +
+                                                  inserted);
+      out.entries.insert(out.entries.begin() + at,
+                         lls::make_component_runtime_lls_double_entry(
+                             deferred[i].key, host[i], deferred[i].domain));
+      ++inserted;
+    }
+    return lls::emit_component_runtime_lls_canonical(out);
+  }
+};
+
 template <typename KeyT>
-inline std::string make_channel_mdn_runtime_lls(
+inline channel_mdn_runtime_lls_pending_t make_channel_mdn_runtime_lls(
     const cuwacunu::wikimyei::inference::expected_value::mdn::stream::
         channel_mdn_input_batch_t<KeyT> &batch,
     const cuwacunu::wikimyei::inference::expected_value::mdn::
@@ -1625,7 +1771,9 @@ inline std::string make_channel_mdn_runtime_lls(
           static_cast<std::uint64_t>(batch.context.numel()),
           static_cast<std::uint64_t>(step.valid_target_count),
           step.skipped ? 1 : 0);
-  auto document =
+  channel_mdn_runtime_lls_pending_t pending{};
+  auto &document = pending.document;
+  document =
       cuwacunu::kikijyeba::protocol::make_component_stream_runtime_document(
           "wikimyei.inference.expected_value.mdn.runtime.v1", stream_report);
   lls::append_graph_anchor_cursor_entries(document, batch.cursor, "batch",
@@ -1670,11 +1818,7 @@ inline std::string make_channel_mdn_runtime_lls(
   document.entries.push_back(lls::make_component_runtime_lls_string_entry(
       "mdn_architecture", "shared_slot_trunk.channel_adapter.shared_feature_"
                           "head.direct_edge_readout.v4"));
-  if (step.loss.defined() && step.loss.numel() > 0) {
-    append_finite_double(
-        document, "loss",
-        step.loss.detach().to(torch::kCPU).to(torch::kFloat64).item<double>());
-  }
+  pending.defer("loss", step.loss);
   append_finite_double(document, "valid_target_fraction",
                        step.valid_target_fraction, "[0,1]");
   append_finite_double(document, "context_mask_fraction",
@@ -1692,40 +1836,15 @@ inline std::string make_channel_mdn_runtime_lls(
                        "[0,+inf)");
   append_finite_double(document, "mixture_entropy", step.mixture_entropy,
                        "[0,+inf)");
-  append_finite_double(document, "grad_norm", step.grad_norm, "[0,+inf)");
-  if (step.direct_edge_return_readout_loss.defined() &&
-      step.direct_edge_return_readout_loss.numel() > 0) {
-    append_finite_double(document, "direct_edge_return_readout_loss",
-                         step.direct_edge_return_readout_loss.detach()
-                             .to(torch::kCPU)
-                             .to(torch::kFloat64)
-                             .item<double>());
-  }
-  if (step.direct_edge_return_readout_regression_loss.defined() &&
-      step.direct_edge_return_readout_regression_loss.numel() > 0) {
-    append_finite_double(
-        document, "direct_edge_return_readout_regression_loss",
-        step.direct_edge_return_readout_regression_loss.detach()
-            .to(torch::kCPU)
-            .to(torch::kFloat64)
-            .item<double>());
-  }
-  if (step.direct_edge_return_readout_direction_loss.defined() &&
-      step.direct_edge_return_readout_direction_loss.numel() > 0) {
-    append_finite_double(document, "direct_edge_return_readout_direction_loss",
-                         step.direct_edge_return_readout_direction_loss.detach()
-                             .to(torch::kCPU)
-                             .to(torch::kFloat64)
-                             .item<double>());
-  }
-  if (step.direct_edge_return_readout_rank_loss.defined() &&
-      step.direct_edge_return_readout_rank_loss.numel() > 0) {
-    append_finite_double(document, "direct_edge_return_readout_rank_loss",
-                         step.direct_edge_return_readout_rank_loss.detach()
-                             .to(torch::kCPU)
-                             .to(torch::kFloat64)
-                             .item<double>());
-  }
+  pending.defer("grad_norm", step.grad_norm, "[0,+inf)");
+  pending.defer("direct_edge_return_readout_loss",
+                step.direct_edge_return_readout_loss);
+  pending.defer("direct_edge_return_readout_regression_loss",
+                step.direct_edge_return_readout_regression_loss);
+  pending.defer("direct_edge_return_readout_direction_loss",
+                step.direct_edge_return_readout_direction_loss);
+  pending.defer("direct_edge_return_readout_rank_loss",
+                step.direct_edge_return_readout_rank_loss);
   if (step.direct_edge_return_readout_valid_count > 0) {
     append_finite_double(
         document, "direct_edge_return_readout_directional_accuracy",
@@ -1743,7 +1862,7 @@ inline std::string make_channel_mdn_runtime_lls(
                 step.direct_edge_return_readout_pairwise_rank_valid_count),
         "[0,1]");
   }
-  return lls::emit_component_runtime_lls_canonical(document);
+  return pending;
 }
 
 inline void move_channel_mdn_input_to_device(
@@ -2119,11 +2238,14 @@ inline void freeze_vicreg_encoder(EncoderT &encoder) {
   return optimizer_step_index;
 }
 
+// With a writer, the archive is serialized on the caller's thread and the
+// file is written, synced and renamed in the background.
 inline void save_channel_mdn_checkpoint_file(
     const std::filesystem::path &path,
     const channel_graph_first_inference_training_report_t &report,
     cuwacunu::wikimyei::inference::expected_value::mdn::
-        channel_context_mdn_train_model_t &model) {
+        channel_context_mdn_train_model_t &model,
+    checkpoint_writer_t *writer = nullptr) {
   if (path.empty()) {
     return;
   }
@@ -2163,29 +2285,27 @@ inline void save_channel_mdn_checkpoint_file(
              torch::tensor({report.optimizer_steps}, i64));
   root.write("meta/optimizer_step_index",
              torch::tensor({model.optimizer_step_index()}, i64));
-  root.write(
-      "meta/component_assembly_id_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.component_assembly_id)));
+  root.write("meta/component_assembly_id_bytes",
+             string_metadata_tensor(report.component_assembly_id));
   root.write("meta/input_representation_assembly_id_bytes",
-             int64_tensor_from_vector(
-                 string_to_bytes(report.input_representation_assembly_id)));
-  root.write(
-      "meta/context_contract_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.context_contract)));
+             string_metadata_tensor(report.input_representation_assembly_id));
+  root.write("meta/context_contract_bytes",
+             string_metadata_tensor(report.context_contract));
   root.write("meta/output_contract_bytes",
-             int64_tensor_from_vector(string_to_bytes(report.output_contract)));
+             string_metadata_tensor(report.output_contract));
+  root.write("meta/precision_policy_bytes",
+             string_metadata_tensor(report.precision_policy));
   root.write("meta/context_mode_bytes",
-             int64_tensor_from_vector(string_to_bytes(report.context_mode)));
+             string_metadata_tensor(report.context_mode));
   root.write("meta/target_domain_bytes",
-             int64_tensor_from_vector(string_to_bytes(report.target_domain)));
-  root.write(
-      "meta/target_mask_policy_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.target_mask_policy)));
+             string_metadata_tensor(report.target_domain));
+  root.write("meta/target_mask_policy_bytes",
+             string_metadata_tensor(report.target_mask_policy));
   root.write("meta/activity_target_bytes",
-             int64_tensor_from_vector(string_to_bytes(report.activity_target)));
-  root.write("meta/direct_edge_return_readout_identity_mode_bytes",
-             int64_tensor_from_vector(string_to_bytes(
-                 report.direct_edge_return_readout_identity_mode)));
+             string_metadata_tensor(report.activity_target));
+  root.write(
+      "meta/direct_edge_return_readout_identity_mode_bytes",
+      string_metadata_tensor(report.direct_edge_return_readout_identity_mode));
   root.write("meta/target_coords",
              int64_tensor_from_vector(report.target_coords));
   const auto f64 = torch::TensorOptions().dtype(torch::kFloat64);
@@ -2193,12 +2313,16 @@ inline void save_channel_mdn_checkpoint_file(
   root.write("meta/sigma_max", torch::tensor({report.sigma_max}, f64));
   root.write("meta/eps", torch::tensor({report.eps}, f64));
   root.write("meta/graph_order_fingerprint_bytes",
-             int64_tensor_from_vector(
-                 string_to_bytes(report.graph_order_fingerprint)));
+             string_metadata_tensor(report.graph_order_fingerprint));
   auto [node_id_lengths, node_id_bytes] =
       string_list_to_lengths_and_bytes(report.node_ids);
   root.write("meta/node_id_lengths", int64_tensor_from_vector(node_id_lengths));
-  root.write("meta/node_id_bytes", int64_tensor_from_vector(node_id_bytes));
+  root.write("meta/node_id_bytes",
+             int64_tensor_from_vector(node_id_bytes).to(torch::kUInt8));
+  if (writer != nullptr) {
+    writer->submit(root, path);
+    return;
+  }
   root.save_to(path.string());
 }
 
@@ -2641,6 +2765,11 @@ public:
     out.effective_batch_size = plan.effective_batch_size;
     out.batch_size_source = plan.batch_size_source;
     out.dtype = plan.dtype;
+    out.precision_policy = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(effective_precision_policy());
+    out.precision_policy_requested = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(requested_precision_policy());
+    out.precision_policy_fallback = precision_policy_fallback_reason();
     out.device = plan.device;
     out.seed = builder_.bundle().channel_mdn_training.seed;
     out.seed_scope = builder_.options().device.is_cuda()
@@ -2718,6 +2847,7 @@ public:
             bundle.wave_settings, options_.runtime_report_mode);
     auto source = builder_.make_graph_source();
     const auto source_cursor_report = source.cursor_report();
+    const auto source_cache_files = source.source_cache_files();
     auto lifted_stream = builder_.make_node_lifted_stream(std::move(source),
                                                           runtime_report_mode);
     bool representation_checkpoint_loaded = false;
@@ -2736,6 +2866,48 @@ public:
         mtf_adapter_holder;
     bool representation_on_device = false;
 
+    namespace repcache =
+        cuwacunu::wikimyei::representation::encoding::vicreg::stream;
+    std::shared_ptr<repcache::representation_embedding_cache_t>
+        embedding_cache;
+    auto make_embedding_cache = [&](const std::string &component_assembly_id,
+                                    const std::string &assembly_token) {
+      const auto dtype = repcache::parse_representation_embedding_cache_dtype(
+          training_spec.representation_embedding_cache);
+      if (dtype == repcache::representation_embedding_cache_dtype_t::off ||
+          options_.representation_embedding_cache_root.empty() ||
+          training_spec.input_representation_checkpoint_path.empty()) {
+        return;
+      }
+      repcache::representation_embedding_cache_identity_t identity{};
+      identity.representation_checkpoint_digest =
+          repcache::representation_checkpoint_file_digest(
+              training_spec.input_representation_checkpoint_path);
+      identity.source_cursor_token = source_cursor_report.cursor_token();
+      const std::vector<std::filesystem::path> source_cache_paths(
+          source_cache_files.begin(), source_cache_files.end());
+      identity.source_cache_fingerprint =
+          repcache::representation_source_cache_fingerprint(
+              source_cache_paths);
+      identity.lift_config_digest = cuwacunu::piaabo::digest::sha256_hex(
+          cuwacunu::wikimyei::expression::nodelift::srl::
+              nodelift_srl_spec_canonical_text(bundle.nodelift));
+      identity.graph_order_fingerprint =
+          bundle.source_plan.market_graph.computed_graph_order_fingerprint();
+      identity.component_assembly_id = component_assembly_id;
+      identity.assembly_token = assembly_token;
+      identity.dock_binding_token =
+          cuwacunu::kikijyeba::topology::dock_binding_token(
+              bundle.dock_binding);
+      identity.dtype = dtype;
+      embedding_cache =
+          std::make_shared<repcache::representation_embedding_cache_t>(
+              options_.representation_embedding_cache_root,
+              std::move(identity),
+              training_spec.input_representation_checkpoint_path,
+              source_cache_paths);
+    };
+
     if (training_spec.input_representation_checkpoint_path.empty() &&
         !training_spec.allow_untrained_representation) {
       throw std::runtime_error(
@@ -2798,6 +2970,13 @@ public:
           "wikimyei.representation.mtf_jepa_mae_vicreg.runtime.v1",
           cuwacunu::kikijyeba::protocol::component_stream_wave_from_settings(
               bundle.wave_settings));
+      make_embedding_cache(
+          bundle.mtf_jepa_mae_vicreg.component_assembly_id,
+          cuwacunu::wikimyei::assembly::make_assembly_token(
+              bundle.mtf_jepa_mae_vicreg_assembly.family,
+              bundle.mtf_jepa_mae_vicreg_assembly.component_assembly_id,
+              bundle.mtf_jepa_mae_vicreg_assembly.version_token));
+      mtf_stream.set_embedding_cache(embedding_cache);
       using mtf_stream_t = decltype(mtf_stream);
       representation_stream = std::make_unique<
           channel_graph_first_inference_launcher_detail::
@@ -2842,6 +3021,13 @@ public:
       auto vicreg_stream = builder_.make_channel_representation_stream(
           std::move(lifted_stream), *vicreg_encoder_holder,
           runtime_report_mode);
+      make_embedding_cache(
+          bundle.vicreg.component_assembly_id,
+          cuwacunu::wikimyei::assembly::make_assembly_token(
+              bundle.vicreg_assembly.family,
+              bundle.vicreg_assembly.component_assembly_id,
+              bundle.vicreg_assembly.version_token));
+      vicreg_stream.set_embedding_cache(embedding_cache);
       using vicreg_stream_t = decltype(vicreg_stream);
       representation_stream = std::make_unique<
           channel_graph_first_inference_launcher_detail::
@@ -2857,6 +3043,12 @@ public:
     report.representation_checkpoint_path =
         training_spec.input_representation_checkpoint_path;
     report.representation_checkpoint_loaded = representation_checkpoint_loaded;
+    report.representation_embedding_cache =
+        training_spec.representation_embedding_cache;
+    if (embedding_cache) {
+      report.representation_embedding_cache_dir =
+          embedding_cache->namespace_dir().string();
+    }
     report.representation_parameter_device_check = representation_on_device;
     report.mdn_checkpoint_path = training_spec.input_mdn_checkpoint_path;
     report.mdn_checkpoint_loaded = false;
@@ -2921,42 +3113,23 @@ public:
                         channel_context_mdn_train_model_t>
         model_holder;
 
-    double loss_sum = 0.0;
-    int64_t loss_count = 0;
-    double nll_loss_sum = 0.0;
-    int64_t nll_loss_count = 0;
-    double edge_auxiliary_loss_sum = 0.0;
-    int64_t edge_auxiliary_loss_count = 0;
-    double edge_auxiliary_regression_loss_sum = 0.0;
-    int64_t edge_auxiliary_regression_loss_count = 0;
-    double edge_auxiliary_direction_loss_sum = 0.0;
-    int64_t edge_auxiliary_direction_loss_count = 0;
-    double edge_auxiliary_rank_loss_sum = 0.0;
-    int64_t edge_auxiliary_rank_loss_count = 0;
+    // Loss components stay on device between reports; refresh_running_report
+    // materializes them in one transfer.
+    cuwacunu::piaabo::tensor::torch::device_metric_accumulator_t loss_metrics(
+        channel_graph_first_inference_launcher_detail::kLossSlotCount);
+    cuwacunu::piaabo::tensor::torch::device_metric_accumulator_t
+        attempt_metrics(
+            channel_graph_first_inference_launcher_detail::kAttemptSlotCount);
+    // Runtime LLS of the latest step; its device scalars are read when the
+    // report is refreshed.
+    std::optional<
+        channel_graph_first_inference_launcher_detail::
+            channel_mdn_runtime_lls_pending_t>
+        pending_mdn_runtime_lls;
     int64_t edge_auxiliary_valid_count = 0;
     int64_t edge_auxiliary_pairwise_valid_count = 0;
-    double direct_readout_loss_sum = 0.0;
-    int64_t direct_readout_loss_count = 0;
-    double direct_readout_regression_loss_sum = 0.0;
-    int64_t direct_readout_regression_loss_count = 0;
-    double direct_readout_direction_loss_sum = 0.0;
-    int64_t direct_readout_direction_loss_count = 0;
-    double direct_readout_rank_loss_sum = 0.0;
-    int64_t direct_readout_rank_loss_count = 0;
     int64_t direct_readout_loss_valid_count = 0;
     int64_t direct_readout_loss_pairwise_valid_count = 0;
-    double direct_readout_loss_abs_to_nll_abs_ratio_sum = 0.0;
-    int64_t direct_readout_loss_abs_to_nll_abs_ratio_count = 0;
-    double direct_readout_loss_abs_to_total_abs_ratio_sum = 0.0;
-    int64_t direct_readout_loss_abs_to_total_abs_ratio_count = 0;
-    double direct_readout_head_grad_norm_sum = 0.0;
-    int64_t direct_readout_head_grad_norm_count = 0;
-    double direct_readout_head_grad_norm_max =
-        -std::numeric_limits<double>::infinity();
-    double direct_readout_head_parameter_update_norm_sum = 0.0;
-    int64_t direct_readout_head_parameter_update_norm_count = 0;
-    double direct_readout_head_parameter_update_norm_max =
-        -std::numeric_limits<double>::infinity();
     double valid_fraction_sum = 0.0;
     int64_t valid_fraction_count = 0;
     double sigma_mean_sum = 0.0;
@@ -2969,7 +3142,6 @@ public:
     double sigma_max_valid = -std::numeric_limits<double>::infinity();
     double mixture_entropy_sum = 0.0;
     int64_t mixture_entropy_count = 0;
-    double max_grad_norm = -std::numeric_limits<double>::infinity();
     double ev_abs_error_sum = 0.0;
     double ev_squared_error_sum = 0.0;
     double ev_signed_error_sum = 0.0;
@@ -3066,90 +3238,123 @@ public:
     std::vector<int64_t> valid_count_per_channel_target_feature_sum;
 
     auto refresh_running_report = [&]() {
-      if (loss_count > 0) {
-        report.mean_loss = loss_sum / static_cast<double>(loss_count);
-      }
-      if (nll_loss_count > 0) {
-        report.mean_nll_loss =
-            nll_loss_sum / static_cast<double>(nll_loss_count);
+      namespace launcher_detail =
+          channel_graph_first_inference_launcher_detail;
+      loss_metrics.materialize();
+      attempt_metrics.materialize();
+      if (pending_mdn_runtime_lls) {
+        report.mdn_runtime_lls = pending_mdn_runtime_lls->emit();
+        pending_mdn_runtime_lls.reset();
       }
-      if (edge_auxiliary_loss_count > 0) {
-        report.mean_edge_return_auxiliary_loss =
-            edge_auxiliary_loss_sum /
-            static_cast<double>(edge_auxiliary_loss_count);
+      if (embedding_cache) {
+        report.representation_embedding_cache_hits = embedding_cache->hits();
+        report.representation_embedding_cache_misses =
+            embedding_cache->misses();
+        report.representation_embedding_cache_writes =
+            embedding_cache->writes();
       }
-      if (edge_auxiliary_regression_loss_count > 0) {
-        report.mean_edge_return_auxiliary_regression_loss =
-            edge_auxiliary_regression_loss_sum /
-            static_cast<double>(edge_auxiliary_regression_loss_count);
-      }
-      if (edge_auxiliary_direction_loss_count > 0) {
-        report.mean_edge_return_auxiliary_direction_loss =
-            edge_auxiliary_direction_loss_sum /
-            static_cast<double>(edge_auxiliary_direction_loss_count);
+      if (loss_metrics.commit_count() > 0) {
+        using launcher_detail::finite_or_nan;
+        report.last_loss = loss_metrics.last(launcher_detail::kLossSlotTotal);
+        report.last_nll_loss =
+            finite_or_nan(loss_metrics.last(launcher_detail::kLossSlotNll));
+        report.last_edge_return_auxiliary_loss = finite_or_nan(
+            loss_metrics.last(launcher_detail::kLossSlotEdgeAuxiliary));
+        report.last_edge_return_auxiliary_regression_loss =
+            finite_or_nan(loss_metrics.last(
+                launcher_detail::kLossSlotEdgeAuxiliaryRegression));
+        report.last_edge_return_auxiliary_direction_loss =
+            finite_or_nan(loss_metrics.last(
+                launcher_detail::kLossSlotEdgeAuxiliaryDirection));
+        report.last_edge_return_auxiliary_rank_loss = finite_or_nan(
+            loss_metrics.last(launcher_detail::kLossSlotEdgeAuxiliaryRank));
+        report.last_direct_edge_return_readout_loss = finite_or_nan(
+            loss_metrics.last(launcher_detail::kLossSlotDirectReadout));
+        report.last_direct_edge_return_readout_regression_loss =
+            finite_or_nan(loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutRegression));
+        report.last_direct_edge_return_readout_direction_loss =
+            finite_or_nan(loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutDirection));
+        report.last_direct_edge_return_readout_rank_loss = finite_or_nan(
+            loss_metrics.last(launcher_detail::kLossSlotDirectReadoutRank));
+        report.last_direct_edge_return_readout_loss_abs_to_nll_abs_ratio =
+            loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutToNllRatio);
+        report.last_direct_edge_return_readout_loss_abs_to_total_abs_ratio =
+            loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutToTotalRatio);
+        report.last_direct_edge_return_readout_head_grad_norm =
+            loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutHeadGradNorm);
+        report.last_direct_edge_return_readout_head_parameter_norm =
+            loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutHeadParameterNorm);
+        report.last_direct_edge_return_readout_head_parameter_update_norm =
+            loss_metrics.last(
+                launcher_detail::kLossSlotDirectReadoutHeadParameterUpdateNorm);
       }
-      if (edge_auxiliary_rank_loss_count > 0) {
-        report.mean_edge_return_auxiliary_rank_loss =
-            edge_auxiliary_rank_loss_sum /
-            static_cast<double>(edge_auxiliary_rank_loss_count);
+      if (attempt_metrics.commit_count() > 0) {
+        report.last_grad_norm =
+            attempt_metrics.last(launcher_detail::kAttemptSlotGradNorm);
+        if (attempt_metrics.sum(launcher_detail::kAttemptSlotNonfiniteLoss) >
+            0.0) {
+          report.finite_parameter_check = 0.0;
+        }
       }
+      auto assign_max = [](double &target, const double value) {
+        if (std::isfinite(value)) {
+          target = value;
+        }
+      };
+      auto assign_mean = [&](double &target, const std::size_t slot) {
+        if (loss_metrics.count(slot) > 0) {
+          target = loss_metrics.mean_or_nan(slot);
+        }
+      };
+      assign_mean(report.mean_loss, launcher_detail::kLossSlotTotal);
+      assign_mean(report.mean_nll_loss, launcher_detail::kLossSlotNll);
+      assign_mean(report.mean_edge_return_auxiliary_loss,
+                  launcher_detail::kLossSlotEdgeAuxiliary);
+      assign_mean(report.mean_edge_return_auxiliary_regression_loss,
+                  launcher_detail::kLossSlotEdgeAuxiliaryRegression);
+      assign_mean(report.mean_edge_return_auxiliary_direction_loss,
+                  launcher_detail::kLossSlotEdgeAuxiliaryDirection);
+      assign_mean(report.mean_edge_return_auxiliary_rank_loss,
+                  launcher_detail::kLossSlotEdgeAuxiliaryRank);
       report.edge_return_auxiliary_valid_count = edge_auxiliary_valid_count;
       report.edge_return_auxiliary_pairwise_valid_count =
           edge_auxiliary_pairwise_valid_count;
-      if (direct_readout_loss_count > 0) {
-        report.mean_direct_edge_return_readout_loss =
-            direct_readout_loss_sum /
-            static_cast<double>(direct_readout_loss_count);
-      }
-      if (direct_readout_regression_loss_count > 0) {
-        report.mean_direct_edge_return_readout_regression_loss =
-            direct_readout_regression_loss_sum /
-            static_cast<double>(direct_readout_regression_loss_count);
-      }
-      if (direct_readout_direction_loss_count > 0) {
-        report.mean_direct_edge_return_readout_direction_loss =
-            direct_readout_direction_loss_sum /
-            static_cast<double>(direct_readout_direction_loss_count);
-      }
-      if (direct_readout_rank_loss_count > 0) {
-        report.mean_direct_edge_return_readout_rank_loss =
-            direct_readout_rank_loss_sum /
-            static_cast<double>(direct_readout_rank_loss_count);
-      }
+      assign_mean(report.mean_direct_edge_return_readout_loss,
+                  launcher_detail::kLossSlotDirectReadout);
+      assign_mean(report.mean_direct_edge_return_readout_regression_loss,
+                  launcher_detail::kLossSlotDirectReadoutRegression);
+      assign_mean(report.mean_direct_edge_return_readout_direction_loss,
+                  launcher_detail::kLossSlotDirectReadoutDirection);
+      assign_mean(report.mean_direct_edge_return_readout_rank_loss,
+                  launcher_detail::kLossSlotDirectReadoutRank);
       report.direct_edge_return_readout_loss_valid_count =
           direct_readout_loss_valid_count;
       report.direct_edge_return_readout_loss_pairwise_valid_count =
           direct_readout_loss_pairwise_valid_count;
-      if (direct_readout_loss_abs_to_nll_abs_ratio_count > 0) {
-        report.mean_direct_edge_return_readout_loss_abs_to_nll_abs_ratio =
-            direct_readout_loss_abs_to_nll_abs_ratio_sum /
-            static_cast<double>(direct_readout_loss_abs_to_nll_abs_ratio_count);
-      }
-      if (direct_readout_loss_abs_to_total_abs_ratio_count > 0) {
-        report.mean_direct_edge_return_readout_loss_abs_to_total_abs_ratio =
-            direct_readout_loss_abs_to_total_abs_ratio_sum /
-            static_cast<double>(
-                direct_readout_loss_abs_to_total_abs_ratio_count);
-      }
-      if (direct_readout_head_grad_norm_count > 0) {
-        report.mean_direct_edge_return_readout_head_grad_norm =
-            direct_readout_head_grad_norm_sum /
-            static_cast<double>(direct_readout_head_grad_norm_count);
-      }
-      if (std::isfinite(direct_readout_head_grad_norm_max)) {
-        report.max_direct_edge_return_readout_head_grad_norm =
-            direct_readout_head_grad_norm_max;
-      }
-      if (direct_readout_head_parameter_update_norm_count > 0) {
-        report.mean_direct_edge_return_readout_head_parameter_update_norm =
-            direct_readout_head_parameter_update_norm_sum /
-            static_cast<double>(
-                direct_readout_head_parameter_update_norm_count);
-      }
-      if (std::isfinite(direct_readout_head_parameter_update_norm_max)) {
-        report.max_direct_edge_return_readout_head_parameter_update_norm =
-            direct_readout_head_parameter_update_norm_max;
-      }
+      assign_mean(
+          report.mean_direct_edge_return_readout_loss_abs_to_nll_abs_ratio,
+          launcher_detail::kLossSlotDirectReadoutToNllRatio);
+      assign_mean(
+          report.mean_direct_edge_return_readout_loss_abs_to_total_abs_ratio,
+          launcher_detail::kLossSlotDirectReadoutToTotalRatio);
+      assign_mean(report.mean_direct_edge_return_readout_head_grad_norm,
+                  launcher_detail::kLossSlotDirectReadoutHeadGradNorm);
+      assign_max(report.max_direct_edge_return_readout_head_grad_norm,
+                 loss_metrics.max(
+                     launcher_detail::kLossSlotDirectReadoutHeadGradNorm));
+      assign_mean(
+          report.mean_direct_edge_return_readout_head_parameter_update_norm,
+          launcher_detail::kLossSlotDirectReadoutHeadParameterUpdateNorm);
+      assign_max(
+          report.max_direct_edge_return_readout_head_parameter_update_norm,
+          loss_metrics.max(
+              launcher_detail::kLossSlotDirectReadoutHeadParameterUpdateNorm));
       if (valid_fraction_count > 0) {
         report.mean_valid_target_fraction =
             valid_fraction_sum / static_cast<double>(valid_fraction_count);
@@ -3178,9 +3383,8 @@ public:
         report.mean_mixture_entropy =
             mixture_entropy_sum / static_cast<double>(mixture_entropy_count);
       }
-      if (std::isfinite(max_grad_norm)) {
-        report.max_grad_norm = max_grad_norm;
-      }
+      assign_max(report.max_grad_norm,
+                 attempt_metrics.max(launcher_detail::kAttemptSlotGradNorm));
       report.forecast_ev_valid_count = ev_metric_valid_count;
       if (ev_metric_valid_count > 0) {
         report.ev_mae =
@@ -3486,6 +3690,11 @@ public:
           valid_count_per_channel_target_feature_sum;
     };
 
+    channel_graph_first_inference_launcher_detail::checkpoint_writer_t
+        checkpoint_writer;
+    int64_t pending_checkpoint_count = 0;
+    int64_t pending_checkpoint_optimizer_step = 0;
+    std::filesystem::path pending_checkpoint_path{};
     auto write_checkpoint = [&]() {
       if (model_ptr == nullptr) {
         return;
@@ -3493,16 +3702,34 @@ public:
       refresh_running_report();
       auto checkpoint_path = options_.report_path;
       checkpoint_path += ".channel_mdn.pt";
+      PIAABO_TRACE_SPAN("jkimyei", "inference_launcher.checkpoint_save");
+      channel_graph_first_inference_launcher_detail::
+          save_channel_mdn_checkpoint_file(checkpoint_path, report, *model_ptr,
+                                           &checkpoint_writer);
+      ++pending_checkpoint_count;
+      pending_checkpoint_optimizer_step = report.optimizer_steps;
+      pending_checkpoint_path = std::move(checkpoint_path);
+    };
+
+    // The checkpoint fields describe files on disk, so they are published
+    // only after the background writes have completed; a later submit waits
+    // for the earlier write, so one wait covers every pending checkpoint.
+    auto publish_checkpoint = [&]() {
+      if (pending_checkpoint_count == 0) {
+        return;
+      }
+      checkpoint_writer.wait();
       report.checkpoint_written = true;
-      ++report.checkpoint_write_count;
-      report.last_checkpoint_optimizer_step = report.optimizer_steps;
-      report.checkpoint_path = checkpoint_path.string();
+      report.checkpoint_write_count += pending_checkpoint_count;
+      pending_checkpoint_count = 0;
+      report.last_checkpoint_optimizer_step =
+          pending_checkpoint_optimizer_step;
+      report.checkpoint_path = pending_checkpoint_path.string();
       report.checkpoint_format = "torch_archive_channel_mdn_v2";
-      channel_graph_first_inference_launcher_detail::
-          save_channel_mdn_checkpoint_file(checkpoint_path, report, *model_ptr);
     };
 
     auto write_report = [&]() {
+      publish_checkpoint();
       refresh_running_report();
       report.last_report_attempted_step = report.steps_attempted;
       if (!options_.report_path.empty()) {
@@ -3536,9 +3763,13 @@ public:
           break;
         }
       }
+      PIAABO_TRACE_SPAN("jkimyei", "inference_launcher.step");
       ++report.steps_attempted;
       ++report.wave_pulses_attempted;
-      auto channel_batch = representation_stream->next();
+      auto channel_batch = [&] {
+        PIAABO_TRACE_SPAN("jkimyei", "inference_launcher.representation");
+        return representation_stream->next();
+      }();
       report.wave_streamed_anchor_count +=
           static_cast<int64_t>(channel_batch.cursor.anchor_count());
 
@@ -3566,6 +3797,17 @@ public:
       if (options_.force_empty_targets_for_test) {
         input.future_mask.fill_(false);
       }
+      // Evaluation decides whether to skip from the valid target count; take
+      // it from the stream's host masks before they move to the device.
+      int64_t eval_valid_target_count = 0;
+      int64_t eval_target_slot_count = 0;
+      if (!train_target) {
+        const auto host_mask = cuwacunu::wikimyei::inference::expected_value::
+            mdn::combine_channel_context_and_future_mask(input.context_mask,
+                                                         input.future_mask);
+        eval_valid_target_count = host_mask.sum().template item<int64_t>();
+        eval_target_slot_count = host_mask.numel();
+      }
       channel_graph_first_inference_launcher_detail::
           move_channel_mdn_input_to_device(input, builder_.options().dtype,
                                            builder_.options().device);
@@ -3589,6 +3831,7 @@ public:
             mdn::channel_context_mdn_train_options_from_spec(
                 builder_.bundle().channel_mdn);
         train_options.grad_clip_norm = training_spec.grad_clip_norm;
+        train_options.precision_policy = effective_precision_policy();
         train_options.edge_return_auxiliary_loss_weight =
             training_spec.mdn_edge_return_auxiliary_loss_weight;
         train_options.edge_return_auxiliary_direction_weight =
@@ -3677,17 +3920,19 @@ public:
       cuwacunu::wikimyei::inference::expected_value::mdn::
           channel_context_mdn_train_step_result_t step{};
       if (train_target) {
+        PIAABO_TRACE_SPAN("jkimyei", "inference_launcher.train_one_batch");
         step = model_ptr->train_one_batch(input);
       } else {
+        PIAABO_TRACE_SPAN("jkimyei", "inference_launcher.evaluate_batch");
         const auto combined_mask = cuwacunu::wikimyei::inference::
             expected_value::mdn::combine_channel_context_and_future_mask(
                 input.context_mask, input.future_mask);
-        step.valid_target_count = combined_mask.sum().template item<int64_t>();
+        step.valid_target_count = eval_valid_target_count;
         step.valid_target_fraction =
-            combined_mask.numel() == 0
+            eval_target_slot_count == 0
                 ? 0.0
                 : static_cast<double>(step.valid_target_count) /
-                      static_cast<double>(combined_mask.numel());
+                      static_cast<double>(eval_target_slot_count);
         if (step.valid_target_count == 0) {
           step.skipped = true;
           step.loss = torch::zeros({}, input.context.options());
@@ -3787,12 +4032,12 @@ public:
                   record_scheduled_objective(
                       step, step.nll, edge_auxiliary, direct_readout,
                       eval_train_options, model_ptr->optimizer_step_index());
-          step.sigma_mean =
-              out.sigma.mean().to(torch::kCPU).template item<double>();
-          step.sigma_min =
-              out.sigma.min().to(torch::kCPU).template item<double>();
-          step.sigma_max =
-              out.sigma.max().to(torch::kCPU).template item<double>();
+          const auto sigma_summary =
+              cuwacunu::piaabo::tensor::torch::materialize_scalars(
+                  {out.sigma.mean(), out.sigma.min(), out.sigma.max()});
+          step.sigma_mean = sigma_summary[0];
+          step.sigma_min = sigma_summary[1];
+          step.sigma_max = sigma_summary[2];
           const auto sigma_valid =
               cuwacunu::wikimyei::inference::expected_value::mdn::
                   channel_context_mdn_train_detail::masked_sigma_summary(
@@ -3831,143 +4076,52 @@ public:
         if (step.optimizer_step_applied) {
           ++report.optimizer_steps;
         }
-        report.last_loss = step.loss.defined() && step.loss.numel() > 0
-                               ? step.loss.detach()
-                                     .to(torch::kCPU)
-                                     .to(torch::kFloat64)
-                                     .template item<double>()
-                               : std::numeric_limits<double>::quiet_NaN();
-        if (std::isfinite(report.last_loss)) {
-          loss_sum += report.last_loss;
-          ++loss_count;
-        }
-        auto finite_scalar_or_nan = [](const torch::Tensor &value) {
-          if (!value.defined() || value.numel() == 0) {
-            return std::numeric_limits<double>::quiet_NaN();
-          }
-          const double scalar = value.detach()
-                                    .to(torch::kCPU)
-                                    .to(torch::kFloat64)
-                                    .template item<double>();
-          return std::isfinite(scalar)
-                     ? scalar
-                     : std::numeric_limits<double>::quiet_NaN();
-        };
-        report.last_nll_loss = finite_scalar_or_nan(step.nll);
-        if (std::isfinite(report.last_nll_loss)) {
-          nll_loss_sum += report.last_nll_loss;
-          ++nll_loss_count;
-        }
-        report.last_edge_return_auxiliary_loss =
-            finite_scalar_or_nan(step.edge_return_auxiliary_loss);
-        if (std::isfinite(report.last_edge_return_auxiliary_loss)) {
-          edge_auxiliary_loss_sum += report.last_edge_return_auxiliary_loss;
-          ++edge_auxiliary_loss_count;
-        }
-        report.last_edge_return_auxiliary_regression_loss =
-            finite_scalar_or_nan(step.edge_return_auxiliary_regression_loss);
-        if (std::isfinite(report.last_edge_return_auxiliary_regression_loss)) {
-          edge_auxiliary_regression_loss_sum +=
-              report.last_edge_return_auxiliary_regression_loss;
-          ++edge_auxiliary_regression_loss_count;
-        }
-        report.last_edge_return_auxiliary_direction_loss =
-            finite_scalar_or_nan(step.edge_return_auxiliary_direction_loss);
-        if (std::isfinite(report.last_edge_return_auxiliary_direction_loss)) {
-          edge_auxiliary_direction_loss_sum +=
-              report.last_edge_return_auxiliary_direction_loss;
-          ++edge_auxiliary_direction_loss_count;
-        }
-        report.last_edge_return_auxiliary_rank_loss =
-            finite_scalar_or_nan(step.edge_return_auxiliary_rank_loss);
-        if (std::isfinite(report.last_edge_return_auxiliary_rank_loss)) {
-          edge_auxiliary_rank_loss_sum +=
-              report.last_edge_return_auxiliary_rank_loss;
-          ++edge_auxiliary_rank_loss_count;
+        {
+          namespace launcher_detail =
+              channel_graph_first_inference_launcher_detail;
+          loss_metrics.stage(launcher_detail::kLossSlotTotal, step.loss);
+          loss_metrics.stage(launcher_detail::kLossSlotNll, step.nll);
+          loss_metrics.stage(launcher_detail::kLossSlotEdgeAuxiliary,
+                             step.edge_return_auxiliary_loss);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotEdgeAuxiliaryRegression,
+              step.edge_return_auxiliary_regression_loss);
+          loss_metrics.stage(launcher_detail::kLossSlotEdgeAuxiliaryDirection,
+                             step.edge_return_auxiliary_direction_loss);
+          loss_metrics.stage(launcher_detail::kLossSlotEdgeAuxiliaryRank,
+                             step.edge_return_auxiliary_rank_loss);
+          loss_metrics.stage(launcher_detail::kLossSlotDirectReadout,
+                             step.direct_edge_return_readout_loss);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutRegression,
+              step.direct_edge_return_readout_regression_loss);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutDirection,
+              step.direct_edge_return_readout_direction_loss);
+          loss_metrics.stage(launcher_detail::kLossSlotDirectReadoutRank,
+                             step.direct_edge_return_readout_rank_loss);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutToNllRatio,
+              launcher_detail::safe_abs_ratio_tensor(
+                  step.direct_edge_return_readout_loss, step.nll));
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutToTotalRatio,
+              launcher_detail::safe_abs_ratio_tensor(
+                  step.direct_edge_return_readout_loss, step.loss));
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutHeadGradNorm,
+              step.direct_edge_return_readout_head_grad_norm);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutHeadParameterNorm,
+              step.direct_edge_return_readout_head_parameter_norm_after_step);
+          loss_metrics.stage(
+              launcher_detail::kLossSlotDirectReadoutHeadParameterUpdateNorm,
+              step.direct_edge_return_readout_head_parameter_update_norm);
+          loss_metrics.commit();
         }
         edge_auxiliary_valid_count += step.edge_return_auxiliary_valid_count;
         edge_auxiliary_pairwise_valid_count +=
             step.edge_return_auxiliary_pairwise_valid_count;
-        report.last_direct_edge_return_readout_loss =
-            finite_scalar_or_nan(step.direct_edge_return_readout_loss);
-        if (std::isfinite(report.last_direct_edge_return_readout_loss)) {
-          direct_readout_loss_sum +=
-              report.last_direct_edge_return_readout_loss;
-          ++direct_readout_loss_count;
-        }
-        report.last_direct_edge_return_readout_regression_loss =
-            finite_scalar_or_nan(
-                step.direct_edge_return_readout_regression_loss);
-        if (std::isfinite(
-                report.last_direct_edge_return_readout_regression_loss)) {
-          direct_readout_regression_loss_sum +=
-              report.last_direct_edge_return_readout_regression_loss;
-          ++direct_readout_regression_loss_count;
-        }
-        report.last_direct_edge_return_readout_direction_loss =
-            finite_scalar_or_nan(
-                step.direct_edge_return_readout_direction_loss);
-        if (std::isfinite(
-                report.last_direct_edge_return_readout_direction_loss)) {
-          direct_readout_direction_loss_sum +=
-              report.last_direct_edge_return_readout_direction_loss;
-          ++direct_readout_direction_loss_count;
-        }
-        report.last_direct_edge_return_readout_rank_loss =
-            finite_scalar_or_nan(step.direct_edge_return_readout_rank_loss);
-        if (std::isfinite(report.last_direct_edge_return_readout_rank_loss)) {
-          direct_readout_rank_loss_sum +=
-              report.last_direct_edge_return_readout_rank_loss;
-          ++direct_readout_rank_loss_count;
-        }
-        report.last_direct_edge_return_readout_loss_abs_to_nll_abs_ratio =
-            channel_graph_first_inference_launcher_detail::safe_abs_ratio(
-                report.last_direct_edge_return_readout_loss,
-                report.last_nll_loss);
-        if (std::isfinite(
-                report
-                    .last_direct_edge_return_readout_loss_abs_to_nll_abs_ratio)) {
-          direct_readout_loss_abs_to_nll_abs_ratio_sum +=
-              report.last_direct_edge_return_readout_loss_abs_to_nll_abs_ratio;
-          ++direct_readout_loss_abs_to_nll_abs_ratio_count;
-        }
-        report.last_direct_edge_return_readout_loss_abs_to_total_abs_ratio =
-            channel_graph_first_inference_launcher_detail::safe_abs_ratio(
-                report.last_direct_edge_return_readout_loss, report.last_loss);
-        if (std::isfinite(
-                report
-                    .last_direct_edge_return_readout_loss_abs_to_total_abs_ratio)) {
-          direct_readout_loss_abs_to_total_abs_ratio_sum +=
-              report
-                  .last_direct_edge_return_readout_loss_abs_to_total_abs_ratio;
-          ++direct_readout_loss_abs_to_total_abs_ratio_count;
-        }
-        report.last_direct_edge_return_readout_head_grad_norm =
-            step.direct_edge_return_readout_head_grad_norm;
-        if (std::isfinite(
-                report.last_direct_edge_return_readout_head_grad_norm)) {
-          direct_readout_head_grad_norm_sum +=
-              report.last_direct_edge_return_readout_head_grad_norm;
-          direct_readout_head_grad_norm_max =
-              std::max(direct_readout_head_grad_norm_max,
-                       report.last_direct_edge_return_readout_head_grad_norm);
-          ++direct_readout_head_grad_norm_count;
-        }
-        report.last_direct_edge_return_readout_head_parameter_norm =
-            step.direct_edge_return_readout_head_parameter_norm_after_step;
-        report.last_direct_edge_return_readout_head_parameter_update_norm =
-            step.direct_edge_return_readout_head_parameter_update_norm;
-        if (std::isfinite(
-                report
-                    .last_direct_edge_return_readout_head_parameter_update_norm)) {
-          direct_readout_head_parameter_update_norm_sum +=
-              report.last_direct_edge_return_readout_head_parameter_update_norm;
-          direct_readout_head_parameter_update_norm_max = std::max(
-              direct_readout_head_parameter_update_norm_max,
-              report
-                  .last_direct_edge_return_readout_head_parameter_update_norm);
-          ++direct_readout_head_parameter_update_norm_count;
-        }
         report.last_direct_edge_return_readout_scheduled_nll_weight =
             step.direct_edge_return_readout_scheduled_nll_weight;
         report.last_direct_edge_return_readout_warmup_active =
@@ -4216,9 +4370,18 @@ public:
         }
       }
       report.nonfinite_output_count += step.nonfinite_output_count;
-      report.last_grad_norm = step.grad_norm;
-      if (std::isfinite(step.grad_norm)) {
-        max_grad_norm = std::max(max_grad_norm, step.grad_norm);
+      {
+        namespace launcher_detail =
+            channel_graph_first_inference_launcher_detail;
+        attempt_metrics.stage(launcher_detail::kAttemptSlotGradNorm,
+                              step.grad_norm);
+        attempt_metrics.stage(
+            launcher_detail::kAttemptSlotNonfiniteLoss,
+            train_target || step.skipped || !step.loss.defined()
+                ? torch::Tensor{}
+                : (~torch::isfinite(step.loss.detach()).all())
+                      .to(torch::kFloat64));
+        attempt_metrics.commit();
       }
       channel_graph_first_inference_launcher_detail::accumulate_finite_vector(
           step.nll_per_channel, nll_per_channel_sum, nll_per_channel_count);
@@ -4246,22 +4409,23 @@ public:
               runtime_report_mode)) {
         report.nodelift_runtime_lls = batch.nodelift_runtime_lls;
         report.representation_runtime_lls = batch.representation_runtime_lls;
-        report.mdn_runtime_lls = channel_graph_first_inference_launcher_detail::
-            make_channel_mdn_runtime_lls(
-                batch, step,
-                builder_.bundle().channel_mdn.component_assembly_id,
-                cuwacunu::wikimyei::assembly::make_assembly_token(
-                    builder_.bundle().channel_mdn_assembly.family,
-                    builder_.bundle()
-                        .channel_mdn_assembly.component_assembly_id,
-                    builder_.bundle().channel_mdn_assembly.version_token),
-                cuwacunu::kikijyeba::topology::dock_binding_token(
-                    builder_.bundle().dock_binding),
-                cuwacunu::kikijyeba::protocol::
-                    component_stream_wave_from_settings(
-                        builder_.bundle().wave_settings),
-                runtime_report_mode, report.optimizer_steps,
-                report.wave_pulses_attempted);
+        pending_mdn_runtime_lls =
+            channel_graph_first_inference_launcher_detail::
+                make_channel_mdn_runtime_lls(
+                    batch, step,
+                    builder_.bundle().channel_mdn.component_assembly_id,
+                    cuwacunu::wikimyei::assembly::make_assembly_token(
+                        builder_.bundle().channel_mdn_assembly.family,
+                        builder_.bundle()
+                            .channel_mdn_assembly.component_assembly_id,
+                        builder_.bundle().channel_mdn_assembly.version_token),
+                    cuwacunu::kikijyeba::topology::dock_binding_token(
+                        builder_.bundle().dock_binding),
+                    cuwacunu::kikijyeba::protocol::
+                        component_stream_wave_from_settings(
+                            builder_.bundle().wave_settings),
+                    runtime_report_mode, report.optimizer_steps,
+                    report.wave_pulses_attempted);
         report.runtime_lls_emitted = true;
       }
 
@@ -4274,6 +4438,7 @@ public:
       }
     }
 
+    publish_checkpoint();
     refresh_running_report();
     if (!options_.write_report ||
         report.last_report_attempted_step != report.steps_attempted) {
@@ -4296,6 +4461,26 @@ private:
            cuwacunu::hero::runtime::settings::wave_action_t::train;
   }
 
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  requested_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::parse_precision_policy(
+        builder_.bundle().channel_mdn_training.precision_policy);
+  }
+
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  effective_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::effective_precision_policy(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
+  // Empty unless a bf16_autocast request was downgraded to float32.
+  [[nodiscard]] std::string precision_policy_fallback_reason() const {
+    return cuwacunu::piaabo::tensor::torch::precision_policy_fallback_reason(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
   void validate_batch_size_contract() const {
     const auto expected = static_cast<std::size_t>(
         builder_.bundle().channel_mdn_training.batch_size);
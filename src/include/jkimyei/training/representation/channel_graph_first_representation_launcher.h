@@ -24,6 +24,8 @@
 #include "kikijyeba/protocol/component_stream.h"
 #include "kikijyeba/protocol/pipeline_builder.h"
 #include "kikijyeba/topology/dock_binding.h"
+#include "piaabo/tensor/torch/checkpoint_writer.h"
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/assembly.h"
 #include "wikimyei/representation/encoding/vicreg/channel_node_stream_adapter.h"
 #include "wikimyei/representation/encoding/vicreg/vicreg_projector.h"
@@ -86,6 +88,9 @@ struct channel_graph_first_representation_training_report_t {
   std::size_t effective_batch_size{0};
   std::string batch_size_source{};
   std::string dtype{};
+  std::string precision_policy{"float32"};
+  std::string precision_policy_requested{"float32"};
+  std::string precision_policy_fallback{};
   std::string device{};
   int64_t seed{0};
   std::string seed_scope{};
@@ -255,6 +260,11 @@ struct channel_graph_first_representation_training_report_t {
     oss << "effective_batch_size=" << effective_batch_size << "\n";
     oss << "batch_size_source=" << batch_size_source << "\n";
     oss << "dtype=" << dtype << "\n";
+    oss << "precision_policy=" << precision_policy << "\n";
+    oss << "precision_policy_requested=" << precision_policy_requested
+        << "\n";
+    oss << "precision_policy_fallback=" << precision_policy_fallback
+        << "\n";
     oss << "device=" << device << "\n";
     oss << "seed=" << seed << "\n";
     oss << "seed_scope=" << seed_scope << "\n";
@@ -399,6 +409,9 @@ struct channel_graph_first_representation_training_report_t {
 
 namespace channel_graph_first_representation_launcher_detail {
 
+using cuwacunu::piaabo::tensor::torch::checkpoint_writer_t;
+using cuwacunu::piaabo::tensor::torch::string_metadata_tensor;
+
 inline double scalar_or_nan(const torch::Tensor &tensor) {
   if (!tensor.defined() || tensor.numel() == 0) {
     return std::numeric_limits<double>::quiet_NaN();
@@ -937,7 +950,8 @@ inline void save_vicreg_checkpoint_file(
     const std::filesystem::path &path,
     const channel_graph_first_representation_training_report_t &report,
     cuwacunu::wikimyei::representation::encoding::vicreg::vicreg_train_model_t
-        &model) {
+        &model,
+    checkpoint_writer_t *writer = nullptr) {
   if (path.empty()) {
     return;
   }
@@ -991,27 +1005,29 @@ inline void save_vicreg_checkpoint_file(
              torch::tensor({report.skip_non_finite_loss ? 1 : 0}, i64));
   root.write("meta/optimizer_steps",
              torch::tensor({report.optimizer_steps}, i64));
-  root.write(
-      "meta/component_assembly_id_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.component_assembly_id)));
+  root.write("meta/component_assembly_id_bytes",
+             string_metadata_tensor(report.component_assembly_id));
   root.write("meta/representation_contract_bytes",
-             int64_tensor_from_vector(
-                 string_to_bytes(report.representation_contract)));
-  root.write(
-      "meta/channel_axis_policy_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.channel_axis_policy)));
-  root.write(
-      "meta/cell_valid_policy_bytes",
-      int64_tensor_from_vector(string_to_bytes(report.cell_valid_policy)));
+             string_metadata_tensor(report.representation_contract));
+  root.write("meta/precision_policy_bytes",
+             string_metadata_tensor(report.precision_policy));
+  root.write("meta/channel_axis_policy_bytes",
+             string_metadata_tensor(report.channel_axis_policy));
+  root.write("meta/cell_valid_policy_bytes",
+             string_metadata_tensor(report.cell_valid_policy));
   root.write("meta/required_feature_coords",
              int64_tensor_from_vector(report.required_feature_coords));
   root.write("meta/graph_order_fingerprint_bytes",
-             int64_tensor_from_vector(
-                 string_to_bytes(report.graph_order_fingerprint)));
+             string_metadata_tensor(report.graph_order_fingerprint));
   auto [node_id_lengths, node_id_bytes] =
       string_list_to_lengths_and_bytes(report.node_ids);
   root.write("meta/node_id_lengths", int64_tensor_from_vector(node_id_lengths));
-  root.write("meta/node_id_bytes", int64_tensor_from_vector(node_id_bytes));
+  root.write("meta/node_id_bytes",
+             int64_tensor_from_vector(node_id_bytes).to(torch::kUInt8));
+  if (writer != nullptr) {
+    writer->submit(root, path);
+    return;
+  }
   root.save_to(path.string());
 }
 
@@ -1076,6 +1092,11 @@ public:
     out.effective_batch_size = plan.effective_batch_size;
     out.batch_size_source = plan.batch_size_source;
     out.dtype = plan.dtype;
+    out.precision_policy = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(effective_precision_policy());
+    out.precision_policy_requested = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(requested_precision_policy());
+    out.precision_policy_fallback = precision_policy_fallback_reason();
     out.device = plan.device;
     out.seed = builder_.bundle().vicreg_training.seed;
     out.seed_scope = builder_.options().device.is_cuda()
@@ -1139,6 +1160,7 @@ public:
         vicreg_train_options_from_spec(builder_.bundle().vicreg);
     train_options.grad_clip_norm =
         builder_.bundle().vicreg_training.grad_clip_norm;
+    train_options.precision_policy = effective_precision_policy();
     auto model = cuwacunu::wikimyei::representation::encoding::vicreg::
         vicreg_train_model_t(std::move(encoder), std::move(projector),
                              builder_.bundle().vicreg_training.learning_rate,
@@ -1288,20 +1310,42 @@ public:
           }
         };
 
+    channel_graph_first_representation_launcher_detail::checkpoint_writer_t
+        checkpoint_writer;
+    int64_t pending_checkpoint_count = 0;
+    int64_t pending_checkpoint_optimizer_step = 0;
+    std::filesystem::path pending_checkpoint_path{};
     auto write_checkpoint = [&]() {
       refresh_running_report();
       auto checkpoint_path = options_.report_path;
       checkpoint_path += ".vicreg.pt";
+      channel_graph_first_representation_launcher_detail::
+          save_vicreg_checkpoint_file(checkpoint_path, report, model,
+                                      &checkpoint_writer);
+      ++pending_checkpoint_count;
+      pending_checkpoint_optimizer_step = report.optimizer_steps;
+      pending_checkpoint_path = std::move(checkpoint_path);
+    };
+
+    // The checkpoint fields describe files on disk, so they are published
+    // only after the background writes have completed; a later submit waits
+    // for the earlier write, so one wait covers every pending checkpoint.
+    auto publish_checkpoint = [&]() {
+      if (pending_checkpoint_count == 0) {
+        return;
+      }
+      checkpoint_writer.wait();
       report.checkpoint_written = true;
-      ++report.checkpoint_write_count;
-      report.last_checkpoint_optimizer_step = report.optimizer_steps;
-      report.checkpoint_path = checkpoint_path.string();
+      report.checkpoint_write_count += pending_checkpoint_count;
+      pending_checkpoint_count = 0;
+      report.last_checkpoint_optimizer_step =
+          pending_checkpoint_optimizer_step;
+      report.checkpoint_path = pending_checkpoint_path.string();
       report.checkpoint_format = "torch_archive_vicreg_v1";
-      channel_graph_first_representation_launcher_detail::
-          save_vicreg_checkpoint_file(checkpoint_path, report, model);
     };
 
     auto write_report = [&]() {
+      publish_checkpoint();
       refresh_running_report();
       report.last_report_attempted_step = report.steps_attempted;
       if (!options_.report_path.empty()) {
@@ -1494,6 +1538,7 @@ public:
       }
     }
 
+    publish_checkpoint();
     refresh_running_report();
     if (!options_.write_report ||
         report.last_report_attempted_step != report.steps_attempted) {
@@ -1511,6 +1556,26 @@ private:
            cuwacunu::hero::runtime::settings::wave_action_t::train;
   }
 
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  requested_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::parse_precision_policy(
+        builder_.bundle().vicreg_training.precision_policy);
+  }
+
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  effective_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::effective_precision_policy(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
+  // Empty unless a bf16_autocast request was downgraded to float32.
+  [[nodiscard]] std::string precision_policy_fallback_reason() const {
+    return cuwacunu::piaabo::tensor::torch::precision_policy_fallback_reason(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
   void validate_batch_size_contract() const {
     const auto expected =
         static_cast<std::size_t>(builder_.bundle().vicreg_training.batch_size);
@@ -24,6 +24,8 @@
 #include "hero/lattice_hero/lattice/runtime_report/component_runtime_lls.h"
 #include "hero/runtime_hero/runtime/wave_settings.h"
 #include "kikijyeba/protocol/pipeline_builder.h"
+#include "piaabo/tensor/torch/checkpoint_writer.h"
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/assembly.h"
 #include "wikimyei/representation/encoding/mtf_jepa_mae_vicreg/channel_node_stream_adapter.h"
 #include "wikimyei/representation/encoding/mtf_jepa_mae_vicreg/mtf_jepa_mae_vicreg.h"
@@ -142,6 +144,9 @@ struct mtf_jepa_mae_vicreg_graph_first_report_t {
   std::size_t effective_batch_size{0};
   std::string batch_size_source{};
   std::string dtype{};
+  std::string precision_policy{"float32"};
+  std::string precision_policy_requested{"float32"};
+  std::string precision_policy_fallback{};
   std::string device{};
   int64_t seed{0};
   std::string seed_scope{};
@@ -377,6 +382,11 @@ struct mtf_jepa_mae_vicreg_graph_first_report_t {
     oss << "effective_batch_size=" << effective_batch_size << "\n";
     oss << "batch_size_source=" << batch_size_source << "\n";
     oss << "dtype=" << dtype << "\n";
+    oss << "precision_policy=" << precision_policy << "\n";
+    oss << "precision_policy_requested=" << precision_policy_requested
+        << "\n";
+    oss << "precision_policy_fallback=" << precision_policy_fallback
+        << "\n";
     oss << "device=" << device << "\n";
     oss << "seed=" << seed << "\n";
     oss << "seed_scope=" << seed_scope << "\n";
@@ -509,6 +519,9 @@ struct mtf_jepa_mae_vicreg_graph_first_report_t {
 
 namespace mtf_jepa_mae_vicreg_graph_first_launcher_detail {
 
+using cuwacunu::piaabo::tensor::torch::checkpoint_writer_t;
+using cuwacunu::piaabo::tensor::torch::string_metadata_tensor;
+
 inline double scalar_or_nan(const torch::Tensor &tensor) {
   if (!tensor.defined() || tensor.numel() == 0) {
     return std::numeric_limits<double>::quiet_NaN();
@@ -1089,7 +1102,8 @@ save_checkpoint_file(const std::filesystem::path &path,
                      const mtf_jepa_mae_vicreg_graph_first_report_t &report,
                      cuwacunu::wikimyei::representation::encoding::
                          mtf_jepa_mae_vicreg::MtfJepaMaeVicreg &model,
-                     torch::optim::Optimizer &optimizer) {
+                     torch::optim::Optimizer &optimizer,
+                     checkpoint_writer_t *writer = nullptr) {
   if (path.empty()) {
     return;
   }
@@ -1116,6 +1130,12 @@ save_checkpoint_file(const std::filesystem::path &path,
   root.write("meta/mean_loss", torch::tensor({report.mean_loss}, f64));
   root.write("meta/target_ema_distance",
              torch::tensor({report.target_ema_distance}, f64));
+  root.write("meta/precision_policy_bytes",
+             string_metadata_tensor(report.precision_policy));
+  if (writer != nullptr) {
+    writer->submit(root, path);
+    return;
+  }
   root.save_to(path.string());
 }
 
@@ -1220,6 +1240,11 @@ public:
     out.effective_batch_size = plan.effective_batch_size;
     out.batch_size_source = builder_.batch_size_source();
     out.dtype = plan.dtype;
+    out.precision_policy = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(effective_precision_policy());
+    out.precision_policy_requested = cuwacunu::piaabo::tensor::torch::
+        precision_policy_name(requested_precision_policy());
+    out.precision_policy_fallback = precision_policy_fallback_reason();
     out.device = plan.device;
     out.seed = training.seed;
     out.seed_scope = cfg.device.is_cuda()
@@ -1285,6 +1310,7 @@ public:
     std::vector<torch::Tensor> params = model->parameters();
     torch::optim::Adam optimizer(
         params, torch::optim::AdamOptions(training.learning_rate));
+    const auto precision_policy = effective_precision_policy();
 
     auto report = dry_run_report();
     report.seed_scope = seed_scope;
@@ -1376,6 +1402,9 @@ public:
       }
     };
 
+    mtf_jepa_mae_vicreg_graph_first_launcher_detail::checkpoint_writer_t
+        checkpoint_writer;
+    bool checkpoint_artifact_pending = false;
     auto write_checkpoint = [&]() {
       if (!train_target || report.optimizer_steps <= 0) {
         return;
@@ -1390,9 +1419,20 @@ public:
       report.checkpoint_path_reported = report.checkpoint_path;
       report.checkpoint_format = "torch_archive_mtf_jepa_mae_vicreg_v1";
       mtf_jepa_mae_vicreg_graph_first_launcher_detail::save_checkpoint_file(
-          checkpoint_path, report, model, optimizer);
+          checkpoint_path, report, model, optimizer, &checkpoint_writer);
+      checkpoint_artifact_pending = true;
+    };
+
+    // The artifact summary reads the file back, so it waits for the
+    // background write and runs only when a report is about to be emitted.
+    auto publish_checkpoint_artifact = [&]() {
+      if (!checkpoint_artifact_pending) {
+        return;
+      }
+      checkpoint_writer.wait();
+      checkpoint_artifact_pending = false;
       const auto artifact = mtf_jepa_mae_vicreg_graph_first_launcher_detail::
-          summarize_file_artifact(checkpoint_path);
+          summarize_file_artifact(report.checkpoint_path);
       report.checkpoint_file_exists = artifact.exists;
       report.checkpoint_digest_reported = artifact.digest;
       report.checkpoint_digest_verified = artifact.digest_ok;
@@ -1402,6 +1442,7 @@ public:
     };
 
     auto write_report = [&]() {
+      publish_checkpoint_artifact();
       refresh_running_report();
       report.last_report_attempted_step = report.steps_attempted;
       if (!options_.report_path.empty()) {
@@ -1490,7 +1531,11 @@ public:
               after_aug_fraction / before_aug_fraction;
           ++augmentation_count;
         }
-        output = model->forward(augmented.data, augmented.feature_mask);
+        {
+          cuwacunu::piaabo::tensor::torch::autocast_scope_t autocast(
+              precision_policy);
+          output = model->forward(augmented.data, augmented.feature_mask);
+        }
         if (!torch::isfinite(output.loss).all().template item<bool>()) {
           ++report.nonfinite_output_count;
           ++report.skipped_batches;
@@ -1660,6 +1705,7 @@ public:
         !report.checkpoint_written) {
       write_checkpoint();
     }
+    publish_checkpoint_artifact();
     if (!options_.write_report ||
         report.last_report_attempted_step != report.steps_attempted) {
       write_report();
@@ -1676,6 +1722,26 @@ private:
            cuwacunu::hero::runtime::settings::wave_action_t::train;
   }
 
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  requested_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::parse_precision_policy(
+        builder_.bundle().mtf_jepa_mae_vicreg_training.precision_policy);
+  }
+
+  [[nodiscard]] cuwacunu::piaabo::tensor::torch::precision_policy_t
+  effective_precision_policy() const {
+    return cuwacunu::piaabo::tensor::torch::effective_precision_policy(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
+  // Empty unless a bf16_autocast request was downgraded to float32.
+  [[nodiscard]] std::string precision_policy_fallback_reason() const {
+    return cuwacunu::piaabo::tensor::torch::precision_policy_fallback_reason(
+        requested_precision_policy(), builder_.options().device,
+        builder_.options().dtype);
+  }
+
   void validate_batch_size_contract() const {
     const auto expected = static_cast<std::size_t>(
         builder_.bundle().mtf_jepa_mae_vicreg_training.batch_size);
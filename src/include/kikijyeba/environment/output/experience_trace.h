@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "kikijyeba/environment/run/experiment_runner.h"
+#include "piaabo/digest/sha256.h"
 
 namespace cuwacunu::kikijyeba::environment::output {
 
@@ -478,9 +479,8 @@ using kv_map_t = std::unordered_map<std::string, std::string>;
   return std::stod(raw);
 }
 
-[[nodiscard]] inline policy_kind_t read_policy_kind(const kv_map_t &values,
-                                                    const std::string &key) {
-  const auto raw = read_text(values, key);
+[[nodiscard]] inline policy_kind_t parse_policy_kind(const std::string &raw,
+                                                     const std::string &key) {
   if (raw == policy_kind_name(policy_kind_t::deterministic_allocator)) {
     return policy_kind_t::deterministic_allocator;
   }
@@ -496,15 +496,24 @@ using kv_map_t = std::unordered_map<std::string, std::string>;
   throw std::runtime_error("[experience_trace] invalid policy_kind key " + key);
 }
 
-[[nodiscard]] inline world_mode_t read_world_mode(const kv_map_t &values,
-                                                  const std::string &key) {
-  const auto raw = read_text(values, key);
+[[nodiscard]] inline policy_kind_t read_policy_kind(const kv_map_t &values,
+                                                    const std::string &key) {
+  return parse_policy_kind(read_text(values, key), key);
+}
+
+[[nodiscard]] inline world_mode_t parse_world_mode(const std::string &raw,
+                                                   const std::string &key) {
   if (raw == world_mode_name(world_mode_t::historical_replay)) {
     return world_mode_t::historical_replay;
   }
   throw std::runtime_error("[experience_trace] invalid world_mode key " + key);
 }
 
+[[nodiscard]] inline world_mode_t read_world_mode(const kv_map_t &values,
+                                                  const std::string &key) {
+  return parse_world_mode(read_text(values, key), key);
+}
+
 [[nodiscard]] inline std::vector<std::string>
 read_string_vector(const kv_map_t &values, const std::string &prefix) {
   const auto count = read_size(values, prefix + "count");
@@ -1288,7 +1297,8 @@ read_transition_record(const kv_map_t &values, const std::string &prefix) {
 }
 
 inline void write_episode_trace(std::ostream &out, const std::string &prefix,
-                                const episode_trace_t &trace) {
+                                const episode_trace_t &trace,
+                                bool include_transitions = true) {
   write_text_kv(out, prefix + "schema", trace.trace_schema_id);
   write_text_kv(out, prefix + "source_episode_artifact_schema_id",
                 trace.source_episode_artifact_schema_id);
@@ -1339,6 +1349,9 @@ inline void write_episode_trace(std::ostream &out, const std::string &prefix,
                   trace.projection_interval_coverage);
   write_string_vector(out, prefix + "warning_", trace.warnings);
   write_string_vector(out, prefix + "failure_", trace.failures);
+  if (!include_transitions) {
+    return;
+  }
   for (std::size_t i = 0; i < trace.transitions.size(); ++i) {
     write_transition_record(out,
                             prefix + "transition_" + std::to_string(i) + "_",
@@ -1347,7 +1360,8 @@ inline void write_episode_trace(std::ostream &out, const std::string &prefix,
 }
 
 [[nodiscard]] inline episode_trace_t
-read_episode_trace(const kv_map_t &values, const std::string &prefix) {
+read_episode_trace(const kv_map_t &values, const std::string &prefix,
+                   bool include_transitions = true) {
   episode_trace_t trace{};
   trace.trace_schema_id = read_text(values, prefix + "schema");
   trace.source_episode_artifact_schema_id =
@@ -1398,6 +1412,9 @@ read_episode_trace(const kv_map_t &values, const std::string &prefix) {
       read_double(values, prefix + "projection_interval_coverage");
   trace.warnings = read_string_vector(values, prefix + "warning_");
   trace.failures = read_string_vector(values, prefix + "failure_");
+  if (!include_transitions) {
+    return trace;
+  }
   trace.transitions.reserve(trace.transition_count);
   for (std::uint64_t i = 0; i < trace.transition_count; ++i) {
     trace.transitions.push_back(read_transition_record(
@@ -1539,8 +1556,95 @@ read_policy_comparison_record(const kv_map_t &values,
   return record;
 }
 
+// Writes the deterministic key-value form of a trace. With
+// include_transitions=false only experiment, episode and policy-comparison
+// keys are written; the columnar store carries transitions itself.
+inline void write_experience_trace_kv(std::ostream &out,
+                                      const experience_trace_t &trace,
+                                      bool include_transitions = true) {
+  write_text_kv(out, "schema", trace.trace_schema_id);
+  write_text_kv(out, "source_experiment_artifact_schema_id",
+                trace.source_experiment_artifact_schema_id);
+  write_text_kv(out, "future_consumer", trace.future_consumer);
+  write_text_kv(out, "experiment_id", trace.experiment_id);
+  write_text_kv(out, "runtime_run_id", trace.runtime_run_id);
+  write_text_kv(out, "environment_run_id", trace.environment_run_id);
+  write_integral_kv(out, "requested_max_parallel_jobs",
+                    trace.requested_max_parallel_jobs);
+  write_integral_kv(out, "resolved_parallelism", trace.resolved_parallelism);
+  write_integral_kv(out, "attempted_count", trace.attempted_count);
+  write_integral_kv(out, "completed_count", trace.completed_count);
+  write_integral_kv(out, "episode_count", trace.episodes.size());
+  write_integral_kv(out, "policy_comparison_count",
+                    trace.policy_comparisons.size());
+  write_string_vector(out, "warning_", trace.warnings);
+  write_string_vector(out, "failure_", trace.failures);
+
+  for (std::size_t i = 0; i < trace.episodes.size(); ++i) {
+    write_episode_trace(out, "episode_" + std::to_string(i) + "_",
+                        trace.episodes[i], include_transitions);
+  }
+  for (std::size_t i = 0; i < trace.policy_comparisons.size(); ++i) {
+    write_policy_comparison_record(
+        out, "policy_comparison_" + std::to_string(i) + "_",
+        trace.policy_comparisons[i]);
+  }
+}
+
+[[nodiscard]] inline experience_trace_t
+read_experience_trace_kv(const kv_map_t &values,
+                         bool include_transitions = true) {
+  experience_trace_t trace{};
+  trace.trace_schema_id = read_text(values, "schema");
+  trace.source_experiment_artifact_schema_id =
+      read_text(values, "source_experiment_artifact_schema_id");
+  trace.future_consumer = read_text(values, "future_consumer");
+  trace.experiment_id = read_text(values, "experiment_id");
+  trace.runtime_run_id = read_text(values, "runtime_run_id");
+  trace.environment_run_id = read_text(values, "environment_run_id");
+  trace.requested_max_parallel_jobs =
+      read_size(values, "requested_max_parallel_jobs");
+  trace.resolved_parallelism = read_size(values, "resolved_parallelism");
+  trace.attempted_count = read_u64(values, "attempted_count");
+  trace.completed_count = read_u64(values, "completed_count");
+  const auto episode_count = read_size(values, "episode_count");
+  const auto policy_comparison_count =
+      read_size(values, "policy_comparison_count");
+  trace.warnings = read_string_vector(values, "warning_");
+  trace.failures = read_string_vector(values, "failure_");
+
+  trace.episodes.reserve(episode_count);
+  for (std::size_t i = 0; i < episode_count; ++i) {
+    trace.episodes.push_back(read_episode_trace(
+        values, "episode_" + std::to_string(i) + "_", include_transitions));
+  }
+  trace.policy_comparisons.reserve(policy_comparison_count);
+  for (std::size_t i = 0; i < policy_comparison_count; ++i) {
+    trace.policy_comparisons.push_back(read_policy_comparison_record(
+        values, "policy_comparison_" + std::to_string(i) + "_"));
+  }
+  return trace;
+}
+
 } // namespace detail
 
+// Canonical text view of a trace: the exact bytes the text report writer
+// emits. Digests and cross-format comparisons are defined over this text, so
+// the columnar store and the text report describe the same trace iff their
+// canonical texts match.
+[[nodiscard]] inline std::string
+experience_trace_canonical_text(const experience_trace_t &trace) {
+  std::ostringstream out;
+  detail::write_experience_trace_kv(out, trace);
+  return out.str();
+}
+
+[[nodiscard]] inline std::string
+experience_trace_digest(const experience_trace_t &trace) {
+  return cuwacunu::piaabo::digest::sha256_hex(
+      experience_trace_canonical_text(trace));
+}
+
 inline void write_experience_trace_report(const experience_trace_t &trace,
                                           const std::filesystem::path &path) {
   if (path.empty()) {
@@ -1553,35 +1657,7 @@ inline void write_experience_trace_report(const experience_trace_t &trace,
     throw std::runtime_error("[experience_trace] failed to open report path " +
                              path.string());
   }
-
-  detail::write_text_kv(out, "schema", trace.trace_schema_id);
-  detail::write_text_kv(out, "source_experiment_artifact_schema_id",
-                        trace.source_experiment_artifact_schema_id);
-  detail::write_text_kv(out, "future_consumer", trace.future_consumer);
-  detail::write_text_kv(out, "experiment_id", trace.experiment_id);
-  detail::write_text_kv(out, "runtime_run_id", trace.runtime_run_id);
-  detail::write_text_kv(out, "environment_run_id", trace.environment_run_id);
-  detail::write_integral_kv(out, "requested_max_parallel_jobs",
-                            trace.requested_max_parallel_jobs);
-  detail::write_integral_kv(out, "resolved_parallelism",
-                            trace.resolved_parallelism);
-  detail::write_integral_kv(out, "attempted_count", trace.attempted_count);
-  detail::write_integral_kv(out, "completed_count", trace.completed_count);
-  detail::write_integral_kv(out, "episode_count", trace.episodes.size());
-  detail::write_integral_kv(out, "policy_comparison_count",
-                            trace.policy_comparisons.size());
-  detail::write_string_vector(out, "warning_", trace.warnings);
-  detail::write_string_vector(out, "failure_", trace.failures);
-
-  for (std::size_t i = 0; i < trace.episodes.size(); ++i) {
-    detail::write_episode_trace(out, "episode_" + std::to_string(i) + "_",
-                                trace.episodes[i]);
-  }
-  for (std::size_t i = 0; i < trace.policy_comparisons.size(); ++i) {
-    detail::write_policy_comparison_record(
-        out, "policy_comparison_" + std::to_string(i) + "_",
-        trace.policy_comparisons[i]);
-  }
+  detail::write_experience_trace_kv(out, trace);
   if (!out) {
     throw std::runtime_error("[experience_trace] failed while writing " +
                              path.string());
@@ -1598,39 +1674,7 @@ read_experience_trace_report(const std::filesystem::path &path) {
     throw std::runtime_error("[experience_trace] failed to open report path " +
                              path.string());
   }
-  const auto values = detail::parse_kv_stream(in);
-
-  experience_trace_t trace{};
-  trace.trace_schema_id = detail::read_text(values, "schema");
-  trace.source_experiment_artifact_schema_id =
-      detail::read_text(values, "source_experiment_artifact_schema_id");
-  trace.future_consumer = detail::read_text(values, "future_consumer");
-  trace.experiment_id = detail::read_text(values, "experiment_id");
-  trace.runtime_run_id = detail::read_text(values, "runtime_run_id");
-  trace.environment_run_id = detail::read_text(values, "environment_run_id");
-  trace.requested_max_parallel_jobs =
-      detail::read_size(values, "requested_max_parallel_jobs");
-  trace.resolved_parallelism =
-      detail::read_size(values, "resolved_parallelism");
-  trace.attempted_count = detail::read_u64(values, "attempted_count");
-  trace.completed_count = detail::read_u64(values, "completed_count");
-  const auto episode_count = detail::read_size(values, "episode_count");
-  const auto policy_comparison_count =
-      detail::read_size(values, "policy_comparison_count");
-  trace.warnings = detail::read_string_vector(values, "warning_");
-  trace.failures = detail::read_string_vector(values, "failure_");
-
-  trace.episodes.reserve(episode_count);
-  for (std::size_t i = 0; i < episode_count; ++i) {
-    trace.episodes.push_back(detail::read_episode_trace(
-        values, "episode_" + std::to_string(i) + "_"));
-  }
-  trace.policy_comparisons.reserve(policy_comparison_count);
-  for (std::size_t i = 0; i < policy_comparison_count; ++i) {
-    trace.policy_comparisons.push_back(detail::read_policy_comparison_record(
-        values, "policy_comparison_" + std::to_string(i) + "_"));
-  }
-
+  auto trace = detail::read_experience_trace_kv(detail::parse_kv_stream(in));
   validate_experience_trace(trace);
   return trace;
 }
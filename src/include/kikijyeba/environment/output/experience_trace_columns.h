@@ -0,0 +1,1060 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <torch/torch.h>
+
+#include "kikijyeba/environment/output/experience_trace.h"
+#include "piaabo/io/mapped_file.h"
+
+// Columnar binary form of an experience trace.
+//
+// This is the primary on-disk trace format. Transitions are stored as one
+// fixed-width column per transition_record_t field, in episode order, behind a
+// small header. Numeric fields are copied straight from the records; text
+// fields are dictionary-coded (u32 codes plus a per-column string table).
+// Bound policy-input payloads are stored as dense numbers, per-row offsets
+// plus float64 (int64 for the executable mask) values, whenever the values
+// print back to the binder's text; a payload column that does not falls back
+// to a text column. Experiment, episode and policy-comparison keys are kept as
+// the text key-value block of experience_trace.h. The file is memory-mapped on
+// read and numeric columns, dense payloads included, are returned as tensors
+// that alias the mapping. The text report is the export and canonical-digest
+// view: both formats must produce the same experience_trace_canonical_text().
+
+namespace cuwacunu::kikijyeba::environment::output {
+
+inline constexpr const char *kExperienceTraceColumnsSchema =
+    "kikijyeba.environment.output.experience_trace_columns.v3";
+
+namespace experience_trace_columns_detail {
+
+inline constexpr std::array<char, 8> kMagic{'C', 'W', 'X', 'T',
+                                            'R', 'C', '0', '1'};
+inline constexpr std::uint32_t kVersion = 3;
+inline constexpr std::uint64_t kDataAlignment = 64;
+inline constexpr std::size_t kColumnNameBytes = 56;
+
+enum class column_kind_t : std::uint32_t {
+  f64 = 1,
+  i64 = 2,
+  u64 = 3,
+  bool8 = 4,
+  text = 5,
+  f64_rows = 6,
+  i64_rows = 7,
+};
+
+struct file_header_t {
+  std::array<char, 8> magic{kMagic};
+  std::uint32_t version{kVersion};
+  std::uint32_t column_count{0};
+  std::uint64_t row_count{0};
+  std::uint64_t episode_count{0};
+  std::uint64_t meta_offset{0};
+  std::uint64_t meta_bytes{0};
+  std::uint64_t directory_offset{0};
+  std::uint64_t reserved{0};
+};
+static_assert(sizeof(file_header_t) == 64);
+
+// Text columns store u32 codes at `offset`; their dictionary at
+// `dictionary_offset` is `dictionary_count + 1` u64 end offsets followed by
+// the concatenated string bytes. Row columns (f64_rows, i64_rows) store
+// `row_count + 1` u64 end offsets at `offset` and their `dictionary_count`
+// 8-byte values at `dictionary_offset`.
+struct column_entry_t {
+  std::array<char, kColumnNameBytes> name{};
+  std::uint32_t kind{0};
+  std::uint32_t reserved_flags{0};
+  std::array<std::uint64_t, 4> reserved{};
+  std::uint64_t offset{0};
+  std::uint64_t bytes{0};
+  std::uint64_t dictionary_offset{0};
+  std::uint64_t dictionary_count{0};
+};
+static_assert(sizeof(column_entry_t) == 128);
+
+template <typename T> struct member_column_t {
+  const char *name;
+  T transition_record_t::*member;
+};
+
+inline constexpr std::array<member_column_t<double>, 37>
+    kDoubleColumns{{
+        {"old_log_prob", &transition_record_t::old_log_prob},
+        {"old_entropy", &transition_record_t::old_entropy},
+        {"old_value_estimate", &transition_record_t::old_value_estimate},
+        {"target_numeraire_weight",
+         &transition_record_t::target_numeraire_weight},
+        {"fill_gross_notional_numeraire",
+         &transition_record_t::fill_gross_notional_numeraire},
+        {"fill_fee_numeraire", &transition_record_t::fill_fee_numeraire},
+        {"cajtucu_requested_notional_numeraire",
+         &transition_record_t::cajtucu_requested_notional_numeraire},
+        {"cajtucu_executed_notional_numeraire",
+         &transition_record_t::cajtucu_executed_notional_numeraire},
+        {"cajtucu_rejected_notional_numeraire",
+         &transition_record_t::cajtucu_rejected_notional_numeraire},
+        {"cajtucu_partial_notional_numeraire",
+         &transition_record_t::cajtucu_partial_notional_numeraire},
+        {"cajtucu_fill_ratio", &transition_record_t::cajtucu_fill_ratio},
+        {"cajtucu_total_fee_numeraire",
+         &transition_record_t::cajtucu_total_fee_numeraire},
+        {"cajtucu_total_spread_cost_numeraire",
+         &transition_record_t::cajtucu_total_spread_cost_numeraire},
+        {"cajtucu_total_slippage_numeraire",
+         &transition_record_t::cajtucu_total_slippage_numeraire},
+        {"cajtucu_total_transaction_cost_numeraire",
+         &transition_record_t::cajtucu_total_transaction_cost_numeraire},
+        {"target_weight_error_l1",
+         &transition_record_t::target_weight_error_l1},
+        {"target_weight_error_linf",
+         &transition_record_t::target_weight_error_linf},
+        {"portfolio_equity_before",
+         &transition_record_t::portfolio_equity_before},
+        {"portfolio_equity_after",
+         &transition_record_t::portfolio_equity_after},
+        {"realized_log_growth", &transition_record_t::realized_log_growth},
+        {"realized_arithmetic_return",
+         &transition_record_t::realized_arithmetic_return},
+        {"transaction_cost_numeraire",
+         &transition_record_t::transaction_cost_numeraire},
+        {"turnover", &transition_record_t::turnover},
+        {"reward_log_growth", &transition_record_t::reward_log_growth},
+        {"reward_drawdown_penalty",
+         &transition_record_t::reward_drawdown_penalty},
+        {"reward_transaction_cost_penalty",
+         &transition_record_t::reward_transaction_cost_penalty},
+        {"reward_turnover_penalty",
+         &transition_record_t::reward_turnover_penalty},
+        {"reward_invalid_action_penalty",
+         &transition_record_t::reward_invalid_action_penalty},
+        {"reward_total", &transition_record_t::reward_total},
+        {"projection_mae", &transition_record_t::projection_mae},
+        {"projection_rmse", &transition_record_t::projection_rmse},
+        {"projection_signed_bias",
+         &transition_record_t::projection_signed_bias},
+        {"projection_correlation",
+         &transition_record_t::projection_correlation},
+        {"projection_directional_accuracy",
+         &transition_record_t::projection_directional_accuracy},
+        {"projection_interval_coverage",
+         &transition_record_t::projection_interval_coverage},
+        {"residual_mean_residual_energy",
+         &transition_record_t::residual_mean_residual_energy},
+        {"residual_max_residual_energy",
+         &transition_record_t::residual_max_residual_energy},
+    }};
+inline constexpr std::array<member_column_t<std::int64_t>, 6>
+    kInt64Columns{{
+        {"observation_anchor_index",
+         &transition_record_t::observation_anchor_index},
+        {"next_realization_anchor_index",
+         &transition_record_t::next_realization_anchor_index},
+        {"knowledge_timestamp_ms",
+         &transition_record_t::knowledge_timestamp_ms},
+        {"realization_available_after_timestamp_ms",
+         &transition_record_t::realization_available_after_timestamp_ms},
+        {"action_decision_timestamp_ms",
+         &transition_record_t::action_decision_timestamp_ms},
+        {"active_count", &transition_record_t::active_count},
+    }};
+inline constexpr std::array<member_column_t<std::uint64_t>, 21>
+    kUInt64Columns{{
+        {"step_index", &transition_record_t::step_index},
+        {"rebalance_order_count", &transition_record_t::rebalance_order_count},
+        {"rebalance_skipped_count",
+         &transition_record_t::rebalance_skipped_count},
+        {"fill_count", &transition_record_t::fill_count},
+        {"cajtucu_failure_count", &transition_record_t::cajtucu_failure_count},
+        {"cajtucu_order_count", &transition_record_t::cajtucu_order_count},
+        {"cajtucu_executed_order_count",
+         &transition_record_t::cajtucu_executed_order_count},
+        {"cajtucu_fill_count", &transition_record_t::cajtucu_fill_count},
+        {"cajtucu_rejected_fill_count",
+         &transition_record_t::cajtucu_rejected_fill_count},
+        {"cajtucu_partial_fill_count",
+         &transition_record_t::cajtucu_partial_fill_count},
+        {"cajtucu_missing_direct_pair_count",
+         &transition_record_t::cajtucu_missing_direct_pair_count},
+        {"cajtucu_numeraire_fallback_pair_count",
+         &transition_record_t::cajtucu_numeraire_fallback_pair_count},
+        {"cajtucu_nontradable_edge_reject_count",
+         &transition_record_t::cajtucu_nontradable_edge_reject_count},
+        {"cajtucu_below_min_notional_reject_count",
+         &transition_record_t::cajtucu_below_min_notional_reject_count},
+        {"cajtucu_above_max_notional_reject_count",
+         &transition_record_t::cajtucu_above_max_notional_reject_count},
+        {"cajtucu_insufficient_sell_units_reject_count",
+         &transition_record_t::cajtucu_insufficient_sell_units_reject_count},
+        {"cajtucu_insufficient_units_reject_count",
+         &transition_record_t::cajtucu_insufficient_units_reject_count},
+        {"cajtucu_invalid_sell_price_count",
+         &transition_record_t::cajtucu_invalid_sell_price_count},
+        {"cajtucu_large_equity_mismatch_count",
+         &transition_record_t::cajtucu_large_equity_mismatch_count},
+        {"warning_count", &transition_record_t::warning_count},
+        {"failure_count", &transition_record_t::failure_count},
+    }};
+inline constexpr std::array<member_column_t<bool>, 13>
+    kBoolColumns{{
+        {"time_law_clean", &transition_record_t::time_law_clean},
+        {"action_distribution_evidence_bound",
+         &transition_record_t::action_distribution_evidence_bound},
+        {"policy_input_tensor_payload_bound",
+         &transition_record_t::policy_input_tensor_payload_bound},
+        {"rebalance_plan_enforced",
+         &transition_record_t::rebalance_plan_enforced},
+        {"cajtucu_execution_trace_available",
+         &transition_record_t::cajtucu_execution_trace_available},
+        {"cajtucu_trace_valid", &transition_record_t::cajtucu_trace_valid},
+        {"invalid_action", &transition_record_t::invalid_action},
+        {"projection_validation_available",
+         &transition_record_t::projection_validation_available},
+        {"residual_quality_available",
+         &transition_record_t::residual_quality_available},
+        {"residual_quality_valid",
+         &transition_record_t::residual_quality_valid},
+        {"risk_gate_evaluated", &transition_record_t::risk_gate_evaluated},
+        {"risk_gate_allow_trading",
+         &transition_record_t::risk_gate_allow_trading},
+        {"risk_gate_force_numeraire_fallback",
+         &transition_record_t::risk_gate_force_numeraire_fallback},
+    }};
+inline constexpr std::array<member_column_t<std::string>, 29>
+    kTextColumns{{
+        {"schema", &transition_record_t::trace_schema_id},
+        {"source_step_artifact_schema_id",
+         &transition_record_t::source_step_artifact_schema_id},
+        {"episode_id", &transition_record_t::episode_id},
+        {"protocol_id", &transition_record_t::protocol_id},
+        {"runtime_run_id", &transition_record_t::runtime_run_id},
+        {"environment_run_id", &transition_record_t::environment_run_id},
+        {"anchor_key", &transition_record_t::anchor_key},
+        {"policy_id", &transition_record_t::policy_id},
+        {"method_id", &transition_record_t::method_id},
+        {"policy_action_mode", &transition_record_t::policy_action_mode},
+        {"action_schema_id", &transition_record_t::action_schema_id},
+        {"policy_input_schema_id",
+         &transition_record_t::policy_input_schema_id},
+        {"action_adapter_id", &transition_record_t::action_adapter_id},
+        {"action_distribution_id",
+         &transition_record_t::action_distribution_id},
+        {"policy_input_digest", &transition_record_t::policy_input_digest},
+        {"active_node_indices", &transition_record_t::active_node_indices},
+        {"policy_input_tensor_payload_schema_id",
+         &transition_record_t::policy_input_tensor_payload_schema_id},
+        {"policy_input_node_features_shape",
+         &transition_record_t::policy_input_node_features_shape},
+        {"policy_input_global_features_shape",
+         &transition_record_t::policy_input_global_features_shape},
+        {"policy_input_risk_features_shape",
+         &transition_record_t::policy_input_risk_features_shape},
+        {"policy_input_executable_mask_shape",
+         &transition_record_t::policy_input_executable_mask_shape},
+        {"target_node_weights", &transition_record_t::target_node_weights},
+        {"accounting_numeraire_node_id",
+         &transition_record_t::accounting_numeraire_node_id},
+        {"execution_model", &transition_record_t::execution_model},
+        {"rebalance_plan_source", &transition_record_t::rebalance_plan_source},
+        {"cajtucu_backend_id", &transition_record_t::cajtucu_backend_id},
+        {"cajtucu_trace_id", &transition_record_t::cajtucu_trace_id},
+        {"warnings", &transition_record_t::warnings},
+        {"failures", &transition_record_t::failures},
+    }};
+
+struct payload_column_t {
+  const char *name;
+  std::string transition_record_t::*member;
+  column_kind_t kind;
+};
+
+// Bound policy-input payloads; payload_tensor() reads each against its
+// "<name>_shape" text column.
+inline constexpr std::array<payload_column_t, 4> kTensorPayloadColumns{{
+    {"policy_input_node_features",
+     &transition_record_t::policy_input_node_features, column_kind_t::f64_rows},
+    {"policy_input_global_features",
+     &transition_record_t::policy_input_global_features,
+     column_kind_t::f64_rows},
+    {"policy_input_risk_features",
+     &transition_record_t::policy_input_risk_features, column_kind_t::f64_rows},
+    {"policy_input_executable_mask",
+     &transition_record_t::policy_input_executable_mask,
+     column_kind_t::i64_rows},
+}};
+
+// Column names in write order. Together they must cover every key
+// detail::write_transition_record emits; the environment contract test checks
+// that, so a field added to transition_record_t without a column fails there.
+[[nodiscard]] inline std::vector<std::string> transition_column_names() {
+  std::vector<std::string> out;
+  const auto add = [&out](const auto &table) {
+    for (const auto &spec : table) {
+      out.emplace_back(spec.name);
+    }
+  };
+  add(kDoubleColumns);
+  add(kInt64Columns);
+  add(kUInt64Columns);
+  add(kBoolColumns);
+  add(kTextColumns);
+  out.emplace_back("policy_kind");
+  out.emplace_back("world_mode");
+  add(kTensorPayloadColumns);
+  return out;
+}
+
+// Comma-separated numbers, as written by the policy-input payload binder.
+template <typename T>
+[[nodiscard]] inline bool parse_csv_numbers(std::string_view text,
+                                            std::vector<T> &out) {
+  out.clear();
+  const char *cursor = text.data();
+  const char *const end = text.data() + text.size();
+  while (true) {
+    T value{};
+    const auto [next, ec] = std::from_chars(cursor, end, value);
+    if (ec != std::errc{}) {
+      return false;
+    }
+    out.push_back(value);
+    if (next == end) {
+      return true;
+    }
+    if (*next != ',') {
+      return false;
+    }
+    cursor = next + 1;
+  }
+}
+
+// Appends `values` as the policy-input payload binder prints them
+// (`tensor_flat_values_csv`: "%.17g", comma-separated). Integers print as
+// plain decimals, which is what the binder emits for an integral mask.
+template <typename T>
+inline void append_csv_numbers(std::string &out, const T *values,
+                               std::size_t count) {
+  std::array<char, 32> buffer{};
+  char *const first = buffer.data();
+  char *const last = buffer.data() + buffer.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i != 0) {
+      out.push_back(',');
+    }
+    std::to_chars_result printed{};
+    if constexpr (std::is_floating_point_v<T>) {
+      printed = std::to_chars(first, last, values[i],
+                              std::chars_format::general, 17);
+    } else {
+      printed = std::to_chars(first, last, values[i]);
+    }
+    out.append(first, printed.ptr);
+  }
+}
+
+[[nodiscard]] inline bool is_row_kind(column_kind_t kind) {
+  return kind == column_kind_t::f64_rows || kind == column_kind_t::i64_rows;
+}
+
+[[nodiscard]] inline std::uint64_t align_up(std::uint64_t value) {
+  return (value + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+[[nodiscard]] inline std::string column_name(const column_entry_t &entry) {
+  const auto end = std::find(entry.name.begin(), entry.name.end(), '\0');
+  return std::string(entry.name.begin(), end);
+}
+
+[[nodiscard]] inline std::uint64_t element_bytes(column_kind_t kind) {
+  switch (kind) {
+  case column_kind_t::f64:
+  case column_kind_t::i64:
+  case column_kind_t::u64:
+  case column_kind_t::f64_rows:
+  case column_kind_t::i64_rows:
+    return 8;
+  case column_kind_t::bool8:
+    return 1;
+  case column_kind_t::text:
+    return 4;
+  }
+  return 0;
+}
+
+struct column_build_t {
+  column_entry_t entry{};
+  std::vector<std::uint8_t> data{};
+  std::vector<std::uint8_t> dictionary{};
+};
+
+template <typename T>
+inline void append_pod(std::vector<std::uint8_t> &out, const T &value) {
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+[[nodiscard]] inline column_build_t make_entry(const std::string &name,
+                                               column_kind_t kind) {
+  if (name.size() >= kColumnNameBytes) {
+    throw std::runtime_error("[experience_trace] column name too long: " +
+                             name);
+  }
+  column_build_t column{};
+  std::memcpy(column.entry.name.data(), name.data(), name.size());
+  column.entry.kind = static_cast<std::uint32_t>(kind);
+  return column;
+}
+
+// u64 columns are read back as kInt64 tensors, so values that do not fit are
+// rejected here instead of wrapping negative.
+template <typename Stored, typename T>
+[[nodiscard]] inline column_build_t
+make_numeric_column(const member_column_t<T> &spec, column_kind_t kind,
+                    const std::vector<const transition_record_t *> &rows) {
+  auto column = make_entry(spec.name, kind);
+  column.data.reserve(rows.size() * sizeof(Stored));
+  for (const auto *row : rows) {
+    if constexpr (std::is_same_v<T, std::uint64_t>) {
+      constexpr auto kInt64Max =
+          static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+      if (row->*spec.member > kInt64Max) {
+        throw std::runtime_error("[experience_trace] column " +
+                                 std::string(spec.name) +
+                                 " exceeds INT64_MAX");
+      }
+    }
+    append_pod(column.data, static_cast<Stored>(row->*spec.member));
+  }
+  return column;
+}
+
+template <typename Get>
+[[nodiscard]] inline column_build_t
+make_text_column(const std::string &name,
+                 const std::vector<const transition_record_t *> &rows,
+                 Get &&get) {
+  auto column = make_entry(name, column_kind_t::text);
+  std::unordered_map<std::string_view, std::uint32_t> codes;
+  std::vector<std::string_view> dictionary;
+  column.data.reserve(rows.size() * sizeof(std::uint32_t));
+  for (const auto *row : rows) {
+    const std::string_view value = get(*row);
+    auto it = codes.find(value);
+    if (it == codes.end()) {
+      it = codes
+               .emplace(value, static_cast<std::uint32_t>(dictionary.size()))
+               .first;
+      dictionary.push_back(value);
+    }
+    append_pod(column.data, it->second);
+  }
+  std::uint64_t end = 0;
+  append_pod(column.dictionary, end);
+  for (const auto value : dictionary) {
+    end += value.size();
+    append_pod(column.dictionary, end);
+  }
+  for (const auto value : dictionary) {
+    column.dictionary.insert(column.dictionary.end(), value.begin(),
+                             value.end());
+  }
+  column.entry.dictionary_count = dictionary.size();
+  return column;
+}
+
+// Dense form of a payload column: every row's text is parsed and must print
+// back to itself, so load() can rebuild the record text exactly. Rows without
+// a bound payload are empty ranges.
+template <typename T>
+[[nodiscard]] inline std::optional<column_build_t>
+try_make_payload_column(const payload_column_t &spec,
+                        const std::vector<const transition_record_t *> &rows) {
+  auto column = make_entry(spec.name, spec.kind);
+  column.data.reserve((rows.size() + 1) * sizeof(std::uint64_t));
+  std::uint64_t end = 0;
+  append_pod(column.data, end);
+  std::vector<T> values;
+  std::string printed;
+  for (const auto *row : rows) {
+    const std::string &text = row->*spec.member;
+    values.clear();
+    if (!text.empty()) {
+      if (!parse_csv_numbers(text, values)) {
+        return std::nullopt;
+      }
+      printed.clear();
+      append_csv_numbers(printed, values.data(), values.size());
+      if (printed != text) {
+        return std::nullopt;
+      }
+    }
+    for (const auto value : values) {
+      append_pod(column.dictionary, value);
+    }
+    end += values.size();
+    append_pod(column.data, end);
+  }
+  column.entry.dictionary_count = end;
+  return column;
+}
+
+inline void write_padding(std::ostream &out, std::uint64_t from,
+                          std::uint64_t to) {
+  static constexpr std::array<char, kDataAlignment> zeros{};
+  if (to > from) {
+    out.write(zeros.data(), static_cast<std::streamsize>(to - from));
+  }
+}
+
+} // namespace experience_trace_columns_detail
+
+// Writes the columnar form of `trace` to `path` (via a temporary file and
+// rename, so readers never see a partial store).
+inline void write_experience_trace_columns(const experience_trace_t &trace,
+                                           const std::filesystem::path &path) {
+  namespace d = experience_trace_columns_detail;
+  if (path.empty()) {
+    throw std::runtime_error("[experience_trace] columnar path is required");
+  }
+  validate_experience_trace(trace);
+
+  std::vector<const transition_record_t *> rows;
+  for (const auto &episode : trace.episodes) {
+    for (const auto &transition : episode.transitions) {
+      rows.push_back(&transition);
+    }
+  }
+
+  std::vector<d::column_build_t> columns;
+  for (const auto &spec : d::kDoubleColumns) {
+    columns.push_back(
+        d::make_numeric_column<double>(spec, d::column_kind_t::f64, rows));
+  }
+  for (const auto &spec : d::kInt64Columns) {
+    columns.push_back(d::make_numeric_column<std::int64_t>(
+        spec, d::column_kind_t::i64, rows));
+  }
+  for (const auto &spec : d::kUInt64Columns) {
+    columns.push_back(d::make_numeric_column<std::uint64_t>(
+        spec, d::column_kind_t::u64, rows));
+  }
+  for (const auto &spec : d::kBoolColumns) {
+    columns.push_back(d::make_numeric_column<std::uint8_t>(
+        spec, d::column_kind_t::bool8, rows));
+  }
+  for (const auto &spec : d::kTextColumns) {
+    columns.push_back(d::make_text_column(
+        spec.name, rows, [&spec](const transition_record_t &row) {
+          return std::string_view(row.*spec.member);
+        }));
+  }
+  columns.push_back(d::make_text_column(
+      "policy_kind", rows, [](const transition_record_t &row) {
+        return std::string_view(policy_kind_name(row.policy_kind));
+      }));
+  columns.push_back(d::make_text_column(
+      "world_mode", rows, [](const transition_record_t &row) {
+        return std::string_view(world_mode_name(row.world_mode));
+      }));
+  for (const auto &spec : d::kTensorPayloadColumns) {
+    auto dense = spec.kind == d::column_kind_t::f64_rows
+                     ? d::try_make_payload_column<double>(spec, rows)
+                     : d::try_make_payload_column<std::int64_t>(spec, rows);
+    columns.push_back(dense.has_value()
+                          ? std::move(*dense)
+                          : d::make_text_column(
+                                spec.name, rows,
+                                [&spec](const transition_record_t &row) {
+                                  return std::string_view(row.*spec.member);
+                                }));
+  }
+
+  std::ostringstream meta_stream;
+  detail::write_experience_trace_kv(meta_stream, trace,
+                                    /*include_transitions=*/false);
+  const auto meta = meta_stream.str();
+
+  d::file_header_t header{};
+  header.column_count = static_cast<std::uint32_t>(columns.size());
+  header.row_count = rows.size();
+  header.episode_count = trace.episodes.size();
+  header.meta_offset = sizeof(d::file_header_t);
+  header.meta_bytes = meta.size();
+  header.directory_offset = d::align_up(header.meta_offset + meta.size());
+  std::uint64_t cursor = d::align_up(
+      header.directory_offset + columns.size() * sizeof(d::column_entry_t));
+  for (auto &column : columns) {
+    column.entry.offset = cursor;
+    column.entry.bytes = column.data.size();
+    cursor = d::align_up(cursor + column.data.size());
+    if (!column.dictionary.empty()) {
+      column.entry.dictionary_offset = cursor;
+      cursor = d::align_up(cursor + column.dictionary.size());
+    }
+  }
+
+  auto tmp = path;
+  tmp += ".tmp." + std::to_string(::getpid());
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error(
+          "[experience_trace] failed to open columnar path " + tmp.string());
+    }
+    std::uint64_t written = 0;
+    const auto put = [&](const void *data, std::uint64_t bytes) {
+      out.write(static_cast<const char *>(data),
+                static_cast<std::streamsize>(bytes));
+      written += bytes;
+    };
+    const auto pad_to = [&](std::uint64_t offset) {
+      d::write_padding(out, written, offset);
+      written = offset;
+    };
+    put(&header, sizeof(header));
+    put(meta.data(), meta.size());
+    pad_to(header.directory_offset);
+    for (const auto &column : columns) {
+      put(&column.entry, sizeof(column.entry));
+    }
+    for (const auto &column : columns) {
+      pad_to(column.entry.offset);
+      put(column.data.data(), column.data.size());
+      if (!column.dictionary.empty()) {
+        pad_to(column.entry.dictionary_offset);
+        put(column.dictionary.data(), column.dictionary.size());
+      }
+    }
+    pad_to(cursor);
+    if (!out) {
+      throw std::runtime_error("[experience_trace] failed while writing " +
+                               tmp.string());
+    }
+  }
+  std::filesystem::rename(tmp, path);
+}
+
+// Memory-mapped reader over a columnar trace. Numeric columns are exposed as
+// `[T]` CPU tensors aliasing the copy-on-write mapping; load() rebuilds the
+// full experience_trace_t.
+class experience_trace_columns_t {
+public:
+  explicit experience_trace_columns_t(const std::filesystem::path &path)
+      : file_(std::make_shared<cuwacunu::piaabo::io::mapped_file_t>(path)) {
+    namespace d = experience_trace_columns_detail;
+    if (file_->size() < sizeof(header_)) {
+      throw std::runtime_error(
+          "[experience_trace] columnar trace is truncated: " + path.string());
+    }
+    std::memcpy(&header_, file_->data(), sizeof(header_));
+    if (header_.magic != d::kMagic || header_.version != d::kVersion) {
+      throw std::runtime_error(
+          "[experience_trace] columnar trace has an unsupported header: " +
+          path.string());
+    }
+    const auto directory_bytes =
+        static_cast<std::uint64_t>(header_.column_count) *
+        sizeof(d::column_entry_t);
+    if (!file_->contains(header_.meta_offset, header_.meta_bytes) ||
+        header_.directory_offset % d::kDataAlignment != 0 ||
+        !file_->contains(header_.directory_offset, directory_bytes)) {
+      throw std::runtime_error(
+          "[experience_trace] columnar trace layout is out of bounds: " +
+          path.string());
+    }
+
+    std::istringstream meta(std::string(
+        reinterpret_cast<const char *>(file_->data() + header_.meta_offset),
+        header_.meta_bytes));
+    meta_ = detail::read_experience_trace_kv(detail::parse_kv_stream(meta),
+                                             /*include_transitions=*/false);
+    std::uint64_t transition_total = 0;
+    episode_row_offsets_.push_back(0);
+    for (const auto &episode : meta_.episodes) {
+      transition_total += episode.transition_count;
+      episode_row_offsets_.push_back(transition_total);
+    }
+    if (meta_.episodes.size() != header_.episode_count ||
+        transition_total != header_.row_count) {
+      throw std::runtime_error(
+          "[experience_trace] columnar trace row count does not match its "
+          "episodes: " +
+          path.string());
+    }
+
+    columns_.resize(header_.column_count);
+    std::memcpy(columns_.data(), file_->data() + header_.directory_offset,
+                directory_bytes);
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+      const auto &entry = columns_[i];
+      const auto name = d::column_name(entry);
+      const auto kind = static_cast<d::column_kind_t>(entry.kind);
+      const auto width = d::element_bytes(kind);
+      const auto slots = header_.row_count + (d::is_row_kind(kind) ? 1 : 0);
+      if (width == 0 || entry.reserved_flags != 0 ||
+          entry.bytes != slots * width ||
+          entry.offset % d::kDataAlignment != 0 ||
+          !file_->contains(entry.offset, entry.bytes)) {
+        throw std::runtime_error("[experience_trace] columnar trace column " +
+                                 name + " is malformed");
+      }
+      if (d::is_row_kind(kind)) {
+        validate_row_offsets(entry, name);
+      }
+      if (kind == d::column_kind_t::text) {
+        const auto table_bytes = (entry.dictionary_count + 1) * 8;
+        if (entry.dictionary_offset % d::kDataAlignment != 0 ||
+            !file_->contains(entry.dictionary_offset, table_bytes)) {
+          throw std::runtime_error(
+              "[experience_trace] columnar trace dictionary for " + name +
+              " is malformed");
+        }
+      }
+      if (!index_.emplace(name, i).second) {
+        throw std::runtime_error(
+            "[experience_trace] columnar trace repeats column " + name);
+      }
+    }
+  }
+
+  [[nodiscard]] std::uint64_t row_count() const { return header_.row_count; }
+
+  // Row range of episode i is [offsets[i], offsets[i + 1]).
+  [[nodiscard]] const std::vector<std::uint64_t> &episode_row_offsets() const {
+    return episode_row_offsets_;
+  }
+
+  [[nodiscard]] bool has_column(const std::string &name) const {
+    return index_.count(name) != 0;
+  }
+
+  [[nodiscard]] std::vector<std::string> column_names() const {
+    std::vector<std::string> out;
+    out.reserve(columns_.size());
+    for (const auto &entry : columns_) {
+      out.push_back(experience_trace_columns_detail::column_name(entry));
+    }
+    return out;
+  }
+
+  // f64 -> kFloat64, i64/u64 -> kInt64 (the writer rejects u64 values above
+  // INT64_MAX), bool -> kBool, text -> kInt32 dictionary codes.
+  [[nodiscard]] ::torch::Tensor tensor(const std::string &name) const {
+    namespace d = experience_trace_columns_detail;
+    const auto &entry = column(name);
+    const std::vector<std::int64_t> sizes{
+        static_cast<std::int64_t>(header_.row_count)};
+    ::torch::Dtype dtype = ::torch::kFloat64;
+    switch (static_cast<d::column_kind_t>(entry.kind)) {
+    case d::column_kind_t::f64:
+      break;
+    case d::column_kind_t::i64:
+    case d::column_kind_t::u64:
+      dtype = ::torch::kInt64;
+      break;
+    case d::column_kind_t::bool8:
+      dtype = ::torch::kBool;
+      break;
+    case d::column_kind_t::text:
+      dtype = ::torch::kInt32;
+      break;
+    case d::column_kind_t::f64_rows:
+    case d::column_kind_t::i64_rows:
+      throw std::runtime_error("[experience_trace] column " + name +
+                               " holds per-row payloads; use payload_tensor");
+    }
+    const auto options = ::torch::TensorOptions().dtype(dtype);
+    if (header_.row_count == 0) {
+      return ::torch::empty(sizes, options);
+    }
+    auto keep_alive = file_;
+    return ::torch::from_blob(
+        file_->data() + entry.offset, sizes,
+        [keep_alive](void *) mutable { keep_alive.reset(); }, options);
+  }
+
+  // Decoded string table of a text column; tensor(name) holds its codes.
+  [[nodiscard]] std::vector<std::string>
+  text_dictionary(const std::string &name) const {
+    namespace d = experience_trace_columns_detail;
+    const auto &entry = column(name);
+    if (static_cast<d::column_kind_t>(entry.kind) != d::column_kind_t::text) {
+      throw std::runtime_error("[experience_trace] column " + name +
+                               " is not a text column");
+    }
+    const auto *base = file_->data() + entry.dictionary_offset;
+    const auto blob_offset =
+        entry.dictionary_offset + (entry.dictionary_count + 1) * 8;
+    std::vector<std::uint64_t> ends(entry.dictionary_count + 1);
+    std::memcpy(ends.data(), base, ends.size() * 8);
+    if (ends.front() != 0 ||
+        !file_->contains(blob_offset, ends.back())) {
+      throw std::runtime_error("[experience_trace] columnar trace dictionary "
+                               "for " +
+                               name + " is malformed");
+    }
+    std::vector<std::string> out;
+    out.reserve(entry.dictionary_count);
+    const auto *blob =
+        reinterpret_cast<const char *>(file_->data() + blob_offset);
+    for (std::uint64_t i = 0; i < entry.dictionary_count; ++i) {
+      if (ends[i + 1] < ends[i] || ends[i + 1] > ends.back()) {
+        throw std::runtime_error("[experience_trace] columnar trace "
+                                 "dictionary for " +
+                                 name + " is malformed");
+      }
+      out.emplace_back(blob + ends[i], ends[i + 1] - ends[i]);
+    }
+    return out;
+  }
+
+  // A bound policy-input payload column (e.g. "policy_input_node_features")
+  // as `[T, ...]`. Dense columns alias the mapping (kFloat64, or kInt64 for
+  // the executable mask); a column stored as text is parsed into kFloat64.
+  // Every row must carry a payload of the one shape recorded in its
+  // "<name>_shape" column.
+  [[nodiscard]] ::torch::Tensor payload_tensor(const std::string &name) const {
+    namespace d = experience_trace_columns_detail;
+    if (header_.row_count == 0) {
+      return ::torch::empty({0}, ::torch::kFloat64);
+    }
+    const auto shape_dictionary = text_dictionary(name + "_shape");
+    std::vector<std::int64_t> row_shape;
+    if (shape_dictionary.size() != 1 ||
+        (!shape_dictionary.front().empty() &&
+         !d::parse_csv_numbers(shape_dictionary.front(), row_shape))) {
+      throw std::runtime_error("[experience_trace] payload column " + name +
+                               " does not have one shape across rows");
+    }
+    std::int64_t numel = 1;
+    for (const auto dim : row_shape) {
+      numel *= dim;
+    }
+    std::vector<std::int64_t> sizes{
+        static_cast<std::int64_t>(header_.row_count)};
+    sizes.insert(sizes.end(), row_shape.begin(), row_shape.end());
+    const auto &entry = column(name);
+    const auto kind = static_cast<d::column_kind_t>(entry.kind);
+    const auto mismatch = [&name] {
+      return std::runtime_error("[experience_trace] payload column " + name +
+                                " has a row that does not match its shape");
+    };
+    if (d::is_row_kind(kind)) {
+      const auto ends = row_ends(entry);
+      for (std::uint64_t i = 0; i < header_.row_count; ++i) {
+        if (ends[i + 1] - ends[i] != static_cast<std::uint64_t>(numel)) {
+          throw mismatch();
+        }
+      }
+      const auto options = ::torch::TensorOptions().dtype(
+          kind == d::column_kind_t::f64_rows ? ::torch::kFloat64
+                                             : ::torch::kInt64);
+      if (entry.dictionary_count == 0) {
+        return ::torch::empty(sizes, options);
+      }
+      auto keep_alive = file_;
+      return ::torch::from_blob(
+          file_->data() + entry.dictionary_offset, sizes,
+          [keep_alive](void *) mutable { keep_alive.reset(); }, options);
+    }
+    auto out = ::torch::empty(sizes, ::torch::kFloat64);
+    const auto dictionary = text_dictionary(name);
+    const auto *codes = reinterpret_cast<const std::uint32_t *>(
+        file_->data() + entry.offset);
+    auto *dst = out.data_ptr<double>();
+    std::vector<double> values;
+    for (std::uint64_t i = 0; i < header_.row_count; ++i) {
+      if (codes[i] >= dictionary.size() ||
+          !d::parse_csv_numbers(dictionary[codes[i]], values) ||
+          static_cast<std::int64_t>(values.size()) != numel) {
+        throw mismatch();
+      }
+      std::copy(values.begin(), values.end(), dst + i * numel);
+    }
+    return out;
+  }
+
+  [[nodiscard]] experience_trace_t load() const {
+    namespace d = experience_trace_columns_detail;
+    auto trace = meta_;
+    std::vector<transition_record_t *> rows;
+    rows.reserve(header_.row_count);
+    for (auto &episode : trace.episodes) {
+      episode.transitions.resize(episode.transition_count);
+      for (auto &transition : episode.transitions) {
+        rows.push_back(&transition);
+      }
+    }
+    for (const auto &spec : d::kDoubleColumns) {
+      read_numeric<double>(spec, d::column_kind_t::f64, rows);
+    }
+    for (const auto &spec : d::kInt64Columns) {
+      read_numeric<std::int64_t>(spec, d::column_kind_t::i64, rows);
+    }
+    for (const auto &spec : d::kUInt64Columns) {
+      read_numeric<std::uint64_t>(spec, d::column_kind_t::u64, rows);
+    }
+    for (const auto &spec : d::kBoolColumns) {
+      read_numeric<std::uint8_t>(spec, d::column_kind_t::bool8, rows);
+    }
+    for (const auto &spec : d::kTextColumns) {
+      read_text(spec.name, rows,
+                [&spec](transition_record_t &row, const std::string &value) {
+                  row.*spec.member = value;
+                });
+    }
+    read_text("policy_kind", rows,
+              [](transition_record_t &row, const std::string &value) {
+                row.policy_kind =
+                    detail::parse_policy_kind(value, "policy_kind");
+              });
+    read_text("world_mode", rows,
+              [](transition_record_t &row, const std::string &value) {
+                row.world_mode = detail::parse_world_mode(value, "world_mode");
+              });
+    for (const auto &spec : d::kTensorPayloadColumns) {
+      const auto kind = static_cast<d::column_kind_t>(column(spec.name).kind);
+      if (kind == d::column_kind_t::f64_rows) {
+        read_payload<double>(spec, rows);
+      } else if (kind == d::column_kind_t::i64_rows) {
+        read_payload<std::int64_t>(spec, rows);
+      } else {
+        read_text(spec.name, rows,
+                  [&spec](transition_record_t &row, const std::string &value) {
+                    row.*spec.member = value;
+                  });
+      }
+    }
+    validate_experience_trace(trace);
+    return trace;
+  }
+
+private:
+  [[nodiscard]] const experience_trace_columns_detail::column_entry_t &
+  column(const std::string &name) const {
+    const auto it = index_.find(name);
+    if (it == index_.end()) {
+      throw std::runtime_error(
+          "[experience_trace] columnar trace missing column " + name);
+    }
+    return columns_[it->second];
+  }
+
+  template <typename Stored, typename T>
+  void read_numeric(
+      const experience_trace_columns_detail::member_column_t<T> &spec,
+      experience_trace_columns_detail::column_kind_t kind,
+      const std::vector<transition_record_t *> &rows) const {
+    const auto &entry = column(spec.name);
+    if (entry.kind != static_cast<std::uint32_t>(kind)) {
+      throw std::runtime_error("[experience_trace] column " +
+                               std::string(spec.name) +
+                               " has an unexpected kind");
+    }
+    const auto *values =
+        reinterpret_cast<const Stored *>(file_->data() + entry.offset);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      rows[i]->*spec.member = static_cast<T>(values[i]);
+    }
+  }
+
+  [[nodiscard]] const std::uint64_t *row_ends(
+      const experience_trace_columns_detail::column_entry_t &entry) const {
+    return reinterpret_cast<const std::uint64_t *>(file_->data() +
+                                                   entry.offset);
+  }
+
+  // Row ends must start at 0, never decrease and stop at the value count, so
+  // payload_tensor() and load() can index values without further checks.
+  void validate_row_offsets(
+      const experience_trace_columns_detail::column_entry_t &entry,
+      const std::string &name) const {
+    namespace d = experience_trace_columns_detail;
+    const auto *ends = row_ends(entry);
+    bool valid =
+        ends[0] == 0 && ends[header_.row_count] == entry.dictionary_count;
+    for (std::uint64_t i = 0; valid && i < header_.row_count; ++i) {
+      valid = ends[i] <= ends[i + 1];
+    }
+    if (valid && entry.dictionary_count != 0) {
+      valid = entry.dictionary_offset % d::kDataAlignment == 0 &&
+              file_->contains(entry.dictionary_offset,
+                              entry.dictionary_count * 8);
+    }
+    if (!valid) {
+      throw std::runtime_error("[experience_trace] columnar trace payload " +
+                               name + " is malformed");
+    }
+  }
+
+  // Prints dense payload rows back into the binder's text form.
+  template <typename T>
+  void
+  read_payload(const experience_trace_columns_detail::payload_column_t &spec,
+               const std::vector<transition_record_t *> &rows) const {
+    const auto &entry = column(spec.name);
+    const auto *ends = row_ends(entry);
+    const auto *values =
+        reinterpret_cast<const T *>(file_->data() + entry.dictionary_offset);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      auto &text = rows[i]->*spec.member;
+      text.clear();
+      experience_trace_columns_detail::append_csv_numbers(
+          text, values + ends[i], ends[i + 1] - ends[i]);
+    }
+  }
+
+  template <typename Set>
+  void read_text(const std::string &name,
+                 const std::vector<transition_record_t *> &rows,
+                 Set &&set) const {
+    const auto dictionary = text_dictionary(name);
+    const auto *codes = reinterpret_cast<const std::uint32_t *>(
+        file_->data() + column(name).offset);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+      if (codes[i] >= dictionary.size()) {
+        throw std::runtime_error("[experience_trace] columnar trace column " +
+                                 name + " has an out-of-range code");
+      }
+      set(*rows[i], dictionary[codes[i]]);
+    }
+  }
+
+  std::shared_ptr<cuwacunu::piaabo::io::mapped_file_t> file_{};
+  experience_trace_columns_detail::file_header_t header_{};
+  std::vector<experience_trace_columns_detail::column_entry_t> columns_{};
+  std::unordered_map<std::string, std::size_t> index_{};
+  std::vector<std::uint64_t> episode_row_offsets_{};
+  experience_trace_t meta_{};
+};
+
+[[nodiscard]] inline experience_trace_t
+read_experience_trace_columns(const std::filesystem::path &path) {
+  if (path.empty()) {
+    throw std::runtime_error("[experience_trace] columnar path is required");
+  }
+  return experience_trace_columns_t(path).load();
+}
+
+} // namespace cuwacunu::kikijyeba::environment::output
@@ -5,9 +5,11 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <initializer_list>
 #include <iomanip>
 #include <iterator>
 #include <limits>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <stdexcept>
@@ -18,6 +20,8 @@
 
 #include <torch/torch.h>
 
+#include <ATen/CPUGeneratorImpl.h>
+
 #include "kikijyeba/environment/control/interfaces.h"
 #include "wikimyei/assembly.h"
 #include "wikimyei/policy/portfolio/graph_node_allocation/torch_policy_module.h"
@@ -863,20 +867,300 @@ inline constexpr double kPi = 3.141592653589793238462643383279502884;
   return std::log1p(std::exp(value));
 }
 
+[[nodiscard]] inline torch::Tensor batch_mask(const torch::Tensor &mask,
+                                              const torch::Tensor &like,
+                                              const char *name) {
+  if (!mask.defined() || mask.dim() != 2 || like.dim() != 2 ||
+      mask.sizes() != like.sizes()) {
+    throw std::runtime_error(std::string("[action_distribution] ") + name +
+                             " expects [B, A] tensors and a [B, A] mask");
+  }
+  return mask.to(torch::TensorOptions().dtype(torch::kBool).device(
+      like.device()));
+}
+
+[[nodiscard]] inline torch::Tensor
+active_count_batch(const torch::Tensor &mask) {
+  return mask.sum(-1).to(torch::kFloat64);
+}
+
+// Last active column of each row: the logistic-normal reference coordinate.
+// Rows without an active column get index 0.
+[[nodiscard]] inline torch::Tensor
+reference_index_batch(const torch::Tensor &mask) {
+  const auto columns =
+      torch::arange(mask.size(-1), torch::TensorOptions()
+                                       .dtype(torch::kInt64)
+                                       .device(mask.device()))
+          .expand_as(mask);
+  return torch::where(mask, columns, torch::full_like(columns, -1))
+      .amax(-1)
+      .clamp_min(0);
+}
+
+[[nodiscard]] inline torch::Tensor
+latent_mask_batch(const torch::Tensor &mask) {
+  auto out = mask.clone();
+  out.scatter_(-1, reference_index_batch(mask).unsqueeze(-1), false);
+  return out;
+}
+
+} // namespace action_distribution_detail
+
+/*
+ * Batched masked simplex distributions.
+ *
+ * Every function takes row-major [B, A] tensors and a [B, A] bool mask of
+ * executable nodes, and reduces over A. Masked columns carry no mass and
+ * never reach lgamma/log, so their stored values may be anything finite. A
+ * row with one active node is a point mass: log-probability, entropy and KL
+ * are zero. Logistic-normal latents live on the active columns except the
+ * row's last active one, which is the reference.
+ *
+ * The single-action distribution classes below run on these with B = 1.
+ */
+
+// alpha = floor + concentration * softmax(logits over active columns);
+// inactive columns are 0. `total_concentration` is [B] or a scalar.
+[[nodiscard]] inline torch::Tensor
+masked_dirichlet_alpha_batch(const torch::Tensor &logits,
+                             const torch::Tensor &mask,
+                             const torch::Tensor &total_concentration,
+                             double alpha_floor) {
+  const auto logits64 = logits.to(torch::kFloat64);
+  const auto m =
+      action_distribution_detail::batch_mask(mask, logits64, "Dirichlet alpha");
+  const auto masked_logits = logits64.masked_fill(
+      m.logical_not(), -std::numeric_limits<double>::infinity());
+  auto mean = torch::softmax(masked_logits, -1);
+  mean = torch::where(m, mean, torch::zeros_like(mean));
+  auto concentration = total_concentration.to(logits64.options());
+  if (concentration.dim() == 1) {
+    concentration = concentration.unsqueeze(-1);
+  }
+  return torch::where(m, mean * concentration + alpha_floor,
+                      torch::zeros_like(mean));
+}
+
+[[nodiscard]] inline torch::Tensor
+masked_dirichlet_log_prob_batch(const torch::Tensor &alpha,
+                                const torch::Tensor &weights,
+                                const torch::Tensor &mask) {
+  const auto alpha64 = alpha.to(torch::kFloat64);
+  const auto m = action_distribution_detail::batch_mask(mask, alpha64,
+                                                        "Dirichlet log_prob");
+  const auto a = torch::where(m, alpha64, torch::ones_like(alpha64));
+  const auto w = torch::where(m, weights.to(alpha64.options()),
+                              torch::ones_like(alpha64));
+  const auto alpha_sum = torch::where(m, alpha64, torch::zeros_like(alpha64))
+                             .sum(-1);
+  const auto out = torch::lgamma(alpha_sum) - torch::lgamma(a).sum(-1) +
+                   ((a - 1.0) * torch::log(w)).sum(-1);
+  return torch::where(action_distribution_detail::active_count_batch(m) > 1.0,
+                      out, torch::zeros_like(out));
+}
+
+[[nodiscard]] inline torch::Tensor
+masked_dirichlet_entropy_batch(const torch::Tensor &alpha,
+                               const torch::Tensor &mask) {
+  const auto alpha64 = alpha.to(torch::kFloat64);
+  const auto m = action_distribution_detail::batch_mask(mask, alpha64,
+                                                        "Dirichlet entropy");
+  const auto a = torch::where(m, alpha64, torch::ones_like(alpha64));
+  const auto count = action_distribution_detail::active_count_batch(m);
+  const auto alpha_sum = torch::where(m, alpha64, torch::zeros_like(alpha64))
+                             .sum(-1);
+  const auto log_beta = torch::lgamma(a).sum(-1) - torch::lgamma(alpha_sum);
+  const auto out = log_beta + (alpha_sum - count) * torch::digamma(alpha_sum) -
+                   ((a - 1.0) * torch::digamma(a)).sum(-1);
+  return torch::where(count > 1.0, out, torch::zeros_like(out));
+}
+
+// Closed-form KL(Dir(alpha_p) || Dir(alpha_q)) per row.
+[[nodiscard]] inline torch::Tensor
+masked_dirichlet_kl_batch(const torch::Tensor &alpha_p,
+                          const torch::Tensor &alpha_q,
+                          const torch::Tensor &mask) {
+  const auto p64 = alpha_p.to(torch::kFloat64);
+  const auto m =
+      action_distribution_detail::batch_mask(mask, p64, "Dirichlet KL");
+  const auto p = torch::where(m, p64, torch::ones_like(p64));
+  const auto q =
+      torch::where(m, alpha_q.to(p64.options()), torch::ones_like(p64));
+  const auto zeros = torch::zeros_like(p64);
+  const auto p_sum = torch::where(m, p, zeros).sum(-1);
+  const auto q_sum = torch::where(m, q, zeros).sum(-1);
+  const auto out =
+      torch::lgamma(p_sum) - torch::lgamma(p).sum(-1) - torch::lgamma(q_sum) +
+      torch::lgamma(q).sum(-1) +
+      ((p - q) * (torch::digamma(p) - torch::digamma(p_sum).unsqueeze(-1)))
+          .sum(-1);
+  return torch::where(action_distribution_detail::active_count_batch(m) > 1.0,
+                      out, torch::zeros_like(out));
+}
+
+// Normalized Gamma(alpha, 1) draws. Gamma variates are drawn on the
+// generator's device, so a seeded CPU generator reproduces the same sample
+// wherever alpha lives. A row whose draws all underflow falls back to its
+// mean.
+[[nodiscard]] inline torch::Tensor
+sample_masked_dirichlet_batch(const torch::Tensor &alpha,
+                              const torch::Tensor &mask,
+                              std::optional<at::Generator> generator = {}) {
+  const auto alpha64 = alpha.to(torch::kFloat64);
+  const auto m =
+      action_distribution_detail::batch_mask(mask, alpha64, "Dirichlet sample");
+  const auto a = torch::where(m, alpha64, torch::ones_like(alpha64));
+  const auto draw_device =
+      generator.has_value() ? generator->device() : a.device();
+  auto gamma = torch::_standard_gamma(a.to(draw_device), generator)
+                   .to(alpha64.device());
+  gamma = torch::where(m & torch::isfinite(gamma), gamma.clamp_min(0.0),
+                       torch::zeros_like(gamma));
+  const auto total = gamma.sum(-1, /*keepdim=*/true);
+  const auto mean_alpha = torch::where(m, alpha64, torch::zeros_like(alpha64));
+  const auto mean = mean_alpha / mean_alpha.sum(-1, true).clamp_min(
+                                     std::numeric_limits<double>::min());
+  return torch::where(total > 0.0, gamma / total.clamp_min(
+                                       std::numeric_limits<double>::min()),
+                      mean);
+}
+
+[[nodiscard]] inline torch::Tensor
+masked_logistic_normal_log_prob_batch(const torch::Tensor &weights,
+                                      const torch::Tensor &mu_z,
+                                      const torch::Tensor &std_z,
+                                      const torch::Tensor &mask) {
+  const auto w64 = weights.to(torch::kFloat64);
+  const auto m = action_distribution_detail::batch_mask(
+      mask, w64, "logistic-normal log_prob");
+  const auto latent = action_distribution_detail::latent_mask_batch(m);
+  const auto ones = torch::ones_like(w64);
+  const auto log_w = torch::log(torch::where(m, w64, ones));
+  const auto ref = action_distribution_detail::reference_index_batch(m);
+  const auto z = log_w - log_w.gather(-1, ref.unsqueeze(-1));
+  const auto s = torch::where(latent, std_z.to(w64.options()), ones);
+  const auto centered =
+      torch::where(latent, (z - mu_z.to(w64.options())) / s,
+                   torch::zeros_like(w64));
+  const double half_log_two_pi =
+      0.5 * std::log(2.0 * action_distribution_detail::kPi);
+  const auto normal =
+      torch::where(latent,
+                   -0.5 * centered * centered - torch::log(s) -
+                       half_log_two_pi,
+                   torch::zeros_like(w64))
+          .sum(-1);
+  const auto out = normal - log_w.sum(-1);
+  return torch::where(action_distribution_detail::active_count_batch(m) > 1.0,
+                      out, torch::zeros_like(out));
+}
+
+[[nodiscard]] inline torch::Tensor
+masked_logistic_normal_entropy_batch(const torch::Tensor &std_z,
+                                     const torch::Tensor &mask) {
+  const auto s64 = std_z.to(torch::kFloat64);
+  const auto m = action_distribution_detail::batch_mask(
+      mask, s64, "logistic-normal entropy");
+  const auto latent = action_distribution_detail::latent_mask_batch(m);
+  const double per_dim =
+      0.5 * (1.0 + std::log(2.0 * action_distribution_detail::kPi));
+  return torch::where(latent,
+                      per_dim + torch::log(torch::where(
+                                    latent, s64, torch::ones_like(s64))),
+                      torch::zeros_like(s64))
+      .sum(-1);
+}
+
+// KL between the latent diagonal normals; the simplex map is a shared
+// bijection, so this equals the KL between the two logistic-normal actions.
+[[nodiscard]] inline torch::Tensor masked_logistic_normal_kl_batch(
+    const torch::Tensor &mu_p, const torch::Tensor &std_p,
+    const torch::Tensor &mu_q, const torch::Tensor &std_q,
+    const torch::Tensor &mask) {
+  const auto mp = mu_p.to(torch::kFloat64);
+  const auto m =
+      action_distribution_detail::batch_mask(mask, mp, "logistic-normal KL");
+  const auto latent = action_distribution_detail::latent_mask_batch(m);
+  const auto ones = torch::ones_like(mp);
+  const auto sp = torch::where(latent, std_p.to(mp.options()), ones);
+  const auto sq = torch::where(latent, std_q.to(mp.options()), ones);
+  const auto diff =
+      torch::where(latent, mp - mu_q.to(mp.options()), torch::zeros_like(mp));
+  return torch::where(latent,
+                      torch::log(sq / sp) +
+                          (sp * sp + diff * diff) / (2.0 * sq * sq) - 0.5,
+                      torch::zeros_like(mp))
+      .sum(-1);
+}
+
+// z = mu + std * eps on latent columns, 0 at the reference, then softmax
+// over active columns. `standard_normal` ([B, A], optional) replaces eps.
+[[nodiscard]] inline torch::Tensor sample_masked_logistic_normal_batch(
+    const torch::Tensor &mu_z, const torch::Tensor &std_z,
+    const torch::Tensor &mask, std::optional<at::Generator> generator = {},
+    const torch::Tensor &standard_normal = {}) {
+  const auto mu64 = mu_z.to(torch::kFloat64);
+  const auto m = action_distribution_detail::batch_mask(
+      mask, mu64, "logistic-normal sample");
+  const auto latent = action_distribution_detail::latent_mask_batch(m);
+  torch::Tensor eps;
+  if (standard_normal.defined()) {
+    eps = standard_normal.to(mu64.options());
+  } else {
+    const auto draw_device =
+        generator.has_value() ? generator->device() : mu64.device();
+    eps = torch::randn(mu64.sizes(), generator,
+                       mu64.options().device(draw_device))
+              .to(mu64.device());
+  }
+  const auto zeros = torch::zeros_like(mu64);
+  const auto z = torch::where(latent, mu64 + std_z.to(mu64.options()) * eps,
+                              zeros);
+  const auto weights = torch::softmax(
+      z.masked_fill(m.logical_not(), -std::numeric_limits<double>::infinity()),
+      -1);
+  return torch::where(m, weights, zeros);
+}
+
+namespace action_distribution_detail {
+
+// Explicit generator for one sampling call: seeded from the options when a
+// seed is bound, from std::random_device otherwise. Draws come from torch's
+// gamma/normal samplers, so a bound seed reproduces its own sample but not
+// one recorded by the earlier std::mt19937_64 sampler; evidence replay uses
+// the stored action, never a re-draw.
+[[nodiscard]] inline at::Generator
+sampling_generator(const action_distribution_options_t &options) {
+  return at::detail::createCPUGenerator(
+      options.random_seed_bound ? options.random_seed
+                                : static_cast<std::uint64_t>(
+                                      std::random_device{}()));
+}
+
+[[nodiscard]] inline torch::Tensor
+row_mask(std::int64_t K, const torch::Tensor &like) {
+  return torch::ones({1, K}, torch::TensorOptions()
+                                 .dtype(torch::kBool)
+                                 .device(like.device()));
+}
+
 [[nodiscard]] inline std::vector<std::int64_t>
 active_indices_from_input(const policy_input_t &input) {
   const auto mask =
       (input.valid_mask & input.tradable_mask & input.executable_mask)
-          .contiguous();
-  const auto A = static_cast<std::int64_t>(input.node_ids.size());
-  std::vector<std::int64_t> active;
-  active.reserve(static_cast<std::size_t>(A));
-  for (std::int64_t i = 0; i < A; ++i) {
-    if (mask.index({i}).item<bool>()) {
-      active.push_back(i);
-    }
-  }
-  return active;
+          .to(torch::kCPU);
+  const auto indices =
+      torch::nonzero(mask).reshape({-1}).to(torch::kInt64).contiguous();
+  const auto *data = indices.data_ptr<std::int64_t>();
+  return std::vector<std::int64_t>(data, data + indices.numel());
+}
+
+[[nodiscard]] inline torch::Tensor
+index_tensor(const std::vector<std::int64_t> &indices,
+             const torch::Tensor &like) {
+  return torch::tensor(indices, torch::TensorOptions().dtype(torch::kInt64))
+      .to(like.device());
 }
 
 [[nodiscard]] inline torch::Tensor
@@ -886,26 +1170,14 @@ masked_softmax_active(const torch::Tensor &logits,
     throw std::runtime_error(
         "[action_distribution] no executable graph node is available");
   }
-  std::vector<double> values(active.size(), 0.0);
-  double max_logit = -std::numeric_limits<double>::infinity();
-  for (std::size_t offset = 0; offset < active.size(); ++offset) {
-    const double logit = logits.index({active[offset]}).item<double>();
-    values[offset] = logit;
-    max_logit = std::max(max_logit, logit);
-  }
-  double denom = 0.0;
-  for (double &value : values) {
-    value = std::exp(value - max_logit);
-    denom += value;
-  }
-  if (!(denom > 0.0) || !std::isfinite(denom)) {
+  const auto active_logits = logits.to(torch::kFloat64)
+                                 .index_select(0, index_tensor(active, logits));
+  const auto values = torch::softmax(active_logits, 0);
+  if (!torch::isfinite(values).all().item<bool>()) {
     throw std::runtime_error(
         "[action_distribution] softmax denominator is invalid");
   }
-  for (double &value : values) {
-    value /= denom;
-  }
-  return torch::tensor(values, torch::TensorOptions().dtype(torch::kFloat64));
+  return values.contiguous();
 }
 
 [[nodiscard]] inline torch::Tensor
@@ -920,10 +1192,7 @@ scatter_active_weights(std::int64_t A, const std::vector<std::int64_t> &active,
     throw std::runtime_error(
         "[action_distribution] active weights must be finite [K]");
   }
-  for (std::size_t offset = 0; offset < active.size(); ++offset) {
-    weights.index_put_({active[offset]},
-                       active64.index({static_cast<std::int64_t>(offset)}));
-  }
+  weights.index_copy_(0, index_tensor(active, weights), active64);
   return weights.contiguous();
 }
 
@@ -1010,108 +1279,113 @@ logistic_normal_std(const raw_policy_output_t &raw,
   return std::exp(log_std);
 }
 
+// Value checks for the scalar wrappers below. Each wrapper reads its result
+// and every check flag in one host transfer, and throws the first failing
+// check's message, so validation adds no sync of its own.
+struct scalar_check_t {
+  torch::Tensor valid{};
+  const char *error{""};
+};
+
+[[nodiscard]] inline double
+read_checked_scalar(const torch::Tensor &value,
+                    std::initializer_list<scalar_check_t> checks) {
+  std::vector<torch::Tensor> row;
+  row.reserve(checks.size() + 1);
+  row.push_back(value.reshape({}).to(torch::kFloat64));
+  for (const auto &check : checks) {
+    row.push_back(check.valid.reshape({}).to(value.device()).to(
+        torch::kFloat64));
+  }
+  const auto host = torch::stack(row).to(torch::kCPU).contiguous();
+  const auto *data = host.data_ptr<double>();
+  std::size_t i = 1;
+  for (const auto &check : checks) {
+    if (data[i++] == 0.0) {
+      throw std::runtime_error(check.error);
+    }
+  }
+  return data[0];
+}
+
+[[nodiscard]] inline torch::Tensor finite_positive(const torch::Tensor &x) {
+  return torch::isfinite(x).all() & (x > 0.0).all();
+}
+
 [[nodiscard]] inline double
 dirichlet_log_prob(const torch::Tensor &alpha_active,
                    const torch::Tensor &active_weights) {
   const auto alpha = alpha_active.to(torch::kFloat64).contiguous();
   const auto weights = active_weights.to(torch::kFloat64).contiguous();
   if (alpha.dim() != 1 || weights.dim() != 1 ||
-      alpha.size(0) != weights.size(0) || alpha.size(0) <= 0 ||
-      !torch::isfinite(alpha).all().item<bool>() ||
-      !torch::isfinite(weights).all().item<bool>() ||
-      (alpha <= 0.0).any().item<bool>() ||
-      (weights <= 0.0).any().item<bool>()) {
+      alpha.size(0) != weights.size(0) || alpha.size(0) <= 0) {
     throw std::runtime_error(
         "[action_distribution] invalid Dirichlet log_prob tensors");
   }
-  const double alpha_sum = alpha.sum().item<double>();
-  double out = std::lgamma(alpha_sum);
-  for (std::int64_t i = 0; i < alpha.size(0); ++i) {
-    const double a = alpha.index({i}).item<double>();
-    const double w = weights.index({i}).item<double>();
-    out -= std::lgamma(a);
-    out += (a - 1.0) * std::log(w);
-  }
-  return out;
+  return read_checked_scalar(
+      masked_dirichlet_log_prob_batch(alpha.unsqueeze(0), weights.unsqueeze(0),
+                                      row_mask(alpha.size(0), alpha)),
+      {{finite_positive(alpha) & finite_positive(weights),
+        "[action_distribution] invalid Dirichlet log_prob tensors"}});
 }
 
 [[nodiscard]] inline double
 dirichlet_entropy(const torch::Tensor &alpha_active) {
   const auto alpha = alpha_active.to(torch::kFloat64).contiguous();
-  if (alpha.dim() != 1 || alpha.size(0) <= 0 ||
-      !torch::isfinite(alpha).all().item<bool>() ||
-      (alpha <= 0.0).any().item<bool>()) {
+  if (alpha.dim() != 1 || alpha.size(0) <= 0) {
     throw std::runtime_error(
         "[action_distribution] invalid Dirichlet entropy tensor");
   }
-  const double alpha_sum = alpha.sum().item<double>();
-  double log_beta = -std::lgamma(alpha_sum);
-  for (std::int64_t i = 0; i < alpha.size(0); ++i) {
-    log_beta += std::lgamma(alpha.index({i}).item<double>());
-  }
-  const double digamma_sum =
-      torch::digamma(torch::tensor(alpha_sum, torch::TensorOptions().dtype(
-                                                  torch::kFloat64)))
-          .item<double>();
-  double out =
-      log_beta + (alpha_sum - static_cast<double>(alpha.size(0))) * digamma_sum;
-  const auto digamma_alpha = torch::digamma(alpha);
-  for (std::int64_t i = 0; i < alpha.size(0); ++i) {
-    out -= (alpha.index({i}).item<double>() - 1.0) *
-           digamma_alpha.index({i}).item<double>();
-  }
-  return out;
+  const auto entropy =
+      alpha.size(0) == 1
+          ? torch::zeros({}, alpha.options())
+          : masked_dirichlet_entropy_batch(alpha.unsqueeze(0),
+                                           row_mask(alpha.size(0), alpha));
+  return read_checked_scalar(
+      entropy, {{finite_positive(alpha),
+                 "[action_distribution] invalid Dirichlet entropy tensor"}});
 }
 
 [[nodiscard]] inline torch::Tensor
 sample_dirichlet_active(const torch::Tensor &alpha_active,
                         const action_distribution_options_t &options) {
   const auto alpha = alpha_active.to(torch::kFloat64).contiguous();
-  std::mt19937_64 rng(options.random_seed_bound ? options.random_seed
-                                                : std::random_device{}());
-  std::vector<double> draws(static_cast<std::size_t>(alpha.size(0)), 0.0);
-  double total = 0.0;
-  for (std::int64_t i = 0; i < alpha.size(0); ++i) {
-    std::gamma_distribution<double> gamma(alpha.index({i}).item<double>(), 1.0);
-    double value = gamma(rng);
-    if (!std::isfinite(value) || value < 0.0) {
-      value = 0.0;
-    }
-    draws[static_cast<std::size_t>(i)] = value;
-    total += value;
-  }
-  if (!(total > 0.0) || !std::isfinite(total)) {
-    return alpha / alpha.sum();
-  }
-  for (double &draw : draws) {
-    draw /= total;
-  }
-  return torch::tensor(draws, torch::TensorOptions().dtype(torch::kFloat64));
+  return sample_masked_dirichlet_batch(alpha.unsqueeze(0),
+                                       row_mask(alpha.size(0), alpha),
+                                       sampling_generator(options))
+      .squeeze(0)
+      .contiguous();
 }
 
-[[nodiscard]] inline double normal_diag_log_prob(const torch::Tensor &z,
-                                                 const torch::Tensor &mu,
-                                                 const torch::Tensor &std) {
+// Diagonal normal log density of float64 [K] tensors as a device scalar,
+// with the flag that its inputs are finite and std is positive.
+[[nodiscard]] inline std::pair<torch::Tensor, torch::Tensor>
+normal_diag_log_prob_tensor(const torch::Tensor &z, const torch::Tensor &mu,
+                            const torch::Tensor &std) {
   const auto z64 = z.to(torch::kFloat64).contiguous();
   const auto mu64 = mu.to(torch::kFloat64).contiguous();
   const auto std64 = std.to(torch::kFloat64).contiguous();
   if (z64.dim() != 1 || mu64.dim() != 1 || std64.dim() != 1 ||
-      z64.size(0) != mu64.size(0) || z64.size(0) != std64.size(0) ||
-      !torch::isfinite(z64).all().item<bool>() ||
-      !torch::isfinite(mu64).all().item<bool>() ||
-      !torch::isfinite(std64).all().item<bool>() ||
-      (std64 <= 0.0).any().item<bool>()) {
+      z64.size(0) != mu64.size(0) || z64.size(0) != std64.size(0)) {
     throw std::runtime_error(
         "[action_distribution] invalid diagonal normal tensors");
   }
-  double out = 0.0;
-  for (std::int64_t i = 0; i < z64.size(0); ++i) {
-    const double s = std64.index({i}).item<double>();
-    const double centered =
-        (z64.index({i}).item<double>() - mu64.index({i}).item<double>()) / s;
-    out += -0.5 * centered * centered - std::log(s) - 0.5 * std::log(2.0 * kPi);
-  }
-  return out;
+  const auto centered = (z64 - mu64) / std64;
+  auto log_prob =
+      (-0.5 * centered * centered - torch::log(std64)).sum() -
+      0.5 * std::log(2.0 * kPi) * static_cast<double>(z64.size(0));
+  auto valid = torch::isfinite(z64).all() & torch::isfinite(mu64).all() &
+               finite_positive(std64);
+  return {std::move(log_prob), std::move(valid)};
+}
+
+[[nodiscard]] inline double normal_diag_log_prob(const torch::Tensor &z,
+                                                 const torch::Tensor &mu,
+                                                 const torch::Tensor &std) {
+  const auto [log_prob, valid] = normal_diag_log_prob_tensor(z, mu, std);
+  return read_checked_scalar(
+      log_prob,
+      {{valid, "[action_distribution] invalid diagonal normal tensors"}});
 }
 
 [[nodiscard]] inline double
@@ -1119,41 +1393,31 @@ logistic_normal_log_prob(const torch::Tensor &active_weights,
                          const torch::Tensor &mu_z,
                          const torch::Tensor &std_z) {
   const auto weights = active_weights.to(torch::kFloat64).contiguous();
-  if (weights.dim() != 1 || weights.size(0) < 2 ||
-      !torch::isfinite(weights).all().item<bool>() ||
-      (weights <= 0.0).any().item<bool>()) {
+  if (weights.dim() != 1 || weights.size(0) < 2) {
     throw std::runtime_error(
         "[action_distribution] logistic-normal weights must be positive [K]");
   }
   const std::int64_t K = weights.size(0);
-  const double ref_weight = weights.index({K - 1}).item<double>();
-  std::vector<double> z_values(static_cast<std::size_t>(K - 1), 0.0);
-  double log_jacobian = 0.0;
-  for (std::int64_t i = 0; i < K; ++i) {
-    const double w = weights.index({i}).item<double>();
-    log_jacobian -= std::log(w);
-    if (i + 1 < K) {
-      z_values[static_cast<std::size_t>(i)] = std::log(w / ref_weight);
-    }
-  }
-  const auto z =
-      torch::tensor(z_values, torch::TensorOptions().dtype(torch::kFloat64));
-  return normal_diag_log_prob(z, mu_z, std_z) + log_jacobian;
+  const auto log_w = torch::log(weights);
+  const auto z = log_w.slice(0, 0, K - 1) - log_w.index({K - 1});
+  const auto [log_prob, valid] = normal_diag_log_prob_tensor(z, mu_z, std_z);
+  return read_checked_scalar(
+      log_prob - log_w.sum(),
+      {{finite_positive(weights), "[action_distribution] logistic-normal "
+                                  "weights must be positive [K]"},
+       {valid, "[action_distribution] invalid diagonal normal tensors"}});
 }
 
 [[nodiscard]] inline double latent_normal_entropy(const torch::Tensor &std_z) {
   const auto std64 = std_z.to(torch::kFloat64).contiguous();
-  if (std64.dim() != 1 || std64.size(0) <= 0 ||
-      !torch::isfinite(std64).all().item<bool>() ||
-      (std64 <= 0.0).any().item<bool>()) {
+  if (std64.dim() != 1 || std64.size(0) <= 0) {
     throw std::runtime_error("[action_distribution] invalid latent std tensor");
   }
-  double out = 0.0;
-  for (std::int64_t i = 0; i < std64.size(0); ++i) {
-    const double s = std64.index({i}).item<double>();
-    out += 0.5 * (1.0 + std::log(2.0 * kPi)) + std::log(s);
-  }
-  return out;
+  return read_checked_scalar(
+      0.5 * (1.0 + std::log(2.0 * kPi)) * static_cast<double>(std64.size(0)) +
+          torch::log(std64).sum(),
+      {{finite_positive(std64),
+        "[action_distribution] invalid latent std tensor"}});
 }
 
 [[nodiscard]] inline torch::Tensor
@@ -1172,14 +1436,8 @@ standard_normal_noise(std::int64_t dim,
     }
     return noise;
   }
-  std::mt19937_64 rng(options.random_seed_bound ? options.random_seed
-                                                : std::random_device{}());
-  std::normal_distribution<double> normal(0.0, 1.0);
-  std::vector<double> values(static_cast<std::size_t>(dim), 0.0);
-  for (double &value : values) {
-    value = normal(rng);
-  }
-  return torch::tensor(values, torch::TensorOptions().dtype(torch::kFloat64));
+  return torch::randn({dim}, sampling_generator(options),
+                      torch::TensorOptions().dtype(torch::kFloat64));
 }
 
 } // namespace action_distribution_detail
@@ -1276,15 +1534,11 @@ public:
             raw, distribution_options);
     const auto alpha =
         mean * concentration + distribution_options.dirichlet_alpha_floor;
-    std::vector<double> active_weights;
-    active_weights.reserve(active.size());
-    const auto weights = action.target_weights.to(torch::kFloat64).contiguous();
-    for (const auto index : active) {
-      active_weights.push_back(weights.index({index}).item<double>());
-    }
-    return action_distribution_detail::dirichlet_log_prob(
-        alpha, torch::tensor(active_weights,
-                             torch::TensorOptions().dtype(torch::kFloat64)));
+    const auto weights = action.target_weights.to(torch::kFloat64);
+    const auto active_weights = weights.index_select(
+        0, action_distribution_detail::index_tensor(active, weights));
+    return action_distribution_detail::dirichlet_log_prob(alpha,
+                                                          active_weights);
   }
 
   [[nodiscard]] double
@@ -1414,16 +1668,11 @@ public:
       return 0.0;
     }
     const auto params = logistic_params(raw, active, distribution_options);
-    std::vector<double> active_weights;
-    active_weights.reserve(active.size());
-    const auto weights = action.target_weights.to(torch::kFloat64).contiguous();
-    for (const auto index : active) {
-      active_weights.push_back(weights.index({index}).item<double>());
-    }
+    const auto weights = action.target_weights.to(torch::kFloat64);
+    const auto active_weights = weights.index_select(
+        0, action_distribution_detail::index_tensor(active, weights));
     return action_distribution_detail::logistic_normal_log_prob(
-        torch::tensor(active_weights,
-                      torch::TensorOptions().dtype(torch::kFloat64)),
-        params.first, params.second);
+        active_weights, params.first, params.second);
   }
 
   [[nodiscard]] double
@@ -1442,20 +1691,14 @@ private:
       const action_distribution_options_t &distribution_options) const {
     const auto logits = raw.node_weight_logits.to(torch::kFloat64).contiguous();
     const auto K = static_cast<std::int64_t>(active.size());
-    const double ref_logit = logits.index({active.back()}).item<double>();
-    std::vector<double> mu_values(static_cast<std::size_t>(K - 1), 0.0);
-    for (std::int64_t offset = 0; offset + 1 < K; ++offset) {
-      mu_values[static_cast<std::size_t>(offset)] =
-          logits.index({active[static_cast<std::size_t>(offset)]})
-              .item<double>() -
-          ref_logit;
-    }
+    const auto active_logits = logits.index_select(
+        0, action_distribution_detail::index_tensor(active, logits));
     const double std_value = action_distribution_detail::logistic_normal_std(
         raw, distribution_options);
-    return {
-        torch::tensor(mu_values, torch::TensorOptions().dtype(torch::kFloat64)),
-        torch::full({K - 1}, std_value,
-                    torch::TensorOptions().dtype(torch::kFloat64))};
+    return {(active_logits.slice(0, 0, K - 1) - active_logits.index({K - 1}))
+                .contiguous(),
+            torch::full({K - 1}, std_value,
+                        torch::TensorOptions().dtype(torch::kFloat64))};
   }
 
   [[nodiscard]] action_sample_t
@@ -1502,36 +1745,17 @@ private:
                     evidence.std_z *
                         action_distribution_detail::standard_normal_noise(
                             evidence.mu_z.size(0), distribution_options);
-      std::vector<double> softmax_values(
-          static_cast<std::size_t>(evidence.active_count), 0.0);
-      double max_value = 0.0;
-      for (std::int64_t offset = 0; offset + 1 < evidence.active_count;
-           ++offset) {
-        const double value =
-            evidence.latent_z_sample.index({offset}).item<double>();
-        softmax_values[static_cast<std::size_t>(offset)] = value;
-        max_value = std::max(max_value, value);
-      }
-      double denom = std::exp(-max_value);
-      for (std::int64_t offset = 0; offset + 1 < evidence.active_count;
-           ++offset) {
-        const double value =
-            std::exp(evidence.latent_z_sample.index({offset}).item<double>() -
-                     max_value);
-        softmax_values[static_cast<std::size_t>(offset)] = value;
-        denom += value;
-      }
-      softmax_values.back() = std::exp(-max_value);
-      if (!(denom > 0.0) || !std::isfinite(denom)) {
+      active_weights =
+          torch::softmax(torch::cat({evidence.latent_z_sample,
+                                     torch::zeros({1}, evidence.latent_z_sample
+                                                           .options())}),
+                         0)
+              .contiguous();
+      if (!torch::isfinite(active_weights).all().item<bool>()) {
         throw std::runtime_error(
             "[action_distribution] logistic-normal softmax denominator is "
             "invalid");
       }
-      for (double &value : softmax_values) {
-        value /= denom;
-      }
-      active_weights = torch::tensor(
-          softmax_values, torch::TensorOptions().dtype(torch::kFloat64));
       evidence.log_prob = action_distribution_detail::logistic_normal_log_prob(
           active_weights, evidence.mu_z, evidence.std_z);
       evidence.entropy =
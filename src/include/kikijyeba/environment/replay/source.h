@@ -475,8 +475,11 @@ realized_return_projection_spec_from_plan(
   return out;
 }
 
+// Bundle-level checks only: spec, options, frame count and projection. The
+// per-frame pass lives in validate_replay_episode_bundle and in the
+// validating replay_world_t constructor.
 inline void
-validate_replay_episode_bundle(const replay_episode_bundle_t &bundle) {
+validate_replay_episode_bundle_shape(const replay_episode_bundle_t &bundle) {
   validate_episode_spec(bundle.spec);
   validate_replay_frame_build_options(bundle.frame_options);
   validate_replay_world_options(bundle.world_options);
@@ -493,15 +496,6 @@ validate_replay_episode_bundle(const replay_episode_bundle_t &bundle) {
     throw std::runtime_error(
         "[replay_source] replay episode bundle frame count mismatch");
   }
-  auto frame_validation_options = bundle.world_options;
-  frame_validation_options.require_projection_validation = false;
-  for (std::size_t i = 0; i < bundle.frames.size(); ++i) {
-    detail::validate_frame(bundle.frames[i], bundle.spec, i,
-                           frame_validation_options);
-    if (i + 1 < bundle.frames.size()) {
-      detail::validate_frame_sequence(bundle.frames[i], bundle.frames[i + 1]);
-    }
-  }
   const auto A = bundle.spec.target_node_ids.size();
   if (bundle.realized_return_projection.target_node_ids !=
       bundle.spec.target_node_ids) {
@@ -573,6 +567,20 @@ validate_replay_episode_bundle(const replay_episode_bundle_t &bundle) {
   }
 }
 
+inline void
+validate_replay_episode_bundle(const replay_episode_bundle_t &bundle) {
+  validate_replay_episode_bundle_shape(bundle);
+  auto frame_validation_options = bundle.world_options;
+  frame_validation_options.require_projection_validation = false;
+  for (std::size_t i = 0; i < bundle.frames.size(); ++i) {
+    detail::validate_frame(bundle.frames[i], bundle.spec, i,
+                           frame_validation_options);
+    if (i + 1 < bundle.frames.size()) {
+      detail::validate_frame_sequence(bundle.frames[i], bundle.frames[i + 1]);
+    }
+  }
+}
+
 inline void validate_replay_episode_bundle_ready_for_world(
     const replay_episode_bundle_t &bundle) {
   validate_replay_episode_bundle(bundle);
@@ -1048,15 +1056,18 @@ make_replay_episode_bundle_from_graph_anchor_edge_batch(
 
 [[nodiscard]] inline std::unique_ptr<world_iface_t>
 spawn_replay_world(const replay_episode_bundle_t &bundle) {
-  validate_replay_episode_bundle_ready_for_world(bundle);
-  return std::make_unique<replay_world_t>(bundle.frames, bundle.world_options);
+  validate_replay_episode_bundle_shape(bundle);
+  // The world validates its frames against the bundle spec once here; the
+  // first reset with that spec reuses the result.
+  return std::make_unique<replay_world_t>(bundle.frames, bundle.world_options,
+                                          bundle.spec);
 }
 
 [[nodiscard]] inline std::unique_ptr<world_iface_t>
 spawn_replay_world(replay_episode_bundle_t &&bundle) {
-  validate_replay_episode_bundle_ready_for_world(bundle);
-  return std::make_unique<replay_world_t>(std::move(bundle.frames),
-                                          bundle.world_options);
+  validate_replay_episode_bundle_shape(bundle);
+  return std::make_unique<replay_world_t>(
+      std::move(bundle.frames), bundle.world_options, bundle.spec);
 }
 
 } // namespace cuwacunu::kikijyeba::environment::replay
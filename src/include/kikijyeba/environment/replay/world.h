@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -13,6 +14,8 @@
 #include <torch/torch.h>
 
 #include "kikijyeba/environment/control/interfaces.h"
+#include "piaabo/bench/trace_span.h"
+#include "wikimyei/assembly.h"
 
 namespace cuwacunu::kikijyeba::environment::replay {
 
@@ -27,6 +30,10 @@ struct replay_world_options_t {
   double rebalance_plan_consistency_tolerance{1.0e-8};
   bool require_projection_validation{true};
   bool require_realized_log_return{true};
+  // Frames are validated once per distinct episode validation digest; later
+  // resets only check episode-level invariants. Set for debugging to rerun
+  // the full per-frame validation on every reset.
+  bool revalidate_frames_on_reset{false};
 };
 
 inline void
@@ -405,9 +412,15 @@ validate_observation_beliefs_match_frame(const observation_t &observation,
   }
 }
 
-inline void validate_frame(const replay_frame_t &frame,
-                           const episode_spec_t &spec, std::size_t offset,
-                           const replay_world_options_t &options) {
+// Realized returns as checked by validate_frame, in float64.
+struct validated_frame_returns_t {
+  torch::Tensor log_return{};        // [A]
+  torch::Tensor arithmetic_return{}; // [A]
+};
+
+inline validated_frame_returns_t
+validate_frame(const replay_frame_t &frame, const episode_spec_t &spec,
+               std::size_t offset, const replay_world_options_t &options) {
   const auto expected_anchor = spec.accepted_range.anchor_index_begin +
                                static_cast<std::int64_t>(offset);
   const auto &expected_key = spec.accepted_range.anchor_keys.at(offset);
@@ -424,8 +437,10 @@ inline void validate_frame(const replay_frame_t &frame,
         "next accepted anchor");
   }
   const auto A = static_cast<std::int64_t>(spec.target_node_ids.size());
-  auto log_return = require_realized_log_return(frame, A, options);
-  (void)realized_arithmetic_return(frame, log_return, A, options);
+  validated_frame_returns_t returns{};
+  returns.log_return = require_realized_log_return(frame, A, options);
+  returns.arithmetic_return =
+      realized_arithmetic_return(frame, returns.log_return, A, options);
   auto state = portfolio_state_or_default(frame.observation, spec);
   portfolio::validate_portfolio_state(state, A);
   validate_portfolio_state_matches_episode(state, spec);
@@ -435,6 +450,45 @@ inline void validate_frame(const replay_frame_t &frame,
   validate_frame_diagnostic_tensors(frame, A,
                                     options.require_projection_validation);
   validate_observation_beliefs_match_frame(frame.observation, spec);
+  return returns;
+}
+
+// Digest of every EpisodeSpec and option field that validate_frame reads.
+// Frames validated under one digest stay valid for any spec with the same
+// digest, since the world owns its frames and never mutates them.
+[[nodiscard]] inline std::uint64_t
+frame_validation_digest(const episode_spec_t &spec,
+                        const replay_world_options_t &options) {
+  using cuwacunu::wikimyei::assembly::assembly_detail::kFnvOffsetBasis;
+  using cuwacunu::wikimyei::assembly::assembly_detail::mix_hash_string;
+  std::uint64_t hash = kFnvOffsetBasis;
+  mix_hash_string(hash, "kikijyeba.environment.replay.frame_validation.v1");
+  mix_hash_string(hash,
+                  std::to_string(spec.accepted_range.anchor_index_begin));
+  mix_hash_string(hash, std::to_string(spec.accepted_range.anchor_keys.size()));
+  for (const auto &key : spec.accepted_range.anchor_keys) {
+    mix_hash_string(hash, key);
+  }
+  mix_hash_string(hash, std::to_string(spec.target_node_ids.size()));
+  for (const auto &node_id : spec.target_node_ids) {
+    mix_hash_string(hash, node_id);
+  }
+  mix_hash_string(hash, std::to_string(spec.graph_node_ids.size()));
+  for (const auto &node_id : spec.graph_node_ids) {
+    mix_hash_string(hash, node_id);
+  }
+  mix_hash_string(hash, spec.graph_order_fingerprint);
+  mix_hash_string(hash, spec.base_policy.accounting_numeraire_id);
+  mix_hash_string(hash, spec.base_policy.settlement_asset_id);
+  mix_hash_string(hash, spec.base_policy.projection_reference_node_id);
+  std::ostringstream numeric;
+  numeric.precision(17);
+  numeric << spec.initial_equity_numeraire << ' '
+          << options.realized_return_consistency_tolerance << ' '
+          << options.require_realized_log_return << ' '
+          << options.require_projection_validation;
+  mix_hash_string(hash, numeric.str());
+  return hash;
 }
 
 inline void validate_frame_sequence(const replay_frame_t &current,
@@ -809,35 +863,21 @@ public:
                           replay_world_options_t options = {})
       : frames_(std::move(frames)), options_(options) {}
 
+  // Validates every frame against `spec` up front, so a reset with the same
+  // spec only checks episode-level invariants.
+  replay_world_t(std::vector<replay_frame_t> frames,
+                 replay_world_options_t options, const episode_spec_t &spec)
+      : frames_(std::move(frames)), options_(options) {
+    validate_episode_(spec);
+    validate_frames_(spec);
+  }
+
   [[nodiscard]] observation_t reset(const episode_spec_t &spec) override {
-    validate_episode_spec(spec);
-    validate_replay_world_options(options_);
-    if (spec.world_mode != world_mode_t::historical_replay) {
-      throw std::runtime_error(
-          "[replay_world] V1 requires historical_replay world mode");
-    }
-    if (spec.require_projection_validation &&
-        !options_.require_projection_validation) {
-      throw std::runtime_error(
-          "[replay_world] EpisodeSpec requires projection validation but "
-          "replay_world_options disabled it");
-    }
-    const auto expected_frame_count =
-        static_cast<std::size_t>(spec.accepted_range.anchor_index_end -
-                                 spec.accepted_range.anchor_index_begin);
-    if (frames_.size() != expected_frame_count) {
-      throw std::runtime_error(
-          "[replay_world] frame count must match accepted anchor range");
-    }
+    validate_episode_(spec);
+    validate_frames_(spec);
     spec_ = spec;
     step_index_ = 0;
     active_ = true;
-    for (std::size_t i = 0; i < frames_.size(); ++i) {
-      detail::validate_frame(frames_[i], spec_, i, options_);
-      if (i + 1 < frames_.size()) {
-        detail::validate_frame_sequence(frames_[i], frames_[i + 1]);
-      }
-    }
     current_portfolio_ =
         detail::portfolio_state_or_default(frames_.front().observation, spec_);
     portfolio::validate_portfolio_state(
@@ -851,6 +891,7 @@ public:
   }
 
   [[nodiscard]] transition_t step(const action_t &action) override {
+    PIAABO_TRACE_SPAN("kikijyeba", "replay_world.step");
     if (!active_) {
       throw std::runtime_error(
           "[replay_world] reset must be called before step");
@@ -865,9 +906,9 @@ public:
     validate_action_time_boundary(action, frame.observation);
     const auto decision_timestamp_ms =
         resolve_action_decision_timestamp(action, frame.observation);
-    auto log_return = detail::require_realized_log_return(frame, A, options_);
-    auto arithmetic_return =
-        detail::realized_arithmetic_return(frame, log_return, A, options_);
+    const auto &log_return = frame_returns_[step_index_].log_return;
+    const auto &arithmetic_return =
+        frame_returns_[step_index_].arithmetic_return;
 
     transition_t transition{};
     transition.info.anchor_key = frame.observation.anchor_key;
@@ -999,8 +1040,57 @@ public:
   [[nodiscard]] std::size_t step_index() const { return step_index_; }
 
 private:
+  void validate_episode_(const episode_spec_t &spec) const {
+    validate_episode_spec(spec);
+    validate_replay_world_options(options_);
+    if (spec.world_mode != world_mode_t::historical_replay) {
+      throw std::runtime_error(
+          "[replay_world] V1 requires historical_replay world mode");
+    }
+    if (spec.require_projection_validation &&
+        !options_.require_projection_validation) {
+      throw std::runtime_error(
+          "[replay_world] EpisodeSpec requires projection validation but "
+          "replay_world_options disabled it");
+    }
+    const auto expected_frame_count =
+        static_cast<std::size_t>(spec.accepted_range.anchor_index_end -
+                                 spec.accepted_range.anchor_index_begin);
+    if (frames_.size() != expected_frame_count) {
+      throw std::runtime_error(
+          "[replay_world] frame count must match accepted anchor range");
+    }
+  }
+
+  // Full per-frame validation runs once per validation digest. It also keeps
+  // the float64 realized returns it checked, so step() does not convert and
+  // re-check them on every transition.
+  void validate_frames_(const episode_spec_t &spec) {
+    const auto digest = detail::frame_validation_digest(spec, options_);
+    if (frames_validated_ && digest == validated_digest_ &&
+        !options_.revalidate_frames_on_reset) {
+      return;
+    }
+    PIAABO_TRACE_SPAN("kikijyeba", "replay_world.validate_frames");
+    frames_validated_ = false;
+    frame_returns_.clear();
+    frame_returns_.reserve(frames_.size());
+    for (std::size_t i = 0; i < frames_.size(); ++i) {
+      frame_returns_.push_back(
+          detail::validate_frame(frames_[i], spec, i, options_));
+      if (i + 1 < frames_.size()) {
+        detail::validate_frame_sequence(frames_[i], frames_[i + 1]);
+      }
+    }
+    validated_digest_ = digest;
+    frames_validated_ = true;
+  }
+
   std::vector<replay_frame_t> frames_{};
   replay_world_options_t options_{};
+  std::vector<detail::validated_frame_returns_t> frame_returns_{};
+  std::uint64_t validated_digest_{0};
+  bool frames_validated_{false};
   episode_spec_t spec_{};
   portfolio::PortfolioState current_portfolio_{};
   double peak_equity_numeraire_{0.0};
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -195,13 +196,22 @@ split_tokens(const std::string &text) {
   return out;
 }
 
+// One contiguous host float64 copy of `values`, flattened. Trace formatting
+// and per-node diagnostics read it through data_ptr instead of issuing one
+// item() dispatch per element.
+[[nodiscard]] inline torch::Tensor
+host_float64_values(const torch::Tensor &values) {
+  return values.to(torch::kCPU, torch::kFloat64).contiguous().view({-1});
+}
+
 [[nodiscard]] inline std::string
 format_node_weights(const std::vector<std::string> &node_ids,
                     const torch::Tensor &weights) {
   if (!weights.defined()) {
     return {};
   }
-  auto values = weights.to(torch::kFloat64).contiguous().view({-1});
+  const auto values = host_float64_values(weights);
+  const auto *data = values.data_ptr<double>();
   std::ostringstream out;
   for (std::int64_t i = 0; i < values.numel(); ++i) {
     if (i != 0) {
@@ -212,7 +222,7 @@ format_node_weights(const std::vector<std::string> &node_ids,
     } else {
       out << "asset_" << i;
     }
-    out << ":" << values.index({i}).item<double>();
+    out << ":" << data[i];
   }
   return out.str();
 }
@@ -223,7 +233,8 @@ format_node_scalars(const std::vector<std::string> &node_ids,
   if (!values.defined()) {
     return {};
   }
-  auto scalars = values.to(torch::kFloat64).contiguous().view({-1});
+  const auto scalars = host_float64_values(values);
+  const auto *data = scalars.data_ptr<double>();
   std::ostringstream out;
   for (std::int64_t i = 0; i < scalars.numel(); ++i) {
     if (i != 0) {
@@ -234,7 +245,7 @@ format_node_scalars(const std::vector<std::string> &node_ids,
     } else {
       out << "asset_" << i;
     }
-    out << ":" << scalars.index({i}).item<double>();
+    out << ":" << data[i];
   }
   return out.str();
 }
@@ -327,14 +338,8 @@ negative_unit_count(const torch::Tensor &units, double tolerance = 1.0e-10) {
   if (!units.defined() || units.numel() == 0) {
     return 0;
   }
-  auto flat = units.to(torch::kFloat64).cpu().contiguous().view({-1});
-  std::uint64_t out = 0;
-  for (std::int64_t i = 0; i < flat.numel(); ++i) {
-    if (flat.index({i}).item<double>() < -tolerance) {
-      ++out;
-    }
-  }
-  return out;
+  return static_cast<std::uint64_t>(
+      units.to(torch::kFloat64).lt(-tolerance).sum().item<std::int64_t>());
 }
 
 struct node_projection_series_t {
@@ -361,87 +366,85 @@ inline void append_node_projection_samples(
   if (A <= 0) {
     return;
   }
-  auto predicted =
-      projection_validation.predicted_log_return.to(torch::kFloat64)
-          .cpu()
-          .contiguous()
-          .view({-1});
-  auto realized = projection_validation.realized_log_return.to(torch::kFloat64)
-                      .cpu()
-                      .contiguous()
-                      .view({-1});
-  auto error = projection_validation.error.to(torch::kFloat64)
-                   .cpu()
-                   .contiguous()
-                   .view({-1});
-  auto abs_error = projection_validation.abs_error.to(torch::kFloat64)
-                       .cpu()
-                       .contiguous()
-                       .view({-1});
-  auto squared_error =
-      projection_validation.squared_error.defined()
-          ? projection_validation.squared_error.to(torch::kFloat64)
-                .cpu()
-                .contiguous()
-                .view({-1})
-          : error.pow(2);
-  auto active =
+  const auto device = projection_validation.error.device();
+  const auto f64 = torch::TensorOptions().dtype(torch::kFloat64).device(device);
+  const auto flat = [&](const torch::Tensor &t) {
+    return t.to(device, torch::kFloat64).reshape({-1});
+  };
+  const auto error = flat(projection_validation.error);
+  const auto active =
       projection_validation.active_mask.defined()
-          ? projection_validation.active_mask.to(torch::kBool)
-                .cpu()
-                .contiguous()
-                .view({-1})
-          : torch::ones({A}, torch::TensorOptions().dtype(torch::kBool));
-  auto interval_hit =
-      projection_validation.interval_hit.defined()
-          ? projection_validation.interval_hit.to(torch::kFloat64)
-                .cpu()
-                .contiguous()
-                .view({-1})
-          : torch::full({A}, std::numeric_limits<double>::quiet_NaN(),
-                        torch::TensorOptions().dtype(torch::kFloat64));
-  auto interval_width =
-      projection_validation.interval_width.defined()
-          ? projection_validation.interval_width.to(torch::kFloat64)
-                .cpu()
-                .contiguous()
-                .view({-1})
-          : torch::full({A}, std::numeric_limits<double>::quiet_NaN(),
-                        torch::TensorOptions().dtype(torch::kFloat64));
-
-  const auto count = std::min<std::int64_t>(
-      {A, predicted.numel(), realized.numel(), error.numel(), abs_error.numel(),
-       squared_error.numel(), active.numel()});
-  for (std::int64_t i = 0; i < count; ++i) {
-    if (!active.index({i}).item<bool>()) {
-      continue;
+          ? projection_validation.active_mask.to(device, torch::kBool)
+                .reshape({-1})
+          : torch::ones({A}, torch::TensorOptions()
+                                 .dtype(torch::kBool)
+                                 .device(device));
+  const std::array<torch::Tensor, 5> core{
+      flat(projection_validation.predicted_log_return),
+      flat(projection_validation.realized_log_return), error,
+      flat(projection_validation.abs_error),
+      projection_validation.squared_error.defined()
+          ? flat(projection_validation.squared_error)
+          : error.pow(2)};
+  std::int64_t count = std::min(A, active.numel());
+  for (const auto &column : core) {
+    count = std::min(count, column.numel());
+  }
+  if (count <= 0) {
+    return;
+  }
+  // Optional interval columns are NaN-padded to `count`; NaN entries are
+  // skipped below, exactly like an undefined column.
+  const auto padded = [&](const torch::Tensor &t) {
+    auto out =
+        torch::full({count}, std::numeric_limits<double>::quiet_NaN(), f64);
+    if (t.defined()) {
+      const auto values = flat(t);
+      const auto n = std::min(count, values.numel());
+      out.slice(0, 0, n).copy_(values.slice(0, 0, n));
     }
-    const double p = predicted.index({i}).item<double>();
-    const double r = realized.index({i}).item<double>();
-    const double e = error.index({i}).item<double>();
-    const double ae = abs_error.index({i}).item<double>();
-    const double se = squared_error.index({i}).item<double>();
-    if (!std::isfinite(p) || !std::isfinite(r) || !std::isfinite(e) ||
-        !std::isfinite(ae) || !std::isfinite(se)) {
+    return out;
+  };
+
+  // Rows: predicted, realized, error, abs_error, squared_error, interval_hit,
+  // interval_width, keep. `keep` is the active-and-finite mask, reduced on the
+  // tensors' device, so the host sees one [8,count] transfer.
+  std::vector<torch::Tensor> rows;
+  rows.reserve(8);
+  for (const auto &column : core) {
+    rows.push_back(column.slice(0, 0, count));
+  }
+  const auto keep = active.slice(0, 0, count) &
+                    torch::isfinite(torch::stack(rows)).all(0);
+  rows.push_back(padded(projection_validation.interval_hit));
+  rows.push_back(padded(projection_validation.interval_width));
+  rows.push_back(keep.to(torch::kFloat64));
+  const auto host = host_float64_values(torch::stack(rows));
+  const double *data = host.data_ptr<double>();
+  const auto row = [&](std::int64_t r) { return data + r * count; };
+  const double *predicted = row(0);
+  const double *realized = row(1);
+  const double *err = row(2);
+  const double *abs_error = row(3);
+  const double *sq_error = row(4);
+  const double *interval_hit = row(5);
+  const double *interval_width = row(6);
+  const double *kept = row(7);
+  for (std::int64_t i = 0; i < count; ++i) {
+    if (kept[i] == 0.0) {
       continue;
     }
     auto &node = series[static_cast<std::size_t>(i)];
-    node.predicted.push_back(p);
-    node.realized.push_back(r);
-    node.error.push_back(e);
-    node.abs_error.push_back(ae);
-    node.squared_error.push_back(se);
-    if (i < interval_hit.numel()) {
-      const double hit = interval_hit.index({i}).item<double>();
-      if (std::isfinite(hit)) {
-        node.interval_hit.push_back(hit);
-      }
+    node.predicted.push_back(predicted[i]);
+    node.realized.push_back(realized[i]);
+    node.error.push_back(err[i]);
+    node.abs_error.push_back(abs_error[i]);
+    node.squared_error.push_back(sq_error[i]);
+    if (std::isfinite(interval_hit[i])) {
+      node.interval_hit.push_back(interval_hit[i]);
     }
-    if (i < interval_width.numel()) {
-      const double width = interval_width.index({i}).item<double>();
-      if (std::isfinite(width)) {
-        node.interval_width.push_back(width);
-      }
+    if (std::isfinite(interval_width[i])) {
+      node.interval_width.push_back(interval_width[i]);
     }
   }
 }
@@ -1290,10 +1293,13 @@ make_step_report(std::uint64_t step_index, const observation_t &observation,
         auto diff =
             (executed_weights.slice(0, 0, n) - target_weights.slice(0, 0, n))
                 .abs();
-        out.target_weight_error_l1 = diff.sum().item<double>();
-        out.target_weight_error_linf = diff.max().item<double>();
-        out.post_execution_target_weight_sum =
-            executed_weights.slice(0, 0, n).sum().item<double>();
+        const auto stats = host_float64_values(
+            torch::stack({diff.sum(), diff.max(),
+                          executed_weights.slice(0, 0, n).sum()}));
+        const auto *values = stats.data_ptr<double>();
+        out.target_weight_error_l1 = values[0];
+        out.target_weight_error_linf = values[1];
+        out.post_execution_target_weight_sum = values[2];
       }
     }
     const auto numeraire_it = std::find(
@@ -18,6 +18,7 @@
 #include "kikijyeba/environment/replay/bundle_source.h"
 #include "kikijyeba/environment/replay/source.h"
 #include "kikijyeba/environment/run/episode_runner.h"
+#include "piaabo/tensor/torch/compute_profile.h"
 
 namespace cuwacunu::kikijyeba::environment {
 
@@ -33,6 +34,11 @@ struct replay_experiment_options_t {
   episode_runner_options_t episode_options{};
   bool continue_on_failure{false};
   std::size_t max_parallel_jobs{1}; // 0 selects hardware_concurrency.
+  // Cores one worker keeps busy under its Torch thread budget; 0 leaves the
+  // worker count uncapped. See piaabo/tensor/torch/compute_profile.h.
+  std::size_t cores_per_job{0};
+  // Workers run their episodes under c10::InferenceMode.
+  bool inference_mode{false};
 };
 
 namespace experiment_runner_detail {
@@ -261,11 +267,18 @@ max_episode_metric(const std::vector<episode_report_t> &reports,
 }
 
 [[nodiscard]] inline std::size_t
-resolve_parallelism(std::size_t requested_max_parallel_jobs) {
-  if (requested_max_parallel_jobs == 0) {
-    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
-  }
-  return std::max<std::size_t>(1, requested_max_parallel_jobs);
+resolve_parallelism(std::size_t requested_max_parallel_jobs,
+                    std::size_t cores_per_job = 0) {
+  namespace compute = cuwacunu::piaabo::tensor::torch;
+  const std::size_t requested =
+      requested_max_parallel_jobs == 0
+          ? compute::available_compute_cores()
+          : std::max<std::size_t>(1, requested_max_parallel_jobs);
+  if (cores_per_job == 0) {
+    return requested;
+  }
+  return compute::parallel_jobs_within_core_budget(
+      requested, cores_per_job, compute::available_compute_cores());
 }
 
 struct replay_experiment_task_t {
@@ -286,14 +299,14 @@ struct replay_experiment_task_result_t {
 [[nodiscard]] inline replay_experiment_task_result_t
 run_task(replay_experiment_task_t task, replay::replay_episode_bundle_t bundle,
          replay_policy_factory_t factory,
-         episode_runner_options_t episode_options) {
+         episode_runner_options_t episode_options, bool inference_mode) {
+  // InferenceMode is thread-local, so each worker opens its own.
+  c10::InferenceMode inference_guard(inference_mode);
   replay_experiment_task_result_t result{};
   result.task_index = task.task_index;
   result.bundle_index = task.bundle_index;
   result.policy_id = factory.policy_id;
   try {
-    replay::validate_replay_episode_bundle_ready_for_world(bundle);
-    auto spec = bundle.spec;
     auto policy = factory.make_policy(bundle);
     if (!policy) {
       throw std::runtime_error(
@@ -311,7 +324,11 @@ run_task(replay_experiment_task_t task, replay::replay_episode_bundle_t bundle,
           std::string(policy_kind_name(policy->policy_kind())) +
           " != " + policy_kind_name(factory.policy_kind));
     }
+    auto spec = bundle.spec;
     episode_options.reward_options = bundle.world_options.reward_options;
+    // Spawning validates the bundle and its frames once; run_episode's reset
+    // with the same spec then skips per-frame validation. The task owns its
+    // bundle, so the frames move into the world instead of being copied.
     auto world = replay::spawn_replay_world(std::move(bundle));
     result.report = run_episode(*world, *policy, spec, episode_options);
     result.report.experiment_task_index =
@@ -428,6 +445,7 @@ struct replay_experiment_report_t {
 
   std::size_t requested_max_parallel_jobs{1};
   std::size_t resolved_parallelism{1};
+  std::size_t cores_per_job{0};
 
   std::uint64_t attempted_count{0};
   std::uint64_t completed_count{0};
@@ -1200,8 +1218,10 @@ validate_replay_experiment_report(const replay_experiment_report_t &report) {
   replay_experiment_report_t out{};
   out.experiment_id = std::move(experiment_id);
   out.requested_max_parallel_jobs = options.max_parallel_jobs;
+  out.cores_per_job = options.cores_per_job;
   out.resolved_parallelism =
-      experiment_runner_detail::resolve_parallelism(options.max_parallel_jobs);
+      experiment_runner_detail::resolve_parallelism(options.max_parallel_jobs,
+                                                    options.cores_per_job);
 
   std::vector<std::uint64_t> attempted_by_policy(policy_factories.size(), 0);
   std::vector<experiment_runner_detail::replay_experiment_task_t> tasks;
@@ -1243,7 +1263,7 @@ validate_replay_experiment_report(const replay_experiment_report_t &report) {
       const auto task = tasks[next++];
       handle_result(experiment_runner_detail::run_task(
           task, bundles[task.bundle_index], policy_factories[task.policy_index],
-          options.episode_options));
+          options.episode_options, options.inference_mode));
       continue;
     }
 
@@ -1256,12 +1276,14 @@ validate_replay_experiment_report(const replay_experiment_report_t &report) {
       auto bundle = bundles[task.bundle_index];
       auto factory = policy_factories[task.policy_index];
       auto episode_options = options.episode_options;
-      futures.push_back(
-          std::async(std::launch::async, [task, bundle = std::move(bundle),
-                                          factory = std::move(factory),
-                                          episode_options]() mutable {
+      const bool inference_mode = options.inference_mode;
+      futures.push_back(std::async(
+          std::launch::async,
+          [task, bundle = std::move(bundle), factory = std::move(factory),
+           episode_options, inference_mode]() mutable {
             return experiment_runner_detail::run_task(
-                task, std::move(bundle), std::move(factory), episode_options);
+                task, std::move(bundle), std::move(factory), episode_options,
+                inference_mode);
           }));
     }
     for (auto &future : futures) {
@@ -1292,8 +1314,10 @@ validate_replay_experiment_report(const replay_experiment_report_t &report) {
   replay_experiment_report_t out{};
   out.experiment_id = std::move(experiment_id);
   out.requested_max_parallel_jobs = options.max_parallel_jobs;
+  out.cores_per_job = options.cores_per_job;
   out.resolved_parallelism =
-      experiment_runner_detail::resolve_parallelism(options.max_parallel_jobs);
+      experiment_runner_detail::resolve_parallelism(options.max_parallel_jobs,
+                                                    options.cores_per_job);
   std::vector<std::uint64_t> attempted_by_policy(policy_factories.size(), 0);
 
   const std::size_t parallelism = out.resolved_parallelism;
@@ -1340,20 +1364,22 @@ validate_replay_experiment_report(const replay_experiment_report_t &report) {
       if (parallelism == 1) {
         handle_result(experiment_runner_detail::run_task(
             task, *bundle, policy_factories[policy_index],
-            options.episode_options));
+            options.episode_options, options.inference_mode));
         continue;
       }
       auto task_bundle = *bundle;
       auto factory = policy_factories[policy_index];
       auto episode_options = options.episode_options;
-      futures.push_back(
-          std::async(std::launch::async,
-                     [task, task_bundle = std::move(task_bundle),
-                      factory = std::move(factory), episode_options]() mutable {
-                       return experiment_runner_detail::run_task(
-                           task, std::move(task_bundle), std::move(factory),
-                           episode_options);
-                     }));
+      const bool inference_mode = options.inference_mode;
+      futures.push_back(std::async(
+          std::launch::async,
+          [task, task_bundle = std::move(task_bundle),
+           factory = std::move(factory), episode_options,
+           inference_mode]() mutable {
+            return experiment_runner_detail::run_task(
+                task, std::move(task_bundle), std::move(factory),
+                episode_options, inference_mode);
+          }));
       if (futures.size() >= parallelism) {
         drain_futures();
       }
@@ -22,6 +22,7 @@
 
 #include "hero/runtime_hero/runtime/job_layout.h"
 #include "kikijyeba/environment/output/experience_trace.h"
+#include "kikijyeba/environment/output/experience_trace_columns.h"
 #include "kikijyeba/environment/policy/allocation.h"
 #include "kikijyeba/environment/policy/baseline.h"
 #include "kikijyeba/environment/policy/trainable.h"
@@ -77,14 +78,18 @@ struct runtime_job_replay_driver_options_t {
 
   bool write_report{true};
   std::filesystem::path report_path{};
+  // The columnar store is written next to the text report; readers that
+  // only need the binary trace can turn the text export off.
   bool write_experience_trace{true};
   std::filesystem::path experience_trace_path{};
+  bool write_experience_trace_text{true};
 };
 
 struct runtime_job_replay_driver_result_t {
   replay_experiment_report_t report{};
   std::filesystem::path report_path{};
   std::filesystem::path experience_trace_path{};
+  std::filesystem::path experience_trace_text_path{};
   std::filesystem::path experiment_index_path{};
   std::string config_path{};
   std::size_t replay_bundle_count{0};
@@ -550,6 +555,19 @@ default_experience_trace_path_for_report(
         "[runtime_job_replay_driver] report_path is required for experience "
         "trace sidecar path");
   }
+  return report_path.parent_path() /
+         (report_path.stem().string() + ".experience_trace.columns");
+}
+
+// Text export next to the columnar store, using the report's extension.
+[[nodiscard]] inline std::filesystem::path
+default_experience_trace_text_path_for_report(
+    const std::filesystem::path &report_path) {
+  if (report_path.empty()) {
+    throw std::runtime_error(
+        "[runtime_job_replay_driver] report_path is required for experience "
+        "trace export path");
+  }
   const auto filename =
       report_path.stem().string() + ".experience_trace" +
       (report_path.extension().empty() ? std::string{}
@@ -818,6 +836,7 @@ inline void write_replay_experiment_report(
       << report.requested_max_parallel_jobs << "\n";
   out << "experiment_resolved_parallelism=" << report.resolved_parallelism
       << "\n";
+  out << "experiment_cores_per_job=" << report.cores_per_job << "\n";
   write_kv(out, "top_level_metric_scope",
            "mean_over_completed_episode_reports_across_policies");
   write_kv(out, "policy_metric_scope",
@@ -2004,8 +2023,9 @@ run_runtime_job_replay_experiment(runtime_job_replay_driver_options_t options) {
       replay::read_runtime_replay_job_evidence(options.job_dir);
   auto config_path =
       replay_driver_detail::resolve_driver_config_path(options, evidence);
-  auto contract = replay_driver_detail::protocol::
-      load_channel_graph_first_protocol_contract_from_config(config_path);
+  const auto contract_ref = replay_driver_detail::protocol::
+      load_channel_graph_first_protocol_contract_cached(config_path);
+  const auto &contract = *contract_ref;
   replay_driver_detail::validate_driver_replay_environment_contract(
       contract.replay_environment, options);
   auto market_graph = contract.source_plan.market_graph;
@@ -2031,6 +2051,19 @@ run_runtime_job_replay_experiment(runtime_job_replay_driver_options_t options) {
           : options.experiment_id;
   auto factories = replay_driver_detail::make_driver_policy_factories(
       base_spec, contract.spot_distributional_utility, options);
+  // The replay budget sizes this process's Torch pools; the worker count is
+  // then capped so workers times cores per worker fits the machine.
+  namespace compute = cuwacunu::piaabo::tensor::torch;
+  const auto compute_profile =
+      replay_driver_detail::protocol::load_compute_profile_from_config(
+          config_path);
+  const auto &replay_budget =
+      compute_profile.budget(compute::compute_role_t::replay);
+  compute::apply_compute_thread_budget(replay_budget);
+  options.experiment_options.cores_per_job =
+      compute::compute_cores_per_job(replay_budget);
+  options.experiment_options.inference_mode =
+      compute_profile.uses_inference_mode(compute::compute_role_t::replay);
   auto report = run_replay_experiment(experiment_id, source, factories,
                                       options.experiment_options);
   report.execution_profile_digest = options.execution_profile_digest;
@@ -2038,6 +2071,7 @@ run_runtime_job_replay_experiment(runtime_job_replay_driver_options_t options) {
 
   std::filesystem::path report_path{};
   std::filesystem::path experience_trace_path{};
+  std::filesystem::path experience_trace_text_path{};
   std::filesystem::path experiment_index_path{};
   if (options.write_report) {
     report_path = replay_driver_detail::normalize_report_path(
@@ -2053,8 +2087,15 @@ run_runtime_job_replay_experiment(runtime_job_replay_driver_options_t options) {
               ? replay_driver_detail::default_experience_trace_path_for_report(
                     report_path)
               : options.experience_trace_path);
-      output::write_experience_trace_report(
-          output::make_experience_trace(report), experience_trace_path);
+      const auto experience_trace = output::make_experience_trace(report);
+      output::write_experience_trace_columns(experience_trace,
+                                             experience_trace_path);
+      if (options.write_experience_trace_text) {
+        experience_trace_text_path = replay_driver_detail::
+            default_experience_trace_text_path_for_report(report_path);
+        output::write_experience_trace_report(experience_trace,
+                                              experience_trace_text_path);
+      }
     }
     append_runtime_replay_experiment_index_entry(
         options.job_dir,
@@ -2076,6 +2117,7 @@ run_runtime_job_replay_experiment(runtime_job_replay_driver_options_t options) {
       .report = std::move(report),
       .report_path = std::move(report_path),
       .experience_trace_path = std::move(experience_trace_path),
+      .experience_trace_text_path = std::move(experience_trace_text_path),
       .experiment_index_path = std::move(experiment_index_path),
       .config_path = std::move(config_path),
       .replay_bundle_count = replay_bundle_count,
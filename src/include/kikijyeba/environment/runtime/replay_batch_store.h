@@ -0,0 +1,359 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <torch/torch.h>
+
+#include "piaabo/io/mapped_file.h"
+
+// Append-only store of named-tensor records, one file per job.
+//
+// Each record is a 64-byte aligned header, a fixed-width tensor directory and
+// 64-byte aligned raw payloads. Writers append a record and publish its byte
+// offset through an index; readers map the file and return CPU tensors that
+// alias the mapping, so loading a record costs a bounds check per tensor
+// rather than an archive unpickle. Appends hold an exclusive flock on the store
+// and fsync the record before returning its offset, so an index never publishes
+// an offset whose bytes are not durable, and a torn append past the last
+// indexed offset is never referenced.
+
+namespace cuwacunu::kikijyeba::environment::replay {
+
+using replay_batch_store_tensors_t =
+    std::vector<std::pair<std::string, torch::Tensor>>;
+
+namespace replay_batch_store_detail {
+
+inline constexpr std::array<char, 8> kRecordMagic{'C', 'W', 'R', 'B',
+                                                  'A', 'T', '0', '1'};
+inline constexpr std::uint32_t kRecordVersion = 1;
+inline constexpr std::uint64_t kDataAlignment = 64;
+inline constexpr std::size_t kMaxDims = 8;
+inline constexpr std::size_t kNameBytes = 56;
+
+enum class stored_dtype_t : std::uint8_t {
+  float64 = 0,
+  float32 = 1,
+  int64 = 2,
+  bool8 = 3,
+};
+
+struct record_header_t {
+  std::array<char, 8> magic{kRecordMagic};
+  std::uint32_t version{kRecordVersion};
+  std::uint32_t tensor_count{0};
+  std::uint64_t record_bytes{0};
+  std::array<std::uint64_t, 5> reserved{};
+};
+static_assert(sizeof(record_header_t) == 64);
+
+// `offset` is relative to the start of the record.
+struct tensor_entry_t {
+  std::array<char, kNameBytes> name{};
+  std::uint8_t dtype{0};
+  std::uint8_t ndim{0};
+  std::array<std::uint8_t, 6> reserved{};
+  std::array<std::int64_t, kMaxDims> sizes{};
+  std::uint64_t offset{0};
+  std::uint64_t nbytes{0};
+};
+
+[[nodiscard]] inline std::uint64_t align_up(std::uint64_t value) {
+  return (value + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+[[nodiscard]] inline stored_dtype_t stored_dtype(torch::ScalarType dtype,
+                                                 const std::string &name) {
+  switch (dtype) {
+  case torch::kFloat64:
+    return stored_dtype_t::float64;
+  case torch::kFloat32:
+    return stored_dtype_t::float32;
+  case torch::kInt64:
+    return stored_dtype_t::int64;
+  case torch::kBool:
+    return stored_dtype_t::bool8;
+  default:
+    throw std::runtime_error("[replay_batch_store] unsupported dtype for " +
+                             name);
+  }
+}
+
+[[noreturn]] inline void
+throw_store_io_error(int fd, const std::string &what,
+                     const std::filesystem::path &path) {
+  const std::string reason = std::strerror(errno);
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  throw std::runtime_error("[replay_batch_store] " + what + " " +
+                           path.string() + ": " + reason);
+}
+
+inline void write_all(int fd, const std::vector<char> &bytes,
+                      const std::filesystem::path &path) {
+  std::size_t written = 0;
+  while (written < bytes.size()) {
+    const ::ssize_t n =
+        ::write(fd, bytes.data() + written, bytes.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw_store_io_error(fd, "failed while appending to", path);
+    }
+    written += static_cast<std::size_t>(n);
+  }
+}
+
+[[nodiscard]] inline torch::ScalarType torch_dtype(stored_dtype_t dtype) {
+  switch (dtype) {
+  case stored_dtype_t::float64:
+    return torch::kFloat64;
+  case stored_dtype_t::float32:
+    return torch::kFloat32;
+  case stored_dtype_t::int64:
+    return torch::kInt64;
+  case stored_dtype_t::bool8:
+    return torch::kBool;
+  }
+  return torch::kFloat64;
+}
+
+} // namespace replay_batch_store_detail
+
+// Appends one record of defined CPU-copyable tensors to `path` and returns the
+// record's byte offset.
+[[nodiscard]] inline std::uint64_t
+append_replay_batch_store_record(const std::filesystem::path &path,
+                                 const replay_batch_store_tensors_t &tensors) {
+  namespace d = replay_batch_store_detail;
+  if (path.empty()) {
+    throw std::runtime_error("[replay_batch_store] store path is required");
+  }
+  if (tensors.empty()) {
+    throw std::runtime_error(
+        "[replay_batch_store] record tensors are required");
+  }
+
+  std::vector<torch::Tensor> payloads;
+  std::vector<d::tensor_entry_t> entries(tensors.size());
+  payloads.reserve(tensors.size());
+  std::uint64_t cursor =
+      d::align_up(sizeof(d::record_header_t) +
+                  entries.size() * sizeof(d::tensor_entry_t));
+  for (std::size_t i = 0; i < tensors.size(); ++i) {
+    const auto &[name, tensor] = tensors[i];
+    if (name.empty() || name.size() >= d::kNameBytes) {
+      throw std::runtime_error("[replay_batch_store] invalid tensor name: " +
+                               name);
+    }
+    if (!tensor.defined() ||
+        tensor.dim() > static_cast<std::int64_t>(d::kMaxDims)) {
+      throw std::runtime_error("[replay_batch_store] tensor " + name +
+                               " must be defined with at most 8 dims");
+    }
+    auto &entry = entries[i];
+    std::memcpy(entry.name.data(), name.data(), name.size());
+    entry.dtype = static_cast<std::uint8_t>(
+        d::stored_dtype(tensor.scalar_type(), name));
+    entry.ndim = static_cast<std::uint8_t>(tensor.dim());
+    for (std::int64_t dim = 0; dim < tensor.dim(); ++dim) {
+      entry.sizes[static_cast<std::size_t>(dim)] = tensor.size(dim);
+    }
+    payloads.push_back(tensor.detach().to(torch::kCPU).contiguous());
+    entry.offset = cursor;
+    entry.nbytes = static_cast<std::uint64_t>(payloads.back().nbytes());
+    cursor = d::align_up(cursor + entry.nbytes);
+  }
+
+  d::record_header_t header{};
+  header.tensor_count = static_cast<std::uint32_t>(entries.size());
+  header.record_bytes = cursor;
+  std::vector<char> record(cursor, 0);
+  std::memcpy(record.data(), &header, sizeof(header));
+  std::memcpy(record.data() + sizeof(header), entries.data(),
+              entries.size() * sizeof(d::tensor_entry_t));
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].nbytes != 0) {
+      std::memcpy(record.data() + entries[i].offset, payloads[i].data_ptr(),
+                  entries[i].nbytes);
+    }
+  }
+
+  if (!path.parent_path().empty()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+  const bool created = !std::filesystem::exists(path);
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) {
+    d::throw_store_io_error(fd, "could not open store", path);
+  }
+  // Single writer per store: the lock keeps the end offset read below valid
+  // until the record is on disk. It is released when the descriptor closes.
+  if (::flock(fd, LOCK_EX) != 0) {
+    d::throw_store_io_error(fd, "could not lock store", path);
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    d::throw_store_io_error(fd, "could not stat store", path);
+  }
+  const auto end = static_cast<std::uint64_t>(st.st_size);
+  const std::uint64_t offset = d::align_up(end);
+  const std::vector<char> padding(offset - end, 0);
+  d::write_all(fd, padding, path);
+  d::write_all(fd, record, path);
+  if (::fsync(fd) != 0) {
+    d::throw_store_io_error(fd, "could not fsync", path);
+  }
+  ::close(fd);
+  if (created) {
+    const auto parent = path.has_parent_path() ? path.parent_path()
+                                               : std::filesystem::path(".");
+    const int dir_fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+      (void)::fsync(dir_fd);
+      ::close(dir_fd);
+    }
+  }
+  return offset;
+}
+
+// Memory-mapped reader. Records appended after the reader was opened are not
+// visible to it.
+class replay_batch_store_reader_t {
+public:
+  explicit replay_batch_store_reader_t(std::filesystem::path path)
+      : path_(std::move(path)),
+        file_(std::make_shared<cuwacunu::piaabo::io::mapped_file_t>(path_)) {}
+
+  [[nodiscard]] const std::filesystem::path &path() const { return path_; }
+
+  // True when a record starting at `offset` was already in the file when the
+  // reader mapped it.
+  [[nodiscard]] bool covers(std::uint64_t offset) const {
+    return offset < file_->size();
+  }
+
+  // Returns the record's tensors as CPU views over the mapping.
+  [[nodiscard]] std::unordered_map<std::string, torch::Tensor>
+  record(std::uint64_t offset) const {
+    namespace d = replay_batch_store_detail;
+    d::record_header_t header{};
+    if (offset % d::kDataAlignment != 0 ||
+        !file_->contains(offset, sizeof(header))) {
+      throw std::runtime_error(
+          "[replay_batch_store] record offset out of range in " +
+          path_.string());
+    }
+    std::memcpy(&header, file_->data() + offset, sizeof(header));
+    const auto directory_bytes =
+        static_cast<std::uint64_t>(header.tensor_count) *
+        sizeof(d::tensor_entry_t);
+    if (header.magic != d::kRecordMagic ||
+        header.version != d::kRecordVersion ||
+        !file_->contains(offset, header.record_bytes) ||
+        sizeof(header) + directory_bytes > header.record_bytes) {
+      throw std::runtime_error("[replay_batch_store] malformed record in " +
+                               path_.string());
+    }
+    std::vector<d::tensor_entry_t> entries(header.tensor_count);
+    std::memcpy(entries.data(), file_->data() + offset + sizeof(header),
+                directory_bytes);
+
+    std::unordered_map<std::string, torch::Tensor> out;
+    out.reserve(entries.size());
+    for (const auto &entry : entries) {
+      const auto name_end =
+          std::find(entry.name.begin(), entry.name.end(), '\0');
+      std::string name(entry.name.begin(), name_end);
+      if (entry.dtype > static_cast<std::uint8_t>(d::stored_dtype_t::bool8) ||
+          entry.ndim > d::kMaxDims || entry.offset % d::kDataAlignment != 0 ||
+          entry.offset > header.record_bytes ||
+          entry.nbytes > header.record_bytes - entry.offset) {
+        throw std::runtime_error("[replay_batch_store] malformed tensor " +
+                                 name + " in " + path_.string());
+      }
+      const auto dtype =
+          d::torch_dtype(static_cast<d::stored_dtype_t>(entry.dtype));
+      std::vector<std::int64_t> sizes(entry.sizes.begin(),
+                                      entry.sizes.begin() + entry.ndim);
+      std::int64_t numel = 1;
+      for (const auto size : sizes) {
+        if (size < 0) {
+          throw std::runtime_error("[replay_batch_store] negative size in " +
+                                   name);
+        }
+        numel *= size;
+      }
+      if (static_cast<std::uint64_t>(numel) *
+              static_cast<std::uint64_t>(c10::elementSize(dtype)) !=
+          entry.nbytes) {
+        throw std::runtime_error("[replay_batch_store] size mismatch in " +
+                                 name);
+      }
+      const auto options = torch::TensorOptions().dtype(dtype);
+      torch::Tensor tensor;
+      if (numel == 0) {
+        tensor = torch::empty(sizes, options);
+      } else {
+        auto keep_alive = file_;
+        tensor = torch::from_blob(
+            file_->data() + offset + entry.offset, sizes,
+            [keep_alive](void *) mutable { keep_alive.reset(); }, options);
+      }
+      if (!out.emplace(std::move(name), std::move(tensor)).second) {
+        throw std::runtime_error("[replay_batch_store] duplicate tensor in " +
+                                 path_.string());
+      }
+    }
+    return out;
+  }
+
+private:
+  std::filesystem::path path_{};
+  std::shared_ptr<cuwacunu::piaabo::io::mapped_file_t> file_{};
+};
+
+// Readers keyed by store path. A replay source holds one set for its lifetime,
+// so each store is mapped once rather than on every batch load. A reader is
+// remapped only when asked for a record appended after it was opened; tensors
+// from the previous mapping keep that mapping alive.
+class replay_batch_store_readers_t {
+public:
+  [[nodiscard]] const replay_batch_store_reader_t &
+  reader_for(const std::filesystem::path &path, std::uint64_t offset) {
+    auto it = readers_.find(path.string());
+    if (it == readers_.end()) {
+      it = readers_.emplace(path.string(), replay_batch_store_reader_t(path))
+               .first;
+    } else if (!it->second.covers(offset)) {
+      it->second = replay_batch_store_reader_t(path);
+    }
+    return it->second;
+  }
+
+  [[nodiscard]] std::size_t size() const { return readers_.size(); }
+
+private:
+  std::unordered_map<std::string, replay_batch_store_reader_t> readers_{};
+};
+
+} // namespace cuwacunu::kikijyeba::environment::replay
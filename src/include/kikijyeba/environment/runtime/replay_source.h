@@ -5,7 +5,9 @@
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -21,6 +23,7 @@
 #include "hero/runtime_hero/runtime/job_manifest.h"
 #include "hero/runtime_hero/runtime/wave_plan.h"
 #include "kikijyeba/environment/replay/bundle_source.h"
+#include "kikijyeba/environment/runtime/replay_batch_store.h"
 #include "kikijyeba/topology/graph/graph.h"
 #include "wikimyei/inference/expected_value/mdn/stream/mdn_adapter.h"
 #include "wikimyei/observer/belief/builder.h"
@@ -149,28 +152,6 @@ tensor_or_empty_cpu(const torch::Tensor &tensor,
   return cpu;
 }
 
-inline void write_string(torch::serialize::OutputArchive &root,
-                         const std::string &key, const std::string &value) {
-  forecast::detail::write_string(root, key, value);
-}
-
-inline void read_string(torch::serialize::InputArchive &root,
-                        const std::string &key, std::string *out) {
-  forecast::detail::read_string(root, key, out);
-}
-
-inline void write_string_list(torch::serialize::OutputArchive &root,
-                              const std::string &key_prefix,
-                              const std::vector<std::string> &values) {
-  forecast::detail::write_string_list(root, key_prefix, values);
-}
-
-inline void read_string_list(torch::serialize::InputArchive &root,
-                             const std::string &key_prefix,
-                             std::vector<std::string> *out) {
-  forecast::detail::read_string_list(root, key_prefix, out);
-}
-
 template <typename KeyT>
 [[nodiscard]] torch::Tensor
 key_vector_to_tensor(const std::vector<KeyT> &values) {
@@ -256,9 +237,13 @@ inline constexpr const char *kRuntimeReplayArtifactPathIndexSchema =
 inline constexpr const char *kRuntimeReplayBatchIndexSchema =
     "kikijyeba.environment.replay.runtime_batch_index.v1";
 
+// When graph_anchor_edge_batch_store_offset is set, the batch artifact path
+// names the job's consolidated replay batch store and the batch is the record
+// at that offset; otherwise it names a per-batch torch archive.
 struct runtime_replay_artifact_paths_t {
   std::filesystem::path graph_anchor_edge_batch_artifact_path{};
   std::filesystem::path observation_artifact_index_path{};
+  std::optional<std::uint64_t> graph_anchor_edge_batch_store_offset{};
 };
 
 struct runtime_replay_batch_index_entry_t {
@@ -515,18 +500,25 @@ make_runtime_replay_forecast_records_from_mdn_batch(
     target_coords_fingerprint =
         replay_runtime_detail::target_coords_fingerprint(batch.target_coords);
   }
+  // One batched build: every observer utility runs once over all B anchors.
+  belief::allocation_belief_batch_builder_options_t batch_options{};
+  batch_options.common = std::move(common_options);
+  batch_options.anchor_keys.reserve(static_cast<std::size_t>(B));
+  batch_options.timestamps_ms.reserve(static_cast<std::size_t>(B));
+  for (const auto &key : anchor_keys) {
+    batch_options.anchor_keys.push_back(
+        replay_source_detail::key_to_string(key));
+    batch_options.timestamps_ms.push_back(
+        replay_source_detail::to_i64_checked(key));
+  }
+  const auto batch_result =
+      belief::build_allocation_belief_batch_result(cpu_out, batch_options);
 
   std::vector<runtime_replay_forecast_artifact_record_t> records;
   records.reserve(static_cast<std::size_t>(B));
   for (std::int64_t b = 0; b < B; ++b) {
-    auto options = common_options;
-    options.anchor_slot = b;
-    options.anchor_key = replay_source_detail::key_to_string(
-        anchor_keys[static_cast<std::size_t>(b)]);
-    options.timestamp_ms = replay_source_detail::to_i64_checked(
-        anchor_keys[static_cast<std::size_t>(b)]);
-    auto build_result =
-        belief::build_single_anchor_allocation_belief(cpu_out, options);
+    auto build_result = belief::select_anchor_build_result(
+        batch_result, b, batch_options.common.scenario_bank_options);
     std::optional<std::int64_t> observation_anchor_index{};
     if (batch.cursor.anchor_indices.size() == static_cast<std::size_t>(B)) {
       observation_anchor_index = replay_source_detail::to_i64_checked(
@@ -549,6 +541,12 @@ inline void save_graph_anchor_edge_batch_artifact(
         &batch,
     const std::filesystem::path &path);
 
+template <typename KeyT>
+[[nodiscard]] inline std::uint64_t append_graph_anchor_edge_batch_to_store(
+    const replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
+        &batch,
+    const std::filesystem::path &store_path);
+
 template <typename KeyT>
 [[nodiscard]] replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
 make_runtime_replay_edge_batch_from_channel_representation(
@@ -667,6 +665,12 @@ runtime_replay_batch_index_path(const std::filesystem::path &job_dir) {
   return runtime_replay_artifact_dir(job_dir) / "runtime_replay_batches.index";
 }
 
+[[nodiscard]] inline std::filesystem::path
+runtime_replay_batch_store_path(const std::filesystem::path &job_dir) {
+  return runtime_replay_artifact_dir(job_dir) /
+         "graph_anchor_edge_batches.store";
+}
+
 [[nodiscard]] inline std::string
 runtime_replay_pulse_leaf(std::size_t wave_pulse_index,
                           std::string batch_cursor_token = {}) {
@@ -786,6 +790,10 @@ inline void write_runtime_replay_artifact_path_index_at(
       << paths.graph_anchor_edge_batch_artifact_path.generic_string() << "\n";
   out << "observation_artifact_index_path="
       << paths.observation_artifact_index_path.generic_string() << "\n";
+  if (paths.graph_anchor_edge_batch_store_offset.has_value()) {
+    out << "graph_anchor_edge_batch_store_offset="
+        << *paths.graph_anchor_edge_batch_store_offset << "\n";
+  }
   replay_runtime_detail::runtime::job_layout::write_text_file_atomically(
       index_path, out.str());
 }
@@ -829,6 +837,12 @@ read_runtime_replay_artifact_path_index_at(
       layout::map_get(kv, "graph_anchor_edge_batch_artifact_path"), index_dir);
   out.observation_artifact_index_path = resolve_runtime_replay_path(
       layout::map_get(kv, "observation_artifact_index_path"), index_dir);
+  const auto store_offset =
+      layout::map_get(kv, "graph_anchor_edge_batch_store_offset");
+  if (!store_offset.empty()) {
+    out.graph_anchor_edge_batch_store_offset =
+        static_cast<std::uint64_t>(std::stoull(store_offset));
+  }
   validate_runtime_replay_artifact_paths(out);
   return out;
 }
@@ -956,7 +970,8 @@ write_runtime_graph_anchor_replay_artifacts_to_paths(
     const replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
         &batch,
     const std::vector<runtime_replay_forecast_artifact_record_t>
-        &forecast_records) {
+        &forecast_records,
+    bool append_batch_to_store = false) {
   static_assert(std::is_integral_v<KeyT>,
                 "Graph-anchor replay artifact V1 requires integral keys");
   if (artifact_path_index_path.empty()) {
@@ -1018,8 +1033,15 @@ write_runtime_graph_anchor_replay_artifacts_to_paths(
   }
 
   std::filesystem::create_directories(artifact_dir);
-  save_graph_anchor_edge_batch_artifact(
-      batch, paths.graph_anchor_edge_batch_artifact_path);
+  if (append_batch_to_store) {
+    paths.graph_anchor_edge_batch_store_offset =
+        append_graph_anchor_edge_batch_to_store(
+            batch, paths.graph_anchor_edge_batch_artifact_path);
+  } else {
+    paths.graph_anchor_edge_batch_store_offset.reset();
+    save_graph_anchor_edge_batch_artifact(
+        batch, paths.graph_anchor_edge_batch_artifact_path);
+  }
   for (std::size_t i = 0; i < forecast_records.size(); ++i) {
     forecast::save_forecast_artifact(forecast_records[i].forecast_artifact,
                                      forecast_paths[i]);
@@ -1114,7 +1136,9 @@ write_runtime_graph_anchor_replay_artifacts_from_mdn_batch_for_pulse(
   const auto cursor_token = edge_batch.cursor.cursor_token();
   const auto pulse_dir = runtime_replay_pulse_artifact_dir(
       job_dir, wave_pulse_index, cursor_token);
-  const auto paths = default_runtime_replay_artifact_paths_for_dir(pulse_dir);
+  auto paths = default_runtime_replay_artifact_paths_for_dir(pulse_dir);
+  paths.graph_anchor_edge_batch_artifact_path =
+      runtime_replay_batch_store_path(job_dir);
   auto forecast_records = make_runtime_replay_forecast_records_from_mdn_batch(
       out, mdn_batch, std::move(common_options), std::move(mdn_artifact),
       std::move(model_version), std::move(target_coords_fingerprint),
@@ -1122,7 +1146,7 @@ write_runtime_graph_anchor_replay_artifacts_from_mdn_batch_for_pulse(
   const auto written_paths =
       write_runtime_graph_anchor_replay_artifacts_to_paths(
           pulse_dir / "runtime_replay_artifacts.index", paths, edge_batch,
-          forecast_records);
+          forecast_records, /*append_batch_to_store=*/true);
   append_runtime_replay_batch_index_entry(
       job_dir, runtime_replay_batch_index_entry_t{
                    .wave_pulse_index = wave_pulse_index,
@@ -1136,6 +1160,120 @@ write_runtime_graph_anchor_replay_artifacts_from_mdn_batch_for_pulse(
   return written_paths;
 }
 
+namespace replay_runtime_detail {
+
+// Named tensors of a graph-anchor edge batch. The same keys back the
+// per-batch torch archive and the consolidated replay batch store.
+template <typename KeyT>
+[[nodiscard]] replay_batch_store_tensors_t graph_anchor_edge_batch_tensors(
+    const dataloader::graph_anchor_edge_batch_t<KeyT> &batch) {
+  const auto i64 = torch::TensorOptions().dtype(torch::kInt64);
+  const auto string_tensor = [](const std::string &value) {
+    return forecast::detail::int64_tensor_from_vector(
+        forecast::detail::string_to_bytes(value));
+  };
+  auto [edge_id_lengths, edge_id_bytes] =
+      forecast::detail::string_list_to_lengths_and_bytes(batch.edge_ids);
+  return {
+      {"meta/schema", string_tensor(kGraphAnchorEdgeBatchArtifactSchema)},
+      {"meta/graph_order_fingerprint",
+       string_tensor(batch.graph_order_fingerprint)},
+      {"meta/edge_ids/lengths",
+       forecast::detail::int64_tensor_from_vector(edge_id_lengths)},
+      {"meta/edge_ids/bytes",
+       forecast::detail::int64_tensor_from_vector(edge_id_bytes)},
+      {"meta/cursor/begin_anchor_index",
+       torch::tensor(
+           {static_cast<std::int64_t>(batch.cursor.begin_anchor_index)}, i64)},
+      {"meta/cursor/end_anchor_index",
+       torch::tensor(
+           {static_cast<std::int64_t>(batch.cursor.end_anchor_index)}, i64)},
+      {"meta/cursor/requested_batch_size",
+       torch::tensor(
+           {static_cast<std::int64_t>(batch.cursor.requested_batch_size)},
+           i64)},
+      {"meta/cursor/anchor_keys",
+       key_vector_to_tensor(batch.cursor.anchor_keys)},
+      {"meta/cursor/anchor_indices",
+       size_vector_to_tensor(batch.cursor.anchor_indices)},
+      {"tensor/edge_features",
+       tensor_or_empty_cpu(batch.edge_features, torch::kFloat64)},
+      {"tensor/edge_mask", tensor_or_empty_cpu(batch.edge_mask, torch::kBool)},
+      {"tensor/future_features",
+       tensor_or_empty_cpu(batch.future_features, torch::kFloat64)},
+      {"tensor/future_mask",
+       tensor_or_empty_cpu(batch.future_mask, torch::kBool)},
+      {"tensor/past_keys", tensor_or_empty_cpu(batch.past_keys, torch::kInt64)},
+      {"tensor/future_keys",
+       tensor_or_empty_cpu(batch.future_keys, torch::kInt64)},
+      {"tensor/anchor_keys",
+       tensor_or_empty_cpu(batch.anchor_keys, torch::kInt64)},
+      {"tensor/edge_present",
+       tensor_or_empty_cpu(batch.edge_present, torch::kBool)},
+  };
+}
+
+// Rebuilds a batch from its named tensors; `read(key)` returns the tensor
+// stored under `key` or throws.
+template <typename KeyT, typename ReadT>
+[[nodiscard]] dataloader::graph_anchor_edge_batch_t<KeyT>
+graph_anchor_edge_batch_from_tensors(ReadT &&read) {
+  const auto read_text = [&](const std::string &key) {
+    return forecast::detail::bytes_to_string(
+        forecast::detail::tensor_to_int64_vector(read(key)));
+  };
+  const auto read_count = [&](const std::string &key) {
+    return static_cast<std::size_t>(read(key)
+                                        .to(torch::kCPU)
+                                        .to(torch::kInt64)
+                                        .template item<std::int64_t>());
+  };
+  if (read_text("meta/schema") != kGraphAnchorEdgeBatchArtifactSchema) {
+    throw std::runtime_error(
+        "[replay_runtime_source] graph-anchor batch artifact schema mismatch");
+  }
+  const auto graph_order_fingerprint =
+      read_text("meta/graph_order_fingerprint");
+
+  dataloader::graph_anchor_edge_batch_t<KeyT> out{};
+  out.graph_order_fingerprint = graph_order_fingerprint;
+  out.edge_ids = forecast::detail::string_list_from_tensors(
+      read("meta/edge_ids/lengths"), read("meta/edge_ids/bytes"));
+  out.cursor.graph_order_fingerprint = graph_order_fingerprint;
+  out.cursor.begin_anchor_index = read_count("meta/cursor/begin_anchor_index");
+  out.cursor.end_anchor_index = read_count("meta/cursor/end_anchor_index");
+  out.cursor.requested_batch_size =
+      read_count("meta/cursor/requested_batch_size");
+  out.cursor.anchor_keys = tensor_to_key_vector<KeyT>(
+      read("meta/cursor/anchor_keys"), "cursor.anchor_keys");
+  out.cursor.anchor_indices = tensor_to_size_vector(
+      read("meta/cursor/anchor_indices"), "cursor.anchor_indices");
+
+  out.edge_features = read("tensor/edge_features");
+  out.edge_mask = read("tensor/edge_mask");
+  out.future_features = read("tensor/future_features");
+  out.future_mask = read("tensor/future_mask");
+  out.past_keys = read("tensor/past_keys");
+  out.future_keys = read("tensor/future_keys");
+  out.anchor_keys = read("tensor/anchor_keys");
+  out.edge_present = read("tensor/edge_present");
+  if (out.future_features.defined() && out.future_features.numel() == 0) {
+    out.future_features = torch::Tensor{};
+  }
+  if (out.future_mask.defined() && out.future_mask.numel() == 0) {
+    out.future_mask = torch::Tensor{};
+  }
+  if (out.past_keys.defined() && out.past_keys.numel() == 0) {
+    out.past_keys = torch::Tensor{};
+  }
+  if (out.future_keys.defined() && out.future_keys.numel() == 0) {
+    out.future_keys = torch::Tensor{};
+  }
+  return out;
+}
+
+} // namespace replay_runtime_detail
+
 template <typename KeyT>
 inline void save_graph_anchor_edge_batch_artifact(
     const replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
@@ -1151,52 +1289,27 @@ inline void save_graph_anchor_edge_batch_artifact(
     std::filesystem::create_directories(path.parent_path());
   }
   torch::serialize::OutputArchive root;
-  const auto i64 = torch::TensorOptions().dtype(torch::kInt64);
-  replay_runtime_detail::write_string(root, "meta/schema",
-                                      kGraphAnchorEdgeBatchArtifactSchema);
-  replay_runtime_detail::write_string(root, "meta/graph_order_fingerprint",
-                                      batch.graph_order_fingerprint);
-  replay_runtime_detail::write_string_list(root, "meta/edge_ids",
-                                           batch.edge_ids);
-  root.write(
-      "meta/cursor/begin_anchor_index",
-      torch::tensor(
-          {static_cast<std::int64_t>(batch.cursor.begin_anchor_index)}, i64));
-  root.write(
-      "meta/cursor/end_anchor_index",
-      torch::tensor({static_cast<std::int64_t>(batch.cursor.end_anchor_index)},
-                    i64));
-  root.write(
-      "meta/cursor/requested_batch_size",
-      torch::tensor(
-          {static_cast<std::int64_t>(batch.cursor.requested_batch_size)}, i64));
-  root.write(
-      "meta/cursor/anchor_keys",
-      replay_runtime_detail::key_vector_to_tensor(batch.cursor.anchor_keys));
-  root.write("meta/cursor/anchor_indices",
-             replay_runtime_detail::size_vector_to_tensor(
-                 batch.cursor.anchor_indices));
-
-  root.write("tensor/edge_features", replay_runtime_detail::tensor_or_empty_cpu(
-                                         batch.edge_features, torch::kFloat64));
-  root.write("tensor/edge_mask", replay_runtime_detail::tensor_or_empty_cpu(
-                                     batch.edge_mask, torch::kBool));
-  root.write("tensor/future_features",
-             replay_runtime_detail::tensor_or_empty_cpu(batch.future_features,
-                                                        torch::kFloat64));
-  root.write("tensor/future_mask", replay_runtime_detail::tensor_or_empty_cpu(
-                                       batch.future_mask, torch::kBool));
-  root.write("tensor/past_keys", replay_runtime_detail::tensor_or_empty_cpu(
-                                     batch.past_keys, torch::kInt64));
-  root.write("tensor/future_keys", replay_runtime_detail::tensor_or_empty_cpu(
-                                       batch.future_keys, torch::kInt64));
-  root.write("tensor/anchor_keys", replay_runtime_detail::tensor_or_empty_cpu(
-                                       batch.anchor_keys, torch::kInt64));
-  root.write("tensor/edge_present", replay_runtime_detail::tensor_or_empty_cpu(
-                                        batch.edge_present, torch::kBool));
+  for (const auto &[key, tensor] :
+       replay_runtime_detail::graph_anchor_edge_batch_tensors(batch)) {
+    root.write(key, tensor);
+  }
   root.save_to(path.string());
 }
 
+// Appends `batch` to the job's consolidated replay batch store and returns
+// the record offset to publish in the artifact path index.
+template <typename KeyT>
+[[nodiscard]] inline std::uint64_t append_graph_anchor_edge_batch_to_store(
+    const replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
+        &batch,
+    const std::filesystem::path &store_path) {
+  static_assert(std::is_integral_v<KeyT>,
+                "Graph-anchor batch store V1 requires integral keys");
+  return append_replay_batch_store_record(
+      store_path,
+      replay_runtime_detail::graph_anchor_edge_batch_tensors(batch));
+}
+
 template <typename KeyT>
 [[nodiscard]] replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
 load_graph_anchor_edge_batch_artifact(
@@ -1212,69 +1325,61 @@ load_graph_anchor_edge_batch_artifact(
 
   torch::serialize::InputArchive root;
   root.load_from(path.string(), device);
-  std::string schema{};
-  std::string graph_order_fingerprint{};
-  replay_runtime_detail::read_string(root, "meta/schema", &schema);
-  if (schema != kGraphAnchorEdgeBatchArtifactSchema) {
-    throw std::runtime_error(
-        "[replay_runtime_source] graph-anchor batch artifact schema mismatch");
-  }
-  replay_runtime_detail::read_string(root, "meta/graph_order_fingerprint",
-                                     &graph_order_fingerprint);
-  std::vector<std::string> edge_ids;
-  replay_runtime_detail::read_string_list(root, "meta/edge_ids", &edge_ids);
-
-  torch::Tensor begin_anchor_index{};
-  torch::Tensor end_anchor_index{};
-  torch::Tensor requested_batch_size{};
-  torch::Tensor cursor_anchor_keys{};
-  torch::Tensor cursor_anchor_indices{};
-  root.read("meta/cursor/begin_anchor_index", begin_anchor_index);
-  root.read("meta/cursor/end_anchor_index", end_anchor_index);
-  root.read("meta/cursor/requested_batch_size", requested_batch_size);
-  root.read("meta/cursor/anchor_keys", cursor_anchor_keys);
-  root.read("meta/cursor/anchor_indices", cursor_anchor_indices);
+  return replay_runtime_detail::graph_anchor_edge_batch_from_tensors<KeyT>(
+      [&root](const std::string &key) {
+        torch::Tensor tensor{};
+        root.read(key, tensor);
+        return tensor;
+      });
+}
 
-  replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT> out{};
-  out.graph_order_fingerprint = graph_order_fingerprint;
-  out.edge_ids = std::move(edge_ids);
-  out.cursor.graph_order_fingerprint = graph_order_fingerprint;
-  out.cursor.begin_anchor_index =
-      static_cast<std::size_t>(begin_anchor_index.to(torch::kCPU)
-                                   .to(torch::kInt64)
-                                   .item<std::int64_t>());
-  out.cursor.end_anchor_index = static_cast<std::size_t>(
-      end_anchor_index.to(torch::kCPU).to(torch::kInt64).item<std::int64_t>());
-  out.cursor.requested_batch_size =
-      static_cast<std::size_t>(requested_batch_size.to(torch::kCPU)
-                                   .to(torch::kInt64)
-                                   .item<std::int64_t>());
-  out.cursor.anchor_keys = replay_runtime_detail::tensor_to_key_vector<KeyT>(
-      cursor_anchor_keys, "cursor.anchor_keys");
-  out.cursor.anchor_indices = replay_runtime_detail::tensor_to_size_vector(
-      cursor_anchor_indices, "cursor.anchor_indices");
-
-  root.read("tensor/edge_features", out.edge_features);
-  root.read("tensor/edge_mask", out.edge_mask);
-  root.read("tensor/future_features", out.future_features);
-  root.read("tensor/future_mask", out.future_mask);
-  root.read("tensor/past_keys", out.past_keys);
-  root.read("tensor/future_keys", out.future_keys);
-  root.read("tensor/anchor_keys", out.anchor_keys);
-  root.read("tensor/edge_present", out.edge_present);
-  if (out.future_features.defined() && out.future_features.numel() == 0) {
-    out.future_features = torch::Tensor{};
-  }
-  if (out.future_mask.defined() && out.future_mask.numel() == 0) {
-    out.future_mask = torch::Tensor{};
-  }
-  if (out.past_keys.defined() && out.past_keys.numel() == 0) {
-    out.past_keys = torch::Tensor{};
-  }
-  if (out.future_keys.defined() && out.future_keys.numel() == 0) {
-    out.future_keys = torch::Tensor{};
-  }
-  return out;
+// Zero-copy load of one batch record from the consolidated store. On CPU the
+// batch tensors alias the store mapping; other devices receive a copy.
+template <typename KeyT>
+[[nodiscard]] replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
+load_graph_anchor_edge_batch_from_store(
+    const replay_batch_store_reader_t &store, std::uint64_t offset,
+    const torch::Device &device = torch::Device(torch::kCPU)) {
+  static_assert(std::is_integral_v<KeyT>,
+                "Graph-anchor batch store V1 requires integral keys");
+  const auto record = store.record(offset);
+  return replay_runtime_detail::graph_anchor_edge_batch_from_tensors<KeyT>(
+      [&](const std::string &key) {
+        const auto it = record.find(key);
+        if (it == record.end()) {
+          throw std::runtime_error(
+              "[replay_runtime_source] replay batch store record missing " +
+              key);
+        }
+        return device.is_cpu() ? it->second : it->second.to(device);
+      });
+}
+
+// Loads the batch named by an artifact path index: a store record when the
+// index carries a store offset, otherwise a per-batch archive (older jobs).
+// Callers loading many batches pass `store_readers` so the store is mapped
+// once; without it the store is mapped for this load only.
+template <typename KeyT>
+[[nodiscard]] replay_source_detail::dataloader::graph_anchor_edge_batch_t<KeyT>
+load_graph_anchor_edge_batch_for_paths(
+    const runtime_replay_artifact_paths_t &paths,
+    const torch::Device &device = torch::Device(torch::kCPU),
+    replay_batch_store_readers_t *store_readers = nullptr) {
+  if (!paths.graph_anchor_edge_batch_store_offset.has_value()) {
+    return load_graph_anchor_edge_batch_artifact<KeyT>(
+        paths.graph_anchor_edge_batch_artifact_path, device);
+  }
+  const auto offset = *paths.graph_anchor_edge_batch_store_offset;
+  if (store_readers == nullptr) {
+    const replay_batch_store_reader_t store(
+        paths.graph_anchor_edge_batch_artifact_path);
+    return load_graph_anchor_edge_batch_from_store<KeyT>(store, offset,
+                                                         device);
+  }
+  return load_graph_anchor_edge_batch_from_store<KeyT>(
+      store_readers->reader_for(paths.graph_anchor_edge_batch_artifact_path,
+                                offset),
+      offset, device);
 }
 
 [[nodiscard]] inline replay_runtime_detail::runtime::job_manifest_t
@@ -1715,26 +1820,48 @@ template <typename KeyT>
 [[nodiscard]] runtime_graph_anchor_replay_record_t<KeyT>
 make_runtime_graph_anchor_replay_record_from_artifact_paths(
     const runtime_replay_job_evidence_t &evidence, episode_spec_t base_spec,
-    const std::filesystem::path &graph_anchor_edge_batch_artifact_path,
-    const std::filesystem::path &observation_artifact_index_path,
+    const runtime_replay_artifact_paths_t &paths,
     replay_frame_build_options_t frame_options = {},
     replay_world_options_t world_options = {},
     replay_observation_artifact_options_t artifact_options = {},
     bool require_observation_artifacts = true,
-    const torch::Device &device = torch::Device(torch::kCPU)) {
-  auto batch = load_graph_anchor_edge_batch_artifact<KeyT>(
-      graph_anchor_edge_batch_artifact_path, device);
+    const torch::Device &device = torch::Device(torch::kCPU),
+    replay_batch_store_readers_t *store_readers = nullptr) {
+  auto batch = load_graph_anchor_edge_batch_for_paths<KeyT>(paths, device,
+                                                           store_readers);
   auto cursor = batch.cursor;
-  auto artifacts = observation_artifact_index_path.empty()
+  auto artifacts = paths.observation_artifact_index_path.empty()
                        ? std::vector<replay_observation_artifacts_t>{}
                        : load_replay_observation_artifacts_from_index(
-                             observation_artifact_index_path, device);
+                             paths.observation_artifact_index_path, device);
   return make_runtime_graph_anchor_replay_record_from_job_evidence(
       evidence, std::move(base_spec), std::move(cursor), std::move(batch),
       frame_options, world_options, std::move(artifacts), artifact_options,
       require_observation_artifacts);
 }
 
+template <typename KeyT>
+[[nodiscard]] runtime_graph_anchor_replay_record_t<KeyT>
+make_runtime_graph_anchor_replay_record_from_artifact_paths(
+    const runtime_replay_job_evidence_t &evidence, episode_spec_t base_spec,
+    const std::filesystem::path &graph_anchor_edge_batch_artifact_path,
+    const std::filesystem::path &observation_artifact_index_path,
+    replay_frame_build_options_t frame_options = {},
+    replay_world_options_t world_options = {},
+    replay_observation_artifact_options_t artifact_options = {},
+    bool require_observation_artifacts = true,
+    const torch::Device &device = torch::Device(torch::kCPU)) {
+  return make_runtime_graph_anchor_replay_record_from_artifact_paths<KeyT>(
+      evidence, std::move(base_spec),
+      runtime_replay_artifact_paths_t{
+          .graph_anchor_edge_batch_artifact_path =
+              graph_anchor_edge_batch_artifact_path,
+          .observation_artifact_index_path = observation_artifact_index_path,
+      },
+      frame_options, world_options, artifact_options,
+      require_observation_artifacts, device);
+}
+
 template <typename KeyT>
 [[nodiscard]] runtime_graph_anchor_replay_record_t<KeyT>
 make_runtime_graph_anchor_replay_record_from_job_dir(
@@ -1747,12 +1874,37 @@ make_runtime_graph_anchor_replay_record_from_job_dir(
   const auto evidence = read_runtime_replay_job_evidence(job_dir);
   const auto paths = read_runtime_replay_artifact_path_index(job_dir);
   return make_runtime_graph_anchor_replay_record_from_artifact_paths<KeyT>(
-      evidence, std::move(base_spec),
-      paths.graph_anchor_edge_batch_artifact_path,
-      paths.observation_artifact_index_path, frame_options, world_options,
+      evidence, std::move(base_spec), paths, frame_options, world_options,
       artifact_options, require_observation_artifacts, device);
 }
 
+template <typename KeyT>
+[[nodiscard]] runtime_graph_anchor_replay_record_t<KeyT>
+make_runtime_graph_anchor_replay_record_from_batch_entry(
+    const runtime_replay_job_evidence_t &evidence, episode_spec_t base_spec,
+    const runtime_replay_batch_index_entry_t &entry,
+    replay_frame_build_options_t frame_options = {},
+    replay_world_options_t world_options = {},
+    replay_observation_artifact_options_t artifact_options = {},
+    bool require_observation_artifacts = true,
+    const torch::Device &device = torch::Device(torch::kCPU),
+    replay_batch_store_readers_t *store_readers = nullptr) {
+  const auto paths = read_runtime_replay_artifact_path_index_at(
+      entry.artifact_path_index_path);
+  auto record = make_runtime_graph_anchor_replay_record_from_artifact_paths<
+      KeyT>(evidence, std::move(base_spec), paths, frame_options, world_options,
+            artifact_options, require_observation_artifacts, device,
+            store_readers);
+  if (record.cursor.begin_anchor_index != entry.begin_anchor_index ||
+      record.cursor.end_anchor_index != entry.end_anchor_index ||
+      record.cursor.anchor_count() != entry.anchor_count) {
+    throw std::runtime_error(
+        "[replay_runtime_source] replay batch index entry does not match "
+        "loaded cursor");
+  }
+  return record;
+}
+
 template <typename KeyT>
 [[nodiscard]] std::vector<runtime_graph_anchor_replay_record_t<KeyT>>
 make_runtime_graph_anchor_replay_records_from_job_dir(
@@ -1770,24 +1922,15 @@ make_runtime_graph_anchor_replay_records_from_job_dir(
         artifact_options, require_observation_artifacts, device)};
   }
 
+  replay_batch_store_readers_t store_readers;
   std::vector<runtime_graph_anchor_replay_record_t<KeyT>> records;
   records.reserve(batch_entries.size());
   for (const auto &entry : batch_entries) {
-    const auto paths = read_runtime_replay_artifact_path_index_at(
-        entry.artifact_path_index_path);
-    auto record =
-        make_runtime_graph_anchor_replay_record_from_artifact_paths<KeyT>(
-            evidence, base_spec, paths.graph_anchor_edge_batch_artifact_path,
-            paths.observation_artifact_index_path, frame_options, world_options,
-            artifact_options, require_observation_artifacts, device);
-    if (record.cursor.begin_anchor_index != entry.begin_anchor_index ||
-        record.cursor.end_anchor_index != entry.end_anchor_index ||
-        record.cursor.anchor_count() != entry.anchor_count) {
-      throw std::runtime_error(
-          "[replay_runtime_source] replay batch index entry does not match "
-          "loaded cursor");
-    }
-    records.push_back(std::move(record));
+    records.push_back(make_runtime_graph_anchor_replay_record_from_batch_entry<
+                      KeyT>(evidence, base_spec, entry, frame_options,
+                            world_options, artifact_options,
+                            require_observation_artifacts, device,
+                            &store_readers));
   }
   return records;
 }
@@ -1823,10 +1966,17 @@ make_replay_episode_bundle_from_runtime_graph_anchor_record(
   return bundle;
 }
 
+// Replays runtime records in order. Records are either held eagerly or built
+// on demand by per-batch loaders, so a job-dir source only reads the batches
+// it actually yields. A loaded record is kept, so reset() rewinds without
+// running any loader again.
 template <typename KeyT>
 class runtime_graph_anchor_replay_bundle_source_t final
     : public replay_bundle_source_iface_t {
 public:
+  using record_loader_t =
+      std::function<runtime_graph_anchor_replay_record_t<KeyT>()>;
+
   runtime_graph_anchor_replay_bundle_source_t(
       std::string source_id, replay_source_detail::market_graph_t graph,
       std::vector<runtime_graph_anchor_replay_record_t<KeyT>> records)
@@ -1843,28 +1993,66 @@ public:
     }
   }
 
+  runtime_graph_anchor_replay_bundle_source_t(
+      std::string source_id, replay_source_detail::market_graph_t graph,
+      std::vector<record_loader_t> loaders)
+      : source_id_(std::move(source_id)), graph_(std::move(graph)),
+        loaders_(std::move(loaders)) {
+    if (cuwacunu::kikijyeba::environment::detail::blank(source_id_)) {
+      throw std::runtime_error(
+          "[runtime_graph_anchor_replay_bundle_source] source_id is required");
+    }
+    graph_.validate();
+    if (loaders_.empty() ||
+        std::any_of(loaders_.begin(), loaders_.end(),
+                    [](const auto &loader) { return !loader; })) {
+      throw std::runtime_error(
+          "[runtime_graph_anchor_replay_bundle_source] record loaders are "
+          "required");
+    }
+  }
+
   [[nodiscard]] std::string source_id() const override { return source_id_; }
 
   [[nodiscard]] std::optional<replay_episode_bundle_t> next_bundle() override {
-    if (cursor_ >= records_.size()) {
+    if (cursor_ >= size()) {
       return std::nullopt;
     }
-    const auto &record = records_[cursor_++];
+    const auto index = cursor_++;
     auto bundle = make_replay_episode_bundle_from_runtime_graph_anchor_record(
-        record, graph_);
+        record_at(index), graph_);
     validate_replay_episode_bundle(bundle);
     return bundle;
   }
 
   void reset() override { cursor_ = 0; }
 
-  [[nodiscard]] std::size_t size() const { return records_.size(); }
+  [[nodiscard]] std::size_t size() const {
+    return loaders_.empty() ? records_.size() : loaders_.size();
+  }
   [[nodiscard]] std::size_t cursor() const { return cursor_; }
 
 private:
+  [[nodiscard]] const runtime_graph_anchor_replay_record_t<KeyT> &
+  record_at(std::size_t index) {
+    if (loaders_.empty()) {
+      return records_[index];
+    }
+    if (loaded_.empty()) {
+      loaded_.resize(loaders_.size());
+    }
+    if (!loaded_[index].has_value()) {
+      loaded_[index] = loaders_[index]();
+    }
+    return *loaded_[index];
+  }
+
   std::string source_id_{};
   replay_source_detail::market_graph_t graph_{};
   std::vector<runtime_graph_anchor_replay_record_t<KeyT>> records_{};
+  std::vector<record_loader_t> loaders_{};
+  std::vector<std::optional<runtime_graph_anchor_replay_record_t<KeyT>>>
+      loaded_{};
   std::size_t cursor_{0};
 };
 
@@ -1878,15 +2066,37 @@ make_runtime_graph_anchor_replay_bundle_source_from_job_dir(
     replay_observation_artifact_options_t artifact_options = {},
     bool require_observation_artifacts = true,
     const torch::Device &device = torch::Device(torch::kCPU)) {
+  auto evidence = read_runtime_replay_job_evidence(job_dir);
   if (cuwacunu::kikijyeba::environment::detail::blank(source_id)) {
-    const auto evidence = read_runtime_replay_job_evidence(job_dir);
     source_id = evidence.manifest.job_id + ".runtime_replay_bundle_source";
   }
-  auto records = make_runtime_graph_anchor_replay_records_from_job_dir<KeyT>(
-      job_dir, std::move(base_spec), frame_options, world_options,
-      artifact_options, require_observation_artifacts, device);
-  return runtime_graph_anchor_replay_bundle_source_t<KeyT>(
-      std::move(source_id), std::move(graph), std::move(records));
+  const auto batch_entries = read_runtime_replay_batch_index(job_dir);
+  if (batch_entries.empty()) {
+    auto records = make_runtime_graph_anchor_replay_records_from_job_dir<KeyT>(
+        job_dir, std::move(base_spec), frame_options, world_options,
+        artifact_options, require_observation_artifacts, device);
+    return runtime_graph_anchor_replay_bundle_source_t<KeyT>(
+        std::move(source_id), std::move(graph), std::move(records));
+  }
+
+  using source_t = runtime_graph_anchor_replay_bundle_source_t<KeyT>;
+  const auto shared_evidence =
+      std::make_shared<const runtime_replay_job_evidence_t>(
+          std::move(evidence));
+  const auto store_readers = std::make_shared<replay_batch_store_readers_t>();
+  std::vector<typename source_t::record_loader_t> loaders;
+  loaders.reserve(batch_entries.size());
+  for (const auto &entry : batch_entries) {
+    loaders.push_back([shared_evidence, store_readers, base_spec, entry,
+                       frame_options, world_options, artifact_options,
+                       require_observation_artifacts, device]() {
+      return make_runtime_graph_anchor_replay_record_from_batch_entry<KeyT>(
+          *shared_evidence, base_spec, entry, frame_options, world_options,
+          artifact_options, require_observation_artifacts, device,
+          store_readers.get());
+    });
+  }
+  return source_t(std::move(source_id), std::move(graph), std::move(loaders));
 }
 
 } // namespace cuwacunu::kikijyeba::environment::replay
@@ -1,10 +1,13 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -22,7 +25,10 @@
 #include "kikijyeba/topology/dock_binding.h"
 #include "kikijyeba/topology/node_value_chain.h"
 #include "kikijyeba/topology/wikimyei_registry.h"
+#include "piaabo/digest/sha256.h"
+#include "piaabo/parse/bnf/compiled_grammar.h"
 #include "piaabo/parse/simple_kv_block.h"
+#include "piaabo/tensor/torch/compute_profile.h"
 #include "ujcamei/source/contract/runtime/decode.h"
 #include "ujcamei/source/registry/types/kline_feature_registry.h"
 #include "wikimyei/expression/nodelift/srl/assembly.h"
@@ -475,6 +481,10 @@ inline void append_training_contract_fields(
   out << prefix << "_max_steps=" << training.max_steps << "\n";
   out << prefix << "_batch_size=" << training.batch_size << "\n";
   out << prefix << "_grad_clip_norm=" << training.grad_clip_norm << "\n";
+  // Emitted only when opted in, so float32 contracts keep their digests.
+  if (training.precision_policy != "float32") {
+    out << prefix << "_precision_policy=" << training.precision_policy << "\n";
+  }
   if (training.task == cuwacunu::jkimyei::training::training_task_t::
                            mdn_expected_value_inference) {
     out << prefix << "_mdn_edge_return_auxiliary_loss_weight="
@@ -1669,15 +1679,170 @@ resolve_config_relative_path(const std::string &config_path,
       .string();
 }
 
+/*
+ * Config file dependencies.
+ *
+ * The cached loaders install a recorder on the loading thread. Every file the
+ * loader reads is stamped (size, mtime) before the read and digested from the
+ * bytes actually read, so a later stamp or digest mismatch always means the
+ * cached result may be stale. Files probed but absent are recorded too: their
+ * appearance changes path resolution.
+ */
+struct config_file_dependency_t {
+  std::string path{};
+  bool exists{false};
+  std::uintmax_t size{0};
+  std::filesystem::file_time_type mtime{};
+  // mtime was within kConfigRacyWindow of the stamp; a same-size rewrite in
+  // the same timestamp tick would go unseen, so recheck the digest.
+  bool racy{false};
+  std::string sha256{};
+};
+
+inline constexpr auto kConfigRacyWindow = std::chrono::seconds(2);
+
+[[nodiscard]] inline config_file_dependency_t
+stamp_config_file(const std::string &path) {
+  config_file_dependency_t out{};
+  out.path = path;
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return out;
+  }
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return out;
+  }
+  out.exists = true;
+  out.size = size;
+  out.mtime = mtime;
+  out.racy = mtime + kConfigRacyWindow >=
+             std::filesystem::file_time_type::clock::now();
+  return out;
+}
+
+struct config_dependency_recorder_t {
+  std::vector<config_file_dependency_t> files{};
+
+  [[nodiscard]] bool contains(const std::string &path) const {
+    for (const auto &file : files) {
+      if (file.path == path) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+inline thread_local config_dependency_recorder_t *t_config_dependency_recorder =
+    nullptr;
+
+class scoped_config_dependency_recorder_t {
+public:
+  explicit scoped_config_dependency_recorder_t(
+      config_dependency_recorder_t *recorder)
+      : previous_(t_config_dependency_recorder) {
+    t_config_dependency_recorder = recorder;
+  }
+  ~scoped_config_dependency_recorder_t() {
+    t_config_dependency_recorder = previous_;
+  }
+  scoped_config_dependency_recorder_t(
+      const scoped_config_dependency_recorder_t &) = delete;
+  scoped_config_dependency_recorder_t &
+  operator=(const scoped_config_dependency_recorder_t &) = delete;
+
+private:
+  config_dependency_recorder_t *previous_{nullptr};
+};
+
+// Records a file read outside read_text_file_or_throw (the Ujcamei source
+// registry decoders). Call it before the read, as read_text_file_or_throw
+// does, so a rewrite in between shows up as a stale digest.
+inline void record_config_dependency_file(const std::string &path) {
+  auto *recorder = t_config_dependency_recorder;
+  if (recorder == nullptr || path.empty() || recorder->contains(path)) {
+    return;
+  }
+  auto file = stamp_config_file(path);
+  if (file.exists) {
+    try {
+      file.sha256 = cuwacunu::piaabo::digest::sha256_file_hex(path);
+    } catch (const std::exception &) {
+      file = config_file_dependency_t{.path = path};
+    }
+  }
+  recorder->files.push_back(std::move(file));
+}
+
+// True when `file` still matches what the load saw. A stamp change alone is
+// not staleness: the digest decides, and a match refreshes the stamp.
+[[nodiscard]] inline bool
+config_dependency_current(config_file_dependency_t *file) {
+  auto now = stamp_config_file(file->path);
+  if (now.exists != file->exists) {
+    return false;
+  }
+  if (!now.exists) {
+    return true;
+  }
+  if (!file->racy && now.size == file->size && now.mtime == file->mtime) {
+    return true;
+  }
+  if (now.size != file->size) {
+    return false;
+  }
+  try {
+    now.sha256 = cuwacunu::piaabo::digest::sha256_file_hex(file->path);
+  } catch (const std::exception &) {
+    return false;
+  }
+  if (now.sha256 != file->sha256) {
+    return false;
+  }
+  *file = std::move(now);
+  return true;
+}
+
 [[nodiscard]] inline std::string
 read_text_file_or_throw(const std::string &path) {
+  auto *recorder = t_config_dependency_recorder;
+  config_file_dependency_t stamp{};
+  if (recorder != nullptr) {
+    stamp = stamp_config_file(path);
+  }
   std::ifstream in(path);
   if (!in) {
     throw std::runtime_error("[graph_first_config] unable to open file: " +
                              path);
   }
-  return std::string((std::istreambuf_iterator<char>(in)),
-                     std::istreambuf_iterator<char>());
+  std::string text((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  if (recorder != nullptr && !recorder->contains(path)) {
+    stamp.sha256 = cuwacunu::piaabo::digest::sha256_hex(text);
+    recorder->files.push_back(std::move(stamp));
+  }
+  return text;
+}
+
+// Grammar files load through the on-disk compiled grammar cache, so the
+// decoders built from the returned text find their compiled form in the
+// process memo instead of recompiling the BNF.
+[[nodiscard]] inline std::string
+read_grammar_file_or_throw(const std::string &path) {
+  auto *recorder = t_config_dependency_recorder;
+  config_file_dependency_t stamp{};
+  if (recorder != nullptr) {
+    stamp = stamp_config_file(path);
+  }
+  std::string text =
+      cuwacunu::piaabo::parse::bnf::readGrammarFileCached(path).text;
+  if (recorder != nullptr && !recorder->contains(path)) {
+    stamp.sha256 = cuwacunu::piaabo::digest::sha256_hex(text);
+    recorder->files.push_back(std::move(stamp));
+  }
+  return text;
 }
 
 [[nodiscard]] inline std::unordered_map<std::string, std::string>
@@ -1716,10 +1881,11 @@ parse_assignment_config(const std::string &config_path) {
   return out;
 }
 
-[[nodiscard]] inline std::string
-required_section_config_value(const std::string &config_path,
-                              const std::string &section,
-                              const std::string &key) {
+// Every `key = value` in one `[section]`; an absent section is empty.
+[[nodiscard]] inline std::unordered_map<std::string, std::string>
+section_config_values(const std::string &config_path,
+                      const std::string &section) {
+  std::unordered_map<std::string, std::string> out;
   std::istringstream lines(read_text_file_or_throw(config_path));
   std::string current_section;
   std::string line;
@@ -1746,11 +1912,19 @@ required_section_config_value(const std::string &config_path,
       throw std::runtime_error("[graph_first_config] invalid config line " +
                                std::to_string(line_number) + ": missing '='");
     }
-    auto lhs = kv::trim(line.substr(0, eq));
-    auto rhs = kv::trim(line.substr(eq + 1));
-    if (lhs == key && !rhs.empty()) {
-      return rhs;
-    }
+    out.emplace(kv::trim(line.substr(0, eq)), kv::trim(line.substr(eq + 1)));
+  }
+  return out;
+}
+
+[[nodiscard]] inline std::string
+required_section_config_value(const std::string &config_path,
+                              const std::string &section,
+                              const std::string &key) {
+  const auto values = section_config_values(config_path, section);
+  const auto it = values.find(key);
+  if (it != values.end() && !it->second.empty()) {
+    return it->second;
   }
   throw std::runtime_error("[graph_first_config] missing required key '" +
                            section + "." + key + "' in " + config_path);
@@ -1801,6 +1975,7 @@ optional_config_value(const std::unordered_map<std::string, std::string> &cfg,
   }
   const std::string active_bundle_fallback =
       resolve_config_relative_path(config_path, fallback_relative_path);
+  record_config_dependency_file(active_bundle_fallback);
   std::error_code ec;
   if (!active_bundle_fallback.empty() &&
       std::filesystem::exists(active_bundle_fallback, ec)) {
@@ -1845,6 +2020,64 @@ resolve_accounting_numeraire_node_id(std::string explicit_node_id,
   return load_accounting_numeraire_node_id_from_config(std::move(config_path));
 }
 
+// Process compute profile from the optional `[COMPUTE]` section:
+//   compute_inference_mode = true|false
+//   compute_<train|evaluation|replay>_<intra|inter>_op_threads = N (0: Torch
+//   default)
+// Missing keys keep the compute_profile_t defaults.
+[[nodiscard]] inline cuwacunu::piaabo::tensor::torch::compute_profile_t
+load_compute_profile_from_config(std::string config_path = {}) {
+  namespace compute = cuwacunu::piaabo::tensor::torch;
+  if (cuwacunu::piaabo::parse::simple_kv::trim(config_path).empty()) {
+    config_path =
+        cuwacunu::ujcamei::source::contract::default_source_config_path();
+  }
+  const auto values =
+      graph_first_config_detail::section_config_values(config_path, "COMPUTE");
+  compute::compute_profile_t out{};
+  const auto invalid = [&](const std::string &key) {
+    return std::runtime_error("[graph_first_config] invalid COMPUTE." + key +
+                              " in " + config_path);
+  };
+  if (const auto it = values.find("compute_inference_mode");
+      it != values.end()) {
+    if (it->second == "true") {
+      out.inference_mode = true;
+    } else if (it->second == "false") {
+      out.inference_mode = false;
+    } else {
+      throw invalid(it->first);
+    }
+  }
+  const auto read_threads = [&](const std::string &key, std::int64_t *field) {
+    const auto it = values.find(key);
+    if (it == values.end()) {
+      return;
+    }
+    std::size_t consumed = 0;
+    try {
+      const long long parsed = std::stoll(it->second, &consumed);
+      if (consumed != it->second.size() || parsed < 0) {
+        throw invalid(key);
+      }
+      *field = static_cast<std::int64_t>(parsed);
+    } catch (const std::logic_error &) {
+      throw invalid(key);
+    }
+  };
+  for (const auto role :
+       {compute::compute_role_t::train, compute::compute_role_t::evaluation,
+        compute::compute_role_t::replay}) {
+    auto &budget = out.budget(role);
+    const std::string prefix =
+        std::string("compute_") + compute::compute_role_name(role);
+    read_threads(prefix + "_intra_op_threads", &budget.intra_op_threads);
+    read_threads(prefix + "_inter_op_threads", &budget.inter_op_threads);
+  }
+  compute::validate_compute_profile(out);
+  return out;
+}
+
 [[nodiscard]] inline cuwacunu::hero::runtime::settings::wave_settings_t
 load_wave_settings_from_config(std::string config_path = {}) {
   if (cuwacunu::piaabo::parse::simple_kv::trim(config_path).empty()) {
@@ -1885,6 +2118,10 @@ load_channel_graph_first_protocol_contract_from_config(
   out.config_path = config_path;
   out.source_paths = cuwacunu::ujcamei::source::contract::
       load_source_registry_config_paths_from_config(config_path);
+  graph_first_config_detail::record_config_dependency_file(
+      out.source_paths.source_registry_dsl_bnf_path);
+  graph_first_config_detail::record_config_dependency_file(
+      out.source_paths.source_registry_dsl_path);
   out.source_dock_paths = graph_first_source_dock_paths_t{
       .retrieval_channels_dsl_bnf_path =
           graph_first_config_detail::required_config_value(
@@ -1902,11 +2139,11 @@ load_channel_graph_first_protocol_contract_from_config(
       cuwacunu::ujcamei::source::contract::decode_source_universe_from_config(
           config_path);
   out.source_dock = decode_graph_first_source_dock_from_split_dsl(
-      graph_first_config_detail::read_text_file_or_throw(
+      graph_first_config_detail::read_grammar_file_or_throw(
           out.source_dock_paths.retrieval_channels_dsl_bnf_path),
       graph_first_config_detail::read_text_file_or_throw(
           out.source_dock_paths.retrieval_channels_dsl_path),
-      graph_first_config_detail::read_text_file_or_throw(
+      graph_first_config_detail::read_grammar_file_or_throw(
           out.source_dock_paths.graph_dsl_bnf_path),
       graph_first_config_detail::read_text_file_or_throw(
           out.source_dock_paths.graph_dsl_path));
@@ -2274,4 +2511,164 @@ load_channel_graph_first_config_bundle_from_config(
       std::move(config_path));
 }
 
+/*
+ * Process-level config cache.
+ *
+ * Resident Hero servers inspect the same `.config` bundle many times. The
+ * cached loaders below decode once and hand out the result as a shared
+ * immutable value. Each entry remembers every file its load read, with a
+ * stamp and SHA-256 digest; a lookup re-stats those files and reloads when
+ * any digest changed, a file vanished, or a probed fallback appeared.
+ *
+ * Entries are keyed by the config path as given (and the working directory
+ * when that path is relative), so the paths inside a cached bundle match
+ * what the uncached loader returns for the same argument. Callers that need
+ * to mutate a bundle copy it. Loads run outside the cache lock; two threads
+ * missing the same key both load and the later one wins.
+ */
+struct config_bundle_cache_stats_t {
+  std::uint64_t hits{0};
+  std::uint64_t misses{0};
+  std::uint64_t invalidations{0};
+  std::size_t entries{0};
+};
+
+namespace graph_first_config_detail {
+
+[[nodiscard]] inline std::string
+config_cache_key(const std::string &config_path) {
+  const std::filesystem::path path(config_path);
+  if (path.is_absolute()) {
+    return config_path;
+  }
+  std::error_code ec;
+  auto cwd = std::filesystem::current_path(ec);
+  return (ec ? std::string{} : cwd.string()) + "\n" + config_path;
+}
+
+template <typename T> class config_load_cache_t {
+public:
+  template <typename Load>
+  [[nodiscard]] std::shared_ptr<const T> get_or_load(const std::string &key,
+                                                     Load &&load) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        bool current = true;
+        for (auto &file : it->second.files) {
+          if (!config_dependency_current(&file)) {
+            current = false;
+            break;
+          }
+        }
+        if (current) {
+          ++stats_.hits;
+          return it->second.value;
+        }
+        entries_.erase(it);
+        ++stats_.invalidations;
+      }
+      ++stats_.misses;
+    }
+    config_dependency_recorder_t recorder{};
+    std::shared_ptr<const T> value;
+    {
+      scoped_config_dependency_recorder_t scope(&recorder);
+      value = std::make_shared<const T>(load());
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key] = entry_t{value, std::move(recorder.files)};
+    return value;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    stats_ = config_bundle_cache_stats_t{};
+  }
+
+  [[nodiscard]] config_bundle_cache_stats_t stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto out = stats_;
+    out.entries = entries_.size();
+    return out;
+  }
+
+private:
+  struct entry_t {
+    std::shared_ptr<const T> value{};
+    std::vector<config_file_dependency_t> files{};
+  };
+
+  mutable std::mutex mutex_{};
+  std::unordered_map<std::string, entry_t> entries_{};
+  config_bundle_cache_stats_t stats_{};
+};
+
+inline config_load_cache_t<channel_graph_first_protocol_contract_t> &
+protocol_contract_cache() {
+  static config_load_cache_t<channel_graph_first_protocol_contract_t> cache;
+  return cache;
+}
+
+inline config_load_cache_t<cuwacunu::hero::runtime::settings::wave_settings_t>
+    &wave_settings_cache() {
+  static config_load_cache_t<cuwacunu::hero::runtime::settings::wave_settings_t>
+      cache;
+  return cache;
+}
+
+[[nodiscard]] inline std::string
+config_path_or_default(std::string config_path) {
+  if (cuwacunu::piaabo::parse::simple_kv::trim(config_path).empty()) {
+    config_path =
+        cuwacunu::ujcamei::source::contract::default_source_config_path();
+  }
+  return config_path;
+}
+
+} // namespace graph_first_config_detail
+
+[[nodiscard]] inline std::shared_ptr<
+    const cuwacunu::hero::runtime::settings::wave_settings_t>
+load_wave_settings_cached(std::string config_path = {}) {
+  config_path =
+      graph_first_config_detail::config_path_or_default(std::move(config_path));
+  return graph_first_config_detail::wave_settings_cache().get_or_load(
+      graph_first_config_detail::config_cache_key(config_path),
+      [&] { return load_wave_settings_from_config(config_path); });
+}
+
+[[nodiscard]] inline std::shared_ptr<
+    const channel_graph_first_protocol_contract_t>
+load_channel_graph_first_protocol_contract_cached(
+    std::string config_path = {}) {
+  config_path =
+      graph_first_config_detail::config_path_or_default(std::move(config_path));
+  return graph_first_config_detail::protocol_contract_cache().get_or_load(
+      graph_first_config_detail::config_cache_key(config_path), [&] {
+        return load_channel_graph_first_protocol_contract_from_config(
+            config_path);
+      });
+}
+
+// Hit/miss counters summed over the wave-settings and contract caches.
+[[nodiscard]] inline config_bundle_cache_stats_t config_bundle_cache_stats() {
+  const auto contract = graph_first_config_detail::protocol_contract_cache()
+                            .stats();
+  const auto wave = graph_first_config_detail::wave_settings_cache().stats();
+  return config_bundle_cache_stats_t{
+      .hits = contract.hits + wave.hits,
+      .misses = contract.misses + wave.misses,
+      .invalidations = contract.invalidations + wave.invalidations,
+      .entries = contract.entries + wave.entries,
+  };
+}
+
+inline void clear_config_bundle_cache() {
+  graph_first_config_detail::protocol_contract_cache().clear();
+  graph_first_config_detail::wave_settings_cache().clear();
+}
+
 } // namespace cuwacunu::kikijyeba::protocol
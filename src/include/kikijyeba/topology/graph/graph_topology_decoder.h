@@ -1,5 +1,6 @@
 #pragma once
 
+#include <filesystem>
 #include <mutex>
 #include <string>
 
@@ -17,16 +18,18 @@ class graph_topology_decoder_t : public ASTVisitor {
 private:
   std::mutex current_mutex;
 
+  explicit graph_topology_decoder_t(CachedGrammarFile grammar_file);
+
 public:
   std::string SOURCE_GRAPH_GRAMMAR_TEXT{};
 
-  GrammarLexer grammarLexer;
-  GrammarParser grammarParser;
   ProductionGrammar grammar;
   InstructionLexer iLexer;
   InstructionParser iParser;
 
   explicit graph_topology_decoder_t(std::string grammar_text);
+  /* reads the grammar file through the on-disk compiled grammar cache */
+  explicit graph_topology_decoder_t(const std::filesystem::path &grammar_path);
 
   graph_topology_spec_t decode(std::string instruction);
 
@@ -0,0 +1,413 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <time.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cuwacunu {
+namespace piaabo {
+namespace bench {
+
+// Repeated-sample microbenchmarks. A case runs `warmup` untimed calls and then
+// `repetitions` timed calls; every timed call is one sample of wall time
+// (steady_clock) and of process CPU time (CLOCK_PROCESS_CPUTIME_ID, so work
+// done on intra-op worker threads is counted). Percentiles interpolate between
+// order statistics, and each percentile carries a distribution-free
+// confidence interval built from binomial order-statistic ranks: with few
+// samples the upper bound of a tail percentile is simply the sample maximum.
+
+inline constexpr std::string_view k_microbench_schema =
+    "cuwacunu.microbench.v1";
+
+struct microbench_options_t {
+  std::size_t warmup{3};
+  std::size_t repetitions{30};
+  double confidence{0.95};
+};
+
+struct microbench_interval_t {
+  double lower{0.0};
+  double upper{0.0};
+};
+
+// Summary of one clock over all samples, in nanoseconds.
+struct microbench_distribution_t {
+  double mean{0.0};
+  double stddev{0.0};
+  double min{0.0};
+  double max{0.0};
+  double p50{0.0};
+  double p95{0.0};
+  double p99{0.0};
+  microbench_interval_t p50_ci{};
+  microbench_interval_t p95_ci{};
+  microbench_interval_t p99_ci{};
+};
+
+struct microbench_result_t {
+  std::string name{};
+  std::size_t warmup{0};
+  std::size_t repetitions{0};
+  double confidence{0.95};
+  microbench_distribution_t wall_ns{};
+  microbench_distribution_t cpu_ns{};
+};
+
+struct microbench_report_t {
+  std::string suite{};
+  std::string commit{};
+  std::vector<microbench_result_t> results{};
+};
+
+// Keeps `value` observable so the optimizer cannot drop the work producing it.
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+namespace detail {
+
+[[nodiscard]] inline double process_cpu_ns() {
+  timespec ts{};
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+// Two-sided standard normal quantile for `confidence`, by bisection on erf.
+[[nodiscard]] inline double normal_two_sided_z(double confidence) {
+  double lo = 0.0;
+  double hi = 10.0;
+  for (int i = 0; i < 80; ++i) {
+    const double mid = 0.5 * (lo + hi);
+    if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return 0.5 * (lo + hi);
+}
+
+// Linear interpolation between closest ranks of an ascending sample.
+[[nodiscard]] inline double percentile_sorted(const std::vector<double> &sorted,
+                                              double q) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const double position = q * static_cast<double>(sorted.size() - 1U);
+  const auto below = static_cast<std::size_t>(std::floor(position));
+  const auto above = std::min(below + 1U, sorted.size() - 1U);
+  const double fraction = position - static_cast<double>(below);
+  return sorted[below] + (sorted[above] - sorted[below]) * fraction;
+}
+
+// Order-statistic interval for the q-quantile: ranks n*q -/+ z*sqrt(n*q*(1-q)),
+// widened outward and clamped to the sample.
+[[nodiscard]] inline microbench_interval_t
+percentile_interval_sorted(const std::vector<double> &sorted, double q,
+                           double confidence) {
+  if (sorted.empty()) {
+    return {};
+  }
+  const double n = static_cast<double>(sorted.size());
+  const double half =
+      normal_two_sided_z(confidence) * std::sqrt(n * q * (1.0 - q));
+  const double lower_rank = std::floor(n * q - half);
+  const double upper_rank = std::ceil(n * q + half);
+  const auto rank_index = [&](double rank) {
+    return static_cast<std::size_t>(std::clamp(rank, 1.0, n)) - 1U;
+  };
+  return {sorted[rank_index(lower_rank)], sorted[rank_index(upper_rank)]};
+}
+
+inline void append_json_string(std::string *out, std::string_view text) {
+  out->push_back('"');
+  for (const char c : text) {
+    switch (c) {
+    case '"':
+      out->append("\\\"");
+      break;
+    case '\\':
+      out->append("\\\\");
+      break;
+    case '\n':
+      out->append("\\n");
+      break;
+    case '\t':
+      out->append("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20U) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                      static_cast<unsigned>(static_cast<unsigned char>(c)));
+        out->append(escaped);
+      } else {
+        out->push_back(c);
+      }
+    }
+  }
+  out->push_back('"');
+}
+
+inline void append_json_number(std::string *out, double value) {
+  if (!std::isfinite(value)) {
+    out->append("null");
+    return;
+  }
+  char buffer[64];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                    std::chars_format::fixed, 3);
+  out->append(buffer, result.ptr);
+}
+
+inline void append_json_distribution(std::string *out,
+                                     const microbench_distribution_t &d) {
+  const auto field = [&](std::string_view key, double value) {
+    out->push_back('"');
+    out->append(key);
+    out->append("\":");
+    append_json_number(out, value);
+    out->push_back(',');
+  };
+  const auto interval = [&](std::string_view key,
+                            const microbench_interval_t &ci) {
+    out->push_back('"');
+    out->append(key);
+    out->append("\":[");
+    append_json_number(out, ci.lower);
+    out->push_back(',');
+    append_json_number(out, ci.upper);
+    out->append("],");
+  };
+  out->push_back('{');
+  field("mean", d.mean);
+  field("stddev", d.stddev);
+  field("min", d.min);
+  field("max", d.max);
+  field("p50", d.p50);
+  interval("p50_ci", d.p50_ci);
+  field("p95", d.p95);
+  interval("p95_ci", d.p95_ci);
+  field("p99", d.p99);
+  interval("p99_ci", d.p99_ci);
+  out->back() = '}';
+}
+
+} // namespace detail
+
+[[nodiscard]] inline microbench_distribution_t
+summarize_samples(std::vector<double> samples, double confidence = 0.95) {
+  microbench_distribution_t out{};
+  if (samples.empty()) {
+    return out;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (const double sample : samples) {
+    sum += sample;
+  }
+  out.mean = sum / static_cast<double>(samples.size());
+  double squares = 0.0;
+  for (const double sample : samples) {
+    squares += (sample - out.mean) * (sample - out.mean);
+  }
+  const auto n = static_cast<double>(samples.size());
+  out.stddev = samples.size() > 1U ? std::sqrt(squares / (n - 1.0)) : 0.0;
+  out.min = samples.front();
+  out.max = samples.back();
+  out.p50 = detail::percentile_sorted(samples, 0.50);
+  out.p95 = detail::percentile_sorted(samples, 0.95);
+  out.p99 = detail::percentile_sorted(samples, 0.99);
+  out.p50_ci = detail::percentile_interval_sorted(samples, 0.50, confidence);
+  out.p95_ci = detail::percentile_interval_sorted(samples, 0.95, confidence);
+  out.p99_ci = detail::percentile_interval_sorted(samples, 0.99, confidence);
+  return out;
+}
+
+// Runs `fn` warmup + repetitions times and summarizes the timed calls.
+template <typename Fn>
+[[nodiscard]] inline microbench_result_t
+run_microbench(std::string name, const microbench_options_t &options, Fn &&fn) {
+  const std::size_t repetitions = std::max<std::size_t>(options.repetitions, 1);
+  for (std::size_t i = 0; i < options.warmup; ++i) {
+    fn();
+  }
+  std::vector<double> wall;
+  std::vector<double> cpu;
+  wall.reserve(repetitions);
+  cpu.reserve(repetitions);
+  for (std::size_t i = 0; i < repetitions; ++i) {
+    const double cpu_begin = detail::process_cpu_ns();
+    const auto wall_begin = std::chrono::steady_clock::now();
+    fn();
+    const auto wall_end = std::chrono::steady_clock::now();
+    const double cpu_end = detail::process_cpu_ns();
+    wall.push_back(
+        std::chrono::duration<double, std::nano>(wall_end - wall_begin)
+            .count());
+    cpu.push_back(cpu_end - cpu_begin);
+  }
+  microbench_result_t out{};
+  out.name = std::move(name);
+  out.warmup = options.warmup;
+  out.repetitions = repetitions;
+  out.confidence = options.confidence;
+  out.wall_ns = summarize_samples(std::move(wall), options.confidence);
+  out.cpu_ns = summarize_samples(std::move(cpu), options.confidence);
+  return out;
+}
+
+// One JSON object per report with a fixed key order, so reports from two
+// commits diff line by line and load into any JSON tool.
+[[nodiscard]] inline std::string
+microbench_report_json(const microbench_report_t &report) {
+  std::string out;
+  out.append("{\"schema\":");
+  detail::append_json_string(&out, k_microbench_schema);
+  out.append(",\"suite\":");
+  detail::append_json_string(&out, report.suite);
+  out.append(",\"commit\":");
+  detail::append_json_string(&out, report.commit);
+  out.append(",\"results\":[");
+  for (std::size_t i = 0; i < report.results.size(); ++i) {
+    const auto &result = report.results[i];
+    out.append(i == 0 ? "\n" : ",\n");
+    out.append("{\"name\":");
+    detail::append_json_string(&out, result.name);
+    out.append(",\"warmup\":" + std::to_string(result.warmup));
+    out.append(",\"repetitions\":" + std::to_string(result.repetitions));
+    out.append(",\"confidence\":");
+    detail::append_json_number(&out, result.confidence);
+    out.append(",\"wall_ns\":");
+    detail::append_json_distribution(&out, result.wall_ns);
+    out.append(",\"cpu_ns\":");
+    detail::append_json_distribution(&out, result.cpu_ns);
+    out.push_back('}');
+  }
+  out.append("\n]}\n");
+  return out;
+}
+
+// Command line shared by the bench binaries:
+//   --warmup N --repetitions N --confidence X --json PATH --commit ID
+//   --filter SUBSTRING
+struct microbench_cli_t {
+  microbench_options_t options{};
+  std::string json_path{};
+  std::string commit{};
+  std::string filter{};
+};
+
+[[nodiscard]] inline microbench_cli_t parse_microbench_cli(int argc,
+                                                           char **argv) {
+  microbench_cli_t cli{};
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view flag = argv[i];
+    if (i + 1 >= argc) {
+      throw std::invalid_argument("[microbench] missing value for " +
+                                  std::string(flag));
+    }
+    const std::string value = argv[++i];
+    if (flag == "--warmup") {
+      cli.options.warmup = std::stoul(value);
+    } else if (flag == "--repetitions") {
+      cli.options.repetitions = std::stoul(value);
+    } else if (flag == "--confidence") {
+      cli.options.confidence = std::stod(value);
+      if (!(cli.options.confidence > 0.0 && cli.options.confidence < 1.0)) {
+        throw std::invalid_argument("[microbench] --confidence must be in "
+                                    "(0, 1)");
+      }
+    } else if (flag == "--json") {
+      cli.json_path = value;
+    } else if (flag == "--commit") {
+      cli.commit = value;
+    } else if (flag == "--filter") {
+      cli.filter = value;
+    } else {
+      throw std::invalid_argument("[microbench] unknown option " +
+                                  std::string(flag));
+    }
+  }
+  return cli;
+}
+
+// Collects the cases of one bench binary, prints a line per case and writes
+// the JSON report on finish().
+class microbench_suite_t {
+public:
+  microbench_suite_t(std::string suite, microbench_cli_t cli)
+      : cli_(std::move(cli)) {
+    report_.suite = std::move(suite);
+    report_.commit = cli_.commit;
+  }
+
+  [[nodiscard]] const microbench_options_t &options() const {
+    return cli_.options;
+  }
+
+  template <typename Fn> void run(const std::string &name, Fn &&fn) {
+    run(name, cli_.options, std::forward<Fn>(fn));
+  }
+
+  // Per-case options for cases too slow for the suite-wide repetition count.
+  template <typename Fn>
+  void run(const std::string &name, const microbench_options_t &options,
+           Fn &&fn) {
+    if (!cli_.filter.empty() && name.find(cli_.filter) == std::string::npos) {
+      return;
+    }
+    auto result = run_microbench(name, options, std::forward<Fn>(fn));
+    std::ostringstream line;
+    line.setf(std::ios::fixed);
+    line.precision(1);
+    line << "[microbench] " << report_.suite << "/" << result.name
+         << " n=" << result.repetitions << " wall_p50_us="
+         << result.wall_ns.p50 / 1e3 << " wall_p95_us="
+         << result.wall_ns.p95 / 1e3 << " wall_p99_us="
+         << result.wall_ns.p99 / 1e3 << " cpu_p50_us="
+         << result.cpu_ns.p50 / 1e3 << "\n";
+    std::cout << line.str();
+    report_.results.push_back(std::move(result));
+  }
+
+  [[nodiscard]] const microbench_report_t &report() const { return report_; }
+
+  // Writes the report to --json (stdout when absent); returns an exit code.
+  int finish() const {
+    const auto json = microbench_report_json(report_);
+    if (cli_.json_path.empty()) {
+      std::cout << json;
+      return 0;
+    }
+    std::ofstream out(cli_.json_path, std::ios::binary | std::ios::trunc);
+    out << json;
+    if (!out) {
+      std::cerr << "[microbench] failed to write " << cli_.json_path << "\n";
+      return 1;
+    }
+    return 0;
+  }
+
+private:
+  microbench_cli_t cli_{};
+  microbench_report_t report_{};
+};
+
+} // namespace bench
+} // namespace piaabo
+} // namespace cuwacunu
@@ -0,0 +1,357 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Scoped span profiler that writes Chrome Trace Event JSON (load the file in
+// chrome://tracing or https://ui.perfetto.dev).
+//
+// Build-time flag:
+//
+//   PIAABO_TRACE_SPANS (default: 1)
+//   - 0: PIAABO_TRACE_SPAN() expands to nothing and trace_span_t is empty.
+//   - 1: spans compile in but record only while the runtime switch is on
+//        (set_enabled() or a live trace_session_t). While it is off, a span
+//        costs one relaxed atomic load and one branch.
+//
+// Each thread appends complete ("ph":"X") events to its own buffer, so the
+// hot path never contends with other recording threads. Span category and
+// name must outlive the trace; pass string literals.
+#ifndef PIAABO_TRACE_SPANS
+#define PIAABO_TRACE_SPANS 1
+#endif
+
+namespace cuwacunu {
+namespace piaabo {
+namespace bench {
+namespace trace {
+
+struct trace_event_t {
+  const char *category{nullptr};
+  const char *name{nullptr};
+  std::int64_t start_ns{0};
+  std::int64_t duration_ns{0};
+};
+
+namespace detail {
+
+struct thread_buffer_t {
+  std::mutex mutex{};
+  std::uint64_t tid{0};
+  std::vector<trace_event_t> events{};
+};
+
+struct registry_t {
+  std::mutex mutex{};
+  std::vector<std::shared_ptr<thread_buffer_t>> buffers{};
+  std::uint64_t next_tid{1};
+  std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+};
+
+inline std::atomic<bool> g_enabled{false};
+
+inline registry_t &registry() {
+  static registry_t instance{};
+  return instance;
+}
+
+// Buffers stay registered after their thread exits so that spans recorded by
+// short-lived workers still reach the trace file.
+inline thread_buffer_t &local_buffer() {
+  thread_local const std::shared_ptr<thread_buffer_t> buffer = [] {
+    auto created = std::make_shared<thread_buffer_t>();
+    created->events.reserve(1024);
+    auto &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    created->tid = reg.next_tid++;
+    reg.buffers.push_back(created);
+    return created;
+  }();
+  return *buffer;
+}
+
+inline std::int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - registry().epoch)
+      .count();
+}
+
+inline void record(const char *category, const char *name,
+                   std::int64_t start_ns) {
+  const std::int64_t end_ns = now_ns();
+  auto &buffer = local_buffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back(trace_event_t{category, name, start_ns,
+                                        std::max<std::int64_t>(
+                                            end_ns - start_ns, 0)});
+}
+
+inline void append_json_string(std::string *out, const char *value) {
+  out->push_back('"');
+  for (const char *p = value == nullptr ? "" : value; *p != '\0'; ++p) {
+    const char c = *p;
+    switch (c) {
+    case '"':
+      out->append("\\\"");
+      break;
+    case '\\':
+      out->append("\\\\");
+      break;
+    case '\n':
+      out->append("\\n");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x",
+                      static_cast<unsigned>(c));
+        out->append(escaped);
+      } else {
+        out->push_back(c);
+      }
+    }
+  }
+  out->push_back('"');
+}
+
+// Chrome trace timestamps are microseconds; keep nanosecond resolution.
+inline void append_us(std::string *out, std::int64_t ns) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%lld.%03lld",
+                static_cast<long long>(ns / 1000),
+                static_cast<long long>(ns % 1000));
+  out->append(text);
+}
+
+} // namespace detail
+
+[[nodiscard]] inline bool enabled() noexcept {
+#if PIAABO_TRACE_SPANS
+  return detail::g_enabled.load(std::memory_order_relaxed);
+#else
+  return false;
+#endif
+}
+
+inline void set_enabled(bool value) noexcept {
+  detail::g_enabled.store(value, std::memory_order_relaxed);
+}
+
+// Events recorded so far, per thread; tid is the trace-local thread id.
+struct trace_thread_events_t {
+  std::uint64_t tid{0};
+  std::vector<trace_event_t> events{};
+};
+
+[[nodiscard]] inline std::vector<trace_thread_events_t> snapshot() {
+  std::vector<trace_thread_events_t> out;
+  auto &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  out.reserve(reg.buffers.size());
+  for (const auto &buffer : reg.buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    if (!buffer->events.empty()) {
+      out.push_back(trace_thread_events_t{buffer->tid, buffer->events});
+    }
+  }
+  return out;
+}
+
+[[nodiscard]] inline std::size_t event_count() {
+  std::size_t count = 0;
+  for (const auto &thread : snapshot()) {
+    count += thread.events.size();
+  }
+  return count;
+}
+
+inline void clear() {
+  auto &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (const auto &buffer : reg.buffers) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->events.clear();
+  }
+}
+
+// One event per line, ordered by thread and then start time, so two traces of
+// the same run diff cleanly.
+[[nodiscard]] inline std::string chrome_trace_json() {
+  auto threads = snapshot();
+  std::sort(threads.begin(), threads.end(),
+            [](const auto &a, const auto &b) { return a.tid < b.tid; });
+  const auto pid = static_cast<long long>(::getpid());
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto &thread : threads) {
+    std::stable_sort(thread.events.begin(), thread.events.end(),
+                     [](const trace_event_t &a, const trace_event_t &b) {
+                       return a.start_ns < b.start_ns;
+                     });
+    for (const auto &event : thread.events) {
+      out.append(first ? "\n" : ",\n");
+      first = false;
+      out.append("{\"name\":");
+      detail::append_json_string(&out, event.name);
+      out.append(",\"cat\":");
+      detail::append_json_string(&out, event.category);
+      out.append(",\"ph\":\"X\",\"ts\":");
+      detail::append_us(&out, event.start_ns);
+      out.append(",\"dur\":");
+      detail::append_us(&out, event.duration_ns);
+      out.append(",\"pid\":" + std::to_string(pid) +
+                 ",\"tid\":" + std::to_string(thread.tid) + "}");
+    }
+  }
+  out.append("\n]}\n");
+  return out;
+}
+
+// Writes through a temporary file and a rename so readers never see a
+// partial trace.
+inline void write_chrome_trace(const std::filesystem::path &path) {
+  if (path.empty()) {
+    throw std::runtime_error("[piaabo_trace] trace path is required");
+  }
+  std::error_code ec;
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+  const auto tmp = path.string() + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("[piaabo_trace] cannot open trace file: " +
+                               tmp);
+    }
+    out << chrome_trace_json();
+    if (!out) {
+      throw std::runtime_error("[piaabo_trace] cannot write trace file: " +
+                               tmp);
+    }
+  }
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    throw std::runtime_error("[piaabo_trace] cannot publish trace file: " +
+                             path.string() + ": " + ec.message());
+  }
+}
+
+#if PIAABO_TRACE_SPANS
+
+class trace_span_t {
+public:
+  trace_span_t(const char *category, const char *name) noexcept {
+    if (enabled()) [[unlikely]] {
+      category_ = category;
+      name_ = name;
+      start_ns_ = detail::now_ns();
+    }
+  }
+  ~trace_span_t() {
+    if (category_ != nullptr) [[unlikely]] {
+      try {
+        detail::record(category_, name_, start_ns_);
+      } catch (...) {
+      }
+    }
+  }
+  trace_span_t(const trace_span_t &) = delete;
+  trace_span_t &operator=(const trace_span_t &) = delete;
+
+private:
+  const char *category_{nullptr};
+  const char *name_{nullptr};
+  std::int64_t start_ns_{0};
+};
+
+#else
+
+class trace_span_t {
+public:
+  constexpr trace_span_t(const char *, const char *) noexcept {}
+  trace_span_t(const trace_span_t &) = delete;
+  trace_span_t &operator=(const trace_span_t &) = delete;
+};
+
+#endif
+
+// Records spans from construction until finish() (or destruction) and then
+// writes them to `path`. Spans already buffered by an earlier session are
+// dropped. A failed write never throws from the destructor; it is kept in
+// error() instead.
+class trace_session_t {
+public:
+  explicit trace_session_t(std::filesystem::path path, bool active = true)
+      : path_(std::move(path)), active_(active && PIAABO_TRACE_SPANS) {
+    if (active_) {
+      clear();
+      set_enabled(true);
+    }
+  }
+  ~trace_session_t() { (void)finish(); }
+  trace_session_t(const trace_session_t &) = delete;
+  trace_session_t &operator=(const trace_session_t &) = delete;
+
+  [[nodiscard]] bool active() const noexcept { return active_; }
+  [[nodiscard]] const std::filesystem::path &path() const noexcept {
+    return path_;
+  }
+  [[nodiscard]] const std::string &error() const noexcept { return error_; }
+
+  bool finish() noexcept {
+    if (!active_) {
+      return error_.empty();
+    }
+    active_ = false;
+    set_enabled(false);
+    try {
+      write_chrome_trace(path_);
+      clear();
+    } catch (const std::exception &ex) {
+      error_ = ex.what();
+    } catch (...) {
+      error_ = "[piaabo_trace] unknown error writing trace";
+    }
+    return error_.empty();
+  }
+
+private:
+  std::filesystem::path path_{};
+  bool active_{false};
+  std::string error_{};
+};
+
+} // namespace trace
+} // namespace bench
+} // namespace piaabo
+} // namespace cuwacunu
+
+#define PIAABO_TRACE_SPAN_CONCAT_INNER(a, b) a##b
+#define PIAABO_TRACE_SPAN_CONCAT(a, b) PIAABO_TRACE_SPAN_CONCAT_INNER(a, b)
+
+#if PIAABO_TRACE_SPANS
+#define PIAABO_TRACE_SPAN(category, name)                                      \
+  const ::cuwacunu::piaabo::bench::trace::trace_span_t                         \
+      PIAABO_TRACE_SPAN_CONCAT(piaabo_trace_span_, __LINE__)(category, name)
+#else
+#define PIAABO_TRACE_SPAN(category, name) static_cast<void>(0)
+#endif
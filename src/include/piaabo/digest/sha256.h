@@ -1,89 +1,100 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <iomanip>
-#include <sstream>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define CUWACUNU_SHA256_HAS_SHA_NI 1
+#else
+#define CUWACUNU_SHA256_HAS_SHA_NI 0
+#endif
+
 namespace cuwacunu::piaabo::digest {
 namespace detail {
 
+inline constexpr std::size_t kSha256BlockBytes = 64;
+
+inline constexpr std::array<std::uint32_t, 64> kSha256RoundConstants{
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU,
+    0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U, 0xd807aa98U, 0x12835b01U,
+    0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U,
+    0xc19bf174U, 0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU,
+    0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU, 0x983e5152U,
+    0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U,
+    0x06ca6351U, 0x14292967U, 0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU,
+    0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U,
+    0xd6990624U, 0xf40e3585U, 0x106aa070U, 0x19a4c116U, 0x1e376c08U,
+    0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU,
+    0x682e6ff3U, 0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U,
+    0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U};
+
+inline constexpr std::array<std::uint32_t, 8> kSha256InitialState{
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+    0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U};
+
 [[nodiscard]] inline std::uint32_t rotr(std::uint32_t value,
                                         std::uint32_t bits) {
   return (value >> bits) | (value << (32U - bits));
 }
 
-} // namespace detail
+using sha256_compress_fn_t = void (*)(std::uint32_t *state,
+                                      const unsigned char *blocks,
+                                      std::size_t block_count);
 
-[[nodiscard]] inline std::string sha256_hex(std::string_view input) {
-  static constexpr std::array<std::uint32_t, 64> k{
-      0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU,
-      0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U, 0xd807aa98U, 0x12835b01U,
-      0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U,
-      0xc19bf174U, 0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU,
-      0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU, 0x983e5152U,
-      0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U,
-      0x06ca6351U, 0x14292967U, 0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU,
-      0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
-      0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U,
-      0xd6990624U, 0xf40e3585U, 0x106aa070U, 0x19a4c116U, 0x1e376c08U,
-      0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU,
-      0x682e6ff3U, 0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U,
-      0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U};
-
-  std::vector<unsigned char> data(input.begin(), input.end());
-  const std::uint64_t bit_len = static_cast<std::uint64_t>(data.size()) * 8ULL;
-  data.push_back(0x80U);
-  while ((data.size() % 64U) != 56U) {
-    data.push_back(0U);
-  }
-  for (int shift = 56; shift >= 0; shift -= 8) {
-    data.push_back(static_cast<unsigned char>((bit_len >> shift) & 0xffU));
-  }
-
-  std::array<std::uint32_t, 8> h{0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U,
-                                 0xa54ff53aU, 0x510e527fU, 0x9b05688cU,
-                                 0x1f83d9abU, 0x5be0cd19U};
-
-  for (std::size_t offset = 0; offset < data.size(); offset += 64U) {
+// Portable FIPS 180-4 compression over `block_count` consecutive blocks.
+inline void sha256_compress_scalar(std::uint32_t *state,
+                                   const unsigned char *blocks,
+                                   std::size_t block_count) {
+  const auto &k = kSha256RoundConstants;
+  for (std::size_t block = 0; block < block_count; ++block) {
+    const unsigned char *data = blocks + block * kSha256BlockBytes;
     std::array<std::uint32_t, 64> w{};
     for (std::size_t i = 0; i < 16U; ++i) {
-      const std::size_t j = offset + i * 4U;
+      const std::size_t j = i * 4U;
       w[i] = (static_cast<std::uint32_t>(data[j]) << 24U) |
              (static_cast<std::uint32_t>(data[j + 1U]) << 16U) |
              (static_cast<std::uint32_t>(data[j + 2U]) << 8U) |
              static_cast<std::uint32_t>(data[j + 3U]);
     }
     for (std::size_t i = 16U; i < 64U; ++i) {
-      const std::uint32_t s0 = detail::rotr(w[i - 15U], 7U) ^
-                               detail::rotr(w[i - 15U], 18U) ^
-                               (w[i - 15U] >> 3U);
-      const std::uint32_t s1 = detail::rotr(w[i - 2U], 17U) ^
-                               detail::rotr(w[i - 2U], 19U) ^
-                               (w[i - 2U] >> 10U);
+      const std::uint32_t s0 =
+          rotr(w[i - 15U], 7U) ^ rotr(w[i - 15U], 18U) ^ (w[i - 15U] >> 3U);
+      const std::uint32_t s1 =
+          rotr(w[i - 2U], 17U) ^ rotr(w[i - 2U], 19U) ^ (w[i - 2U] >> 10U);
       w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
     }
 
-    std::uint32_t a = h[0];
-    std::uint32_t b = h[1];
-    std::uint32_t c = h[2];
-    std::uint32_t d = h[3];
-    std::uint32_t e = h[4];
-    std::uint32_t f = h[5];
-    std::uint32_t g = h[6];
-    std::uint32_t hh = h[7];
+    std::uint32_t a = state[0];
+    std::uint32_t b = state[1];
+    std::uint32_t c = state[2];
+    std::uint32_t d = state[3];
+    std::uint32_t e = state[4];
+    std::uint32_t f = state[5];
+    std::uint32_t g = state[6];
+    std::uint32_t hh = state[7];
 
     for (std::size_t i = 0; i < 64U; ++i) {
-      const std::uint32_t s1 =
-          detail::rotr(e, 6U) ^ detail::rotr(e, 11U) ^ detail::rotr(e, 25U);
+      const std::uint32_t s1 = rotr(e, 6U) ^ rotr(e, 11U) ^ rotr(e, 25U);
       const std::uint32_t ch = (e & f) ^ ((~e) & g);
       const std::uint32_t temp1 = hh + s1 + ch + k[i] + w[i];
-      const std::uint32_t s0 =
-          detail::rotr(a, 2U) ^ detail::rotr(a, 13U) ^ detail::rotr(a, 22U);
+      const std::uint32_t s0 = rotr(a, 2U) ^ rotr(a, 13U) ^ rotr(a, 22U);
       const std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
       const std::uint32_t temp2 = s0 + maj;
       hh = g;
@@ -96,22 +107,292 @@ namespace detail {
       a = temp1 + temp2;
     }
 
-    h[0] += a;
-    h[1] += b;
-    h[2] += c;
-    h[3] += d;
-    h[4] += e;
-    h[5] += f;
-    h[6] += g;
-    h[7] += hh;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += hh;
+  }
+}
+
+#if CUWACUNU_SHA256_HAS_SHA_NI
+
+// x86 SHA extensions. Each 4-round group consumes one message vector; the
+// schedule for group g + 1 is finished (msg2) while group g runs and started
+// (msg1) three groups ahead.
+__attribute__((target("sha,sse4.1,ssse3"))) inline void
+sha256_compress_sha_ni(std::uint32_t *state, const unsigned char *blocks,
+                       std::size_t block_count) {
+  const __m128i byte_swap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state));
+  __m128i state1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4));
+  tmp = _mm_shuffle_epi32(tmp, 0xB1);       // CDAB
+  state1 = _mm_shuffle_epi32(state1, 0x1B); // EFGH
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);         // CDGH
+
+  for (std::size_t block = 0; block < block_count; ++block) {
+    const unsigned char *data = blocks + block * kSha256BlockBytes;
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+    __m128i msgs[4] = {};
+    for (std::size_t g = 0; g < 16U; ++g) {
+      auto &current = msgs[g % 4U];
+      if (g < 4U) {
+        current = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + g * 16U)),
+            byte_swap);
+      }
+      __m128i msg = _mm_add_epi32(
+          current, _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                       kSha256RoundConstants.data() + g * 4U)));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+      if (g >= 3U && g < 15U) {
+        auto &next = msgs[(g + 1U) % 4U];
+        next = _mm_add_epi32(
+            next, _mm_alignr_epi8(current, msgs[(g + 3U) % 4U], 4));
+        next = _mm_sha256msg2_epu32(next, current);
+      }
+      msg = _mm_shuffle_epi32(msg, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+      if (g >= 1U && g < 13U) {
+        auto &previous = msgs[(g + 3U) % 4U];
+        previous = _mm_sha256msg1_epu32(previous, current);
+      }
+    }
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
   }
 
-  std::ostringstream out;
-  out << std::hex << std::setfill('0');
-  for (const std::uint32_t word : h) {
-    out << std::setw(8) << word;
+  tmp = _mm_shuffle_epi32(state0, 0x1B);       // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+  state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), state1);
+}
+
+[[nodiscard]] inline bool cpu_supports_sha_ni() {
+  unsigned int eax = 0;
+  unsigned int ebx = 0;
+  unsigned int ecx = 0;
+  unsigned int edx = 0;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  const bool ssse3 = (ecx & (1U << 9U)) != 0;
+  const bool sse41 = (ecx & (1U << 19U)) != 0;
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  const bool sha = (ebx & (1U << 29U)) != 0;
+  return ssse3 && sse41 && sha;
+}
+
+#endif
+
+// Compression kernel for this CPU, resolved once per process.
+[[nodiscard]] inline sha256_compress_fn_t sha256_compress_kernel() {
+#if CUWACUNU_SHA256_HAS_SHA_NI
+  static const sha256_compress_fn_t kernel = cpu_supports_sha_ni()
+                                                 ? &sha256_compress_sha_ni
+                                                 : &sha256_compress_scalar;
+  return kernel;
+#else
+  return &sha256_compress_scalar;
+#endif
+}
+
+} // namespace detail
+
+// Streaming SHA-256: init(), any number of update() calls, then final_*().
+// Memory use is one block regardless of input size. A finalized context must
+// be re-initialized before it is reused.
+class sha256_ctx_t {
+public:
+  sha256_ctx_t() { init(); }
+
+  void init() {
+    state_ = detail::kSha256InitialState;
+    buffer_size_ = 0;
+    total_bytes_ = 0;
+    finalized_ = false;
+  }
+
+  sha256_ctx_t &update(const void *data, std::size_t size) {
+    if (finalized_) {
+      throw std::logic_error("[sha256] update after final; call init() first");
+    }
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    total_bytes_ += size;
+    if (buffer_size_ != 0) {
+      const std::size_t take =
+          std::min(size, detail::kSha256BlockBytes - buffer_size_);
+      std::memcpy(buffer_.data() + buffer_size_, bytes, take);
+      buffer_size_ += take;
+      bytes += take;
+      size -= take;
+      if (buffer_size_ < detail::kSha256BlockBytes) {
+        return *this;
+      }
+      compress_(state_.data(), buffer_.data(), 1);
+      buffer_size_ = 0;
+    }
+    const std::size_t whole_blocks = size / detail::kSha256BlockBytes;
+    if (whole_blocks != 0) {
+      compress_(state_.data(), bytes, whole_blocks);
+      bytes += whole_blocks * detail::kSha256BlockBytes;
+      size -= whole_blocks * detail::kSha256BlockBytes;
+    }
+    if (size != 0) {
+      std::memcpy(buffer_.data(), bytes, size);
+      buffer_size_ = size;
+    }
+    return *this;
+  }
+
+  sha256_ctx_t &update(std::string_view data) {
+    return update(data.data(), data.size());
+  }
+
+  [[nodiscard]] std::array<std::uint8_t, 32> final_bytes() {
+    if (finalized_) {
+      throw std::logic_error("[sha256] context already finalized");
+    }
+    const std::uint64_t bit_len = total_bytes_ * 8ULL;
+    std::array<unsigned char, 2 * detail::kSha256BlockBytes> tail{};
+    std::memcpy(tail.data(), buffer_.data(), buffer_size_);
+    tail[buffer_size_] = 0x80U;
+    const std::size_t tail_bytes =
+        buffer_size_ + 1U + 8U <= detail::kSha256BlockBytes
+            ? detail::kSha256BlockBytes
+            : 2 * detail::kSha256BlockBytes;
+    for (std::size_t i = 0; i < 8U; ++i) {
+      tail[tail_bytes - 1U - i] =
+          static_cast<unsigned char>((bit_len >> (8U * i)) & 0xffU);
+    }
+    compress_(state_.data(), tail.data(),
+              tail_bytes / detail::kSha256BlockBytes);
+    finalized_ = true;
+
+    std::array<std::uint8_t, 32> out{};
+    for (std::size_t i = 0; i < state_.size(); ++i) {
+      out[i * 4U] = static_cast<std::uint8_t>(state_[i] >> 24U);
+      out[i * 4U + 1U] = static_cast<std::uint8_t>(state_[i] >> 16U);
+      out[i * 4U + 2U] = static_cast<std::uint8_t>(state_[i] >> 8U);
+      out[i * 4U + 3U] = static_cast<std::uint8_t>(state_[i]);
+    }
+    return out;
+  }
+
+  [[nodiscard]] std::string final_hex() {
+    static constexpr char kHex[] = "0123456789abcdef";
+    const auto bytes = final_bytes();
+    std::string out(bytes.size() * 2U, '0');
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+      out[i * 2U] = kHex[bytes[i] >> 4U];
+      out[i * 2U + 1U] = kHex[bytes[i] & 0x0fU];
+    }
+    return out;
+  }
+
+private:
+  detail::sha256_compress_fn_t compress_{detail::sha256_compress_kernel()};
+  std::array<std::uint32_t, 8> state_{};
+  std::array<unsigned char, detail::kSha256BlockBytes> buffer_{};
+  std::size_t buffer_size_{0};
+  std::uint64_t total_bytes_{0};
+  bool finalized_{false};
+};
+
+[[nodiscard]] inline std::string sha256_hex(std::string_view input) {
+  sha256_ctx_t ctx;
+  ctx.update(input);
+  return ctx.final_hex();
+}
+
+// Digests a file by streaming fixed-size chunks, so memory stays bounded by
+// `chunk_bytes` whatever the file size.
+[[nodiscard]] inline std::string
+sha256_file_hex(const std::filesystem::path &path,
+                std::size_t chunk_bytes = std::size_t{1} << 20U) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    throw std::runtime_error("[sha256] could not open " + path.string());
+  }
+  std::vector<char> chunk(std::max<std::size_t>(chunk_bytes, 1));
+  sha256_ctx_t ctx;
+  while (input) {
+    input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    const auto got = input.gcount();
+    if (got > 0) {
+      ctx.update(chunk.data(), static_cast<std::size_t>(got));
+    }
+  }
+  if (!input.eof()) {
+    throw std::runtime_error("[sha256] failed while reading " + path.string());
+  }
+  return ctx.final_hex();
+}
+
+// Digests many files on up to `max_parallel_jobs` worker threads (0 selects
+// hardware_concurrency). Results follow the order of `paths`; the first
+// failure is rethrown after all workers stop.
+[[nodiscard]] inline std::vector<std::string>
+sha256_files_hex(const std::vector<std::filesystem::path> &paths,
+                 std::size_t max_parallel_jobs = 0,
+                 std::size_t chunk_bytes = std::size_t{1} << 20U) {
+  std::vector<std::string> out(paths.size());
+  std::size_t workers =
+      max_parallel_jobs == 0
+          ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+          : max_parallel_jobs;
+  workers = std::min(workers, paths.size());
+  if (workers <= 1) {
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+      out[i] = sha256_file_hex(paths[i], chunk_bytes);
+    }
+    return out;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr failure{};
+  std::mutex failure_mutex;
+  const auto worker = [&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      const std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= paths.size()) {
+        return;
+      }
+      try {
+        out[i] = sha256_file_hex(paths[i], chunk_bytes);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(failure_mutex);
+        if (!failure) {
+          failure = std::current_exception();
+        }
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    pool.emplace_back(worker);
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
   }
-  return out.str();
+  return out;
 }
 
 [[nodiscard]] inline bool is_sha256_hex(const std::string &hex) {
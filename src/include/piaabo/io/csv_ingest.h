@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <latch>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "piaabo/io/mapped_file.h"
+
+namespace cuwacunu {
+namespace piaabo {
+namespace io {
+
+// Parallel CSV ingestion. The file is mapped once and cut into newline-aligned
+// chunks; each window of chunks is parsed on worker threads into per-chunk
+// record buffers that are reused across windows, and the records are handed
+// back in file order. Lines follow std::getline: they end at '\n' (a '\r'
+// before it stays in the line) and a last line without a newline still
+// counts. Line numbers are 1-based and match what a sequential getline loop
+// would pass to the record parser.
+
+struct csv_ingest_options_t {
+  std::size_t worker_count{0}; // 0 selects hardware_concurrency
+  std::size_t chunk_bytes{std::size_t{4} << 20U}; // upper bound per chunk
+};
+
+// Filled when a record fails to parse: its line number and text.
+struct csv_ingest_failure_t {
+  std::size_t line_number{0};
+  std::string line{};
+};
+
+namespace csv_ingest_detail {
+
+inline constexpr std::size_t kMinChunkBytes = std::size_t{64} << 10U;
+
+template <typename T>
+concept has_from_csv_view = requires(std::string_view line, char delimiter,
+                                     std::size_t line_number) {
+  { T::from_csv_view(line, delimiter, line_number) } -> std::same_as<T>;
+};
+
+// Records with a string_view parser are built straight from the mapping; the
+// rest go through from_csv with a per-chunk line buffer whose capacity is
+// reused from line to line.
+template <typename T>
+[[nodiscard]] inline T parse_record(std::string_view line, char delimiter,
+                                    std::size_t line_number,
+                                    std::string *scratch) {
+  if constexpr (has_from_csv_view<T>) {
+    (void)scratch;
+    return T::from_csv_view(line, delimiter, line_number);
+  } else {
+    scratch->assign(line.data(), line.size());
+    return T::from_csv(*scratch, delimiter, line_number);
+  }
+}
+
+[[nodiscard]] inline std::size_t count_lines(std::string_view text) {
+  const auto newlines =
+      static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n'));
+  return newlines + ((!text.empty() && text.back() != '\n') ? 1U : 0U);
+}
+
+// One past the first newline at or after begin + target - 1, or the end of
+// the text.
+[[nodiscard]] inline std::size_t chunk_end(std::string_view text,
+                                           std::size_t begin,
+                                           std::size_t target) {
+  if (text.size() - begin <= target) {
+    return text.size();
+  }
+  const std::size_t from = begin + target - 1U;
+  const void *nl = std::memchr(text.data() + from, '\n', text.size() - from);
+  if (nl == nullptr) {
+    return text.size();
+  }
+  return static_cast<std::size_t>(static_cast<const char *>(nl) -
+                                  text.data()) +
+         1U;
+}
+
+template <typename T> struct chunk_state_t {
+  std::string_view text{};
+  std::size_t lines{0};
+  std::size_t first_line{0};
+  std::vector<T> records{};
+  std::string scratch{};
+  std::exception_ptr error{};
+  std::size_t error_line{0};
+  std::string_view error_text{};
+};
+
+// Parses a chunk up to its first failing line; never throws.
+template <typename T>
+inline void parse_chunk(chunk_state_t<T> *chunk, char delimiter) {
+  chunk->records.clear();
+  chunk->error = nullptr;
+  std::string_view rest = chunk->text;
+  std::size_t line_number = chunk->first_line;
+  std::string_view line{};
+  try {
+    chunk->records.reserve(chunk->lines);
+    while (!rest.empty()) {
+      const std::size_t nl = rest.find('\n');
+      line = rest.substr(0, nl);
+      rest.remove_prefix(nl == std::string_view::npos ? rest.size() : nl + 1U);
+      chunk->records.push_back(
+          parse_record<T>(line, delimiter, line_number, &chunk->scratch));
+      ++line_number;
+    }
+  } catch (...) {
+    chunk->error = std::current_exception();
+    chunk->error_line = line_number;
+    chunk->error_text = line;
+  }
+}
+
+} // namespace csv_ingest_detail
+
+// Number of lines std::getline would read from the file.
+[[nodiscard]] inline std::size_t
+count_csv_lines(const std::filesystem::path &csv_path) {
+  std::error_code ec;
+  if (std::filesystem::file_size(csv_path, ec) == 0 && !ec) {
+    return 0;
+  }
+  const mapped_file_t mapping(csv_path);
+  return csv_ingest_detail::count_lines(std::string_view(
+      reinterpret_cast<const char *>(mapping.data()), mapping.size()));
+}
+
+// Parses every line of `csv_path` as a T and calls
+// `on_chunk(std::span<const T> records, std::size_t first_line)` in file order
+// from the calling thread; returning false stops the scan. When a line fails
+// to parse, the records before it are still delivered, `failure` (if given)
+// receives its line number and text, and the parser's exception is rethrown.
+// Exceptions thrown by `on_chunk` propagate unchanged.
+template <typename T, typename OnChunk>
+void for_each_csv_chunk(const std::filesystem::path &csv_path, char delimiter,
+                        OnChunk &&on_chunk,
+                        const csv_ingest_options_t &options = {},
+                        csv_ingest_failure_t *failure = nullptr) {
+  std::error_code ec;
+  if (std::filesystem::file_size(csv_path, ec) == 0 && !ec) {
+    return; // mapped_file_t rejects empty files; an empty CSV has no lines
+  }
+  const mapped_file_t mapping(csv_path);
+  const std::string_view text(reinterpret_cast<const char *>(mapping.data()),
+                              mapping.size());
+
+  const std::size_t workers =
+      options.worker_count == 0
+          ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+          : options.worker_count;
+  const std::size_t target = std::max<std::size_t>(
+      1, std::min(std::max<std::size_t>(options.chunk_bytes, 1),
+                  std::max(csv_ingest_detail::kMinChunkBytes,
+                           text.size() / workers + 1U)));
+
+  std::vector<csv_ingest_detail::chunk_state_t<T>> window(workers);
+  std::size_t offset = 0;
+  std::size_t next_line = 1;
+  while (offset < text.size()) {
+    std::size_t used = 0;
+    for (; used < workers && offset < text.size(); ++used) {
+      const std::size_t end =
+          csv_ingest_detail::chunk_end(text, offset, target);
+      window[used].text = text.substr(offset, end - offset);
+      offset = end;
+    }
+
+    // Each worker counts its chunk's lines, waits until every count is in,
+    // then derives its first line number and parses.
+    std::latch counted(static_cast<std::ptrdiff_t>(used));
+    const auto work = [&](std::size_t i) {
+      auto &chunk = window[i];
+      chunk.lines = csv_ingest_detail::count_lines(chunk.text);
+      counted.arrive_and_wait();
+      chunk.first_line = next_line;
+      for (std::size_t j = 0; j < i; ++j) {
+        chunk.first_line += window[j].lines;
+      }
+      csv_ingest_detail::parse_chunk(&chunk, delimiter);
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(used - 1U);
+    for (std::size_t i = 1; i < used; ++i) {
+      pool.emplace_back(work, i);
+    }
+    work(0);
+    for (auto &thread : pool) {
+      thread.join();
+    }
+
+    for (std::size_t i = 0; i < used; ++i) {
+      auto &chunk = window[i];
+      next_line += chunk.lines;
+      if (!chunk.records.empty() &&
+          !on_chunk(std::span<const T>(chunk.records), chunk.first_line)) {
+        return;
+      }
+      if (chunk.error) {
+        if (failure != nullptr) {
+          failure->line_number = chunk.error_line;
+          failure->line.assign(chunk.error_text);
+        }
+        std::rethrow_exception(chunk.error);
+      }
+    }
+  }
+}
+
+// Record-at-a-time form of for_each_csv_chunk:
+// `on_record(const T &record, std::size_t line_number)` returns false to stop.
+template <typename T, typename OnRecord>
+void for_each_csv_record(const std::filesystem::path &csv_path, char delimiter,
+                         OnRecord &&on_record,
+                         const csv_ingest_options_t &options = {},
+                         csv_ingest_failure_t *failure = nullptr) {
+  for_each_csv_chunk<T>(
+      csv_path, delimiter,
+      [&](std::span<const T> records, std::size_t first_line) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+          if (!on_record(records[i], first_line + i)) {
+            return false;
+          }
+        }
+        return true;
+      },
+      options, failure);
+}
+
+} // namespace io
+} // namespace piaabo
+} // namespace cuwacunu
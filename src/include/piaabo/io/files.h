@@ -5,6 +5,7 @@
 #include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -13,6 +14,7 @@
 #include <sys/stat.h>
 #endif
 #include "piaabo/core/utils.h"
+#include "piaabo/io/csv_ingest.h"
 
 /*
   Note: The binary representation is dependent on the system's endianness.
@@ -35,27 +37,36 @@ std::ifstream readFileToStream(const std::string &filePath);
  * Converts a CSV file to a binary file by parsing each line of the CSV
  * and serializing it into binary format.
  *
+ * The CSV is memory-mapped and parsed in newline-aligned chunks on worker
+ * threads (see csv_ingest.h); records are written in file order, so the output
+ * is byte-identical to a line-by-line conversion.
+ *
  * Requirements:
  * - The template type T must provide a static method:
  *  static T from_csv(const std::string& line, char delimiter, size_t
  * line_number = 0); This method should parse a CSV line into an instance of T.
+ * - T may additionally provide
+ *  static T from_csv_view(std::string_view line, char delimiter, size_t
+ * line_number = 0); which is then used to parse straight from the mapping.
  *
  * Examples:
- * - Structs like `kline_t` and `trade_t` implement the `from_csv` method
- *   and can be used with this template function.
+ * - Structs like `kline_t` and `trade_t` implement both methods and can be
+ *   used with this template function.
  *
  * Parameters:
  * - csv_filename: Path to the input CSV file.
  * - bin_filename: Path to the output binary file.
- * - buffer_size:  (Optional) Number of records to buffer before writing to disk
- * (default: 1024).
+ * - buffer_size:  (Optional) Must be non-zero; kept for compatibility, records
+ * are now written one parsed chunk at a time (default: 1024).
  * - delimiter:  (Optional) Delimiter character used in the CSV file (default:
  * ',').
+ * - options:  (Optional) Worker count and chunk size for the parallel parse.
  */
 template <typename T>
 void csvFile_to_binary(const std::string &csv_filename,
                        const std::string &bin_filename,
-                       size_t buffer_size = 1024, char delimiter = ',') {
+                       size_t buffer_size = 1024, char delimiter = ',',
+                       const csv_ingest_options_t &options = {}) {
   static_assert(
       std::is_trivially_copyable<T>::value,
       "[csvFile_to_binary] T must be trivially copyable for raw binary writes");
@@ -65,14 +76,12 @@ void csvFile_to_binary(const std::string &csv_filename,
     return;
   }
 
-  std::ifstream csv_file = cuwacunu::piaabo::io::readFileToStream(csv_filename);
   const std::string tmp_bin_filename = bin_filename + ".tmp";
   std::remove(tmp_bin_filename.c_str());
 
   std::ofstream bin_file(tmp_bin_filename,
                          std::ios::binary | std::ios::out | std::ios::trunc);
   if (!bin_file.is_open()) {
-    csv_file.close();
     log_fatal("[csvFile_to_binary] Error: Could not open the temporary binary "
               "file %s for writing\n",
               tmp_bin_filename.c_str());
@@ -85,72 +94,41 @@ void csvFile_to_binary(const std::string &csv_filename,
   }
 #endif
 
-  std::vector<T> buffer;
-  buffer.reserve(buffer_size);
-
-  std::string line;
-  // Optionally skip the header line if present
-  // std::getline(csv_file, line);
-
-  size_t line_number = 0;
   size_t records_written = 0;
-  while (std::getline(csv_file, line)) {
-    ++line_number;
-
-    try {
-      // Create an instance of T from the CSV line
-      T obj = T::from_csv(line, delimiter, line_number);
-
-      // Add the object to the buffer
-      buffer.push_back(obj);
-
-      // Write buffer to binary file when full
-      if (buffer.size() == buffer_size) {
-        bin_file.write(reinterpret_cast<const char *>(buffer.data()),
-                       static_cast<std::streamsize>(buffer.size() * sizeof(T)));
-        if (!bin_file) {
-          csv_file.close();
-          bin_file.close();
-          std::remove(tmp_bin_filename.c_str());
-          log_fatal("[csvFile_to_binary] Error: Failed writing buffered "
-                    "records to %s\n",
-                    tmp_bin_filename.c_str());
-          return;
-        }
-        records_written += buffer.size();
-        buffer.clear();
-      }
-    } catch (const std::exception &e) {
-      csv_file.close();
-      bin_file.close();
-      std::remove(tmp_bin_filename.c_str());
+  csv_ingest_failure_t failure;
+  try {
+    for_each_csv_chunk<T>(
+        csv_filename, delimiter,
+        [&](std::span<const T> records, size_t) {
+          bin_file.write(reinterpret_cast<const char *>(records.data()),
+                         static_cast<std::streamsize>(records.size_bytes()));
+          if (!bin_file) {
+            throw std::runtime_error("[csvFile_to_binary] Failed writing "
+                                     "records to " +
+                                     tmp_bin_filename);
+          }
+          records_written += records.size();
+          return true;
+        },
+        options, &failure);
+  } catch (const std::exception &e) {
+    bin_file.close();
+    std::remove(tmp_bin_filename.c_str());
+    if (failure.line_number == 0) {
+      log_fatal("[csvFile_to_binary] Error: Failed converting %s | "
+                "Exception: %s\n",
+                csv_filename.c_str(), e.what());
+    } else {
       log_fatal("[csvFile_to_binary] Error processing line %zu in %s: %s | "
                 "Exception: %s\n",
-                line_number, csv_filename.c_str(), line.c_str(), e.what());
-      return;
-    }
-  }
-
-  // Write any remaining data in the buffer
-  if (!buffer.empty()) {
-    bin_file.write(reinterpret_cast<const char *>(buffer.data()),
-                   static_cast<std::streamsize>(buffer.size() * sizeof(T)));
-    if (!bin_file) {
-      csv_file.close();
-      bin_file.close();
-      std::remove(tmp_bin_filename.c_str());
-      log_fatal(
-          "[csvFile_to_binary] Error: Failed writing tail records to %s\n",
-          tmp_bin_filename.c_str());
-      return;
+                failure.line_number, csv_filename.c_str(),
+                failure.line.c_str(), e.what());
     }
-    records_written += buffer.size();
-    buffer.clear();
+    return;
   }
 
   bin_file.flush();
   if (!bin_file) {
-    csv_file.close();
     bin_file.close();
     std::remove(tmp_bin_filename.c_str());
     log_fatal("[csvFile_to_binary] Error: Failed flushing output file %s\n",
@@ -158,7 +136,6 @@ void csvFile_to_binary(const std::string &csv_filename,
     return;
   }
 
-  csv_file.close();
   bin_file.close();
   if (std::rename(tmp_bin_filename.c_str(), bin_filename.c_str()) != 0) {
     const int rename_errno = errno;
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace cuwacunu {
+namespace piaabo {
+namespace io {
+
+// Read-only view of a whole file. Pages are mapped copy-on-write, so tensors or
+// buffers handed out over the mapping can be written by consumers without ever
+// reaching the file. Holders typically share one mapping through a
+// std::shared_ptr and keep it alive from tensor deleters.
+class mapped_file_t {
+public:
+  // `allow_empty` accepts a zero-length file as an empty mapping (data() is
+  // null) instead of throwing.
+  explicit mapped_file_t(const std::filesystem::path &path,
+                         bool allow_empty = false) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ == -1) {
+      throw std::system_error(errno, std::generic_category(),
+                              "[mapped_file] could not open " + path.string());
+    }
+    if (::fstat(fd_, &stat_) == -1) {
+      const int saved_errno = errno;
+      ::close(fd_);
+      throw std::system_error(saved_errno, std::generic_category(),
+                              "[mapped_file] could not stat " + path.string());
+    }
+    size_ = static_cast<std::size_t>(stat_.st_size);
+    if (size_ == 0 && allow_empty) {
+      return;
+    }
+    if (size_ == 0) {
+      ::close(fd_);
+      throw std::runtime_error("[mapped_file] file is empty: " +
+                               path.string());
+    }
+    data_ =
+        ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED) {
+      const int saved_errno = errno;
+      data_ = nullptr;
+      ::close(fd_);
+      throw std::system_error(saved_errno, std::generic_category(),
+                              "[mapped_file] could not map " + path.string());
+    }
+  }
+
+  mapped_file_t(const mapped_file_t &) = delete;
+  mapped_file_t &operator=(const mapped_file_t &) = delete;
+
+  ~mapped_file_t() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+  }
+
+  [[nodiscard]] std::uint8_t *data() const {
+    return static_cast<std::uint8_t *>(data_);
+  }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  // fstat of the mapped descriptor, taken when the file was opened.
+  [[nodiscard]] const struct stat &file_stat() const { return stat_; }
+
+  // True when [offset, offset + bytes) lies inside the mapping.
+  [[nodiscard]] bool contains(std::uint64_t offset, std::uint64_t bytes) const {
+    return offset <= size_ && bytes <= size_ - offset;
+  }
+
+private:
+  int fd_{-1};
+  void *data_{nullptr};
+  std::size_t size_{0};
+  struct stat stat_ {};
+};
+
+} // namespace io
+} // namespace piaabo
+} // namespace cuwacunu
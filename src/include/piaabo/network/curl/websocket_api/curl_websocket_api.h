@@ -3,6 +3,7 @@
 
 /* CURL implementing RFC 6455, we just use CURL */
 
+#include <cstdint>
 #include <thread>
 #include <chrono>
 #include <mutex>
@@ -11,6 +12,9 @@
 #include <optional>
 #include <unordered_map>
 #include <condition_variable>
+#include <functional>
+#include <shared_mutex>
+#include <vector>
 #include "piaabo/core/utils.h"
 #include "piaabo/parse/json/json_parsing.h"
 #include "piaabo/network/curl/curl_utils.h"
@@ -49,39 +53,35 @@ struct ws_outgoing_data_t {
   std::chrono::system_clock::time_point local_timestamp;
 };
 
+/* Optional per-session message handler; see ws_set_message_callback */
+using ws_message_callback_fn = std::function<void(ws_session_id_t, const ws_incoming_data_t&)>;
+
 struct WebsocketAPI {
 private:
-  /* 
+  /*
+    Per-session state (defined in the implementation)
+      - easy handle, RX reassembly buffer and RX frames deque
+      - lock-free TX frame stack (multi-producer, drained by the event loop)
+      - handshake / shutdown / running flags and the session trigger
+  */
+  struct ws_session_t;
+
+  /*
     Singleton (static) variables
-      - curl_ws_session_still_running, number of running process per curl_session
-      - map to a curl sessions, one per session
-      - map to a curl_multi handlers, one per session
-      - map to a mutex, one per session
-      - map to a session id, one per session
-      - map to a deque of received data, one per session
-      - map to a deque of outgoing data, one per session
-      - session RX message buffer to join chunks of input messages into a whole
-      - global (in the context of WebsocketAPI) mutex
+      - registry of sessions, read-mostly (shared lock for lookups)
       - sessions_counter; to create unique ids for every session
-      - session thread for the RX (incoming) events
-      - session thread for the TX (outgoing) events
-      - session conditional trigger variable
-  */
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<int>> curl_ws_session_still_running;
-  static std::unordered_map<ws_session_id_t, CURL*> curl_ws_sessions;
-  static std::unordered_map<ws_session_id_t, CURLM *> curl_multi_handles;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<ws_session_id_t>> id_sessions;  /* this unusual map is to preserve in memory a reference to the ws_session_id when passed to the curl constructor */
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::deque<ws_incoming_data_t>>> session_RX_frames_deque;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::deque<ws_outgoing_data_t>>> session_TX_frames_deque;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::string>> session_RX_buffer;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<bool>> session_shutdown_requested;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<bool>> session_handshake_ready;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::mutex>> session_mutex;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::thread>> session_RX_thread;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::thread>> session_TX_thread;
-  static std::unordered_map<ws_session_id_t, std::shared_ptr<std::condition_variable>> session_triggers;
-  static std::mutex global_ws_mutex;
+      - one curl_multi handle driving every session
+      - one event loop thread owning that handle; ws_init hands new sessions
+        to it through pending_sessions, guarded by event_loop_mutex
+  */
+  static std::unordered_map<ws_session_id_t, std::shared_ptr<ws_session_t>> sessions;
+  static std::shared_mutex sessions_mutex;
   static int sessions_counter;
+  static CURLM* multi_handle;
+  static std::thread event_loop_thread;
+  static std::mutex event_loop_mutex;
+  static std::vector<std::shared_ptr<ws_session_t>> pending_sessions;
+  static bool event_loop_stop;
 
   /*
     Enforce Singleton requirements
@@ -103,38 +103,24 @@ public:
   static void finit();
 
 private:
-  /* 
-    Session utils (private)
-      - get session
-      - get session mutex
-      - remove session from the heap
-  */
-  static CURL* get_session(const ws_session_id_t session_id);
-  static CURLM* get_session_multi_handle(const ws_session_id_t session_id);
-  static std::shared_ptr<std::mutex> get_session_mutex(const ws_session_id_t session_id);
-  static std::shared_ptr<std::condition_variable> get_session_trigger(const ws_session_id_t session_id);
-  static std::shared_ptr<int> get_session_still_running(const ws_session_id_t session_id);
-  static std::shared_ptr<ws_session_id_t> get_session_id_ref(const ws_session_id_t session_id);
-  static std::shared_ptr<bool> get_session_shutdown_flag(const ws_session_id_t session_id);
-  static std::shared_ptr<bool> get_session_handshake_flag(const ws_session_id_t session_id);
-  static std::shared_ptr<std::thread> get_session_RX_thread(const ws_session_id_t session_id);
-  static std::shared_ptr<std::thread> get_session_TX_thread(const ws_session_id_t session_id);
-  static std::shared_ptr<std::string> get_session_RX_buffer(const ws_session_id_t session_id);
-  static std::shared_ptr<std::deque<ws_incoming_data_t>> get_session_RX_deque(const ws_session_id_t session_id);
-  static std::shared_ptr<std::deque<ws_outgoing_data_t>> get_session_TX_deque(const ws_session_id_t session_id);
-  static void remove_session(const ws_session_id_t session_id);
-
-  /* 
+  /*
     Session utils (private)
+      - get session (fatal when the id is unknown)
+      - remove session from the registry
       - initialize session
-      - disconnect session
+      - start the event loop (once) and wake it
   */
+  static std::shared_ptr<ws_session_t> get_session(const ws_session_id_t session_id);
+  static void remove_session(const ws_session_id_t session_id);
   static ws_session_id_t initialize_curl_ws_session();
+  static void ensure_event_loop();
+  static void wake_event_loop();
+  static std::string enqueue_frame(const ws_session_id_t session_id, ws_outgoing_data_t frame, const char* what);
 
 public:
   /*
     Wait to flush
-      - waits until session_id TX deque has been flushed
+      - waits until every frame queued on session_id has been sent
   */
   static void ws_wait_to_flush(const ws_session_id_t session_id);
   /*
@@ -192,26 +178,38 @@ public:
   */
   static std::optional<ws_incoming_data_t> ws_await_and_retrieve_server_response(const ws_session_id_t session_id, const std::string target_frame_id);
 
-private:
-  /* 
-    Main curl_multi loop 
-      used to process the activity of the curl handles (sessions)
+  /*
+    Message callback
+      - with a callback set, complete frames go to it instead of the RX deque
+      - callbacks run on a small fixed executor; frames of one session are
+        delivered in order, on the same executor thread
+      - the executor queue is bounded: when a session's lane is full the
+        frame is dropped and counted, so a slow callback never stalls the
+        event loop that serves every session; a callback must not block
+        waiting on websocket responses
+      - pass an empty function to go back to the RX deque
+  */
+  static void ws_set_message_callback(const ws_session_id_t session_id, ws_message_callback_fn callback);
+  /*
+    Frames dropped because the callback queue was full, since startup
   */
-  static void curl_loop(const ws_session_id_t session_id);
+  static std::uint64_t ws_dropped_callback_frames();
 
 private:
   /*
-    Flush (TX) messages
-      - runs an independent thread for every session_id
-      - trigger (notify) when on WebsocketAPI::ws_write_* methods
+    Main curl_multi loop
+      - a single thread serves every session: adds new handles, drains the TX stacks
+        (curl_ws_send must run on the thread that performs the transfer),
+        performs, detects handshakes, and retires finished or closing sessions
+      - sleeps in curl_multi_poll; writers wake it with curl_multi_wakeup
   */
-  static void flush_messages_loop(const ws_session_id_t session_id);
+  static void event_loop();
 
 private:
   /* 
     Write_callback method, 
       - on receiving a message it will add the data to the session deque. 
-      - there is a separate thread that processes those deques; the writeback is left simple without the logic of interpreting the data.
+      - runs on the event loop thread; the writeback is left simple without the logic of interpreting the data.
   */
   static size_t websocket_RX_callback(char* ptr, size_t size, size_t nmemb, void* userdata);
 };
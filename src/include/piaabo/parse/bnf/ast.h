@@ -86,6 +86,9 @@ void pop_context(VisitorContext& context, const ASTNode* node);
 // Function to compare ASTs
 bool compareAST(const ASTNode* actual, const ASTNode* expected);
 
+// Deep copy of an AST, preserving node names and hashes
+ASTNodePtr cloneAST(const ASTNode* node);
+
 } // namespace bnf
 } // namespace parse
 } // namespace piaabo
@@ -0,0 +1,87 @@
+/* bnf_compiled_grammar.h */
+#pragma once
+#include <array>
+#include <bitset>
+#include <filesystem>
+#include <memory>
+#include "piaabo/parse/bnf/parser_types.h"
+
+namespace cuwacunu {
+namespace piaabo {
+namespace parse {
+namespace bnf {
+
+/**
+ * @brief A ProductionGrammar plus the lookup tables the InstructionParser
+ *    needs at parse time: rule ids, nullability, first-character sets and
+ *    decoded terminal literals. Building it is a one-time pass over the rules;
+ *    it is immutable afterwards and safe to share between parsers.
+ */
+struct CompiledGrammar {
+  ProductionGrammar grammar;
+  std::unordered_map<std::string, size_t> rule_ids;      /* lhs -> index in grammar.rules */
+  std::vector<std::bitset<256>> first_sets;               /* first input byte of any match */
+  std::vector<bool> nullable;                             /* rule may match without input */
+  std::vector<std::string> rule_strings;                  /* rule.str(false), for diagnostics */
+  std::unordered_map<std::string, std::string> terminal_literals; /* raw lexeme -> bytes to match */
+
+  /* rule id for a non-terminal lexeme ("<rule>"); throws std::invalid_argument like ProductionGrammar::getRule */
+  size_t ruleId(const std::string& lhs) const;
+  /* the decoded bytes a terminal unit must match */
+  const std::string& terminalLiteral(const ProductionUnit& unit) const;
+  /* true when the rule can be skipped without trying it at a position whose next byte is ch */
+  bool rejects(size_t rule_id, unsigned char ch, bool at_end) const;
+};
+
+/* decoded form of a terminal lexeme: quotes stripped, escape sequences resolved */
+std::string decodeTerminalLexeme(const std::string& lexeme);
+
+CompiledGrammar compileGrammar(const ProductionGrammar& grammar);
+
+/**
+ * @brief Lexes, parses and compiles grammar text. Results are memoized per
+ *    process by grammar text, so decoders built repeatedly over the same
+ *    grammar share one compiled form.
+ */
+std::shared_ptr<const CompiledGrammar> compileGrammarText(const std::string& grammar_text);
+
+/**
+ * @brief Binary cache of a compiled grammar. The file records the SHA-256 of
+ *    the grammar text it was built from; loading returns false (and leaves
+ *    `out` untouched) when the file is absent, malformed or built from other
+ *    text.
+ */
+void saveCompiledGrammar(const CompiledGrammar& compiled, const std::string& grammar_text, const std::filesystem::path& cache_path);
+bool loadCompiledGrammar(const std::filesystem::path& cache_path, const std::string& grammar_text, CompiledGrammar* out);
+
+/* cache file kept next to a grammar file: "<grammar>.compiled" */
+std::filesystem::path compiledGrammarCachePath(const std::filesystem::path& grammar_path);
+
+/**
+ * @brief Reads a grammar file and returns its compiled form, loading
+ *    "<grammar>.compiled" when it matches the text and refreshing it
+ *    otherwise. A cache that cannot be written is not an error. The result
+ *    also seeds the compileGrammarText memo.
+ */
+std::shared_ptr<const CompiledGrammar> loadGrammarFileCached(const std::filesystem::path& grammar_path);
+
+/* grammar file text together with its compiled form, for decoders that keep the text */
+struct CachedGrammarFile {
+  std::string text;
+  std::shared_ptr<const CompiledGrammar> compiled;
+};
+/* loadGrammarFileCached that also returns the text it read */
+CachedGrammarFile readGrammarFileCached(const std::filesystem::path& grammar_path);
+
+/* how this process's grammar file loads were served */
+struct GrammarFileCacheStats {
+  size_t memo_hits = 0;  /* already compiled in this process */
+  size_t file_hits = 0;  /* loaded from "<grammar>.compiled" */
+  size_t compiles = 0;   /* lexed and compiled, cache refreshed */
+};
+GrammarFileCacheStats grammarFileCacheStats();
+
+} /* namespace bnf */
+} /* namespace parse */
+} /* namespace piaabo */
+} /* namespace cuwacunu */
@@ -2,6 +2,7 @@
 #pragma once
 #include <stack>
 #include "piaabo/parse/bnf/ast.h"
+#include "piaabo/parse/bnf/compiled_grammar.h"
 #include "piaabo/parse/bnf/parser_types.h"
 #include "piaabo/parse/bnf/grammar_lexer.h"
 #include "piaabo/parse/bnf/instruction_lexer.h"
@@ -14,25 +15,60 @@ namespace bnf {
 
 class InstructionParser {
 private:
+  /* a parse event; formatted only when the instruction fails to parse */
+  struct Diagnostic {
+    enum class Kind { TerminalMismatch, RuleFailure, MultipleAlternatives, RuleSuccess };
+    Kind kind = Kind::RuleFailure;
+    size_t rule_id = 0;                          /* RuleFailure, MultipleAlternatives */
+    size_t count = 0;                            /* MultipleAlternatives */
+    const ProductionAlternative* alt = nullptr;  /* RuleSuccess: the matched alternative */
+    const ProductionUnit* unit = nullptr;        /* TerminalMismatch */
+    char expected = '\0';
+    char found = '\0';
+  };
+
+  /* packrat memo entry for one (rule id, input position) */
+  struct MemoEntry {
+    bool matched = false;
+    size_t end_position = 0;
+    ASTNodePtr node;                /* kept from the second visit on */
+    Diagnostic success;
+    bool had_failure = false;       /* a terminal failed inside this attempt */
+    size_t failure_position = 0;
+    bool cleared_errors = false;    /* a terminal matched inside this attempt */
+  };
+
   InstructionLexer iLexer;
-  ProductionGrammar grammar;
-  std::stack<std::string> parsing_error_stack;
-  std::stack<std::string> parsing_success_stack;
+  std::shared_ptr<const CompiledGrammar> compiled;
+  std::stack<Diagnostic> parsing_error_stack;
+  std::stack<Diagnostic> parsing_success_stack;
   size_t failure_position;
+  size_t terminal_failure_count = 0;
+  size_t error_clear_count = 0;
+  std::unordered_map<size_t, MemoEntry> memo;   /* key: rule_id * memo_stride + position */
+  size_t memo_stride = 1;
 public:
   InstructionParser(InstructionLexer& iLexer, ProductionGrammar& grammar)
-    : iLexer(iLexer), grammar(grammar), parsing_error_stack(), parsing_success_stack() {
+    : InstructionParser(iLexer, std::make_shared<const CompiledGrammar>(compileGrammar(grammar))) {}
+
+  /* shares an already compiled grammar, e.g. from compileGrammarText or loadGrammarFileCached */
+  InstructionParser(InstructionLexer& iLexer, std::shared_ptr<const CompiledGrammar> compiled)
+    : iLexer(iLexer), compiled(std::move(compiled)), parsing_error_stack(), parsing_success_stack() {
       iLexer.reset();
   }
 
   ASTNodePtr parse_Instruction(const std::string& instruction_input); /* left-hand side of <instruction> */
 
 private:
-  ASTNodePtr parse_ProductionRule(const ProductionRule& rule);
+  ASTNodePtr parse_ProductionRule(size_t rule_id);
   ASTNodePtr parse_ProductionAlternative(const ProductionAlternative& alt);
   ASTNodePtr parse_ProductionUnit(const ProductionAlternative& alt, const ProductionUnit& unit);
   
   ASTNodePtr parse_TerminalNode(const std::string& lhs, const ProductionUnit& unit);
+
+  ASTNodePtr replay_Memo(MemoEntry& entry);
+  void clear_ErrorStack();
+  std::string format_Diagnostic(const Diagnostic& diagnostic) const;
 };
 
 } /* namespace bnf */
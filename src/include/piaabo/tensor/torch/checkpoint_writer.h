@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <torch/torch.h>
+
+namespace cuwacunu {
+namespace piaabo {
+namespace tensor {
+namespace torch {
+
+// Checkpoint string metadata as one uint8 element per byte. Readers that
+// convert the tensor to int64 see the same values as the older int64 layout.
+[[nodiscard]] inline ::torch::Tensor
+string_metadata_tensor(const std::string &value) {
+  auto out = ::torch::empty({static_cast<std::int64_t>(value.size())},
+                            ::torch::TensorOptions().dtype(::torch::kUInt8));
+  if (!value.empty()) {
+    std::memcpy(out.data_ptr<std::uint8_t>(), value.data(), value.size());
+  }
+  return out;
+}
+
+struct checkpoint_writer_stats_t {
+  std::uint64_t submitted{0};
+  std::uint64_t written{0};
+  std::uint64_t backpressure_waits{0};
+  std::uint64_t last_bytes{0};
+};
+
+// Double-buffered background writer for torch archives.
+//
+// submit() serializes the archive into whichever staging buffer is not being
+// written. The buffers keep their capacity, so steady-state checkpoints do not
+// allocate. Only the file write, fsync and atomic rename run on the writer
+// thread. Archives hold references to live parameter and optimizer-state
+// storage, so the serialized bytes are the snapshot; training may mutate the
+// tensors as soon as submit() returns.
+//
+// At most one write is in flight. A submit() that finds the previous write
+// still running waits for it (backpressure) instead of queueing more
+// snapshots than the disk can absorb. A failed write is rethrown by the next
+// submit() or wait(). submit() and wait() must be called from one thread.
+class checkpoint_writer_t {
+public:
+  checkpoint_writer_t() = default;
+  checkpoint_writer_t(const checkpoint_writer_t &) = delete;
+  checkpoint_writer_t &operator=(const checkpoint_writer_t &) = delete;
+
+  ~checkpoint_writer_t() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [&] { return !in_flight_; });
+      stop_ = true;
+    }
+    ready_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  void submit(::torch::serialize::OutputArchive &archive,
+              std::filesystem::path path) {
+    if (path.empty()) {
+      throw std::runtime_error("[piaabo_checkpoint] checkpoint path is "
+                               "required");
+    }
+    rethrow_failure_();
+    auto &staging = buffers_[staging_index_];
+    staging.clear();
+    archive.save_to([&staging](const void *data, std::size_t size) {
+      const auto *bytes = static_cast<const char *>(data);
+      staging.insert(staging.end(), bytes, bytes + size);
+      return size;
+    });
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (in_flight_) {
+      ++stats_.backpressure_waits;
+      done_.wait(lock, [&] { return !in_flight_; });
+    }
+    throw_if_failed_locked_();
+    ++stats_.submitted;
+    pending_index_ = staging_index_;
+    pending_path_ = std::move(path);
+    staging_index_ ^= 1;
+    in_flight_ = true;
+    job_ready_ = true;
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this] { run_(); });
+    }
+    lock.unlock();
+    ready_.notify_one();
+  }
+
+  // Blocks until the in-flight write, if any, is on disk.
+  void wait() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [&] { return !in_flight_; });
+    }
+    rethrow_failure_();
+  }
+
+  [[nodiscard]] bool busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+  }
+
+  [[nodiscard]] checkpoint_writer_stats_t stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  // Writes `bytes` to `path` via a temporary sibling, fsync and rename, then
+  // syncs the directory so the rename itself is durable.
+  static void write_file_durably(const std::filesystem::path &path,
+                                 const std::vector<char> &bytes) {
+    const std::string tmp =
+        path.string() + ".tmp." + std::to_string(::getpid());
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      throw std::runtime_error("[piaabo_checkpoint] cannot open " + tmp +
+                               ": " + std::strerror(errno));
+    }
+    std::size_t offset = 0;
+    while (offset < bytes.size()) {
+      const ::ssize_t n =
+          ::write(fd, bytes.data() + offset, bytes.size() - offset);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("[piaabo_checkpoint] cannot write " + tmp +
+                                 ": " + reason);
+      }
+      offset += static_cast<std::size_t>(n);
+    }
+    if (::fsync(fd) != 0) {
+      const std::string reason = std::strerror(errno);
+      ::close(fd);
+      ::unlink(tmp.c_str());
+      throw std::runtime_error("[piaabo_checkpoint] cannot fsync " + tmp +
+                               ": " + reason);
+    }
+    ::close(fd);
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      ::unlink(tmp.c_str());
+      throw std::runtime_error("[piaabo_checkpoint] cannot publish " +
+                               path.string() + ": " + ec.message());
+    }
+    const auto parent = path.has_parent_path() ? path.parent_path()
+                                               : std::filesystem::path(".");
+    const int dir_fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+      (void)::fsync(dir_fd);
+      ::close(dir_fd);
+    }
+  }
+
+private:
+  void rethrow_failure_() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    throw_if_failed_locked_();
+  }
+
+  void throw_if_failed_locked_() {
+    if (!error_.empty()) {
+      std::string error = std::move(error_);
+      error_.clear();
+      throw std::runtime_error(error);
+    }
+  }
+
+  void run_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      ready_.wait(lock, [&] { return job_ready_ || stop_; });
+      if (!job_ready_) {
+        return;
+      }
+      job_ready_ = false;
+      const auto path = pending_path_;
+      const auto &bytes = buffers_[pending_index_];
+      lock.unlock();
+      std::string error;
+      try {
+        write_file_durably(path, bytes);
+      } catch (const std::exception &ex) {
+        error = ex.what();
+      }
+      lock.lock();
+      if (error.empty()) {
+        ++stats_.written;
+        stats_.last_bytes = bytes.size();
+      } else if (error_.empty()) {
+        error_ = std::move(error);
+      }
+      in_flight_ = false;
+      done_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_{};
+  std::condition_variable ready_{};
+  std::condition_variable done_{};
+  std::vector<char> buffers_[2]{};
+  int staging_index_{0};
+  int pending_index_{0};
+  std::filesystem::path pending_path_{};
+  bool in_flight_{false};
+  bool job_ready_{false};
+  bool stop_{false};
+  std::string error_{};
+  checkpoint_writer_stats_t stats_{};
+  std::thread thread_{};
+};
+
+} // namespace torch
+} // namespace tensor
+} // namespace piaabo
+} // namespace cuwacunu
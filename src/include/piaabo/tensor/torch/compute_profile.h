@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <torch/torch.h>
+
+#include "piaabo/log/dlogs.h"
+
+namespace cuwacunu {
+namespace piaabo {
+namespace tensor {
+namespace torch {
+
+// What a process is about to do with Torch. Thread budgets and the
+// InferenceMode choice are made per role.
+enum class compute_role_t {
+  train,
+  evaluation, // non-train waves, including forecast-artifact export
+  replay,
+};
+
+[[nodiscard]] inline const char *compute_role_name(compute_role_t role) {
+  switch (role) {
+  case compute_role_t::train:
+    return "train";
+  case compute_role_t::evaluation:
+    return "evaluation";
+  case compute_role_t::replay:
+    return "replay";
+  }
+  return "unknown";
+}
+
+// Zero keeps Torch's default for that pool.
+struct compute_thread_budget_t {
+  std::int64_t intra_op_threads{0};
+  std::int64_t inter_op_threads{0};
+};
+
+struct compute_profile_t {
+  compute_thread_budget_t train{};
+  compute_thread_budget_t evaluation{};
+  // Replay fans out into one worker job per rollout, capped at
+  // available cores / compute_cores_per_job. Single-threaded workers make
+  // that cap the core count, so the default already uses the whole machine
+  // without oversubscribing it; wider budgets trade workers for threads.
+  compute_thread_budget_t replay{1, 1};
+  // Evaluation and replay never backpropagate, so they run under
+  // c10::InferenceMode and skip version-counter and view tracking.
+  bool inference_mode{true};
+
+  [[nodiscard]] compute_thread_budget_t &budget(compute_role_t role) {
+    return const_cast<compute_thread_budget_t &>(
+        static_cast<const compute_profile_t &>(*this).budget(role));
+  }
+
+  [[nodiscard]] const compute_thread_budget_t &
+  budget(compute_role_t role) const {
+    switch (role) {
+    case compute_role_t::train:
+      return train;
+    case compute_role_t::evaluation:
+      return evaluation;
+    case compute_role_t::replay:
+      return replay;
+    }
+    throw std::runtime_error("[piaabo_compute] unknown compute role");
+  }
+
+  [[nodiscard]] bool uses_inference_mode(compute_role_t role) const {
+    return inference_mode && role != compute_role_t::train;
+  }
+};
+
+inline void validate_compute_profile(const compute_profile_t &profile) {
+  for (const auto role : {compute_role_t::train, compute_role_t::evaluation,
+                          compute_role_t::replay}) {
+    const auto &budget = profile.budget(role);
+    if (budget.intra_op_threads < 0 || budget.inter_op_threads < 0) {
+      throw std::runtime_error(
+          std::string("[piaabo_compute] thread budgets must be nonnegative "
+                      "for role ") +
+          compute_role_name(role));
+    }
+  }
+}
+
+[[nodiscard]] inline std::size_t available_compute_cores() {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Cores one job of this budget keeps busy. Eager LibTorch work runs on the
+// intra-op pool; the inter-op pool only serves async forks, so it does not
+// add to the count.
+[[nodiscard]] inline std::size_t
+compute_cores_per_job(const compute_thread_budget_t &budget) {
+  if (budget.intra_op_threads <= 0) {
+    return available_compute_cores();
+  }
+  return std::min(static_cast<std::size_t>(budget.intra_op_threads),
+                  available_compute_cores());
+}
+
+// Largest worker count not above `requested` whose combined core use fits in
+// `available_cores`. Always at least one.
+[[nodiscard]] inline std::size_t
+parallel_jobs_within_core_budget(std::size_t requested,
+                                 std::size_t cores_per_job,
+                                 std::size_t available_cores) {
+  const auto fit = available_cores / std::max<std::size_t>(1, cores_per_job);
+  return std::max<std::size_t>(1, std::min(requested, fit));
+}
+
+// Applies a budget to this process. The intra-op count can change at any
+// time. The inter-op pool is sized once, before its first use; later requests
+// keep the existing pool and log a warning.
+inline void apply_compute_thread_budget(const compute_thread_budget_t &budget) {
+  if (budget.intra_op_threads > 0) {
+    at::set_num_threads(static_cast<int>(budget.intra_op_threads));
+  }
+  if (budget.inter_op_threads > 0 &&
+      at::get_num_interop_threads() != budget.inter_op_threads) {
+    try {
+      at::set_num_interop_threads(static_cast<int>(budget.inter_op_threads));
+    } catch (const c10::Error &e) {
+      log_warn("[piaabo_compute] keeping the %d-thread inter-op pool; "
+               "requested %lld: %s\n",
+               static_cast<int>(at::get_num_interop_threads()),
+               static_cast<long long>(budget.inter_op_threads),
+               e.what_without_backtrace());
+    }
+  }
+}
+
+// Applies the role's thread budget and, for evaluation and replay, holds
+// InferenceMode on the constructing thread. InferenceMode is thread-local:
+// worker threads open their own guard. The intra-op count in force before the
+// scope is restored on exit; the inter-op pool cannot be resized, so it stays.
+class compute_scope_t {
+public:
+  compute_scope_t(const compute_profile_t &profile, compute_role_t role) {
+    validate_compute_profile(profile);
+    const auto &budget = profile.budget(role);
+    if (budget.intra_op_threads > 0) {
+      previous_intra_op_threads_ = at::get_num_threads();
+    }
+    apply_compute_thread_budget(budget);
+    if (profile.uses_inference_mode(role)) {
+      inference_mode_.emplace();
+    }
+  }
+  ~compute_scope_t() {
+    inference_mode_.reset();
+    if (previous_intra_op_threads_.has_value() &&
+        at::get_num_threads() != *previous_intra_op_threads_) {
+      at::set_num_threads(*previous_intra_op_threads_);
+    }
+  }
+  compute_scope_t(const compute_scope_t &) = delete;
+  compute_scope_t &operator=(const compute_scope_t &) = delete;
+
+  [[nodiscard]] bool inference_mode() const {
+    return inference_mode_.has_value();
+  }
+
+private:
+  std::optional<int> previous_intra_op_threads_{};
+  std::optional<c10::InferenceMode> inference_mode_{};
+};
+
+} // namespace torch
+} // namespace tensor
+} // namespace piaabo
+} // namespace cuwacunu
@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <torch/torch.h>
+
+namespace cuwacunu {
+namespace piaabo {
+namespace tensor {
+namespace torch {
+
+// Copies a list of scalar tensors to the host with one device transfer.
+// Undefined or empty entries come back as NaN; every value is read as double.
+[[nodiscard]] inline std::vector<double>
+materialize_scalars(const std::vector<::torch::Tensor> &values) {
+  std::vector<double> out(values.size(),
+                          std::numeric_limits<double>::quiet_NaN());
+  std::vector<::torch::Tensor> defined;
+  std::vector<std::size_t> positions;
+  defined.reserve(values.size());
+  positions.reserve(values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (values[i].defined() && values[i].numel() > 0) {
+      defined.push_back(
+          values[i].detach().reshape({-1}).select(0, 0).to(::torch::kFloat64));
+      positions.push_back(i);
+    }
+  }
+  if (defined.empty()) {
+    return out;
+  }
+  const auto device = defined.front().device();
+  for (auto &value : defined) {
+    if (value.device() != device) {
+      value = value.to(device);
+    }
+  }
+  const auto host = ::torch::stack(defined).to(::torch::kCPU).contiguous();
+  const double *data = host.data_ptr<double>();
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    out[positions[i]] = data[i];
+  }
+  return out;
+}
+
+// Running per-slot sums, finite counts, last values and maxima of scalar
+// metrics, kept as device tensors. Each step stages its scalars and commits
+// them with a handful of vectorized kernels; the host copy is refreshed only
+// when materialize() is called, in a single transfer. Sums are accumulated in
+// float64 in step order, so materialized means match a host loop over
+// `.item<double>()` values.
+class device_metric_accumulator_t {
+public:
+  explicit device_metric_accumulator_t(std::size_t slot_count)
+      : staged_(slot_count), host_sum_(slot_count, 0.0),
+        host_count_(slot_count, 0),
+        host_last_(slot_count, std::numeric_limits<double>::quiet_NaN()),
+        host_max_(slot_count, -std::numeric_limits<double>::infinity()) {
+    if (slot_count == 0) {
+      throw std::invalid_argument(
+          "[device_metric_accumulator] slot_count must be positive");
+    }
+  }
+
+  [[nodiscard]] std::size_t slot_count() const { return staged_.size(); }
+  [[nodiscard]] int64_t commit_count() const { return commit_count_; }
+
+  // Undefined or empty values are staged as NaN: they reset the slot's last
+  // value and are excluded from the sum, count and max.
+  void stage(std::size_t slot, const ::torch::Tensor &value) {
+    check_slot(slot);
+    if (!value.defined() || value.numel() == 0) {
+      staged_[slot] = ::torch::Tensor{};
+      staged_any_ = true;
+      return;
+    }
+    staged_[slot] = value.detach().reshape({}).to(::torch::kFloat64);
+    staged_any_ = true;
+  }
+
+  void commit() {
+    if (!staged_any_) {
+      return;
+    }
+    ::torch::Device device{::torch::kCPU};
+    bool found_device = false;
+    for (const auto &value : staged_) {
+      if (value.defined()) {
+        device = value.device();
+        found_device = true;
+        break;
+      }
+    }
+    if (!found_device && sums_.defined()) {
+      device = sums_.device();
+    }
+    const auto options =
+        ::torch::TensorOptions().dtype(::torch::kFloat64).device(device);
+    if (!sums_.defined()) {
+      const auto slots = static_cast<int64_t>(staged_.size());
+      sums_ = ::torch::zeros({slots}, options);
+      counts_ = ::torch::zeros({slots}, options.dtype(::torch::kInt64));
+      last_ = ::torch::full({slots}, std::numeric_limits<double>::quiet_NaN(),
+                            options);
+      max_ = ::torch::full({slots}, -std::numeric_limits<double>::infinity(),
+                           options);
+      nan_ = ::torch::full({}, std::numeric_limits<double>::quiet_NaN(),
+                           options);
+    }
+    std::vector<::torch::Tensor> row;
+    row.reserve(staged_.size());
+    for (auto &value : staged_) {
+      row.push_back(value.defined() ? value.to(sums_.device()) : nan_);
+      value = ::torch::Tensor{};
+    }
+    const auto values = ::torch::stack(row);
+    const auto finite = ::torch::isfinite(values);
+    sums_.add_(::torch::where(finite, values, ::torch::zeros_like(values)));
+    counts_.add_(finite.to(::torch::kInt64));
+    last_.copy_(values);
+    max_ = ::torch::maximum(
+        max_, ::torch::where(finite, values,
+                             ::torch::full_like(
+                                 values,
+                                 -std::numeric_limits<double>::infinity())));
+    staged_any_ = false;
+    dirty_ = true;
+    ++commit_count_;
+  }
+
+  // Refreshes the host view with one device-to-host copy.
+  void materialize() {
+    if (!dirty_) {
+      return;
+    }
+    const auto host =
+        ::torch::stack({sums_, counts_.to(::torch::kFloat64), last_, max_})
+            .to(::torch::kCPU)
+            .contiguous();
+    const double *data = host.data_ptr<double>();
+    const std::size_t slots = staged_.size();
+    for (std::size_t i = 0; i < slots; ++i) {
+      host_sum_[i] = data[i];
+      host_count_[i] = static_cast<int64_t>(data[slots + i]);
+      host_last_[i] = data[2 * slots + i];
+      host_max_[i] = data[3 * slots + i];
+    }
+    dirty_ = false;
+  }
+
+  [[nodiscard]] double sum(std::size_t slot) const {
+    check_slot(slot);
+    return host_sum_[slot];
+  }
+  [[nodiscard]] int64_t count(std::size_t slot) const {
+    check_slot(slot);
+    return host_count_[slot];
+  }
+  [[nodiscard]] double last(std::size_t slot) const {
+    check_slot(slot);
+    return host_last_[slot];
+  }
+  [[nodiscard]] double max(std::size_t slot) const {
+    check_slot(slot);
+    return host_max_[slot];
+  }
+  [[nodiscard]] double mean_or_nan(std::size_t slot) const {
+    check_slot(slot);
+    return host_count_[slot] > 0
+               ? host_sum_[slot] / static_cast<double>(host_count_[slot])
+               : std::numeric_limits<double>::quiet_NaN();
+  }
+
+private:
+  void check_slot(std::size_t slot) const {
+    if (slot >= staged_.size()) {
+      throw std::out_of_range("[device_metric_accumulator] slot out of range");
+    }
+  }
+
+  std::vector<::torch::Tensor> staged_{};
+  bool staged_any_{false};
+  bool dirty_{false};
+  int64_t commit_count_{0};
+  ::torch::Tensor sums_{};
+  ::torch::Tensor counts_{};
+  ::torch::Tensor last_{};
+  ::torch::Tensor max_{};
+  ::torch::Tensor nan_{};
+  std::vector<double> host_sum_{};
+  std::vector<int64_t> host_count_{};
+  std::vector<double> host_last_{};
+  std::vector<double> host_max_{};
+};
+
+} // namespace torch
+} // namespace tensor
+} // namespace piaabo
+} // namespace cuwacunu
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <ATen/autocast_mode.h>
+#include <torch/torch.h>
+#include <torch/version.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace cuwacunu {
+namespace piaabo {
+namespace tensor {
+namespace torch {
+
+// Training precision. `bf16_autocast` runs autocast-eligible ops (linear,
+// matmul, conv) in bfloat16 on CPU while parameters, optimizer state and
+// gradients stay float32.
+enum class precision_policy_t {
+  float32,
+  bf16_autocast,
+};
+
+[[nodiscard]] inline const char *
+precision_policy_name(precision_policy_t policy) {
+  switch (policy) {
+  case precision_policy_t::float32:
+    return "float32";
+  case precision_policy_t::bf16_autocast:
+    return "bf16_autocast";
+  }
+  return "unknown";
+}
+
+[[nodiscard]] inline precision_policy_t
+parse_precision_policy(std::string_view value) {
+  if (value.empty() || value == "float32") {
+    return precision_policy_t::float32;
+  }
+  if (value == "bf16_autocast") {
+    return precision_policy_t::bf16_autocast;
+  }
+  throw std::runtime_error("[piaabo_precision] unknown precision policy: " +
+                           std::string(value));
+}
+
+// AVX512-BF16 (CPUID.7.1:EAX[5]) or AMX-BF16 (CPUID.7.0:EDX[22]). Without
+// either, bf16 matmuls are emulated and slower than float32.
+[[nodiscard]] inline bool cpu_has_native_bf16() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (__get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx) != 0 &&
+      (eax & (1u << 5)) != 0) {
+    return true;
+  }
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0 &&
+      (edx & (1u << 22)) != 0) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+// Why a `bf16_autocast` request runs as float32 on this device/dtype, or
+// empty when the request is honored (or was float32 to begin with). Launchers
+// record the reason in their run report so a silent downgrade is visible.
+[[nodiscard]] inline std::string
+precision_policy_fallback_reason(precision_policy_t requested,
+                                 const ::torch::Device &device,
+                                 ::torch::Dtype dtype = ::torch::kFloat32) {
+  if (requested != precision_policy_t::bf16_autocast) {
+    return {};
+  }
+  if (!device.is_cpu()) {
+    return "device_not_cpu";
+  }
+  if (dtype != ::torch::kFloat32) {
+    return "dtype_not_float32";
+  }
+  if (!cpu_has_native_bf16()) {
+    return "cpu_without_native_bf16";
+  }
+  return {};
+}
+
+[[nodiscard]] inline std::string
+precision_policy_fallback_reason(std::string_view requested,
+                                 const ::torch::Device &device,
+                                 ::torch::Dtype dtype = ::torch::kFloat32) {
+  return precision_policy_fallback_reason(parse_precision_policy(requested),
+                                          device, dtype);
+}
+
+// The policy a training run actually uses: bf16 autocast only for float32
+// models on CPU devices with native bf16 support, float32 otherwise. Autocast
+// never touches float64 tensors, so float64 models report float32.
+[[nodiscard]] inline precision_policy_t
+effective_precision_policy(precision_policy_t requested,
+                           const ::torch::Device &device,
+                           ::torch::Dtype dtype = ::torch::kFloat32) {
+  if (requested == precision_policy_t::bf16_autocast &&
+      precision_policy_fallback_reason(requested, device, dtype).empty()) {
+    return precision_policy_t::bf16_autocast;
+  }
+  return precision_policy_t::float32;
+}
+
+[[nodiscard]] inline precision_policy_t
+effective_precision_policy(std::string_view requested,
+                           const ::torch::Device &device,
+                           ::torch::Dtype dtype = ::torch::kFloat32) {
+  return effective_precision_policy(parse_precision_policy(requested), device,
+                                    dtype);
+}
+
+// bfloat16/half tensors widened to float32; anything else is returned as is,
+// so float64 paths keep their dtype.
+[[nodiscard]] inline ::torch::Tensor
+widen_reduced_precision(const ::torch::Tensor &value) {
+  if (value.defined() && (value.scalar_type() == ::torch::kBFloat16 ||
+                          value.scalar_type() == ::torch::kHalf)) {
+    return value.to(::torch::kFloat32);
+  }
+  return value;
+}
+
+namespace mixed_precision_detail {
+
+#if TORCH_VERSION_MAJOR > 2 ||                                                 \
+    (TORCH_VERSION_MAJOR == 2 && TORCH_VERSION_MINOR >= 4)
+[[nodiscard]] inline bool cpu_autocast_enabled() {
+  return at::autocast::is_autocast_enabled(at::kCPU);
+}
+inline void set_cpu_autocast_enabled(bool enabled) {
+  at::autocast::set_autocast_enabled(at::kCPU, enabled);
+}
+[[nodiscard]] inline at::ScalarType cpu_autocast_dtype() {
+  return at::autocast::get_autocast_dtype(at::kCPU);
+}
+inline void set_cpu_autocast_dtype(at::ScalarType dtype) {
+  at::autocast::set_autocast_dtype(at::kCPU, dtype);
+}
+#else
+[[nodiscard]] inline bool cpu_autocast_enabled() {
+  return at::autocast::is_cpu_enabled();
+}
+inline void set_cpu_autocast_enabled(bool enabled) {
+  at::autocast::set_cpu_enabled(enabled);
+}
+[[nodiscard]] inline at::ScalarType cpu_autocast_dtype() {
+  return at::autocast::get_autocast_cpu_dtype();
+}
+inline void set_cpu_autocast_dtype(at::ScalarType dtype) {
+  at::autocast::set_autocast_cpu_dtype(dtype);
+}
+#endif
+
+} // namespace mixed_precision_detail
+
+// Enables CPU bf16 autocast on this thread for `bf16_autocast`; a no-op for
+// `float32`. Wrap the forward pass only: backward and the optimizer step run
+// outside, on the float32 master weights.
+class autocast_scope_t {
+public:
+  explicit autocast_scope_t(precision_policy_t policy)
+      : enabled_(policy == precision_policy_t::bf16_autocast) {
+    if (!enabled_) {
+      return;
+    }
+    previous_enabled_ = mixed_precision_detail::cpu_autocast_enabled();
+    previous_dtype_ = mixed_precision_detail::cpu_autocast_dtype();
+    mixed_precision_detail::set_cpu_autocast_dtype(at::kBFloat16);
+    mixed_precision_detail::set_cpu_autocast_enabled(true);
+    at::autocast::increment_nesting();
+  }
+  ~autocast_scope_t() {
+    if (!enabled_) {
+      return;
+    }
+    if (at::autocast::decrement_nesting() == 0) {
+      at::autocast::clear_cache();
+    }
+    mixed_precision_detail::set_cpu_autocast_enabled(previous_enabled_);
+    mixed_precision_detail::set_cpu_autocast_dtype(previous_dtype_);
+  }
+  autocast_scope_t(const autocast_scope_t &) = delete;
+  autocast_scope_t &operator=(const autocast_scope_t &) = delete;
+
+private:
+  bool enabled_{false};
+  bool previous_enabled_{false};
+  at::ScalarType previous_dtype_{at::kBFloat16};
+};
+
+// Suspends CPU autocast for numerically sensitive code (covariance,
+// log-sum-exp). Pair with widen_reduced_precision on the inputs.
+class float32_scope_t {
+public:
+  float32_scope_t()
+      : previous_enabled_(mixed_precision_detail::cpu_autocast_enabled()) {
+    if (previous_enabled_) {
+      mixed_precision_detail::set_cpu_autocast_enabled(false);
+    }
+  }
+  ~float32_scope_t() {
+    if (previous_enabled_) {
+      mixed_precision_detail::set_cpu_autocast_enabled(true);
+    }
+  }
+  float32_scope_t(const float32_scope_t &) = delete;
+  float32_scope_t &operator=(const float32_scope_t &) = delete;
+
+private:
+  bool previous_enabled_{false};
+};
+
+} // namespace torch
+} // namespace tensor
+} // namespace piaabo
+} // namespace cuwacunu
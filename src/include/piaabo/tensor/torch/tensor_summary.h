@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <torch/torch.h>
+
+namespace cuwacunu {
+namespace piaabo {
+namespace tensor {
+namespace torch {
+
+// Knobs for summarize_tensor_moments. The log10|x| histogram is skipped when
+// log10_abs_bins is 0. A value lands in bin
+// floor((clamp(log10(|x| + log10_abs_offset)) - min) / (max - min) * bins).
+// The result is clamped to [0, bins - 1].
+struct tensor_moments_options_t {
+  double near_zero_epsilon{0.0};
+  std::int64_t log10_abs_bins{0};
+  double log10_abs_min{-12.0};
+  double log10_abs_max{6.0};
+  double log10_abs_offset{1e-16};
+  bool keep_log10_abs_values{false};
+};
+
+// Moments over the finite entries of one tensor. NaN and +/-Inf are only
+// counted. log10_abs_values is filled only when keep_log10_abs_values is set
+// and the histogram is enabled.
+struct tensor_moments_t {
+  std::uint64_t count{0};
+  std::uint64_t finite_count{0};
+  std::uint64_t nan_count{0};
+  std::uint64_t inf_count{0};
+
+  double sum{0.0};
+  double sum_sq{0.0};
+  double sum_abs{0.0};
+  double sum_abs_log_abs{0.0};
+
+  std::uint64_t non_zero_abs_count{0};
+  std::uint64_t near_zero_count{0};
+  std::uint64_t exact_zero_count{0};
+
+  double min{std::numeric_limits<double>::infinity()};
+  double max{-std::numeric_limits<double>::infinity()};
+  double max_abs{0.0};
+
+  std::vector<std::uint64_t> log10_abs_histogram{};
+  std::vector<double> log10_abs_values{};
+};
+
+namespace tensor_summary_detail {
+
+inline constexpr std::int64_t kMinChunk = std::int64_t{1} << 15;
+inline constexpr std::int64_t kMaxChunks = 1024;
+
+inline void merge_moments(const tensor_moments_t &part,
+                          tensor_moments_t *out) {
+  out->finite_count += part.finite_count;
+  out->nan_count += part.nan_count;
+  out->inf_count += part.inf_count;
+  out->sum += part.sum;
+  out->sum_sq += part.sum_sq;
+  out->sum_abs += part.sum_abs;
+  out->sum_abs_log_abs += part.sum_abs_log_abs;
+  out->non_zero_abs_count += part.non_zero_abs_count;
+  out->near_zero_count += part.near_zero_count;
+  out->exact_zero_count += part.exact_zero_count;
+  out->min = std::min(out->min, part.min);
+  out->max = std::max(out->max, part.max);
+  out->max_abs = std::max(out->max_abs, part.max_abs);
+  for (std::size_t i = 0; i < part.log10_abs_histogram.size(); ++i) {
+    out->log10_abs_histogram[i] += part.log10_abs_histogram[i];
+  }
+  out->log10_abs_values.insert(out->log10_abs_values.end(),
+                               part.log10_abs_values.begin(),
+                               part.log10_abs_values.end());
+}
+
+template <class scalar_t>
+void accumulate_moments_chunk(const scalar_t *data, std::int64_t begin,
+                              std::int64_t end,
+                              const tensor_moments_options_t &options,
+                              tensor_moments_t *out) {
+  const std::int64_t bins = options.log10_abs_bins;
+  const double hmin = options.log10_abs_min;
+  const double hmax = options.log10_abs_max;
+  const bool histogram = bins > 0 && hmax > hmin;
+  const bool keep = histogram && options.keep_log10_abs_values;
+  if (histogram) {
+    out->log10_abs_histogram.assign(static_cast<std::size_t>(bins), 0);
+  }
+  if (keep) {
+    out->log10_abs_values.reserve(static_cast<std::size_t>(end - begin));
+  }
+  for (std::int64_t i = begin; i < end; ++i) {
+    const double v = static_cast<double>(data[i]);
+    if (std::isnan(v)) {
+      ++out->nan_count;
+      continue;
+    }
+    if (std::isinf(v)) {
+      ++out->inf_count;
+      continue;
+    }
+    ++out->finite_count;
+    out->sum += v;
+    out->sum_sq += v * v;
+    out->min = std::min(out->min, v);
+    out->max = std::max(out->max, v);
+    const double a = std::abs(v);
+    out->sum_abs += a;
+    out->max_abs = std::max(out->max_abs, a);
+    if (a > 0.0) {
+      ++out->non_zero_abs_count;
+      out->sum_abs_log_abs += a * std::log(a);
+    } else {
+      ++out->exact_zero_count;
+    }
+    if (a <= options.near_zero_epsilon) {
+      ++out->near_zero_count;
+    }
+    if (histogram) {
+      const double logabs =
+          std::clamp(std::log10(a + options.log10_abs_offset), hmin, hmax);
+      const auto idx = std::clamp<std::int64_t>(
+          static_cast<std::int64_t>(((logabs - hmin) / (hmax - hmin)) *
+                                    static_cast<double>(bins)),
+          0, bins - 1);
+      ++out->log10_abs_histogram[static_cast<std::size_t>(idx)];
+      if (keep) {
+        out->log10_abs_values.push_back(logabs);
+      }
+    }
+  }
+}
+
+} // namespace tensor_summary_detail
+
+// Every moment, zero count and histogram bin of `tensor` in one read of its
+// elements. The tensor is read in its own floating dtype (other dtypes are
+// converted to float64 first). Elements are split into at most 1024 chunks
+// whose size depends only on numel. Chunks run on the intra-op pool, and
+// their partial results are merged in chunk order. The result therefore does
+// not depend on the thread count.
+[[nodiscard]] inline tensor_moments_t
+summarize_tensor_moments(const ::torch::Tensor &tensor,
+                         const tensor_moments_options_t &options = {}) {
+  tensor_moments_t out{};
+  if (options.log10_abs_bins > 0 &&
+      options.log10_abs_max > options.log10_abs_min) {
+    out.log10_abs_histogram.assign(
+        static_cast<std::size_t>(options.log10_abs_bins), 0);
+  }
+  if (!tensor.defined() || tensor.numel() == 0) {
+    return out;
+  }
+  auto values = tensor.detach();
+  if (!values.device().is_cpu()) {
+    values = values.to(::torch::kCPU);
+  }
+  if (!at::isFloatingType(values.scalar_type())) {
+    values = values.to(::torch::kFloat64);
+  }
+  values = values.contiguous();
+
+  const std::int64_t n = values.numel();
+  out.count = static_cast<std::uint64_t>(n);
+  const std::int64_t chunk = std::max(
+      tensor_summary_detail::kMinChunk,
+      (n + tensor_summary_detail::kMaxChunks - 1) /
+          tensor_summary_detail::kMaxChunks);
+  const std::int64_t chunks = (n + chunk - 1) / chunk;
+  std::vector<tensor_moments_t> parts(static_cast<std::size_t>(chunks));
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kHalf, at::kBFloat16, values.scalar_type(),
+      "summarize_tensor_moments", [&] {
+        const scalar_t *data = values.data_ptr<scalar_t>();
+        at::parallel_for(0, chunks, 1, [&](std::int64_t b, std::int64_t e) {
+          for (std::int64_t c = b; c < e; ++c) {
+            tensor_summary_detail::accumulate_moments_chunk(
+                data, c * chunk, std::min(n, (c + 1) * chunk), options,
+                &parts[static_cast<std::size_t>(c)]);
+          }
+        });
+      });
+
+  if (options.keep_log10_abs_values && !out.log10_abs_histogram.empty()) {
+    out.log10_abs_values.reserve(static_cast<std::size_t>(n));
+  }
+  for (const auto &part : parts) {
+    tensor_summary_detail::merge_moments(part, &out);
+  }
+  return out;
+}
+
+// Knobs for summarize_matrix_spectrum. With exact = false, the leading
+// singular values come from a randomized range finder (Halko, Martinsson and
+// Tropp, 2011). It uses rank + oversampling Gaussian probes and
+// power_iterations rounds of subspace iteration, re-orthonormalized with QR.
+// The probes come from a CPU generator seeded with `seed`, so repeated
+// reports on the same weights agree.
+struct matrix_spectrum_options_t {
+  bool exact{false};
+  std::int64_t rank{32};
+  std::int64_t oversampling{8};
+  std::int64_t power_iterations{2};
+  std::uint64_t seed{0x5eedULL};
+};
+
+// Leading singular values of a matrix A, in descending order.
+//
+// When `exact` is false, Q spans the sketched range and
+// singular_values = svd(Q^T A). Each reported value is a lower bound of the
+// matching singular value of A. residual_frobenius is
+// ||A - Q Q^T A||_F = sqrt(||A||_F^2 - ||Q^T A||_F^2). By Weyl's inequality:
+//
+//   singular_values[0] <= sigma_1(A) <= singular_values[0] + residual_frobenius
+//
+// This is a deterministic a posteriori bound, not a probabilistic one.
+// spectral_norm_relative_error_bound() reports it relative to the estimate.
+// The tail_count singular values that were not resolved carry the residual
+// energy. effective_rank() splits that energy evenly across them. By
+// Cauchy-Schwarz this gives the largest possible tail sum, so the estimate is
+// exact when the tail is flat.
+struct matrix_spectrum_t {
+  bool exact{true};
+  std::vector<double> singular_values{};
+  double frobenius_sq{0.0};
+  double residual_frobenius{0.0};
+  std::int64_t tail_count{0};
+
+  [[nodiscard]] double spectral_norm() const {
+    return singular_values.empty() ? 0.0 : singular_values.front();
+  }
+  [[nodiscard]] double spectral_norm_upper_bound() const {
+    return spectral_norm() + residual_frobenius;
+  }
+  [[nodiscard]] double spectral_norm_relative_error_bound() const {
+    const double s = spectral_norm();
+    return s > 0.0 ? residual_frobenius / s : 0.0;
+  }
+  [[nodiscard]] double stable_rank() const {
+    const double s = spectral_norm();
+    return frobenius_sq / (s * s + 1e-18);
+  }
+  // exp of the Shannon entropy of sigma_i / sum(sigma).
+  [[nodiscard]] double effective_rank() const {
+    double head_sum = 0.0;
+    for (const double s : singular_values) {
+      head_sum += s;
+    }
+    const bool has_tail = tail_count > 0 && residual_frobenius > 0.0;
+    const double tail_value =
+        has_tail ? residual_frobenius /
+                       std::sqrt(static_cast<double>(tail_count))
+                 : 0.0;
+    const double total =
+        head_sum + (has_tail ? tail_value * static_cast<double>(tail_count)
+                             : 0.0);
+    if (!(total > 0.0)) {
+      return 0.0;
+    }
+    double entropy = 0.0;
+    for (const double s : singular_values) {
+      const double p = s / total;
+      if (p > 0.0) {
+        entropy -= p * std::log(p);
+      }
+    }
+    if (has_tail) {
+      const double p = tail_value / total;
+      if (p > 0.0) {
+        entropy -= static_cast<double>(tail_count) * p * std::log(p);
+      }
+    }
+    return std::exp(entropy);
+  }
+};
+
+// Spectrum of a 2-D tensor, read as float64 on the CPU. A randomized request
+// falls back to exact singular values when the sketch would be as wide as
+// min(rows, cols), since that sketch costs no less than the exact
+// decomposition.
+[[nodiscard]] inline matrix_spectrum_t
+summarize_matrix_spectrum(const ::torch::Tensor &matrix,
+                          const matrix_spectrum_options_t &options = {}) {
+  TORCH_CHECK(matrix.defined() && matrix.dim() == 2,
+              "[piaabo_tensor] summarize_matrix_spectrum expects a 2-D "
+              "tensor");
+  const auto a = matrix.detach()
+                     .to(::torch::kCPU)
+                     .to(::torch::kFloat64)
+                     .contiguous();
+  matrix_spectrum_t out{};
+  const std::int64_t rows = a.size(0);
+  const std::int64_t cols = a.size(1);
+  const std::int64_t min_dim = std::min(rows, cols);
+  if (min_dim == 0) {
+    return out;
+  }
+  out.frobenius_sq = a.square().sum().item<double>();
+
+  const std::int64_t sketch =
+      std::min(min_dim, std::max<std::int64_t>(1, options.rank) +
+                            std::max<std::int64_t>(0, options.oversampling));
+  ::torch::Tensor singular;
+  if (options.exact || sketch >= min_dim) {
+    singular = at::linalg_svdvals(a);
+  } else {
+    auto generator = at::detail::createCPUGenerator(options.seed);
+    auto probes = at::randn({cols, sketch}, generator, a.options());
+    auto q = std::get<0>(at::linalg_qr(a.mm(probes)));
+    for (std::int64_t i = 0; i < options.power_iterations; ++i) {
+      auto z = std::get<0>(at::linalg_qr(a.t().mm(q)));
+      q = std::get<0>(at::linalg_qr(a.mm(z)));
+    }
+    singular = at::linalg_svdvals(q.t().mm(a));
+    out.exact = false;
+  }
+  singular = singular.contiguous();
+  const double *data = singular.data_ptr<double>();
+  out.singular_values.assign(data, data + singular.numel());
+
+  if (!out.exact) {
+    double captured_sq = 0.0;
+    for (const double s : out.singular_values) {
+      captured_sq += s * s;
+    }
+    out.residual_frobenius =
+        std::sqrt(std::max(0.0, out.frobenius_sq - captured_sq));
+    out.tail_count =
+        min_dim - static_cast<std::int64_t>(out.singular_values.size());
+  }
+  return out;
+}
+
+} // namespace torch
+} // namespace tensor
+} // namespace piaabo
+} // namespace cuwacunu
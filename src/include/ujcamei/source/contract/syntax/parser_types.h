@@ -18,6 +18,8 @@ namespace parser_core = ::cuwacunu::piaabo::parse::bnf;
 using parser_core::ASTNode;
 using parser_core::ASTNodePtr;
 using parser_core::ASTVisitor;
+using parser_core::CachedGrammarFile;
+using parser_core::compileGrammarText;
 using parser_core::GrammarLexer;
 using parser_core::GrammarParser;
 using parser_core::InstructionLexer;
@@ -26,6 +28,7 @@ using parser_core::IntermediaryNode;
 using parser_core::printAST;
 using parser_core::ProductionGrammar;
 using parser_core::ProductionUnit;
+using parser_core::readGrammarFileCached;
 using parser_core::RootNode;
 using parser_core::TerminalNode;
 using parser_core::VisitorContext;
@@ -150,6 +150,8 @@ struct GNU_PACKED trade_t {
   static trade_t from_binary(const char *data);
   static trade_t from_csv(const std::string &line, char delimiter = ',',
                           size_t line_number = 0);
+  static trade_t from_csv_view(std::string_view line, char delimiter = ',',
+                               size_t line_number = 0);
   static statistics_pack_t<trade_t>
   initialize_statistics_pack(unsigned int window_size = 100);
   std::vector<double> tensor_features() const;
@@ -178,6 +180,8 @@ struct GNU_PACKED kline_t {
   static kline_t null_instance(key_type_t key_value = INT64_MIN);
   static kline_t from_csv(const std::string &line, char delimiter = ',',
                           size_t line_number = 0);
+  static kline_t from_csv_view(std::string_view line, char delimiter = ',',
+                               size_t line_number = 0);
   static statistics_pack_t<kline_t>
   initialize_statistics_pack(unsigned int window_size = 100);
   std::vector<double> tensor_features() const;
@@ -209,6 +213,8 @@ struct GNU_PACKED basic_t {
   null_instance(key_type_t key_value = std::numeric_limits<double>::min());
   static basic_t from_csv(const std::string &line, char delimiter = ',',
                           size_t line_number = 0);
+  static basic_t from_csv_view(std::string_view line, char delimiter = ',',
+                               size_t line_number = 0);
   static statistics_pack_t<basic_t>
   initialize_statistics_pack(unsigned int window_size = 100);
   std::vector<double> tensor_features() const;
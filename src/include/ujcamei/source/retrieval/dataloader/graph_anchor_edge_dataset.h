@@ -23,6 +23,7 @@
 #include <ATen/Context.h>
 
 #include "kikijyeba/topology/graph/graph.h"
+#include "piaabo/bench/trace_span.h"
 #include "ujcamei/source/contract/contract.h"
 #include "ujcamei/source/contract/validation/nodelift_compatibility.h"
 #include "ujcamei/source/registry/instrument_signature.h"
@@ -195,6 +196,7 @@ public:
         source_plan.validation_source_spec.has_value()
             ? &source_plan.validation_source_spec.value()
             : nullptr;
+    PIAABO_TRACE_SPAN("ujcamei", "graph_anchor_edge_dataset.materialize");
     run_validation_(&source_plan.edge_instruments, validation_source_spec);
     validate_options_();
     for (const auto &edge_id : graph_.edge_ids) {
@@ -257,6 +259,20 @@ public:
     return cursor_report_;
   }
 
+  // Binary cache files the edges are read from, in graph edge order.
+  [[nodiscard]] std::vector<std::string> source_cache_files() const {
+    std::vector<std::string> out;
+    for (const auto &edge_id : graph_.edge_ids) {
+      const auto found = edge_datasets_.find(edge_id);
+      if (found == edge_datasets_.end()) {
+        continue;
+      }
+      const auto &files = found->second.file_names();
+      out.insert(out.end(), files.begin(), files.end());
+    }
+    return out;
+  }
+
   [[nodiscard]] graph_anchor_edge_batch_options_t
   graph_anchor_edge_batch_options() const {
     graph_anchor_edge_batch_options_t out{};
@@ -342,6 +358,7 @@ public:
     TORCH_CHECK(requested_batch_size > 0,
                 "[graph_anchor_edge_dataset_t] requested_batch_size must be "
                 "positive");
+    PIAABO_TRACE_SPAN("ujcamei", "graph_anchor_edge_dataset.get_graph_batch");
     validate_anchor_indices_(anchor_indices);
 
     auto samples = collect_samples_for_anchor_indices_(anchor_indices);
@@ -358,6 +375,7 @@ public:
     TORCH_CHECK(requested_batch_size > 0,
                 "[graph_anchor_edge_dataset_t] requested_batch_size must be "
                 "positive");
+    PIAABO_TRACE_SPAN("ujcamei", "graph_anchor_edge_dataset.collate");
     validate_anchor_indices_(anchor_indices);
 
     auto options = collator_options.value_or(graph_anchor_edge_batch_options());
@@ -609,6 +627,8 @@ private:
       futures.push_back(std::async(
           std::launch::async,
           [&, edge_begin, edge_end]() -> std::vector<std::string> {
+            PIAABO_TRACE_SPAN("ujcamei",
+                              "graph_anchor_edge_dataset.fetch_edges");
             std::vector<std::string> errors;
             for (std::size_t e = edge_begin; e < edge_end; ++e) {
               const auto &edge_id = edge_refs[e].first;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <filesystem>
 #include <mutex>
 #include <string>
 
@@ -18,16 +19,18 @@ class retrieval_channel_decoder_t : public ASTVisitor {
 private:
   std::mutex current_mutex;
 
+  explicit retrieval_channel_decoder_t(CachedGrammarFile grammar_file);
+
 public:
   std::string SOURCE_CHANNELS_GRAMMAR_TEXT{};
 
-  GrammarLexer grammarLexer;
-  GrammarParser grammarParser;
   ProductionGrammar grammar;
   InstructionLexer iLexer;
   InstructionParser iParser;
 
   explicit retrieval_channel_decoder_t(std::string grammar_text);
+  /* reads the grammar file through the on-disk compiled grammar cache */
+  explicit retrieval_channel_decoder_t(const std::filesystem::path &grammar_path);
 
   source_spec_t decode(std::string instruction);
 
@@ -21,6 +21,7 @@
 #endif
 
 #include "piaabo/core/utils.h"
+#include "piaabo/io/csv_ingest.h"
 #include "ujcamei/source/registry/types/data.h"
 #include "ujcamei/source/registry/types/enums.h"
 #include "ujcamei/source/registry/types/utils.h"
@@ -117,21 +118,19 @@ inline std::string line_reason(std::size_t line_number,
 }
 
 inline std::size_t count_lines_or_throw(const std::string &csv_filename) {
-  std::ifstream file(csv_filename);
-  if (!file.is_open()) {
-    throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
-                    "could not open CSV");
-  }
-  std::size_t line_count = 0;
-  std::string line;
-  while (std::getline(file, line)) {
-    ++line_count;
+  {
+    std::ifstream file(csv_filename);
+    if (!file.is_open()) {
+      throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
+                      "could not open CSV");
+    }
   }
-  if (!file.eof()) {
+  try {
+    return cuwacunu::piaabo::io::count_csv_lines(csv_filename);
+  } catch (const std::exception &e) {
     throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
-                    "failed while reading CSV");
+                    std::string("failed while reading CSV: ") + e.what());
   }
-  return line_count;
 }
 
 inline std::int64_t rounded_steps_or_throw(long double steps_ld,
@@ -372,10 +371,12 @@ long double infer_regular_delta_from_csv(const std::string &csv_filename,
                                          char delimiter,
                                          const csv_step_policy_t &policy) {
   using RecoveryT = csv_lattice_recovery<T>;
-  std::ifstream csv_file(csv_filename);
-  if (!csv_file.is_open()) {
-    throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
-                    "could not open CSV for step inference");
+  {
+    std::ifstream csv_file(csv_filename);
+    if (!csv_file.is_open()) {
+      throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
+                      "could not open CSV for step inference");
+    }
   }
 
   std::vector<long double> positive_deltas;
@@ -383,50 +384,53 @@ long double infer_regular_delta_from_csv(const std::string &csv_filename,
 
   bool have_anchor = false;
   T anchor{};
-  std::size_t line_number = 0;
-  std::string line;
-  while (std::getline(csv_file, line)) {
-    ++line_number;
-    T curr = T::from_csv(line, delimiter, line_number);
-    if (!curr.is_valid())
-      continue;
-
-    if (!have_anchor) {
-      anchor = curr;
-      have_anchor = true;
-      continue;
-    }
+  // Inference usually stops after a few records, so scan on one thread in
+  // small chunks instead of parsing ahead across the whole file.
+  cuwacunu::piaabo::io::for_each_csv_record<T>(
+      csv_filename, delimiter,
+      [&](const T &record, std::size_t line_number) {
+        T curr = record;
+        if (!curr.is_valid())
+          return true;
+
+        if (!have_anchor) {
+          anchor = curr;
+          have_anchor = true;
+          return true;
+        }
 
-    const long double kv0 = static_cast<long double>(anchor.key_value());
-    const long double kv1 = static_cast<long double>(curr.key_value());
-    const long double raw_delta = kv1 - kv0;
-    long double delta = raw_delta;
-    if (const auto recovered_delta =
-            RecoveryT::bootstrap_delta(anchor, curr, raw_delta, policy);
-        recovered_delta.has_value()) {
-      delta = *recovered_delta;
-      if (!is_near_with_tolerance(delta, raw_delta, policy.abs_tol,
-                                  policy.rel_tol)) {
-        RecoveryT::log_bootstrap_delta_override(anchor, curr, raw_delta, delta,
-                                                line_number, csv_filename);
-      }
-    }
+        const long double kv0 = static_cast<long double>(anchor.key_value());
+        const long double kv1 = static_cast<long double>(curr.key_value());
+        const long double raw_delta = kv1 - kv0;
+        long double delta = raw_delta;
+        if (const auto recovered_delta =
+                RecoveryT::bootstrap_delta(anchor, curr, raw_delta, policy);
+            recovered_delta.has_value()) {
+          delta = *recovered_delta;
+          if (!is_near_with_tolerance(delta, raw_delta, policy.abs_tol,
+                                      policy.rel_tol)) {
+            RecoveryT::log_bootstrap_delta_override(
+                anchor, curr, raw_delta, delta, line_number, csv_filename);
+          }
+        }
 
-    if (delta < 0.0L) {
-      throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
-                      line_reason(line_number,
-                                  "key_value must be non-decreasing during "
-                                  "step inference"));
-    }
+        if (delta < 0.0L) {
+          throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
+                          line_reason(line_number,
+                                      "key_value must be non-decreasing "
+                                      "during step inference"));
+        }
 
-    if (!is_near_with_tolerance(delta, 0.0L, policy.abs_tol, policy.rel_tol)) {
-      positive_deltas.push_back(delta);
-      if (positive_deltas.size() >= policy.bootstrap_deltas)
-        break;
-    }
-    anchor = curr;
-  }
-  csv_file.close();
+        if (!is_near_with_tolerance(delta, 0.0L, policy.abs_tol,
+                                    policy.rel_tol)) {
+          positive_deltas.push_back(delta);
+          if (positive_deltas.size() >= policy.bootstrap_deltas)
+            return false;
+        }
+        anchor = curr;
+        return true;
+      },
+      {.worker_count = 1, .chunk_bytes = std::size_t{64} << 10U});
 
   if (!have_anchor) {
     throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
@@ -856,16 +860,9 @@ std::string sanitize_csv_into_binary_file(
             regular_delta, csv_step_policy.bootstrap_deltas,
             csv_step_policy.abs_tol, csv_step_policy.rel_tol);
 
-    std::ifstream csv_file(csv_filename);
-    if (!csv_file.is_open()) {
-      detail::throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
-                              "could not open CSV");
-    }
-
     std::ofstream bin_file(raw_bin,
                            std::ios::binary | std::ios::out | std::ios::trunc);
     if (!bin_file.is_open()) {
-      csv_file.close();
       detail::throw_file_error("sanitize_csv_into_binary_file", raw_bin,
                                "could not open BIN for write");
     }
@@ -893,20 +890,18 @@ std::string sanitize_csv_into_binary_file(
                       "Preparing Binary data file");
 
     std::size_t processed_lines = 0;
-    std::size_t line_number = 0;
     bool have_anchor = false;
     RawT obj_p0{};
     std::size_t obj_p0_line_number = 0;
     long double obj_p0_resolved_key = 0.0L;
     bool obj_p0_rewrite_key = false;
 
-    std::string line_p1;
-    while (std::getline(csv_file, line_p1)) {
+    const auto consume_record = [&](const RawT &record,
+                                    std::size_t line_number) -> bool {
       ++processed_lines;
-      ++line_number;
 
       if (detail::should_tick_progress(processed_lines) ||
-          csv_file.peek() == EOF) {
+          line_number == total_records_hint) {
         double pct = (static_cast<double>(processed_lines) /
                       static_cast<double>(
                           std::max<std::size_t>(1, total_records_hint))) *
@@ -915,9 +910,9 @@ std::string sanitize_csv_into_binary_file(
         UPDATE_LOADING_BAR(csv_file_preparation_progress_bar_, pct);
       }
 
-      RawT obj_p1 = RawT::from_csv(line_p1, delimiter, line_number);
+      RawT obj_p1 = record;
       if (!obj_p1.is_valid())
-        continue;
+        return true;
 
       if (!have_anchor) {
         obj_p0 = obj_p1;
@@ -925,7 +920,7 @@ std::string sanitize_csv_into_binary_file(
         obj_p0_resolved_key = static_cast<long double>(obj_p0.key_value());
         obj_p0_rewrite_key = false;
         have_anchor = true;
-        continue;
+        return true;
       }
 
       const long double kv0_raw = static_cast<long double>(obj_p0.key_value());
@@ -950,7 +945,7 @@ std::string sanitize_csv_into_binary_file(
         obj_p0_line_number = line_number;
         obj_p0_resolved_key = kv1_raw;
         obj_p0_rewrite_key = false;
-        continue;
+        return true;
       }
 
       if (current_delta < 0.0L) {
@@ -1078,7 +1073,13 @@ std::string sanitize_csv_into_binary_file(
       obj_p0_line_number = line_number;
       obj_p0_resolved_key = kv1;
       obj_p0_rewrite_key = rewrite_p1_key;
-    }
+      return true;
+    };
+    // Records are parsed ahead in parallel chunks and replayed here in file
+    // order, so the lattice sees exactly the sequence a line-by-line read
+    // would produce.
+    cuwacunu::piaabo::io::for_each_csv_record<RawT>(csv_filename, delimiter,
+                                                    consume_record);
 
     if (!have_anchor) {
       detail::throw_csv_error("sanitize_csv_into_binary_file", csv_filename,
@@ -1091,7 +1092,6 @@ std::string sanitize_csv_into_binary_file(
     flush_buffer();
 
     FINISH_LOADING_BAR(csv_file_preparation_progress_bar_);
-    csv_file.close();
     bin_file.close();
 
     log_dbg("(sanitize_csv_into_binary_file) Raw cache lattice ready: %s%s%s\n",
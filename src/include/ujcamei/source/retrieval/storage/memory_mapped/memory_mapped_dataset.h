@@ -1001,6 +1001,9 @@ public:
 
   torch::optional<std::size_t> size() const override { return num_records_; }
 
+  /* Binary cache files backing this edge (normalized when a policy is set). */
+  const std::vector<std::string> &file_names() const { return file_names_; }
+
   /* Common samplers */
   torch::data::samplers::SequentialSampler SequentialSampler() const {
     return torch::data::samplers::SequentialSampler(num_records_);
@@ -4,6 +4,8 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <iomanip>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
@@ -265,6 +267,39 @@ nodelift_options_from_spec(const nodelift_srl_spec_t &spec) {
   return out;
 }
 
+// Every spec field that changes what the lift emits, one key per line. Used
+// to key caches of lifted or encoded batches.
+[[nodiscard]] inline std::string
+nodelift_srl_spec_canonical_text(const nodelift_srl_spec_t &spec) {
+  const auto join = [](const std::vector<int64_t> &values) {
+    std::string out;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      out += (i == 0 ? "" : ",") + std::to_string(values[i]);
+    }
+    return out;
+  };
+  std::ostringstream out;
+  out << std::setprecision(17);
+  out << "version_token=" << spec.version_token << "\n";
+  out << "component_assembly_id=" << spec.component_assembly_id << "\n";
+  out << "feature_width=" << spec.feature_width << "\n";
+  out << "price_coords=" << join(spec.price_coords) << "\n";
+  out << "activity_coords=" << join(spec.activity_coords) << "\n";
+  out << "gauge_policy=" << static_cast<int>(spec.gauge_policy) << "\n";
+  out << "precision_policy=" << static_cast<int>(spec.precision_policy)
+      << "\n";
+  out << "activity_mode=" << static_cast<int>(spec.activity_mode) << "\n";
+  out << "future_lift_policy=" << static_cast<int>(spec.future_lift_policy)
+      << "\n";
+  out << "return_activity_total=" << spec.return_activity_total << "\n";
+  out << "return_activity_support=" << spec.return_activity_support << "\n";
+  out << "return_activity_coverage=" << spec.return_activity_coverage << "\n";
+  out << "return_coarse_masks=" << spec.return_coarse_masks << "\n";
+  out << "eps=" << spec.eps << "\n";
+  out << "activity_max_exp_arg=" << spec.activity_max_exp_arg << "\n";
+  return out.str();
+}
+
 [[nodiscard]] inline bool lift_future_enabled(const nodelift_srl_spec_t &spec) {
   validate_nodelift_srl_spec(spec);
   return spec.future_lift_policy == future_lift_policy_t::target_side;
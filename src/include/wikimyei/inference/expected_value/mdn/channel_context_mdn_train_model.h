@@ -12,6 +12,7 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/inference/expected_value/mdn/channel_context_mdn.h"
 #include "wikimyei/inference/expected_value/mdn/mixture_density_network_utils.h"
 
@@ -37,6 +38,9 @@ struct channel_context_mdn_train_options_t {
   double direct_edge_return_readout_warmup_nll_weight{1.0};
   double direct_edge_return_readout_post_warmup_nll_weight{1.0};
   bool direct_edge_return_readout_warmup_direct_head_only{false};
+  // Forward-pass precision; losses and the optimizer step stay float32.
+  cuwacunu::piaabo::tensor::torch::precision_policy_t precision_policy{
+      cuwacunu::piaabo::tensor::torch::precision_policy_t::float32};
 };
 
 struct channel_context_mdn_train_step_result_t {
@@ -148,21 +152,19 @@ struct channel_context_mdn_train_step_result_t {
       std::numeric_limits<double>::quiet_NaN()};
   double direct_edge_return_readout_realized_max{
       std::numeric_limits<double>::quiet_NaN()};
-  double direct_edge_return_readout_head_grad_norm{
-      std::numeric_limits<double>::quiet_NaN()};
-  double direct_edge_return_readout_head_parameter_norm_before_step{
-      std::numeric_limits<double>::quiet_NaN()};
-  double direct_edge_return_readout_head_parameter_norm_after_step{
-      std::numeric_limits<double>::quiet_NaN()};
-  double direct_edge_return_readout_head_parameter_update_norm{
-      std::numeric_limits<double>::quiet_NaN()};
+  // Float64 device scalars, undefined when not computed for this step; the
+  // caller decides when to bring them to the host.
+  torch::Tensor direct_edge_return_readout_head_grad_norm{};
+  torch::Tensor direct_edge_return_readout_head_parameter_norm_before_step{};
+  torch::Tensor direct_edge_return_readout_head_parameter_norm_after_step{};
+  torch::Tensor direct_edge_return_readout_head_parameter_update_norm{};
   double direct_edge_return_readout_scheduled_nll_weight{1.0};
   bool direct_edge_return_readout_warmup_active{false};
   bool direct_edge_return_readout_direct_head_only_warmup_active{false};
   bool skipped{false};
   bool optimizer_step_applied{false};
   bool gradients_finite{true};
-  double grad_norm{std::numeric_limits<double>::quiet_NaN()};
+  torch::Tensor grad_norm{};
 };
 
 namespace channel_context_mdn_train_detail {
@@ -1135,82 +1137,82 @@ clone_direct_edge_head_parameters(const ModelT &model) {
   return out;
 }
 
+// Float64 L2 norm over the defined tensors, left as a scalar on the device of
+// the first one; undefined when none is defined. The train step reports its
+// norms this way so the launcher can read them at its report interval instead
+// of paying a host sync per parameter on every step.
+[[nodiscard]] inline torch::Tensor
+l2_norm_tensor(const std::vector<torch::Tensor> &values) {
+  torch::Tensor total_sq{};
+  for (const auto &value : values) {
+    if (!value.defined()) {
+      continue;
+    }
+    auto sq = value.detach().to(torch::kFloat64).pow(2).sum();
+    total_sq = total_sq.defined() ? total_sq + sq.to(total_sq.device())
+                                  : std::move(sq);
+  }
+  return total_sq.defined() ? total_sq.sqrt() : torch::Tensor{};
+}
+
+[[nodiscard]] inline torch::Tensor
+gradient_norm_tensor(const std::vector<torch::Tensor> &params) {
+  std::vector<torch::Tensor> grads;
+  grads.reserve(params.size());
+  for (const auto &param : params) {
+    grads.push_back(param.grad());
+  }
+  return l2_norm_tensor(grads);
+}
+
 template <typename ModelT>
-[[nodiscard]] inline double
+[[nodiscard]] inline torch::Tensor
 direct_edge_head_parameter_norm(const ModelT &model) {
-  double total_sq = 0.0;
-  bool saw_param = false;
+  std::vector<torch::Tensor> values;
   for (const auto &param : model->named_parameters(/*recurse=*/true)) {
-    if (param.key().find("direct_edge_head") == std::string::npos) {
-      continue;
+    if (param.key().find("direct_edge_head") != std::string::npos) {
+      values.push_back(param.value());
     }
-    saw_param = true;
-    total_sq += param.value()
-                    .detach()
-                    .to(torch::kCPU)
-                    .to(torch::kFloat64)
-                    .pow(2)
-                    .sum()
-                    .template item<double>();
   }
-  return saw_param ? std::sqrt(total_sq)
-                   : std::numeric_limits<double>::quiet_NaN();
+  return l2_norm_tensor(values);
 }
 
 template <typename ModelT>
-[[nodiscard]] inline double
+[[nodiscard]] inline torch::Tensor
 direct_edge_head_gradient_norm(const ModelT &model) {
-  double total_sq = 0.0;
-  bool saw_grad = false;
+  std::vector<torch::Tensor> grads;
   for (const auto &param : model->named_parameters(/*recurse=*/true)) {
-    if (param.key().find("direct_edge_head") == std::string::npos) {
-      continue;
-    }
-    const auto grad = param.value().grad();
-    if (!grad.defined()) {
-      continue;
+    if (param.key().find("direct_edge_head") != std::string::npos) {
+      grads.push_back(param.value().grad());
     }
-    saw_grad = true;
-    total_sq += grad.detach()
-                    .to(torch::kCPU)
-                    .to(torch::kFloat64)
-                    .pow(2)
-                    .sum()
-                    .template item<double>();
   }
-  return saw_grad ? std::sqrt(total_sq)
-                  : std::numeric_limits<double>::quiet_NaN();
+  return l2_norm_tensor(grads);
 }
 
 template <typename ModelT>
-[[nodiscard]] inline double
+[[nodiscard]] inline torch::Tensor
 direct_edge_head_update_norm(const ModelT &model,
                              const std::vector<torch::Tensor> &before) {
-  double total_sq = 0.0;
+  std::vector<torch::Tensor> deltas;
   std::size_t idx = 0;
   for (const auto &param : model->named_parameters(/*recurse=*/true)) {
     if (param.key().find("direct_edge_head") == std::string::npos) {
       continue;
     }
     if (idx >= before.size()) {
-      return std::numeric_limits<double>::quiet_NaN();
+      return torch::Tensor{};
     }
-    total_sq += (param.value()
-                     .detach()
-                     .to(before[idx].device())
-                     .to(before[idx].dtype()) -
-                 before[idx])
-                    .to(torch::kCPU)
-                    .to(torch::kFloat64)
-                    .pow(2)
-                    .sum()
-                    .template item<double>();
+    deltas.push_back(param.value()
+                         .detach()
+                         .to(before[idx].device())
+                         .to(before[idx].dtype()) -
+                     before[idx]);
     ++idx;
   }
   if (idx == 0 || idx != before.size()) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
-  return std::sqrt(total_sq);
+  return l2_norm_tensor(deltas);
 }
 
 inline void clip_gradients(std::vector<torch::Tensor> &params, double clip_norm,
@@ -1227,6 +1229,25 @@ inline void clip_gradients(std::vector<torch::Tensor> &params, double clip_norm,
   }
 }
 
+// Same clipping rule with the norm kept on device: the scale is selected by
+// torch::where so no host read decides whether to clip.
+inline void clip_gradients(std::vector<torch::Tensor> &params, double clip_norm,
+                           const torch::Tensor &current_norm) {
+  if (clip_norm <= 0.0 || !current_norm.defined()) {
+    return;
+  }
+  const auto clip = torch::full_like(current_norm, clip_norm);
+  const auto scale =
+      torch::where(torch::isfinite(current_norm) & current_norm.gt(clip),
+                   clip / (current_norm + 1e-12), torch::ones_like(clip));
+  for (auto &param : params) {
+    if (param.grad().defined()) {
+      param.grad().mul_(
+          scale.to(param.grad().device()).to(param.grad().scalar_type()));
+    }
+  }
+}
+
 [[nodiscard]] inline bool direct_edge_return_readout_warmup_active(
     const channel_context_mdn_train_options_t &options,
     const int64_t optimizer_step_index) {
@@ -1292,6 +1313,20 @@ inline void zero_non_direct_edge_head_gradients(const ModelT &model) {
   }
 }
 
+// The MDN head already widens log_pi/mu/sigma; the direct edge readout is
+// widened here so every auxiliary loss sees float32.
+[[nodiscard]] inline cuwacunu::wikimyei::inference::expected_value::mdn::MdnOut
+widen_train_output(
+    cuwacunu::wikimyei::inference::expected_value::mdn::MdnOut out) {
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  out.log_pi = precision::widen_reduced_precision(out.log_pi);
+  out.mu = precision::widen_reduced_precision(out.mu);
+  out.sigma = precision::widen_reduced_precision(out.sigma);
+  out.direct_edge_return =
+      precision::widen_reduced_precision(out.direct_edge_return);
+  return out;
+}
+
 inline int64_t nonfinite_count(
     const cuwacunu::wikimyei::inference::expected_value::mdn::MdnOut &out) {
   int64_t count =
@@ -1424,8 +1459,11 @@ public:
     out.direct_edge_return_readout_head_parameter_norm_before_step =
         channel_context_mdn_train_detail::direct_edge_head_parameter_norm(
             model_);
-    auto mdn_out =
-        model_->forward(clean_input.context, clean_input.context_mask);
+    auto mdn_out = channel_context_mdn_train_detail::widen_train_output([&] {
+      cuwacunu::piaabo::tensor::torch::autocast_scope_t autocast(
+          options_.precision_policy);
+      return model_->forward(clean_input.context, clean_input.context_mask);
+    }());
     out.nonfinite_output_count =
         channel_context_mdn_train_detail::nonfinite_count(mdn_out);
     auto nll_map =
@@ -1495,7 +1533,8 @@ public:
       channel_context_mdn_train_detail::zero_non_direct_edge_head_gradients(
           model_);
     }
-    out.grad_norm = channel_context_mdn_train_detail::gradient_norm(params_);
+    out.grad_norm =
+        channel_context_mdn_train_detail::gradient_norm_tensor(params_);
     channel_context_mdn_train_detail::clip_gradients(
         params_, options_.grad_clip_norm, out.grad_norm);
     out.direct_edge_return_readout_head_grad_norm =
@@ -1607,9 +1646,13 @@ public:
     out.direct_edge_return_readout_head_parameter_norm_before_step =
         channel_context_mdn_train_detail::direct_edge_head_parameter_norm(
             model_);
-    auto mdn_out = model_->forward(
-        clean_input.channel.context, clean_input.channel.context_mask,
-        clean_input.global_context, clean_input.global_mask);
+    auto mdn_out = channel_context_mdn_train_detail::widen_train_output([&] {
+      cuwacunu::piaabo::tensor::torch::autocast_scope_t autocast(
+          options_.precision_policy);
+      return model_->forward(
+          clean_input.channel.context, clean_input.channel.context_mask,
+          clean_input.global_context, clean_input.global_mask);
+    }());
     out.nonfinite_output_count =
         channel_context_mdn_train_detail::nonfinite_count(mdn_out);
     auto nll_map =
@@ -1680,7 +1723,8 @@ public:
       channel_context_mdn_train_detail::zero_non_direct_edge_head_gradients(
           model_);
     }
-    out.grad_norm = channel_context_mdn_train_detail::gradient_norm(params_);
+    out.grad_norm =
+        channel_context_mdn_train_detail::gradient_norm_tensor(params_);
     channel_context_mdn_train_detail::clip_gradients(
         params_, options_.grad_clip_norm, out.grad_norm);
     out.direct_edge_return_readout_head_grad_norm =
@@ -7,6 +7,7 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/inference/expected_value/mdn/mixture_density_network_types.h"
 #include "wikimyei/inference/expected_value/mdn/mixture_density_network_utils.h"
 
@@ -174,7 +175,11 @@ struct FeatureConditionedMdnHeadImpl : torch::nn::Module {
                  .contiguous()
                  .view({B * N * C * Df, H + Ef});
     auto z = torch::silu(hidden->forward(input_norm->forward(x)));
-    auto raw = projection->forward(z).view({B, N, C, Df, 3, K});
+    // Under bf16 autocast the projection is bf16; the mixture normalization
+    // and sigma transform run on its float32 widening.
+    auto raw = cuwacunu::piaabo::tensor::torch::widen_reduced_precision(
+                   projection->forward(z))
+                   .view({B, N, C, Df, 3, K});
     auto raw_pi = raw.select(/*dim=*/4, /*index=*/0);
     auto raw_mu = raw.select(/*dim=*/4, /*index=*/1);
     auto raw_sigma = raw.select(/*dim=*/4, /*index=*/2);
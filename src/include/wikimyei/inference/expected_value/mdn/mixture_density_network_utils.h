@@ -8,6 +8,7 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/inference/expected_value/mdn/mixture_density_network_types.h"
 
 namespace cuwacunu {
@@ -132,9 +133,15 @@ inline torch::Tensor mdn_nll_map(const MdnOut &out,
                   out.log_pi.size(2) == C && out.log_pi.size(3) == Df,
               "[mdn_nll_map] shape mismatch");
 
+  // The log-sum-exp is always float32 or wider, including under autocast.
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  precision::float32_scope_t float32_nll;
+  const auto log_pi = precision::widen_reduced_precision(out.log_pi);
+  const auto mu = precision::widen_reduced_precision(out.mu);
+
   // Numerically stable σ handling
   auto eps_t = out.sigma.new_full({}, opt.eps);
-  auto sigma = out.sigma + eps_t;
+  auto sigma = precision::widen_reduced_precision(out.sigma) + eps_t;
   if (opt.sigma_min > 0.0)
     sigma = sigma.clamp_min(opt.sigma_min);
   if (opt.sigma_max > 0.0)
@@ -143,10 +150,10 @@ inline torch::Tensor mdn_nll_map(const MdnOut &out,
   // Portable constant (avoid platform M_PI)
   constexpr double LOG2PI = 1.8378770664093453; // log(2π)
 
-  auto f_b = f.unsqueeze(-1).expand_as(out.mu); // [B,N,C,Df,K]
-  auto diff = (f_b - out.mu) / sigma;
+  auto f_b = f.unsqueeze(-1).expand_as(mu); // [B,N,C,Df,K]
+  auto diff = (f_b - mu) / sigma;
   auto perd = -0.5 * diff.pow(2) - sigma.log() - 0.5 * LOG2PI; // [B,N,C,Df,K]
-  auto logp = torch::logsumexp(out.log_pi + perd, /*dim=*/-1); // [B,N,C,Df]
+  auto logp = torch::logsumexp(log_pi + perd, /*dim=*/-1);     // [B,N,C,Df]
   return -logp;                                                // [B,N,C,Df]
 }
 
@@ -84,6 +84,20 @@ struct allocation_belief_batch_builder_options_t {
   std::vector<timestamp_ms_t> timestamps_ms{};
 };
 
+// Every anchor of an MdnOut built in one pass. `collated` holds the [B,...]
+// tensors; each belief in `belief_batch` is a view of one of its rows.
+struct allocation_belief_batch_build_result_t {
+  CollatedAllocationBeliefBatch collated{};
+  AllocationBeliefBatch belief_batch{};
+  channel_consensus_t channel_consensus{};
+  nodelift_potential_surface_t potential_surface{};
+  nodelift_return_projection_batch_t return_projection{};
+  tail_risk_t tail_risk{};   // [B,A]
+  range_risk_t range_risk{};
+  flow_liquidity_t flow_liquidity{};
+  volatility_t volatility{}; // [B,A]
+};
+
 namespace detail {
 
 [[nodiscard]] inline torch::Tensor
@@ -96,16 +110,18 @@ graph_index_tensor(const std::vector<std::int64_t> &indices,
 }
 
 [[nodiscard]] inline torch::Tensor
-select_anchor_assets(const torch::Tensor &tensor, std::int64_t anchor_slot,
+select_anchor_assets(const torch::Tensor &tensor, std::int64_t anchor_begin,
+                     std::int64_t anchor_count,
                      const torch::Tensor &graph_index, const char *name) {
   TORCH_CHECK(tensor.defined(), "[allocation_belief_builder] missing ", name);
   TORCH_CHECK(tensor.dim() >= 2, "[allocation_belief_builder] ", name,
               " must have [B,N,...] shape");
-  TORCH_CHECK(anchor_slot >= 0 && anchor_slot < tensor.size(0),
-              "[allocation_belief_builder] anchor_slot out of range for ",
+  TORCH_CHECK(anchor_begin >= 0 && anchor_count > 0 &&
+                  anchor_begin + anchor_count <= tensor.size(0),
+              "[allocation_belief_builder] anchor range out of range for ",
               name);
-  return tensor.select(/*dim=*/0, anchor_slot)
-      .index_select(/*dim=*/0, graph_index);
+  return tensor.narrow(/*dim=*/0, anchor_begin, anchor_count)
+      .index_select(/*dim=*/1, graph_index);
 }
 
 [[nodiscard]] inline torch::Tensor vector_or(const torch::Tensor &tensor,
@@ -155,31 +171,39 @@ normalized_mixture_entropy(const torch::Tensor &log_weight) {
   return (entropy / std::log(static_cast<double>(Kc))).clamp(0.0, 1.0);
 }
 
-} // namespace detail
+// Repeats an [A] vector for every anchor in the range.
+[[nodiscard]] inline torch::Tensor anchor_rows(const torch::Tensor &vector,
+                                               std::int64_t anchor_count) {
+  return vector.unsqueeze(0)
+      .expand({anchor_count, vector.size(0)})
+      .contiguous();
+}
 
-[[nodiscard]] inline allocation_belief_build_result_t
-build_single_anchor_allocation_belief(
-    const mdn::MdnOut &out,
-    const allocation_belief_builder_options_t &options) {
+struct builder_context_t {
+  std::int64_t A{0};
+  GraphNodeAxisBinding graph_axis{};
+  std::int64_t projection_reference_graph_index{0};
+};
+
+[[nodiscard]] inline builder_context_t
+validate_builder_options(const mdn::MdnOut &out,
+                         const allocation_belief_builder_options_t &options) {
   const auto quality = check_mdn_output(out);
   TORCH_CHECK(quality.valid, "[allocation_belief_builder] invalid MDN output");
-  TORCH_CHECK(options.anchor_slot >= 0 &&
-                  options.anchor_slot < out.log_pi.size(0),
-              "[allocation_belief_builder] anchor_slot out of range");
   TORCH_CHECK(
       options.node_ids.size() == options.node_graph_indices.size(),
       "[allocation_belief_builder] node_ids/node_graph_indices mismatch");
   TORCH_CHECK(!options.node_ids.empty(),
               "[allocation_belief_builder] target node universe is empty");
   const auto A = static_cast<std::int64_t>(options.node_ids.size());
-  detail::require_base_policy(options.base_policy);
-  const auto graph_axis = detail::effective_graph_node_axis_binding(
+  require_base_policy(options.base_policy);
+  auto graph_axis = effective_graph_node_axis_binding(
       options.graph_node_axis, options.graph_order_fingerprint,
       options.graph_node_ids, "[allocation_belief_builder]");
   const auto projection_reference_graph_index =
       options.projection_reference_graph_index.has_value()
           ? options.projection_reference_graph_index
-          : detail::find_graph_node_index(
+          : find_graph_node_index(
                 graph_axis.node_ids,
                 options.base_policy.projection_reference_node_id);
   TORCH_CHECK(
@@ -195,9 +219,8 @@ build_single_anchor_allocation_belief(
               options.base_policy.projection_reference_node_id,
       "[allocation_belief_builder] projection_reference_graph_index does "
       "not match projection_reference_node_id");
-  TORCH_CHECK(detail::find_graph_node_index(
-                  graph_axis.node_ids,
-                  options.base_policy.accounting_numeraire_id)
+  TORCH_CHECK(find_graph_node_index(graph_axis.node_ids,
+                                    options.base_policy.accounting_numeraire_id)
                   .has_value(),
               "[allocation_belief_builder] accounting_numeraire_id must "
               "appear in graph_node_ids");
@@ -218,23 +241,41 @@ build_single_anchor_allocation_belief(
       "[allocation_belief_builder] empirical_potential_correlation must be "
       "[M,M] ordered as target nodes plus projection reference when absent "
       "from target nodes");
+  return builder_context_t{A, std::move(graph_axis),
+                           *projection_reference_graph_index};
+}
 
-  auto consensus =
-      compute_uniform_valid_channel_consensus(out, options.channel_mask);
-  auto surface = from_channel_consensus(consensus, options.surface_options);
-  auto graph_index = detail::graph_index_tensor(options.node_graph_indices,
-                                                surface.log_weight.device());
-  auto projected = project_single_anchor(
-      surface, options.anchor_slot, options.node_graph_indices,
-      *projection_reference_graph_index,
-      options.empirical_potential_correlation, options.projection_options);
-  auto scenarios = make_stress_bank(projected.arithmetic_return_scenarios,
-                                    options.scenario_bank_options);
+struct allocation_belief_rows_t {
+  CollatedAllocationBeliefBatch collated{};
+  nodelift_return_projection_batch_t projected{};
+  tail_risk_t tails{};
+  volatility_t vol{};
+};
+
+// Builds the beliefs of anchors [anchor_begin, anchor_begin + n) as [n,...]
+// tensors, with n = anchor_keys.size(). Consensus, surface, ranges and flow
+// cover the whole MdnOut batch; every utility runs once over the range.
+[[nodiscard]] inline allocation_belief_rows_t build_allocation_belief_rows(
+    const allocation_belief_builder_options_t &options,
+    const builder_context_t &context, const channel_consensus_t &consensus,
+    const nodelift_potential_surface_t &surface, const range_risk_t &ranges,
+    const flow_liquidity_t &flow, std::int64_t anchor_begin,
+    std::vector<anchor_key_t> anchor_keys,
+    std::vector<timestamp_ms_t> timestamps_ms,
+    mixture_quantile_workspace_t *workspace = nullptr) {
+  const auto A = context.A;
+  const auto n = static_cast<std::int64_t>(anchor_keys.size());
+  TORCH_CHECK(n > 0 && timestamps_ms.size() == anchor_keys.size(),
+              "[allocation_belief_builder] anchor keys and timestamps must "
+              "be non-empty and aligned");
+  auto graph_index = graph_index_tensor(options.node_graph_indices,
+                                        surface.log_weight.device());
+  auto projected = project_anchor_batch(
+      surface, anchor_begin, n, options.node_graph_indices,
+      context.projection_reference_graph_index,
+      options.empirical_potential_correlation, options.projection_options,
+      workspace);
   auto tails = compute_node_tail_risk(projected.arithmetic_return_scenarios);
-  auto ranges = compute_range_risk(consensus, options.node_graph_indices,
-                                   *projection_reference_graph_index,
-                                   options.range_options);
-  auto flow = compute_flow_liquidity(consensus, options.flow_liquidity_options);
 
   auto tensor_options =
       torch::TensorOptions()
@@ -244,19 +285,17 @@ build_single_anchor_allocation_belief(
       torch::TensorOptions()
           .dtype(torch::kBool)
           .device(projected.arithmetic_return_scenarios.device()));
-  auto tradable_mask = detail::bool_vector_or(
-      options.tradable_mask, A, projected.arithmetic_return_scenarios.device(),
-      true, "tradable_mask");
-  auto expected_log = projected.expected_log_return.to(tensor_options);
-  auto expected_arithmetic =
-      projected.expected_arithmetic_return.to(tensor_options);
+  auto tradable_mask = anchor_rows(
+      bool_vector_or(options.tradable_mask, A,
+                     projected.arithmetic_return_scenarios.device(), true,
+                     "tradable_mask"),
+      n);
   auto marginal_variance = projected.marginal_variance.to(tensor_options);
-  auto marginal_volatility = projected.marginal_volatility.to(tensor_options);
-
   auto realized_variance =
       options.realized_variance.defined()
-          ? detail::vector_or(options.realized_variance, A, tensor_options, 0.0,
-                              "realized_variance")
+          ? anchor_rows(vector_or(options.realized_variance, A, tensor_options,
+                                  0.0, "realized_variance"),
+                        n)
           : marginal_variance;
   auto vol = blend_mdn_and_realized_variance(
       marginal_variance, realized_variance, options.volatility_options);
@@ -267,132 +306,159 @@ build_single_anchor_allocation_belief(
               "[allocation_belief_builder] adverse_excursion_prob must be "
               "[B,A]");
   auto range_adverse =
-      ranges.adverse_excursion_prob.select(/*dim=*/0, options.anchor_slot)
+      ranges.adverse_excursion_prob.narrow(/*dim=*/0, anchor_begin, n)
           .to(tensor_options);
-  auto flow_liquidity_score =
-      detail::select_anchor_assets(flow.liquidity_score, options.anchor_slot,
-                                   graph_index, "liquidity_score")
+  auto liquidity_score =
+      select_anchor_assets(flow.liquidity_score, anchor_begin, n, graph_index,
+                           "liquidity_score")
           .to(tensor_options)
           .clamp(0.0, 1.0);
-  auto flow_capacity = detail::select_anchor_assets(
-                           flow.capacity_weight_limit, options.anchor_slot,
-                           graph_index, "capacity_weight_limit")
-                           .to(tensor_options)
-                           .clamp(0.0, 1.0);
-  auto liquidity_score = options.capacity_weight_limit.defined()
-                             ? flow_liquidity_score
-                             : flow_liquidity_score;
   auto capacity =
       options.capacity_weight_limit.defined()
-          ? detail::vector_or(options.capacity_weight_limit, A, tensor_options,
-                              1.0, "capacity_weight_limit")
-                .clamp(0.0, 1.0)
-          : flow_capacity;
-  auto linear_cost = detail::vector_or(options.linear_cost, A, tensor_options,
-                                       0.0, "linear_cost")
-                         .clamp_min(0.0);
+          ? anchor_rows(vector_or(options.capacity_weight_limit, A,
+                                  tensor_options, 1.0, "capacity_weight_limit")
+                            .clamp(0.0, 1.0),
+                        n)
+          : select_anchor_assets(flow.capacity_weight_limit, anchor_begin, n,
+                                 graph_index, "capacity_weight_limit")
+                .to(tensor_options)
+                .clamp(0.0, 1.0);
+  auto linear_cost = anchor_rows(vector_or(options.linear_cost, A,
+                                           tensor_options, 0.0, "linear_cost")
+                                     .clamp_min(0.0),
+                                 n);
   auto quadratic_impact =
-      detail::vector_or(options.quadratic_impact, A, tensor_options, 0.0,
-                        "quadratic_impact")
-          .clamp_min(0.0);
-
-  auto raw_entropy = detail::select_anchor_assets(
-                         detail::mixture_entropy(surface.log_weight),
-                         options.anchor_slot, graph_index, "mixture_entropy")
+      anchor_rows(vector_or(options.quadratic_impact, A, tensor_options, 0.0,
+                            "quadratic_impact")
+                      .clamp_min(0.0),
+                  n);
+
+  auto log_weight = surface.log_weight.narrow(/*dim=*/0, anchor_begin, n);
+  auto raw_entropy = mixture_entropy(log_weight)
+                         .index_select(/*dim=*/1, graph_index)
                          .to(tensor_options);
-  auto normalized_entropy =
-      detail::select_anchor_assets(
-          detail::normalized_mixture_entropy(surface.log_weight),
-          options.anchor_slot, graph_index, "normalized_mixture_entropy")
-          .to(tensor_options);
+  auto normalized_entropy = normalized_mixture_entropy(log_weight)
+                                .index_select(/*dim=*/1, graph_index)
+                                .to(tensor_options);
   auto mixture_entropy_score =
-      score_from_normalized_entropy(normalized_entropy.to(torch::kCPU))
+      score_from_normalized_entropy(
+          normalized_entropy.reshape({n * A}).to(torch::kCPU))
+          .view({n, A})
           .to(tensor_options);
   auto component_disagreement =
-      detail::select_anchor_assets(
-          detail::mixture_disagreement(surface.log_weight, surface.potential_mu,
-                                       surface.expected_potential),
-          options.anchor_slot, graph_index, "component_disagreement")
+      mixture_disagreement(
+          log_weight, surface.potential_mu.narrow(/*dim=*/0, anchor_begin, n),
+          surface.expected_potential.narrow(/*dim=*/0, anchor_begin, n))
+          .index_select(/*dim=*/1, graph_index)
           .to(tensor_options);
   auto channel_disagreement =
-      detail::select_anchor_assets(consensus.channel_disagreement.select(
-                                       2, options.surface_options.close_coord),
-                                   options.anchor_slot, graph_index,
-                                   "channel_disagreement")
+      select_anchor_assets(consensus.channel_disagreement.select(
+                               2, options.surface_options.close_coord),
+                           anchor_begin, n, graph_index,
+                           "channel_disagreement")
           .to(tensor_options);
-  auto channel_score = score_from_channel_disagreement(
-                           channel_disagreement.to(torch::kCPU),
-                           options.channel_disagreement_confidence_scale)
-                           .to(tensor_options);
-  auto data_score = detail::vector_or(options.data_quality_score, A,
-                                      tensor_options, 1.0, "data_quality_score")
-                        .clamp(0.0, 1.0);
-  auto calibration_score = neutral_calibration_score(A, tensor_options);
-  auto surprise_score = neutral_surprise_score(A, tensor_options);
+  auto channel_score =
+      score_from_channel_disagreement(
+          channel_disagreement.reshape({n * A}).to(torch::kCPU),
+          options.channel_disagreement_confidence_scale)
+          .view({n, A})
+          .to(tensor_options);
+  auto data_score = anchor_rows(vector_or(options.data_quality_score, A,
+                                          tensor_options, 1.0,
+                                          "data_quality_score")
+                                    .clamp(0.0, 1.0),
+                                n);
+  auto calibration_score =
+      anchor_rows(neutral_calibration_score(A, tensor_options), n);
+  auto surprise_score =
+      anchor_rows(neutral_surprise_score(A, tensor_options), n);
+  // compute_confidence scores [A] vectors; score all n*A entries at once.
   confidence_inputs_t confidence_inputs{};
-  confidence_inputs.data_quality_score = data_score;
-  confidence_inputs.liquidity_score = liquidity_score;
-  confidence_inputs.calibration_score = calibration_score;
-  confidence_inputs.entropy_score = mixture_entropy_score;
-  confidence_inputs.channel_score = channel_score;
-  confidence_inputs.surprise_score = surprise_score;
+  confidence_inputs.data_quality_score = data_score.view({n * A});
+  confidence_inputs.liquidity_score = liquidity_score.reshape({n * A});
+  confidence_inputs.calibration_score = calibration_score.view({n * A});
+  confidence_inputs.entropy_score = mixture_entropy_score.reshape({n * A});
+  confidence_inputs.channel_score = channel_score.reshape({n * A});
+  confidence_inputs.surprise_score = surprise_score.view({n * A});
   auto final_confidence =
-      compute_confidence(confidence_inputs, A, tensor_options)
+      compute_confidence(confidence_inputs, n * A, tensor_options)
+          .view({n, A})
           .masked_fill(valid_mask.logical_not(), 0.0)
           .masked_fill(tradable_mask.logical_not(), 0.0);
 
-  AllocationBelief state{};
-  state.anchor_key = options.anchor_key;
-  state.timestamp_ms = options.timestamp_ms;
-  state.graph_node_axis = graph_axis;
-  state.graph_order_fingerprint = graph_axis.graph_order_fingerprint;
-  state.source_feature_semantics_id = std::string(kKlineFeatureSemanticsId);
-  state.source_feature_semantics_fingerprint =
-      kline_feature_semantics_fingerprint();
-  state.graph_node_ids = graph_axis.node_ids;
-  state.node_ids = options.node_ids;
-  state.node_graph_indices = options.node_graph_indices;
-  state.base_policy = options.base_policy;
-  state.projection_reference_graph_index = projection_reference_graph_index;
-  state.horizon = 1;
-  state.marginal_unit = return_unit_t::log_return;
-  state.scenario_unit = return_unit_t::arithmetic_return;
-  state.return_origin = return_origin_t::numeraire_relative_nodelift_projection;
-  state.valid_mask = std::move(valid_mask);
-  state.tradable_mask = std::move(tradable_mask);
-  state.expected_log_return = std::move(expected_log);
-  state.expected_arithmetic_return = std::move(expected_arithmetic);
-  state.marginal_variance = std::move(marginal_variance);
-  state.marginal_volatility = std::move(marginal_volatility);
-  state.covariance = projected.covariance.to(tensor_options);
-  state.correlation = projected.correlation.to(tensor_options);
-  state.scenarios = projected.arithmetic_return_scenarios.to(tensor_options);
-  state.var_down = tails.var_down.to(tensor_options);
-  state.cvar_down = tails.cvar_down.to(tensor_options);
-  state.adverse_excursion_prob = std::move(range_adverse);
-  state.volatility = vol.volatility.to(tensor_options);
-  state.mixture_entropy = std::move(raw_entropy);
-  state.component_disagreement = std::move(component_disagreement);
-  state.channel_disagreement = std::move(channel_disagreement);
-  state.surprise = torch::zeros({A}, tensor_options);
-  state.calibration_score = calibration_score;
-  state.liquidity_score = std::move(liquidity_score);
-  state.linear_cost = std::move(linear_cost);
-  state.quadratic_impact = std::move(quadratic_impact);
-  state.capacity_weight_limit = std::move(capacity);
-  state.confidence = std::move(final_confidence);
-  state.projection_validation_required = true;
-  state.projection_validated = false;
-  state.live_capital_allowed = false;
-  state.valid = true;
-  state.diagnostics.notes.push_back("wikimyei.observer.belief.builder.v1");
-  state.diagnostics.warnings.push_back(
+  const auto flags = torch::TensorOptions().dtype(torch::kBool);
+  BeliefDiagnostics diagnostics{};
+  diagnostics.notes.push_back("wikimyei.observer.belief.builder.v1");
+  diagnostics.warnings.push_back(
       "allocation_belief.projection_validation_required_before_live_capital");
-  validate_allocation_belief_contract(state);
 
+  CollatedAllocationBeliefBatch collated{};
+  collated.anchor_keys = std::move(anchor_keys);
+  collated.timestamps_ms = std::move(timestamps_ms);
+  collated.graph_order_fingerprint = context.graph_axis.graph_order_fingerprint;
+  collated.graph_node_axis = context.graph_axis;
+  collated.source_feature_semantics_id = std::string(kKlineFeatureSemanticsId);
+  collated.source_feature_semantics_fingerprint =
+      kline_feature_semantics_fingerprint();
+  collated.graph_node_ids = context.graph_axis.node_ids;
+  collated.node_ids = options.node_ids;
+  collated.node_graph_indices = options.node_graph_indices;
+  collated.base_policy = options.base_policy;
+  collated.projection_reference_graph_index =
+      context.projection_reference_graph_index;
+  collated.horizon = 1;
+  collated.marginal_unit = return_unit_t::log_return;
+  collated.scenario_unit = return_unit_t::arithmetic_return;
+  collated.return_origin =
+      return_origin_t::numeraire_relative_nodelift_projection;
+  collated.belief_valid = torch::ones({n}, flags);
+  collated.valid_mask = std::move(valid_mask);
+  collated.tradable_mask = std::move(tradable_mask);
+  collated.expected_log_return =
+      projected.expected_log_return.to(tensor_options);
+  collated.expected_arithmetic_return =
+      projected.expected_arithmetic_return.to(tensor_options);
+  collated.marginal_variance = std::move(marginal_variance);
+  collated.marginal_volatility =
+      projected.marginal_volatility.to(tensor_options);
+  collated.covariance = projected.covariance.to(tensor_options);
+  collated.correlation = projected.correlation.to(tensor_options);
+  collated.scenarios =
+      projected.arithmetic_return_scenarios.to(tensor_options);
+  collated.var_down = tails.var_down.to(tensor_options);
+  collated.cvar_down = tails.cvar_down.to(tensor_options);
+  collated.adverse_excursion_prob = std::move(range_adverse);
+  collated.volatility = vol.volatility.to(tensor_options);
+  collated.mixture_entropy = std::move(raw_entropy);
+  collated.component_disagreement = std::move(component_disagreement);
+  collated.channel_disagreement = std::move(channel_disagreement);
+  collated.surprise = torch::zeros({n, A}, tensor_options);
+  collated.calibration_score = std::move(calibration_score);
+  collated.liquidity_score = std::move(liquidity_score);
+  collated.linear_cost = std::move(linear_cost);
+  collated.quadratic_impact = std::move(quadratic_impact);
+  collated.capacity_weight_limit = std::move(capacity);
+  collated.confidence = std::move(final_confidence);
+  collated.projection_validation_required = torch::ones({n}, flags);
+  collated.projection_validated = torch::zeros({n}, flags);
+  collated.live_capital_allowed = torch::zeros({n}, flags);
+  collated.diagnostics.assign(static_cast<std::size_t>(n), diagnostics);
+
+  allocation_belief_rows_t rows{};
+  rows.collated = std::move(collated);
+  rows.projected = std::move(projected);
+  rows.tails = std::move(tails);
+  rows.vol = std::move(vol);
+  return rows;
+}
+
+[[nodiscard]] inline NodeLiftPotentialBelief make_nodelift_potential_belief(
+    const channel_consensus_t &consensus, std::int64_t anchor_slot,
+    const anchor_key_t &anchor_key, timestamp_ms_t timestamp_ms,
+    const GraphNodeAxisBinding &graph_axis) {
   NodeLiftPotentialBelief nodelift{};
-  nodelift.anchor_key = options.anchor_key;
-  nodelift.timestamp_ms = options.timestamp_ms;
+  nodelift.anchor_key = anchor_key;
+  nodelift.timestamp_ms = timestamp_ms;
   nodelift.graph_node_axis = graph_axis;
   nodelift.graph_order_fingerprint = graph_axis.graph_order_fingerprint;
   nodelift.source_feature_semantics_id = std::string(kKlineFeatureSemanticsId);
@@ -404,33 +470,75 @@ build_single_anchor_allocation_belief(
   nodelift.price_coord_semantics =
       coordinate_semantics_t::edge_log_return_lifted_potential;
   nodelift.log_weight =
-      consensus.log_weight.select(/*dim=*/0, options.anchor_slot).detach();
-  nodelift.mu = consensus.mu.select(/*dim=*/0, options.anchor_slot).detach();
-  nodelift.sigma =
-      consensus.sigma.select(/*dim=*/0, options.anchor_slot).detach();
+      consensus.log_weight.select(/*dim=*/0, anchor_slot).detach();
+  nodelift.mu = consensus.mu.select(/*dim=*/0, anchor_slot).detach();
+  nodelift.sigma = consensus.sigma.select(/*dim=*/0, anchor_slot).detach();
   nodelift.active_mask =
-      consensus.active_mask.select(/*dim=*/0, options.anchor_slot).detach();
+      consensus.active_mask.select(/*dim=*/0, anchor_slot).detach();
   nodelift.valid = true;
   nodelift.diagnostics.notes.push_back(
       "wikimyei.observer.belief.nodelift_potential.v1");
+  return nodelift;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline allocation_belief_build_result_t
+build_single_anchor_allocation_belief(
+    const mdn::MdnOut &out,
+    const allocation_belief_builder_options_t &options) {
+  const auto context = detail::validate_builder_options(out, options);
+  TORCH_CHECK(options.anchor_slot >= 0 &&
+                  options.anchor_slot < out.log_pi.size(0),
+              "[allocation_belief_builder] anchor_slot out of range");
+
+  auto consensus =
+      compute_uniform_valid_channel_consensus(out, options.channel_mask);
+  auto surface = from_channel_consensus(consensus, options.surface_options);
+  auto ranges = compute_range_risk(consensus, options.node_graph_indices,
+                                   context.projection_reference_graph_index,
+                                   options.range_options);
+  auto flow = compute_flow_liquidity(consensus, options.flow_liquidity_options);
+  auto rows = detail::build_allocation_belief_rows(
+      options, context, consensus, surface, ranges, flow, options.anchor_slot,
+      {options.anchor_key}, {options.timestamp_ms});
+
+  auto state = select_collated_anchor(rows.collated, /*index=*/0);
+  validate_allocation_belief_contract(state);
+  auto projected = select_anchor_projection(rows.projected, /*index=*/0);
 
   allocation_belief_build_result_t result{};
   result.allocation_belief = std::move(state);
-  result.nodelift_potential_belief = std::move(nodelift);
+  result.nodelift_potential_belief = detail::make_nodelift_potential_belief(
+      consensus, options.anchor_slot, options.anchor_key, options.timestamp_ms,
+      context.graph_axis);
+  result.scenario_bank = make_stress_bank(projected.arithmetic_return_scenarios,
+                                          options.scenario_bank_options);
+  result.return_projection = std::move(projected);
   result.channel_consensus = std::move(consensus);
   result.potential_surface = std::move(surface);
-  result.return_projection = std::move(projected);
-  result.scenario_bank = std::move(scenarios);
-  result.tail_risk = std::move(tails);
+  result.tail_risk = {rows.tails.var_down.select(0, 0),
+                      rows.tails.cvar_down.select(0, 0)};
   result.range_risk = std::move(ranges);
   result.flow_liquidity = std::move(flow);
-  result.volatility = std::move(vol);
+  result.volatility = {rows.vol.mdn_variance.select(0, 0),
+                       rows.vol.realized_variance.select(0, 0),
+                       rows.vol.final_variance.select(0, 0),
+                       rows.vol.volatility.select(0, 0)};
   return result;
 }
 
-[[nodiscard]] inline AllocationBeliefBatch build_allocation_belief_batch(
+// Builds every anchor of `out` with one pass of each observer utility over
+// the batch dimension; common.anchor_slot, anchor_key and timestamp_ms are
+// ignored. Anchor b matches build_single_anchor_allocation_belief with
+// anchor_slot = b. From the generator state of B sequential single-anchor
+// builds it draws the same normals, and the quantile solver converges each
+// lane on its own, so sampled fields match exactly.
+[[nodiscard]] inline allocation_belief_batch_build_result_t
+build_allocation_belief_batch_result(
     const mdn::MdnOut &out,
-    const allocation_belief_batch_builder_options_t &options) {
+    const allocation_belief_batch_builder_options_t &options,
+    mixture_quantile_workspace_t *workspace = nullptr) {
   TORCH_CHECK(out.log_pi.defined() && out.log_pi.dim() == 5,
               "[allocation_belief_builder] MdnOut must be [B,N,C,Df,K]");
   const auto B = out.log_pi.size(0);
@@ -438,18 +546,76 @@ build_single_anchor_allocation_belief(
               "[allocation_belief_builder] anchor_keys must have B entries");
   TORCH_CHECK(static_cast<std::int64_t>(options.timestamps_ms.size()) == B,
               "[allocation_belief_builder] timestamps_ms must have B entries");
+  const auto &common = options.common;
+  const auto context = detail::validate_builder_options(out, common);
 
-  AllocationBeliefBatch batch{};
-  batch.beliefs.reserve(static_cast<std::size_t>(B));
+  auto consensus =
+      compute_uniform_valid_channel_consensus(out, common.channel_mask);
+  auto surface = from_channel_consensus(consensus, common.surface_options);
+  auto ranges = compute_range_risk(consensus, common.node_graph_indices,
+                                   context.projection_reference_graph_index,
+                                   common.range_options);
+  auto flow = compute_flow_liquidity(consensus, common.flow_liquidity_options);
+  auto rows = detail::build_allocation_belief_rows(
+      common, context, consensus, surface, ranges, flow, /*anchor_begin=*/0,
+      options.anchor_keys, options.timestamps_ms, workspace);
+
+  allocation_belief_batch_build_result_t result{};
+  result.belief_batch.beliefs.reserve(static_cast<std::size_t>(B));
   for (std::int64_t b = 0; b < B; ++b) {
-    auto single = options.common;
-    single.anchor_slot = b;
-    single.anchor_key = options.anchor_keys[static_cast<std::size_t>(b)];
-    single.timestamp_ms = options.timestamps_ms[static_cast<std::size_t>(b)];
-    batch.beliefs.push_back(
-        build_single_anchor_allocation_belief(out, single).allocation_belief);
+    result.belief_batch.beliefs.push_back(
+        select_collated_anchor(rows.collated, b));
+    validate_allocation_belief_contract(result.belief_batch.beliefs.back());
   }
-  return batch;
+  result.collated = std::move(rows.collated);
+  result.channel_consensus = std::move(consensus);
+  result.potential_surface = std::move(surface);
+  result.return_projection = std::move(rows.projected);
+  result.tail_risk = std::move(rows.tails);
+  result.range_risk = std::move(ranges);
+  result.flow_liquidity = std::move(flow);
+  result.volatility = std::move(rows.vol);
+  return result;
+}
+
+// Per-anchor view of a batch build, shaped like the single-anchor result.
+// Only the stress bank is computed here, since just the artifact path needs
+// it.
+[[nodiscard]] inline allocation_belief_build_result_t
+select_anchor_build_result(const allocation_belief_batch_build_result_t &batch,
+                           std::int64_t index,
+                           const scenario_bank_options_t &scenario_options) {
+  TORCH_CHECK(index >= 0 && index < static_cast<std::int64_t>(
+                                        batch.belief_batch.beliefs.size()),
+              "[allocation_belief_builder] anchor index out of range");
+  const auto &state =
+      batch.belief_batch.beliefs[static_cast<std::size_t>(index)];
+  allocation_belief_build_result_t result{};
+  result.allocation_belief = state;
+  result.nodelift_potential_belief = detail::make_nodelift_potential_belief(
+      batch.channel_consensus, index, state.anchor_key, state.timestamp_ms,
+      batch.collated.graph_node_axis);
+  result.channel_consensus = batch.channel_consensus;
+  result.potential_surface = batch.potential_surface;
+  result.return_projection =
+      select_anchor_projection(batch.return_projection, index);
+  result.scenario_bank = make_stress_bank(
+      result.return_projection.arithmetic_return_scenarios, scenario_options);
+  result.tail_risk = {batch.tail_risk.var_down.select(0, index),
+                      batch.tail_risk.cvar_down.select(0, index)};
+  result.range_risk = batch.range_risk;
+  result.flow_liquidity = batch.flow_liquidity;
+  result.volatility = {batch.volatility.mdn_variance.select(0, index),
+                       batch.volatility.realized_variance.select(0, index),
+                       batch.volatility.final_variance.select(0, index),
+                       batch.volatility.volatility.select(0, index)};
+  return result;
+}
+
+[[nodiscard]] inline AllocationBeliefBatch build_allocation_belief_batch(
+    const mdn::MdnOut &out,
+    const allocation_belief_batch_builder_options_t &options) {
+  return build_allocation_belief_batch_result(out, options).belief_batch;
 }
 
 } // namespace cuwacunu::wikimyei::observer::belief
@@ -749,4 +749,78 @@ collate_allocation_belief_batch(const AllocationBeliefBatch &batch,
   return out;
 }
 
+// Inverse of collate_allocation_belief_batch for one anchor. Tensor fields
+// are views into the collated batch, so splitting B anchors copies no
+// tensor data.
+[[nodiscard]] inline AllocationBelief
+select_collated_anchor(const CollatedAllocationBeliefBatch &batch,
+                       std::int64_t index) {
+  if (index < 0 ||
+      index >= static_cast<std::int64_t>(batch.anchor_keys.size()) ||
+      batch.timestamps_ms.size() != batch.anchor_keys.size() ||
+      batch.diagnostics.size() != batch.anchor_keys.size()) {
+    throw std::runtime_error(
+        "[AllocationBeliefBatch] collated anchor index out of range");
+  }
+  const auto row = [index](const torch::Tensor &tensor) {
+    return tensor.defined() ? tensor.select(/*dim=*/0, index)
+                            : torch::Tensor{};
+  };
+  const auto flag = [index](const torch::Tensor &tensor) {
+    return tensor.select(/*dim=*/0, index).item<bool>();
+  };
+  const auto i = static_cast<std::size_t>(index);
+
+  AllocationBelief state{};
+  state.anchor_key = batch.anchor_keys[i];
+  state.timestamp_ms = batch.timestamps_ms[i];
+  state.graph_node_axis = batch.graph_node_axis;
+  state.graph_order_fingerprint = batch.graph_order_fingerprint;
+  state.source_feature_semantics_id = batch.source_feature_semantics_id;
+  state.source_feature_semantics_fingerprint =
+      batch.source_feature_semantics_fingerprint;
+  state.graph_node_ids = batch.graph_node_ids;
+  state.node_ids = batch.node_ids;
+  state.node_graph_indices = batch.node_graph_indices;
+  state.base_policy = batch.base_policy;
+  state.projection_reference_graph_index =
+      batch.projection_reference_graph_index;
+  state.horizon = batch.horizon;
+  state.marginal_unit = batch.marginal_unit;
+  state.scenario_unit = batch.scenario_unit;
+  state.return_origin = batch.return_origin;
+  state.valid_mask = row(batch.valid_mask);
+  state.tradable_mask = row(batch.tradable_mask);
+  state.expected_log_return = row(batch.expected_log_return);
+  state.expected_arithmetic_return = row(batch.expected_arithmetic_return);
+  state.marginal_variance = row(batch.marginal_variance);
+  state.marginal_volatility = row(batch.marginal_volatility);
+  state.covariance = row(batch.covariance);
+  state.correlation = row(batch.correlation);
+  state.scenarios = row(batch.scenarios);
+  state.var_down = row(batch.var_down);
+  state.cvar_down = row(batch.cvar_down);
+  state.adverse_excursion_prob = row(batch.adverse_excursion_prob);
+  state.volatility = row(batch.volatility);
+  state.mixture_entropy = row(batch.mixture_entropy);
+  state.component_disagreement = row(batch.component_disagreement);
+  state.channel_disagreement = row(batch.channel_disagreement);
+  state.surprise = row(batch.surprise);
+  state.calibration_score = row(batch.calibration_score);
+  state.residual_quality_score = row(batch.residual_quality_score);
+  state.projection_validation_score = row(batch.projection_validation_score);
+  state.liquidity_score = row(batch.liquidity_score);
+  state.linear_cost = row(batch.linear_cost);
+  state.quadratic_impact = row(batch.quadratic_impact);
+  state.capacity_weight_limit = row(batch.capacity_weight_limit);
+  state.confidence = row(batch.confidence);
+  state.projection_validation_required =
+      flag(batch.projection_validation_required);
+  state.projection_validated = flag(batch.projection_validated);
+  state.live_capital_allowed = flag(batch.live_capital_allowed);
+  state.diagnostics = batch.diagnostics[i];
+  state.valid = flag(batch.belief_valid);
+  return state;
+}
+
 } // namespace cuwacunu::wikimyei::observer::belief
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <tuple>
 #include <vector>
 
@@ -11,12 +13,27 @@
 
 namespace cuwacunu::wikimyei::observer {
 
+enum class mixture_quantile_method_t {
+  newton,    // moment-matched start, safeguarded Newton on the mixture CDF
+  bisection, // fixed-step bisection over the +/-8 sigma component envelope
+};
+
+struct covariance_coupler_factor_cache_t;
+
 struct covariance_coupler_options_t {
   std::int64_t sample_count{512};
+  mixture_quantile_method_t quantile_method{mixture_quantile_method_t::newton};
   std::int64_t quantile_bisection_steps{40};
+  std::int64_t quantile_newton_max_steps{40};
+  // A Newton lane freezes once its step is below this fraction of the
+  // smallest component sigma of its marginal.
+  double quantile_newton_tolerance{1.0e-9};
   double shrinkage{0.10};
   double repair_epsilon{1.0e-6};
   double cholesky_jitter{1.0e-8};
+  // Optional; copies of the options share it, so anchors that reuse one
+  // empirical correlation repair and factor it once.
+  std::shared_ptr<covariance_coupler_factor_cache_t> factor_cache{};
 };
 
 struct coupled_samples_t {
@@ -26,6 +43,28 @@ struct coupled_samples_t {
   torch::Tensor uniforms{};    // [S,M]
 };
 
+struct coupled_sample_batch_t {
+  torch::Tensor samples{};     // [B,S,M], sampled marginal values
+  torch::Tensor covariance{};  // [B,M,M], sample-derived per anchor
+  torch::Tensor correlation{}; // [M,M], repaired/shrunk input correlation
+  torch::Tensor uniforms{};    // [B,S,M]
+};
+
+// Repaired correlation and its Cholesky factor for the last empirical
+// correlation seen. A lookup compares the [M,M] input exactly, which is far
+// cheaper than the eigendecompositions and factorization it skips.
+struct covariance_coupler_factor_cache_t {
+  std::mutex mutex{};
+  torch::Tensor empirical{};
+  double shrinkage{0.0};
+  double repair_epsilon{0.0};
+  double cholesky_jitter{0.0};
+  torch::Tensor correlation{};
+  torch::Tensor cholesky{};
+  std::int64_t hits{0};
+  std::int64_t misses{0};
+};
+
 [[nodiscard]] inline torch::Tensor
 covariance_standard_normal_cdf(const torch::Tensor &x) {
   return 0.5 * (1.0 + torch::erf(x / std::sqrt(2.0)));
@@ -66,19 +105,62 @@ shrink_and_repair_correlation(const torch::Tensor &empirical, double shrinkage,
   return repair_correlation_matrix(shrunk, epsilon);
 }
 
+[[nodiscard]] inline torch::Tensor
+correlation_cholesky_factor(const torch::Tensor &correlation,
+                            double cholesky_jitter = 1.0e-8) {
+  auto corr = repair_correlation_matrix(correlation).to(torch::kFloat64);
+  auto eye = torch::eye(corr.size(0), corr.options());
+  return torch::linalg_cholesky(corr + cholesky_jitter * eye);
+}
+
 [[nodiscard]] inline torch::Tensor
 sample_correlated_normals(const torch::Tensor &correlation,
                           std::int64_t sample_count,
                           double cholesky_jitter = 1.0e-8) {
   TORCH_CHECK(sample_count > 0,
               "[covariance_coupler] sample_count must be positive");
-  auto corr = repair_correlation_matrix(correlation).to(torch::kFloat64);
-  auto eye = torch::eye(corr.size(0), corr.options());
-  auto chol = torch::linalg_cholesky(corr + cholesky_jitter * eye);
-  auto z = torch::randn({sample_count, corr.size(0)}, corr.options());
+  auto chol = correlation_cholesky_factor(correlation, cholesky_jitter);
+  auto z = torch::randn({sample_count, chol.size(0)}, chol.options());
   return z.matmul(chol.transpose(0, 1));
 }
 
+// Shrunk/repaired correlation and its Cholesky factor, served from
+// options.factor_cache when the empirical correlation is unchanged.
+[[nodiscard]] inline std::pair<torch::Tensor, torch::Tensor>
+coupled_correlation_factor(const torch::Tensor &empirical_correlation,
+                           const covariance_coupler_options_t &options) {
+  auto *cache = options.factor_cache.get();
+  if (cache == nullptr) {
+    auto corr = shrink_and_repair_correlation(
+        empirical_correlation, options.shrinkage, options.repair_epsilon);
+    auto chol = correlation_cholesky_factor(corr, options.cholesky_jitter);
+    return {std::move(corr), std::move(chol)};
+  }
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  if (cache->empirical.defined() &&
+      cache->shrinkage == options.shrinkage &&
+      cache->repair_epsilon == options.repair_epsilon &&
+      cache->cholesky_jitter == options.cholesky_jitter &&
+      cache->empirical.sizes() == empirical_correlation.sizes() &&
+      cache->empirical.scalar_type() == empirical_correlation.scalar_type() &&
+      cache->empirical.device() == empirical_correlation.device() &&
+      torch::equal(cache->empirical, empirical_correlation)) {
+    ++cache->hits;
+    return {cache->correlation, cache->cholesky};
+  }
+  ++cache->misses;
+  auto corr = shrink_and_repair_correlation(
+      empirical_correlation, options.shrinkage, options.repair_epsilon);
+  auto chol = correlation_cholesky_factor(corr, options.cholesky_jitter);
+  cache->empirical = empirical_correlation.detach().clone();
+  cache->shrinkage = options.shrinkage;
+  cache->repair_epsilon = options.repair_epsilon;
+  cache->cholesky_jitter = options.cholesky_jitter;
+  cache->correlation = corr;
+  cache->cholesky = chol;
+  return {std::move(corr), std::move(chol)};
+}
+
 [[nodiscard]] inline torch::Tensor
 mixture_quantile(const torch::Tensor &log_weight, const torch::Tensor &mu,
                  const torch::Tensor &sigma, const torch::Tensor &uniforms,
@@ -123,6 +205,175 @@ mixture_quantile(const torch::Tensor &log_weight, const torch::Tensor &mu,
   return 0.5 * (low + high);
 }
 
+// Scratch tensors for mixture_quantile_newton, kept across calls so repeated
+// inversions of the same shape allocate nothing per iteration.
+struct mixture_quantile_workspace_t {
+  torch::Tensor z{};        // [B,S,A,K]
+  torch::Tensor term{};     // [B,S,A,K]
+  torch::Tensor x{};        // [B,S,A], current estimate
+  torch::Tensor low{};      // [B,S,A], bracket with F(low) < u
+  torch::Tensor high{};     // [B,S,A], bracket with F(high) >= u
+  torch::Tensor cdf{};      // [B,S,A]
+  torch::Tensor pdf{};      // [B,S,A]
+  torch::Tensor step{};     // [B,S,A]
+  torch::Tensor scratch{};  // [B,S,A]
+  torch::Tensor last_abs{}; // [B,S,A], |previous step|
+  torch::Tensor below{};    // [B,S,A], bool
+  torch::Tensor reject{};   // [B,S,A], bool
+  torch::Tensor done{};     // [B,S,A], bool, lane converged and frozen
+  std::int64_t last_iterations{0};
+
+  void reserve(std::int64_t B, std::int64_t S, std::int64_t A,
+               std::int64_t K, const torch::TensorOptions &options) {
+    if (z.defined() && z.device() == options.device() &&
+        z.sizes() == torch::IntArrayRef({B, S, A, K})) {
+      return;
+    }
+    z = torch::empty({B, S, A, K}, options);
+    term = torch::empty({B, S, A, K}, options);
+    for (auto *t : {&x, &low, &high, &cdf, &pdf, &step, &scratch, &last_abs}) {
+      *t = torch::empty({B, S, A}, options);
+    }
+    below = torch::empty({B, S, A}, options.dtype(torch::kBool));
+    reject = torch::empty({B, S, A}, options.dtype(torch::kBool));
+    done = torch::empty({B, S, A}, options.dtype(torch::kBool));
+  }
+};
+
+// Inverts Gaussian-mixture CDFs. Mixtures are [B,A,K] and uniforms [B,S,A].
+// Each marginal starts from its moment-matched normal quantile, bracketed by
+// the smallest and largest component quantiles (the mixture quantile always
+// lies between them). Newton steps use the mixture PDF and fall back to
+// bisection when a step leaves the bracket or fails to halve the previous
+// step, so well-behaved marginals converge in a handful of iterations and
+// multimodal ones never do worse than bisection. Each lane stops moving once
+// its own step falls below tolerance, so a lane's result does not depend on
+// what else shares the batch.
+[[nodiscard]] inline torch::Tensor mixture_quantile_newton_batch(
+    const torch::Tensor &log_weight, const torch::Tensor &mu,
+    const torch::Tensor &sigma, const torch::Tensor &uniforms,
+    std::int64_t max_steps = 40, double tolerance = 1.0e-9,
+    mixture_quantile_workspace_t *workspace = nullptr) {
+  TORCH_CHECK(log_weight.defined() && mu.defined() && sigma.defined(),
+              "[covariance_coupler] mixture tensors must be defined");
+  TORCH_CHECK(log_weight.dim() == 3 && mu.sizes() == log_weight.sizes() &&
+                  sigma.sizes() == log_weight.sizes(),
+              "[covariance_coupler] batched mixture tensors must be [B,A,K]");
+  TORCH_CHECK(uniforms.defined() && uniforms.dim() == 3 &&
+                  uniforms.size(0) == log_weight.size(0) &&
+                  uniforms.size(2) == log_weight.size(1),
+              "[covariance_coupler] batched uniforms must be [B,S,A]");
+  TORCH_CHECK(max_steps > 0,
+              "[covariance_coupler] Newton steps must be positive");
+  TORCH_CHECK(tolerance > 0.0,
+              "[covariance_coupler] Newton tolerance must be positive");
+
+  const auto B = log_weight.size(0);
+  const auto A = log_weight.size(1);
+  const auto K = log_weight.size(2);
+  const auto S = uniforms.size(1);
+  auto lw = log_weight.to(torch::kFloat64);
+  auto m = mu.to(torch::kFloat64);
+  auto s = sigma.to(torch::kFloat64).clamp_min(1.0e-12);
+  auto u = uniforms.to(torch::kFloat64).clamp(1.0e-8, 1.0 - 1.0e-8);
+  auto pi = lw.exp();
+
+  mixture_quantile_workspace_t local{};
+  auto &ws = workspace != nullptr ? *workspace : local;
+  ws.reserve(B, S, A, K, u.options());
+
+  auto m_b = m.unsqueeze(1);                // [B,1,A,K]
+  auto s_b = s.unsqueeze(1);                // [B,1,A,K]
+  auto half_pi_b = (0.5 * pi).unsqueeze(1); // CDF weights
+  constexpr double k_inv_sqrt2 = 0.7071067811865476;    // 1/sqrt(2)
+  constexpr double k_inv_sqrt_2pi = 0.3989422804014327; // 1/sqrt(2*pi)
+  const std::vector<std::int64_t> last_dim{-1};
+  auto density_b = (k_inv_sqrt_2pi * pi / s).unsqueeze(1);
+  auto step_floor = (tolerance * std::get<0>(s.min(/*dim=*/2)))
+                        .unsqueeze(1); // [B,1,A]
+
+  // Standard normal quantile of u, the bracket, and the moment-matched start.
+  auto z0 = std::sqrt(2.0) * torch::erfinv(2.0 * u - 1.0);
+  torch::mul_out(ws.z, s_b, z0.unsqueeze(-1));
+  ws.z.add_(m_b);
+  torch::amin_out(ws.low, ws.z, last_dim);
+  torch::amax_out(ws.high, ws.z, last_dim);
+  auto mean = (pi * m).sum(/*dim=*/-1);
+  auto var = ((pi * (s * s + m * m)).sum(/*dim=*/-1) - mean * mean)
+                 .clamp_min(0.0);
+  torch::mul_out(ws.x, var.sqrt().unsqueeze(1), z0);
+  ws.x.add_(mean.unsqueeze(1));
+  torch::maximum_out(ws.x, ws.x, ws.low);
+  torch::minimum_out(ws.x, ws.x, ws.high);
+  torch::sub_out(ws.last_abs, ws.high, ws.low);
+  ws.done.fill_(false);
+  const auto zero = torch::zeros({}, u.options());
+
+  ws.last_iterations = 0;
+  for (std::int64_t iter = 0; iter < max_steps; ++iter) {
+    ws.last_iterations = iter + 1;
+    // z = (x - mu) / sigma over components; F and f share it.
+    torch::sub_out(ws.z, ws.x.unsqueeze(-1), m_b);
+    ws.z.div_(s_b);
+    torch::mul_out(ws.term, ws.z, ws.z);
+    ws.term.mul_(-0.5).exp_().mul_(density_b);
+    torch::sum_out(ws.pdf, ws.term, last_dim);
+    ws.z.mul_(k_inv_sqrt2).erf_().add_(1.0).mul_(half_pi_b);
+    torch::sum_out(ws.cdf, ws.z, last_dim);
+
+    // Shrink the bracket around the root.
+    torch::lt_out(ws.below, ws.cdf, u);
+    torch::where_out(ws.low, ws.below, ws.x, ws.low);
+    torch::where_out(ws.high, ws.below, ws.high, ws.x);
+
+    // Newton step, rejected in favour of bisection when it leaves the
+    // bracket or does not halve the previous step.
+    torch::sub_out(ws.step, ws.cdf, u);
+    ws.step.div_(ws.pdf.clamp_min_(1.0e-300));
+    torch::sub_out(ws.scratch, ws.x, ws.step);
+    torch::lt_out(ws.reject, ws.scratch, ws.low);
+    torch::gt_out(ws.below, ws.scratch, ws.high);
+    ws.reject.logical_or_(ws.below);
+    torch::abs_out(ws.scratch, ws.step).mul_(2.0);
+    torch::gt_out(ws.below, ws.scratch, ws.last_abs);
+    ws.reject.logical_or_(ws.below);
+    torch::add_out(ws.scratch, ws.low, ws.high).mul_(0.5);
+    torch::sub_out(ws.scratch, ws.x, ws.scratch);
+    torch::where_out(ws.step, ws.reject, ws.scratch, ws.step);
+    torch::where_out(ws.step, ws.done, zero, ws.step);
+
+    ws.x.sub_(ws.step);
+    torch::abs_out(ws.last_abs, ws.step);
+    // NaN steps count as converged, as a non-finite lane cannot improve.
+    torch::gt_out(ws.done, ws.last_abs, step_floor);
+    ws.done.logical_not_();
+    if (ws.done.all().item<bool>()) {
+      break;
+    }
+  }
+  return ws.x.clone();
+}
+
+[[nodiscard]] inline torch::Tensor
+mixture_quantile_newton(const torch::Tensor &log_weight,
+                        const torch::Tensor &mu, const torch::Tensor &sigma,
+                        const torch::Tensor &uniforms,
+                        std::int64_t max_steps = 40, double tolerance = 1.0e-9,
+                        mixture_quantile_workspace_t *workspace = nullptr) {
+  TORCH_CHECK(log_weight.defined() && mu.defined() && sigma.defined(),
+              "[covariance_coupler] mixture tensors must be defined");
+  TORCH_CHECK(log_weight.dim() == 2 && mu.sizes() == log_weight.sizes() &&
+                  sigma.sizes() == log_weight.sizes(),
+              "[covariance_coupler] mixture tensors must be [A,K]");
+  TORCH_CHECK(uniforms.defined() && uniforms.dim() == 2 &&
+                  uniforms.size(1) == log_weight.size(0),
+              "[covariance_coupler] uniforms must be [S,A]");
+  return mixture_quantile_newton_batch(
+             log_weight.unsqueeze(0), mu.unsqueeze(0), sigma.unsqueeze(0),
+             uniforms.unsqueeze(0), max_steps, tolerance, workspace)
+      .squeeze(0);
+}
+
 [[nodiscard]] inline torch::Tensor scenario_covariance(const torch::Tensor &x) {
   TORCH_CHECK(x.defined() && x.dim() == 2,
               "[covariance_coupler] scenarios must be [S,A]");
@@ -133,17 +384,54 @@ mixture_quantile(const torch::Tensor &log_weight, const torch::Tensor &mu,
   return centered.transpose(0, 1).matmul(centered) / denom;
 }
 
+[[nodiscard]] inline torch::Tensor
+scenario_covariance_batch(const torch::Tensor &x) {
+  TORCH_CHECK(x.defined() && x.dim() == 3,
+              "[covariance_coupler] batched scenarios must be [B,S,A]");
+  const auto S = x.size(1);
+  auto y = x.to(torch::kFloat64);
+  auto centered = y - y.mean(/*dim=*/1, /*keepdim=*/true);
+  const double denom = static_cast<double>(std::max<std::int64_t>(S - 1, 1));
+  return centered.transpose(1, 2).matmul(centered) / denom;
+}
+
+// Dispatches on options.quantile_method; mixtures are [B,A,K], uniforms
+// [B,S,A].
+[[nodiscard]] inline torch::Tensor
+invert_mixture_marginals(const torch::Tensor &log_weight,
+                         const torch::Tensor &mu, const torch::Tensor &sigma,
+                         const torch::Tensor &uniforms,
+                         const covariance_coupler_options_t &options,
+                         mixture_quantile_workspace_t *workspace = nullptr) {
+  if (options.quantile_method == mixture_quantile_method_t::newton) {
+    return mixture_quantile_newton_batch(
+        log_weight, mu, sigma, uniforms, options.quantile_newton_max_steps,
+        options.quantile_newton_tolerance, workspace);
+  }
+  std::vector<torch::Tensor> per_anchor;
+  per_anchor.reserve(static_cast<std::size_t>(log_weight.size(0)));
+  for (std::int64_t b = 0; b < log_weight.size(0); ++b) {
+    per_anchor.push_back(mixture_quantile(
+        log_weight.select(0, b), mu.select(0, b), sigma.select(0, b),
+        uniforms.select(0, b), options.quantile_bisection_steps));
+  }
+  return torch::stack(per_anchor, /*dim=*/0);
+}
+
 [[nodiscard]] inline torch::Tensor
 covariance_to_correlation(const torch::Tensor &covariance,
                           double epsilon = 1.0e-12) {
-  TORCH_CHECK(covariance.defined() && covariance.dim() == 2 &&
-                  covariance.size(0) == covariance.size(1),
-              "[covariance_coupler] covariance must be [A,A]");
+  TORCH_CHECK(covariance.defined() &&
+                  (covariance.dim() == 2 || covariance.dim() == 3) &&
+                  covariance.size(-1) == covariance.size(-2),
+              "[covariance_coupler] covariance must be [A,A] or [B,A,A]");
   auto cov = covariance.to(torch::kFloat64);
-  auto scale = cov.diagonal().clamp_min(epsilon).sqrt();
-  auto corr = cov / (scale.unsqueeze(1) * scale.unsqueeze(0));
-  corr = 0.5 * (corr + corr.transpose(0, 1));
-  corr.diagonal().fill_(1.0);
+  auto scale = cov.diagonal(/*offset=*/0, /*dim1=*/-2, /*dim2=*/-1)
+                   .clamp_min(epsilon)
+                   .sqrt();
+  auto corr = cov / (scale.unsqueeze(-1) * scale.unsqueeze(-2));
+  corr = 0.5 * (corr + corr.transpose(-2, -1));
+  corr.diagonal(/*offset=*/0, /*dim1=*/-2, /*dim2=*/-1).fill_(1.0);
   return corr;
 }
 
@@ -178,16 +466,19 @@ covariance_to_correlation(const torch::Tensor &covariance,
                   empirical_correlation.size(0) == M &&
                   empirical_correlation.size(1) == M,
               "[covariance_coupler] empirical_correlation must be [M,M]");
-  auto corr = shrink_and_repair_correlation(
-      empirical_correlation, options.shrinkage, options.repair_epsilon);
-  auto normals = sample_correlated_normals(corr, options.sample_count,
-                                           options.cholesky_jitter);
+  auto [corr, chol] =
+      coupled_correlation_factor(empirical_correlation, options);
+  auto normals =
+      torch::randn({options.sample_count, M}, chol.options())
+          .matmul(chol.transpose(0, 1));
   auto uniforms =
       covariance_standard_normal_cdf(normals).clamp(1.0e-8, 1.0 - 1.0e-8);
   auto samples =
-      mixture_quantile(lw.to(torch::kFloat64), selected_mu.to(torch::kFloat64),
-                       selected_sigma.to(torch::kFloat64), uniforms,
-                       options.quantile_bisection_steps);
+      invert_mixture_marginals(lw.to(torch::kFloat64).unsqueeze(0),
+                               selected_mu.to(torch::kFloat64).unsqueeze(0),
+                               selected_sigma.to(torch::kFloat64).unsqueeze(0),
+                               uniforms.unsqueeze(0), options)
+          .squeeze(0);
   auto cov = scenario_covariance(samples);
 
   coupled_samples_t result{};
@@ -198,4 +489,62 @@ covariance_to_correlation(const torch::Tensor &covariance,
   return result;
 }
 
+// Samples every anchor of a [B,G,Kc] marginal surface at once against one
+// shared empirical correlation: the correlation is repaired and factored once
+// (or served from options.factor_cache), and all marginals are inverted in a
+// single batched quantile solve. Normals are drawn one [S,M] block per anchor
+// in anchor order, so a batch consumes the generator exactly like B
+// sequential sample_single_anchor_marginals calls.
+[[nodiscard]] inline coupled_sample_batch_t sample_anchor_batch_marginals(
+    const torch::Tensor &log_weight, const torch::Tensor &mu,
+    const torch::Tensor &sigma, const std::vector<std::int64_t> &graph_indices,
+    const torch::Tensor &empirical_correlation,
+    const covariance_coupler_options_t &options = {},
+    mixture_quantile_workspace_t *workspace = nullptr) {
+  TORCH_CHECK(options.sample_count > 0,
+              "[covariance_coupler] sample_count must be positive");
+  TORCH_CHECK(!graph_indices.empty(),
+              "[covariance_coupler] graph_indices must not be empty");
+  TORCH_CHECK(log_weight.defined() && mu.defined() && sigma.defined(),
+              "[covariance_coupler] marginal mixture tensors required");
+  TORCH_CHECK(log_weight.dim() == 3 && mu.sizes() == log_weight.sizes() &&
+                  sigma.sizes() == log_weight.sizes(),
+              "[covariance_coupler] marginal mixtures must be [B,G,Kc]");
+  TORCH_CHECK(log_weight.size(0) > 0,
+              "[covariance_coupler] anchor batch must not be empty");
+  auto index = torch::tensor(
+      graph_indices,
+      torch::TensorOptions().dtype(torch::kInt64).device(log_weight.device()));
+  auto lw = log_weight.index_select(1, index).to(torch::kFloat64);
+  auto selected_mu = mu.index_select(1, index).to(torch::kFloat64);
+  auto selected_sigma = sigma.index_select(1, index).to(torch::kFloat64);
+
+  const auto B = log_weight.size(0);
+  const auto M = static_cast<std::int64_t>(graph_indices.size());
+  TORCH_CHECK(empirical_correlation.defined() &&
+                  empirical_correlation.dim() == 2 &&
+                  empirical_correlation.size(0) == M &&
+                  empirical_correlation.size(1) == M,
+              "[covariance_coupler] empirical_correlation must be [M,M]");
+  auto [corr, chol] =
+      coupled_correlation_factor(empirical_correlation, options);
+  auto normals = torch::empty({B, options.sample_count, M}, chol.options());
+  for (std::int64_t b = 0; b < B; ++b) {
+    normals.select(/*dim=*/0, b).normal_();
+  }
+  normals = normals.matmul(chol.transpose(0, 1));
+  auto uniforms =
+      covariance_standard_normal_cdf(normals).clamp(1.0e-8, 1.0 - 1.0e-8);
+  auto samples = invert_mixture_marginals(lw, selected_mu, selected_sigma,
+                                          uniforms, options, workspace);
+  auto cov = scenario_covariance_batch(samples);
+
+  coupled_sample_batch_t result{};
+  result.samples = std::move(samples);
+  result.covariance = std::move(cov);
+  result.correlation = std::move(corr);
+  result.uniforms = std::move(uniforms);
+  return result;
+}
+
 } // namespace cuwacunu::wikimyei::observer
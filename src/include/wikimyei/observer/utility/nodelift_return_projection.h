@@ -36,6 +36,24 @@ struct nodelift_return_projection_t {
   torch::Tensor correlation{};                // [A,A]
 };
 
+// The same projection for a contiguous range of B anchors; every field gains
+// a leading anchor dimension.
+struct nodelift_return_projection_batch_t {
+  torch::Tensor projected_log_weight{};         // [B,A,Kp]
+  torch::Tensor projected_log_return_mu{};      // [B,A,Kp]
+  torch::Tensor projected_log_return_sigma{};   // [B,A,Kp]
+  torch::Tensor active_mask{};                  // [B,A], bool
+  torch::Tensor potential_samples{};            // [B,S,M]
+  torch::Tensor numeraire_relative_log_return{}; // [B,S,A]
+  torch::Tensor arithmetic_return_scenarios{};  // [B,S,A]
+  torch::Tensor expected_log_return{};          // [B,A]
+  torch::Tensor expected_arithmetic_return{};   // [B,A]
+  torch::Tensor marginal_variance{};            // [B,A]
+  torch::Tensor marginal_volatility{};          // [B,A]
+  torch::Tensor covariance{};                   // [B,A,A]
+  torch::Tensor correlation{};                  // [B,A,A]
+};
+
 namespace detail {
 
 [[nodiscard]] inline torch::Tensor
@@ -47,22 +65,27 @@ index_tensor(const std::vector<std::int64_t> &indices,
       indices, torch::TensorOptions().dtype(torch::kInt64).device(device));
 }
 
+// Unbiased variance over the scenario axis of [S,A] or [B,S,A] samples.
 [[nodiscard]] inline torch::Tensor
 variance_along_rows(const torch::Tensor &samples) {
-  const auto S = samples.size(0);
-  auto centered = samples - samples.mean(/*dim=*/0, /*keepdim=*/true);
+  const auto S = samples.size(-2);
+  auto centered = samples - samples.mean(/*dim=*/-2, /*keepdim=*/true);
   const double denom = static_cast<double>(std::max<std::int64_t>(S - 1, 1));
-  return centered.pow(2).sum(/*dim=*/0) / denom;
+  return centered.pow(2).sum(/*dim=*/-2) / denom;
 }
 
 } // namespace detail
 
-[[nodiscard]] inline nodelift_return_projection_t project_single_anchor(
-    const nodelift_potential_surface_t &surface, std::int64_t anchor_slot,
+// Projects anchors [anchor_begin, anchor_begin + anchor_count) of a [B,G,Kc]
+// potential surface into numeraire-relative returns in one batched pass.
+[[nodiscard]] inline nodelift_return_projection_batch_t project_anchor_batch(
+    const nodelift_potential_surface_t &surface, std::int64_t anchor_begin,
+    std::int64_t anchor_count,
     const std::vector<std::int64_t> &asset_graph_indices,
     std::int64_t projection_reference_graph_index,
     const torch::Tensor &empirical_correlation,
-    const nodelift_return_projection_options_t &options = {}) {
+    const nodelift_return_projection_options_t &options = {},
+    mixture_quantile_workspace_t *workspace = nullptr) {
   TORCH_CHECK(
       surface.log_weight.defined() && surface.potential_mu.defined() &&
           surface.potential_sigma.defined(),
@@ -70,8 +93,9 @@ variance_along_rows(const torch::Tensor &samples) {
   TORCH_CHECK(
       surface.log_weight.dim() == 3,
       "[nodelift_return_projection] potential surface must be [B,G,Kc]");
-  TORCH_CHECK(anchor_slot >= 0 && anchor_slot < surface.log_weight.size(0),
-              "[nodelift_return_projection] anchor_slot out of range");
+  TORCH_CHECK(anchor_begin >= 0 && anchor_count > 0 &&
+                  anchor_begin + anchor_count <= surface.log_weight.size(0),
+              "[nodelift_return_projection] anchor range out of range");
   TORCH_CHECK(projection_reference_graph_index >= 0 &&
                   projection_reference_graph_index < surface.log_weight.size(1),
               "[nodelift_return_projection] projection_reference_graph_index "
@@ -100,69 +124,74 @@ variance_along_rows(const torch::Tensor &samples) {
               "[M,M] ordered as target nodes plus projection reference when "
               "absent from target nodes");
 
+  const auto B = anchor_count;
   auto asset_index = detail::index_tensor(
       asset_graph_indices, surface.log_weight.device(), "asset_graph_indices");
-  auto anchor_log_weight = surface.log_weight.select(/*dim=*/0, anchor_slot);
-  auto anchor_mu = surface.potential_mu.select(/*dim=*/0, anchor_slot);
-  auto anchor_sigma = surface.potential_sigma.select(/*dim=*/0, anchor_slot);
+  auto anchor_log_weight =
+      surface.log_weight.narrow(/*dim=*/0, anchor_begin, anchor_count);
+  auto anchor_mu =
+      surface.potential_mu.narrow(/*dim=*/0, anchor_begin, anchor_count);
+  auto anchor_sigma =
+      surface.potential_sigma.narrow(/*dim=*/0, anchor_begin, anchor_count);
 
-  auto asset_log_weight = anchor_log_weight.index_select(0, asset_index);
-  auto asset_mu = anchor_mu.index_select(0, asset_index);
-  auto asset_sigma = anchor_sigma.index_select(0, asset_index);
+  auto asset_log_weight = anchor_log_weight.index_select(1, asset_index);
+  auto asset_mu = anchor_mu.index_select(1, asset_index);
+  auto asset_sigma = anchor_sigma.index_select(1, asset_index);
   auto projection_reference_log_weight =
-      anchor_log_weight.select(/*dim=*/0, projection_reference_graph_index);
+      anchor_log_weight.select(/*dim=*/1, projection_reference_graph_index);
   auto projection_reference_mu =
-      anchor_mu.select(/*dim=*/0, projection_reference_graph_index);
+      anchor_mu.select(/*dim=*/1, projection_reference_graph_index);
   auto projection_reference_sigma =
-      anchor_sigma.select(/*dim=*/0, projection_reference_graph_index);
-
-  const auto K = asset_log_weight.size(1);
-  auto log_weight = asset_log_weight.unsqueeze(2) +
-                    projection_reference_log_weight.view({1, 1, K});
-  log_weight = log_weight.reshape({A, K * K});
-  log_weight = log_weight - torch::logsumexp(log_weight, /*dim=*/1, true);
-  auto mu = (asset_mu.unsqueeze(2) - projection_reference_mu.view({1, 1, K}))
-                .reshape({A, K * K});
-  auto sigma = (asset_sigma.pow(2).unsqueeze(2) +
-                projection_reference_sigma.pow(2).view({1, 1, K}))
+      anchor_sigma.select(/*dim=*/1, projection_reference_graph_index);
+
+  const auto K = asset_log_weight.size(2);
+  auto log_weight = asset_log_weight.unsqueeze(3) +
+                    projection_reference_log_weight.reshape({B, 1, 1, K});
+  log_weight = log_weight.reshape({B, A, K * K});
+  log_weight = log_weight - torch::logsumexp(log_weight, /*dim=*/2, true);
+  auto mu =
+      (asset_mu.unsqueeze(3) - projection_reference_mu.reshape({B, 1, 1, K}))
+          .reshape({B, A, K * K});
+  auto sigma = (asset_sigma.pow(2).unsqueeze(3) +
+                projection_reference_sigma.pow(2).reshape({B, 1, 1, K}))
                    .clamp_min(0.0)
                    .sqrt()
-                   .reshape({A, K * K});
+                   .reshape({B, A, K * K});
 
   auto active =
       surface.active_mask.defined()
-          ? surface.active_mask.select(/*dim=*/0, anchor_slot)
-                .index_select(0, asset_index)
-          : torch::ones({A}, torch::TensorOptions()
-                                 .dtype(torch::kBool)
-                                 .device(surface.log_weight.device()));
+          ? surface.active_mask.narrow(/*dim=*/0, anchor_begin, anchor_count)
+                .index_select(1, asset_index)
+          : torch::ones({B, A}, torch::TensorOptions()
+                                    .dtype(torch::kBool)
+                                    .device(surface.log_weight.device()));
   if (surface.active_mask.defined()) {
     auto projection_reference_active =
-        surface.active_mask.select(/*dim=*/0, anchor_slot)
-            .select(/*dim=*/0, projection_reference_graph_index)
+        surface.active_mask.narrow(/*dim=*/0, anchor_begin, anchor_count)
+            .select(/*dim=*/1, projection_reference_graph_index)
             .to(torch::TensorOptions()
                     .dtype(torch::kBool)
                     .device(surface.log_weight.device()));
-    active = active.logical_and(projection_reference_active.expand_as(active));
+    active = active.logical_and(
+        projection_reference_active.unsqueeze(1).expand_as(active));
   }
-  auto inactive = active.logical_not().unsqueeze(1);
+  auto inactive = active.logical_not().unsqueeze(2);
   log_weight =
       log_weight.masked_fill(inactive, -std::log(static_cast<double>(K * K)));
   mu = mu.masked_fill(inactive, 0.0);
   sigma = sigma.masked_fill(inactive, 0.0);
 
-  auto coupled = sample_single_anchor_marginals(
-      surface.log_weight, surface.potential_mu, surface.potential_sigma,
-      anchor_slot, projection_indices, empirical_correlation,
-      options.coupling_options);
-  auto asset_potential = coupled.samples.narrow(/*dim=*/1, 0, A);
+  auto coupled = sample_anchor_batch_marginals(
+      anchor_log_weight, anchor_mu, anchor_sigma, projection_indices,
+      empirical_correlation, options.coupling_options, workspace);
+  auto asset_potential = coupled.samples.narrow(/*dim=*/2, 0, A);
   auto projection_reference_potential =
-      coupled.samples.select(/*dim=*/1, reference_projection_position)
-          .unsqueeze(1);
+      coupled.samples.select(/*dim=*/2, reference_projection_position)
+          .unsqueeze(2);
   auto log_return = asset_potential - projection_reference_potential;
   auto scenarios = torch::exp(log_return) - 1.0;
-  scenarios = scenarios.masked_fill(active.logical_not().unsqueeze(0), 0.0);
-  log_return = log_return.masked_fill(active.logical_not().unsqueeze(0), 0.0);
+  scenarios = scenarios.masked_fill(active.logical_not().unsqueeze(1), 0.0);
+  log_return = log_return.masked_fill(active.logical_not().unsqueeze(1), 0.0);
 
   for (std::int64_t a = 0; a < A; ++a) {
     if (asset_graph_indices[static_cast<std::size_t>(a)] !=
@@ -170,21 +199,21 @@ variance_along_rows(const torch::Tensor &samples) {
       continue;
     }
     using torch::indexing::Slice;
-    log_weight.index_put_({a, Slice()},
+    log_weight.index_put_({Slice(), a, Slice()},
                           -std::log(static_cast<double>(K * K)));
-    mu.index_put_({a, Slice()}, 0.0);
-    sigma.index_put_({a, Slice()}, 0.0);
-    log_return.index_put_({Slice(), a}, 0.0);
-    scenarios.index_put_({Slice(), a}, 0.0);
-    active.index_put_({a}, true);
+    mu.index_put_({Slice(), a, Slice()}, 0.0);
+    sigma.index_put_({Slice(), a, Slice()}, 0.0);
+    log_return.index_put_({Slice(), Slice(), a}, 0.0);
+    scenarios.index_put_({Slice(), Slice(), a}, 0.0);
+    active.index_put_({Slice(), a}, true);
   }
 
-  auto expected_log = log_return.mean(/*dim=*/0);
-  auto expected_arithmetic = scenarios.mean(/*dim=*/0);
+  auto expected_log = log_return.mean(/*dim=*/1);
+  auto expected_arithmetic = scenarios.mean(/*dim=*/1);
   auto variance = detail::variance_along_rows(scenarios).clamp_min(0.0);
-  auto covariance = scenario_covariance(scenarios);
+  auto covariance = scenario_covariance_batch(scenarios);
 
-  nodelift_return_projection_t result{};
+  nodelift_return_projection_batch_t result{};
   result.projected_log_weight = std::move(log_weight);
   result.projected_log_return_mu = std::move(mu);
   result.projected_log_return_sigma = std::move(sigma);
@@ -201,4 +230,47 @@ variance_along_rows(const torch::Tensor &samples) {
   return result;
 }
 
+// View of one anchor of a batched projection; shares its storage.
+[[nodiscard]] inline nodelift_return_projection_t
+select_anchor_projection(const nodelift_return_projection_batch_t &batch,
+                         std::int64_t index) {
+  TORCH_CHECK(batch.active_mask.defined() && index >= 0 &&
+                  index < batch.active_mask.size(0),
+              "[nodelift_return_projection] anchor index out of range");
+  nodelift_return_projection_t result{};
+  result.projected_log_weight = batch.projected_log_weight.select(0, index);
+  result.projected_log_return_mu =
+      batch.projected_log_return_mu.select(0, index);
+  result.projected_log_return_sigma =
+      batch.projected_log_return_sigma.select(0, index);
+  result.active_mask = batch.active_mask.select(0, index);
+  result.potential_samples = batch.potential_samples.select(0, index);
+  result.numeraire_relative_log_return =
+      batch.numeraire_relative_log_return.select(0, index);
+  result.arithmetic_return_scenarios =
+      batch.arithmetic_return_scenarios.select(0, index);
+  result.expected_log_return = batch.expected_log_return.select(0, index);
+  result.expected_arithmetic_return =
+      batch.expected_arithmetic_return.select(0, index);
+  result.marginal_variance = batch.marginal_variance.select(0, index);
+  result.marginal_volatility = batch.marginal_volatility.select(0, index);
+  result.covariance = batch.covariance.select(0, index);
+  result.correlation = batch.correlation.select(0, index);
+  return result;
+}
+
+[[nodiscard]] inline nodelift_return_projection_t project_single_anchor(
+    const nodelift_potential_surface_t &surface, std::int64_t anchor_slot,
+    const std::vector<std::int64_t> &asset_graph_indices,
+    std::int64_t projection_reference_graph_index,
+    const torch::Tensor &empirical_correlation,
+    const nodelift_return_projection_options_t &options = {}) {
+  return select_anchor_projection(
+      project_anchor_batch(surface, anchor_slot, /*anchor_count=*/1,
+                           asset_graph_indices,
+                           projection_reference_graph_index,
+                           empirical_correlation, options),
+      /*index=*/0);
+}
+
 } // namespace cuwacunu::wikimyei::observer
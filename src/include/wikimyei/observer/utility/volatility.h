@@ -10,21 +10,22 @@ struct volatility_options_t {
 };
 
 struct volatility_t {
-  torch::Tensor mdn_variance{};      // [A]
-  torch::Tensor realized_variance{}; // [A]
-  torch::Tensor final_variance{};    // [A]
-  torch::Tensor volatility{};        // [A]
+  torch::Tensor mdn_variance{};      // [A] or [B,A]
+  torch::Tensor realized_variance{}; // [A] or [B,A]
+  torch::Tensor final_variance{};    // [A] or [B,A]
+  torch::Tensor volatility{};        // [A] or [B,A]
 };
 
 [[nodiscard]] inline volatility_t
 blend_mdn_and_realized_variance(const torch::Tensor &mdn_variance,
                                 const torch::Tensor &realized_variance,
                                 const volatility_options_t &options = {}) {
-  TORCH_CHECK(mdn_variance.defined() && mdn_variance.dim() == 1,
-              "[volatility] mdn_variance must be [A]");
+  TORCH_CHECK(mdn_variance.defined() &&
+                  (mdn_variance.dim() == 1 || mdn_variance.dim() == 2),
+              "[volatility] mdn_variance must be [A] or [B,A]");
   TORCH_CHECK(realized_variance.defined() &&
                   realized_variance.sizes() == mdn_variance.sizes(),
-              "[volatility] realized_variance must be [A]");
+              "[volatility] realized_variance must match mdn_variance");
   TORCH_CHECK(options.mdn_weight >= 0.0 && options.mdn_weight <= 1.0,
               "[volatility] mdn_weight must be in [0,1]");
   auto mdn = mdn_variance.to(torch::kFloat64).clamp_min(0.0);
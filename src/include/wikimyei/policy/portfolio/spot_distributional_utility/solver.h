@@ -7,6 +7,7 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/bench/trace_span.h"
 #include "wikimyei/observer/belief/types.h"
 #include "wikimyei/observer/utility/data_quality.h"
 #include "wikimyei/observer/utility/transaction_cost.h"
@@ -124,6 +125,11 @@ bool_mask_or_true(const torch::Tensor &mask, std::int64_t A,
   return top.mean();
 }
 
+// Inference tensors cannot be saved for backward; see solve().
+[[nodiscard]] inline torch::Tensor autograd_input(const torch::Tensor &value) {
+  return value.is_inference() ? value.clone() : value;
+}
+
 } // namespace detail
 
 [[nodiscard]] inline TargetPortfolio
@@ -131,6 +137,7 @@ solve(const cuwacunu::wikimyei::observer::belief::AllocationBelief &belief,
       const PortfolioState &portfolio, const MarketState &market,
       const PortfolioConstraints &constraints,
       const solver_options_t &options = {}) {
+  PIAABO_TRACE_SPAN("wikimyei", "spot_distributional_utility.solve");
   namespace belief_ns = cuwacunu::wikimyei::observer::belief;
   const auto A = belief_ns::asset_count(belief);
   validate_portfolio_state(portfolio, A);
@@ -163,7 +170,10 @@ solve(const cuwacunu::wikimyei::observer::belief::AllocationBelief &belief,
     return guarded;
   }
 
-  auto scenarios = belief.scenarios.to(torch::kFloat64);
+  // Replay and evaluation hold InferenceMode; the projected-gradient loop
+  // below needs autograd, so it leaves that mode for this scope.
+  c10::InferenceMode autograd_enabled(false);
+  auto scenarios = detail::autograd_input(belief.scenarios.to(torch::kFloat64));
   const auto device = scenarios.device();
   auto tensor_options =
       torch::TensorOptions().dtype(torch::kFloat64).device(device);
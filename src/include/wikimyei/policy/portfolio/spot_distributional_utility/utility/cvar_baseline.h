@@ -42,9 +42,12 @@ solve(const cuwacunu::wikimyei::observer::belief::AllocationBelief &belief,
     return guarded;
   }
 
+  c10::InferenceMode autograd_enabled(false);
   auto ctx = solver::make_solve_context(belief, portfolio, market, constraints);
-  auto scenarios = belief.scenarios.to(ctx.tensor_options);
-  auto mu = belief.expected_arithmetic_return.to(ctx.tensor_options);
+  auto scenarios =
+      solver::autograd_input(belief.scenarios.to(ctx.tensor_options));
+  auto mu = solver::autograd_input(
+      belief.expected_arithmetic_return.to(ctx.tensor_options));
 
   auto objective_for = [&](const torch::Tensor &w) {
     auto growth = 1.0 + scenarios.matmul(w);
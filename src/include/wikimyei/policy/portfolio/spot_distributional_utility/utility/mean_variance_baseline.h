@@ -43,9 +43,12 @@ solve(const cuwacunu::wikimyei::observer::belief::AllocationBelief &belief,
     return guarded;
   }
 
+  c10::InferenceMode autograd_enabled(false);
   auto ctx = solver::make_solve_context(belief, portfolio, market, constraints);
-  auto mu = belief.expected_arithmetic_return.to(ctx.tensor_options);
-  auto covariance = belief.covariance.to(ctx.tensor_options);
+  auto mu = solver::autograd_input(
+      belief.expected_arithmetic_return.to(ctx.tensor_options));
+  auto covariance =
+      solver::autograd_input(belief.covariance.to(ctx.tensor_options));
   auto uncertainty = (1.0 - ctx.confidence).clamp(0.0, 1.0);
 
   auto objective_for = [&](const torch::Tensor &w) {
@@ -124,6 +124,13 @@ bool_mask_or_true(const torch::Tensor &mask, std::int64_t A,
   return top.mean();
 }
 
+// The gradient solves below leave any caller InferenceMode (replay and
+// evaluation hold one) for their own scope. Inference tensors still cannot be
+// saved for backward, so inputs the objective captures as-is are cloned.
+[[nodiscard]] inline torch::Tensor autograd_input(const torch::Tensor &value) {
+  return value.is_inference() ? value.clone() : value;
+}
+
 [[nodiscard]] inline solve_context_t
 make_solve_context(const belief_ns::AllocationBelief &belief,
                    const PortfolioState &portfolio, const MarketState &market,
@@ -14,6 +14,8 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
+
 namespace cuwacunu::wikimyei::representation::encoding::mtf_jepa_mae_vicreg {
 
 /*
@@ -267,10 +269,15 @@ compute_vicreg_stability_loss(
               "[mtf_jepa_mae_vicreg] stability z1/z2 shape mismatch");
   TORCH_CHECK(mask1.sizes() == mask2.sizes(),
               "[mtf_jepa_mae_vicreg] stability mask1/mask2 shape mismatch");
+  // Covariance stays float32 under bf16 autocast.
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  precision::float32_scope_t float32_loss;
   const auto joint_mask =
       mask1.to(torch::kBool).logical_and(mask2.to(torch::kBool));
-  auto rows1 = vicreg_stability_detail::valid_rows(z1, joint_mask);
-  auto rows2 = vicreg_stability_detail::valid_rows(z2, joint_mask);
+  auto rows1 = vicreg_stability_detail::valid_rows(
+      precision::widen_reduced_precision(z1), joint_mask);
+  auto rows2 = vicreg_stability_detail::valid_rows(
+      precision::widen_reduced_precision(z2), joint_mask);
 
   vicreg_stability_loss_result_t out{};
   out.valid_rows = std::min(rows1.size(0), rows2.size(0));
@@ -553,18 +560,27 @@ inline torch::Tensor masked_mean(const torch::Tensor &x,
   return (x * mask_f).sum(/*dim=*/1) / denom;
 }
 
-inline torch::Tensor masked_mse(const torch::Tensor &a, const torch::Tensor &b,
+// Reconstruction losses reduce in float32 when the latents come out of a
+// bf16 autocast forward.
+inline torch::Tensor masked_mse(const torch::Tensor &a_in,
+                                const torch::Tensor &b_in,
                                 const torch::Tensor &mask) {
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  const auto a = precision::widen_reduced_precision(a_in);
+  const auto b = precision::widen_reduced_precision(b_in);
   const auto mask_f = mask.to(a.dtype()).unsqueeze(-1);
   const auto denom =
       (mask_f.sum() * static_cast<double>(a.size(-1))).clamp_min(1.0);
   return ((a - b).pow(2) * mask_f).sum() / denom;
 }
 
-inline torch::Tensor masked_weighted_mse(const torch::Tensor &a,
-                                         const torch::Tensor &b,
+inline torch::Tensor masked_weighted_mse(const torch::Tensor &a_in,
+                                         const torch::Tensor &b_in,
                                          const torch::Tensor &token_mask,
                                          const torch::Tensor &descriptor_mask) {
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  const auto a = precision::widen_reduced_precision(a_in);
+  const auto b = precision::widen_reduced_precision(b_in);
   TORCH_CHECK(a.sizes() == b.sizes(),
               "[mtf_jepa_mae_vicreg] weighted MSE tensor shape mismatch");
   TORCH_CHECK(token_mask.dim() == 2 && descriptor_mask.dim() == 3,
@@ -2159,6 +2175,9 @@ private:
       return out;
     }
     out.pair_valid_count = pair_mask.sum().item<int64_t>();
+    namespace precision = cuwacunu::piaabo::tensor::torch;
+    time_latents = precision::widen_reduced_precision(time_latents);
+    frequency_latents = precision::widen_reduced_precision(frequency_latents);
     auto pair_loss =
         1.0 - torch::cosine_similarity(time_latents, frequency_latents,
                                        /*dim=*/-1, /*eps=*/1e-8);
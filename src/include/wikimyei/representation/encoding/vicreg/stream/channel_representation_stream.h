@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -15,11 +16,13 @@
 
 #include "hero/lattice_hero/lattice/runtime_report/component_runtime_lls.h"
 #include "kikijyeba/protocol/component_stream.h"
+#include "piaabo/tensor/torch/device_metric_accumulator.h"
 #include "wikimyei/expression/nodelift/srl/stream/node_lifted_stream.h"
 #include "wikimyei/representation/encoding/vicreg/channel_node_stream_adapter.h"
 #include "wikimyei/representation/encoding/vicreg/channel_preserving_encoder.h"
 #include "wikimyei/representation/encoding/vicreg/channel_representation_adapter.h"
 #include "wikimyei/representation/encoding/vicreg/stream/channel_representation_batch.h"
+#include "wikimyei/representation/encoding/vicreg/stream/representation_embedding_cache.h"
 
 namespace cuwacunu::wikimyei::representation::encoding::vicreg::stream {
 
@@ -32,50 +35,53 @@ inline double elapsed_millis(std::chrono::steady_clock::time_point begin,
   return std::chrono::duration<double, std::milli>(end - begin).count();
 }
 
-inline double bool_fraction_or_nan(const torch::Tensor &mask) {
+// The runtime-report summaries below stay on the encoder device and return an
+// undefined tensor when there is nothing to summarize; a summary with no valid
+// rows evaluates to NaN. The caller materializes them in one host transfer.
+inline torch::Tensor bool_fraction_tensor(const torch::Tensor &mask) {
   if (!mask.defined() || mask.numel() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
-  return mask.to(torch::kFloat64).mean().to(torch::kCPU).item<double>();
+  return mask.to(torch::kFloat64).mean();
 }
 
-inline double tensor_mean_or_nan(const torch::Tensor &tensor) {
+inline torch::Tensor tensor_mean_tensor(const torch::Tensor &tensor) {
   if (!tensor.defined() || tensor.numel() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
-  return tensor.detach()
-      .to(torch::kCPU)
-      .to(torch::kFloat64)
-      .mean()
-      .item<double>();
+  return tensor.detach().to(torch::kFloat64).mean();
 }
 
-inline double reducer_weight_entropy_or_nan(const torch::Tensor &weights,
-                                            const torch::Tensor &mask) {
+inline torch::Tensor masked_mean_tensor(const torch::Tensor &values,
+                                        const torch::Tensor &valid) {
+  const auto values64 = values.to(torch::kFloat64);
+  return torch::where(valid, values64, torch::zeros_like(values64)).sum() /
+         valid.sum().to(torch::kFloat64);
+}
+
+inline torch::Tensor reducer_weight_entropy_tensor(const torch::Tensor &weights,
+                                                   const torch::Tensor &mask) {
   if (!weights.defined() || !mask.defined() || weights.numel() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
   auto mask_bool = mask.to(
       torch::TensorOptions().dtype(torch::kBool).device(weights.device()));
   auto w = weights.masked_fill(mask_bool.logical_not(), 0.0);
   auto entropy = -(w * w.clamp_min(1e-12).log()).sum(/*dim=*/-1);
   auto valid = mask_bool.any(/*dim=*/-1);
-  if (valid.sum().item<int64_t>() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
-  }
-  return entropy.masked_select(valid).mean().to(torch::kCPU).item<double>();
+  return masked_mean_tensor(entropy, valid);
 }
 
-inline double
-reducer_last_valid_weight_mean_or_nan(const torch::Tensor &weights,
+inline torch::Tensor
+reducer_last_valid_weight_mean_tensor(const torch::Tensor &weights,
                                       const torch::Tensor &mask) {
   if (!weights.defined() || !mask.defined() || weights.numel() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
   auto mask_bool = mask.to(
       torch::TensorOptions().dtype(torch::kBool).device(weights.device()));
   if (mask_bool.sizes() != weights.sizes()) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return torch::Tensor{};
   }
   const auto history_length = weights.size(-1);
   std::vector<int64_t> index_shape(static_cast<std::size_t>(weights.dim()), 1);
@@ -89,16 +95,10 @@ reducer_last_valid_weight_mean_or_nan(const torch::Tensor &weights,
   auto last_plus_one = std::get<0>(
       (mask_bool.to(torch::kInt64) * (index_grid + 1)).max(/*dim=*/-1));
   auto valid = last_plus_one > 0;
-  if (valid.sum().item<int64_t>() == 0) {
-    return std::numeric_limits<double>::quiet_NaN();
-  }
   auto last_index = (last_plus_one - 1).clamp_min(0);
   auto last_valid_weight =
       weights.gather(/*dim=*/-1, last_index.unsqueeze(-1)).squeeze(-1);
-  return last_valid_weight.masked_select(valid)
-      .mean()
-      .to(torch::kCPU)
-      .item<double>();
+  return masked_mean_tensor(last_valid_weight, valid);
 }
 
 inline void append_finite_double(lls::runtime_lls_document_t &document,
@@ -131,6 +131,24 @@ inline void move_encoder_input_tensors_for_encoder(EncoderT &encoder,
   }
 }
 
+// Dtype/device the encoder input would be moved to; a cache lookup uses
+// these before the input is built so that a hit skips the transfer.
+template <typename EncoderT>
+[[nodiscard]] torch::TensorOptions
+encoder_input_options(EncoderT &encoder, const torch::Tensor &features) {
+  if constexpr (requires(EncoderT e) { e->options(); }) {
+    return torch::TensorOptions()
+        .dtype(encoder->options().dtype)
+        .device(encoder->options().device);
+  } else if constexpr (requires(EncoderT e) { e.options(); }) {
+    return torch::TensorOptions()
+        .dtype(encoder.options().dtype)
+        .device(encoder.options().device);
+  } else {
+    return features.options();
+  }
+}
+
 template <typename EncoderT>
 [[nodiscard]] channel_preserving_encoder_output_t
 encode_channel_rows(EncoderT &encoder, const torch::Tensor &data,
@@ -223,21 +241,22 @@ template <typename KeyT>
       "detach_to_cpu", detach_to_cpu));
   append_finite_double(document, "valid_feature_fraction",
                        input.diagnostics.valid_feature_fraction, "[0,1]");
-  append_finite_double(document, "node_encoding_mask_fraction",
-                       bool_fraction_or_nan(node_encoding_mask), "[0,1]");
-  append_finite_double(document, "per_channel_mask_fraction",
-                       bool_fraction_or_nan(node_encoding_mask), "[0,1]");
-  append_finite_double(document, "node_encoding_mean",
-                       tensor_mean_or_nan(node_encoding));
   const auto graph_cell_mask =
       reshape_channel_mask(input.cell_mask_all, make_graph_row_index(input));
-  append_finite_double(
-      document, "reducer_weight_entropy",
-      reducer_weight_entropy_or_nan(reducer_weights, graph_cell_mask));
-  append_finite_double(
-      document, "reducer_last_valid_weight_mean",
-      reducer_last_valid_weight_mean_or_nan(reducer_weights, graph_cell_mask),
-      "[0,1]");
+  const auto summaries = cuwacunu::piaabo::tensor::torch::materialize_scalars({
+      bool_fraction_tensor(node_encoding_mask),
+      tensor_mean_tensor(node_encoding),
+      reducer_weight_entropy_tensor(reducer_weights, graph_cell_mask),
+      reducer_last_valid_weight_mean_tensor(reducer_weights, graph_cell_mask),
+  });
+  append_finite_double(document, "node_encoding_mask_fraction", summaries[0],
+                       "[0,1]");
+  append_finite_double(document, "per_channel_mask_fraction", summaries[0],
+                       "[0,1]");
+  append_finite_double(document, "node_encoding_mean", summaries[1]);
+  append_finite_double(document, "reducer_weight_entropy", summaries[2]);
+  append_finite_double(document, "reducer_last_valid_weight_mean",
+                       summaries[3], "[0,1]");
   return lls::emit_component_runtime_lls_canonical(document);
 }
 
@@ -259,14 +278,47 @@ make_channel_representation_stream_batch(
     std::string component_family_id = "wikimyei.representation.encoding.vicreg",
     std::string runtime_document_schema_id =
         "wikimyei.representation.vicreg.runtime.v1",
-    cuwacunu::kikijyeba::protocol::component_stream_wave_t stream_wave = {}) {
+    cuwacunu::kikijyeba::protocol::component_stream_wave_t stream_wave = {},
+    representation_embedding_cache_t *embedding_cache = nullptr) {
+  const auto begin = std::chrono::steady_clock::now();
+  channel_preserving_encoder_output_t encoded{};
+  std::string embedding_anchor_key{};
+  bool embedding_cache_hit = false;
+  if (embedding_cache != nullptr) {
+    TORCH_CHECK(lifted.node_features.defined(),
+                "[channel_node_stream_adapter] node_features is undefined");
+    const auto target = channel_representation_stream_detail::
+        encoder_input_options(encoder, lifted.node_features);
+    embedding_anchor_key = representation_embedding_anchor_key(lifted.cursor);
+    if (auto cached = embedding_cache->lookup(
+            embedding_anchor_key,
+            c10::typeMetaToScalarType(target.dtype()))) {
+      encoded = std::move(*cached);
+      if (!detach_to_cpu) {
+        encoded.reduced = encoded.reduced.to(target.device());
+        encoded.reduced_mask = encoded.reduced_mask.to(target.device());
+        if (encoded.reducer_weights.defined()) {
+          encoded.reducer_weights =
+              encoded.reducer_weights.to(target.device());
+        }
+      }
+      embedding_cache_hit = true;
+    }
+  }
+  // The input still carries the row index and diagnostics the batch reports;
+  // only a miss moves it to the encoder device.
   auto input =
       make_channel_node_encoder_input(lifted, require_finite_valid_features);
-  channel_representation_stream_detail::move_encoder_input_tensors_for_encoder(
-      encoder, input.data, input.feature_mask);
-  const auto begin = std::chrono::steady_clock::now();
-  auto encoded = channel_representation_stream_detail::encode_channel_rows(
-      encoder, input.data, input.feature_mask, detach_to_cpu);
+  if (!embedding_cache_hit) {
+    channel_representation_stream_detail::
+        move_encoder_input_tensors_for_encoder(encoder, input.data,
+                                               input.feature_mask);
+    encoded = channel_representation_stream_detail::encode_channel_rows(
+        encoder, input.data, input.feature_mask, detach_to_cpu);
+    if (embedding_cache != nullptr) {
+      embedding_cache->store(embedding_anchor_key, encoded);
+    }
+  }
   auto adapted = cuwacunu::wikimyei::representation::encoding::vicreg::
       make_channel_representation_batch(
           encoded.reduced, encoded.reduced_mask, make_graph_row_index(input),
@@ -389,7 +441,19 @@ public:
         *encoder_, lifted, require_finite_valid_features_, detach_to_cpu_,
         runtime_report_mode_, component_assembly_id_, assembly_token_,
         dock_binding_token_, component_family_id_, runtime_document_schema_id_,
-        stream_wave_);
+        stream_wave_, embedding_cache_.get());
+  }
+
+  // Serves encoder outputs from a frozen-representation embedding cache; the
+  // encoder only runs for anchor batches the cache has not seen yet.
+  void set_embedding_cache(
+      std::shared_ptr<representation_embedding_cache_t> embedding_cache) {
+    embedding_cache_ = std::move(embedding_cache);
+  }
+
+  [[nodiscard]] const std::shared_ptr<representation_embedding_cache_t> &
+  embedding_cache() const {
+    return embedding_cache_;
   }
 
 private:
@@ -407,6 +471,7 @@ private:
   std::string runtime_document_schema_id_{
       "wikimyei.representation.vicreg.runtime.v1"};
   cuwacunu::kikijyeba::protocol::component_stream_wave_t stream_wave_{};
+  std::shared_ptr<representation_embedding_cache_t> embedding_cache_{};
 };
 
 } // namespace
@@ -0,0 +1,493 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <torch/torch.h>
+
+#include "piaabo/digest/sha256.h"
+#include "piaabo/io/mapped_file.h"
+#include "ujcamei/source/retrieval/storage/memory_mapped/cache_freshness.h"
+#include "wikimyei/representation/encoding/vicreg/channel_preserving_encoder.h"
+
+namespace cuwacunu::wikimyei::representation::encoding::vicreg::stream {
+
+// Storage precision of cached frozen-representation embeddings. float32 shards
+// reproduce the encoder output bit for bit; float16 halves the footprint and
+// is widened back to the encoder dtype on read.
+enum class representation_embedding_cache_dtype_t { off, float32, float16 };
+
+[[nodiscard]] inline representation_embedding_cache_dtype_t
+parse_representation_embedding_cache_dtype(const std::string &value) {
+  if (value == "off") {
+    return representation_embedding_cache_dtype_t::off;
+  }
+  if (value == "float32" || value == "f32") {
+    return representation_embedding_cache_dtype_t::float32;
+  }
+  if (value == "float16" || value == "f16") {
+    return representation_embedding_cache_dtype_t::float16;
+  }
+  throw std::runtime_error(
+      "[representation_embedding_cache] invalid cache dtype: " + value +
+      " (expected off|float32|float16)");
+}
+
+[[nodiscard]] inline const char *representation_embedding_cache_dtype_token(
+    representation_embedding_cache_dtype_t dtype) {
+  switch (dtype) {
+  case representation_embedding_cache_dtype_t::off:
+    return "off";
+  case representation_embedding_cache_dtype_t::float32:
+    return "float32";
+  case representation_embedding_cache_dtype_t::float16:
+    return "float16";
+  }
+  return "off";
+}
+
+// Everything that decides what a frozen encoder emits for a given anchor
+// batch. The canonical text is hashed into the cache namespace directory, so
+// changing the checkpoint, the source range, the source caches, the NodeLift
+// config or the assembly never reuses old shards.
+struct representation_embedding_cache_identity_t {
+  std::string representation_checkpoint_digest{};
+  std::string source_cursor_token{};
+  // representation_source_cache_fingerprint() of the mapped source caches.
+  std::string source_cache_fingerprint{};
+  // Digest of the NodeLift spec that lifts source rows into encoder input.
+  std::string lift_config_digest{};
+  std::string graph_order_fingerprint{};
+  std::string component_assembly_id{};
+  std::string assembly_token{};
+  std::string dock_binding_token{};
+  representation_embedding_cache_dtype_t dtype{
+      representation_embedding_cache_dtype_t::float32};
+
+  [[nodiscard]] std::string canonical_text() const {
+    std::ostringstream out;
+    out << "schema=wikimyei.representation.embedding_cache.v2\n";
+    out << "representation_checkpoint_digest="
+        << representation_checkpoint_digest << "\n";
+    out << "source_cursor_token=" << source_cursor_token << "\n";
+    out << "source_cache_fingerprint=" << source_cache_fingerprint << "\n";
+    out << "lift_config_digest=" << lift_config_digest << "\n";
+    out << "graph_order_fingerprint=" << graph_order_fingerprint << "\n";
+    out << "component_assembly_id=" << component_assembly_id << "\n";
+    out << "assembly_token=" << assembly_token << "\n";
+    out << "dock_binding_token=" << dock_binding_token << "\n";
+    out << "dtype=" << representation_embedding_cache_dtype_token(dtype)
+        << "\n";
+    return out.str();
+  }
+
+  [[nodiscard]] std::string namespace_digest() const {
+    return cuwacunu::piaabo::digest::sha256_hex(canonical_text());
+  }
+};
+
+namespace representation_embedding_cache_detail {
+
+inline constexpr std::array<char, 8> kShardMagic{'C', 'W', 'R', 'E',
+                                                 'M', 'B', '0', '1'};
+inline constexpr std::uint32_t kShardVersion = 1;
+inline constexpr std::size_t kTensorSlots = 3;
+inline constexpr std::size_t kMaxDims = 8;
+inline constexpr std::uint64_t kDataAlignment = 64;
+
+enum class stored_dtype_t : std::uint8_t {
+  float32 = 0,
+  float16 = 1,
+  bool8 = 2,
+};
+
+struct tensor_record_t {
+  std::uint8_t present{0};
+  std::uint8_t dtype{0};
+  std::uint8_t ndim{0};
+  std::array<std::uint8_t, 5> reserved{};
+  std::array<std::int64_t, kMaxDims> sizes{};
+  std::uint64_t offset{0};
+  std::uint64_t nbytes{0};
+};
+
+struct shard_header_t {
+  std::array<char, 8> magic{kShardMagic};
+  std::uint32_t version{kShardVersion};
+  std::uint32_t tensor_count{static_cast<std::uint32_t>(kTensorSlots)};
+  std::array<char, 64> anchor_key_digest{};
+  std::array<tensor_record_t, kTensorSlots> tensors{};
+};
+
+[[nodiscard]] inline torch::Dtype torch_dtype(stored_dtype_t dtype) {
+  switch (dtype) {
+  case stored_dtype_t::float32:
+    return torch::kFloat32;
+  case stored_dtype_t::float16:
+    return torch::kFloat16;
+  case stored_dtype_t::bool8:
+    return torch::kBool;
+  }
+  return torch::kFloat32;
+}
+
+[[nodiscard]] inline std::uint64_t align_up(std::uint64_t value) {
+  return (value + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+// Shards are mapped copy-on-write, so consumers may write the returned
+// tensors without touching the cache.
+using mapped_shard_t = cuwacunu::piaabo::io::mapped_file_t;
+
+[[nodiscard]] inline std::optional<torch::Tensor>
+view_tensor(const std::shared_ptr<mapped_shard_t> &shard,
+            const tensor_record_t &record) {
+  if (record.present == 0) {
+    return torch::Tensor{};
+  }
+  if (record.dtype > static_cast<std::uint8_t>(stored_dtype_t::bool8) ||
+      record.ndim > kMaxDims || record.offset % kDataAlignment != 0 ||
+      record.offset > shard->size() ||
+      record.nbytes > shard->size() - record.offset) {
+    return std::nullopt;
+  }
+  const auto dtype = torch_dtype(static_cast<stored_dtype_t>(record.dtype));
+  std::vector<int64_t> sizes(record.sizes.begin(),
+                             record.sizes.begin() + record.ndim);
+  int64_t numel = 1;
+  for (const auto size : sizes) {
+    if (size < 0) {
+      return std::nullopt;
+    }
+    numel *= size;
+  }
+  if (static_cast<std::uint64_t>(numel) *
+          static_cast<std::uint64_t>(c10::elementSize(dtype)) !=
+      record.nbytes) {
+    return std::nullopt;
+  }
+  auto keep_alive = shard;
+  return torch::from_blob(
+      shard->data() + record.offset, sizes,
+      [keep_alive](void *) mutable { keep_alive.reset(); },
+      torch::TensorOptions().dtype(dtype).device(torch::kCPU));
+}
+
+} // namespace representation_embedding_cache_detail
+
+// Content-addressed, memory-mapped store of frozen encoder outputs. One shard
+// per anchor batch lives under `<root>/<identity digest>/`; a shard is only
+// trusted while it is strictly newer than the representation checkpoint and
+// every source cache it was computed from, mirroring the raw/normalized
+// cache-chain freshness rule.
+class representation_embedding_cache_t {
+public:
+  representation_embedding_cache_t(
+      std::filesystem::path root,
+      representation_embedding_cache_identity_t identity,
+      std::filesystem::path representation_checkpoint_path,
+      std::vector<std::filesystem::path> source_cache_paths = {})
+      : identity_(std::move(identity)),
+        representation_checkpoint_path_(
+            std::move(representation_checkpoint_path)),
+        source_cache_paths_(std::move(source_cache_paths)) {
+    TORCH_CHECK(!root.empty(),
+                "[representation_embedding_cache] cache root is required");
+    TORCH_CHECK(identity_.dtype != representation_embedding_cache_dtype_t::off,
+                "[representation_embedding_cache] cache dtype must not be off");
+    TORCH_CHECK(!identity_.representation_checkpoint_digest.empty(),
+                "[representation_embedding_cache] frozen representation "
+                "checkpoint digest is required");
+    namespace_dir_ = root / identity_.namespace_digest();
+    std::filesystem::create_directories(namespace_dir_);
+    const auto identity_path = namespace_dir_ / "identity.txt";
+    const auto expected = identity_.canonical_text();
+    if (std::filesystem::exists(identity_path)) {
+      std::ifstream in(identity_path, std::ios::binary);
+      const std::string found((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+      TORCH_CHECK(found == expected,
+                  "[representation_embedding_cache] identity mismatch in ",
+                  namespace_dir_.string());
+    } else {
+      write_file_atomically(identity_path, expected.data(), expected.size());
+    }
+  }
+
+  [[nodiscard]] const std::filesystem::path &namespace_dir() const {
+    return namespace_dir_;
+  }
+  [[nodiscard]] const representation_embedding_cache_identity_t &
+  identity() const {
+    return identity_;
+  }
+  [[nodiscard]] int64_t hits() const { return hits_; }
+  [[nodiscard]] int64_t misses() const { return misses_; }
+  [[nodiscard]] int64_t writes() const { return writes_; }
+
+  [[nodiscard]] std::filesystem::path
+  shard_path(const std::string &anchor_key) const {
+    return namespace_dir_ /
+           (cuwacunu::piaabo::digest::sha256_hex(anchor_key) + ".emb");
+  }
+
+  // Returns the cached reduced/reduced_mask/reducer_weights for the anchor
+  // batch as CPU tensors backed by the mapped shard, or nullopt on a miss or
+  // a stale/corrupt shard. float16 shards are widened to `dtype`.
+  [[nodiscard]] std::optional<channel_preserving_encoder_output_t>
+  lookup(const std::string &anchor_key, torch::Dtype dtype) {
+    namespace detail = representation_embedding_cache_detail;
+    const auto path = shard_path(anchor_key);
+    if (!shard_is_fresh(path)) {
+      ++misses_;
+      return std::nullopt;
+    }
+    std::shared_ptr<detail::mapped_shard_t> shard;
+    try {
+      shard = std::make_shared<detail::mapped_shard_t>(path);
+    } catch (const std::exception &) {
+      ++misses_;
+      return std::nullopt;
+    }
+    if (shard->size() < sizeof(detail::shard_header_t)) {
+      ++misses_;
+      return std::nullopt;
+    }
+    detail::shard_header_t header{};
+    std::memcpy(&header, shard->data(), sizeof(header));
+    const auto key_digest = cuwacunu::piaabo::digest::sha256_hex(anchor_key);
+    if (header.magic != detail::kShardMagic ||
+        header.version != detail::kShardVersion ||
+        header.tensor_count != detail::kTensorSlots ||
+        std::string(header.anchor_key_digest.data(),
+                    header.anchor_key_digest.size()) != key_digest) {
+      ++misses_;
+      return std::nullopt;
+    }
+    std::array<torch::Tensor, detail::kTensorSlots> views{};
+    for (std::size_t i = 0; i < detail::kTensorSlots; ++i) {
+      auto view = detail::view_tensor(shard, header.tensors[i]);
+      if (!view.has_value()) {
+        ++misses_;
+        return std::nullopt;
+      }
+      views[i] = std::move(*view);
+    }
+    if (!views[0].defined() || !views[1].defined()) {
+      ++misses_;
+      return std::nullopt;
+    }
+    channel_preserving_encoder_output_t out{};
+    out.reduced = views[0].to(dtype);
+    out.reduced_mask = views[1];
+    if (views[2].defined()) {
+      out.reducer_weights = views[2].to(dtype);
+    }
+    ++hits_;
+    return out;
+  }
+
+  void store(const std::string &anchor_key,
+             const channel_preserving_encoder_output_t &encoded) {
+    namespace detail = representation_embedding_cache_detail;
+    TORCH_CHECK(encoded.reduced.defined() && encoded.reduced_mask.defined(),
+                "[representation_embedding_cache] encoder output must define "
+                "reduced and reduced_mask");
+    const auto value_dtype =
+        identity_.dtype == representation_embedding_cache_dtype_t::float16
+            ? detail::stored_dtype_t::float16
+            : detail::stored_dtype_t::float32;
+    const std::array<std::pair<torch::Tensor, detail::stored_dtype_t>,
+                     detail::kTensorSlots>
+        slots{{{encoded.reduced, value_dtype},
+               {encoded.reduced_mask, detail::stored_dtype_t::bool8},
+               {encoded.reducer_weights, value_dtype}}};
+
+    detail::shard_header_t header{};
+    const auto key_digest = cuwacunu::piaabo::digest::sha256_hex(anchor_key);
+    std::memcpy(header.anchor_key_digest.data(), key_digest.data(),
+                header.anchor_key_digest.size());
+    std::array<torch::Tensor, detail::kTensorSlots> host{};
+    std::uint64_t cursor = detail::align_up(sizeof(detail::shard_header_t));
+    for (std::size_t i = 0; i < detail::kTensorSlots; ++i) {
+      const auto &[tensor, stored] = slots[i];
+      auto &record = header.tensors[i];
+      if (!tensor.defined()) {
+        continue;
+      }
+      TORCH_CHECK(tensor.dim() <= static_cast<int64_t>(detail::kMaxDims),
+                  "[representation_embedding_cache] tensor rank exceeds ",
+                  detail::kMaxDims);
+      host[i] = tensor.detach()
+                    .to(torch::kCPU)
+                    .to(detail::torch_dtype(stored))
+                    .contiguous();
+      record.present = 1;
+      record.dtype = static_cast<std::uint8_t>(stored);
+      record.ndim = static_cast<std::uint8_t>(host[i].dim());
+      for (int64_t d = 0; d < host[i].dim(); ++d) {
+        record.sizes[static_cast<std::size_t>(d)] = host[i].size(d);
+      }
+      record.offset = cursor;
+      record.nbytes = static_cast<std::uint64_t>(host[i].nbytes());
+      cursor = detail::align_up(cursor + record.nbytes);
+    }
+
+    std::vector<char> bytes(static_cast<std::size_t>(cursor), 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (std::size_t i = 0; i < detail::kTensorSlots; ++i) {
+      if (host[i].defined() && header.tensors[i].nbytes > 0) {
+        std::memcpy(bytes.data() + header.tensors[i].offset,
+                    host[i].data_ptr(), header.tensors[i].nbytes);
+      }
+    }
+    write_file_atomically(shard_path(anchor_key), bytes.data(), bytes.size());
+    ++writes_;
+  }
+
+private:
+  [[nodiscard]] bool shard_is_fresh(const std::filesystem::path &path) const {
+    namespace storage =
+        cuwacunu::ujcamei::source::retrieval::storage::memory_mapped;
+    if (!storage::cache_file_is_strictly_newer(
+            path, representation_checkpoint_path_)) {
+      return false;
+    }
+    for (const auto &source : source_cache_paths_) {
+      if (!storage::cache_file_is_strictly_newer(path, source)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Shards may be written by several threads and processes sharing the
+  // namespace, so the temp name is unique per writer; the file and its
+  // directory are fsynced so a published shard survives a crash.
+  static void write_file_atomically(const std::filesystem::path &path,
+                                    const char *data, std::size_t size) {
+    static std::atomic<uint64_t> sequence{0};
+    auto tmp = path;
+    tmp += ".tmp." + std::to_string(::getpid()) + "." +
+           std::to_string(sequence.fetch_add(1, std::memory_order_relaxed));
+    const int fd =
+        ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_TRUNC, 0644);
+    TORCH_CHECK(fd >= 0, "[representation_embedding_cache] could not open ",
+                tmp.string(), ": ", std::strerror(errno));
+    const auto fail = [&](const char *what) {
+      const std::string reason = std::strerror(errno);
+      ::close(fd);
+      ::unlink(tmp.c_str());
+      TORCH_CHECK(false, "[representation_embedding_cache] could not ", what,
+                  " ", tmp.string(), ": ", reason);
+    };
+    std::size_t offset = 0;
+    while (offset < size) {
+      const ::ssize_t n = ::write(fd, data + offset, size - offset);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        fail("write");
+      }
+      offset += static_cast<std::size_t>(n);
+    }
+    if (::fsync(fd) != 0) {
+      fail("fsync");
+    }
+    ::close(fd);
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      ::unlink(tmp.c_str());
+      TORCH_CHECK(false, "[representation_embedding_cache] could not "
+                         "publish ",
+                  path.string(), ": ", ec.message());
+    }
+    const auto parent = path.has_parent_path() ? path.parent_path()
+                                               : std::filesystem::path(".");
+    const int dir_fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+      (void)::fsync(dir_fd);
+      ::close(dir_fd);
+    }
+  }
+
+  representation_embedding_cache_identity_t identity_{};
+  std::filesystem::path representation_checkpoint_path_{};
+  std::vector<std::filesystem::path> source_cache_paths_{};
+  std::filesystem::path namespace_dir_{};
+  int64_t hits_{0};
+  int64_t misses_{0};
+  int64_t writes_{0};
+};
+
+// Anchor key of one lifted batch: the batch cursor token plus every anchor
+// key and index, so two batches only share a shard when they cover the same
+// anchors.
+template <typename CursorT>
+[[nodiscard]] std::string
+representation_embedding_anchor_key(const CursorT &cursor) {
+  std::ostringstream out;
+  out << cursor.cursor_token() << "|keys=";
+  for (std::size_t i = 0; i < cursor.anchor_keys.size(); ++i) {
+    out << (i == 0 ? "" : ",") << cursor.anchor_keys[i];
+  }
+  out << "|indices=";
+  for (std::size_t i = 0; i < cursor.anchor_indices.size(); ++i) {
+    out << (i == 0 ? "" : ",") << cursor.anchor_indices[i];
+  }
+  return out.str();
+}
+
+// Digest of the representation checkpoint bytes; the frozen encoder's weights
+// are what the cache namespace is keyed on.
+[[nodiscard]] inline std::string
+representation_checkpoint_file_digest(const std::filesystem::path &path) {
+  TORCH_CHECK(std::filesystem::is_regular_file(path),
+              "[representation_embedding_cache] could not read checkpoint ",
+              path.string());
+  return cuwacunu::piaabo::digest::sha256_file_hex(path);
+}
+
+// Freshness fingerprint of the source caches an encoder reads: path, size and
+// write time of each file. The normalized cache names carry their
+// normalization policy, and any rebuild of a raw or normalized cache rewrites
+// the mapped file, so either lands in a new cache namespace.
+[[nodiscard]] inline std::string representation_source_cache_fingerprint(
+    const std::vector<std::filesystem::path> &paths) {
+  std::ostringstream out;
+  for (const auto &path : paths) {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    const auto time =
+        error ? std::filesystem::file_time_type{}
+              : std::filesystem::last_write_time(path, error);
+    TORCH_CHECK(!error,
+                "[representation_embedding_cache] could not stat source cache ",
+                path.string());
+    out << path.string() << "|" << size << "|"
+        << time.time_since_epoch().count() << "\n";
+  }
+  return cuwacunu::piaabo::digest::sha256_hex(out.str());
+}
+
+} // namespace cuwacunu::wikimyei::representation::encoding::vicreg::stream
@@ -3,12 +3,49 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
+
 namespace cuwacunu::wikimyei::representation::encoding::vicreg {
 
+// masked: one weighted reduction over [C,N,De], no host synchronization.
+// gather: nonzero/index_select per channel; kept as the parity reference.
+enum class vicreg_loss_impl_t {
+  masked,
+  gather,
+};
+
+[[nodiscard]] inline vicreg_loss_impl_t
+parse_vicreg_loss_impl(const std::string &value) {
+  if (value == "masked") {
+    return vicreg_loss_impl_t::masked;
+  }
+  if (value == "gather") {
+    return vicreg_loss_impl_t::gather;
+  }
+  throw std::runtime_error("[vicreg_loss] invalid loss impl: " + value +
+                           " (expected masked|gather)");
+}
+
+[[nodiscard]] inline const char *
+vicreg_loss_impl_token(vicreg_loss_impl_t impl) {
+  switch (impl) {
+  case vicreg_loss_impl_t::masked:
+    return "masked";
+  case vicreg_loss_impl_t::gather:
+    return "gather";
+  }
+  return "masked";
+}
+
 struct vicreg_loss_options_t {
+  vicreg_loss_impl_t impl{vicreg_loss_impl_t::masked};
   double invariance_weight{25.0};
   double variance_weight{25.0};
   double covariance_weight{1.0};
@@ -32,7 +69,7 @@ struct vicreg_loss_result_t {
   torch::Tensor per_channel_covariance_loss{}; // [C]
   torch::Tensor per_channel_norm_mean{};       // [C]
   torch::Tensor cross_channel_similarity{};    // [C,C]
-  int64_t valid_rows{0};
+  torch::Tensor valid_rows{};                  // [], int64
 };
 
 namespace vicreg_loss_detail {
@@ -102,31 +139,198 @@ inline torch::Tensor mean_or_zero(const torch::Tensor &rows, int64_t dim,
   return rows.mean(/*dim=*/0);
 }
 
-} // namespace vicreg_loss_detail
-
-[[nodiscard]] inline vicreg_loss_result_t
-compute_vicreg_loss(const torch::Tensor &z1, const torch::Tensor &mask1,
-                    const torch::Tensor &z2, const torch::Tensor &mask2,
-                    const vicreg_loss_options_t &options = {}) {
+inline void check_pair_shapes(const torch::Tensor &z1,
+                              const torch::Tensor &mask1,
+                              const torch::Tensor &z2,
+                              const torch::Tensor &mask2) {
   TORCH_CHECK(z1.sizes() == z2.sizes(), "[vicreg_loss] z1/z2 shape mismatch");
   TORCH_CHECK(mask1.sizes() == mask2.sizes(),
               "[vicreg_loss] mask1/mask2 shape mismatch");
+}
+
+// Rearranges z [M,C,Hx,De] or [M,C,De] into [C,N,De] and the mask into
+// [C,N] so every channel is one group of a single batched reduction.
+inline std::pair<torch::Tensor, torch::Tensor>
+channel_groups(const torch::Tensor &z, const torch::Tensor &mask) {
+  TORCH_CHECK(z.defined(), "[vicreg_loss] z is undefined");
+  TORCH_CHECK(mask.defined(), "[vicreg_loss] mask is undefined");
+  if (z.dim() == 4) {
+    TORCH_CHECK(mask.dim() == 3,
+                "[vicreg_loss] rank-4 z requires [M,C,Hx] mask");
+    TORCH_CHECK(z.size(0) == mask.size(0) && z.size(1) == mask.size(1) &&
+                    z.size(2) == mask.size(2),
+                "[vicreg_loss] z/mask shape mismatch");
+  } else if (z.dim() == 3) {
+    TORCH_CHECK(mask.dim() == 2, "[vicreg_loss] rank-3 z requires [M,C] mask");
+    TORCH_CHECK(z.size(0) == mask.size(0) && z.size(1) == mask.size(1),
+                "[vicreg_loss] z/mask shape mismatch");
+  } else {
+    TORCH_CHECK(false, "[vicreg_loss] z must be [M,C,Hx,De] or [M,C,De]");
+  }
+  const int64_t C = z.size(1);
+  const int64_t De = z.size(z.dim() - 1);
+  auto grouped = z.transpose(0, 1).reshape({C, -1, De});
+  auto grouped_mask = mask.to(torch::kBool).transpose(0, 1).reshape({C, -1});
+  return {grouped, grouped_mask};
+}
+
+struct masked_group_terms_t {
+  torch::Tensor count{};      // [G], int64
+  torch::Tensor invariance{}; // [G]
+  torch::Tensor variance{};   // [G]
+  torch::Tensor covariance{}; // [G]
+  torch::Tensor norm_mean{};  // [G], over z1 rows
+  torch::Tensor mean1{};      // [G,De], zero for empty groups
+};
+
+// Weighted per-group moments of z1/z2 [G,N,De] under mask [G,N]. Matches the
+// gather path term by term: empty groups report zeros, covariance needs at
+// least two rows and two dims, and variance is the biased estimator.
+inline masked_group_terms_t masked_group_terms(const torch::Tensor &z1,
+                                               const torch::Tensor &z2,
+                                               const torch::Tensor &mask,
+                                               double floor, double eps) {
+  const int64_t De = z1.size(2);
+  const auto weight = mask.to(z1.dtype()).unsqueeze(-1); // [G,N,1]
+  const auto keep = mask.unsqueeze(-1);
+  const auto zero = torch::zeros({}, z1.options());
+  const auto x1 = torch::where(keep, z1, zero);
+  const auto x2 = torch::where(keep, z2, zero);
+
+  masked_group_terms_t out{};
+  out.count = mask.sum(/*dim=*/1); // [G]
+  const auto rows = out.count.to(z1.dtype());
+  const auto has_rows = out.count.gt(0);
+  const auto rows_safe = rows.clamp_min(1.0);
+
+  out.invariance = (x1 - x2).pow(2).sum({1, 2}) / (rows_safe * De);
+  out.invariance = torch::where(has_rows, out.invariance, zero);
+
+  const auto mean1 = x1.sum(/*dim=*/1) / rows_safe.unsqueeze(-1); // [G,De]
+  const auto mean2 = x2.sum(/*dim=*/1) / rows_safe.unsqueeze(-1);
+  const auto centered1 = (x1 - mean1.unsqueeze(1)) * weight;
+  const auto centered2 = (x2 - mean2.unsqueeze(1)) * weight;
+
+  const auto variance_of = [&](const torch::Tensor &centered) {
+    auto var = centered.pow(2).sum(/*dim=*/1) / rows_safe.unsqueeze(-1);
+    auto std = torch::sqrt(var + eps);
+    return torch::relu(floor - std).mean(/*dim=*/1);
+  };
+  out.variance = 0.5 * (variance_of(centered1) + variance_of(centered2));
+  out.variance = torch::where(has_rows, out.variance, zero);
+
+  if (De > 1) {
+    const auto denom = (rows - 1.0).clamp_min(1.0).view({-1, 1, 1});
+    const auto off_diag = 1.0 - torch::eye(De, z1.options());
+    const auto covariance_of = [&](const torch::Tensor &centered) {
+      auto cov = centered.transpose(1, 2).matmul(centered) / denom;
+      return (cov * off_diag).pow(2).sum({1, 2}) / static_cast<double>(De);
+    };
+    out.covariance =
+        0.5 * (covariance_of(centered1) + covariance_of(centered2));
+    out.covariance = torch::where(out.count.gt(1), out.covariance, zero);
+  } else {
+    out.covariance = torch::zeros({z1.size(0)}, z1.options());
+  }
+
+  const auto norms = x1.norm(2, /*dim=*/2); // [G,N]
+  out.norm_mean = (norms * mask.to(z1.dtype())).sum(/*dim=*/1) / rows_safe;
+  out.norm_mean = torch::where(has_rows, out.norm_mean, zero);
+  out.mean1 = mean1;
+  return out;
+}
+
+inline void finish_vicreg_loss(vicreg_loss_result_t &out,
+                               const torch::Tensor &per_channel_means,
+                               const vicreg_loss_options_t &options,
+                               const torch::TensorOptions &value_options) {
+  auto valid_channel = out.per_channel_valid_rows.to(torch::kBool)
+                           .to(value_options.device());
+  auto valid_channel_weight = valid_channel.to(value_options.dtype());
+  auto valid_channel_count = valid_channel_weight.sum().clamp_min(1.0);
+  out.invariance_loss =
+      (out.per_channel_invariance_loss * valid_channel_weight).sum() /
+      valid_channel_count;
+  out.variance_loss =
+      (out.per_channel_variance_loss * valid_channel_weight).sum() /
+      valid_channel_count;
+  out.covariance_loss =
+      (out.per_channel_covariance_loss * valid_channel_weight).sum() /
+      valid_channel_count;
+  auto primary_loss = options.invariance_weight * out.invariance_loss +
+                      options.variance_weight * out.variance_loss +
+                      options.covariance_weight * out.covariance_loss;
+  out.loss = primary_loss + options.global_aux_weight * out.global_loss;
+  auto denom =
+      per_channel_means.norm(2, /*dim=*/1, /*keepdim=*/true).clamp_min(1e-12);
+  auto normalized = per_channel_means / denom;
+  out.cross_channel_similarity = normalized.matmul(normalized.transpose(0, 1));
+}
+
+} // namespace vicreg_loss_detail
+
+// Fused formulation: every channel is a group of one weighted reduction over
+// [C,N,De], so the loss never synchronizes with the host regardless of C.
+[[nodiscard]] inline vicreg_loss_result_t
+compute_vicreg_loss_masked(const torch::Tensor &z1, const torch::Tensor &mask1,
+                           const torch::Tensor &z2, const torch::Tensor &mask2,
+                           const vicreg_loss_options_t &options = {}) {
+  vicreg_loss_detail::check_pair_shapes(z1, mask1, z2, mask2);
+  auto joint_mask = mask1.to(torch::kBool).logical_and(mask2.to(torch::kBool));
+  auto [g1, gmask] = vicreg_loss_detail::channel_groups(z1, joint_mask);
+  auto g2 = vicreg_loss_detail::channel_groups(z2, joint_mask).first;
+  const int64_t De = g1.size(2);
+
+  const auto channel = vicreg_loss_detail::masked_group_terms(
+      g1, g2, gmask, options.variance_floor, options.eps);
+  const auto global = vicreg_loss_detail::masked_group_terms(
+      g1.reshape({1, -1, De}), g2.reshape({1, -1, De}), gmask.reshape({1, -1}),
+      options.variance_floor, options.eps);
+
+  vicreg_loss_result_t out{};
+  out.valid_rows = global.count.reshape({});
+  out.global_invariance_loss = global.invariance.reshape({});
+  out.global_variance_loss = global.variance.reshape({});
+  out.global_covariance_loss = global.covariance.reshape({});
+  out.global_loss = options.invariance_weight * out.global_invariance_loss +
+                    options.variance_weight * out.global_variance_loss +
+                    options.covariance_weight * out.global_covariance_loss;
+  out.per_channel_valid_rows = channel.count;
+  out.per_channel_invariance_loss = channel.invariance;
+  out.per_channel_variance_loss = channel.variance;
+  out.per_channel_covariance_loss = channel.covariance;
+  out.per_channel_norm_mean = channel.norm_mean;
+  vicreg_loss_detail::finish_vicreg_loss(out, channel.mean1, options,
+                                         z1.options());
+  return out;
+}
+
+// Reference formulation: gathers valid rows with nonzero/index_select, once
+// globally and once per channel. Each gather synchronizes with the host.
+[[nodiscard]] inline vicreg_loss_result_t
+compute_vicreg_loss_gather(const torch::Tensor &z1, const torch::Tensor &mask1,
+                           const torch::Tensor &z2, const torch::Tensor &mask2,
+                           const vicreg_loss_options_t &options = {}) {
+  vicreg_loss_detail::check_pair_shapes(z1, mask1, z2, mask2);
   auto joint_mask = mask1.to(torch::kBool).logical_and(mask2.to(torch::kBool));
   auto rows1 = vicreg_loss_detail::valid_rows(z1, joint_mask);
   auto rows2 = vicreg_loss_detail::valid_rows(z2, joint_mask);
   vicreg_loss_result_t out{};
-  out.valid_rows = std::min(rows1.size(0), rows2.size(0));
-  if (out.valid_rows <= 0) {
+  const int64_t valid_rows = std::min(rows1.size(0), rows2.size(0));
+  out.valid_rows = torch::full(
+      {}, valid_rows,
+      torch::TensorOptions().dtype(torch::kInt64).device(z1.device()));
+  if (valid_rows <= 0) {
     out.global_loss = torch::zeros({}, z1.options());
     out.global_invariance_loss = torch::zeros({}, z1.options());
     out.global_variance_loss = torch::zeros({}, z1.options());
     out.global_covariance_loss = torch::zeros({}, z1.options());
   } else {
-    if (rows1.size(0) != out.valid_rows) {
-      rows1 = rows1.narrow(0, 0, out.valid_rows);
+    if (rows1.size(0) != valid_rows) {
+      rows1 = rows1.narrow(0, 0, valid_rows);
     }
-    if (rows2.size(0) != out.valid_rows) {
-      rows2 = rows2.narrow(0, 0, out.valid_rows);
+    if (rows2.size(0) != valid_rows) {
+      rows2 = rows2.narrow(0, 0, valid_rows);
     }
     out.global_invariance_loss = torch::mse_loss(rows1, rows2);
     out.global_variance_loss =
@@ -190,28 +394,28 @@ compute_vicreg_loss(const torch::Tensor &z1, const torch::Tensor &mask1,
   out.per_channel_variance_loss = torch::stack(var_terms);
   out.per_channel_covariance_loss = torch::stack(cov_terms);
   out.per_channel_norm_mean = torch::stack(norm_terms);
-  auto valid_channel =
-      out.per_channel_valid_rows.to(torch::kBool).to(z1.device());
-  auto valid_channel_weight = valid_channel.to(z1.dtype());
-  auto valid_channel_count = valid_channel_weight.sum().clamp_min(1.0);
-  out.invariance_loss =
-      (out.per_channel_invariance_loss * valid_channel_weight).sum() /
-      valid_channel_count;
-  out.variance_loss =
-      (out.per_channel_variance_loss * valid_channel_weight).sum() /
-      valid_channel_count;
-  out.covariance_loss =
-      (out.per_channel_covariance_loss * valid_channel_weight).sum() /
-      valid_channel_count;
-  auto primary_loss = options.invariance_weight * out.invariance_loss +
-                      options.variance_weight * out.variance_loss +
-                      options.covariance_weight * out.covariance_loss;
-  out.loss = primary_loss + options.global_aux_weight * out.global_loss;
-  auto means = torch::stack(mean_vectors); // [C,De]
-  auto denom = means.norm(2, /*dim=*/1, /*keepdim=*/true).clamp_min(1e-12);
-  auto normalized = means / denom;
-  out.cross_channel_similarity = normalized.matmul(normalized.transpose(0, 1));
+  vicreg_loss_detail::finish_vicreg_loss(out, torch::stack(mean_vectors),
+                                         options, z1.options());
   return out;
 }
 
+// Always evaluated in float32 (or the inputs' wider dtype): a bf16 projector
+// output is widened and autocast is suspended for the covariance matmuls.
+[[nodiscard]] inline vicreg_loss_result_t
+compute_vicreg_loss(const torch::Tensor &z1, const torch::Tensor &mask1,
+                    const torch::Tensor &z2, const torch::Tensor &mask2,
+                    const vicreg_loss_options_t &options = {}) {
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  precision::float32_scope_t float32_loss;
+  const auto wide_z1 = precision::widen_reduced_precision(z1);
+  const auto wide_z2 = precision::widen_reduced_precision(z2);
+  switch (options.impl) {
+  case vicreg_loss_impl_t::masked:
+    return compute_vicreg_loss_masked(wide_z1, mask1, wide_z2, mask2, options);
+  case vicreg_loss_impl_t::gather:
+    return compute_vicreg_loss_gather(wide_z1, mask1, wide_z2, mask2, options);
+  }
+  TORCH_CHECK(false, "[vicreg_loss] unknown loss impl");
+}
+
 } // namespace cuwacunu::wikimyei::representation::encoding::vicreg
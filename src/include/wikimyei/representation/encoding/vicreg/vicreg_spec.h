@@ -50,6 +50,7 @@ struct vicreg_spec_t {
   double vicreg_variance_floor{1.0};
   double vicreg_eps{1e-4};
   double global_aux_weight{0.0};
+  vicreg_loss_impl_t vicreg_loss_impl{vicreg_loss_impl_t::masked};
   int64_t min_valid_rows{2};
   bool skip_non_finite_loss{true};
   double jitter_std{0.01};
@@ -212,6 +213,8 @@ inline void decode_vicreg_net_into_spec(const std::string &net_text,
   spec.vicreg_eps = kv::parse_double(kv::required(block, "VICREG_EPS"));
   spec.global_aux_weight =
       kv::parse_double(kv::required(block, "GLOBAL_AUX_WEIGHT"));
+  spec.vicreg_loss_impl = parse_vicreg_loss_impl(
+      kv::lowercase(kv::optional(block, "VICREG_LOSS_IMPL", "masked")));
   spec.min_valid_rows = kv::parse_i64(kv::required(block, "MIN_VALID_ROWS"));
   spec.skip_non_finite_loss =
       kv::parse_bool(kv::required(block, "SKIP_NON_FINITE_LOSS"));
@@ -295,6 +298,7 @@ vicreg_train_options_from_spec(const vicreg_spec_t &spec) {
   out.vicreg.variance_floor = spec.vicreg_variance_floor;
   out.vicreg.eps = spec.vicreg_eps;
   out.vicreg.global_aux_weight = spec.global_aux_weight;
+  out.vicreg.impl = spec.vicreg_loss_impl;
   out.min_valid_rows = spec.min_valid_rows;
   out.skip_non_finite_loss = spec.skip_non_finite_loss;
   out.jitter_std = spec.jitter_std;
@@ -10,6 +10,7 @@
 
 #include <torch/torch.h>
 
+#include "piaabo/tensor/torch/mixed_precision.h"
 #include "wikimyei/representation/encoding/vicreg/channel_preserving_encoder.h"
 #include "wikimyei/representation/encoding/vicreg/vicreg_loss.h"
 #include "wikimyei/representation/encoding/vicreg/vicreg_projector.h"
@@ -24,6 +25,9 @@ struct vicreg_train_options_t {
   double grad_clip_norm{0.0};
   int64_t min_valid_rows{2};
   bool skip_non_finite_loss{true};
+  // Encoder/projector precision; compute_vicreg_loss stays float32.
+  cuwacunu::piaabo::tensor::torch::precision_policy_t precision_policy{
+      cuwacunu::piaabo::tensor::torch::precision_policy_t::float32};
 };
 
 struct vicreg_train_step_result_t {
@@ -260,10 +264,18 @@ public:
         vicreg_train_detail::augment_channel_view(data_d, mask_d, options_);
     const auto view2 =
         vicreg_train_detail::augment_channel_view(data_d, mask_d, options_);
-    const auto enc1 = encoder_->forward(view1.data, view1.feature_mask);
-    const auto enc2 = encoder_->forward(view2.data, view2.feature_mask);
-    auto p1 = projector_->forward(enc1.reduced);
-    auto p2 = projector_->forward(enc2.reduced);
+    channel_preserving_encoder_output_t enc1{};
+    channel_preserving_encoder_output_t enc2{};
+    torch::Tensor p1{};
+    torch::Tensor p2{};
+    {
+      cuwacunu::piaabo::tensor::torch::autocast_scope_t autocast(
+          options_.precision_policy);
+      enc1 = encoder_->forward(view1.data, view1.feature_mask);
+      enc2 = encoder_->forward(view2.data, view2.feature_mask);
+      p1 = projector_->forward(enc1.reduced);
+      p2 = projector_->forward(enc2.reduced);
+    }
     auto vicreg = compute_vicreg_loss(p1, enc1.reduced_mask, p2,
                                       enc2.reduced_mask, options_.vicreg);
 
@@ -278,7 +290,7 @@ public:
     out.per_channel_covariance_loss = vicreg.per_channel_covariance_loss;
     out.per_channel_norm_mean = vicreg.per_channel_norm_mean;
     out.cross_channel_similarity = vicreg.cross_channel_similarity;
-    out.valid_projection_rows = vicreg.valid_rows;
+    out.valid_projection_rows = vicreg.valid_rows.template item<int64_t>();
     const auto original_valid_features =
         vicreg_train_detail::valid_feature_count(valid_feature);
     const auto total_features = mask_d.numel();
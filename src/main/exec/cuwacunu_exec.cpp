@@ -37,7 +37,8 @@ void print_usage(const char *argv0) {
             << "       [--marshal-target-driver-run-id ID]\n"
             << "       [--input-representation-checkpoint PATH]\n"
             << "       [--input-mdn-checkpoint PATH]\n"
-            << "       [--no-replay-artifacts]\n"
+            << "       [--vicreg-loss-impl masked|gather]\n"
+            << "       [--no-replay-artifacts] [--trace-spans]\n"
             << "       [--replay-accounting-numeraire-node NODE]\n"
             << "       [--replay-target-nodes CSV]\n"
             << "       [--replay-experiment-id ID]\n"
@@ -224,8 +225,13 @@ int main(int argc, char **argv) {
       } else if (arg == "--input-mdn-checkpoint") {
         options.input_mdn_checkpoint_path =
             require_next_arg(argc, argv, &i, arg);
+      } else if (arg == "--vicreg-loss-impl") {
+        options.vicreg_loss_impl_override =
+            require_next_arg(argc, argv, &i, arg);
       } else if (arg == "--no-replay-artifacts") {
         options.write_replay_artifacts = false;
+      } else if (arg == "--trace-spans") {
+        options.write_trace_spans = true;
       } else if (arg == "--replay-accounting-numeraire-node") {
         options.replay_accounting_numeraire_node_id =
             require_next_arg(argc, argv, &i, arg);
@@ -326,9 +332,15 @@ int main(int argc, char **argv) {
              "artifacts may be unsuitable for readiness claims. Prefer "
              "hero.marshal.rollout or hero.runtime.run operation=replay for "
              "operator evidence.\n";
+      cuwacunu::piaabo::bench::trace::trace_session_t trace_session(
+          replay_options.job_dir / "replay.trace.json",
+          options.write_trace_spans);
       const auto replay_result =
           env::run_runtime_job_replay_experiment(replay_options);
       print_replay_result(replay_result);
+      if (!trace_session.finish()) {
+        std::cerr << trace_session.error() << "\n";
+      }
       return 0;
     }
 
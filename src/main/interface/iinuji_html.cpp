@@ -19,6 +19,7 @@ struct options_t {
   std::uint16_t port{8765U};
   std::filesystem::path repo_root;
   std::size_t max_requests{0U};
+  std::size_t workers{4U};
   bool repo_root_set{false};
   bool validate_only{false};
   bool help{false};
@@ -94,6 +95,19 @@ struct options_t {
         throw std::invalid_argument("--max-requests is too large");
       }
       options.max_requests = static_cast<std::size_t>(value);
+    } else if (argument == "--workers") {
+      const auto value =
+          parse_u64(require_value(argc, argv, index, argument), argument);
+      if (value == 0U || value > 256U) {
+        throw std::invalid_argument("--workers must be in [1,256]");
+      }
+      options.workers = static_cast<std::size_t>(value);
+    } else if (argument.starts_with("--workers=")) {
+      const auto value = parse_u64(argument.substr(10U), "--workers");
+      if (value == 0U || value > 256U) {
+        throw std::invalid_argument("--workers must be in [1,256]");
+      }
+      options.workers = static_cast<std::size_t>(value);
     } else {
       throw std::invalid_argument("unknown option: " + std::string(argument));
     }
@@ -134,6 +148,7 @@ void print_usage(std::ostream &output) {
             "discovered)\n"
          << "  --validate-only      Validate all inputs/assets, then exit\n"
          << "  --max-requests N     Exit after N requests; 0 means unlimited\n"
+         << "  --workers N          Request handler threads (default: 4)\n"
          << "  -h, --help           Show this help\n";
 }
 
@@ -168,7 +183,10 @@ int main(int argc, char **argv) {
     }
 
     const cuwacunu::iinuji::html::iinuji_http_server_config_t config{
-        options.bind_address, options.port, options.max_requests};
+        .bind_address = options.bind_address,
+        .port = options.port,
+        .max_requests = options.max_requests,
+        .worker_threads = options.workers};
     const cuwacunu::iinuji::html::iinuji_http_server_t server(config,
                                                               application);
     const bool ipv6 = options.bind_address.find(':') != std::string::npos;
@@ -215,7 +215,7 @@
   async function fetchJson(url, signal) {
     const response = await fetch(url, {
       signal,
-      cache: "no-store",
+      cache: "no-cache",
       credentials: "same-origin",
       headers: { Accept: "application/json" },
     });
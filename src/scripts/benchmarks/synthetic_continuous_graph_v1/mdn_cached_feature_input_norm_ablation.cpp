@@ -111,17 +111,8 @@ Options parse_options(int argc, char **argv) {
   return options;
 }
 
-std::string read_file(const std::filesystem::path &path) {
-  std::ifstream input(path, std::ios::binary);
-  require(input.good(), "cannot open input: " + path.string());
-  std::ostringstream buffer;
-  buffer << input.rdbuf();
-  require(input.good() || input.eof(), "cannot read input: " + path.string());
-  return buffer.str();
-}
-
 std::string sha256_file(const std::filesystem::path &path) {
-  return digest::sha256_hex(read_file(path));
+  return digest::sha256_file_hex(path);
 }
 
 int64_t parse_int64(const std::string &token, int64_t row,
@@ -116,17 +116,8 @@ Options parse_options(int argc, char **argv) {
   return options;
 }
 
-std::string read_file(const std::filesystem::path &path) {
-  std::ifstream in(path, std::ios::binary);
-  require(in.good(), "cannot open input: " + path.string());
-  std::ostringstream buffer;
-  buffer << in.rdbuf();
-  require(in.good() || in.eof(), "cannot read input: " + path.string());
-  return buffer.str();
-}
-
 std::string sha256_file(const std::filesystem::path &path) {
-  return digest::sha256_hex(read_file(path));
+  return digest::sha256_file_hex(path);
 }
 
 struct KlineRow {
@@ -257,22 +257,6 @@ void write_bars(const fs::path &path, const std::vector<bar_t> &bars,
   require(output.good(), "failed while writing " + path.string());
 }
 
-[[nodiscard]] std::string read_file(const fs::path &path) {
-  std::ifstream input(path, std::ios::binary | std::ios::ate);
-  require(input.good(), "cannot read " + path.string());
-  const auto end = input.tellg();
-  require(end >= 0, "cannot determine size of " + path.string());
-  std::string contents(static_cast<std::size_t>(end), '\0');
-  input.seekg(0, std::ios::beg);
-  if (!contents.empty()) {
-    input.read(contents.data(), static_cast<std::streamsize>(contents.size()));
-  }
-  require(input.good() || input.eof(), "failed reading " + path.string());
-  require(static_cast<std::size_t>(input.gcount()) == contents.size(),
-          "short read from " + path.string());
-  return contents;
-}
-
 [[nodiscard]] std::string relative_csv_path(std::string_view tree,
                                             std::string_view instrument,
                                             std::string_view interval) {
@@ -312,11 +296,19 @@ void write_manifest(const fs::path &root,
             relative_csv_path(tree, instrument.instrument, interval.id);
         bindings.push_back({std::string(tree),
                             std::string(instrument.instrument),
-                            std::string(interval.id), relative,
-                            digest::sha256_hex(read_file(root / relative))});
+                            std::string(interval.id), relative, ""});
       }
     }
   }
+  std::vector<fs::path> binding_paths;
+  binding_paths.reserve(bindings.size());
+  for (const auto &binding : bindings) {
+    binding_paths.push_back(root / binding.relative_path);
+  }
+  const auto binding_digests = digest::sha256_files_hex(binding_paths);
+  for (std::size_t i = 0; i < bindings.size(); ++i) {
+    bindings[i].sha256 = binding_digests[i];
+  }
 
   std::ostringstream dataset_binding;
   for (const auto &binding : bindings) {
@@ -187,7 +187,7 @@ std::string read_file(const std::filesystem::path &path) {
 }
 
 std::string sha256_file(const std::filesystem::path &path) {
-  return digest::sha256_hex(read_file(path));
+  return digest::sha256_file_hex(path);
 }
 
 void validate_inputs(const Options &options) {
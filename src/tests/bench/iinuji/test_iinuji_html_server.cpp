@@ -2,12 +2,22 @@
 
 #include "iinuji/html/iinuji_http_server.h"
 
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <unistd.h>
 
 namespace {
@@ -73,6 +83,189 @@ std::size_t count_point_tuples(std::string_view chart_json) {
   return count;
 }
 
+
+// Asks the kernel for a free loopback port; the server binds it right after.
+std::uint16_t free_loopback_port() {
+  const cuwacunu::iinuji::html::iinuji_http_detail::socket_t probe(
+      ::socket(AF_INET, SOCK_STREAM, 0));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (!probe ||
+      ::bind(probe.get(), reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+      ::getsockname(probe.get(), reinterpret_cast<sockaddr *>(&address),
+                    &length) != 0) {
+    return 0U;
+  }
+  return ntohs(address.sin_port);
+}
+
+// Blocking client socket with a receive timeout, retried until the server
+// listens.
+cuwacunu::iinuji::html::iinuji_http_detail::socket_t
+connect_loopback(std::uint16_t port) {
+  using cuwacunu::iinuji::html::iinuji_http_detail::socket_t;
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  for (int attempt = 0; attempt < 200; ++attempt) {
+    socket_t client(::socket(AF_INET, SOCK_STREAM, 0));
+    timeval timeout{5, 0};
+    (void)::setsockopt(client.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                       sizeof(timeout));
+    if (client && ::connect(client.get(),
+                            reinterpret_cast<sockaddr *>(&address),
+                            sizeof(address)) == 0) {
+      return client;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return socket_t{};
+}
+
+bool send_all(int descriptor, std::string_view bytes) {
+  while (!bytes.empty()) {
+    const auto sent =
+        ::send(descriptor, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+    if (sent <= 0) {
+      return false;
+    }
+    bytes.remove_prefix(static_cast<std::size_t>(sent));
+  }
+  return true;
+}
+
+// Reads one response (header plus Content-Length body) off `descriptor`,
+// keeping any bytes of the next response in `pending`.
+std::string read_http_response(int descriptor, std::string &pending) {
+  std::array<char, 4096> buffer{};
+  std::size_t expected = std::string::npos;
+  for (;;) {
+    const auto header_end = pending.find("\r\n\r\n");
+    if (header_end != std::string::npos && expected == std::string::npos) {
+      expected = header_end + 4U;
+      const auto length_at = pending.find("Content-Length: ");
+      if (length_at != std::string::npos && length_at < header_end) {
+        expected += std::stoul(pending.substr(length_at + 16U));
+      }
+    }
+    if (expected != std::string::npos && pending.size() >= expected) {
+      std::string response = pending.substr(0U, expected);
+      pending.erase(0U, expected);
+      return response;
+    }
+    const auto received =
+        ::recv(descriptor, buffer.data(), buffer.size(), 0);
+    if (received <= 0) {
+      return {};
+    }
+    pending.append(buffer.data(), static_cast<std::size_t>(received));
+  }
+}
+
+// True once the server has closed its end: recv sees EOF, not a timeout.
+bool peer_closed(int descriptor) {
+  char byte = 0;
+  return ::recv(descriptor, &byte, 1U, 0) == 0;
+}
+
+bool check_loopback_server(
+    std::shared_ptr<const cuwacunu::iinuji::html::iinuji_http_application_t>
+        application) {
+  using namespace cuwacunu::iinuji::html;
+  bool ok = true;
+  const auto port = free_loopback_port();
+  if (!require(port != 0U, "loopback port probe should succeed")) {
+    return false;
+  }
+  iinuji_http_server_config_t config;
+  config.port = port;
+  // 3 pipelined/keep-alive, 1 oversized header, 1 abandoned, 1 final.
+  config.max_requests = 6U;
+  config.worker_threads = 2U;
+  const iinuji_http_server_t server(config, application);
+  auto served = std::async(std::launch::async, [&] { return server.run(); });
+
+  {
+    const auto client = connect_loopback(port);
+    std::string pending;
+    const bool sent = client && send_all(client.get(),
+                                         "GET /healthz HTTP/1.1\r\n"
+                                         "Host: localhost\r\n\r\n"
+                                         "GET /api/v1/catalog HTTP/1.1\r\n"
+                                         "Host: localhost\r\n\r\n");
+    const auto first = sent ? read_http_response(client.get(), pending) : "";
+    const auto second = sent ? read_http_response(client.get(), pending) : "";
+    ok = require(first.starts_with("HTTP/1.1 200") &&
+                     contains(first, "\"status\":\"ok\"") &&
+                     contains(first, "Connection: keep-alive") &&
+                     second.starts_with("HTTP/1.1 200") &&
+                     contains(second, "iinuji.synthetic_chart_catalog") &&
+                     contains(second, "Connection: keep-alive"),
+                 "pipelined requests should be answered in request order") &&
+         ok;
+    const bool resent =
+        sent && send_all(client.get(),
+                         "GET /healthz HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    const auto third = resent ? read_http_response(client.get(), pending) : "";
+    ok = require(third.starts_with("HTTP/1.1 200") && pending.empty(),
+                 "a pipelined connection should stay open for the next "
+                 "request") &&
+         ok;
+  }
+
+  {
+    const auto client = connect_loopback(port);
+    std::string oversized = "GET /healthz HTTP/1.1\r\nX-Fill: ";
+    oversized.append(kMaximumHttpRequestHeaderBytes, 'x');
+    std::string pending;
+    const bool sent = client && send_all(client.get(), oversized);
+    const auto response =
+        sent ? read_http_response(client.get(), pending) : "";
+    ok = require(response.starts_with("HTTP/1.1 431") &&
+                     peer_closed(client.get()),
+                 "an unterminated header past the cap should get 431 and "
+                 "close") &&
+         ok;
+  }
+
+  {
+    // The peer hangs up while its request is with the pool; the loop must
+    // drop the socket from its interest set and keep serving.
+    const auto client = connect_loopback(port);
+    ok = require(client && send_all(client.get(),
+                                    "GET /api/v1/catalog HTTP/1.1\r\n"
+                                    "Host: localhost\r\n\r\n"),
+                 "abandoned request should be sent") &&
+         ok;
+  }
+
+  {
+    const auto client = connect_loopback(port);
+    std::string pending;
+    const bool sent =
+        client && send_all(client.get(),
+                           "GET /healthz HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    const auto response =
+        sent ? read_http_response(client.get(), pending) : "";
+    ok = require(response.starts_with("HTTP/1.1 200") &&
+                     contains(response, "Connection: close") &&
+                     peer_closed(client.get()),
+                 "the last request under max_requests should close") &&
+         ok;
+  }
+
+  const bool finished =
+      served.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+  ok = require(finished && served.get() == 6U,
+               "run() should return after max_requests answers") &&
+       ok;
+  return ok;
+}
+
 } // namespace
 
 int main() {
@@ -221,7 +414,9 @@ int main() {
                  "resolve to raw data") &&
          ok;
 
-    const iinuji_http_application_t application(repo_root);
+    const auto shared_application =
+        std::make_shared<const iinuji_http_application_t>(repo_root);
+    const auto &application = *shared_application;
     const auto &repository = application.repository();
     const auto &v2_repository = application.v2_repository();
 
@@ -498,6 +693,59 @@ int main() {
              "responses should carry restrictive security headers and no "
              "CORS") &&
          ok;
+
+    ok = require(!chart_response.etag.empty() &&
+                     contains(serialize_http_response(chart_response, false),
+                              "ETag: " + chart_response.etag + "\r\n") &&
+                     contains(serialize_http_response(chart_response, false),
+                              "Cache-Control: no-cache\r\n") &&
+                     health_response.etag.empty(),
+                 "cached documents should carry an ETag and revalidate") &&
+         ok;
+
+    http_request_t conditional_request{http_method_e::get,
+                                       "/api/v1/chart/SYNBETASYNUSD/3d",
+                                       "HTTP/1.1",
+                                       {},
+                                       {}};
+    conditional_request.headers.emplace("if-none-match", chart_response.etag);
+    const auto not_modified = application.respond(conditional_request);
+    const auto not_modified_wire =
+        serialize_http_response(not_modified, false, true);
+    ok = require(not_modified.status == 304 && not_modified.body.empty() &&
+                     not_modified_wire.ends_with("\r\n\r\n") &&
+                     !contains(not_modified_wire, "Content-Length:") &&
+                     contains(not_modified_wire, "Connection: keep-alive"),
+                 "matching If-None-Match should answer 304 without a body") &&
+         ok;
+
+    http_request_t gzip_request{http_method_e::get,
+                                "/api/v1/chart/SYNBETASYNUSD/3d",
+                                "HTTP/1.1",
+                                {},
+                                {}};
+    gzip_request.headers.emplace("accept-encoding", "br, gzip;q=0.8");
+    const auto gzip_response = application.respond(gzip_request);
+    const auto gzip_wire = serialize_http_response(gzip_response, false);
+    ok = require(gzip_response.status == 200 &&
+                     gzip_response.body.size() < chart_response.body.size() &&
+                     gzip_response.body.starts_with("\x1f\x8b") &&
+                     gzip_response.etag != chart_response.etag &&
+                     contains(gzip_wire, "Content-Encoding: gzip\r\n") &&
+                     contains(gzip_wire, "Vary: Accept-Encoding\r\n"),
+                 "JSON documents should be gzip-encoded when accepted") &&
+         ok;
+    gzip_request.headers["accept-encoding"] = "gzip;q=0, identity";
+    ok = require(application.respond(gzip_request).body ==
+                     chart_response.body,
+                 "q=0 should refuse a content coding") &&
+         ok;
+    gzip_request.headers["if-none-match"] = gzip_response.etag;
+    ok = require(application.respond(gzip_request).status == 304,
+                 "any coding's validator should revalidate the document") &&
+         ok;
+
+    ok = check_loopback_server(shared_application) && ok;
   } catch (const std::exception &error) {
     std::cerr << "[FAIL] repository/application validation threw: "
               << error.what() << '\n';
@@ -508,7 +756,7 @@ int main() {
     return 1;
   }
   std::cout
-      << "[PASS] iinuji HTML parser, catalog, routes, security, and holdout"
-         " truncation\n";
+      << "[PASS] iinuji HTML parser, catalog, routes, security, holdout"
+         " truncation, and loopback keep-alive\n";
   return 0;
 }
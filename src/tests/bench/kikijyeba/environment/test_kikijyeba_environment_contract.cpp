@@ -7,6 +7,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -2228,6 +2229,42 @@ void test_replay_world() {
   check(!report.step_reports[0].risk_gate_evaluated,
         "replay step report distinguishes unevaluated risk gate");
 
+  // Frames are validated once per validation digest. Poisoning a shared
+  // return tensor after validation is only visible to worlds that revalidate.
+  auto cached_frames = frames;
+  cached_frames[1].realized_log_return =
+      frames[1].realized_log_return.clone();
+  replay::replay_world_t cached_world(cached_frames, options, spec);
+  auto revalidate_options = options;
+  revalidate_options.revalidate_frames_on_reset = true;
+  replay::replay_world_t revalidating_world(cached_frames, revalidate_options,
+                                            spec);
+  cached_frames[1].realized_log_return.fill_(
+      std::numeric_limits<double>::quiet_NaN());
+  check(cached_world.reset(spec).anchor_key == "anchor_10",
+        "replay reset with a validated spec skips per-frame validation");
+  bool revalidation_caught_poisoned_frame = false;
+  try {
+    (void)revalidating_world.reset(spec);
+  } catch (const std::exception &) {
+    revalidation_caught_poisoned_frame = true;
+  }
+  check(revalidation_caught_poisoned_frame,
+        "replay revalidate_frames_on_reset reruns per-frame validation");
+  auto rebased_spec = spec;
+  rebased_spec.initial_equity_numeraire = 2.0;
+  check(replay::detail::frame_validation_digest(rebased_spec, options) !=
+            replay::detail::frame_validation_digest(spec, options),
+        "replay frame validation digest covers episode equity");
+  bool new_digest_revalidated = false;
+  try {
+    (void)cached_world.reset(rebased_spec);
+  } catch (const std::exception &) {
+    new_digest_revalidated = true;
+  }
+  check(new_digest_revalidated,
+        "replay reset with a new validation digest revalidates frames");
+
   auto bad_frames = frames;
   bad_frames[0].observation.anchor_key = "wrong_anchor";
   replay::replay_world_t bad_world(bad_frames, options);
@@ -4174,6 +4211,104 @@ void test_replay_source_graph_anchor_binding() {
       experience_trace.episodes[0].transitions[0].projection_correlation, 1e-12,
       "experience trace reader preserves projection correlation");
 
+  const auto experience_trace_columns_path =
+      std::filesystem::temp_directory_path() /
+      "cuwacunu_environment_contract_experience_trace.columns";
+  env::output::write_experience_trace_columns(experience_trace,
+                                              experience_trace_columns_path);
+  const auto columnar_trace =
+      env::output::read_experience_trace_columns(experience_trace_columns_path);
+  check(env::output::experience_trace_canonical_text(columnar_trace) ==
+            env::output::experience_trace_canonical_text(experience_trace),
+        "columnar experience trace round-trips the canonical text");
+  check(env::output::experience_trace_digest(columnar_trace) ==
+            env::output::experience_trace_digest(loaded_experience_trace),
+        "columnar and text experience traces share one digest");
+  const env::output::experience_trace_columns_t trace_columns(
+      experience_trace_columns_path);
+  std::size_t transition_total = 0;
+  for (const auto &episode : experience_trace.episodes) {
+    transition_total += episode.transitions.size();
+  }
+  check(trace_columns.row_count() == transition_total &&
+            trace_columns.episode_row_offsets().back() == transition_total,
+        "columnar experience trace flattens every transition");
+  const auto reward_column = trace_columns.tensor("reward_total");
+  const auto step_column = trace_columns.tensor("step_index");
+  const auto clean_column = trace_columns.tensor("time_law_clean");
+  check(reward_column.dim() == 1 &&
+            reward_column.size(0) ==
+                static_cast<std::int64_t>(transition_total) &&
+            reward_column.scalar_type() == torch::kFloat64 &&
+            step_column.scalar_type() == torch::kInt64 &&
+            clean_column.scalar_type() == torch::kBool &&
+            clean_column.all().item<bool>(),
+        "columnar experience trace loads fields as [T] tensors");
+  check(reward_column[0].item<double>() ==
+                experience_trace.episodes[0].transitions[0].reward_total &&
+            step_column[0].item<std::int64_t>() ==
+                static_cast<std::int64_t>(
+                    experience_trace.episodes[0].transitions[0].step_index),
+        "columnar experience trace tensors alias the stored values");
+  const auto policy_codes = trace_columns.tensor("policy_id");
+  const auto policy_dictionary = trace_columns.text_dictionary("policy_id");
+  check(policy_codes.scalar_type() == torch::kInt32 &&
+            policy_dictionary.at(policy_codes[0].item<std::int32_t>()) ==
+                experience_trace.episodes[0].transitions[0].policy_id,
+        "columnar experience trace dictionary-codes text fields");
+  const auto &first_transition = experience_trace.episodes[0].transitions[0];
+  const auto node_feature_shapes =
+      trace_columns.text_dictionary("policy_input_node_features_shape");
+  if (node_feature_shapes.size() == 1 && !node_feature_shapes[0].empty()) {
+    const auto node_feature_column =
+        trace_columns.payload_tensor("policy_input_node_features");
+    check(node_feature_column.scalar_type() == torch::kFloat64 &&
+              node_feature_column.dim() >= 2 &&
+              node_feature_column.size(0) ==
+                  static_cast<std::int64_t>(transition_total),
+          "columnar experience trace reads bound payloads as [T, ...]");
+  }
+  const auto mask_shapes =
+      trace_columns.text_dictionary("policy_input_executable_mask_shape");
+  if (mask_shapes.size() == 1 && !mask_shapes[0].empty()) {
+    check(trace_columns.payload_tensor("policy_input_executable_mask")
+                  .scalar_type() == torch::kInt64,
+          "columnar experience trace stores the executable mask as int64");
+  }
+  {
+    // Payload text that does not print back as "%.17g" keeps a text column
+    // and still round-trips.
+    auto loose_trace = experience_trace;
+    loose_trace.episodes[0].transitions[0].policy_input_global_features =
+        "0.1";
+    env::output::write_experience_trace_columns(loose_trace,
+                                                experience_trace_columns_path);
+    check(env::output::experience_trace_canonical_text(
+              env::output::read_experience_trace_columns(
+                  experience_trace_columns_path)) ==
+              env::output::experience_trace_canonical_text(loose_trace),
+          "columnar experience trace keeps non-canonical payload text");
+  }
+  {
+    std::ostringstream transition_text;
+    env::output::detail::write_transition_record(transition_text, "",
+                                                 first_transition);
+    std::set<std::string> text_keys;
+    std::string line;
+    std::istringstream lines(transition_text.str());
+    while (std::getline(lines, line)) {
+      text_keys.insert(line.substr(0, line.find('=')));
+    }
+    const auto names =
+        env::output::experience_trace_columns_detail::transition_column_names();
+    const std::set<std::string> column_keys(names.begin(), names.end());
+    const auto stored = trace_columns.column_names();
+    check(column_keys.size() == names.size() && column_keys == text_keys &&
+              std::set<std::string>(stored.begin(), stored.end()) ==
+                  column_keys,
+          "columnar experience trace covers every transition_record_t field");
+  }
+
   auto bad_experience_trace = experience_trace;
   bad_experience_trace.episodes[0].transitions[0].time_law_clean = false;
   bool rejected_bad_experience_trace = false;
@@ -4287,7 +4422,7 @@ void test_replay_source_graph_anchor_binding() {
           replay_report_path);
   check(default_experience_trace_sidecar_path.filename().string() ==
             "cuwacunu_environment_contract_replay_experiment.experience_trace."
-            "report",
+            "columns",
         "runtime replay driver derives deterministic experience trace sidecar "
         "path");
   const auto replay_report_text = read_text(replay_report_path);
@@ -5478,6 +5613,58 @@ void test_replay_source_graph_anchor_binding() {
         "runtime replay pulse writer appends batch index entry");
   check(runtime_batch_index[0].wave_pulse_index == 7,
         "runtime replay batch index preserves wave pulse index");
+  const auto &pulse_batch_path =
+      runtime_pulse_artifact_paths.graph_anchor_edge_batch_artifact_path;
+  check(runtime_pulse_artifact_paths.graph_anchor_edge_batch_store_offset
+                .has_value() &&
+            pulse_batch_path ==
+                replay::runtime_replay_batch_store_path(runtime_fixture_dir),
+        "runtime replay pulse writer appends edge batch to the job store");
+  const auto runtime_pulse_index_paths =
+      replay::read_runtime_replay_artifact_path_index_at(
+          runtime_batch_index[0].artifact_path_index_path);
+  check(runtime_pulse_index_paths.graph_anchor_edge_batch_store_offset ==
+            runtime_pulse_artifact_paths.graph_anchor_edge_batch_store_offset,
+        "runtime replay path index round-trips batch store offset");
+  const auto stored_pulse_batch =
+      replay::load_graph_anchor_edge_batch_for_paths<std::int64_t>(
+          runtime_pulse_index_paths);
+  check(stored_pulse_batch.cursor.anchor_count() == cursor.anchor_count() &&
+            stored_pulse_batch.cursor.anchor_keys == cursor.anchor_keys,
+        "runtime replay batch store reloads pulse cursor");
+  bool rejected_misaligned_store_offset = false;
+  try {
+    replay::replay_batch_store_reader_t store(
+        runtime_pulse_index_paths.graph_anchor_edge_batch_artifact_path);
+    (void)store.record(
+        *runtime_pulse_index_paths.graph_anchor_edge_batch_store_offset + 8);
+  } catch (const std::exception &) {
+    rejected_misaligned_store_offset = true;
+  }
+  check(rejected_misaligned_store_offset,
+        "runtime replay batch store rejects misaligned record offsets");
+  check(!runtime_artifact_paths.graph_anchor_edge_batch_store_offset
+             .has_value(),
+        "runtime replay single-batch writer keeps the per-batch archive");
+  replay::replay_batch_store_readers_t store_readers;
+  const auto pulse_store_offset =
+      *runtime_pulse_index_paths.graph_anchor_edge_batch_store_offset;
+  const auto *first_store_reader =
+      &store_readers.reader_for(pulse_batch_path, pulse_store_offset);
+  (void)replay::load_graph_anchor_edge_batch_for_paths<std::int64_t>(
+      runtime_pulse_index_paths, torch::Device(torch::kCPU), &store_readers);
+  check(store_readers.size() == 1 &&
+            &store_readers.reader_for(pulse_batch_path, pulse_store_offset) ==
+                first_store_reader,
+        "runtime replay batch store readers map each store once");
+  const auto appended_store_offset = replay::append_replay_batch_store_record(
+      pulse_batch_path, {{"probe", torch::arange(3, torch::kInt64)}});
+  check(!first_store_reader->covers(appended_store_offset) &&
+            store_readers.reader_for(pulse_batch_path, appended_store_offset)
+                    .record(appended_store_offset)
+                    .at("probe")
+                    .equal(torch::arange(3, torch::kInt64)),
+        "runtime replay batch store readers remap for appended records");
   const auto empty_runtime_batch_index_root =
       std::filesystem::temp_directory_path() /
       "cuwacunu_environment_empty_runtime_batch_index_fixture";
@@ -5720,11 +5907,28 @@ void test_replay_source_graph_anchor_binding() {
                         projection_required_bundle_world_options,
                         replay::replay_observation_artifact_options_t{},
                         /*require_observation_artifacts=*/true);
+  check(runtime_source_from_job_dir.size() == 1 &&
+            runtime_source_from_job_dir.cursor() == 0,
+        "runtime replay job-dir source defers pulse batch loading");
   auto job_dir_runtime_experiment = env::run_replay_experiment(
       "runtime_job_dir_allocation_compare", runtime_source_from_job_dir,
       std::vector{make_sdu_policy_factory()}, source_experiment_options);
   check(job_dir_runtime_experiment.completed_count == 1,
         "runtime replay job-dir source runs deterministic allocation policy");
+  std::size_t runtime_loader_calls = 0;
+  replay::runtime_graph_anchor_replay_bundle_source_t<std::int64_t>
+      counted_runtime_source(
+          "runtime_graph_anchor_counted_source_fixture", graph,
+          std::vector<replay::runtime_graph_anchor_replay_bundle_source_t<
+              std::int64_t>::record_loader_t>{[&]() {
+            ++runtime_loader_calls;
+            return runtime_record_from_file;
+          }});
+  (void)counted_runtime_source.next_bundle();
+  counted_runtime_source.reset();
+  check(counted_runtime_source.next_bundle().has_value() &&
+            runtime_loader_calls == 1,
+        "runtime replay job-dir source keeps loaded records across reset");
 
   auto bad_runtime_record = runtime_record;
   bad_runtime_record.manifest.graph_order_fingerprint = "wrong_graph";
@@ -6347,6 +6551,218 @@ void test_trainable_policy_contract() {
         "sampled trainable step carries PPO old policy evidence");
 }
 
+// Double-precision closed forms, independent of the torch kernels under test.
+double digamma_reference(double x) {
+  double result = 0.0;
+  for (; x < 10.0; x += 1.0) {
+    result -= 1.0 / x;
+  }
+  const double inv2 = 1.0 / (x * x);
+  return result + std::log(x) - 0.5 / x -
+         inv2 * (1.0 / 12.0 -
+                 inv2 * (1.0 / 120.0 -
+                         inv2 * (1.0 / 252.0 -
+                                 inv2 * (1.0 / 240.0 - inv2 / 132.0))));
+}
+
+std::vector<double> masked_row_values(const torch::Tensor &row,
+                                      const torch::Tensor &mask_row) {
+  const auto values =
+      row.masked_select(mask_row).to(torch::kFloat64).contiguous();
+  const auto *data = values.data_ptr<double>();
+  return std::vector<double>(data, data + values.numel());
+}
+
+double dirichlet_log_prob_reference(const std::vector<double> &alpha,
+                                    const std::vector<double> &x) {
+  double alpha0 = 0.0;
+  double out = 0.0;
+  for (std::size_t i = 0; i < alpha.size(); ++i) {
+    alpha0 += alpha[i];
+    out += (alpha[i] - 1.0) * std::log(x[i]) - std::lgamma(alpha[i]);
+  }
+  return out + std::lgamma(alpha0);
+}
+
+double dirichlet_entropy_reference(const std::vector<double> &alpha) {
+  double alpha0 = 0.0;
+  double out = 0.0;
+  for (const double a : alpha) {
+    alpha0 += a;
+    out += std::lgamma(a) - (a - 1.0) * digamma_reference(a);
+  }
+  const double K = static_cast<double>(alpha.size());
+  return out - std::lgamma(alpha0) + (alpha0 - K) * digamma_reference(alpha0);
+}
+
+void test_batched_simplex_distributions() {
+  const double log_2pi = std::log(2.0 * std::acos(-1.0));
+  close(digamma_reference(1.0), -0.57721566490153286, 1.0e-13,
+        "digamma reference gives -gamma at one");
+  const auto f64 = torch::TensorOptions().dtype(torch::kFloat64);
+  const auto logits = torch::tensor(
+      {{0.2, -0.4, 1.1}, {0.5, 0.3, -0.2}, {0.0, 0.7, 0.1}}, f64);
+  const auto mask = torch::tensor({{true, false, true},
+                                   {true, true, true},
+                                   {false, false, true}},
+                                  torch::TensorOptions().dtype(torch::kBool));
+  const auto alpha = env::masked_dirichlet_alpha_batch(
+      logits, mask, torch::tensor({3.0, 8.0, 5.0}, f64), 1.0e-4);
+  close(alpha.index({0, 1}).item<double>(), 0.0, 0.0,
+        "batched Dirichlet alpha is zero on masked nodes");
+
+  auto generator = at::detail::createCPUGenerator(23);
+  const auto sample =
+      env::sample_masked_dirichlet_batch(alpha, mask, generator);
+  auto replay = at::detail::createCPUGenerator(23);
+  check(torch::equal(sample,
+                     env::sample_masked_dirichlet_batch(alpha, mask, replay)),
+        "seeded batched Dirichlet sampling is reproducible");
+  close((sample.sum(-1) - 1.0).abs().max().item<double>(), 0.0, 1.0e-12,
+        "batched Dirichlet rows sum to one");
+  close(sample.index({0, 1}).item<double>(), 0.0, 0.0,
+        "batched Dirichlet masks inactive nodes");
+  close(sample.index({2, 2}).item<double>(), 1.0, 1.0e-12,
+        "single-node batched Dirichlet row is a point mass");
+
+  const auto log_prob =
+      env::masked_dirichlet_log_prob_batch(alpha, sample, mask);
+  const auto entropy = env::masked_dirichlet_entropy_batch(alpha, mask);
+  for (std::int64_t b = 0; b < 2; ++b) {
+    const auto alpha_b = masked_row_values(alpha[b], mask[b]);
+    close(log_prob[b].item<double>(),
+          dirichlet_log_prob_reference(alpha_b,
+                                       masked_row_values(sample[b], mask[b])),
+          1.0e-10, "batched Dirichlet log_prob matches the closed form");
+    close(entropy[b].item<double>(), dirichlet_entropy_reference(alpha_b),
+          1.0e-10, "batched Dirichlet entropy matches the closed form");
+  }
+  close(log_prob[2].item<double>(), 0.0, 0.0,
+        "single-node batched Dirichlet log_prob is zero");
+  close(entropy[2].item<double>(), 0.0, 0.0,
+        "single-node batched Dirichlet entropy is zero");
+
+  const auto alpha_q = env::masked_dirichlet_alpha_batch(
+      logits.flip({-1}), mask, torch::tensor({4.0, 2.0, 5.0}, f64), 1.0e-4);
+  close(env::masked_dirichlet_kl_batch(alpha, alpha, mask)
+            .abs()
+            .max()
+            .item<double>(),
+        0.0, 1.0e-12, "batched Dirichlet KL is zero for identical rows");
+  const auto kl = env::masked_dirichlet_kl_batch(alpha, alpha_q, mask);
+  // Monte Carlo E_p[log p - log q] on the full row.
+  const std::int64_t draws = 20000;
+  const auto p_rows = alpha[1].expand({draws, 3});
+  const auto q_rows = alpha_q[1].expand({draws, 3});
+  const auto full_mask = mask[1].expand({draws, 3});
+  auto mc_generator = at::detail::createCPUGenerator(29);
+  const auto mc_sample =
+      env::sample_masked_dirichlet_batch(p_rows, full_mask, mc_generator);
+  const double mc_kl =
+      (env::masked_dirichlet_log_prob_batch(p_rows, mc_sample, full_mask) -
+       env::masked_dirichlet_log_prob_batch(q_rows, mc_sample, full_mask))
+          .mean()
+          .item<double>();
+  close(kl[1].item<double>(), mc_kl, 0.08 * std::abs(mc_kl) + 0.02,
+        "batched Dirichlet KL matches a Monte Carlo estimate");
+
+  const auto ref = torch::tensor({2, 2, 2}, torch::kInt64);
+  const auto mu_z = logits - logits.gather(-1, ref.unsqueeze(-1));
+  const auto std_z = torch::full({3, 3}, 0.4, f64);
+  auto logistic_generator = at::detail::createCPUGenerator(31);
+  const auto logistic_sample = env::sample_masked_logistic_normal_batch(
+      mu_z, std_z, mask, logistic_generator);
+  close((logistic_sample.sum(-1) - 1.0).abs().max().item<double>(), 0.0,
+        1.0e-12, "batched logistic-normal rows sum to one");
+  const auto logistic_log_prob = env::masked_logistic_normal_log_prob_batch(
+      logistic_sample, mu_z, std_z, mask);
+  // Row 0 keeps nodes 0 and 2: one latent coordinate against node 2, and
+  // the density picks up the additive-logistic Jacobian 1 / (w0 * w2).
+  const auto w0 = masked_row_values(logistic_sample[0], mask[0]);
+  const double z0 = std::log(w0[0]) - std::log(w0[1]);
+  const double centered0 = (z0 - mu_z[0][0].item<double>()) / 0.4;
+  close(logistic_log_prob[0].item<double>(),
+        -0.5 * centered0 * centered0 - std::log(0.4) - 0.5 * log_2pi -
+            std::log(w0[0]) - std::log(w0[1]),
+        1.0e-10, "batched logistic-normal log_prob matches the closed form");
+  const auto logistic_entropy =
+      env::masked_logistic_normal_entropy_batch(std_z, mask);
+  close(logistic_entropy[1].item<double>(),
+        2.0 * (0.5 * (1.0 + log_2pi) + std::log(0.4)), 1.0e-12,
+        "batched logistic-normal entropy counts latent coordinates");
+  close(logistic_entropy[2].item<double>(), 0.0, 0.0,
+        "single-node batched logistic-normal entropy is zero");
+  close(env::masked_logistic_normal_kl_batch(mu_z, std_z, mu_z, std_z, mask)
+            .abs()
+            .max()
+            .item<double>(),
+        0.0, 1.0e-12, "batched logistic-normal KL is zero for identical rows");
+
+  // The scalar wrappers read their value checks with the result.
+  namespace dist = env::action_distribution_detail;
+  bool rejected_bad_alpha = false;
+  try {
+    (void)dist::dirichlet_entropy(torch::tensor({1.0, -1.0}, f64));
+  } catch (const std::exception &) {
+    rejected_bad_alpha = true;
+  }
+  check(rejected_bad_alpha, "scalar Dirichlet entropy rejects alpha <= 0");
+  bool rejected_bad_weights = false;
+  try {
+    (void)dist::logistic_normal_log_prob(torch::tensor({0.5, 0.0}, f64),
+                                         torch::zeros({1}, f64),
+                                         torch::ones({1}, f64));
+  } catch (const std::exception &) {
+    rejected_bad_weights = true;
+  }
+  check(rejected_bad_weights,
+        "scalar logistic-normal log_prob rejects zero weights");
+}
+
+void test_episode_runner_projection_samples() {
+  namespace runner = env::episode_runner_detail;
+  const auto f64 = torch::TensorOptions().dtype(torch::kFloat64);
+  cuwacunu::wikimyei::observer::projection_validation_t validation{};
+  validation.available = true;
+  validation.predicted_log_return =
+      torch::tensor({0.01, 0.02, -0.03, 0.04}, f64);
+  validation.realized_log_return =
+      torch::tensor({0.02, std::numeric_limits<double>::quiet_NaN(), -0.01,
+                     0.00},
+                    f64);
+  validation.error =
+      validation.predicted_log_return - validation.realized_log_return;
+  validation.abs_error = validation.error.abs();
+  validation.active_mask = torch::tensor({true, true, true, false});
+  // Shorter than A: the missing interval entries are simply not recorded.
+  validation.interval_hit = torch::tensor({true, false});
+  validation.interval_width = torch::tensor({0.5, 0.25, 0.125}, f64);
+
+  std::vector<runner::node_projection_series_t> series(4);
+  runner::append_node_projection_samples(series, validation);
+  runner::append_node_projection_samples(series, validation);
+  check(series[0].predicted.size() == 2 && series[2].predicted.size() == 2,
+        "projection samples keep active finite nodes on every step");
+  check(series[1].predicted.empty() && series[3].predicted.empty(),
+        "projection samples skip non-finite and inactive nodes");
+  check(std::abs(series[2].error[0] + 0.02) < 1.0e-15 &&
+            std::abs(series[2].squared_error[0] - 0.0004) < 1.0e-15,
+        "projection samples fall back to squared error from error");
+  check(series[0].interval_hit.size() == 2 &&
+            series[0].interval_hit[0] == 1.0 && series[2].interval_hit.empty(),
+        "projection samples read short interval-hit columns safely");
+  check(series[2].interval_width.size() == 2 &&
+            series[2].interval_width[1] == 0.125,
+        "projection samples record finite interval widths");
+  check(runner::format_node_weights({"BTC", "USDT"},
+                                    torch::tensor({0.25F, 0.75F})) ==
+            "BTC:0.25,USDT:0.75",
+        "node weight trace formatting reads one host copy");
+  check(runner::negative_unit_count(
+            torch::tensor({-1.0, 0.0, -1.0e-12}, f64)) == 1,
+        "negative unit count ignores values within tolerance");
+}
+
 } // namespace
 
 int main() {
@@ -6356,6 +6772,8 @@ int main() {
     test_baseline_policies();
     test_spot_distributional_utility_policy_adapter();
     test_trainable_policy_contract();
+    test_batched_simplex_distributions();
+    test_episode_runner_projection_samples();
     test_replay_world();
     test_replay_source_graph_anchor_binding();
     std::cout << "kikijyeba environment contract tests passed\n";
@@ -311,6 +311,19 @@ int main() {
                     }),
         "all Marshal performance stages should use repeated samples");
 
+  std::size_t sampled_calls = 0;
+  const auto sampled = marshal::measure_stage(
+      "sampled_stage", "library", 10.0,
+      marshal::marshal_stage_sampling_t{.warmup = 2, .samples = 7},
+      [&] { ++sampled_calls; });
+  check(sampled_calls == 9, "sampled stage should run warm-up plus samples");
+  check(sampled.sample_count == 7 && sampled.warmup_count == 2,
+        "sampled stage should report only timed samples");
+  check(sampled.min_ms <= sampled.p50_ms && sampled.p50_ms <= sampled.p95_ms &&
+            sampled.p95_ms <= sampled.p99_ms &&
+            sampled.p99_ms <= sampled.max_ms,
+        "sampled stage percentiles should be ordered");
+
   marshal::marshal_performance_report_t failed{};
   failed.stages.push_back(
       marshal::marshal_performance_stage_t{.name = "synthetic",
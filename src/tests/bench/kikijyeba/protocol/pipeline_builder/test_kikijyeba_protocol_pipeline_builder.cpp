@@ -774,6 +774,47 @@ void test_channel_contract_ignores_runtime_model_state_inputs() {
         "model-state inputs do not alter channel protocol contract identity");
 }
 
+void test_cached_contract_reuses_until_a_dependency_changes() {
+  const auto fixture = make_config_fixture("channel_contract_cache");
+  builder::clear_config_bundle_cache();
+  const auto first =
+      builder::load_channel_graph_first_protocol_contract_cached(
+          fixture.config);
+  const auto second =
+      builder::load_channel_graph_first_protocol_contract_cached(
+          fixture.config);
+  check(first == second, "cached contract is shared while files are unchanged");
+  check(builder::channel_graph_first_protocol_contract_fingerprint(*first) ==
+            builder::channel_graph_first_protocol_contract_fingerprint(
+                builder::load_channel_graph_first_protocol_contract_from_config(
+                    fixture.config)),
+        "cached contract matches the uncached loader");
+
+  // Rewriting identical bytes bumps mtime but keeps the digest.
+  const auto jkimyei =
+      fixture.dir / "wikimyei.inference.expected_value.mdn.jkimyei";
+  const auto jkimyei_text = read_text(jkimyei);
+  write_text(jkimyei, jkimyei_text);
+  check(builder::load_channel_graph_first_protocol_contract_cached(
+            fixture.config) == first,
+        "identical rewrite keeps the cached contract");
+
+  write_text(jkimyei, jkimyei_text + "\n");
+  const auto reloaded =
+      builder::load_channel_graph_first_protocol_contract_cached(
+          fixture.config);
+  check(reloaded != first, "edited dependency invalidates the cached contract");
+
+  const auto wave = builder::load_wave_settings_cached(fixture.config);
+  check(builder::load_wave_settings_cached(fixture.config) == wave,
+        "cached wave settings are shared");
+  const auto stats = builder::config_bundle_cache_stats();
+  check(stats.hits == 3 && stats.misses == 3 && stats.invalidations == 1 &&
+            stats.entries == 2,
+        "config cache counters track hits, misses and invalidations");
+  builder::clear_config_bundle_cache();
+}
+
 void test_channel_config_backed_forward_nll_smoke() {
   torch::manual_seed(43);
   const auto fixture = make_config_fixture("channel_forward_nll");
@@ -926,6 +967,7 @@ int main() {
     test_default_channel_config_dry_run_report();
     test_train_wave_defaults_to_random_source_order_in_pipeline();
     test_channel_contract_ignores_runtime_model_state_inputs();
+    test_cached_contract_reuses_until_a_dependency_changes();
     test_edge_discovery_policy();
     test_channel_config_backed_forward_nll_smoke();
     std::cout << "[Jkimyei GraphFirstPipelineBuilder test] all checks passed\n";
@@ -0,0 +1,89 @@
+#include "hero/json_field_index.h"
+
+#include <cassert>
+#include <string>
+
+namespace json_index = cuwacunu::hero::json_field_index;
+
+namespace {
+
+void test_first_occurrence_and_kinds() {
+  const std::string json =
+      R"({ "job_id" : "job \"7\"\n", "count": 12 , "flag":true,)"
+      R"("nested":{"inner":"x","deep":{"leaf":[1,2]}},"list":["}"],)"
+      R"("job_id":"shadowed","esc":"\u00e9"})";
+  const json_index::json_object_index_t index(json);
+  assert(index.size() == 6);
+
+  const json_index::json_payload_t payload(json);
+  std::string value;
+  assert(json_index::extract_json_string_field(payload, "job_id", &value));
+  assert(value == "job \"7\"\n");
+  assert(json_index::extract_json_raw_field(payload, "count", &value));
+  assert(value == "12");
+  assert(json_index::extract_json_raw_field(payload, "flag", &value));
+  assert(value == "true");
+  assert(!json_index::extract_json_string_field(payload, "count", &value));
+  assert(json_index::extract_json_raw_field(payload, "list", &value));
+  assert(value == R"(["}"])");
+  assert(json_index::extract_json_string_field(payload, "esc", &value));
+  assert(value == "\\u00e9");
+  assert(!json_index::extract_json_raw_field(payload, "inner", &value));
+
+  const auto *nested = index.object(json, "nested");
+  assert(nested != nullptr && nested->size() == 2);
+  std::string_view raw;
+  assert(nested->raw_field(json, "inner", &raw) && raw == R"("x")");
+  const auto *deep = nested->object(json, "deep");
+  assert(deep != nullptr && deep->raw_field(json, "leaf", &raw));
+  assert(raw == "[1,2]");
+  assert(index.object(json, "list") == nullptr);
+  assert(index.object(json, "nested") == nested);
+}
+
+void test_malformed_members_hide_later_keys() {
+  const json_index::json_payload_t json(
+      R"({"a":1,"b":{"unterminated":[}, "c":3})");
+  std::string value;
+  assert(json_index::extract_json_raw_field(json, "a", &value));
+  assert(value == "1");
+  assert(!json_index::extract_json_raw_field(json, "b", &value));
+  assert(!json_index::extract_json_raw_field(json, "c", &value));
+
+  const json_index::json_payload_t missing_comma(R"({"a":1 "b":2})");
+  assert(json_index::extract_json_raw_field(missing_comma, "b", &value));
+  assert(value == "2");
+
+  const json_index::json_payload_t array("[1,2]");
+  assert(!json_index::extract_json_raw_field(array, "a", &value));
+  const json_index::json_payload_t empty("");
+  assert(!json_index::extract_json_raw_field(empty, "a", &value));
+}
+
+void test_payload_owns_its_text_and_index() {
+  std::string json = R"({"k":"one","n":2})";
+  const json_index::json_payload_t payload(json);
+  json = R"({"k":"two"})";
+  std::string value;
+  assert(json_index::extract_json_string_field(payload, "k", &value));
+  assert(value == "one");
+  assert(json_index::extract_json_raw_field(payload, "n", &value));
+  assert(value == "2");
+  assert(payload.index().size() == 2);
+  assert(json_index::extract_json_string_field(json_index::json_payload_t(json),
+                                              "k", &value));
+  assert(value == "two");
+
+  const json_index::json_payload_t temporary(std::string(R"({"t":[1]})"));
+  assert(json_index::extract_json_raw_field(temporary, "t", &value));
+  assert(value == "[1]");
+}
+
+} // namespace
+
+int main() {
+  test_first_occurrence_and_kinds();
+  test_malformed_members_hide_later_keys();
+  test_payload_owns_its_text_and_index();
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "hero/lattice_hero/lattice/runtime_report/runtime_lls_view.h"
+
+#include <unistd.h>
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace runtime_report = cuwacunu::hero::lattice::runtime_report;
+
+namespace {
+
+void write_text(const std::filesystem::path &path, const std::string &text) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << text;
+}
+
+void test_fast_views_match_fast_kv_semantics() {
+  const std::string text = "# header\r\n"
+                           "schema = kikijyeba.lattice.test.v1\r\n"
+                           "\n"
+                           "  loss(0,+inf):double = 0.25  \n"
+                           "label[str]:str=a=b\n"
+                           "loss = 0.5";
+  std::vector<runtime_report::runtime_lls_kv_view_t> views;
+  std::string error;
+  assert(runtime_report::parse_runtime_lls_text_fast_views(text, &views,
+                                                           &error));
+  assert(error.empty());
+  assert(views.size() == 4);
+  assert(views[0].key == "schema");
+  assert(views[0].value == "kikijyeba.lattice.test.v1");
+  assert(views[1].key == "loss" && views[1].value == "0.25");
+  assert(views[2].key == "label" && views[2].value == "a=b");
+  assert(views[3].key == "loss" && views[3].value == "0.5");
+  assert(views[1].key.data() >= text.data() &&
+         views[1].key.data() < text.data() + text.size());
+
+  assert(!runtime_report::parse_runtime_lls_text_fast_views(
+      "schema=x\n=oops\n", &views, &error));
+  assert(views.empty());
+  assert(error == "runtime .lls parse failure: invalid key/value line");
+  assert(!runtime_report::parse_runtime_lls_text_fast_views("a=1\n", &views,
+                                                            &error));
+  assert(error == "persisted runtime .lls requires top-level schema key");
+}
+
+void test_file_views_and_sidecar() {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("cuwacunu_runtime_lls_view_" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const auto path = dir / "status.lls";
+  write_text(path, "schema=kikijyeba.lattice.test.v1\nstep=3\nstep=4\n");
+
+  runtime_report::runtime_lls_view_options_t options{};
+  options.use_sidecar = true;
+  options.write_sidecar = true;
+  options.verify_sidecar_digest = true;
+
+  runtime_report::runtime_lls_file_view_t first;
+  std::string error;
+  assert(runtime_report::read_runtime_lls_file_views(path, options, &first,
+                                                     &error));
+  assert(!first.loaded_from_sidecar());
+  assert(std::filesystem::exists(dir / "status.lls.kvidx"));
+  const auto *step = first.find("step");
+  assert(step != nullptr && *step == "4");
+  assert(first.to_kv_map().at("schema") == "kikijyeba.lattice.test.v1");
+
+  runtime_report::runtime_lls_file_view_t second;
+  assert(runtime_report::read_runtime_lls_file_views(path, options, &second,
+                                                     &error));
+  assert(second.loaded_from_sidecar());
+  assert(second.entries().size() == first.entries().size());
+  for (std::size_t i = 0; i < first.entries().size(); ++i) {
+    assert(second.entries()[i].key == first.entries()[i].key);
+    assert(second.entries()[i].value == first.entries()[i].value);
+  }
+
+  // Same size, new content: the digest check rejects the stale sidecar.
+  write_text(path, "schema=kikijyeba.lattice.test.v1\nstep=5\nstep=6\n");
+  runtime_report::runtime_lls_file_view_t third;
+  assert(runtime_report::read_runtime_lls_file_views(path, options, &third,
+                                                     &error));
+  assert(!third.loaded_from_sidecar());
+  assert(*third.find("step") == "6");
+
+  // Strict readers skip the unvalidated sidecar until one is marked.
+  runtime_report::runtime_lls_view_options_t strict{};
+  strict.use_sidecar = true;
+  strict.require_validated_sidecar = true;
+  runtime_report::runtime_lls_file_view_t fourth;
+  assert(runtime_report::read_runtime_lls_file_views(path, strict, &fourth,
+                                                     &error));
+  assert(!fourth.loaded_from_sidecar());
+  fourth.write_validated_sidecar();
+  runtime_report::runtime_lls_file_view_t fifth;
+  assert(runtime_report::read_runtime_lls_file_views(path, strict, &fifth,
+                                                     &error));
+  assert(fifth.loaded_from_sidecar());
+  assert(*fifth.find("step") == "6");
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    assert(entry.path().filename().string().find(".tmp") ==
+           std::string::npos);
+  }
+
+  // Replaced by rename with the same size and mtime: only the inode differs,
+  // and that alone rejects the sidecar even without the digest check.
+  runtime_report::runtime_lls_view_options_t cached{};
+  cached.use_sidecar = true;
+  cached.write_sidecar = true;
+  runtime_report::runtime_lls_file_view_t sixth;
+  assert(runtime_report::read_runtime_lls_file_views(path, cached, &sixth,
+                                                     &error));
+  const auto mtime = std::filesystem::last_write_time(path);
+  write_text(dir / "replacement.lls",
+             "schema=kikijyeba.lattice.test.v1\nstep=7\nstep=8\n");
+  std::filesystem::last_write_time(dir / "replacement.lls", mtime);
+  std::filesystem::rename(dir / "replacement.lls", path);
+  cached.write_sidecar = false;
+  runtime_report::runtime_lls_file_view_t seventh;
+  assert(runtime_report::read_runtime_lls_file_views(path, cached, &seventh,
+                                                     &error));
+  assert(!seventh.loaded_from_sidecar());
+  assert(*seventh.find("step") == "8");
+
+  write_text(dir / "empty.lls", "");
+  runtime_report::runtime_lls_file_view_t empty;
+  assert(!runtime_report::read_runtime_lls_file_views(dir / "empty.lls", {},
+                                                      &empty, &error));
+  assert(error == "persisted runtime .lls requires top-level schema key");
+  assert(!runtime_report::read_runtime_lls_file_views(dir / "missing.lls", {},
+                                                      &empty, &error));
+
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  test_fast_views_match_fast_kv_semantics();
+  test_file_views_and_sidecar();
+  return 0;
+}
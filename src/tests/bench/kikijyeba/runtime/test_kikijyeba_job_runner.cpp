@@ -3,6 +3,7 @@
 #include "tests/bench/kikijyeba/test_support/canonical_protocol_fixture.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <exception>
 #include <filesystem>
@@ -15,6 +16,7 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -1077,11 +1079,20 @@ void test_inference_dry_run_writes_manifest_and_state() {
   options.runtime_handoff_id = "runtime_handoff_test_digest";
   options.runtime_handoff_digest = "test_digest";
   options.marshal_target_driver_run_id = "target_driver_test_run";
+  options.write_trace_spans = true;
   const auto result =
       runtime::run_graph_first_job<Kline>(fixture.config.string(), options);
 
   check(result.manifest.job_kind == "channel_inference_mdn",
         "manifest job kind");
+  const auto trace_text = read_text(job_dir / "job.trace.json");
+  check(trace_text.find("\"name\":\"runtime_job.run\"") != std::string::npos,
+        "trace records the job lifecycle span");
+  check(trace_text.find("\"name\":\"runtime_job.delegate\"") !=
+            std::string::npos,
+        "trace records the delegate span");
+  check(!cuwacunu::piaabo::bench::trace::enabled(),
+        "trace spans switch off when the job finishes");
   check(result.manifest.protocol_id == "cwu_02v",
         "default inference fixture records cwu_02v protocol id");
   check(!result.manifest.config_bundle_id.empty(),
@@ -1495,6 +1506,49 @@ void test_probe_catalog_sidecar_writes_visibility_records() {
         "probe records bind dock fingerprint");
 }
 
+void test_probe_stream_writer_batches_whole_records() {
+  namespace probe = runtime::job_events_probe;
+  const auto dir = make_tmp_dir("probe_stream_writer");
+  const auto path = dir / "nested" / probe::k_job_events_probe_stream_leaf;
+  const std::string record = "record_schema=test\nsequence=1\n\n";
+  {
+    probe::probe_stream_writer_t writer(path, 4 * record.size(),
+                                        std::chrono::hours(1));
+    writer.append(record);
+    writer.append(record);
+    check(!std::filesystem::exists(path) ||
+              std::filesystem::file_size(path) == 0,
+          "probe writer buffers records below the size threshold");
+    writer.append(record);
+    writer.append(record);
+    check(std::filesystem::file_size(path) == 4 * record.size() &&
+              writer.buffered_bytes() == 0,
+          "probe writer flushes whole records at the size threshold");
+    writer.append(record);
+    writer.flush();
+    check(std::filesystem::file_size(path) == 5 * record.size(),
+          "probe writer flush publishes buffered records");
+    writer.append(record);
+  }
+  check(read_text(path).size() == 6 * record.size(),
+        "probe writer flushes on destruction");
+
+  probe::probe_stream_writer_t timed(path, std::size_t{1} << 20U,
+                                     std::chrono::milliseconds(0));
+  timed.append(record);
+  check(std::filesystem::file_size(path) == 7 * record.size(),
+        "probe writer flushes records past the time threshold");
+
+  probe::probe_stream_writer_t quiet(path, std::size_t{1} << 20U,
+                                     std::chrono::milliseconds(20));
+  quiet.append(record);
+  for (int i = 0; i < 200 && quiet.buffered_bytes() != 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  check(std::filesystem::file_size(path) == 8 * record.size(),
+        "probe writer timer flushes a quiet buffer without another append");
+}
+
 void test_probe_catalog_sidecar_writes_learning_timeseries_records() {
   const auto fixture = make_config_fixture(
       "probe_sidecar_learning_timeseries", "  SOURCE_RANGE = all;\n",
@@ -2668,20 +2722,21 @@ void test_strict_channel_baseline_runs_through_runtime() {
               std::string::npos,
       "strict baseline replay driver report carries validation-grade "
       "Cajtucu cost and feasibility evidence");
-  const auto replay_driver_trace_text =
-      read_text(replay_driver_result.experience_trace_path);
-  check(replay_driver_trace_text.find(
-            "policy_comparison_0_cajtucu_valid_trace_count=") !=
-                std::string::npos &&
-            replay_driver_trace_text.find(
-                "episode_0_transition_0_cajtucu_execution_trace_available="
-                "true") != std::string::npos &&
-            replay_driver_trace_text.find(
-                "episode_0_transition_0_cajtucu_total_transaction_cost_"
-                "numeraire=") != std::string::npos &&
-            replay_driver_trace_text.find(
-                "episode_0_transition_0_cajtucu_numeraire_fallback_pair_count="
-                "0") != std::string::npos,
+  const auto replay_driver_trace = env::output::read_experience_trace_columns(
+      replay_driver_result.experience_trace_path);
+  check(!replay_driver_trace.policy_comparisons.empty() &&
+            !replay_driver_trace.episodes.empty() &&
+            !replay_driver_trace.episodes[0].transitions.empty(),
+        "strict baseline replay driver writes a columnar experience trace");
+  const auto &replay_driver_transition =
+      replay_driver_trace.episodes[0].transitions[0];
+  check(replay_driver_trace.policy_comparisons[0].cajtucu_valid_trace_count >
+                0 &&
+            replay_driver_transition.cajtucu_execution_trace_available &&
+            std::isfinite(replay_driver_transition
+                              .cajtucu_total_transaction_cost_numeraire) &&
+            replay_driver_transition.cajtucu_numeraire_fallback_pair_count ==
+                0,
         "strict baseline replay driver experience trace carries "
         "per-transition Cajtucu validation evidence");
   check(replay_driver_report_text.find("time_law_expected_step_count=6") !=
@@ -4073,6 +4128,7 @@ int main() {
   try {
     test_inference_dry_run_writes_manifest_and_state();
     test_probe_catalog_sidecar_writes_visibility_records();
+    test_probe_stream_writer_batches_whole_records();
     test_probe_catalog_sidecar_writes_learning_timeseries_records();
     test_learning_probe_fraction_range_uses_resolved_anchor_axes();
     test_missing_probe_config_does_not_attach_sidecar();
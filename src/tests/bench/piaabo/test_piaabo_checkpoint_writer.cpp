@@ -0,0 +1,86 @@
+#include "piaabo/tensor/torch/checkpoint_writer.h"
+
+#include <cassert>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include <torch/torch.h>
+
+namespace ckpt = cuwacunu::piaabo::tensor::torch;
+
+namespace {
+
+std::filesystem::path scratch_dir() {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("cuwacunu_checkpoint_writer_" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+void test_snapshot_is_taken_at_submit() {
+  const auto dir = scratch_dir();
+  const auto path = dir / "model.pt";
+  ckpt::checkpoint_writer_t writer;
+  auto weights = torch::arange(4096, torch::kFloat32);
+  for (int step = 0; step < 8; ++step) {
+    torch::serialize::OutputArchive root;
+    root.write("weights", weights);
+    root.write("meta/step", torch::tensor({step}, torch::kInt64));
+    root.write("meta/tag_bytes", ckpt::string_metadata_tensor("step"));
+    writer.submit(root, path);
+    // Training keeps mutating the live tensor while the write runs.
+    weights.add_(1.0);
+  }
+  writer.wait();
+  const auto stats = writer.stats();
+  assert(stats.submitted == 8 && stats.written == 8);
+  assert(stats.last_bytes == std::filesystem::file_size(path));
+
+  torch::serialize::InputArchive in;
+  in.load_from(path.string());
+  torch::Tensor saved, step, tag;
+  in.read("weights", saved);
+  in.read("meta/step", step);
+  in.read("meta/tag_bytes", tag);
+  assert(step.item<int64_t>() == 7);
+  assert(torch::equal(saved, torch::arange(4096, torch::kFloat32) + 7.0));
+  assert(tag.scalar_type() == torch::kUInt8 && tag.numel() == 4);
+  const auto as_i64 = tag.to(torch::kInt64);
+  assert(as_i64[0].item<int64_t>() == 's' && as_i64[3].item<int64_t>() == 'p');
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    assert(entry.path() == path);
+  }
+  std::filesystem::remove_all(dir);
+}
+
+void test_failed_write_is_rethrown_once() {
+  const auto dir = scratch_dir();
+  ckpt::checkpoint_writer_t writer;
+  torch::serialize::OutputArchive root;
+  root.write("x", torch::ones({2}));
+  writer.submit(root, dir / "missing" / "model.pt");
+  bool threw = false;
+  try {
+    writer.wait();
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  writer.wait();
+  writer.submit(root, dir / "model.pt");
+  writer.wait();
+  assert(std::filesystem::exists(dir / "model.pt"));
+  assert(ckpt::string_metadata_tensor("").numel() == 0);
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  test_snapshot_is_taken_at_submit();
+  test_failed_write_is_rethrown_once();
+  return 0;
+}
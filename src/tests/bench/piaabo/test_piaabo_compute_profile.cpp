@@ -0,0 +1,73 @@
+#include "piaabo/tensor/torch/compute_profile.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <torch/torch.h>
+
+namespace compute = cuwacunu::piaabo::tensor::torch;
+
+namespace {
+
+void test_core_budget_caps_parallel_jobs() {
+  assert(compute::parallel_jobs_within_core_budget(8, 2, 8) == 4);
+  assert(compute::parallel_jobs_within_core_budget(3, 2, 8) == 3);
+  assert(compute::parallel_jobs_within_core_budget(8, 16, 8) == 1);
+  assert(compute::parallel_jobs_within_core_budget(8, 0, 8) == 8);
+
+  const auto cores = compute::available_compute_cores();
+  assert(compute::compute_cores_per_job({}) == cores);
+  assert(compute::compute_cores_per_job({.intra_op_threads = 1}) == 1);
+  assert(compute::compute_cores_per_job(
+             {.intra_op_threads = static_cast<std::int64_t>(cores) + 4}) ==
+         cores);
+}
+
+void test_profile_roles_and_validation() {
+  compute::compute_profile_t profile{};
+  assert(!profile.uses_inference_mode(compute::compute_role_t::train));
+  assert(profile.uses_inference_mode(compute::compute_role_t::evaluation));
+  assert(profile.uses_inference_mode(compute::compute_role_t::replay));
+  assert(profile.budget(compute::compute_role_t::replay).intra_op_threads == 1);
+
+  profile.budget(compute::compute_role_t::evaluation).inter_op_threads = -1;
+  bool threw = false;
+  try {
+    compute::validate_compute_profile(profile);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+void test_scope_applies_budget_and_inference_mode() {
+  compute::compute_profile_t profile{};
+  profile.evaluation = {.intra_op_threads = 1, .inter_op_threads = 0};
+  at::set_num_threads(2);
+  {
+    compute::compute_scope_t scope(profile,
+                                   compute::compute_role_t::evaluation);
+    assert(scope.inference_mode());
+    assert(at::get_num_threads() == 1);
+    assert(c10::InferenceMode::is_enabled());
+    assert(torch::ones({2}).is_inference());
+  }
+  assert(!c10::InferenceMode::is_enabled());
+  assert(at::get_num_threads() == 2);
+  {
+    compute::compute_scope_t scope(profile, compute::compute_role_t::train);
+    assert(!scope.inference_mode());
+    assert(!torch::ones({2}).is_inference());
+  }
+}
+
+} // namespace
+
+int main() {
+  test_core_budget_caps_parallel_jobs();
+  test_profile_roles_and_validation();
+  test_scope_applies_budget_and_inference_mode();
+  return 0;
+}
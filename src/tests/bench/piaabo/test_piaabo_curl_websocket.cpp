@@ -0,0 +1,404 @@
+#include "piaabo/network/curl/websocket_api/curl_websocket_api.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace curl = cuwacunu::piaabo::network::curl;
+
+namespace {
+
+/* SHA-1 and base64, only for the server side of the opening handshake */
+std::array<std::uint8_t, 20> sha1(const std::string &text) {
+  std::uint32_t h[5] = {0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u,
+                        0xC3D2E1F0u};
+  std::string msg = text;
+  const std::uint64_t bit_length = static_cast<std::uint64_t>(text.size()) * 8;
+  msg.push_back(static_cast<char>(0x80));
+  while (msg.size() % 64 != 56) msg.push_back('\0');
+  for (int i = 7; i >= 0; --i) {
+    msg.push_back(static_cast<char>((bit_length >> (i * 8)) & 0xFF));
+  }
+  const auto rol = [](std::uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+  };
+  for (std::size_t block = 0; block < msg.size(); block += 64) {
+    std::uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      const auto *p =
+          reinterpret_cast<const unsigned char *>(msg.data() + block + i * 4);
+      w[i] = (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+             (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+    }
+    for (int i = 16; i < 80; ++i) {
+      w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    std::uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      std::uint32_t f = 0, k = 0;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999u;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1u;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDCu;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6u;
+      }
+      const std::uint32_t t = rol(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rol(b, 30);
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+  std::array<std::uint8_t, 20> out{};
+  for (int i = 0; i < 20; ++i) {
+    out[i] = static_cast<std::uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+  }
+  return out;
+}
+
+std::string base64(const std::uint8_t *data, std::size_t size) {
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (std::size_t i = 0; i < size; i += 3) {
+    const std::uint32_t n = (std::uint32_t{data[i]} << 16) |
+                            (i + 1 < size ? std::uint32_t{data[i + 1]} << 8 : 0) |
+                            (i + 2 < size ? std::uint32_t{data[i + 2]} : 0);
+    out.push_back(kAlphabet[(n >> 18) & 63]);
+    out.push_back(kAlphabet[(n >> 12) & 63]);
+    out.push_back(i + 1 < size ? kAlphabet[(n >> 6) & 63] : '=');
+    out.push_back(i + 2 < size ? kAlphabet[n & 63] : '=');
+  }
+  return out;
+}
+
+void send_all(int fd, const std::string &bytes) {
+  std::size_t off = 0;
+  while (off < bytes.size()) {
+    const ssize_t n =
+        ::send(fd, bytes.data() + off, bytes.size() - off, MSG_NOSIGNAL);
+    if (n <= 0) return;
+    off += static_cast<std::size_t>(n);
+  }
+}
+
+std::string server_frame(unsigned char opcode, const std::string &payload) {
+  std::string out;
+  out.push_back(static_cast<char>(0x80 | opcode));
+  if (payload.size() < 126) {
+    out.push_back(static_cast<char>(payload.size()));
+  } else if (payload.size() <= 0xFFFF) {
+    out.push_back(static_cast<char>(126));
+    out.push_back(static_cast<char>((payload.size() >> 8) & 0xFF));
+    out.push_back(static_cast<char>(payload.size() & 0xFF));
+  } else {
+    out.push_back(static_cast<char>(127));
+    for (int i = 7; i >= 0; --i) {
+      out.push_back(static_cast<char>((payload.size() >> (i * 8)) & 0xFF));
+    }
+  }
+  return out + payload;
+}
+
+/*
+  Single-threaded RFC 6455 echo server on 127.0.0.1: echoes text and binary
+  frames, answers pings and closes. Its connection count is the number of
+  client sessions that reached it.
+*/
+class echo_server_t {
+public:
+  echo_server_t() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    assert(listen_fd_ >= 0);
+    const int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    const int bound =
+        ::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    const int listening = bound == 0 ? ::listen(listen_fd_, 128) : -1;
+    assert(listening == 0);
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this] { run(); });
+  }
+  ~echo_server_t() {
+    stop_ = true;
+    thread_.join();
+    for (auto &[fd, conn] : connections_) ::close(fd);
+    ::close(listen_fd_);
+  }
+
+  [[nodiscard]] int port() const { return port_; }
+  [[nodiscard]] int accepted() const { return accepted_.load(); }
+
+private:
+  struct connection_t {
+    bool upgraded = false;
+    std::string input;
+  };
+
+  void run() {
+    while (!stop_) {
+      std::vector<pollfd> fds;
+      fds.push_back({listen_fd_, POLLIN, 0});
+      for (const auto &[fd, conn] : connections_) fds.push_back({fd, POLLIN, 0});
+      if (::poll(fds.data(), fds.size(), 50) <= 0) continue;
+      if (fds[0].revents & POLLIN) {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd >= 0) {
+          connections_[fd] = connection_t{};
+          ++accepted_;
+        }
+      }
+      for (std::size_t i = 1; i < fds.size(); ++i) {
+        if (fds[i].revents == 0) continue;
+        char buffer[16384];
+        const ssize_t n = ::recv(fds[i].fd, buffer, sizeof(buffer), 0);
+        if (n <= 0 || !consume(fds[i].fd, std::string(buffer, n))) {
+          ::close(fds[i].fd);
+          connections_.erase(fds[i].fd);
+        }
+      }
+    }
+  }
+
+  /* false when the connection should be closed */
+  bool consume(int fd, const std::string &bytes) {
+    auto &conn = connections_[fd];
+    conn.input += bytes;
+    if (!conn.upgraded) {
+      const auto end = conn.input.find("\r\n\r\n");
+      if (end == std::string::npos) return true;
+      const auto key_at = conn.input.find("Sec-WebSocket-Key:");
+      if (key_at == std::string::npos) return false;
+      auto key_begin = key_at + std::strlen("Sec-WebSocket-Key:");
+      while (conn.input[key_begin] == ' ') ++key_begin;
+      const std::string key = conn.input.substr(
+          key_begin, conn.input.find("\r\n", key_begin) - key_begin);
+      const auto digest = sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+      send_all(fd, "HTTP/1.1 101 Switching Protocols\r\n"
+                   "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                   "Sec-WebSocket-Accept: " +
+                       base64(digest.data(), digest.size()) + "\r\n\r\n");
+      conn.upgraded = true;
+      conn.input.erase(0, end + 4);
+    }
+    while (conn.input.size() >= 2) {
+      const auto *p = reinterpret_cast<const unsigned char *>(conn.input.data());
+      const unsigned char opcode = p[0] & 0x0F;
+      std::uint64_t length = p[1] & 0x7F;
+      std::size_t header = 2;
+      if (length == 126) {
+        if (conn.input.size() < 4) return true;
+        length = (std::uint64_t{p[2]} << 8) | p[3];
+        header = 4;
+      } else if (length == 127) {
+        if (conn.input.size() < 10) return true;
+        length = 0;
+        for (int i = 0; i < 8; ++i) length = (length << 8) | p[2 + i];
+        header = 10;
+      }
+      const bool masked = (p[1] & 0x80) != 0;
+      const std::size_t total = header + (masked ? 4 : 0) + length;
+      if (conn.input.size() < total) return true;
+      std::string payload = conn.input.substr(header + (masked ? 4 : 0), length);
+      if (masked) {
+        for (std::size_t i = 0; i < payload.size(); ++i) {
+          payload[i] = static_cast<char>(payload[i] ^ p[header + i % 4]);
+        }
+      }
+      conn.input.erase(0, total);
+      if (opcode == 0x1 || opcode == 0x2) {
+        send_all(fd, server_frame(opcode, payload));
+      } else if (opcode == 0x9) {
+        send_all(fd, server_frame(0xA, payload));
+      } else if (opcode == 0x8) {
+        send_all(fd, server_frame(0x8, payload));
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic<bool> stop_{false};
+  std::atomic<int> accepted_{0};
+  std::map<int, connection_t> connections_;
+  std::thread thread_;
+};
+
+int thread_count() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) return std::stoi(line.substr(8));
+  }
+  return -1;
+}
+
+std::string message(int session, int k) {
+  return "{\"id\":\"s" + std::to_string(session) + "-" + std::to_string(k) +
+         "\",\"value\":" + std::to_string(k) + "}";
+}
+
+void test_sessions_share_one_event_loop() {
+  echo_server_t server;
+  const std::string url = "ws://127.0.0.1:" + std::to_string(server.port()) + "/";
+  constexpr int kSessions = 24;
+  constexpr int kMessages = 20;
+
+  const int threads_before = thread_count();
+  std::vector<curl::ws_session_id_t> ids;
+  for (int i = 0; i < kSessions; ++i) {
+    const auto id = curl::WebsocketAPI::ws_init(url);
+    assert(id != NULL_CURL_SESSION);
+    ids.push_back(id);
+  }
+  const int threads_after = thread_count();
+  /* one event loop plus the callback executor, however many sessions */
+  assert(threads_after - threads_before <= 3);
+  assert(server.accepted() == kSessions);
+
+  /* Writers on several threads; every echo comes back to its own session */
+  std::vector<std::thread> writers;
+  std::atomic<int> echoed{0};
+  for (int w = 0; w < 4; ++w) {
+    writers.emplace_back([&, w] {
+      for (int s = w; s < kSessions; s += 4) {
+        for (int k = 0; k < kMessages; ++k) {
+          const std::string frame_id =
+              "s" + std::to_string(s) + "-" + std::to_string(k);
+          const auto queued =
+              curl::WebsocketAPI::ws_write_text(ids[s], message(s, k), frame_id);
+          assert(queued == frame_id);
+        }
+        for (int k = 0; k < kMessages; ++k) {
+          const auto response =
+              curl::WebsocketAPI::ws_await_and_retrieve_server_response(
+                  ids[s], "s" + std::to_string(s) + "-" + std::to_string(k));
+          assert(response.has_value());
+          assert(response->data == message(s, k));
+          ++echoed;
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  assert(echoed.load() == kSessions * kMessages);
+
+  /* Callback delivery keeps the session's frame order */
+  std::mutex mtx;
+  std::condition_variable done;
+  std::vector<std::string> received;
+  constexpr int kStream = 200;
+  curl::WebsocketAPI::ws_set_message_callback(
+      ids[0], [&](curl::ws_session_id_t session_id,
+                  const curl::ws_incoming_data_t &frame) {
+        assert(session_id == ids[0]);
+        std::lock_guard<std::mutex> lock(mtx);
+        received.push_back(frame.frame_id);
+        if (received.size() == kStream) done.notify_all();
+      });
+  for (int k = 0; k < kStream; ++k) {
+    curl::WebsocketAPI::ws_write_text(ids[0], message(0, 1000 + k));
+  }
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    const bool complete = done.wait_for(
+        lock, std::chrono::seconds(5), [&] { return received.size() == kStream; });
+    assert(complete);
+    for (int k = 0; k < kStream; ++k) {
+      assert(received[k] == "s0-" + std::to_string(1000 + k));
+    }
+  }
+
+  /* A stalled callback drops frames; the event loop keeps serving others */
+  bool released = false;
+  int delivered = 0;
+  curl::WebsocketAPI::ws_set_message_callback(
+      ids[0], [&](curl::ws_session_id_t, const curl::ws_incoming_data_t &) {
+        std::unique_lock<std::mutex> lock(mtx);
+        done.wait(lock, [&] { return released; });
+        ++delivered;
+      });
+  const auto dropped_before = curl::WebsocketAPI::ws_dropped_callback_frames();
+  constexpr int kFlood = 1500;
+  for (int k = 0; k < kFlood; ++k) {
+    curl::WebsocketAPI::ws_write_text(ids[0], message(0, 2000 + k));
+  }
+  const auto dropped = [&] {
+    return static_cast<int>(curl::WebsocketAPI::ws_dropped_callback_frames() -
+                            dropped_before);
+  };
+  const auto flood_deadline = std::chrono::steady_clock::now() + WS_MAX_WAIT;
+  while (dropped() == 0 && std::chrono::steady_clock::now() < flood_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  assert(dropped() > 0);
+  curl::WebsocketAPI::ws_write_text(ids[1], message(1, 9000), "s1-9000");
+  const auto unblocked =
+      curl::WebsocketAPI::ws_await_and_retrieve_server_response(ids[1],
+                                                                "s1-9000");
+  assert(unblocked.has_value() && unblocked->data == message(1, 9000));
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    released = true;
+  }
+  done.notify_all();
+  /* every flooded frame is either delivered or counted as dropped */
+  const auto drain_deadline = std::chrono::steady_clock::now() + WS_MAX_WAIT;
+  bool drained = false;
+  while (!drained && std::chrono::steady_clock::now() < drain_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::lock_guard<std::mutex> lock(mtx);
+    drained = delivered + dropped() == kFlood;
+  }
+  assert(drained);
+
+  const auto finalize_started = std::chrono::steady_clock::now();
+  for (const auto id : ids) curl::WebsocketAPI::ws_finalize(id);
+  assert(std::chrono::steady_clock::now() - finalize_started < WS_MAX_WAIT);
+}
+
+} // namespace
+
+int main() {
+  test_sessions_share_one_event_loop();
+  std::printf("[PASS] curl websocket sessions share one event loop\n");
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "piaabo/tensor/torch/device_metric_accumulator.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <torch/torch.h>
+
+namespace ptorch = cuwacunu::piaabo::tensor::torch;
+
+namespace {
+
+template <typename Fn> void expect_throw(Fn &&fn) {
+  bool threw = false;
+  try {
+    fn();
+  } catch (const std::exception &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+void test_device_metric_accumulator_contract() {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  const std::vector<std::vector<double>> steps = {
+      {1.25, nan}, {inf, 0.5}, {-2.0, 3.0}};
+  ptorch::device_metric_accumulator_t accumulator(2);
+  assert(accumulator.commit_count() == 0);
+  accumulator.materialize();
+  assert(std::isnan(accumulator.mean_or_nan(0)));
+
+  double host_sum[2] = {0.0, 0.0};
+  int64_t host_count[2] = {0, 0};
+  for (const auto &row : steps) {
+    for (std::size_t slot = 0; slot < row.size(); ++slot) {
+      accumulator.stage(slot,
+                        ::torch::tensor(row[slot], ::torch::kFloat32));
+      const double as_item = ::torch::tensor(row[slot], ::torch::kFloat32)
+                                 .to(::torch::kFloat64)
+                                 .item<double>();
+      if (std::isfinite(as_item)) {
+        host_sum[slot] += as_item;
+        ++host_count[slot];
+      }
+    }
+    accumulator.commit();
+  }
+  accumulator.materialize();
+  assert(accumulator.commit_count() == 3);
+  for (std::size_t slot = 0; slot < 2; ++slot) {
+    assert(accumulator.count(slot) == host_count[slot]);
+    assert(accumulator.sum(slot) == host_sum[slot]);
+    assert(accumulator.mean_or_nan(slot) ==
+           host_sum[slot] / static_cast<double>(host_count[slot]));
+  }
+  assert(accumulator.last(0) == -2.0);
+  assert(accumulator.max(0) == 1.25);
+  assert(accumulator.max(1) == 3.0);
+
+  accumulator.stage(0, ::torch::Tensor{});
+  accumulator.commit();
+  accumulator.materialize();
+  assert(std::isnan(accumulator.last(0)));
+  assert(std::isnan(accumulator.last(1)));
+  assert(accumulator.count(0) == host_count[0]);
+  expect_throw([&] { accumulator.stage(2, ::torch::tensor(1.0)); });
+
+  const auto scalars = ptorch::materialize_scalars(
+      {::torch::tensor(4.0), ::torch::Tensor{},
+       ::torch::tensor({2, 3}, ::torch::kInt64).sum()});
+  assert(scalars.size() == 3);
+  assert(scalars[0] == 4.0);
+  assert(std::isnan(scalars[1]));
+  assert(scalars[2] == 5.0);
+}
+
+} // namespace
+
+int main() {
+  test_device_metric_accumulator_contract();
+  return 0;
+}
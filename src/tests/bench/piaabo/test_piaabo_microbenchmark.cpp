@@ -0,0 +1,104 @@
+#include "piaabo/bench/microbenchmark.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bench = cuwacunu::piaabo::bench;
+
+namespace {
+
+bool near(double actual, double expected) {
+  return std::fabs(actual - expected) < 1e-9;
+}
+
+void test_percentiles_interpolate_order_statistics() {
+  std::vector<double> samples;
+  for (int i = 100; i >= 1; --i) {
+    samples.push_back(static_cast<double>(i));
+  }
+  const auto d = bench::summarize_samples(samples, 0.95);
+  assert(near(d.min, 1.0) && near(d.max, 100.0));
+  assert(near(d.mean, 50.5));
+  assert(near(d.p50, 50.5));
+  assert(near(d.p95, 95.05));
+  assert(near(d.p99, 99.01));
+  // Order-statistic ranks n*q -/+ 1.96*sqrt(n*q*(1-q)) for n=100, q=0.5.
+  assert(near(d.p50_ci.lower, 40.0) && near(d.p50_ci.upper, 60.0));
+  assert(d.p95_ci.lower <= d.p95 && d.p95 <= d.p95_ci.upper);
+  assert(near(d.p99_ci.upper, 100.0));
+
+  const auto one = bench::summarize_samples({7.0});
+  assert(near(one.p50, 7.0) && near(one.p99, 7.0) && near(one.stddev, 0.0));
+  assert(near(one.p95_ci.lower, 7.0) && near(one.p95_ci.upper, 7.0));
+}
+
+void test_run_separates_warmup_and_clocks() {
+  std::size_t calls = 0;
+  const auto result = bench::run_microbench(
+      "spin", bench::microbench_options_t{.warmup = 4, .repetitions = 9}, [&] {
+        ++calls;
+        double x = 0.0;
+        for (int i = 0; i < 20000; ++i) {
+          x += std::sqrt(static_cast<double>(i));
+        }
+        bench::do_not_optimize(x);
+      });
+  assert(calls == 13);
+  assert(result.warmup == 4 && result.repetitions == 9);
+  assert(result.wall_ns.min > 0.0);
+  assert(result.cpu_ns.max > 0.0);
+  assert(result.wall_ns.p50 <= result.wall_ns.p95 &&
+         result.wall_ns.p95 <= result.wall_ns.p99);
+}
+
+void test_report_json_is_stable() {
+  bench::microbench_report_t report{};
+  report.suite = "suite\"x";
+  report.commit = "abc123";
+  bench::microbench_result_t result{};
+  result.name = "case";
+  result.warmup = 1;
+  result.repetitions = 2;
+  result.wall_ns = bench::summarize_samples({1.0, 3.0});
+  result.cpu_ns = bench::summarize_samples({1.0, 3.0});
+  report.results.push_back(result);
+  const auto json = bench::microbench_report_json(report);
+  assert(json.rfind("{\"schema\":\"cuwacunu.microbench.v1\"", 0) == 0);
+  assert(json.find("\"suite\":\"suite\\\"x\"") != std::string::npos);
+  assert(json.find("\"commit\":\"abc123\"") != std::string::npos);
+  assert(json.find("\"wall_ns\":{\"mean\":2.000,\"stddev\":1.414,") !=
+         std::string::npos);
+  assert(json.find("\"p50_ci\":[1.000,3.000]") != std::string::npos);
+  assert(json == bench::microbench_report_json(report));
+}
+
+void test_cli_parses_sampling_flags() {
+  const char *argv[] = {"bench",    "--warmup", "2",        "--repetitions",
+                        "50",       "--json",   "out.json", "--commit",
+                        "deadbeef"};
+  const auto cli = bench::parse_microbench_cli(9, const_cast<char **>(argv));
+  assert(cli.options.warmup == 2 && cli.options.repetitions == 50);
+  assert(cli.json_path == "out.json" && cli.commit == "deadbeef");
+
+  const char *bad[] = {"bench", "--samples", "3"};
+  bool rejected = false;
+  try {
+    (void)bench::parse_microbench_cli(3, const_cast<char **>(bad));
+  } catch (const std::invalid_argument &) {
+    rejected = true;
+  }
+  assert(rejected);
+}
+
+} // namespace
+
+int main() {
+  test_percentiles_interpolate_order_statistics();
+  test_run_separates_warmup_and_clocks();
+  test_report_json_is_stable();
+  test_cli_parses_sampling_flags();
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "piaabo/tensor/torch/mixed_precision.h"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include <torch/torch.h>
+
+namespace precision = cuwacunu::piaabo::tensor::torch;
+
+namespace {
+
+void test_policy_names_round_trip() {
+  for (const auto policy : {precision::precision_policy_t::float32,
+                            precision::precision_policy_t::bf16_autocast}) {
+    assert(precision::parse_precision_policy(
+               precision::precision_policy_name(policy)) == policy);
+  }
+  assert(precision::parse_precision_policy("") ==
+         precision::precision_policy_t::float32);
+  bool threw = false;
+  try {
+    (void)precision::parse_precision_policy("fp8");
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+void test_effective_policy_falls_back_to_float32() {
+  const auto bf16 = precision::precision_policy_t::bf16_autocast;
+  assert(precision::effective_precision_policy(
+             bf16, torch::Device(torch::kCPU), torch::kFloat64) ==
+         precision::precision_policy_t::float32);
+  assert(precision::effective_precision_policy(
+             bf16, torch::Device(torch::kCUDA, 0)) ==
+         precision::precision_policy_t::float32);
+  assert(precision::effective_precision_policy(
+             bf16, torch::Device(torch::kCPU)) ==
+         (precision::cpu_has_native_bf16()
+              ? bf16
+              : precision::precision_policy_t::float32));
+}
+
+void test_fallback_reason_names_the_downgrade() {
+  const auto bf16 = precision::precision_policy_t::bf16_autocast;
+  const torch::Device cpu(torch::kCPU);
+  assert(precision::precision_policy_fallback_reason(
+             precision::precision_policy_t::float32,
+             torch::Device(torch::kCUDA, 0))
+             .empty());
+  assert(precision::precision_policy_fallback_reason(
+             bf16, torch::Device(torch::kCUDA, 0)) == "device_not_cpu");
+  assert(precision::precision_policy_fallback_reason(
+             bf16, cpu, torch::kFloat64) == "dtype_not_float32");
+  assert(precision::precision_policy_fallback_reason("bf16_autocast", cpu) ==
+         (precision::cpu_has_native_bf16() ? ""
+                                           : "cpu_without_native_bf16"));
+}
+
+void test_widen_keeps_float32_and_float64() {
+  const auto bf16 = torch::ones({2}, torch::kBFloat16);
+  assert(precision::widen_reduced_precision(bf16).scalar_type() ==
+         torch::kFloat32);
+  const auto f64 = torch::ones({2}, torch::kFloat64);
+  assert(precision::widen_reduced_precision(f64).scalar_type() ==
+         torch::kFloat64);
+  assert(!precision::widen_reduced_precision(torch::Tensor{}).defined());
+}
+
+void test_scopes_switch_matmul_dtype_and_restore() {
+  const auto a = torch::randn({4, 8});
+  const auto b = torch::randn({8, 3});
+  {
+    precision::autocast_scope_t autocast(
+        precision::precision_policy_t::float32);
+    assert(torch::mm(a, b).scalar_type() == torch::kFloat32);
+  }
+  {
+    precision::autocast_scope_t autocast(
+        precision::precision_policy_t::bf16_autocast);
+    assert(torch::mm(a, b).scalar_type() == torch::kBFloat16);
+    {
+      precision::float32_scope_t float32;
+      assert(torch::mm(a, b).scalar_type() == torch::kFloat32);
+    }
+    assert(torch::mm(a, b).scalar_type() == torch::kBFloat16);
+  }
+  assert(torch::mm(a, b).scalar_type() == torch::kFloat32);
+}
+
+void test_bf16_forward_keeps_float32_master_weights() {
+  torch::manual_seed(7);
+  auto net = torch::nn::Sequential(torch::nn::Linear(16, 32),
+                                   torch::nn::ReLU(), torch::nn::Linear(32, 4));
+  const auto x = torch::randn({64, 16});
+  const auto y = torch::randn({64, 4});
+  const auto reference = torch::mse_loss(net->forward(x), y).item<double>();
+
+  torch::Tensor out;
+  {
+    precision::autocast_scope_t autocast(
+        precision::precision_policy_t::bf16_autocast);
+    out = net->forward(x);
+  }
+  assert(out.scalar_type() == torch::kBFloat16);
+  const auto loss =
+      torch::mse_loss(precision::widen_reduced_precision(out), y);
+  loss.backward();
+  for (const auto &param : net->parameters()) {
+    assert(param.scalar_type() == torch::kFloat32);
+    assert(param.grad().scalar_type() == torch::kFloat32);
+  }
+  assert(std::abs(loss.item<double>() - reference) <=
+         5e-2 * std::abs(reference));
+}
+
+} // namespace
+
+int main() {
+  test_policy_names_round_trip();
+  test_effective_policy_falls_back_to_float32();
+  test_fallback_reason_names_the_downgrade();
+  test_widen_keeps_float32_and_float64();
+  test_scopes_switch_matmul_dtype_and_restore();
+  test_bf16_forward_keeps_float32_master_weights();
+  return 0;
+}
@@ -1,20 +1,26 @@
+#include "piaabo/digest/sha256.h"
 #include "piaabo/io/files.h"
+#include "piaabo/parse/bnf/compiled_grammar.h"
 #include "piaabo/parse/bnf/grammar_lexer.h"
 #include "piaabo/parse/bnf/grammar_parser.h"
 #include "piaabo/parse/bnf/instruction_lexer.h"
 #include "piaabo/parse/bnf/instruction_parser.h"
 #include "piaabo/parse/json/json_parsing.h"
 
+#include <array>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <stdexcept>
 #include <string>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <vector>
 
 namespace bnf = cuwacunu::piaabo::parse::bnf;
+namespace digest = cuwacunu::piaabo::digest;
 namespace io = cuwacunu::piaabo::io;
 namespace json = cuwacunu::piaabo::parse::json;
 
@@ -102,6 +108,106 @@ void test_bnf_repetition_allows_zero_items() {
   expect_throw([&] { parser.parse_Instruction("abx"); });
 }
 
+void test_bnf_packrat_and_compiled_grammar_cache() {
+  /* every <e> alternative re-parses <t>; without memoization nesting depth d
+   * costs 3^d rule attempts */
+  const std::string grammar_text = R"bnf(
+<instruction> ::= <expr> ;
+<expr>        ::= <term> "+" <expr> | <term> "-" <expr> | <term> ;
+<term>        ::= "(" <expr> ")" | "x" ;
+)bnf";
+  const std::string nested =
+      std::string(40, '(') + "x+x" + std::string(40, ')') + "-x";
+
+  const auto compiled = bnf::compileGrammarText(grammar_text);
+  assert(compiled == bnf::compileGrammarText(grammar_text));
+  const std::size_t term = compiled->ruleId("<term>");
+  assert(!compiled->nullable[term]);
+  assert(compiled->first_sets[term].test('(') &&
+         compiled->first_sets[term].test('x') &&
+         !compiled->first_sets[term].test('+'));
+  assert(compiled->rejects(term, '+', false) && compiled->rejects(term, 0, true));
+
+  bnf::InstructionLexer lexer;
+  bnf::InstructionParser parser(lexer, compiled);
+  const bnf::ASTNodePtr ast = parser.parse_Instruction(nested);
+  assert(ast != nullptr);
+  const bnf::ASTNodePtr copy = bnf::cloneAST(ast.get());
+  assert(bnf::compareAST(ast.get(), copy.get()));
+  expect_throw([&] { parser.parse_Instruction(nested + ")"); });
+
+  const std::string prefix =
+      "/tmp/cuwacunu_piaabo_bnf_cache_" + std::to_string(getpid());
+  const std::string grammar_path = prefix + ".bnf";
+  const auto cache_path = bnf::compiledGrammarCachePath(grammar_path);
+  std::remove(cache_path.c_str());
+  write_text(grammar_path, grammar_text);
+
+  bnf::CompiledGrammar loaded;
+  assert(!bnf::loadCompiledGrammar(cache_path, grammar_text, &loaded));
+  assert(bnf::loadGrammarFileCached(grammar_path) == compiled);
+  bnf::saveCompiledGrammar(*compiled, grammar_text, cache_path);
+  assert(bnf::loadCompiledGrammar(cache_path, grammar_text, &loaded));
+  assert(loaded.rule_strings == compiled->rule_strings);
+  assert(loaded.first_sets == compiled->first_sets);
+  assert(loaded.terminal_literals == compiled->terminal_literals);
+  assert(!bnf::loadCompiledGrammar(cache_path, grammar_text + " ", &loaded));
+
+  bnf::InstructionLexer cached_lexer;
+  bnf::InstructionParser cached_parser(
+      cached_lexer, std::make_shared<const bnf::CompiledGrammar>(loaded));
+  const bnf::ASTNodePtr cached_ast = cached_parser.parse_Instruction(nested);
+  assert(bnf::compareAST(ast.get(), cached_ast.get()));
+
+  std::remove(cache_path.c_str());
+  std::remove(grammar_path.c_str());
+}
+
+/* a fresh process (cuwacunu_exec run) starts with an empty memo; the second
+ * one must reuse the "<grammar>.compiled" written by the first */
+void test_bnf_grammar_file_cache_across_processes() {
+  const std::string grammar_text = R"bnf(
+<instruction> ::= <item> {<more>} ;
+<more>        ::= "," <item> ;
+<item>        ::= "a" | "b" ;
+)bnf";
+  const std::string grammar_path = "/tmp/cuwacunu_piaabo_bnf_file_cache_" +
+                                   std::to_string(getpid()) + ".bnf";
+  const auto cache_path = bnf::compiledGrammarCachePath(grammar_path);
+  std::remove(cache_path.c_str());
+  write_text(grammar_path, grammar_text);
+
+  const auto load_in_child = [&](std::size_t want_file_hits,
+                                 std::size_t want_compiles) {
+    const pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+      /* counters are inherited across fork; compare deltas */
+      const auto before = bnf::grammarFileCacheStats();
+      const auto file = bnf::readGrammarFileCached(grammar_path);
+      bnf::InstructionLexer lexer;
+      bnf::InstructionParser parser(lexer, file.compiled);
+      const bool parsed = parser.parse_Instruction("a,b,a") != nullptr;
+      const auto after = bnf::grammarFileCacheStats();
+      _exit(parsed && file.text == grammar_text &&
+                    after.memo_hits == before.memo_hits &&
+                    after.file_hits - before.file_hits == want_file_hits &&
+                    after.compiles - before.compiles == want_compiles
+                ? 0
+                : 1);
+    }
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  };
+  assert(load_in_child(/*want_file_hits=*/0, /*want_compiles=*/1));
+  assert(std::filesystem::exists(cache_path));
+  assert(load_in_child(/*want_file_hits=*/1, /*want_compiles=*/0));
+
+  std::remove(cache_path.c_str());
+  std::remove(grammar_path.c_str());
+}
+
 void test_csv_conversion_fails_without_partial_publish() {
   const std::string prefix =
       "/tmp/cuwacunu_piaabo_csv_contract_" + std::to_string(getpid());
@@ -135,11 +241,142 @@ void test_csv_conversion_fails_without_partial_publish() {
   std::remove(tmp_path.c_str());
 }
 
+void test_parallel_csv_ingest_matches_sequential_read() {
+  const std::string prefix =
+      "/tmp/cuwacunu_piaabo_csv_ingest_" + std::to_string(getpid());
+  const std::string csv_path = prefix + ".csv";
+  const std::string bin_path = prefix + ".bin";
+
+  std::string text;
+  for (int i = 1; i <= 5000; ++i) {
+    text += std::to_string(i) + "," + std::to_string(i) + ".25\n";
+  }
+  text += "5001,0.5"; /* last line without a newline still counts */
+  write_text(csv_path, text);
+
+  const io::csv_ingest_options_t options{.worker_count = 4,
+                                         .chunk_bytes = 1024};
+  std::vector<std::size_t> line_numbers;
+  std::vector<int> ids;
+  io::for_each_csv_record<csv_row_t>(
+      csv_path, ',',
+      [&](const csv_row_t &row, std::size_t line_number) {
+        line_numbers.push_back(line_number);
+        ids.push_back(row.id);
+        return true;
+      },
+      options);
+  assert(ids.size() == 5001);
+  assert(io::count_csv_lines(csv_path) == 5001);
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    assert(line_numbers[i] == i + 1);
+    assert(ids[i] == static_cast<int>(i + 1));
+  }
+
+  io::csvFile_to_binary<csv_row_t>(csv_path, bin_path, 1, ',', options);
+  const auto rows = io::binaryFile_to_vector<csv_row_t>(bin_path, 1);
+  assert(rows.size() == 5001);
+  assert(rows[4999].id == 5000 && rows[4999].value == 5000.25F);
+  assert(rows[5000].id == 5001 && rows[5000].value == 0.5F);
+
+  /* early stop */
+  std::size_t seen = 0;
+  io::for_each_csv_record<csv_row_t>(
+      csv_path, ',',
+      [&](const csv_row_t &, std::size_t) { return ++seen < 10; }, options);
+  assert(seen == 10);
+
+  /* a bad line deep in the file reports its own line number, after every
+   * record before it was delivered */
+  write_text(csv_path, text.substr(0, text.find("4000,")) + "bad-line\n" +
+                           text.substr(text.find("4000,")));
+  io::csv_ingest_failure_t failure;
+  std::size_t delivered = 0;
+  bool threw = false;
+  try {
+    io::for_each_csv_record<csv_row_t>(
+        csv_path, ',',
+        [&](const csv_row_t &, std::size_t) {
+          ++delivered;
+          return true;
+        },
+        options, &failure);
+  } catch (const std::runtime_error &e) {
+    threw = true;
+    assert(std::string(e.what()) == "missing delimiter at line 4000");
+  }
+  assert(threw);
+  assert(delivered == 3999);
+  assert(failure.line_number == 4000);
+  assert(failure.line == "bad-line");
+
+  write_text(csv_path, "");
+  assert(io::count_csv_lines(csv_path) == 0);
+
+  std::remove(csv_path.c_str());
+  std::remove(bin_path.c_str());
+}
+
+void test_sha256_streaming_matches_one_shot() {
+  assert(digest::sha256_hex("") ==
+         "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  assert(digest::sha256_hex("abc") ==
+         "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+  std::string payload;
+  for (std::size_t i = 0; i < 4099; ++i) {
+    payload.push_back(static_cast<char>((i * 131U + 7U) & 0xffU));
+  }
+  for (const std::size_t size : {55U, 56U, 64U, 65U, 4099U}) {
+    const std::string_view view(payload.data(), size);
+    digest::sha256_ctx_t ctx;
+    for (std::size_t offset = 0; offset < size; offset += 7U) {
+      ctx.update(view.substr(offset, 7U));
+    }
+    assert(ctx.final_hex() == digest::sha256_hex(view));
+    expect_throw([&] { ctx.update("x"); });
+    ctx.init();
+    assert(ctx.update(view).final_hex() == digest::sha256_hex(view));
+
+    std::array<std::uint32_t, 8> scalar = digest::detail::kSha256InitialState;
+    std::array<std::uint32_t, 8> dispatched = scalar;
+    const auto *blocks = reinterpret_cast<const unsigned char *>(view.data());
+    digest::detail::sha256_compress_scalar(scalar.data(), blocks, size / 64U);
+    digest::detail::sha256_compress_kernel()(dispatched.data(), blocks,
+                                             size / 64U);
+    assert(scalar == dispatched);
+  }
+
+  const std::string prefix =
+      "/tmp/cuwacunu_piaabo_sha256_contract_" + std::to_string(getpid());
+  std::vector<std::filesystem::path> paths;
+  for (std::size_t i = 0; i < 3; ++i) {
+    paths.emplace_back(prefix + "_" + std::to_string(i) + ".bin");
+    write_text(paths.back().string(), payload.substr(0, 1000U * i + 1U));
+    assert(digest::sha256_file_hex(paths.back(), /*chunk_bytes=*/64U) ==
+           digest::sha256_hex(payload.substr(0, 1000U * i + 1U)));
+  }
+  const auto batch = digest::sha256_files_hex(paths, /*max_parallel_jobs=*/2);
+  assert(batch.size() == paths.size());
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    assert(batch[i] == digest::sha256_file_hex(paths[i]));
+  }
+  paths.emplace_back(prefix + "_missing.bin");
+  expect_throw([&] { (void)digest::sha256_files_hex(paths, 2); });
+  for (const auto &path : paths) {
+    std::remove(path.c_str());
+  }
+}
+
 } // namespace
 
 int main() {
   test_json_validity_is_strict();
   test_bnf_repetition_allows_zero_items();
+  test_bnf_packrat_and_compiled_grammar_cache();
+  test_bnf_grammar_file_cache_across_processes();
   test_csv_conversion_fails_without_partial_publish();
+  test_parallel_csv_ingest_matches_sequential_read();
+  test_sha256_streaming_matches_one_shot();
   return 0;
 }
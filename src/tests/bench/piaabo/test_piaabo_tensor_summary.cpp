@@ -0,0 +1,133 @@
+#include "piaabo/tensor/torch/tensor_summary.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <torch/torch.h>
+
+namespace summary = cuwacunu::piaabo::tensor::torch;
+
+namespace {
+
+bool near(double a, double b, double tol) {
+  return std::abs(a - b) <= tol * (1.0 + std::abs(b));
+}
+
+void test_fused_moments_match_separate_reductions() {
+  torch::manual_seed(7);
+  auto values = torch::randn({4099}, torch::kFloat64);
+  values.index_put_({0}, std::numeric_limits<double>::quiet_NaN());
+  values.index_put_({1}, std::numeric_limits<double>::infinity());
+  values.index_put_({2}, -std::numeric_limits<double>::infinity());
+  values.index_put_({3}, 0.0);
+  values.index_put_({4}, 1e-10);
+
+  summary::tensor_moments_options_t options{};
+  options.near_zero_epsilon = 1e-8;
+  options.log10_abs_bins = 16;
+  options.log10_abs_min = -12.0;
+  options.log10_abs_max = 6.0;
+  options.log10_abs_offset = 1e-8;
+  const auto m = summary::summarize_tensor_moments(values, options);
+
+  const auto finite = values.masked_select(torch::isfinite(values));
+  const auto abs = finite.abs();
+  assert(m.count == 4099);
+  assert(m.nan_count == 1 && m.inf_count == 2);
+  assert(m.finite_count == static_cast<std::uint64_t>(finite.numel()));
+  assert(near(m.sum, finite.sum().item<double>(), 1e-12));
+  assert(near(m.sum_sq, finite.square().sum().item<double>(), 1e-12));
+  assert(near(m.sum_abs, abs.sum().item<double>(), 1e-12));
+  assert(m.min == finite.min().item<double>());
+  assert(m.max == finite.max().item<double>());
+  assert(m.max_abs == abs.max().item<double>());
+  assert(m.exact_zero_count == 1);
+  assert(m.near_zero_count == 2);
+  assert(m.non_zero_abs_count == m.finite_count - 1);
+  const auto positive = abs.masked_select(abs.gt(0.0));
+  assert(near(m.sum_abs_log_abs,
+              (positive * positive.log()).sum().item<double>(), 1e-12));
+
+  const auto logabs = (abs + 1e-8).log10().clamp(-12.0, 6.0);
+  const auto idx = torch::clamp(
+      ((logabs + 12.0) / 18.0 * 16.0).to(torch::kLong), 0, 15);
+  const auto expected = torch::bincount(idx, {}, 16);
+  assert(m.log10_abs_histogram.size() == 16);
+  for (std::int64_t i = 0; i < 16; ++i) {
+    assert(m.log10_abs_histogram[static_cast<std::size_t>(i)] ==
+           static_cast<std::uint64_t>(expected[i].item<std::int64_t>()));
+  }
+  assert(m.log10_abs_values.empty());
+
+  // Reduced-precision and integer inputs go through the same pass.
+  const auto half = summary::summarize_tensor_moments(
+      torch::tensor({1.0, -2.0, 0.5}).to(torch::kBFloat16));
+  assert(half.finite_count == 3 && half.sum == -0.5 && half.max_abs == 2.0);
+  const auto ints =
+      summary::summarize_tensor_moments(torch::arange(5, torch::kLong));
+  assert(ints.sum == 10.0 && ints.exact_zero_count == 1);
+}
+
+void test_moments_do_not_depend_on_thread_count() {
+  torch::manual_seed(11);
+  const auto values = torch::randn({300001}, torch::kFloat32);
+  const int threads = at::get_num_threads();
+  at::set_num_threads(1);
+  const auto serial = summary::summarize_tensor_moments(values);
+  at::set_num_threads(4);
+  const auto parallel = summary::summarize_tensor_moments(values);
+  at::set_num_threads(threads);
+  assert(serial.sum == parallel.sum);
+  assert(serial.sum_sq == parallel.sum_sq);
+  assert(serial.sum_abs_log_abs == parallel.sum_abs_log_abs);
+}
+
+void test_randomized_spectrum_is_bounded_by_exact() {
+  torch::manual_seed(3);
+  const auto left = torch::randn({256, 6}, torch::kFloat64);
+  const auto right = torch::randn({6, 192}, torch::kFloat64);
+  const auto matrix =
+      left.mm(right) + 0.01 * torch::randn({256, 192}, torch::kFloat64);
+
+  summary::matrix_spectrum_options_t exact_options{};
+  exact_options.exact = true;
+  const auto exact = summary::summarize_matrix_spectrum(matrix, exact_options);
+  assert(exact.exact && exact.singular_values.size() == 192);
+  assert(exact.residual_frobenius == 0.0 && exact.tail_count == 0);
+
+  summary::matrix_spectrum_options_t options{};
+  options.rank = 8;
+  const auto fast = summary::summarize_matrix_spectrum(matrix, options);
+  assert(!fast.exact);
+  assert(fast.singular_values.size() == 16 && fast.tail_count == 176);
+  const double sigma = exact.spectral_norm();
+  assert(fast.spectral_norm() <= sigma * (1.0 + 1e-12));
+  assert(sigma <= fast.spectral_norm_upper_bound() * (1.0 + 1e-12));
+  assert(fast.spectral_norm_relative_error_bound() < 0.1);
+  assert(near(fast.spectral_norm(), sigma, 1e-9));
+  assert(near(fast.stable_rank(), exact.stable_rank(), 1e-8));
+
+  // The leading rank dominates, so the even tail split stays close.
+  assert(std::abs(fast.effective_rank() - exact.effective_rank()) <
+         0.25 * exact.effective_rank());
+
+  // Same seed, same probes.
+  const auto again = summary::summarize_matrix_spectrum(matrix, options);
+  assert(again.singular_values == fast.singular_values);
+
+  // A sketch as wide as the matrix falls back to exact values.
+  options.rank = 400;
+  assert(summary::summarize_matrix_spectrum(matrix, options).exact);
+}
+
+} // namespace
+
+int main() {
+  test_fused_moments_match_separate_reductions();
+  test_moments_do_not_depend_on_thread_count();
+  test_randomized_spectrum_is_bounded_by_exact();
+  return 0;
+}
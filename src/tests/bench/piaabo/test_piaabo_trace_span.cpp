@@ -0,0 +1,129 @@
+#include "piaabo/bench/trace_span.h"
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace trace = cuwacunu::piaabo::bench::trace;
+
+namespace {
+
+std::size_t count_occurrences(const std::string &text,
+                              const std::string &needle) {
+  std::size_t count = 0;
+  for (auto pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+void test_disabled_spans_record_nothing() {
+  trace::set_enabled(false);
+  trace::clear();
+  {
+    PIAABO_TRACE_SPAN("test", "ignored");
+  }
+  assert(trace::event_count() == 0);
+}
+
+void test_nested_spans_are_complete_events() {
+  trace::clear();
+  trace::set_enabled(true);
+  {
+    PIAABO_TRACE_SPAN("test", "outer");
+    {
+      PIAABO_TRACE_SPAN("test", "inner");
+    }
+  }
+  trace::set_enabled(false);
+  const auto threads = trace::snapshot();
+  assert(threads.size() == 1);
+  const auto &events = threads.front().events;
+  assert(events.size() == 2);
+  // Inner closes first; the outer span must contain it.
+  assert(std::string(events[0].name) == "inner");
+  assert(std::string(events[1].name) == "outer");
+  assert(events[1].start_ns <= events[0].start_ns);
+  assert(events[0].start_ns + events[0].duration_ns <=
+         events[1].start_ns + events[1].duration_ns);
+
+  const auto json = trace::chrome_trace_json();
+  assert(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+  assert(json.find("{\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\",") !=
+         std::string::npos);
+  assert(json.find("\"pid\":" + std::to_string(::getpid())) !=
+         std::string::npos);
+  // Sorted by start time: outer precedes inner.
+  assert(json.find("\"outer\"") < json.find("\"inner\""));
+  trace::clear();
+}
+
+void test_threads_get_distinct_tids() {
+  trace::clear();
+  trace::set_enabled(true);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([] {
+      for (int i = 0; i < 100; ++i) {
+        PIAABO_TRACE_SPAN("test", "worker");
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  trace::set_enabled(false);
+  const auto threads = trace::snapshot();
+  std::set<std::uint64_t> tids;
+  std::size_t events = 0;
+  for (const auto &thread : threads) {
+    tids.insert(thread.tid);
+    events += thread.events.size();
+  }
+  assert(tids.size() == 4);
+  assert(events == 400);
+  trace::clear();
+}
+
+void test_session_writes_trace_file() {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("cuwacunu_trace_span_" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+  const auto path = dir / "job" / "job.trace.json";
+  {
+    trace::trace_session_t session(path);
+    assert(session.active() && trace::enabled());
+    PIAABO_TRACE_SPAN("test", "session");
+  }
+  assert(!trace::enabled());
+  assert(trace::event_count() == 0);
+  std::ifstream in(path);
+  const std::string text((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  assert(count_occurrences(text, "\"ph\":\"X\"") == 1);
+  assert(text.find("\"name\":\"session\"") != std::string::npos);
+  assert(!std::filesystem::exists(path.string() + ".tmp"));
+
+  trace::trace_session_t inactive(dir / "unused.json", false);
+  assert(!inactive.active() && !trace::enabled());
+  assert(inactive.finish());
+  assert(!std::filesystem::exists(dir / "unused.json"));
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  test_disabled_spans_record_nothing();
+  test_nested_spans_are_complete_events();
+  test_threads_get_distinct_tids();
+  test_session_writes_trace_file();
+  return 0;
+}
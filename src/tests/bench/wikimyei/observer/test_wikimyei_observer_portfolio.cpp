@@ -1,6 +1,10 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -376,6 +380,232 @@ void test_nodelift_projection_and_coupler() {
         "projected marginal combines asset and reference mixtures");
 }
 
+void test_mixture_quantile_newton_and_batch_sampler() {
+  auto f64 = torch::TensorOptions().dtype(torch::kFloat64);
+  // One unimodal and one well-separated bimodal marginal.
+  auto log_weight = torch::tensor({{0.5, 0.3, 0.2}, {0.5, 0.5, 1.0e-6}}, f64)
+                        .log();
+  auto mu = torch::tensor({{0.00, 0.01, -0.01}, {-0.05, 0.05, 0.0}}, f64);
+  auto sigma = torch::tensor({{0.02, 0.03, 0.01}, {0.001, 0.002, 0.01}}, f64);
+  auto uniforms = torch::rand({256, 2}, f64).clamp(1.0e-6, 1.0 - 1.0e-6);
+  auto reference = observer::mixture_quantile(log_weight, mu, sigma, uniforms,
+                                              /*bisection_steps=*/60);
+  observer::mixture_quantile_workspace_t workspace{};
+  auto newton = observer::mixture_quantile_newton(
+      log_weight, mu, sigma, uniforms, /*max_steps=*/40,
+      /*tolerance=*/1.0e-10, &workspace);
+  check((newton - reference).abs().max().item<double>() < 1.0e-8,
+        "Newton mixture quantile matches fine bisection");
+  check(workspace.last_iterations < 40,
+        "Newton mixture quantile converges before the step cap");
+  // The bimodal marginal needs more iterations than the unimodal one; lanes
+  // that converge early must not keep moving while it finishes.
+  bool lanes_match_solo = true;
+  for (const std::int64_t sample : {0, 17, 255}) {
+    for (std::int64_t asset = 0; asset < 2; ++asset) {
+      auto solo = observer::mixture_quantile_newton(
+          log_weight.narrow(0, asset, 1), mu.narrow(0, asset, 1),
+          sigma.narrow(0, asset, 1),
+          uniforms.narrow(0, sample, 1).narrow(1, asset, 1),
+          /*max_steps=*/40, /*tolerance=*/1.0e-10);
+      lanes_match_solo =
+          lanes_match_solo &&
+          torch::equal(solo.reshape({}), newton.index({sample, asset}));
+    }
+  }
+  check(lanes_match_solo,
+        "Newton mixture quantile lanes match their solo inversions");
+
+  auto corr = torch::tensor({{1.0, 0.35}, {0.35, 1.0}}, f64);
+  observer::covariance_coupler_options_t options{};
+  options.sample_count = 32;
+  options.factor_cache =
+      std::make_shared<observer::covariance_coupler_factor_cache_t>();
+  auto surface_log_weight = log_weight.unsqueeze(0).repeat({3, 1, 1});
+  auto batch = observer::sample_anchor_batch_marginals(
+      surface_log_weight, mu.unsqueeze(0).repeat({3, 1, 1}),
+      sigma.unsqueeze(0).repeat({3, 1, 1}), std::vector<int64_t>{0, 1}, corr,
+      options);
+  check(batch.samples.sizes() == torch::IntArrayRef({3, 32, 2}),
+        "batched coupler samples [B,S,M]");
+  check(batch.covariance.sizes() == torch::IntArrayRef({3, 2, 2}),
+        "batched coupler covariance [B,M,M]");
+  check(torch::isfinite(batch.samples).all().item<bool>(),
+        "batched coupler samples finite");
+  auto single = observer::sample_single_anchor_marginals(
+      surface_log_weight, mu.unsqueeze(0).repeat({3, 1, 1}),
+      sigma.unsqueeze(0).repeat({3, 1, 1}), /*anchor_slot=*/1,
+      std::vector<int64_t>{0, 1}, corr, options);
+  check(single.samples.sizes() == torch::IntArrayRef({32, 2}),
+        "single-anchor coupler samples [S,M]");
+  check(options.factor_cache->misses == 1 && options.factor_cache->hits == 1,
+        "unchanged empirical correlation reuses the Cholesky factor");
+  check(torch::allclose(single.correlation, batch.correlation),
+        "cached correlation matches the first repair");
+}
+
+// Per-anchor reference for the batched builder: the single-anchor belief
+// pipeline as it stood before build_allocation_belief_rows, assembled here
+// from the observer utilities so the batch is not checked against its own
+// core. Only the fields compared by the parity check are kept.
+struct reference_allocation_belief_t {
+  torch::Tensor valid_mask{};
+  torch::Tensor expected_log_return{};
+  torch::Tensor scenarios{};
+  torch::Tensor covariance{};
+  torch::Tensor var_down{};
+  torch::Tensor cvar_down{};
+  torch::Tensor volatility{};
+  torch::Tensor adverse_excursion_prob{};
+  torch::Tensor mixture_entropy{};
+  torch::Tensor component_disagreement{};
+  torch::Tensor channel_disagreement{};
+  torch::Tensor liquidity_score{};
+  torch::Tensor capacity_weight_limit{};
+  torch::Tensor confidence{};
+};
+
+reference_allocation_belief_t reference_single_anchor_belief(
+    const mdn::MdnOut &out,
+    const belief::allocation_belief_builder_options_t &options) {
+  using torch::indexing::Slice;
+  const auto b = options.anchor_slot;
+  const auto A = static_cast<std::int64_t>(options.node_graph_indices.size());
+  const auto reference = static_cast<std::int64_t>(
+      std::find(options.graph_node_ids.begin(), options.graph_node_ids.end(),
+                options.base_policy.projection_reference_node_id) -
+      options.graph_node_ids.begin());
+  std::vector<std::int64_t> universe = options.node_graph_indices;
+  auto reference_it = std::find(universe.begin(), universe.end(), reference);
+  if (reference_it == universe.end()) {
+    universe.push_back(reference);
+    reference_it = std::prev(universe.end());
+  }
+  const auto reference_position =
+      static_cast<std::int64_t>(reference_it - universe.begin());
+
+  auto consensus = observer::compute_uniform_valid_channel_consensus(
+      out, options.channel_mask);
+  auto surface =
+      observer::from_channel_consensus(consensus, options.surface_options);
+  const auto device = surface.log_weight.device();
+  const auto f64 =
+      torch::TensorOptions().dtype(torch::kFloat64).device(device);
+  auto graph_index = torch::tensor(
+      options.node_graph_indices,
+      torch::TensorOptions().dtype(torch::kInt64).device(device));
+  const auto anchor_nodes = [&](const torch::Tensor &x) {
+    return x.select(/*dim=*/0, b).index_select(/*dim=*/0, graph_index);
+  };
+
+  auto active = torch::ones(
+      {A}, torch::TensorOptions().dtype(torch::kBool).device(device));
+  if (surface.active_mask.defined()) {
+    auto anchor_active = surface.active_mask.select(/*dim=*/0, b);
+    active = anchor_nodes(surface.active_mask)
+                 .to(torch::kBool)
+                 .logical_and(anchor_active.select(/*dim=*/0, reference)
+                                  .to(torch::kBool));
+  }
+  auto coupled = observer::sample_single_anchor_marginals(
+      surface.log_weight, surface.potential_mu, surface.potential_sigma, b,
+      universe, options.empirical_potential_correlation,
+      options.projection_options.coupling_options);
+  auto log_return =
+      coupled.samples.narrow(/*dim=*/1, 0, A) -
+      coupled.samples.select(/*dim=*/1, reference_position).unsqueeze(1);
+  auto inactive = active.logical_not().unsqueeze(0);
+  auto scenarios = (torch::exp(log_return) - 1.0).masked_fill(inactive, 0.0);
+  log_return = log_return.masked_fill(inactive, 0.0);
+  for (std::int64_t a = 0; a < A; ++a) {
+    if (options.node_graph_indices[static_cast<std::size_t>(a)] != reference) {
+      continue;
+    }
+    log_return.index_put_({Slice(), a}, 0.0);
+    scenarios.index_put_({Slice(), a}, 0.0);
+    active.index_put_({a}, true);
+  }
+  const auto S = scenarios.size(0);
+  auto centered = scenarios - scenarios.mean(/*dim=*/0, /*keepdim=*/true);
+  auto marginal_variance =
+      (centered.pow(2).sum(/*dim=*/0) /
+       static_cast<double>(std::max<std::int64_t>(S - 1, 1)))
+          .clamp_min(0.0)
+          .to(f64);
+
+  auto tails = observer::compute_node_tail_risk(scenarios);
+  auto ranges = observer::compute_range_risk(
+      consensus, options.node_graph_indices, reference, options.range_options);
+  auto flow = observer::compute_flow_liquidity(consensus,
+                                               options.flow_liquidity_options);
+  auto realized_variance = options.realized_variance.defined()
+                               ? options.realized_variance.to(f64)
+                               : marginal_variance;
+  auto vol = observer::blend_mdn_and_realized_variance(
+      marginal_variance, realized_variance, options.volatility_options);
+
+  auto pi = surface.log_weight.exp();
+  auto entropy = -(pi * surface.log_weight).sum(/*dim=*/-1);
+  const auto Kc = surface.log_weight.size(-1);
+  auto normalized_entropy =
+      Kc <= 1 ? torch::zeros_like(entropy)
+              : (entropy / std::log(static_cast<double>(Kc))).clamp(0.0, 1.0);
+  auto disagreement =
+      (pi * (surface.potential_mu - surface.expected_potential.unsqueeze(-1))
+                .pow(2))
+          .sum(/*dim=*/-1);
+  auto channel_disagreement =
+      anchor_nodes(consensus.channel_disagreement.select(
+                       2, options.surface_options.close_coord))
+          .to(f64);
+  auto liquidity_score =
+      anchor_nodes(flow.liquidity_score).to(f64).clamp(0.0, 1.0);
+  auto capacity =
+      options.capacity_weight_limit.defined()
+          ? options.capacity_weight_limit.to(f64).clamp(0.0, 1.0)
+          : anchor_nodes(flow.capacity_weight_limit).to(f64).clamp(0.0, 1.0);
+  auto tradable = options.tradable_mask.defined()
+                      ? options.tradable_mask.to(active.options())
+                      : torch::ones_like(active);
+
+  observer::confidence_inputs_t inputs{};
+  inputs.data_quality_score =
+      options.data_quality_score.defined()
+          ? options.data_quality_score.to(f64).clamp(0.0, 1.0)
+          : torch::ones({A}, f64);
+  inputs.liquidity_score = liquidity_score;
+  inputs.calibration_score = observer::neutral_calibration_score(A, f64);
+  inputs.entropy_score =
+      observer::score_from_normalized_entropy(
+          anchor_nodes(normalized_entropy).to(torch::kCPU))
+          .to(f64);
+  inputs.channel_score = observer::score_from_channel_disagreement(
+                             channel_disagreement.to(torch::kCPU),
+                             options.channel_disagreement_confidence_scale)
+                             .to(f64);
+  inputs.surprise_score = observer::neutral_surprise_score(A, f64);
+
+  reference_allocation_belief_t ref{};
+  ref.confidence = observer::compute_confidence(inputs, A, f64)
+                       .masked_fill(active.logical_not(), 0.0)
+                       .masked_fill(tradable.logical_not(), 0.0);
+  ref.valid_mask = active;
+  ref.expected_log_return = log_return.mean(/*dim=*/0).to(f64);
+  ref.covariance = observer::scenario_covariance(scenarios).to(f64);
+  ref.scenarios = scenarios.to(f64);
+  ref.var_down = tails.var_down.to(f64);
+  ref.cvar_down = tails.cvar_down.to(f64);
+  ref.volatility = vol.volatility.to(f64);
+  ref.adverse_excursion_prob =
+      ranges.adverse_excursion_prob.select(/*dim=*/0, b).to(f64);
+  ref.mixture_entropy = anchor_nodes(entropy).to(f64);
+  ref.component_disagreement = anchor_nodes(disagreement).to(f64);
+  ref.channel_disagreement = std::move(channel_disagreement);
+  ref.liquidity_score = std::move(liquidity_score);
+  ref.capacity_weight_limit = std::move(capacity);
+  return ref;
+}
+
 void test_allocation_belief_builder() {
   auto out = make_fixture_mdn();
   auto mask = torch::tensor(
@@ -478,6 +708,55 @@ void test_allocation_belief_builder() {
   batch_options.common.projection_options.coupling_options.sample_count = 32;
   batch_options.anchor_keys = {"batch_anchor_0", "batch_anchor_1"};
   batch_options.timestamps_ms = {3000, 4000};
+  torch::manual_seed(17);
+  std::vector<reference_allocation_belief_t> sequential;
+  for (std::int64_t b = 0; b < 2; ++b) {
+    auto single = batch_options.common;
+    single.anchor_slot = b;
+    sequential.push_back(reference_single_anchor_belief(batch_out, single));
+  }
+  torch::manual_seed(17);
+  auto batch_result =
+      belief::build_allocation_belief_batch_result(batch_out, batch_options);
+  for (std::size_t b = 0; b < 2; ++b) {
+    const auto &lhs = batch_result.belief_batch.beliefs[b];
+    const auto &rhs = sequential[b];
+    // Deterministic fields are elementwise; sampled fields go through the
+    // batched quantile solve and agree within the Newton tolerance.
+    const auto same = [](const torch::Tensor &x, const torch::Tensor &y) {
+      return x.sizes() == y.sizes() &&
+             torch::allclose(x, y, /*rtol=*/0.0, /*atol=*/1e-12);
+    };
+    const auto sampled = [](const torch::Tensor &x, const torch::Tensor &y) {
+      return x.sizes() == y.sizes() &&
+             torch::allclose(x, y, /*rtol=*/1e-7, /*atol=*/1e-8);
+    };
+    check(sampled(lhs.expected_log_return, rhs.expected_log_return) &&
+              sampled(lhs.scenarios, rhs.scenarios) &&
+              sampled(lhs.covariance, rhs.covariance) &&
+              sampled(lhs.var_down, rhs.var_down) &&
+              sampled(lhs.cvar_down, rhs.cvar_down) &&
+              sampled(lhs.volatility, rhs.volatility),
+          "batched belief builder matches the per-anchor reference scenarios");
+    check(same(lhs.adverse_excursion_prob, rhs.adverse_excursion_prob) &&
+              same(lhs.mixture_entropy, rhs.mixture_entropy) &&
+              same(lhs.component_disagreement, rhs.component_disagreement) &&
+              same(lhs.channel_disagreement, rhs.channel_disagreement) &&
+              same(lhs.liquidity_score, rhs.liquidity_score) &&
+              same(lhs.capacity_weight_limit, rhs.capacity_weight_limit) &&
+              same(lhs.confidence, rhs.confidence) &&
+              lhs.valid_mask.equal(rhs.valid_mask),
+          "batched belief builder matches the per-anchor reference scores");
+  }
+  check(batch_result.collated.scenarios.storage().is_alias_of(
+            batch_result.belief_batch.beliefs[1].scenarios.storage()),
+        "batched beliefs are views of the collated tensors");
+  auto anchor_result = belief::select_anchor_build_result(
+      batch_result, 1, batch_options.common.scenario_bank_options);
+  check(anchor_result.scenario_bank.base_scenarios.sizes() ==
+            torch::IntArrayRef({32, 3}),
+        "batched anchor result carries a stress bank");
+
   auto batch = belief::build_allocation_belief_batch(batch_out, batch_options);
   check(batch.beliefs.size() == 2, "belief batch builder size");
   check(batch.beliefs[0].anchor_key == "batch_anchor_0",
@@ -1230,6 +1509,7 @@ int main() {
     test_auxiliary_observers();
     test_projection_validation_and_residual_quality();
     test_nodelift_projection_and_coupler();
+    test_mixture_quantile_newton_and_batch_sampler();
     test_allocation_belief_builder();
     test_belief_contract_and_portfolio_engine();
     test_method_support_allocators();
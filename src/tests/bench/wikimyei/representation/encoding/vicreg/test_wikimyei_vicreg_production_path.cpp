@@ -11,8 +11,13 @@
 #include "wikimyei/representation/encoding/vicreg/vicreg_projector.h"
 #include "wikimyei/representation/encoding/vicreg/vicreg_train_model.h"
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
@@ -467,6 +472,114 @@ void test_channel_train_models_and_streams() {
   check(stream_batch.reducer_weights.sizes() ==
             torch::IntArrayRef({2, 2, 2, 4}),
         "production channel representation stream carries reducer weights");
+  {
+    const auto cache_root = std::filesystem::temp_directory_path() /
+                            ("cuwacunu_embedding_cache_test_" +
+                             std::to_string(::getpid()));
+    std::filesystem::remove_all(cache_root);
+    std::filesystem::create_directories(cache_root);
+    const auto checkpoint_path = cache_root / "representation.pt";
+    {
+      std::ofstream checkpoint(checkpoint_path, std::ios::binary);
+      checkpoint << "frozen-representation-bytes";
+    }
+    const auto source_cache_path =
+        cache_root / "edge.cache.norm.log_returns.bin";
+    {
+      std::ofstream source_cache(source_cache_path, std::ios::binary);
+      source_cache << "normalized-source-bytes";
+    }
+    for (const auto &path : {checkpoint_path, source_cache_path}) {
+      std::filesystem::last_write_time(
+          path, std::filesystem::file_time_type::clock::now() -
+                    std::chrono::hours(1));
+    }
+    const std::vector<std::filesystem::path> source_cache_paths{
+        source_cache_path};
+    vicreg_stream::representation_embedding_cache_identity_t identity{};
+    identity.representation_checkpoint_digest =
+        vicreg_stream::representation_checkpoint_file_digest(checkpoint_path);
+    identity.source_cursor_token = "test-source-cursor";
+    identity.source_cache_fingerprint =
+        vicreg_stream::representation_source_cache_fingerprint(
+            source_cache_paths);
+    identity.lift_config_digest = "test-nodelift-config";
+    identity.graph_order_fingerprint = lifted.graph_order_fingerprint;
+    identity.component_assembly_id = "vicreg_v1";
+    identity.dtype =
+        vicreg_stream::representation_embedding_cache_dtype_t::float32;
+    vicreg_stream::representation_embedding_cache_t cache(
+        cache_root / "embeddings", identity, checkpoint_path,
+        source_cache_paths);
+    auto first = vicreg_stream::make_channel_representation_stream_batch(
+        encoder, lifted, /*require_finite_valid_features=*/true,
+        /*detach_to_cpu=*/true, runtime_lls::runtime_report_mode_t::normal,
+        "vicreg_v1", "wikimyei.representation.vicreg.v1", {},
+        "wikimyei.representation.encoding.vicreg",
+        "wikimyei.representation.vicreg.runtime.v1", {}, &cache);
+    check(cache.misses() == 1 && cache.writes() == 1 && cache.hits() == 0,
+          "embedding cache encodes and stores an unseen anchor batch");
+    auto second = vicreg_stream::make_channel_representation_stream_batch(
+        encoder, lifted, /*require_finite_valid_features=*/true,
+        /*detach_to_cpu=*/true, runtime_lls::runtime_report_mode_t::normal,
+        "vicreg_v1", "wikimyei.representation.vicreg.v1", {},
+        "wikimyei.representation.encoding.vicreg",
+        "wikimyei.representation.vicreg.runtime.v1", {}, &cache);
+    check(cache.hits() == 1 && cache.writes() == 1,
+          "embedding cache serves a seen anchor batch without encoding");
+    check(torch::equal(first.node_encoding, second.node_encoding) &&
+              torch::equal(first.node_encoding_mask,
+                           second.node_encoding_mask) &&
+              torch::equal(first.reducer_weights, second.reducer_weights),
+          "float32 embedding cache reproduces the encoder output exactly");
+
+    identity.dtype =
+        vicreg_stream::representation_embedding_cache_dtype_t::float16;
+    vicreg_stream::representation_embedding_cache_t half_cache(
+        cache_root / "embeddings", identity, checkpoint_path,
+        source_cache_paths);
+    check(half_cache.namespace_dir() != cache.namespace_dir(),
+          "embedding cache dtype is part of the cache namespace");
+    auto relifted_identity = identity;
+    relifted_identity.lift_config_digest = "other-nodelift-config";
+    check(relifted_identity.namespace_digest() != identity.namespace_digest(),
+          "embedding cache NodeLift config is part of the cache namespace");
+    const auto anchor_key =
+        vicreg_stream::representation_embedding_anchor_key(lifted.cursor);
+    vicreg::channel_preserving_encoder_output_t encoded{};
+    encoded.reduced = torch::randn({3, 2, 5});
+    encoded.reduced_mask =
+        torch::tensor({true, false, true, true, false, true}, torch::kBool)
+            .view({3, 2});
+    half_cache.store(anchor_key, encoded);
+    auto half = half_cache.lookup(anchor_key, torch::kFloat32);
+    check(half.has_value() && !half->reducer_weights.defined() &&
+              half->reduced.scalar_type() == torch::kFloat32 &&
+              torch::allclose(half->reduced, encoded.reduced, 1e-3, 1e-3) &&
+              torch::equal(half->reduced_mask, encoded.reduced_mask),
+          "float16 embedding cache widens shards back to the encoder dtype");
+
+    std::filesystem::last_write_time(
+        checkpoint_path,
+        std::filesystem::file_time_type::clock::now() + std::chrono::hours(1));
+    check(!cache.lookup(anchor_key, torch::kFloat32).has_value(),
+          "embedding cache shards older than the checkpoint are stale");
+    std::filesystem::last_write_time(
+        checkpoint_path,
+        std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    check(half_cache.lookup(anchor_key, torch::kFloat32).has_value(),
+          "embedding cache shards newer than every input are fresh");
+    const auto source_fingerprint = identity.source_cache_fingerprint;
+    std::filesystem::last_write_time(
+        source_cache_path,
+        std::filesystem::file_time_type::clock::now() + std::chrono::hours(1));
+    check(!half_cache.lookup(anchor_key, torch::kFloat32).has_value(),
+          "embedding cache shards older than a source cache are stale");
+    check(vicreg_stream::representation_source_cache_fingerprint(
+              source_cache_paths) != source_fingerprint,
+          "rebuilt source caches move the embedding cache namespace");
+    std::filesystem::remove_all(cache_root);
+  }
   auto debug_stream_batch =
       vicreg_stream::make_channel_representation_stream_batch(
           encoder, lifted,
@@ -488,11 +601,17 @@ void test_channel_train_models_and_streams() {
   auto reducer_mask =
       torch::tensor({true, true, true, true, true, false}, torch::kBool)
           .view({1, 1, 2, 3});
-  close(
-      vicreg_stream::channel_representation_stream_detail::
-          reducer_last_valid_weight_mean_or_nan(reducer_weights, reducer_mask),
-      0.7, 1e-6,
-      "reducer diagnostic gathers the anchor-nearest valid history weight");
+  close(vicreg_stream::channel_representation_stream_detail::
+            reducer_last_valid_weight_mean_tensor(reducer_weights,
+                                                  reducer_mask)
+                .item<double>(),
+        0.7, 1e-6,
+        "reducer diagnostic gathers the anchor-nearest valid history weight");
+  check(std::isnan(vicreg_stream::channel_representation_stream_detail::
+                       reducer_weight_entropy_tensor(
+                           reducer_weights, torch::zeros_like(reducer_mask))
+                           .item<double>()),
+        "reducer diagnostic is NaN when no history cell is valid");
   check(
       debug_stream_batch.runtime_lls.find("reducer_last_valid_weight_mean") !=
           std::string::npos,
@@ -833,6 +952,85 @@ void test_vicreg_safe_augmentations() {
         "full feature dropout view2 fraction is zero");
 }
 
+void test_vicreg_loss_masked_matches_gather() {
+  torch::manual_seed(41);
+  vicreg::vicreg_loss_options_t options{};
+  options.global_aux_weight = 0.5;
+
+  const auto expect_parity = [&](const torch::Tensor &z1,
+                                 const torch::Tensor &mask1,
+                                 const torch::Tensor &z2,
+                                 const torch::Tensor &mask2,
+                                 const std::string &label, bool backward) {
+    auto a1 = z1.clone().requires_grad_(true);
+    auto b1 = z1.clone().requires_grad_(true);
+    const auto masked =
+        vicreg::compute_vicreg_loss_masked(a1, mask1, z2, mask2, options);
+    const auto gather =
+        vicreg::compute_vicreg_loss_gather(b1, mask1, z2, mask2, options);
+    check(masked.valid_rows.item<int64_t>() ==
+              gather.valid_rows.item<int64_t>(),
+          label + " valid row counts match");
+    check(torch::equal(masked.per_channel_valid_rows,
+                       gather.per_channel_valid_rows),
+          label + " per-channel valid rows match");
+    const auto same = [&](const torch::Tensor &lhs, const torch::Tensor &rhs,
+                          const std::string &what) {
+      check(torch::allclose(lhs, rhs, /*rtol=*/1e-9, /*atol=*/1e-10),
+            label + " " + what + " matches the gather reference");
+    };
+    same(masked.loss, gather.loss, "loss");
+    same(masked.global_loss, gather.global_loss, "global loss");
+    same(masked.per_channel_invariance_loss, gather.per_channel_invariance_loss,
+         "per-channel invariance");
+    same(masked.per_channel_variance_loss, gather.per_channel_variance_loss,
+         "per-channel variance");
+    same(masked.per_channel_covariance_loss,
+         gather.per_channel_covariance_loss, "per-channel covariance");
+    same(masked.per_channel_norm_mean, gather.per_channel_norm_mean,
+         "per-channel norm");
+    same(masked.cross_channel_similarity, gather.cross_channel_similarity,
+         "cross-channel similarity");
+    if (backward) {
+      masked.loss.backward();
+      gather.loss.backward();
+      same(a1.grad(), b1.grad(), "gradient");
+    }
+  };
+
+  auto z1 = torch::randn({5, 3, 4, 6}, torch::kFloat64);
+  auto z2 = torch::randn({5, 3, 4, 6}, torch::kFloat64);
+  auto mask1 = torch::rand({5, 3, 4}).gt(0.3);
+  auto mask2 = torch::rand({5, 3, 4}).gt(0.3);
+  // Channel 1 keeps a single row and channel 2 none, covering both guards.
+  mask1.index_put_({torch::indexing::Slice(), 1}, false);
+  mask1.index_put_({0, 1, 0}, true);
+  mask2.index_put_({0, 1, 0}, true);
+  mask1.index_put_({torch::indexing::Slice(), 2}, false);
+  z1.index_put_({torch::indexing::Slice(), 2}, 1.0e20);
+  expect_parity(z1, mask1, z2, mask2, "rank-4", /*backward=*/true);
+
+  auto r1 = torch::randn({7, 2, 4}, torch::kFloat64);
+  auto r2 = torch::randn({7, 2, 4}, torch::kFloat64);
+  auto rmask = torch::ones({7, 2}, torch::kBool);
+  rmask.index_put_({3, 0}, false);
+  expect_parity(r1, rmask, r2, rmask, "rank-3", /*backward=*/true);
+
+  const auto empty = torch::zeros({7, 2}, torch::kBool);
+  expect_parity(r1, empty, r2, empty, "empty", /*backward=*/false);
+
+  check(vicreg::parse_vicreg_loss_impl("gather") ==
+            vicreg::vicreg_loss_impl_t::gather,
+        "loss impl parser accepts gather");
+  bool rejected = false;
+  try {
+    (void)vicreg::parse_vicreg_loss_impl("dense");
+  } catch (const std::runtime_error &) {
+    rejected = true;
+  }
+  check(rejected, "loss impl parser rejects unknown tokens");
+}
+
 void test_production_assemblies() {
   const auto representation = vicreg::make_vicreg_assembly();
   const auto global_fusion = vicreg::make_channel_global_fusion_assembly();
@@ -1035,6 +1233,68 @@ void test_channel_mdn_train_model_sanitizes_masked_sentinels() {
         1e-6, "masked invalid future values are sanitized before MDN NLL");
 }
 
+void test_bf16_autocast_losses_track_float32() {
+  namespace precision = cuwacunu::piaabo::tensor::torch;
+  auto lifted = make_lifted_batch();
+  auto input = vicreg::make_channel_node_encoder_input(lifted);
+
+  auto vicreg_step = [&](precision::precision_policy_t policy) {
+    torch::manual_seed(151);
+    auto encoder = vicreg::ChannelPreservingEncoder(make_encoder_options());
+    vicreg::vicreg_projector_options_t popts{};
+    popts.input_dim = 5;
+    popts.projector_dim = 6;
+    popts.hidden_dim = 8;
+    auto projector = vicreg::VicregProjector(popts);
+    vicreg::vicreg_train_options_t train_opts{};
+    train_opts.jitter_std = 0.001;
+    train_opts.precision_policy = policy;
+    vicreg::vicreg_train_model_t train(encoder, projector, 0.001, train_opts);
+    return train.train_one_batch(input.data, input.feature_mask);
+  };
+  const auto vicreg_fp32 = vicreg_step(precision::precision_policy_t::float32);
+  const auto vicreg_bf16 =
+      vicreg_step(precision::precision_policy_t::bf16_autocast);
+  check(!vicreg_fp32.skipped && !vicreg_bf16.skipped,
+        "bf16 autocast VICReg step is applied");
+  check(vicreg_bf16.loss.scalar_type() == torch::kFloat32,
+        "bf16 autocast VICReg loss is reduced in float32");
+  const auto vicreg_ref = vicreg_fp32.loss.item<double>();
+  close(vicreg_bf16.loss.item<double>(), vicreg_ref,
+        std::max(5e-2 * std::abs(vicreg_ref), 1e-2),
+        "bf16 autocast VICReg loss tracks the float32 path");
+
+  auto mdn_input = mdn::channel_mdn_input_t{};
+  torch::manual_seed(152);
+  mdn_input.context = torch::randn({8, 2, 2, 5}, torch::kFloat32);
+  mdn_input.context_mask = torch::ones({8, 2, 2}, torch::kBool);
+  mdn_input.future = torch::randn({8, 2, 2, 2}, torch::kFloat32);
+  mdn_input.future_mask = torch::ones({8, 2, 2, 2}, torch::kBool);
+  auto mdn_step = [&](precision::precision_policy_t policy) {
+    torch::manual_seed(153);
+    auto model = mdn::ChannelContextMdn(5, 2, 2, 1, 3, 16, 1);
+    mdn::channel_context_mdn_train_options_t options{};
+    options.precision_policy = policy;
+    mdn::channel_context_mdn_train_model_t train(model, 0.001, options);
+    auto result = train.train_one_batch(mdn_input);
+    for (const auto &param : model->parameters()) {
+      check(param.scalar_type() == torch::kFloat32,
+            "bf16 autocast keeps float32 master weights");
+    }
+    return result;
+  };
+  const auto mdn_fp32 = mdn_step(precision::precision_policy_t::float32);
+  const auto mdn_bf16 = mdn_step(precision::precision_policy_t::bf16_autocast);
+  check(mdn_bf16.optimizer_step_applied && mdn_bf16.nonfinite_output_count == 0,
+        "bf16 autocast MDN step is applied with finite outputs");
+  check(mdn_bf16.nll.scalar_type() == torch::kFloat32,
+        "bf16 autocast MDN NLL is reduced in float32");
+  const auto nll_ref = mdn_fp32.nll.item<double>();
+  close(mdn_bf16.nll.item<double>(), nll_ref,
+        std::max(5e-2 * std::abs(nll_ref), 1e-2),
+        "bf16 autocast MDN NLL tracks the float32 path");
+}
+
 } // namespace
 
 int main() {
@@ -1046,6 +1306,7 @@ int main() {
     test_channel_mdn_plus_global_is_separate_and_mask_safe();
     test_channel_mdn_plus_global_train_model_sanitizes_masked_sentinels();
     test_vicreg_safe_augmentations();
+    test_vicreg_loss_masked_matches_gather();
     test_production_assemblies();
     test_channel_mdn_zero_valid_targets();
     test_channel_mdn_close_coord_resolves_selected_target_slot();
@@ -1054,6 +1315,7 @@ int main() {
     test_channel_mdn_direct_edge_readout_warmup_updates_only_head();
     test_channel_mdn_direct_edge_readout_fixed_batch_loss_decreases();
     test_channel_mdn_train_model_sanitizes_masked_sentinels();
+    test_bf16_autocast_losses_track_float32();
     std::cout << "[test_wikimyei_vicreg_production_path] all checks "
                  "passed\n";
     return 0;
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+#include "cajtucu/execution/assembly.h"
+#include "piaabo/bench/microbenchmark.h"
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+#include <torch/torch.h>
+
+namespace bench = cuwacunu::piaabo::bench;
+namespace exec = cuwacunu::cajtucu::execution;
+
+namespace {
+
+exec::market_execution_state_t make_market() {
+  exec::market_execution_state_t out{};
+  out.market_source_id = "microbench.direct_pair_market_state";
+  out.timestamp_ms = 100;
+  out.graph.node_ids = {"BTC", "ETH", "USDT"};
+  out.graph.edge_ids = {"BTC/USDT", "ETH/USDT", "ETH/BTC"};
+  out.graph.base_index = {0, 1, 1};
+  out.graph.quote_index = {2, 2, 0};
+  out.edge_mid_price = torch::tensor({100.0, 50.0, 0.5}, torch::kFloat64);
+  out.edge_fee_rate = torch::full({3}, 0.001, torch::kFloat64);
+  out.edge_spread_rate = torch::full({3}, 0.002, torch::kFloat64);
+  out.edge_slippage_rate = torch::full({3}, 0.003, torch::kFloat64);
+  out.min_notional_numeraire = torch::full({3}, 1.0, torch::kFloat64);
+  out.max_notional_numeraire = torch::full({3}, 1000.0, torch::kFloat64);
+  out.edge_tradable_mask = torch::ones({3}, torch::kBool);
+  exec::validate_market_execution_state(out);
+  return out;
+}
+
+exec::execution_ledger_t make_ledger() {
+  exec::execution_ledger_t out{};
+  out.timestamp_ms = 100;
+  out.accounting_numeraire_node_id = "USDT";
+  out.node_ids = {"BTC", "ETH", "USDT"};
+  out.units = torch::tensor({2.0, 12.0, 200.0}, torch::kFloat64);
+  const auto values =
+      out.units * torch::tensor({100.0, 50.0, 1.0}, torch::kFloat64);
+  out.equity_value_numeraire = values.sum().item<double>();
+  out.weights = values / out.equity_value_numeraire;
+  exec::validate_execution_ledger(out);
+  return out;
+}
+
+exec::execution_intent_t make_intent() {
+  exec::execution_intent_t out{};
+  out.intent_id = "microbench_intent";
+  out.action_id = "microbench_action";
+  out.policy_id = "microbench_policy";
+  out.method_id = "microbench_method";
+  out.runtime_run_id = "microbench_runtime";
+  out.environment_run_id = "microbench_environment";
+  out.episode_id = "microbench_episode";
+  out.anchor_key = "microbench_anchor";
+  out.timestamp_ms = 101;
+  out.node_ids = {"BTC", "ETH", "USDT"};
+  out.accounting_numeraire_node_id = "USDT";
+  out.current_weights = torch::tensor({0.2, 0.6, 0.2}, torch::kFloat64);
+  out.target_weights = torch::tensor({0.6, 0.2, 0.2}, torch::kFloat64);
+  out.current_units = torch::tensor({2.0, 12.0, 200.0}, torch::kFloat64);
+  out.equity_value_numeraire = 1000.0;
+  exec::validate_execution_intent(out);
+  return out;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("cajtucu_paper",
+                                    bench::parse_microbench_cli(argc, argv));
+    const auto market = make_market();
+    const auto ledger = make_ledger();
+    const auto intent = make_intent();
+    exec::paper_execution_backend_t backend{};
+
+    suite.run("execute_direct_pair_rebalance", [&] {
+      auto trace = backend.execute(intent, market, ledger);
+      if (!trace.valid) {
+        throw std::runtime_error("[microbench paper] invalid trace");
+      }
+      bench::do_not_optimize(trace.total_transaction_cost_numeraire);
+    });
+
+    suite.run("execute_and_validate_trace", [&] {
+      auto trace = backend.execute(intent, market, ledger);
+      exec::validate_execution_trace(trace);
+      bench::do_not_optimize(trace.total_transaction_cost_numeraire);
+    });
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+#include "hero/lattice_hero/lattice/runtime_report/runtime_lls_view.h"
+#include "piaabo/bench/microbenchmark.h"
+
+#include <unistd.h>
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bench = cuwacunu::piaabo::bench;
+namespace runtime_report = cuwacunu::hero::lattice::runtime_report;
+
+namespace {
+
+constexpr int kEntries = 4096;
+
+// A status report shaped like the ones runtime jobs persist: a schema line,
+// typed numeric keys and free-form string values.
+std::string make_lls_text() {
+  std::string text = "# microbench runtime report\n"
+                     "schema = kikijyeba.lattice.microbench.v1\n";
+  for (int i = 0; i < kEntries; ++i) {
+    const auto id = std::to_string(i);
+    if (i % 3 == 0) {
+      text += "metric_" + id + "(0,+inf):double = " + id + ".25\n";
+    } else if (i % 3 == 1) {
+      text += "step_" + id + ":int = " + id + "\n";
+    } else {
+      text += "label_" + id + ":str = wave=" + id + ";channel=btc\n";
+    }
+  }
+  return text;
+}
+
+void require(bool ok, const std::string &what, const std::string &error) {
+  if (!ok) {
+    throw std::runtime_error("[microbench runtime_lls] " + what + ": " +
+                             error);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("hero_runtime_lls",
+                                    bench::parse_microbench_cli(argc, argv));
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("cuwacunu_microbench_lls_" +
+                      std::to_string(static_cast<long long>(::getpid())));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto text = make_lls_text();
+    const auto path = dir / "status.lls";
+    {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      out << text;
+    }
+
+    std::vector<runtime_report::runtime_lls_kv_view_t> views;
+    std::string error;
+    suite.run("parse_text_fast_views_4096", [&] {
+      require(runtime_report::parse_runtime_lls_text_fast_views(text, &views,
+                                                                &error),
+              "fast views", error);
+      bench::do_not_optimize(views.data());
+    });
+
+    suite.run("read_file_views_scan_4096", [&] {
+      runtime_report::runtime_lls_file_view_t view;
+      require(runtime_report::read_runtime_lls_file_views(path, {}, &view,
+                                                          &error),
+              "file views", error);
+      bench::do_not_optimize(view.entries().size());
+    });
+
+    runtime_report::runtime_lls_view_options_t sidecar{};
+    sidecar.use_sidecar = true;
+    sidecar.write_sidecar = true;
+    suite.run("read_file_views_sidecar_4096", [&] {
+      runtime_report::runtime_lls_file_view_t view;
+      require(runtime_report::read_runtime_lls_file_views(path, sidecar,
+                                                          &view, &error),
+              "sidecar views", error);
+      bench::do_not_optimize(view.entries().size());
+    });
+
+    std::filesystem::remove_all(dir);
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
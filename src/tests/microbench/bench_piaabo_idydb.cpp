@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+#include "piaabo/bench/microbenchmark.h"
+#include "piaabo/db/idydb/idydb.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bench = cuwacunu::piaabo::bench;
+
+namespace {
+
+constexpr idydb_column_row_sizing kRows = 512;
+constexpr unsigned short kDims = 32;
+constexpr idydb_column_row_sizing kFloatColumn = 1;
+constexpr idydb_column_row_sizing kVectorColumn = 2;
+
+void check(int rc, int expected, const std::string &what) {
+  if (rc != expected) {
+    throw std::runtime_error("[microbench idydb] " + what +
+                             " rc=" + std::to_string(rc));
+  }
+}
+
+std::vector<float> embedding(idydb_column_row_sizing row) {
+  std::vector<float> out(kDims);
+  for (unsigned short d = 0; d < kDims; ++d) {
+    out[d] = static_cast<float>((row * 31U + d * 7U) % 97U) / 97.0F;
+  }
+  return out;
+}
+
+void fill(idydb **db) {
+  for (idydb_column_row_sizing row = 1; row <= kRows; ++row) {
+    check(idydb_insert_float(db, kFloatColumn, row, static_cast<float>(row)),
+          IDYDB_DONE, "insert float");
+    const auto vec = embedding(row);
+    check(idydb_insert_vector(db, kVectorColumn, row, vec.data(), kDims),
+          IDYDB_DONE, "insert vector");
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("piaabo_idydb",
+                                    bench::parse_microbench_cli(argc, argv));
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("cuwacunu_microbench_idydb_" +
+                      std::to_string(static_cast<long long>(::getpid())));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    auto slow = suite.options();
+    slow.repetitions = std::max<std::size_t>(slow.repetitions / 4, 5);
+    std::size_t generation = 0;
+    suite.run("insert_512_rows", slow, [&] {
+      const auto path =
+          dir / ("insert_" + std::to_string(generation++) + ".db");
+      idydb *db = nullptr;
+      check(idydb_open(path.c_str(), &db, IDYDB_CREATE), IDYDB_SUCCESS,
+            "open");
+      fill(&db);
+      idydb_close(&db);
+      std::filesystem::remove(path);
+    });
+
+    const auto path = dir / "read.db";
+    idydb *db = nullptr;
+    check(idydb_open(path.c_str(), &db, IDYDB_CREATE), IDYDB_SUCCESS,
+          "open");
+    fill(&db);
+
+    suite.run("extract_512_floats", [&] {
+      float sum = 0.0F;
+      for (idydb_column_row_sizing row = 1; row <= kRows; ++row) {
+        check(idydb_extract(&db, kFloatColumn, row), IDYDB_DONE, "extract");
+        sum += idydb_retrieve_float(&db);
+      }
+      bench::do_not_optimize(sum);
+    });
+
+    const auto query = embedding(17);
+    std::vector<idydb_knn_result> hits(8);
+    suite.run("knn_cosine_top8", [&] {
+      const int found = idydb_knn_search_vector_column(
+          &db, kVectorColumn, query.data(), kDims,
+          static_cast<unsigned short>(hits.size()), IDYDB_SIM_COSINE,
+          hits.data());
+      if (found <= 0) {
+        throw std::runtime_error("[microbench idydb] knn returned no rows");
+      }
+      bench::do_not_optimize(hits.front().score);
+    });
+
+    idydb_close(&db);
+    std::filesystem::remove_all(dir);
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MIT
+#include "piaabo/bench/microbenchmark.h"
+#include "ujcamei/source/registry/types/data.h"
+#include "ujcamei/source/retrieval/dataloader/edge_sample.h"
+#include "ujcamei/source/retrieval/storage/memory_mapped/memory_mapped_datafile.h"
+#include "ujcamei/source/retrieval/storage/memory_mapped/memory_mapped_dataloader.h"
+#include "ujcamei/source/retrieval/storage/memory_mapped/memory_mapped_dataset.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <torch/torch.h>
+
+namespace bench = cuwacunu::piaabo::bench;
+namespace dl = cuwacunu::ujcamei::source::retrieval::dataloader;
+namespace mm = cuwacunu::ujcamei::source::retrieval::storage::memory_mapped;
+namespace types = cuwacunu::ujcamei::source::registry::types;
+
+namespace {
+
+using Kline = types::kline_t;
+
+constexpr int kRows = 20000;
+constexpr std::size_t kInputLength = 64;
+constexpr std::size_t kFutureLength = 8;
+
+void write_kline_csv(const std::filesystem::path &path, types::ms_t first,
+                     double phase) {
+  std::ofstream out(path, std::ios::trunc);
+  for (int i = 0; i < kRows; ++i) {
+    const double price = 100.0 + 10.0 * std::sin(0.01 * i + phase);
+    Kline k{};
+    k.open_time = first + i - 1;
+    k.open_price = price;
+    k.high_price = price + 1.0;
+    k.low_price = price - 1.0;
+    k.close_price = price;
+    k.volume = 10.0 + (i % 7);
+    k.close_time = first + i;
+    k.quote_asset_volume = k.volume * price;
+    k.number_of_trades = 3 + (i % 5);
+    k.taker_buy_base_volume = k.volume * 0.4;
+    k.taker_buy_quote_volume = k.volume * price * 0.4;
+    k.to_csv(out, ',');
+    out << '\n';
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("ujcamei_dataloader",
+                                    bench::parse_microbench_cli(argc, argv));
+    const auto dir = std::filesystem::temp_directory_path() /
+                     ("cuwacunu_microbench_dataloader_" +
+                      std::to_string(static_cast<long long>(::getpid())));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto csv0 = dir / "edge0.csv";
+    const auto csv1 = dir / "edge1.csv";
+    write_kline_csv(csv0, 1000000, 0.0);
+    write_kline_csv(csv1, 1000000, 1.5);
+
+    auto slow = suite.options();
+    slow.repetitions = std::max<std::size_t>(slow.repetitions / 4, 5);
+    suite.run("sanitize_csv_20000_log_returns", slow, [&] {
+      const auto bin = mm::sanitize_csv_into_binary_file<Kline>(
+          csv0.string(), "log_returns", /*force_rebuild_cache=*/true, 1024);
+      bench::do_not_optimize(bin.size());
+    });
+
+    mm::MemoryMappedEdgeDataset<Kline> dataset;
+    dataset.add_dataset(csv0.string(), kInputLength, kFutureLength, "none",
+                        true);
+    dataset.add_dataset(csv1.string(), kInputLength, kFutureLength, "none",
+                        true);
+    const std::size_t anchors = dataset.size().value();
+
+    std::size_t cursor = 0;
+    suite.run("edge_dataset_get_C2_H64", [&] {
+      cursor = (cursor * 2654435761U + 1U) % anchors;
+      auto sample = dataset.get(cursor);
+      bench::do_not_optimize(sample.features.data_ptr());
+    });
+
+    suite.run("edge_loader_epoch_batch64", slow, [&] {
+      auto sampler = dataset.SequentialSampler();
+      auto options = dataset.SequentialSampler_options(64, 0);
+      mm::MemoryMappedDataLoader<mm::MemoryMappedEdgeDataset<Kline>,
+                                 dl::edge_sample_t, Kline>
+          loader(dataset, sampler, options);
+      std::size_t batches = 0;
+      for (auto &batch : loader) {
+        bench::do_not_optimize(&batch);
+        ++batches;
+      }
+      bench::do_not_optimize(batches);
+    });
+
+    std::filesystem::remove_all(dir);
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+#include "piaabo/bench/microbenchmark.h"
+#include "wikimyei/expression/nodelift/srl/synthetic_reference_lift.h"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <torch/torch.h>
+
+namespace bench = cuwacunu::piaabo::bench;
+namespace srl = cuwacunu::wikimyei::expression::nodelift::srl;
+
+namespace {
+
+struct lift_case_t {
+  std::string label;
+  int64_t B;
+  int64_t C;
+  int64_t H;
+  int64_t N;
+  int64_t L;
+};
+
+// Chain over every node plus forward chords until L edges exist, so the graph
+// is connected with L - N + 1 independent cycles.
+srl::graph_t make_graph(int64_t N, int64_t L) {
+  srl::graph_t graph{};
+  for (int64_t n = 0; n < N; ++n) {
+    graph.node_ids.push_back("n" + std::to_string(n));
+  }
+  std::vector<int64_t> base;
+  std::vector<int64_t> quote;
+  for (int64_t n = 0; n + 1 < N; ++n) {
+    base.push_back(n);
+    quote.push_back(n + 1);
+  }
+  for (int64_t stride = 2; static_cast<int64_t>(base.size()) < L; ++stride) {
+    for (int64_t n = 0;
+         n + stride < N && static_cast<int64_t>(base.size()) < L; ++n) {
+      base.push_back(n);
+      quote.push_back(n + stride);
+    }
+  }
+  for (std::size_t e = 0; e < base.size(); ++e) {
+    graph.edge_ids.push_back("e" + std::to_string(e));
+  }
+  graph.base_index =
+      torch::tensor(base, torch::TensorOptions().dtype(torch::kInt64));
+  graph.quote_index =
+      torch::tensor(quote, torch::TensorOptions().dtype(torch::kInt64));
+  graph.validate();
+  return graph;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("wikimyei_nodelift",
+                                    bench::parse_microbench_cli(argc, argv));
+    torch::manual_seed(1701);
+    torch::NoGradGuard no_grad;
+    const std::vector<lift_case_t> cases{
+        {.label = "lift_B1_C1_H16_N6_L8", .B = 1, .C = 1, .H = 16, .N = 6,
+         .L = 8},
+        {.label = "lift_B4_C3_H32_N12_L24", .B = 4, .C = 3, .H = 32, .N = 12,
+         .L = 24},
+        {.label = "lift_B8_C3_H64_N24_L64", .B = 8, .C = 3, .H = 64, .N = 24,
+         .L = 64},
+    };
+    for (const auto &c : cases) {
+      const auto graph = make_graph(c.N, c.L);
+      srl::nodelift_input_t input{};
+      input.edge_features =
+          torch::randn({c.B, c.L, c.C, c.H, 9}, torch::kFloat32);
+      input.edge_mask = torch::ones({c.B, c.L, c.C, c.H}, torch::kBool);
+      const srl::nodelift_options_t options{};
+      suite.run(c.label, [&] {
+        auto out = srl::featurewise_node_lift(graph, input, options);
+        bench::do_not_optimize(out.node_features.data_ptr());
+      });
+    }
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: MIT
+#include "piaabo/bench/microbenchmark.h"
+#include "wikimyei/inference/expected_value/mdn/mixture_density_network_types.h"
+#include "wikimyei/observer/belief/builder.h"
+#include "wikimyei/observer/utility/covariance_coupler.h"
+#include "wikimyei/policy/portfolio/spot_distributional_utility/solver.h"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <torch/torch.h>
+
+namespace bench = cuwacunu::piaabo::bench;
+namespace belief = cuwacunu::wikimyei::observer::belief;
+namespace observer = cuwacunu::wikimyei::observer;
+namespace mdn = cuwacunu::wikimyei::inference::expected_value::mdn;
+namespace portfolio = cuwacunu::wikimyei::policy::portfolio;
+namespace sdu = portfolio::spot_distributional_utility;
+
+namespace {
+
+// Three-node MDN head (BTC, ETH and the USDT numeraire) with a spread of
+// close-return means, as in the observer portfolio fixture.
+mdn::MdnOut make_mdn() {
+  const int64_t B = 1;
+  const int64_t N = 3;
+  const int64_t C = 3;
+  const int64_t Df = 9;
+  const int64_t K = 3;
+  auto opts = torch::TensorOptions().dtype(torch::kFloat64);
+  mdn::MdnOut out{};
+  out.log_pi = torch::log(torch::full({B, N, C, Df, K}, 1.0 / K, opts));
+  out.mu = torch::zeros({B, N, C, Df, K}, opts);
+  out.sigma = torch::full({B, N, C, Df, K}, 0.10, opts);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      for (int64_t k = 0; k < K; ++k) {
+        const double mu = n == 2 ? 0.0 : 0.01 * (k + 1) * (n + 1) + 0.005 * c;
+        out.mu.index_put_({0, n, c, 3, k}, mu);
+        if (n == 2) {
+          out.sigma.index_put_({0, n, c, 3, k}, 0.02);
+        }
+      }
+      out.mu.index_put_({0, n, c, 4, 0}, 1.0 + 0.1 * n);
+      out.mu.index_put_({0, n, c, 5, 0}, 1.2 + 0.1 * n);
+      out.mu.index_put_({0, n, c, 6, 0}, 0.8 + 0.1 * n);
+    }
+  }
+  return out;
+}
+
+belief::allocation_belief_builder_options_t make_builder_options() {
+  belief::allocation_belief_builder_options_t options{};
+  options.anchor_slot = 0;
+  options.anchor_key = "1000";
+  options.timestamp_ms = 1000;
+  options.graph_order_fingerprint = "microbench_graph";
+  options.graph_node_ids = {"BTC", "ETH", "USDT"};
+  options.node_ids = {"BTC", "ETH", "USDT"};
+  options.node_graph_indices = {0, 1, 2};
+  options.base_policy = {.accounting_numeraire_id = "USDT",
+                         .settlement_asset_id = "USDT",
+                         .projection_reference_node_id = "USDT"};
+  options.channel_mask = torch::ones({1, 3, 3}, torch::kBool);
+  options.empirical_potential_correlation =
+      torch::tensor({{1.0, 0.25, 0.10}, {0.25, 1.0, 0.15}, {0.10, 0.15, 1.0}},
+                    torch::TensorOptions().dtype(torch::kFloat64));
+  options.tradable_mask = torch::ones({3}, torch::kBool);
+  options.linear_cost = torch::full({3}, 0.001, torch::kFloat64);
+  options.quadratic_impact = torch::zeros({3}, torch::kFloat64);
+  options.capacity_weight_limit =
+      torch::tensor({0.50, 0.50, 1.0}, torch::kFloat64);
+  options.projection_options.coupling_options.sample_count = 64;
+  options.projection_options.coupling_options.quantile_bisection_steps = 24;
+  return options;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    bench::microbench_suite_t suite("wikimyei_solver",
+                                    bench::parse_microbench_cli(argc, argv));
+    torch::NoGradGuard no_grad;
+    const auto mdn_out = make_mdn();
+    const auto builder_options = make_builder_options();
+
+    suite.run("allocation_belief_build_N3", [&] {
+      auto built =
+          belief::build_single_anchor_allocation_belief(mdn_out,
+                                                        builder_options);
+      bench::do_not_optimize(built.allocation_belief.confidence.data_ptr());
+    });
+
+    // 64 anchors: one single-anchor build per anchor versus one batch pass.
+    const int64_t kAnchors = 64;
+    mdn::MdnOut batch_out{};
+    batch_out.log_pi = mdn_out.log_pi.repeat({kAnchors, 1, 1, 1, 1});
+    batch_out.mu = mdn_out.mu.repeat({kAnchors, 1, 1, 1, 1});
+    batch_out.sigma = mdn_out.sigma.repeat({kAnchors, 1, 1, 1, 1});
+    belief::allocation_belief_batch_builder_options_t batch_options{};
+    batch_options.common = builder_options;
+    batch_options.common.channel_mask =
+        torch::ones({kAnchors, 3, 3}, torch::kBool);
+    for (int64_t b = 0; b < kAnchors; ++b) {
+      batch_options.anchor_keys.push_back(std::to_string(1000 + b));
+      batch_options.timestamps_ms.push_back(1000 + b);
+    }
+    suite.run("allocation_belief_per_anchor_B64_N3", [&] {
+      auto single = batch_options.common;
+      for (int64_t b = 0; b < kAnchors; ++b) {
+        single.anchor_slot = b;
+        auto built =
+            belief::build_single_anchor_allocation_belief(batch_out, single);
+        bench::do_not_optimize(built.allocation_belief.confidence.data_ptr());
+      }
+    });
+    suite.run("allocation_belief_batch_B64_N3", [&] {
+      auto batch = belief::build_allocation_belief_batch(batch_out,
+                                                         batch_options);
+      bench::do_not_optimize(batch.beliefs.back().confidence.data_ptr());
+    });
+
+    // Coupler quantile inversion on a [S=512, A=8, K=9] marginal block.
+    auto f64 = torch::TensorOptions().dtype(torch::kFloat64);
+    const auto q_log_weight = torch::log_softmax(torch::randn({8, 9}, f64), 1);
+    const auto q_mu = 0.02 * torch::randn({8, 9}, f64);
+    const auto q_sigma = 0.005 + 0.02 * torch::rand({8, 9}, f64);
+    const auto q_uniforms = torch::rand({512, 8}, f64);
+    suite.run("mixture_quantile_bisection40_S512_A8_K9", [&] {
+      auto q = observer::mixture_quantile(q_log_weight, q_mu, q_sigma,
+                                          q_uniforms, 40);
+      bench::do_not_optimize(q.data_ptr());
+    });
+    observer::mixture_quantile_workspace_t q_workspace{};
+    suite.run("mixture_quantile_newton_S512_A8_K9", [&] {
+      auto q = observer::mixture_quantile_newton(
+          q_log_weight, q_mu, q_sigma, q_uniforms, 40, 1.0e-9, &q_workspace);
+      bench::do_not_optimize(q.data_ptr());
+    });
+
+    const auto state =
+        belief::build_single_anchor_allocation_belief(mdn_out, builder_options)
+            .allocation_belief;
+    portfolio::PortfolioState portfolio_state{};
+    portfolio_state.timestamp_ms = 1000;
+    portfolio_state.accounting_numeraire_node_id = "USDT";
+    portfolio_state.node_ids = state.node_ids;
+    portfolio_state.current_weights =
+        torch::tensor({0.10, 0.10, 0.80}, torch::kFloat64);
+    portfolio_state.current_units =
+        torch::tensor({1.0, 1.0, 800.0}, torch::kFloat64);
+    portfolio_state.equity_value_numeraire = 1000.0;
+
+    portfolio::MarketState market{};
+    market.timestamp_ms = 1000;
+    market.tradable_mask = torch::ones({3}, torch::kBool);
+    market.executable_mid = torch::tensor({100.0, 50.0, 1.0}, torch::kFloat64);
+    market.fee_rate = torch::full({3}, 0.001, torch::kFloat64);
+
+    portfolio::PortfolioConstraints constraints{};
+    constraints.max_weight = torch::tensor({0.60, 0.60, 1.0}, torch::kFloat64);
+    constraints.min_weight = torch::zeros({3}, torch::kFloat64);
+    constraints.max_turnover_l1 = 0.50;
+    constraints.lambda_cvar = 0.5;
+    constraints.lambda_concentration = 0.01;
+    constraints.lambda_uncertainty = 0.01;
+    constraints.lambda_turnover = 0.001;
+
+    const sdu::solver_options_t solver_options{};
+    suite.run("solve_default_iterations_N3", [&] {
+      auto target = sdu::solve(state, portfolio_state, market, constraints,
+                               solver_options);
+      if (!target.valid) {
+        throw std::runtime_error("[microbench solver] invalid target");
+      }
+      bench::do_not_optimize(target.target_weights.data_ptr());
+    });
+    return suite.finish();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}